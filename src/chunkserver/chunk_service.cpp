@@ -86,6 +86,55 @@ void ChunkServiceImpl::DeleteChunk(RpcController *controller,
     req->Process();
 }
 
+void ChunkServiceImpl::DeleteChunks(RpcController *controller,
+                                    const ChunkRequest *request,
+                                    ChunkResponse *response,
+                                    Closure *done) {
+    ChunkServiceClosure* closure =
+        new (std::nothrow) ChunkServiceClosure(inflightThrottle_,
+                                               request,
+                                               response,
+                                               done);
+    CHECK(nullptr != closure) << "new chunk service closure failed";
+
+    brpc::ClosureGuard doneGuard(closure);
+
+    if (inflightThrottle_->IsOverLoad()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+        LOG_EVERY_N(WARNING, 100)
+            << "DeleteChunks: "
+            << "too many inflight requests to process in chunkserver";
+        return;
+    }
+
+    // 请求的op类型不是批量删除chunk，或者没有要删除的chunk
+    if (request->optype() != CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH
+        || request->deletechunkids_size() == 0) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+        DVLOG(9) << "Invalid request: " << request->optype()
+                 << " chunk count: " << request->deletechunkids_size();
+        return;
+    }
+
+    // 判断copyset是否存在
+    auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
+                                                       request->copysetid());
+    if (nullptr == nodePtr) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST);
+        LOG(WARNING) << "delete chunks failed, copyset node is not found:"
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
+    std::shared_ptr<DeleteChunksRequest>
+        req = std::make_shared<DeleteChunksRequest>(nodePtr,
+                                                    controller,
+                                                    request,
+                                                    response,
+                                                    doneGuard.release());
+    req->Process();
+}
+
 void ChunkServiceImpl::WriteChunk(RpcController *controller,
                                   const ChunkRequest *request,
                                   ChunkResponse *response,
@@ -192,6 +241,60 @@ void ChunkServiceImpl::CreateCloneChunk(RpcController *controller,
     req->Process();
 }
 
+void ChunkServiceImpl::CreateCloneChunks(RpcController *controller,
+                                         const ChunkRequest *request,
+                                         ChunkResponse *response,
+                                         Closure *done) {
+    ChunkServiceClosure* closure =
+        new (std::nothrow) ChunkServiceClosure(inflightThrottle_,
+                                               request,
+                                               response,
+                                               done);
+    CHECK(nullptr != closure) << "new chunk service closure failed";
+
+    brpc::ClosureGuard doneGuard(closure);
+
+    if (inflightThrottle_->IsOverLoad()) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD);
+        LOG_EVERY_N(WARNING, 100)
+            << "CreateCloneChunks: "
+            << "too many inflight requests to process in chunkserver";
+        return;
+    }
+
+    // 请求的op类型不是批量创建clone chunk，请求创建的chunk大小和copyset
+    // 配置的大小不一致，或者没有要创建的chunk
+    if (request->optype() != CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH
+        || request->size() != maxChunkSize_
+        || request->clonechunks_size() == 0) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+        DVLOG(9) << "Invalid request: " << request->optype()
+                 << " request size: " << request->size()
+                 << " copyset size: " << maxChunkSize_
+                 << " chunk count: " << request->clonechunks_size();
+        return;
+    }
+
+    // 判断copyset是否存在
+    auto nodePtr = copysetNodeManager_->GetCopysetNode(request->logicpoolid(),
+                                                       request->copysetid());
+    if (nullptr == nodePtr) {
+        response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST);
+        LOG(WARNING) << "create clone chunks failed, "
+                     << "copyset node is not found:"
+                     << request->logicpoolid() << "," << request->copysetid();
+        return;
+    }
+
+    std::shared_ptr<CreateCloneChunksRequest>
+        req = std::make_shared<CreateCloneChunksRequest>(nodePtr,
+                                                         controller,
+                                                         request,
+                                                         response,
+                                                         doneGuard.release());
+    req->Process();
+}
+
 void ChunkServiceImpl::CreateS3CloneChunk(RpcController* controller,
                        const CreateS3CloneChunkRequest* request,
                        CreateS3CloneChunkResponse* response,
@@ -458,6 +561,24 @@ void ChunkServiceImpl::GetChunkInfo(RpcController *controller,
         response->add_chunksn(chunkInfo.curSn);
         if (chunkInfo.snapSn > 0)
             response->add_chunksn(chunkInfo.snapSn);
+        // 返回各版本写过的区域，快照时只需转储变化的部分
+        for (int i = 0; i < response->chunksn_size(); ++i) {
+            CSChunkChangedBlocks changed;
+            CSErrorCode errorCode =
+                nodePtr->GetDataStore()->GetChunkChangedBlocks(
+                    request->chunkid(), response->chunksn(i), &changed);
+            if (CSErrorCode::Success != errorCode
+                || changed.baseSn == kInvalidSeq) {
+                continue;
+            }
+            ChunkChangedBlocks* blocks = response->add_changedblocks();
+            blocks->set_sn(changed.sn);
+            blocks->set_basesn(changed.baseSn);
+            blocks->set_blocksize(
+                chunkInfo.chunkSize / changed.blocks->Size());
+            blocks->set_bitmap(changed.blocks->GetBitmap(),
+                (changed.blocks->Size() + 8 - 1) >> 3);
+        }
         response->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
     } else if (CSErrorCode::ChunkNotExistError == ret) {
         // 2.chunk文件不存在，返回的版本集合为空
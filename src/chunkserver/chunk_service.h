@@ -47,6 +47,10 @@ class ChunkServiceImpl : public ChunkService {
                      const ChunkRequest *request,
                      ChunkResponse *response,
                      Closure *done);
+    void DeleteChunks(RpcController *controller,
+                      const ChunkRequest *request,
+                      ChunkResponse *response,
+                      Closure *done);
 
     void ReadChunk(RpcController *controller,
                    const ChunkRequest *request,
@@ -72,6 +76,10 @@ class ChunkServiceImpl : public ChunkService {
                           const ChunkRequest *request,
                           ChunkResponse *response,
                           Closure *done);
+    void CreateCloneChunks(RpcController *controller,
+                           const ChunkRequest *request,
+                           ChunkResponse *response,
+                           Closure *done);
     void CreateS3CloneChunk(RpcController* controller,
                        const CreateS3CloneChunkRequest* request,
                        CreateS3CloneChunkResponse* response,
@@ -131,6 +131,7 @@ int ChunkServer::Run(int argc, char** argv) {
     // 远端拷贝管理模块选项
     CopyerOptions copyerOptions;
     InitCopyerOptions(&conf, &copyerOptions);
+    copyerOptions.localFs = fs;
     auto copyer = std::make_shared<OriginCopyer>();
     LOG_IF(FATAL, copyer->Init(copyerOptions) != 0)
         << "Failed to initialize clone copyer.";
@@ -438,6 +439,8 @@ void ChunkServer::InitCopysetNodeOptions(
         &copysetNodeOptions->maxChunkSize));
     LOG_IF(FATAL, !conf->GetUInt32Value("global.location_limit",
         &copysetNodeOptions->locationLimit));
+    LOG_IF(FATAL, !conf->GetUInt32Value("global.change_block_size",
+        &copysetNodeOptions->changeBlockSize));
     LOG_IF(FATAL, !conf->GetUInt32Value("copyset.load_concurrency",
         &copysetNodeOptions->loadConcurrency));
     LOG_IF(FATAL, !conf->GetUInt32Value("copyset.check_retrytimes",
@@ -470,12 +473,36 @@ void ChunkServer::InitCopyerOptions(
     } else {
         copyerOptions->curveClient = std::make_shared<FileClient>();
     }
+    LOG_IF(FATAL, !conf->GetUInt32Value("clone.curve_file_cache_capacity",
+        &copyerOptions->curveFileCacheCapacity));
 
     if (disableS3Adapter) {
         copyerOptions->s3Client = nullptr;
     } else {
         copyerOptions->s3Client = std::make_shared<S3Adapter>();
     }
+
+    S3RangeCacheOptions *cacheOptions = &copyerOptions->s3CacheOptions;
+    LOG_IF(FATAL, !conf->GetUInt32Value("clone.s3_cache_block_size",
+        &cacheOptions->blockSize));
+    LOG_IF(FATAL, !conf->GetUInt64Value("clone.s3_cache_mem_capacity",
+        &cacheOptions->memCapacity));
+    LOG_IF(FATAL, !conf->GetUInt64Value("clone.s3_cache_disk_capacity",
+        &cacheOptions->diskCapacity));
+    LOG_IF(FATAL, !conf->GetUInt32Value("clone.s3_cache_read_ahead_blocks",
+        &cacheOptions->readAheadBlocks));
+    uint32_t chunkSize = 0;
+    LOG_IF(FATAL, !conf->GetUInt32Value("global.chunk_size", &chunkSize));
+    // 快照的数据对象与chunk一一对应
+    cacheOptions->objectSize = chunkSize;
+    // 缓存的block不能超出对象的范围
+    LOG_IF(FATAL, cacheOptions->blockSize != 0 &&
+        chunkSize % cacheOptions->blockSize != 0)
+        << "clone.s3_cache_block_size must be a divisor of chunk size.";
+    // 磁盘缓存放在chunkserver自己的目录下
+    std::string storUri;
+    LOG_IF(FATAL, !conf->GetStringValue("chunkserver.stor_uri", &storUri));
+    cacheOptions->diskPath = UriParser::GetPathFromUri(storUri) + "/s3cache";
 }
 
 void ChunkServer::InitCloneOptions(
@@ -499,6 +526,10 @@ void ChunkServer::InitHeartbeatOptions(
         &heartbeatOptions->intervalSec));
     LOG_IF(FATAL, !conf->GetUInt32Value("mds.heartbeat_timeout",
         &heartbeatOptions->timeout));
+    LOG_IF(FATAL, !conf->GetBoolValue("mds.heartbeat_delta_report",
+        &heartbeatOptions->deltaReport));
+    LOG_IF(FATAL, !conf->GetUInt32Value("mds.heartbeat_full_report_interval",
+        &heartbeatOptions->fullReportInterval));
 }
 
 void ChunkServer::InitRegisterOptions(
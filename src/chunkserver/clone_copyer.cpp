@@ -20,6 +20,9 @@
  * Author: yangyaokai
  */
 
+#include <algorithm>
+#include <functional>
+
 #include "src/chunkserver/clone_copyer.h"
 #include "src/chunkserver/clone_core.h"
 
@@ -37,6 +40,7 @@ std::ostream& operator<<(std::ostream& out, const AsyncDownloadContext& rhs) {
 struct CurveAioCombineContext {
     DownloadClosure* done;
     CurveAioContext curveCtx;
+    CurveFileHandlePtr file;
 };
 
 void CurveAioCallback(struct CurveAioContext* context) {
@@ -47,6 +51,7 @@ void CurveAioCallback(struct CurveAioContext* context) {
     if (context->ret < 0) {
         done->SetFailed();
     }
+    curveCombineCtx->file->inflight--;
     delete curveCombineCtx;
 
     brpc::ClosureGuard doneGuard(done);
@@ -54,10 +59,18 @@ void CurveAioCallback(struct CurveAioContext* context) {
 
 OriginCopyer::OriginCopyer()
     : curveClient_(nullptr)
-    , s3Client_(nullptr) {}
+    , s3Client_(nullptr)
+    , s3Cache_(nullptr)
+    , s3CacheBypassSize_(0)
+    , curveFileShardCapacity_(0)
+    , accessTick_(0) {}
 
 int OriginCopyer::Init(const CopyerOptions& options) {
     curveClient_ = options.curveClient;
+    if (options.curveFileCacheCapacity > 0) {
+        curveFileShardCapacity_ = std::max<uint32_t>(1,
+            options.curveFileCacheCapacity / kCurveFileShardNum);
+    }
     s3Client_ = options.s3Client;
     if (curveClient_ != nullptr) {
         int errorCode = curveClient_->Init(options.curveConf.c_str());
@@ -72,6 +85,20 @@ int OriginCopyer::Init(const CopyerOptions& options) {
     }
     if (s3Client_ != nullptr) {
         s3Client_->Init(options.s3Conf);
+        if (options.s3CacheOptions.blockSize > 0) {
+            s3Cache_ = std::make_shared<S3RangeCache>(
+                options.s3CacheOptions, options.localFs,
+                [this] (const string& objectName, off_t off, size_t size,
+                        char* buf, RangeFetchDone done) {
+                    FetchFromS3(objectName, off, size, buf, done);
+                });
+            if (s3Cache_->Init() != 0) {
+                LOG(ERROR) << "Init s3 range cache failed.";
+                return -1;
+            }
+            // 整个对象的下载一般来自recover，一次下载，也不占用缓存
+            s3CacheBypassSize_ = options.s3CacheOptions.objectSize;
+        }
     } else {
         LOG(WARNING) << "s3 adapter is disabled.";
     }
@@ -80,8 +107,15 @@ int OriginCopyer::Init(const CopyerOptions& options) {
 
 int OriginCopyer::Fini() {
     if (curveClient_ != nullptr) {
-        for (auto &pair : fdMap_) {
-            curveClient_->Close(pair.second);
+        for (auto &shard : curveFiles_) {
+            std::unordered_map<std::string, CurveFileHandlePtr> files;
+            {
+                WriteLockGuard lg(shard.lock);
+                files.swap(shard.files);
+            }
+            for (auto &pair : files) {
+                CloseCurveFile(pair.first, pair.second->fd);
+            }
         }
         curveClient_->UnInit();
     }
@@ -115,7 +149,7 @@ void OriginCopyer::DownloadAsync(DownloadClosure* done) {
     } else if (type == OriginType::S3Origin) {
         DownloadFromS3(originPath, context->offset,
                        context->size, context->buf,
-                       done);
+                       context->recover, done);
         doneGuard.release();
     } else {
         LOG(ERROR) << "Unknown origin location."
@@ -128,6 +162,7 @@ void OriginCopyer::DownloadFromS3(const string& objectName,
                                  off_t off,
                                  size_t size,
                                  char* buf,
+                                 bool recover,
                                  DownloadClosure* done) {
     brpc::ClosureGuard doneGuard(done);
     if (s3Client_ == nullptr) {
@@ -137,13 +172,36 @@ void OriginCopyer::DownloadFromS3(const string& objectName,
         return;
     }
 
+    RangeFetchDone cb = [=] (int retCode) {
+        brpc::ClosureGuard doneGuard(done);
+        if (retCode != 0) {
+            done->SetFailed();
+        }
+    };
+
+    // recover和大块的下载数据只使用一次，直接按请求的范围下载，
+    // 避免拆成多个block下载以及挤占缓存;
+    // 按逻辑名称存储的对象名会被重用，不能缓存
+    bool bypassCache = recover ||
+        !S3RangeCache::IsCacheable(objectName) ||
+        (s3CacheBypassSize_ > 0 && size >= s3CacheBypassSize_);
+    if (s3Cache_ != nullptr && !bypassCache) {
+        s3Cache_->Read(objectName, off, size, buf, cb);
+    } else {
+        FetchFromS3(objectName, off, size, buf, cb);
+    }
+    doneGuard.release();
+}
+
+void OriginCopyer::FetchFromS3(const string& objectName,
+                               off_t off,
+                               size_t size,
+                               char* buf,
+                               RangeFetchDone done) {
     GetObjectAsyncCallBack cb =
         [=] (const S3Adapter* adapter,
              const std::shared_ptr<GetObjectAsyncContext>& context) {
-            brpc::ClosureGuard doneGuard(done);
-            if (context->retCode != 0) {
-                done->SetFailed();
-            }
+            done(context->retCode);
         };
 
     auto context = std::make_shared<GetObjectAsyncContext>();
@@ -154,7 +212,6 @@ void OriginCopyer::DownloadFromS3(const string& objectName,
     context->cb = cb;
 
     s3Client_->GetObjectAsync(context);
-    doneGuard.release();
 }
 
 void OriginCopyer::DownloadFromCurve(const string& fileName,
@@ -170,38 +227,27 @@ void OriginCopyer::DownloadFromCurve(const string& fileName,
         return;
     }
 
-    int fd = 0;
-    {
-        std::unique_lock<std::mutex> lock(mtx_);
-        auto iter = fdMap_.find(fileName);
-        if (iter != fdMap_.end()) {
-            fd = iter->second;
-        } else {
-            fd = curveClient_->Open4ReadOnly(fileName, curveUser_);
-            if (fd < 0) {
-                LOG(ERROR) << "Open curve file failed."
-                        << "file name: " << fileName
-                        << " ,return code: " << fd;
-                done->SetFailed();
-                return;
-            }
-            fdMap_[fileName] = fd;
-        }
+    CurveFileHandlePtr file = AcquireCurveFile(fileName);
+    if (file == nullptr) {
+        done->SetFailed();
+        return;
     }
 
     CurveAioCombineContext *curveCombineCtx = new CurveAioCombineContext();
     curveCombineCtx->done = done;
+    curveCombineCtx->file = file;
     curveCombineCtx->curveCtx.offset = off;
     curveCombineCtx->curveCtx.length = size;
     curveCombineCtx->curveCtx.buf = buf;
     curveCombineCtx->curveCtx.op = LIBCURVE_OP::LIBCURVE_OP_READ;
     curveCombineCtx->curveCtx.cb = CurveAioCallback;
 
-    int ret = curveClient_->AioRead(fd,  &curveCombineCtx->curveCtx);
+    int ret = curveClient_->AioRead(file->fd,  &curveCombineCtx->curveCtx);
     if (ret !=  LIBCURVE_ERROR::OK) {
         LOG(ERROR) << "Read curve file failed."
                    << "file name: " << fileName
                    << " ,error code: " << ret;
+        file->inflight--;
         delete curveCombineCtx;
         done->SetFailed();
     } else {
@@ -209,5 +255,100 @@ void OriginCopyer::DownloadFromCurve(const string& fileName,
     }
 }
 
+CurveFileHandlePtr OriginCopyer::AcquireCurveFile(const string& fileName) {
+    uint32_t shardIndex =
+        std::hash<std::string>()(fileName) % kCurveFileShardNum;
+    CurveFileHandlePtr file = FindCurveFile(shardIndex, fileName);
+    if (file != nullptr) {
+        return file;
+    }
+
+    // 打开文件需要与mds交互，不能持有shard的锁，否则会阻塞同一shard上
+    // 其他文件的读请求；同一个文件的并发请求等待第一个请求打开完成
+    NameLockGuard openGuard(curveFileOpenLock_, fileName);
+    file = FindCurveFile(shardIndex, fileName);
+    if (file != nullptr) {
+        return file;
+    }
+    int fd = curveClient_->Open4ReadOnly(fileName, curveUser_);
+    if (fd < 0) {
+        LOG(ERROR) << "Open curve file failed."
+                << "file name: " << fileName
+                << " ,return code: " << fd;
+        return nullptr;
+    }
+    file = std::make_shared<CurveFileHandle>();
+    file->fd = fd;
+    file->inflight = 1;
+    file->lastAccess = accessTick_++;
+
+    string victimName;
+    int victimFd = -1;
+    bool evicted = false;
+    {
+        CurveFileShard& shard = curveFiles_[shardIndex];
+        WriteLockGuard lg(shard.lock);
+        shard.files[fileName] = file;
+        if (curveFileShardCapacity_ > 0 &&
+            shard.files.size() > curveFileShardCapacity_) {
+            evicted = EvictCurveFile(shardIndex, fileName,
+                                     &victimName, &victimFd);
+        }
+    }
+    if (evicted) {
+        CloseCurveFile(victimName, victimFd);
+    }
+    return file;
+}
+
+CurveFileHandlePtr OriginCopyer::FindCurveFile(uint32_t shardIndex,
+                                               const string& fileName) {
+    CurveFileShard& shard = curveFiles_[shardIndex];
+    // 文件已经打开时只需要持有读锁，inflight在读锁下增加，
+    // 淘汰时持有写锁，能够看到所有正在进行的读请求
+    ReadLockGuard lg(shard.lock);
+    auto iter = shard.files.find(fileName);
+    if (iter == shard.files.end()) {
+        return nullptr;
+    }
+    iter->second->inflight++;
+    iter->second->lastAccess = accessTick_++;
+    return iter->second;
+}
+
+bool OriginCopyer::EvictCurveFile(uint32_t shardIndex,
+                                  const string& skipFile,
+                                  string* victimName,
+                                  int* victimFd) {
+    CurveFileShard& shard = curveFiles_[shardIndex];
+    auto victim = shard.files.end();
+    for (auto iter = shard.files.begin(); iter != shard.files.end(); ++iter) {
+        if (iter->first == skipFile || iter->second->inflight > 0) {
+            continue;
+        }
+        if (victim == shard.files.end() ||
+            iter->second->lastAccess < victim->second->lastAccess) {
+            victim = iter;
+        }
+    }
+    // 所有文件都有正在进行的读请求时暂时超出上限，下次打开文件时再淘汰
+    if (victim == shard.files.end()) {
+        return false;
+    }
+    *victimName = victim->first;
+    *victimFd = victim->second->fd;
+    shard.files.erase(victim);
+    return true;
+}
+
+void OriginCopyer::CloseCurveFile(const string& fileName, int fd) {
+    int ret = curveClient_->Close(fd);
+    if (ret != LIBCURVE_ERROR::OK) {
+        LOG(WARNING) << "Close curve file failed."
+                     << "file name: " << fileName
+                     << " ,error code: " << ret;
+    }
+}
+
 }  // namespace chunkserver
 }  // namespace curve
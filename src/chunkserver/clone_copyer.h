@@ -24,6 +24,7 @@
 #define SRC_CHUNKSERVER_CLONE_COPYER_H_
 
 #include <glog/logging.h>
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <string>
@@ -35,6 +36,9 @@
 #include "src/client/client_common.h"
 #include "include/client/libcurve.h"
 #include "src/common/s3_adapter.h"
+#include "src/chunkserver/s3_range_cache.h"
+#include "src/common/concurrent/rw_lock.h"
+#include "src/common/concurrent/name_lock.h"
 
 namespace curve {
 namespace chunkserver {
@@ -46,6 +50,11 @@ using curve::common::LocationOperator;
 using curve::common::OriginType;
 using curve::common::GetObjectAsyncCallBack;
 using curve::common::GetObjectAsyncContext;
+using curve::common::RWLock;
+using curve::common::ReadLockGuard;
+using curve::common::WriteLockGuard;
+using curve::common::NameLock;
+using curve::common::NameLockGuard;
 using std::string;
 
 class DownloadClosure;
@@ -61,8 +70,29 @@ struct CopyerOptions {
     std::shared_ptr<FileClient> curveClient;
     // s3 adapter的对象指针
     std::shared_ptr<S3Adapter> s3Client;
+    // s3对象读缓存的配置，blockSize为0时不使用缓存
+    S3RangeCacheOptions s3CacheOptions;
+    // 磁盘缓存使用的本地文件系统
+    std::shared_ptr<LocalFileSystem> localFs;
+    // 保持打开的curve源文件数量上限，超过时关闭最久未使用的文件，0表示不限制
+    uint32_t curveFileCacheCapacity;
+
+    CopyerOptions() : curveFileCacheCapacity(0) {}
 };
 
+// 源文件句柄按照文件名分到多个shard中，减少读请求之间的锁竞争
+const uint32_t kCurveFileShardNum = 16;
+
+// 打开的curve源文件
+struct CurveFileHandle {
+    int fd;
+    // 正在进行的读请求数量，不为0时文件不能被关闭
+    std::atomic<uint32_t> inflight;
+    // 最近一次访问的序号，用于淘汰最久未使用的文件
+    std::atomic<uint64_t> lastAccess;
+};
+using CurveFileHandlePtr = std::shared_ptr<CurveFileHandle>;
+
 struct AsyncDownloadContext {
     // 源chunk的位置信息
     string location;
@@ -72,6 +102,11 @@ struct AsyncDownloadContext {
     size_t size;
     // 存放下载数据的缓冲区
     char* buf;
+    // 是否是recover请求，recover下载的数据写入chunk后不会再从源端读取
+    bool recover;
+
+    AsyncDownloadContext() : offset(0), size(0), buf(nullptr)
+                           , recover(false) {}
 };
 
 std::ostream& operator<<(std::ostream& out, const AsyncDownloadContext& rhs);
@@ -106,13 +141,56 @@ class OriginCopyer {
                        off_t off,
                        size_t size,
                        char* buf,
+                       bool recover,
                        DownloadClosure* done);
+    void FetchFromS3(const string& objectName,
+                     off_t off,
+                     size_t size,
+                     char* buf,
+                     RangeFetchDone done);
     void DownloadFromCurve(const string& fileName,
                           off_t off,
                           size_t size,
                           char* buf,
                           DownloadClosure* done);
 
+    /**
+     * 获取源文件的句柄，文件未打开时打开文件，并将inflight加1
+     * 打开文件不持有shard的锁，同一个文件同时只有一个请求去打开
+     * @param fileName: 源文件名
+     * @return: 成功返回文件句柄，打开失败返回nullptr
+     */
+    CurveFileHandlePtr AcquireCurveFile(const string& fileName);
+
+    // 在shard中查找已经打开的文件，找到时将inflight加1
+    CurveFileHandlePtr FindCurveFile(uint32_t shardIndex,
+                                     const string& fileName);
+
+    /**
+     * 从shard中移除最久未使用并且没有读请求的文件，需要持有shard的写锁
+     * 移除的文件由调用方在释放锁之后关闭
+     * @param shardIndex: shard的索引
+     * @param skipFile: 不参与淘汰的文件
+     * @param victimName: 被移除的文件名
+     * @param victimFd: 被移除的文件句柄
+     * @return: 移除了文件返回true，没有可以移除的文件返回false
+     */
+    bool EvictCurveFile(uint32_t shardIndex,
+                        const string& skipFile,
+                        string* victimName,
+                        int* victimFd);
+
+    // 关闭被淘汰的文件，不能持有shard的锁
+    void CloseCurveFile(const string& fileName, int fd);
+
+ private:
+    struct CurveFileShard {
+        // 查找已经打开的文件只需要读锁
+        RWLock lock;
+        // 文件名 -> 文件句柄
+        std::unordered_map<std::string, CurveFileHandlePtr> files;
+    };
+
  private:
     // curvefs上的root用户信息
     UserInfo curveUser_;
@@ -120,10 +198,18 @@ class OriginCopyer {
     std::shared_ptr<FileClient> curveClient_;
     // 负责跟s3交互
     std::shared_ptr<S3Adapter>  s3Client_;
-    // 保护fdMap_的互斥锁
-    std::mutex  mtx_;
-    // 文件名->文件fd 的映射
-    std::unordered_map<std::string, int> fdMap_;
+    // s3对象的读缓存，为nullptr时直接从s3下载
+    std::shared_ptr<S3RangeCache> s3Cache_;
+    // 打开的源文件，按照文件名分shard
+    CurveFileShard curveFiles_[kCurveFileShardNum];
+    // 正在打开的文件，同一个文件的其他请求等待打开完成后直接使用
+    NameLock curveFileOpenLock_;
+    // 不小于该大小的s3请求不经过缓存，直接下载，0表示都经过缓存
+    uint64_t s3CacheBypassSize_;
+    // 每个shard保持打开的文件数量上限，0表示不限制
+    uint32_t curveFileShardCapacity_;
+    // 用于生成文件的访问序号
+    std::atomic<uint64_t> accessTick_;
 };
 
 }  // namespace chunkserver
@@ -175,6 +175,8 @@ int CloneCore::CloneReadByLocalInfo(
         downloadCtx->offset = offset;
         downloadCtx->size = length;
         downloadCtx->buf = new (std::nothrow) char[length];
+        downloadCtx->recover =
+            CHUNK_OP_TYPE::CHUNK_OP_RECOVER == request->optype();
         DownloadClosure* downloadClosure =
             new (std::nothrow) DownloadClosure(readRequest,
                                                shared_from_this(),
@@ -43,6 +43,7 @@ CopysetNodeOptions::CopysetNodeOptions()
       port(8200),
       maxChunkSize(16 * 1024 * 1024),
       pageSize(4096),
+      changeBlockSize(0),
       concurrentapply(nullptr),
       chunkfilePool(nullptr),
       localFileSystem(nullptr),
@@ -89,6 +89,8 @@ struct CopysetNodeOptions {
     uint32_t pageSize;
     // clone chunk的location长度限制
     uint32_t locationLimit;
+    // 变化追踪的粒度，为0表示不追踪chunk各版本写过的区域
+    uint32_t changeBlockSize;
 
     // 并发模块
     ConcurrentApplyModule *concurrentapply;
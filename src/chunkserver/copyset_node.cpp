@@ -112,6 +112,7 @@ int CopysetNode::Init(const CopysetNodeOptions &options) {
     dsOptions.chunkSize = options.maxChunkSize;
     dsOptions.pageSize = options.pageSize;
     dsOptions.locationLimit = options.locationLimit;
+    dsOptions.changeBlockSize = options.changeBlockSize;
     dataStore_ = std::make_shared<CSDataStore>(options.localFileSystem,
                                                options.chunkfilePool,
                                                dsOptions);
@@ -242,7 +243,7 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
                                   opRequest,
                                   iter.index(),
                                   doneGuard.release());
-            concurrentapply_->Push(opRequest->ChunkId(), task);
+            ApplyTask(opRequest->OpType(), opRequest->ChunkId(), task);
         } else {
             // 获取log entry
             butil::IOBuf log = iter.data();
@@ -256,16 +257,45 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
             butil::IOBuf data;
             auto opReq = ChunkOpRequest::Decode(log, &request, &data);
             auto chunkId = request.chunkid();
-            auto task = std::bind(&ChunkOpRequest::OnApplyFromLog,
+            auto opType = request.optype();
+            auto task = std::bind(&CopysetNode::ApplyFromLog,
+                                  this,
                                   opReq,
                                   dataStore_,
                                   std::move(request),
-                                  data);
-            concurrentapply_->Push(chunkId, task);
+                                  data,
+                                  iter.index());
+            ApplyTask(opType, chunkId, task);
         }
     }
 }
 
+void CopysetNode::ApplyTask(CHUNK_OP_TYPE opType,
+                            ChunkID chunkId,
+                            const std::function<void()> &task) {
+    if (opType == CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH
+        || opType == CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH) {
+        /**
+         * 批量请求涉及多个chunk，等之前的请求都apply完之后在当前线程执行，
+         * 执行完之后才会继续分发后面的请求，保证和各个chunk上其他请求的顺序
+         */
+        concurrentapply_->Flush();
+        task();
+    } else {
+        concurrentapply_->Push(chunkId, task);
+    }
+}
+
+void CopysetNode::ApplyFromLog(std::shared_ptr<ChunkOpRequest> opReq,
+                               std::shared_ptr<CSDataStore> datastore,
+                               const ChunkRequest &request,
+                               const butil::IOBuf &data,
+                               uint64_t index) {
+    opReq->OnApplyFromLog(datastore, request, data);
+    // follower上也需要推进applied index，follower read依赖该值判断数据是否可读
+    UpdateAppliedIndex(index);
+}
+
 void CopysetNode::on_shutdown() {
     LOG(INFO) << GroupIdString() << " is shutdown";
 }
@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 #include <climits>
+#include <functional>
 #include <memory>
 
 #include "src/chunkserver/concurrent_apply.h"
@@ -52,6 +53,7 @@ using ::curve::mds::heartbeat::ConfigChangeType;
 using ::curve::common::Peer;
 
 class CopysetNodeManager;
+class ChunkOpRequest;
 
 extern const char *kCurveConfEpochFilename;
 
@@ -377,6 +379,31 @@ class CopysetNode : public braft::StateMachine,
      */
     int SaveConfEpoch(const std::string &filePath);
 
+    /**
+     * follower apply或者重启回放日志时执行op，并推进applied index
+     * @param opReq:从日志中反序列化出的op
+     * @param datastore:op作用的datastore
+     * @param request:op对应的请求
+     * @param data:op携带的数据
+     * @param index:op对应的日志index
+     */
+    void ApplyFromLog(std::shared_ptr<ChunkOpRequest> opReq,
+                      std::shared_ptr<CSDataStore> datastore,
+                      const ChunkRequest &request,
+                      const butil::IOBuf &data,
+                      uint64_t index);
+
+    /**
+     * 将op分发到并发apply模块执行，批量创建clone chunk和批量删除chunk
+     * 的op会先等之前的op执行完，然后在状态机线程中执行
+     * @param opType:op的类型
+     * @param chunkId:op对应的chunk id，用于选择apply队列
+     * @param task:执行op的任务
+     */
+    void ApplyTask(CHUNK_OP_TYPE opType,
+                   ChunkID chunkId,
+                   const std::function<void()> &task);
+
  private:
     inline std::string GroupId() {
         return ToGroupId(logicPoolId_, copysetId_);
@@ -30,6 +30,67 @@
 namespace curve {
 namespace chunkserver {
 
+namespace {
+// 用于判断crc之后是否存在变化追踪信息
+const uint32_t kChangedBlocksMagic = 0x43425431;
+
+void CopyChangedBlocks(const CSChunkChangedBlocks& from,
+                       CSChunkChangedBlocks* to) {
+    to->sn = from.sn;
+    to->baseSn = from.baseSn;
+    if (from.blocks != nullptr) {
+        to->blocks = std::make_shared<Bitmap>(*from.blocks);
+    } else {
+        to->blocks = nullptr;
+    }
+}
+
+void EncodeChangedBlocks(const CSChunkChangedBlocks& changed,
+                         uint32_t bits,
+                         char* buf,
+                         size_t* len) {
+    // bitmap大小不一致的记录不可用，按照没有记录处理
+    bool valid = changed.blocks != nullptr && changed.blocks->Size() == bits;
+    SequenceNum sn = valid ? changed.sn : kInvalidSeq;
+    SequenceNum baseSn = valid ? changed.baseSn : kInvalidSeq;
+    memcpy(buf + *len, &sn, sizeof(sn));
+    *len += sizeof(sn);
+    memcpy(buf + *len, &baseSn, sizeof(baseSn));
+    *len += sizeof(baseSn);
+    size_t blocksBytes = (bits + 8 - 1) >> 3;
+    if (valid) {
+        memcpy(buf + *len, changed.blocks->GetBitmap(), blocksBytes);
+    } else {
+        memset(buf + *len, 0, blocksBytes);
+    }
+    *len += blocksBytes;
+}
+
+void DecodeChangedBlocks(const char* buf,
+                         uint32_t bits,
+                         size_t* len,
+                         CSChunkChangedBlocks* changed) {
+    memcpy(&changed->sn, buf + *len, sizeof(changed->sn));
+    *len += sizeof(changed->sn);
+    memcpy(&changed->baseSn, buf + *len, sizeof(changed->baseSn));
+    *len += sizeof(changed->baseSn);
+    if (changed->baseSn != kInvalidSeq) {
+        changed->blocks = std::make_shared<Bitmap>(bits, buf + *len);
+    } else {
+        changed->sn = kInvalidSeq;
+        changed->blocks = nullptr;
+    }
+    *len += (bits + 8 - 1) >> 3;
+}
+
+size_t ChangedBlocksSize(uint32_t bits) {
+    size_t blocksBytes = (bits + 8 - 1) >> 3;
+    return sizeof(kChangedBlocksMagic) + sizeof(bits)
+           + 2 * (2 * sizeof(SequenceNum) + blocksBytes)
+           + sizeof(uint32_t);
+}
+}  // namespace
+
 ChunkFileMetaPage::ChunkFileMetaPage(const ChunkFileMetaPage& metaPage) {
     version = metaPage.version;
     sn = metaPage.sn;
@@ -41,6 +102,8 @@ ChunkFileMetaPage::ChunkFileMetaPage(const ChunkFileMetaPage& metaPage) {
     } else {
         bitmap = nullptr;
     }
+    CopyChangedBlocks(metaPage.changed, &changed);
+    CopyChangedBlocks(metaPage.snapChanged, &snapChanged);
 }
 
 ChunkFileMetaPage& ChunkFileMetaPage::operator =(
@@ -57,10 +120,12 @@ ChunkFileMetaPage& ChunkFileMetaPage::operator =(
     } else {
         bitmap = nullptr;
     }
+    CopyChangedBlocks(metaPage.changed, &changed);
+    CopyChangedBlocks(metaPage.snapChanged, &snapChanged);
     return *this;
 }
 
-void ChunkFileMetaPage::encode(char* buf) {
+void ChunkFileMetaPage::encode(char* buf, uint32_t size) {
     size_t len = 0;
     memcpy(buf, &version, sizeof(version));
     len += sizeof(version);
@@ -84,9 +149,36 @@ void ChunkFileMetaPage::encode(char* buf) {
     }
     uint32_t crc = ::curve::common::CRC32(buf, len);
     memcpy(buf + len, &crc, sizeof(crc));
+    len += sizeof(crc);
+
+    // 没有变化追踪信息时，格式与之前保持一致
+    uint32_t bits = 0;
+    if (changed.blocks != nullptr) {
+        bits = changed.blocks->Size();
+    } else if (snapChanged.blocks != nullptr) {
+        bits = snapChanged.blocks->Size();
+    }
+    if (bits == 0) {
+        return;
+    }
+    // metapage放不下时不记录，快照时按照没有变化信息处理
+    if (len + ChangedBlocksSize(bits) > size) {
+        LOG(WARNING) << "Metapage has no room for changed blocks, "
+                     << "bits: " << bits << ", size: " << size;
+        return;
+    }
+    size_t begin = len;
+    memcpy(buf + len, &kChangedBlocksMagic, sizeof(kChangedBlocksMagic));
+    len += sizeof(kChangedBlocksMagic);
+    memcpy(buf + len, &bits, sizeof(bits));
+    len += sizeof(bits);
+    EncodeChangedBlocks(changed, bits, buf, &len);
+    EncodeChangedBlocks(snapChanged, bits, buf, &len);
+    crc = ::curve::common::CRC32(buf + begin, len - begin);
+    memcpy(buf + len, &crc, sizeof(crc));
 }
 
-CSErrorCode ChunkFileMetaPage::decode(const char* buf) {
+CSErrorCode ChunkFileMetaPage::decode(const char* buf, uint32_t size) {
     size_t len = 0;
     memcpy(&version, buf, sizeof(version));
     len += sizeof(version);
@@ -125,6 +217,36 @@ CSErrorCode ChunkFileMetaPage::decode(const char* buf) {
                     << static_cast<uint32_t>(FORMAT_VERSION);
         return CSErrorCode::IncompatibleError;
     }
+    len += sizeof(recordCrc);
+
+    // 解析变化追踪信息，信息不存在或者不完整时不影响chunk的使用
+    changed = CSChunkChangedBlocks();
+    snapChanged = CSChunkChangedBlocks();
+    uint32_t magic = 0;
+    uint32_t bits = 0;
+    if (len + sizeof(magic) + sizeof(bits) > size) {
+        return CSErrorCode::Success;
+    }
+    memcpy(&magic, buf + len, sizeof(magic));
+    memcpy(&bits, buf + len + sizeof(magic), sizeof(bits));
+    if (magic != kChangedBlocksMagic) {
+        return CSErrorCode::Success;
+    }
+    size_t extSize = ChangedBlocksSize(bits);
+    if (bits == 0 || len + extSize > size) {
+        LOG(WARNING) << "Invalid changed blocks in metapage, bits: " << bits;
+        return CSErrorCode::Success;
+    }
+    size_t crcOffset = len + extSize - sizeof(recordCrc);
+    crc = ::curve::common::CRC32(buf + len, crcOffset - len);
+    memcpy(&recordCrc, buf + crcOffset, sizeof(recordCrc));
+    if (crc != recordCrc) {
+        LOG(WARNING) << "Checking crc32 of changed blocks failed.";
+        return CSErrorCode::Success;
+    }
+    len += sizeof(magic) + sizeof(bits);
+    DecodeChangedBlocks(buf, bits, &len, &changed);
+    DecodeChangedBlocks(buf, bits, &len, &snapChanged);
     return CSErrorCode::Success;
 }
 
@@ -137,6 +259,7 @@ CSChunkFile::CSChunkFile(std::shared_ptr<LocalFileSystem> lfs,
       chunkId_(options.id),
       baseDir_(options.baseDir),
       isCloneChunk_(false),
+      changeBlockSize_(options.changeBlockSize),
       snapshot_(nullptr),
       chunkfilePool_(chunkfilePool),
       lfs_(lfs),
@@ -186,7 +309,7 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
         && metaPage_.sn > 0) {
         char buf[pageSize_];  // NOLINT
         memset(buf, 0, sizeof(buf));
-        metaPage_.encode(buf);
+        metaPage_.encode(buf, pageSize_);
         int rc = chunkfilePool_->GetChunk(chunkFilePath, buf);
         // 并发创建文件时，可能前面线程已经创建成功，那么这里会返回-EEXIST
         // 此时可以继续open已经生成的文件
@@ -228,7 +351,30 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
         }
         isCloneChunk_ = true;
     }
-    return errCode;
+    if (errCode != CSErrorCode::Success) {
+        return errCode;
+    }
+
+    // 关闭变化追踪或者追踪粒度改变后，之后的写入不会再记录到已有的变化信息中，
+    // 需要清除这些信息，避免再次开启追踪时漏掉中间写过的区域
+    uint32_t bits = changeBlockSize_ > 0 ? size_ / changeBlockSize_ : 0;
+    bool invalidChanged = metaPage_.changed.blocks != nullptr
+                       && metaPage_.changed.blocks->Size() != bits;
+    bool invalidSnapChanged = metaPage_.snapChanged.blocks != nullptr
+                           && metaPage_.snapChanged.blocks->Size() != bits;
+    if (invalidChanged || invalidSnapChanged) {
+        ChunkFileMetaPage tempMeta = metaPage_;
+        tempMeta.changed = CSChunkChangedBlocks();
+        tempMeta.snapChanged = CSChunkChangedBlocks();
+        errCode = updateMetaPage(&tempMeta);
+        if (errCode != CSErrorCode::Success) {
+            LOG(ERROR) << "Clear changed blocks failed."
+                       << " filepath = " << chunkFilePath;
+            return errCode;
+        }
+        metaPage_ = tempMeta;
+    }
+    return CSErrorCode::Success;
 }
 
 CSErrorCode CSChunkFile::LoadSnapshot(SequenceNum sn) {
@@ -270,6 +416,31 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
                                size_t length,
                                uint32_t* cost) {
     WriteLockGuard writeGuard(rwLock_);
+    CSErrorCode errorCode = prepareWrite(sn, offset, length);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
+    int rc = writeData(buf, offset, length);
+    return finishWrite(rc, sn);
+}
+
+CSErrorCode CSChunkFile::Write(SequenceNum sn,
+                               const butil::IOBuf& buf,
+                               off_t offset,
+                               size_t length,
+                               uint32_t* cost) {
+    WriteLockGuard writeGuard(rwLock_);
+    CSErrorCode errorCode = prepareWrite(sn, offset, length);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
+    int rc = writeData(buf, offset, length);
+    return finishWrite(rc, sn);
+}
+
+CSErrorCode CSChunkFile::prepareWrite(SequenceNum sn,
+                                      off_t offset,
+                                      size_t length) {
     if (!CheckOffsetAndLength(offset, length)) {
         LOG(ERROR) << "Write chunk failed, invalid offset or length."
                    << "ChunkID: " << chunkId_
@@ -335,9 +506,18 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
         }
     }
     // 如果请求版本号大于当前chunk版本号，需要更新metapage
-    if (sn > metaPage_.sn) {
+    // 开启变化追踪时，写入的区域需要在写数据之前记录到metapage中
+    if (sn > metaPage_.sn || needTrackChange(offset, length)) {
         ChunkFileMetaPage tempMeta = metaPage_;
-        tempMeta.sn = sn;
+        if (sn > metaPage_.sn) {
+            switchChangedBlocks(sn, &tempMeta);
+            tempMeta.sn = sn;
+        }
+        if (tempMeta.changed.blocks != nullptr && tempMeta.changed.sn == sn) {
+            uint32_t beginIndex = offset / changeBlockSize_;
+            uint32_t endIndex = (offset + length - 1) / changeBlockSize_;
+            tempMeta.changed.blocks->Set(beginIndex, endIndex);
+        }
         CSErrorCode errorCode = updateMetaPage(&tempMeta);
         if (errorCode != CSErrorCode::Success) {
             LOG(ERROR) << "Update metapage failed."
@@ -346,7 +526,7 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
                        << ",chunk sn: " << metaPage_.sn;
             return errorCode;
         }
-        metaPage_.sn = tempMeta.sn;
+        metaPage_ = tempMeta;
     }
     // 判断是否要cow,若是先将数据拷贝到快照文件
     if (needCow(sn)) {
@@ -359,7 +539,10 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
             return errorCode;
         }
     }
-    int rc = writeData(buf, offset, length);
+    return CSErrorCode::Success;
+}
+
+CSErrorCode CSChunkFile::finishWrite(int rc, SequenceNum sn) {
     if (rc < 0) {
         LOG(ERROR) << "Write data to chunk file failed."
                    << "ChunkID: " << chunkId_
@@ -683,6 +866,25 @@ void CSChunkFile::GetInfo(CSChunkInfo* info)  {
         info->bitmap = nullptr;
 }
 
+void CSChunkFile::GetChangedBlocks(SequenceNum sn,
+                                   CSChunkChangedBlocks* changed) {
+    ReadLockGuard readGuard(rwLock_);
+    *changed = CSChunkChangedBlocks();
+    const CSChunkChangedBlocks* record = nullptr;
+    if (sn == metaPage_.sn) {
+        record = &metaPage_.changed;
+    } else if (snapshot_ != nullptr && sn == snapshot_->GetSn()) {
+        record = &metaPage_.snapChanged;
+    }
+    // 记录的版本与请求的版本不一致时，说明该版本没有记录变化信息
+    if (record == nullptr || record->sn != sn || record->blocks == nullptr) {
+        return;
+    }
+    changed->sn = record->sn;
+    changed->baseSn = record->baseSn;
+    changed->blocks = std::make_shared<Bitmap>(*record->blocks);
+}
+
 CSErrorCode CSChunkFile::GetHash(off_t offset,
                                  size_t length,
                                  std::string* hash)  {
@@ -763,10 +965,39 @@ bool CSChunkFile::needCow(SequenceNum sn) {
     return true;
 }
 
+bool CSChunkFile::needTrackChange(off_t offset, size_t length) {
+    const CSChunkChangedBlocks& changed = metaPage_.changed;
+    if (changeBlockSize_ == 0
+        || changed.blocks == nullptr
+        || changed.sn != metaPage_.sn) {
+        return false;
+    }
+    uint32_t beginIndex = offset / changeBlockSize_;
+    uint32_t endIndex = (offset + length - 1) / changeBlockSize_;
+    return changed.blocks->NextClearBit(beginIndex, endIndex)
+           != Bitmap::NO_POS;
+}
+
+void CSChunkFile::switchChangedBlocks(SequenceNum sn,
+                                      ChunkFileMetaPage* metaPage) {
+    if (changeBlockSize_ == 0) {
+        return;
+    }
+    // 快照文件保存的是旧版本的数据，旧版本的变化信息在快照删除之前仍然有用
+    if (snapshot_ != nullptr && snapshot_->GetSn() == metaPage->sn) {
+        metaPage->snapChanged = metaPage->changed;
+    }
+    // 新版本的数据是在旧版本的基础上写入的，从旧版本开始记录
+    metaPage->changed.sn = sn;
+    metaPage->changed.baseSn = metaPage->sn;
+    metaPage->changed.blocks =
+        std::make_shared<Bitmap>(size_ / changeBlockSize_);
+}
+
 CSErrorCode CSChunkFile::updateMetaPage(ChunkFileMetaPage* metaPage) {
     char buf[pageSize_];  // NOLINT
     memset(buf, 0, sizeof(buf));
-    metaPage->encode(buf);
+    metaPage->encode(buf, pageSize_);
     int rc = writeMetaPage(buf);
     if (rc < 0) {
         LOG(ERROR) << "Update metapage failed."
@@ -786,7 +1017,7 @@ CSErrorCode CSChunkFile::loadMetaPage() {
                    << " filepath = " << path();
         return CSErrorCode::InternalError;
     }
-    return metaPage_.decode(buf);
+    return metaPage_.decode(buf, pageSize_);
 }
 
 CSErrorCode CSChunkFile::copy2Snapshot(off_t offset, size_t length) {
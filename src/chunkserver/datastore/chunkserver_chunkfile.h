@@ -23,6 +23,7 @@
 #define SRC_CHUNKSERVER_DATASTORE_CHUNKSERVER_CHUNKFILE_H_
 
 #include <glog/logging.h>
+#include <butil/iobuf.h>
 #include <string>
 #include <vector>
 #include <set>
@@ -53,13 +54,24 @@ class ChunkfilePool;
 class CSSnapshot;
 struct DataStoreMetric;
 
+// metapage的默认大小
+const uint32_t kDefaultMetaPageSize = 4096;
+
 /**
  * Chunkfile Metapage Format
  * version: 1 byte
  * sn: 8 bytes
  * correctedSn: 8 bytes
  * crc: 4 bytes
- * padding: 4075 bytes
+ * 开启变化追踪时，crc之后追加变化追踪信息，旧版本解析时会忽略
+ * magic: 4 bytes
+ * bits: 4 bytes
+ * changed.sn, changed.baseSn: 16 bytes
+ * changed.blocks: (bits + 8 - 1) / 8 bytes
+ * snapChanged.sn, snapChanged.baseSn: 16 bytes
+ * snapChanged.blocks: (bits + 8 - 1) / 8 bytes
+ * crc: 4 bytes
+ * padding: 剩余部分
  */
 struct ChunkFileMetaPage {
     // 文件格式的版本
@@ -72,6 +84,10 @@ struct ChunkFileMetaPage {
     string location;
     // 表示当前Chunk中page的状态，如果不是CloneChunk则为nullptr
     std::shared_ptr<Bitmap> bitmap;
+    // 当前版本相对上一个版本写过的block
+    CSChunkChangedBlocks changed;
+    // 快照文件中保存的版本相对它的上一个版本写过的block
+    CSChunkChangedBlocks snapChanged;
 
     ChunkFileMetaPage() : version(FORMAT_VERSION)
                         , sn(0)
@@ -81,8 +97,13 @@ struct ChunkFileMetaPage {
     ChunkFileMetaPage(const ChunkFileMetaPage& metaPage);
     ChunkFileMetaPage& operator = (const ChunkFileMetaPage& metaPage);
 
-    void encode(char* buf);
-    CSErrorCode decode(const char* buf);
+    /**
+     * 序列化metapage，变化追踪信息超出metapage大小时不序列化
+     * @param buf: 序列化的目标buffer
+     * @param size: metapage的大小
+     */
+    void encode(char* buf, uint32_t size = kDefaultMetaPageSize);
+    CSErrorCode decode(const char* buf, uint32_t size = kDefaultMetaPageSize);
 };
 
 struct ChunkOptions {
@@ -100,6 +121,8 @@ struct ChunkOptions {
     ChunkSizeType   chunkSize;
     // page的大小，bitmap中每个bit表示1个page，metapage大小也是1个page
     PageSizeType    pageSize;
+    // 变化追踪的粒度，为0表示不追踪chunk各版本写过的区域
+    uint32_t        changeBlockSize;
     // datastore内部统计指标
     std::shared_ptr<DataStoreMetric> metric;
 
@@ -110,6 +133,7 @@ struct ChunkOptions {
                    , location("")
                    , chunkSize(0)
                    , pageSize(0)
+                   , changeBlockSize(0)
                    , metric(nullptr) {}
 };
 
@@ -151,6 +175,21 @@ class CSChunkFile {
                       off_t offset,
                       size_t length,
                       uint32_t* cost);
+    /**
+     * 以IOBuf形式写chunk文件，语义同上
+     * 数据不需要先拷贝成连续内存，通过向量写直接落盘，用于大IO的写入
+     * @param sn: 当前写请求的文件版本号
+     * @param buf: 请求写入的数据
+     * @param offset: 请求写入的偏移位置
+     * @param length: 请求写入的数据长度
+     * @param cost: 此次请求实际产生的IO次数，用于QOS控制
+     * @return: 返回错误码
+     */
+    CSErrorCode Write(SequenceNum sn,
+                      const butil::IOBuf& buf,
+                      off_t offset,
+                      size_t length,
+                      uint32_t* cost);
     /**
      * 将拷贝的数据写入Chunk中
      * 只会写入未写过的区域，不会覆盖已经写过的区域
@@ -203,6 +242,13 @@ class CSChunkFile {
      * 调用fsync将snapshot文件在pagecache中的数据刷盘
      */
     void GetInfo(CSChunkInfo* info);
+    /**
+     * 获取指定版本相对上一个版本写过的block，用于增量快照
+     * 可能存在并发，加读锁
+     * @param sn: 当前chunk或者快照文件的版本号
+     * @param changed: 写过的block，没有记录时baseSn为0
+     */
+    void GetChangedBlocks(SequenceNum sn, CSChunkChangedBlocks* changed);
     /**
      * 获取chunk的hash值，此接口一般用于测试调用
      * @param[out]: chunk hash值
@@ -225,6 +271,36 @@ class CSChunkFile {
      * @return: true 表示要cow；false 表示不需要cow
      */
     bool needCow(SequenceNum sn);
+    /**
+     * 判断写入区域是否有block未记录到当前版本的变化追踪信息中
+     * @param offset: 写入数据区域的起始偏移
+     * @param length: 写入数据区域的长度
+     * @return: true 表示需要在写数据前更新metapage
+     */
+    bool needTrackChange(off_t offset, size_t length);
+    /**
+     * chunk版本变化时开始追踪新版本写过的block
+     * 如果快照文件保存的是旧版本的数据，旧版本的变化信息随之保留
+     * @param sn: 写请求的版本号
+     * @param metaPage: 待更新的metapage
+     */
+    void switchChangedBlocks(SequenceNum sn, ChunkFileMetaPage* metaPage);
+    /**
+     * 写数据前的检查和准备工作，包括参数检查、创建快照、更新版本号以及cow
+     * 调用方需持有写锁
+     * @param sn:写请求的版本号
+     * @param offset: 写入数据区域的起始偏移
+     * @param length: 写入数据区域的长度
+     * @return: 返回错误码
+     */
+    CSErrorCode prepareWrite(SequenceNum sn, off_t offset, size_t length);
+    /**
+     * 写数据后的收尾工作，检查写入结果，clone chunk需更新bitmap
+     * @param rc: 写数据的返回值
+     * @param sn:写请求的版本号
+     * @return: 返回错误码
+     */
+    CSErrorCode finishWrite(int rc, SequenceNum sn);
     /**
      * 将metapage持久化
      * @param metaPage:需要持久化到磁盘的metapage,
@@ -275,6 +351,22 @@ class CSChunkFile {
         if (rc < 0) {
             return rc;
         }
+        markDirtyPages(offset, length);
+        return rc;
+    }
+
+    inline int writeData(const butil::IOBuf& buf,
+                         off_t offset,
+                         size_t length) {
+        int rc = lfs_->Writev(fd_, buf, offset + pageSize_, length);
+        if (rc < 0) {
+            return rc;
+        }
+        markDirtyPages(offset, length);
+        return rc;
+    }
+
+    inline void markDirtyPages(off_t offset, size_t length) {
         // 如果是clone chunk，需要判断是否需要更改bitmap并更新metapage
         if (isCloneChunk_) {
             uint32_t beginIndex = offset / pageSize_;
@@ -286,7 +378,6 @@ class CSChunkFile {
                 }
             }
         }
-        return rc;
     }
 
     inline bool CheckOffsetAndLength(off_t offset, size_t len) {
@@ -321,6 +412,8 @@ class CSChunkFile {
     std::string baseDir_;
     // 是否为clone chunk
     bool isCloneChunk_;
+    // 变化追踪的粒度，为0表示不追踪
+    uint32_t changeBlockSize_;
     // chunk的metapage
     ChunkFileMetaPage metaPage_;
     // 被写过但还未更新到metapage中的page索引
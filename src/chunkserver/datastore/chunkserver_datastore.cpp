@@ -41,11 +41,22 @@ CSDataStore::CSDataStore(std::shared_ptr<LocalFileSystem> lfs,
       pageSize_(options.pageSize),
       baseDir_(options.baseDir),
       locationLimit_(options.locationLimit),
+      changeBlockSize_(options.changeBlockSize),
       chunkfilePool_(chunkfilePool),
       lfs_(lfs) {
     CHECK(!baseDir_.empty()) << "Create datastore failed";
     CHECK(lfs_ != nullptr) << "Create datastore failed";
     CHECK(chunkfilePool_ != nullptr) << "Create datastore failed";
+    // 追踪粒度需要是page的整数倍，且能整除chunk大小
+    if (changeBlockSize_ > 0
+        && (changeBlockSize_ % pageSize_ != 0
+            || chunkSize_ % changeBlockSize_ != 0)) {
+        LOG(WARNING) << "Invalid change block size " << changeBlockSize_
+                     << ", page size: " << pageSize_
+                     << ", chunk size: " << chunkSize_
+                     << ", disable change tracking.";
+        changeBlockSize_ = 0;
+    }
 }
 
 CSDataStore::~CSDataStore() {
@@ -214,15 +225,67 @@ CSErrorCode CSDataStore::WriteChunk(ChunkID id,
                             size_t length,
                             uint32_t* cost,
                             const std::string & cloneSourceLocation)  {
+    CSChunkFilePtr chunkFile;
+    CSErrorCode errorCode =
+        getChunkFileForWrite(id, sn, cloneSourceLocation, &chunkFile);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
+    // 写chunk文件
+    errorCode = chunkFile->Write(sn,
+                                 buf,
+                                 offset,
+                                 length,
+                                 cost);
+    if (errorCode != CSErrorCode::Success) {
+        LOG(WARNING) << "Write chunk file failed."
+                     << "ChunkID = " << id;
+        return errorCode;
+    }
+    return CSErrorCode::Success;
+}
+
+CSErrorCode CSDataStore::WriteChunk(ChunkID id,
+                            SequenceNum sn,
+                            const butil::IOBuf& buf,
+                            off_t offset,
+                            size_t length,
+                            uint32_t* cost,
+                            const std::string & cloneSourceLocation)  {
+    CSChunkFilePtr chunkFile;
+    CSErrorCode errorCode =
+        getChunkFileForWrite(id, sn, cloneSourceLocation, &chunkFile);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
+    // 写chunk文件
+    errorCode = chunkFile->Write(sn,
+                                 buf,
+                                 offset,
+                                 length,
+                                 cost);
+    if (errorCode != CSErrorCode::Success) {
+        LOG(WARNING) << "Write chunk file failed."
+                     << "ChunkID = " << id;
+        return errorCode;
+    }
+    return CSErrorCode::Success;
+}
+
+CSErrorCode CSDataStore::getChunkFileForWrite(
+    ChunkID id,
+    SequenceNum sn,
+    const std::string& cloneSourceLocation,
+    CSChunkFilePtr* chunkFile) {
     // 请求版本号不允许为0，snapsn=0时会当做快照不存在的判断依据
     if (sn == kInvalidSeq) {
         LOG(ERROR) << "Sequence num should not be zero."
                    << "ChunkID = " << id;
         return CSErrorCode::InvalidArgError;
     }
-    auto chunkFile = metaCache_.Get(id);
+    *chunkFile = metaCache_.Get(id);
     // 如果chunk文件不存在，则先创建chunk文件
-    if (chunkFile == nullptr) {
+    if (*chunkFile == nullptr) {
         ChunkOptions options;
         options.id = id;
         options.sn = sn;
@@ -230,22 +293,9 @@ CSErrorCode CSDataStore::WriteChunk(ChunkID id,
         options.chunkSize = chunkSize_;
         options.location = cloneSourceLocation;
         options.pageSize = pageSize_;
+        options.changeBlockSize = changeBlockSize_;
         options.metric = metric_;
-        CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
-        if (errorCode != CSErrorCode::Success) {
-            return errorCode;
-        }
-    }
-    // 写chunk文件
-    CSErrorCode errorCode = chunkFile->Write(sn,
-                                             buf,
-                                             offset,
-                                             length,
-                                             cost);
-    if (errorCode != CSErrorCode::Success) {
-        LOG(WARNING) << "Write chunk file failed."
-                     << "ChunkID = " << id;
-        return errorCode;
+        return CreateChunkFile(options, chunkFile);
     }
     return CSErrorCode::Success;
 }
@@ -278,6 +328,7 @@ CSErrorCode CSDataStore::CreateCloneChunk(ChunkID id,
         options.baseDir = baseDir_;
         options.chunkSize = chunkSize_;
         options.pageSize = pageSize_;
+        options.changeBlockSize = changeBlockSize_;
         options.metric = metric_;
         CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
         if (errorCode != CSErrorCode::Success) {
@@ -304,6 +355,44 @@ CSErrorCode CSDataStore::CreateCloneChunk(ChunkID id,
     return CSErrorCode::Success;
 }
 
+CSErrorCode CSDataStore::CreateCloneChunks(
+    const std::vector<CloneChunkDesc>& chunks,
+    SequenceNum correctedSn,
+    ChunkSizeType size,
+    std::vector<ChunkID>* conflictIds) {
+    // 先检查所有chunk的参数，避免只创建了一部分chunk
+    for (const auto& chunk : chunks) {
+        if (size != chunkSize_
+            || chunk.sn == kInvalidSeq
+            || chunk.location.empty()
+            || chunk.location.size() > locationLimit_) {
+            LOG(ERROR) << "Invalid arguments."
+                       << "ChunkID = " << chunk.id
+                       << ", sn = " << chunk.sn
+                       << ", correctedSn = " << correctedSn
+                       << ", size = " << size
+                       << ", location = " << chunk.location;
+            return CSErrorCode::InvalidArgError;
+        }
+    }
+    for (const auto& chunk : chunks) {
+        CSErrorCode errorCode = CreateCloneChunk(chunk.id,
+                                                 chunk.sn,
+                                                 correctedSn,
+                                                 size,
+                                                 chunk.location);
+        if (errorCode == CSErrorCode::ChunkConflictError) {
+            conflictIds->push_back(chunk.id);
+        } else if (errorCode != CSErrorCode::Success) {
+            LOG(ERROR) << "Create clone chunks failed."
+                       << "ChunkID = " << chunk.id
+                       << ", ErrorCode = " << errorCode;
+            return errorCode;
+        }
+    }
+    return CSErrorCode::Success;
+}
+
 CSErrorCode CSDataStore::PasteChunk(ChunkID id,
                                     const char * buf,
                                     off_t offset,
@@ -336,6 +425,19 @@ CSErrorCode CSDataStore::GetChunkInfo(ChunkID id,
     return CSErrorCode::Success;
 }
 
+CSErrorCode CSDataStore::GetChunkChangedBlocks(ChunkID id,
+                                               SequenceNum sn,
+                                               CSChunkChangedBlocks* changed) {
+    auto chunkFile = metaCache_.Get(id);
+    if (chunkFile == nullptr) {
+        LOG(INFO) << "Get changed blocks failed, Chunk not exists."
+                  << "ChunkID = " << id;
+        return CSErrorCode::ChunkNotExistError;
+    }
+    chunkFile->GetChangedBlocks(sn, changed);
+    return CSErrorCode::Success;
+}
+
 CSErrorCode CSDataStore::GetChunkHash(ChunkID id,
                                       off_t offset,
                                       size_t length,
@@ -366,6 +468,7 @@ CSErrorCode CSDataStore::loadChunkFile(ChunkID id) {
         options.baseDir = baseDir_;
         options.chunkSize = chunkSize_;
         options.pageSize = pageSize_;
+        options.changeBlockSize = changeBlockSize_;
         options.metric = metric_;
         CSChunkFilePtr chunkFilePtr =
             std::make_shared<CSChunkFile>(lfs_,
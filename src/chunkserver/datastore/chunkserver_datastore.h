@@ -56,6 +56,13 @@ struct DataStoreOptions {
     ChunkSizeType                       chunkSize;
     PageSizeType                        pageSize;
     uint32_t                            locationLimit;
+    // 变化追踪的粒度，为0表示不追踪chunk各版本写过的区域
+    uint32_t                            changeBlockSize;
+
+    DataStoreOptions() : chunkSize(0)
+                       , pageSize(0)
+                       , locationLimit(0)
+                       , changeBlockSize(0) {}
 };
 
 /**
@@ -86,6 +93,18 @@ struct DataStoreMetric {
 };
 using DataStoreMetricPtr = std::shared_ptr<DataStoreMetric>;
 
+/**
+ * 批量创建clone chunk时每个chunk的信息
+ * id:要创建的chunk id
+ * sn:要创建的chunk的版本号
+ * location:数据源位置信息
+ */
+struct CloneChunkDesc {
+    ChunkID         id;
+    SequenceNum     sn;
+    std::string     location;
+};
+
 using ChunkMap = std::unordered_map<ChunkID, CSChunkFilePtr>;
 // 为chunkid到chunkfile的映射，使用读写锁对map的操作进行保护
 class CSMetaCache {
@@ -210,6 +229,25 @@ class CSDataStore {
                                 size_t length,
                                 uint32_t* cost,
                                 const std::string & cloneSourceLocation = "");
+    /**
+     * 以IOBuf形式写数据，语义同上
+     * 数据以向量写的方式直接落盘，避免将请求数据拷贝成连续内存
+     * @param id：要写入的chunk id
+     * @param sn：当前写请求发出时用户文件的版本号
+     * @param buf：要写入的数据内容
+     * @param offset：请求写入的偏移地址
+     * @param length：请求写入的数据长度
+     * @param cost：实际产生的IO次数，用于QOS控制
+     * @param cloneSource：表示从curvefs clone的地址
+     * @return：返回错误码
+     */
+    virtual CSErrorCode WriteChunk(ChunkID id,
+                                SequenceNum sn,
+                                const butil::IOBuf& buf,
+                                off_t offset,
+                                size_t length,
+                                uint32_t* cost,
+                                const std::string & cloneSourceLocation = "");
     /**
      * 创建克隆的Chunk，chunk中记录数据源位置信息
      * 该接口需要保证幂等性，重复以相同参数进行创建返回成功
@@ -226,6 +264,22 @@ class CSDataStore {
                                          SequenceNum correctedSn,
                                          ChunkSizeType size,
                                          const string& location);
+    /**
+     * 批量创建克隆的Chunk，克隆时同一copyset上的chunk通过一次请求创建
+     * 先检查所有chunk的参数，参数不合法时不会创建任何chunk；
+     * 已存在且信息与参数不符的chunk记录到conflictIds中，继续创建后面的chunk；
+     * 遇到其他错误时直接返回，重试时已创建的chunk会返回成功
+     * @param chunks：要创建的chunk
+     * @param correctedSn：修改chunk的correctedSn
+     * @param size：要创建的chunk大小
+     * @param conflictIds：已存在且信息与参数不符的chunk
+     * @return：返回错误码
+     */
+    virtual CSErrorCode CreateCloneChunks(
+        const std::vector<CloneChunkDesc>& chunks,
+        SequenceNum correctedSn,
+        ChunkSizeType size,
+        std::vector<ChunkID>* conflictIds);
     /**
      * 将从源端拷贝的数据写到本地，不会覆盖已写入的数据区域
      * @param id：要写入的chunk id
@@ -246,6 +300,17 @@ class CSDataStore {
     virtual CSErrorCode GetChunkInfo(ChunkID id,
                                      CSChunkInfo* chunkInfo);
 
+    /**
+     * 获取chunk指定版本相对上一个版本写过的block，用于增量快照
+     * @param id：请求获取的chunk的id
+     * @param sn：chunk或者快照文件的版本号
+     * @param changed：写过的block，没有记录时baseSn为0
+     * @return：返回错误码
+     */
+    virtual CSErrorCode GetChunkChangedBlocks(ChunkID id,
+                                              SequenceNum sn,
+                                              CSChunkChangedBlocks* changed);
+
     /**
      * 获取Chunk的hash值
      * @param id[in]: chunk id
@@ -265,6 +330,10 @@ class CSDataStore {
     CSErrorCode loadChunkFile(ChunkID id);
     CSErrorCode CreateChunkFile(const ChunkOptions & ops,
                                 CSChunkFilePtr* chunkFile);
+    CSErrorCode getChunkFileForWrite(ChunkID id,
+                                     SequenceNum sn,
+                                     const std::string& cloneSourceLocation,
+                                     CSChunkFilePtr* chunkFile);
 
  private:
     // 每个chunk的大小
@@ -273,6 +342,8 @@ class CSDataStore {
     PageSizeType pageSize_;
     // clone chunk location长度限制
     uint32_t locationLimit_;
+    // 变化追踪的粒度，为0表示不追踪
+    uint32_t changeBlockSize_;
     // datastore的管理目录
     std::string baseDir_;
     // 为chunkid->chunkfile的映射
@@ -128,6 +128,20 @@ struct CSChunkInfo {
     }
 };
 
+// chunk某个版本相对上一个版本写过的区域，用于增量快照
+struct CSChunkChangedBlocks {
+    // 记录的chunk版本号
+    SequenceNum sn;
+    // 相对的上一个版本号，为0表示没有记录
+    SequenceNum baseSn;
+    // 相对baseSn写过的block，每个bit表示一个block
+    std::shared_ptr<Bitmap> blocks;
+
+    CSChunkChangedBlocks() : sn(0)
+                           , baseSn(0)
+                           , blocks(nullptr) {}
+};
+
 }  // namespace chunkserver
 }  // namespace curve
 
@@ -92,6 +92,12 @@ int Heartbeat::Init(const HeartbeatOptions &options) {
 
     // 获取当前unix时间戳
     startUpTime_ = ::curve::common::TimeUtility::GetTimeofDaySec();
+
+    // 启动后第一次心跳全量上报
+    lastReported_.clear();
+    mdsSupportDelta_ = false;
+    needFullReport_ = true;
+    deltaReportCount_ = 0;
     return 0;
 }
 
@@ -340,6 +346,53 @@ void Heartbeat::DumpHeartbeatResponse(const HeartbeatResponse& response) {
     }
 }
 
+bool Heartbeat::CanDeltaReport() {
+    // mds不支持增量心跳(例如旧版本的mds)时始终全量上报
+    return options_.deltaReport && mdsSupportDelta_ && !needFullReport_ &&
+           deltaReportCount_ < options_.fullReportInterval;
+}
+
+void Heartbeat::FilterDeltaRequest(HeartbeatRequest* request) {
+    google::protobuf::RepeatedPtrField<curve::mds::heartbeat::CopySetInfo>
+        changed;
+    for (int i = 0; i < request->copysetinfos_size(); i++) {
+        const curve::mds::heartbeat::CopySetInfo& info =
+            request->copysetinfos(i);
+        auto iter = lastReported_.find(
+            ToGroupNid(info.logicalpoolid(), info.copysetid()));
+        if (iter == lastReported_.end() ||
+            HeartbeatHelper::CopySetInfoChanged(iter->second, info)) {
+            *changed.Add() = info;
+        }
+    }
+
+    request->mutable_copysetinfos()->Swap(&changed);
+    request->set_isdeltareport(true);
+}
+
+void Heartbeat::UpdateLastReported(const HeartbeatRequest& request,
+                                   const std::set<GroupNid>& allCopysets) {
+    if (!request.isdeltareport()) {
+        lastReported_.clear();
+    }
+
+    for (int i = 0; i < request.copysetinfos_size(); i++) {
+        const curve::mds::heartbeat::CopySetInfo& info =
+            request.copysetinfos(i);
+        lastReported_[ToGroupNid(info.logicalpoolid(), info.copysetid())] =
+            info;
+    }
+
+    // 已经不在该chunkserver上的copyset不再比较
+    for (auto iter = lastReported_.begin(); iter != lastReported_.end();) {
+        if (allCopysets.count(iter->first) == 0) {
+            iter = lastReported_.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
 int Heartbeat::SendHeartbeat(const HeartbeatRequest& request,
                              HeartbeatResponse* response) {
     brpc::Channel channel;
@@ -515,14 +568,33 @@ void Heartbeat::HeartbeatWorker() {
             continue;
         }
 
-        LOG(INFO) << "sending heartbeat info";
+        std::set<GroupNid> allCopysets;
+        for (int i = 0; i < req.copysetinfos_size(); i++) {
+            allCopysets.insert(ToGroupNid(req.copysetinfos(i).logicalpoolid(),
+                                          req.copysetinfos(i).copysetid()));
+        }
+        if (CanDeltaReport()) {
+            FilterDeltaRequest(&req);
+        }
+
+        LOG(INFO) << "sending heartbeat info, delta report: "
+                  << req.isdeltareport() << ", copyset reported: "
+                  << req.copysetinfos_size() << "/" << allCopysets.size();
         ret = SendHeartbeat(req, &resp);
         if (ret != 0) {
             LOG(WARNING) << "Failed to send heartbeat to MDS";
+            // 可能切换了mds，下一次全量上报
+            needFullReport_ = true;
             ::sleep(errorIntervalSec);
             continue;
         }
 
+        UpdateLastReported(req, allCopysets);
+        deltaReportCount_ = req.isdeltareport() ? deltaReportCount_ + 1 : 0;
+        mdsSupportDelta_ = resp.supportdeltareport();
+        needFullReport_ = resp.needfullreport() ||
+            resp.statuscode() != curve::mds::heartbeat::hbOK;
+
         LOG(INFO) << "executing heartbeat info";
         ret = ExecTask(resp);
         if (ret != 0) {
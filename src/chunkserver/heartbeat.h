@@ -28,6 +28,7 @@
 #include <braft/node.h>                  // NodeImpl
 
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
 #include <atomic>
@@ -70,6 +71,10 @@ struct HeartbeatOptions {
     uint32_t                port;
     uint32_t                intervalSec;
     uint32_t                timeout;
+    // 是否开启增量心跳，只上报发生变化的copyset
+    bool                    deltaReport;
+    // 开启增量心跳时，每隔多少次心跳进行一次全量上报
+    uint32_t                fullReportInterval;
     CopysetNodeManager*     copysetNodeManager;
 
     std::shared_ptr<LocalFileSystem> fs;
@@ -130,6 +135,22 @@ class Heartbeat {
      */
     int BuildRequest(HeartbeatRequest* request);
 
+    /*
+     * 判断本次心跳是否可以增量上报
+     */
+    bool CanDeltaReport();
+
+    /*
+     * 过滤出与上一次上报相比发生变化的copyset，构建增量心跳请求
+     */
+    void FilterDeltaRequest(HeartbeatRequest* request);
+
+    /*
+     * 心跳发送成功后更新上一次上报的copyset信息
+     */
+    void UpdateLastReported(const HeartbeatRequest& request,
+                            const std::set<GroupNid>& allCopysets);
+
     /*
      * 发送心跳消息
      */
@@ -186,6 +207,18 @@ class Heartbeat {
 
     // 模块初始化时间, unix时间
     uint64_t startUpTime_;
+
+    // 上一次成功上报给mds的copyset信息，增量心跳时用于比较
+    std::map<GroupNid, curve::mds::heartbeat::CopySetInfo> lastReported_;
+
+    // mds是否支持增量心跳
+    bool mdsSupportDelta_;
+
+    // 下一次心跳是否需要全量上报
+    bool needFullReport_;
+
+    // 上一次全量上报之后的增量心跳次数
+    uint32_t deltaReportCount_;
 };
 
 }  // namespace chunkserver
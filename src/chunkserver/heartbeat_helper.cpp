@@ -23,6 +23,7 @@
 #include <butil/endpoint.h>
 #include <brpc/channel.h>
 #include <brpc/controller.h>
+#include <algorithm>
 #include <string>
 #include "src/chunkserver/heartbeat_helper.h"
 #include "include/chunkserver/chunkserver_common.h"
@@ -139,6 +140,46 @@ bool HeartbeatHelper::ChunkServerLoadCopySetFin(const std::string peerId) {
     return rep.copysetloadfin();
 }
 
+
+static bool StatChanged(uint32_t last, uint32_t cur) {
+    uint32_t base = std::max(last, cur);
+    uint32_t diff = last > cur ? last - cur : cur - last;
+    return diff > base * kCopysetStatChangeRatio;
+}
+
+bool HeartbeatHelper::CopySetInfoChanged(const CopySetInfo &last,
+                                         const CopySetInfo &cur) {
+    if (last.epoch() != cur.epoch() ||
+        last.leaderpeer().address() != cur.leaderpeer().address() ||
+        last.peers_size() != cur.peers_size()) {
+        return true;
+    }
+
+    for (int i = 0; i < cur.peers_size(); i++) {
+        if (last.peers(i).address() != cur.peers(i).address()) {
+            return true;
+        }
+    }
+
+    // 配置变更的进度需要及时上报给mds
+    if (last.has_configchangeinfo() || cur.has_configchangeinfo()) {
+        return true;
+    }
+
+    if (last.has_stats() != cur.has_stats()) {
+        return true;
+    }
+    if (!cur.has_stats()) {
+        return false;
+    }
+
+    const CopysetStatistics &lastStat = last.stats();
+    const CopysetStatistics &curStat = cur.stats();
+    return StatChanged(lastStat.readrate(), curStat.readrate()) ||
+           StatChanged(lastStat.writerate(), curStat.writerate()) ||
+           StatChanged(lastStat.readiops(), curStat.readiops()) ||
+           StatChanged(lastStat.writeiops(), curStat.writeiops());
+}
 }  // namespace chunkserver
 }  // namespace curve
 
@@ -33,9 +33,14 @@
 namespace curve {
 namespace chunkserver {
 using ::curve::mds::heartbeat::CopySetConf;
+using ::curve::mds::heartbeat::CopySetInfo;
+using ::curve::mds::heartbeat::CopysetStatistics;
 using ::curve::common::Peer;
 using CopysetNodePtr = std::shared_ptr<CopysetNode>;
 
+// copyset的io统计变化超过该比例时，增量心跳中需要上报
+const double kCopysetStatChangeRatio = 0.2;
+
 class HeartbeatHelper {
  public:
     /**
@@ -90,6 +95,20 @@ class HeartbeatHelper {
      * @return false-copyset加载完毕 true-copyset未加载完成
      */
     static bool ChunkServerLoadCopySetFin(const std::string ipPort);
+
+    /**
+     * 判断copyset的信息与上一次上报相比是否发生了变化，以下情况认为发生变化:
+     * 1. epoch、leader或者成员发生变化
+     * 2. 有正在进行的配置变更
+     * 3. io统计的变化超过kCopysetStatChangeRatio
+     *
+     * @param[in] last 上一次上报的copyset信息
+     * @param[in] cur 当前的copyset信息
+     *
+     * @return false-没有变化，增量心跳中无需上报 true-发生变化
+     */
+    static bool CopySetInfoChanged(const CopySetInfo &last,
+                                   const CopySetInfo &cur);
 };
 }  // namespace chunkserver
 }  // namespace curve
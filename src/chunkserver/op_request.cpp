@@ -29,6 +29,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "src/chunkserver/copyset_node.h"
 #include "src/chunkserver/chunk_closure.h"
@@ -167,6 +168,10 @@ std::shared_ptr<ChunkOpRequest> ChunkOpRequest::Decode(butil::IOBuf log,
             return std::make_shared<PasteChunkInternalRequest>();
         case CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE:
             return std::make_shared<CreateCloneChunkRequest>();
+        case CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH:
+            return std::make_shared<CreateCloneChunksRequest>();
+        case CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH:
+            return std::make_shared<DeleteChunksRequest>();
         default:LOG(ERROR) << "Unknown chunk op";
             return nullptr;
     }
@@ -225,6 +230,70 @@ void DeleteChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
     }
 }
 
+CSErrorCode DeleteChunksRequest::DeleteChunks(
+    std::shared_ptr<CSDataStore> datastore,
+    const ChunkRequest &request) {
+    for (auto chunkId : request.deletechunkids()) {
+        auto ret = datastore->DeleteChunk(chunkId, request.sn());
+        if (CSErrorCode::Success != ret) {
+            LOG(ERROR) << "delete chunks failed at chunkid: " << chunkId;
+            return ret;
+        }
+    }
+    return CSErrorCode::Success;
+}
+
+void DeleteChunksRequest::OnApply(uint64_t index,
+                                  ::google::protobuf::Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+
+    auto ret = DeleteChunks(datastore_, *request_);
+    if (CSErrorCode::Success == ret) {
+        response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        node_->UpdateAppliedIndex(index);
+    } else if (CSErrorCode::InternalError == ret) {
+        LOG(FATAL) << "delete chunks failed: "
+                   << " logic pool id: " << request_->logicpoolid()
+                   << " copyset id: " << request_->copysetid()
+                   << " chunk count: " << request_->deletechunkids_size()
+                   << " data store return: " << ret;
+    } else {
+        LOG(ERROR) << "delete chunks failed: "
+                   << " logic pool id: " << request_->logicpoolid()
+                   << " copyset id: " << request_->copysetid()
+                   << " chunk count: " << request_->deletechunkids_size()
+                   << " data store return: " << ret;
+        response_->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+    }
+    auto maxIndex =
+        (index > node_->GetAppliedIndex() ? index : node_->GetAppliedIndex());
+    response_->set_appliedindex(maxIndex);
+}
+
+void DeleteChunksRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,  //NOLINT
+                                         const ChunkRequest &request,
+                                         const butil::IOBuf &data) {
+    // NOTE: 处理过程中优先使用参数传入的datastore/request
+    auto ret = DeleteChunks(datastore, request);
+    if (CSErrorCode::Success == ret)
+        return;
+
+    if (CSErrorCode::InternalError == ret) {
+        LOG(FATAL) << "delete chunks failed: "
+                   << request.logicpoolid() << ", "
+                   << request.copysetid()
+                   << " chunk count: " << request.deletechunkids_size()
+                   << " data store return: " << ret;
+    } else {
+        LOG(ERROR) << "delete chunks failed: "
+                   << request.logicpoolid() << ", "
+                   << request.copysetid()
+                   << " chunk count: " << request.deletechunkids_size()
+                   << " data store return: " << ret;
+    }
+}
+
 ReadChunkRequest::ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
                                    CloneManager* cloneMgr,
                                    RpcController *cntl,
@@ -234,15 +303,28 @@ ReadChunkRequest::ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
     ChunkOpRequest(nodePtr, cntl, request, response, done),
     cloneMgr_(cloneMgr),
     concurrentApplyModule_(nodePtr->GetConcurrentApplyModule()),
-    applyIndex(0) {
+    applyIndex(0),
+    followerRead_(false) {
 }
 
 void ReadChunkRequest::Process() {
     brpc::ClosureGuard doneGuard(done_);
 
+    bool appliedIndexRead = request_->has_appliedindex()
+        && node_->GetAppliedIndex() >= request_->appliedindex();
+
+    /**
+     * follower上只处理携带了applied index且本节点已经apply到该index的普通读请求
+     * (follower read)，client据此保证能读到自己已经写成功的数据；
+     * 其余请求以及applied index落后的情况都重定向给leader
+     */
     if (!node_->IsLeaderTerm()) {
-        RedirectChunkRequest();
-        return;
+        if (!appliedIndexRead
+            || request_->optype() != CHUNK_OP_TYPE::CHUNK_OP_READ) {
+            RedirectChunkRequest();
+            return;
+        }
+        followerRead_ = true;
     }
 
     /**
@@ -250,8 +332,7 @@ void ReadChunkRequest::Process() {
      * 的最新applied index，或者 op类型为CHUNK_OP_RECOVER
      * 那么不需要走一致性协议
      */
-    if ((request_->has_appliedindex()
-        && node_->GetAppliedIndex() >= request_->appliedindex())
+    if (appliedIndexRead
         || request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_RECOVER) {
         /**
          * 构造shared_ptr<ReadChunkRequest>，因为在ChunkOpRequest只指定了
@@ -325,6 +406,11 @@ void ReadChunkRequest::OnApply(uint64_t index,
         }
         // 如果需要从源端拷贝数据，需要将请求转发给clone manager处理
         if ( needLazyClone || NeedClone(chunkInfo) ) {
+            // clone后的数据需要经过raft paste到chunk中，只能由leader处理
+            if (followerRead_) {
+                RedirectChunkRequest();
+                break;
+            }
             applyIndex = index;
             std::shared_ptr<CloneTask> cloneTask =
             cloneMgr_->GenerateCloneTask(
@@ -446,9 +532,10 @@ void WriteChunkRequest::OnApply(uint64_t index,
                             request_->clonefileoffset());
     }
 
+    // 直接以IOBuf下发，由datastore向量写落盘，大IO不再整块拷贝
     auto ret = datastore_->WriteChunk(request_->chunkid(),
                                       request_->sn(),
-                                      cntl_->request_attachment().to_string().c_str(),  //NOLINT
+                                      cntl_->request_attachment(),
                                       request_->offset(),
                                       request_->size(),
                                       &cost,
@@ -512,7 +599,7 @@ void WriteChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
 
     auto ret = datastore->WriteChunk(request.chunkid(),
                                      request.sn(),
-                                     data.to_string().c_str(),
+                                     data,
                                      request.offset(),
                                      request.size(),
                                      &cost,
@@ -790,6 +877,92 @@ void CreateCloneChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datast
     }
 }
 
+CSErrorCode CreateCloneChunksRequest::CreateChunks(
+    std::shared_ptr<CSDataStore> datastore,
+    const ChunkRequest &request,
+    std::vector<ChunkID> *conflictIds) {
+    std::vector<CloneChunkDesc> chunks;
+    chunks.reserve(request.clonechunks_size());
+    for (const auto &meta : request.clonechunks()) {
+        CloneChunkDesc chunk;
+        chunk.id = meta.chunkid();
+        chunk.sn = meta.sn();
+        chunk.location = meta.location();
+        chunks.emplace_back(std::move(chunk));
+    }
+    return datastore->CreateCloneChunks(chunks,
+                                        request.correctedsn(),
+                                        request.size(),
+                                        conflictIds);
+}
+
+void CreateCloneChunksRequest::OnApply(uint64_t index,
+                                       ::google::protobuf::Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+
+    std::vector<ChunkID> conflictIds;
+    auto ret = CreateChunks(datastore_, *request_, &conflictIds);
+
+    if (CSErrorCode::Success == ret) {
+        response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        for (auto id : conflictIds) {
+            response_->add_existchunkids(id);
+        }
+        node_->UpdateAppliedIndex(index);
+    } else if (CSErrorCode::InternalError == ret ||
+               CSErrorCode::CrcCheckError == ret ||
+               CSErrorCode::FileFormatError == ret) {
+        LOG(FATAL) << "create clone chunks failed: "
+                   << " logic pool id: " << request_->logicpoolid()
+                   << " copyset id: " << request_->copysetid()
+                   << " chunk count: " << request_->clonechunks_size()
+                   << " correctedSn: " << request_->correctedsn()
+                   << " data store return: " << ret;
+        response_->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+    } else {
+        LOG(ERROR) << "create clone chunks failed: "
+                   << " logic pool id: " << request_->logicpoolid()
+                   << " copyset id: " << request_->copysetid()
+                   << " chunk count: " << request_->clonechunks_size()
+                   << " correctedSn: " << request_->correctedsn()
+                   << " data store return: " << ret;
+        response_->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+    }
+    auto maxIndex =
+        (index > node_->GetAppliedIndex() ? index : node_->GetAppliedIndex());
+    response_->set_appliedindex(maxIndex);
+}
+
+void CreateCloneChunksRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,  //NOLINT
+                                              const ChunkRequest &request,
+                                              const butil::IOBuf &data) {
+    // NOTE: 处理过程中优先使用参数传入的datastore/request
+    std::vector<ChunkID> conflictIds;
+    auto ret = CreateChunks(datastore, request, &conflictIds);
+    if (CSErrorCode::Success == ret)
+        return;
+
+    if (CSErrorCode::InternalError == ret ||
+        CSErrorCode::CrcCheckError == ret ||
+        CSErrorCode::FileFormatError == ret) {
+        LOG(FATAL) << "create clone chunks failed:"
+                   << " logic pool id: " << request.logicpoolid()
+                   << " copyset id: " << request.copysetid()
+                   << " chunk count: " << request.clonechunks_size()
+                   << " correctedSn: " << request.correctedsn()
+                   << " data store return: " << ret;
+    } else {
+        LOG(ERROR) << "create clone chunks failed:"
+                   << " logic pool id: " << request.logicpoolid()
+                   << " copyset id: " << request.copysetid()
+                   << " chunk count: " << request.clonechunks_size()
+                   << " correctedSn: " << request.correctedsn()
+                   << " data store return: " << ret;
+    }
+}
+
 void PasteChunkInternalRequest::Process() {
     brpc::ClosureGuard doneGuard(done_);
     /**
@@ -28,6 +28,7 @@
 #include <brpc/controller.h>
 
 #include <memory>
+#include <vector>
 
 #include "proto/chunk.pb.h"
 #include "include/chunkserver/chunkserver_common.h"
@@ -199,13 +200,45 @@ class DeleteChunkRequest : public ChunkOpRequest {
                         const butil::IOBuf &data) override;
 };
 
+/**
+ * 在一条raft日志中删除同一copyset上的多个chunk
+ * 该请求涉及多个chunk，不能按chunk id分发到并发apply的队列中，
+ * apply时需要等之前的请求都执行完，见CopysetNode::ApplyTask
+ */
+class DeleteChunksRequest : public ChunkOpRequest {
+ public:
+    DeleteChunksRequest() :
+        ChunkOpRequest() {}
+    DeleteChunksRequest(std::shared_ptr<CopysetNode> nodePtr,
+                        RpcController *cntl,
+                        const ChunkRequest *request,
+                        ChunkResponse *response,
+                        ::google::protobuf::Closure *done) :
+        ChunkOpRequest(nodePtr,
+                       cntl,
+                       request,
+                       response,
+                       done) {}
+    virtual ~DeleteChunksRequest() = default;
+
+    void OnApply(uint64_t index, ::google::protobuf::Closure *done) override;
+    void OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
+                        const ChunkRequest &request,
+                        const butil::IOBuf &data) override;
+
+ private:
+    static CSErrorCode DeleteChunks(std::shared_ptr<CSDataStore> datastore,
+                                    const ChunkRequest &request);
+};
+
 class ReadChunkRequest : public ChunkOpRequest {
     friend class CloneCore;
     friend class PasteChunkInternalRequest;
 
  public:
     ReadChunkRequest() :
-        ChunkOpRequest() {}
+        ChunkOpRequest(),
+        followerRead_(false) {}
     ReadChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
                      CloneManager* cloneMgr,
                      RpcController *cntl,
@@ -237,6 +270,8 @@ class ReadChunkRequest : public ChunkOpRequest {
     ConcurrentApplyModule* concurrentApplyModule_;
     // 保存 apply index
     uint64_t applyIndex;
+    // 是否是在follower上处理的读请求
+    bool followerRead_;
 };
 
 class WriteChunkRequest : public ChunkOpRequest {
@@ -327,6 +362,38 @@ class CreateCloneChunkRequest : public ChunkOpRequest {
                         const butil::IOBuf &data) override;
 };
 
+/**
+ * 在一条raft日志中创建同一copyset上的多个clone chunk
+ * 该请求涉及多个chunk，不能按chunk id分发到并发apply的队列中，
+ * apply时需要等之前的请求都执行完，见CopysetNode::on_apply
+ */
+class CreateCloneChunksRequest : public ChunkOpRequest {
+ public:
+    CreateCloneChunksRequest() :
+        ChunkOpRequest() {}
+    CreateCloneChunksRequest(std::shared_ptr<CopysetNode> nodePtr,
+                             RpcController *cntl,
+                             const ChunkRequest *request,
+                             ChunkResponse *response,
+                             ::google::protobuf::Closure *done) :
+        ChunkOpRequest(nodePtr,
+                       cntl,
+                       request,
+                       response,
+                       done) {}
+    virtual ~CreateCloneChunksRequest() = default;
+
+    void OnApply(uint64_t index, ::google::protobuf::Closure *done) override;
+    void OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
+                        const ChunkRequest &request,
+                        const butil::IOBuf &data) override;
+
+ private:
+    static CSErrorCode CreateChunks(std::shared_ptr<CSDataStore> datastore,
+                                    const ChunkRequest &request,
+                                    std::vector<ChunkID> *conflictIds);
+};
+
 class PasteChunkInternalRequest : public ChunkOpRequest {
  public:
     PasteChunkInternalRequest() :
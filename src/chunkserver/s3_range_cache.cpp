@@ -0,0 +1,370 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include <glog/logging.h>
+#include <fcntl.h>
+#include <string.h>
+#include <algorithm>
+
+#include "src/chunkserver/s3_range_cache.h"
+#include "src/common/location_operator.h"
+
+namespace curve {
+namespace chunkserver {
+
+struct S3RangeCache::ReadRequest {
+    off_t offset;
+    size_t length;
+    char* buf;
+    RangeFetchDone done;
+    // 还未完成的block数量
+    std::atomic<uint64_t> pending;
+    std::atomic<bool> failed;
+};
+
+S3RangeCache::S3RangeCache(const S3RangeCacheOptions& options,
+                           std::shared_ptr<LocalFileSystem> lfs,
+                           RangeFetcher fetcher)
+    : options_(options)
+    , lfs_(lfs)
+    , fetcher_(fetcher)
+    , memBytes_(0)
+    , diskBytes_(0)
+    , nextFileId_(0) {}
+
+int S3RangeCache::Init() {
+    if (options_.blockSize == 0) {
+        LOG(ERROR) << "Invalid s3 cache block size.";
+        return -1;
+    }
+    if (options_.diskCapacity == 0) {
+        return 0;
+    }
+    if (lfs_ == nullptr || options_.diskPath.empty()) {
+        LOG(ERROR) << "Disk cache is enabled without local filesystem "
+                   << "or cache path.";
+        return -1;
+    }
+    // 上次运行时缓存的对象可能已经被删除，不能再使用
+    if (lfs_->DirExists(options_.diskPath)) {
+        int rc = lfs_->Delete(options_.diskPath);
+        if (rc < 0) {
+            LOG(ERROR) << "Clear s3 disk cache failed."
+                       << "path: " << options_.diskPath;
+            return -1;
+        }
+    }
+    int rc = lfs_->Mkdir(options_.diskPath);
+    if (rc < 0) {
+        LOG(ERROR) << "Create s3 disk cache dir failed."
+                   << "path: " << options_.diskPath;
+        return -1;
+    }
+    return 0;
+}
+
+bool S3RangeCache::IsCacheable(const std::string& name) {
+    const std::string prefix = curve::common::kContentAddressedObjectPrefix;
+    return name.size() > prefix.size()
+        && name.compare(0, prefix.size(), prefix) == 0;
+}
+
+void S3RangeCache::Read(const std::string& name,
+                        off_t offset,
+                        size_t length,
+                        char* buf,
+                        RangeFetchDone done) {
+    if (length == 0) {
+        done(0);
+        return;
+    }
+    uint64_t beginIndex = offset / options_.blockSize;
+    uint64_t endIndex = (offset + length - 1) / options_.blockSize;
+
+    auto request = std::make_shared<ReadRequest>();
+    request->offset = offset;
+    request->length = length;
+    request->buf = buf;
+    request->done = done;
+    request->pending = endIndex - beginIndex + 1;
+    request->failed = false;
+    for (uint64_t index = beginIndex; index <= endIndex; ++index) {
+        ReadBlock(name, index, request);
+    }
+}
+
+void S3RangeCache::ReadBlock(const std::string& name,
+                             uint64_t index,
+                             const ReadRequestPtr& request) {
+    std::string key = BlockKey(name, index);
+    BlockPtr block;
+    std::string diskFile;
+    std::vector<uint64_t> readAhead;
+    {
+        LockGuard lg(mtx_);
+        block = GetFromMem(key);
+        if (block == nullptr) {
+            auto iter = loading_.find(key);
+            if (iter != loading_.end()) {
+                // 相同的block正在加载，加载完成后一起返回
+                iter->second.push_back(request);
+                metric_.coalesced << 1;
+                return;
+            }
+            loading_[key].push_back(request);
+            diskFile = GetDiskFile(key);
+            if (diskFile.empty()) {
+                readAhead = PrepareReadAhead(name, index);
+            }
+        }
+    }
+    if (block != nullptr) {
+        metric_.memHit << 1;
+        FillRequest(request, index, block);
+        return;
+    }
+
+    if (!diskFile.empty()) {
+        block = ReadFromDisk(diskFile);
+        if (block != nullptr) {
+            metric_.diskHit << 1;
+            FinishBlock(key, index, block, false);
+            return;
+        }
+    }
+
+    metric_.miss << 1;
+    FetchBlock(name, key, index);
+    for (uint64_t next : readAhead) {
+        metric_.readAhead << 1;
+        FetchBlock(name, BlockKey(name, next), next);
+    }
+}
+
+void S3RangeCache::FetchBlock(const std::string& name,
+                              const std::string& key,
+                              uint64_t index) {
+    BlockPtr block = std::make_shared<std::string>(options_.blockSize, '\0');
+    fetcher_(name,
+             index * options_.blockSize,
+             options_.blockSize,
+             &(*block)[0],
+             [this, key, index, block] (int retCode) {
+                 if (retCode != 0) {
+                     LOG(ERROR) << "Download s3 object failed."
+                                << "key: " << key
+                                << ", return code: " << retCode;
+                     FinishBlock(key, index, nullptr, true);
+                 } else {
+                     FinishBlock(key, index, block, true);
+                 }
+             });
+}
+
+std::vector<uint64_t> S3RangeCache::PrepareReadAhead(const std::string& name,
+                                                    uint64_t index) {
+    std::vector<uint64_t> readAhead;
+    if (options_.readAheadBlocks == 0 || options_.objectSize == 0) {
+        return readAhead;
+    }
+    // 只有顺序读取时才预读，即前一个block已经缓存或者正在加载
+    if (index > 0) {
+        std::string prev = BlockKey(name, index - 1);
+        if (memIndex_.find(prev) == memIndex_.end()
+            && loading_.find(prev) == loading_.end()) {
+            return readAhead;
+        }
+    }
+    uint64_t blockNum = options_.objectSize / options_.blockSize;
+    for (uint64_t next = index + 1;
+         next <= index + options_.readAheadBlocks && next < blockNum;
+         ++next) {
+        std::string key = BlockKey(name, next);
+        if (memIndex_.find(key) != memIndex_.end()
+            || diskIndex_.find(key) != diskIndex_.end()
+            || loading_.find(key) != loading_.end()) {
+            continue;
+        }
+        // 预读的block没有等待的请求，加载完成后只放入缓存
+        loading_[key];
+        readAhead.push_back(next);
+    }
+    return readAhead;
+}
+
+void S3RangeCache::FinishBlock(const std::string& key,
+                               uint64_t index,
+                               BlockPtr block,
+                               bool fromS3) {
+    std::vector<ReadRequestPtr> waiters;
+    {
+        LockGuard lg(mtx_);
+        auto iter = loading_.find(key);
+        if (iter != loading_.end()) {
+            waiters.swap(iter->second);
+            loading_.erase(iter);
+        }
+        if (block != nullptr) {
+            PutToMem(key, block);
+        }
+    }
+    for (auto& request : waiters) {
+        FillRequest(request, index, block);
+    }
+    if (block != nullptr && fromS3) {
+        WriteToDisk(key, block);
+    }
+}
+
+void S3RangeCache::FillRequest(const ReadRequestPtr& request,
+                               uint64_t index,
+                               const BlockPtr& block) {
+    if (block == nullptr) {
+        request->failed = true;
+    } else {
+        // 拷贝block与请求重叠的部分
+        uint64_t blockBegin = index * options_.blockSize;
+        uint64_t begin = std::max<uint64_t>(blockBegin, request->offset);
+        uint64_t end = std::min<uint64_t>(blockBegin + options_.blockSize,
+                                          request->offset + request->length);
+        memcpy(request->buf + (begin - request->offset),
+               block->data() + (begin - blockBegin),
+               end - begin);
+    }
+    if (--request->pending == 0) {
+        request->done(request->failed ? -1 : 0);
+    }
+}
+
+std::string S3RangeCache::BlockKey(const std::string& name, uint64_t index) {
+    return name + ":" + std::to_string(index);
+}
+
+S3RangeCache::BlockPtr S3RangeCache::GetFromMem(const std::string& key) {
+    auto iter = memIndex_.find(key);
+    if (iter == memIndex_.end()) {
+        return nullptr;
+    }
+    memList_.splice(memList_.begin(), memList_, iter->second);
+    return iter->second->second;
+}
+
+void S3RangeCache::PutToMem(const std::string& key, BlockPtr block) {
+    if (options_.memCapacity < options_.blockSize
+        || memIndex_.find(key) != memIndex_.end()) {
+        return;
+    }
+    memList_.emplace_front(key, block);
+    memIndex_[key] = memList_.begin();
+    memBytes_ += options_.blockSize;
+    metric_.memBytes << options_.blockSize;
+    while (memBytes_ > options_.memCapacity) {
+        memIndex_.erase(memList_.back().first);
+        memList_.pop_back();
+        memBytes_ -= options_.blockSize;
+        metric_.memBytes << -static_cast<int64_t>(options_.blockSize);
+    }
+}
+
+std::string S3RangeCache::GetDiskFile(const std::string& key) {
+    auto iter = diskIndex_.find(key);
+    if (iter == diskIndex_.end()) {
+        return "";
+    }
+    diskList_.splice(diskList_.begin(), diskList_, iter->second);
+    return iter->second->second;
+}
+
+S3RangeCache::BlockPtr S3RangeCache::ReadFromDisk(const std::string& path) {
+    // 文件可能已经被淘汰，此时从s3重新下载
+    int fd = lfs_->Open(path, O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    auto block = std::make_shared<std::string>(options_.blockSize, '\0');
+    int rc = lfs_->Read(fd, &(*block)[0], 0, options_.blockSize);
+    lfs_->Close(fd);
+    if (rc != static_cast<int>(options_.blockSize)) {
+        LOG(WARNING) << "Read s3 disk cache failed."
+                     << "path: " << path
+                     << ", return code: " << rc;
+        return nullptr;
+    }
+    return block;
+}
+
+void S3RangeCache::WriteToDisk(const std::string& key,
+                               const BlockPtr& block) {
+    if (options_.diskCapacity < options_.blockSize) {
+        return;
+    }
+    std::string path;
+    {
+        LockGuard lg(mtx_);
+        if (diskIndex_.find(key) != diskIndex_.end()) {
+            return;
+        }
+        path = options_.diskPath + "/" + std::to_string(nextFileId_++);
+    }
+
+    int fd = lfs_->Open(path, O_RDWR | O_CREAT | O_TRUNC);
+    if (fd < 0) {
+        LOG(WARNING) << "Create s3 disk cache file failed."
+                     << "path: " << path;
+        return;
+    }
+    int rc = lfs_->Write(fd, block->data(), 0, options_.blockSize);
+    lfs_->Close(fd);
+    if (rc != static_cast<int>(options_.blockSize)) {
+        LOG(WARNING) << "Write s3 disk cache failed."
+                     << "path: " << path
+                     << ", return code: " << rc;
+        lfs_->Delete(path);
+        return;
+    }
+
+    std::vector<std::string> evicted;
+    {
+        LockGuard lg(mtx_);
+        if (diskIndex_.find(key) != diskIndex_.end()) {
+            evicted.push_back(path);
+        } else {
+            diskList_.emplace_front(key, path);
+            diskIndex_[key] = diskList_.begin();
+            diskBytes_ += options_.blockSize;
+            metric_.diskBytes << options_.blockSize;
+            while (diskBytes_ > options_.diskCapacity) {
+                evicted.push_back(diskList_.back().second);
+                diskIndex_.erase(diskList_.back().first);
+                diskList_.pop_back();
+                diskBytes_ -= options_.blockSize;
+                metric_.diskBytes <<
+                    -static_cast<int64_t>(options_.blockSize);
+            }
+        }
+    }
+    for (auto& file : evicted) {
+        lfs_->Delete(file);
+    }
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,230 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#ifndef SRC_CHUNKSERVER_S3_RANGE_CACHE_H_
+#define SRC_CHUNKSERVER_S3_RANGE_CACHE_H_
+
+#include <bvar/bvar.h>
+#include <sys/types.h>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "src/common/concurrent/concurrent.h"
+#include "src/fs/local_filesystem.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::fs::LocalFileSystem;
+using curve::common::Mutex;
+using curve::common::LockGuard;
+
+struct S3RangeCacheOptions {
+    // 缓存的粒度，从s3下载时按照该粒度对齐，0表示不使用缓存
+    uint32_t blockSize;
+    // 内存缓存的容量
+    uint64_t memCapacity;
+    // 磁盘缓存的容量，0表示不使用磁盘缓存
+    uint64_t diskCapacity;
+    // 磁盘缓存的目录，启动时会清空
+    std::string diskPath;
+    // 对象的大小，预读不会超出对象的范围
+    uint64_t objectSize;
+    // 顺序读未命中时向后预读的block数量，0表示不预读
+    uint32_t readAheadBlocks;
+
+    S3RangeCacheOptions() : blockSize(0)
+                          , memCapacity(0)
+                          , diskCapacity(0)
+                          , objectSize(0)
+                          , readAheadBlocks(0) {}
+};
+
+struct S3RangeCacheMetric {
+    const std::string S3CacheMetricPrefix = "chunkserver_s3_cache_";
+
+    // 在内存缓存中命中的block数量
+    bvar::Adder<uint64_t> memHit;
+    // 在磁盘缓存中命中的block数量
+    bvar::Adder<uint64_t> diskHit;
+    // 合并到正在下载的相同block上的请求数量
+    bvar::Adder<uint64_t> coalesced;
+    // 需要从s3下载的block数量
+    bvar::Adder<uint64_t> miss;
+    // 预读从s3下载的block数量
+    bvar::Adder<uint64_t> readAhead;
+    // 内存缓存和磁盘缓存占用的空间
+    bvar::Adder<int64_t> memBytes;
+    bvar::Adder<int64_t> diskBytes;
+    // 不需要从s3下载的block所占的比例
+    bvar::PassiveStatus<double> hitRate;
+
+    S3RangeCacheMetric() :
+        memHit(S3CacheMetricPrefix, "mem_hit"),
+        diskHit(S3CacheMetricPrefix, "disk_hit"),
+        coalesced(S3CacheMetricPrefix, "coalesced"),
+        miss(S3CacheMetricPrefix, "miss"),
+        readAhead(S3CacheMetricPrefix, "read_ahead"),
+        memBytes(S3CacheMetricPrefix, "mem_bytes"),
+        diskBytes(S3CacheMetricPrefix, "disk_bytes"),
+        hitRate(S3CacheMetricPrefix + "hit_rate", GetHitRate, this) {}
+
+    static double GetHitRate(void* arg) {
+        S3RangeCacheMetric* metric =
+            reinterpret_cast<S3RangeCacheMetric*>(arg);
+        uint64_t hit = metric->memHit.get_value()
+                     + metric->diskHit.get_value()
+                     + metric->coalesced.get_value();
+        uint64_t total = hit + metric->miss.get_value();
+        return total == 0 ? 0 : static_cast<double>(hit) / total;
+    }
+};
+
+// 下载完成的回调，参数为返回码，0表示成功
+using RangeFetchDone = std::function<void(int)>;
+// 从s3异步下载对象[offset, offset + length)的数据到buf中
+using RangeFetcher = std::function<void(const std::string& name,
+                                        off_t offset,
+                                        size_t length,
+                                        char* buf,
+                                        RangeFetchDone done)>;
+
+/**
+ * S3RangeCache 缓存从s3下载的对象数据，用于加速从同一个快照lazy克隆出来的
+ * 多个卷的读取
+ *
+ * 数据按照blockSize对齐缓存，以对象名和block在对象中的序号为key。
+ * 内存缓存和磁盘缓存分别按照LRU淘汰，从s3下载的block同时写入两级缓存。
+ * 对同一个block的并发请求只会从s3下载一次。
+ * 顺序读取未命中时，向后预读readAheadBlocks个block，预读不超出对象的范围。
+ * 按逻辑名称(文件名-chunk索引-版本号)存储的对象在快照或文件删除重建后
+ * 会被重用，缓存无法感知，因此只缓存按内容哈希命名的对象(IsCacheable)，
+ * 这类对象同名即同内容，缓存不需要校验。
+ * 磁盘缓存在启动时清空，不会读到上次运行时缓存的已被删除的对象
+ */
+class S3RangeCache {
+ public:
+    S3RangeCache(const S3RangeCacheOptions& options,
+                 std::shared_ptr<LocalFileSystem> lfs,
+                 RangeFetcher fetcher);
+    virtual ~S3RangeCache() = default;
+
+    /**
+     * 初始化磁盘缓存的目录
+     * @return: 成功返回0，失败返回-1
+     */
+    int Init();
+
+    /**
+     * 判断对象是否可以缓存，只有按内容哈希命名的对象内容不会改变
+     * @param name: 对象名称
+     * @return: 可以缓存返回true
+     */
+    static bool IsCacheable(const std::string& name);
+
+    /**
+     * 读取对象[offset, offset + length)的数据，未缓存的block从s3下载
+     * @param name: 对象名
+     * @param offset: 数据在对象中的偏移
+     * @param length: 数据的长度
+     * @param buf: 存放数据的缓冲区
+     * @param done: 读取完成后的回调，可能在调用线程中直接执行
+     */
+    void Read(const std::string& name,
+              off_t offset,
+              size_t length,
+              char* buf,
+              RangeFetchDone done);
+
+    const S3RangeCacheMetric& GetMetric() const {
+        return metric_;
+    }
+
+ private:
+    using BlockPtr = std::shared_ptr<std::string>;
+    struct ReadRequest;
+    using ReadRequestPtr = std::shared_ptr<ReadRequest>;
+
+    void ReadBlock(const std::string& name,
+                   uint64_t index,
+                   const ReadRequestPtr& request);
+
+    void FetchBlock(const std::string& name,
+                    const std::string& key,
+                    uint64_t index);
+
+    void FinishBlock(const std::string& key,
+                     uint64_t index,
+                     BlockPtr block,
+                     bool fromS3);
+
+    void FillRequest(const ReadRequestPtr& request,
+                     uint64_t index,
+                     const BlockPtr& block);
+
+    static std::string BlockKey(const std::string& name, uint64_t index);
+
+    // 以下函数需要持有mtx_
+    BlockPtr GetFromMem(const std::string& key);
+    void PutToMem(const std::string& key, BlockPtr block);
+    std::string GetDiskFile(const std::string& key);
+    // 返回需要预读的block序号，并将其加入loading_
+    std::vector<uint64_t> PrepareReadAhead(const std::string& name,
+                                           uint64_t index);
+
+    BlockPtr ReadFromDisk(const std::string& path);
+    void WriteToDisk(const std::string& key, const BlockPtr& block);
+
+ private:
+    S3RangeCacheOptions options_;
+    std::shared_ptr<LocalFileSystem> lfs_;
+    RangeFetcher fetcher_;
+
+    // 保护以下所有成员
+    Mutex mtx_;
+    // 内存缓存，越靠前越新
+    std::list<std::pair<std::string, BlockPtr>> memList_;
+    std::unordered_map<std::string,
+        std::list<std::pair<std::string, BlockPtr>>::iterator> memIndex_;
+    uint64_t memBytes_;
+    // 磁盘缓存，value为缓存文件的路径，越靠前越新
+    std::list<std::pair<std::string, std::string>> diskList_;
+    std::unordered_map<std::string,
+        std::list<std::pair<std::string, std::string>>::iterator> diskIndex_;
+    uint64_t diskBytes_;
+    // 用于生成缓存文件名，文件名不会重复使用
+    uint64_t nextFileId_;
+    // 正在加载的block以及等待该block的请求
+    std::unordered_map<std::string, std::vector<ReadRequestPtr>> loading_;
+
+    S3RangeCacheMetric metric_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_S3_RANGE_CACHE_H_
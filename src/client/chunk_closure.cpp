@@ -84,6 +84,42 @@ UnstableState UnstableHelper::GetCurrentUnstableState(
     }
 }
 
+void UnstableHelper::RecordReadLatency(ChunkServerID csId,
+                                       uint64_t latencyUs) {
+    {
+        ReadLockGuard rdlk(latencyLock_);
+        auto iter = readLatency_.find(csId);
+        if (iter != readLatency_.end()) {
+            *iter->second << latencyUs;
+            return;
+        }
+    }
+
+    WriteLockGuard wrlk(latencyLock_);
+    auto& recorder = readLatency_[csId];
+    if (recorder == nullptr) {
+        recorder.reset(new bvar::LatencyRecorder());
+    }
+    *recorder << latencyUs;
+}
+
+uint64_t UnstableHelper::GetReadLatencyPercentile(ChunkServerID csId,
+                                                  double ratio) {
+    ReadLockGuard rdlk(latencyLock_);
+    auto iter = readLatency_.find(csId);
+    if (iter == readLatency_.end()) {
+        return 0;
+    }
+
+    int64_t latency = iter->second->latency_percentile(ratio);
+    return latency > 0 ? latency : 0;
+}
+
+void UnstableHelper::RemoveReadLatency(ChunkServerID csId) {
+    WriteLockGuard wrlk(latencyLock_);
+    readLatency_.erase(csId);
+}
+
 void ClientClosure::PreProcessBeforeRetry(int rpcstatus, int cntlstatus) {
     RequestClosure *reqDone = dynamic_cast<RequestClosure *>(done_);
 
@@ -519,7 +555,144 @@ void WriteChunkClosure::OnSuccess() {
         response_->appliedindex());
 }
 
+bool HedgedReadState::TryFinish() {
+    std::shared_ptr<HedgedReadState>* timerArg = nullptr;
+    {
+        std::lock_guard<bthread::Mutex> lk(mtx_);
+        if (finished_) {
+            return false;
+        }
+        finished_ = true;
+
+        // 定时任务还没有执行，取消定时任务并释放其持有的引用
+        if (timerArmed_ && bthread_timer_del(timer_) == 0) {
+            timerArg = timerArg_;
+        }
+        timerArmed_ = false;
+        timerArg_ = nullptr;
+    }
+
+    delete timerArg;
+    return true;
+}
+
+void HedgedReadState::ArmTimer(const std::shared_ptr<HedgedReadState>& self,
+                               ChunkServerID primaryId,
+                               uint64_t delayUs) {
+    std::lock_guard<bthread::Mutex> lk(self->mtx_);
+    if (self->finished_) {
+        return;
+    }
+
+    self->primaryId_ = primaryId;
+    self->timerArg_ = new std::shared_ptr<HedgedReadState>(self);
+    int ret = bthread_timer_add(&self->timer_,
+                                butil::microseconds_from_now(delayUs),
+                                OnTimer, self->timerArg_);
+    if (ret != 0) {
+        LOG(WARNING) << "add hedged read timer failed, ret = " << ret;
+        delete self->timerArg_;
+        self->timerArg_ = nullptr;
+        return;
+    }
+    self->timerArmed_ = true;
+}
+
+void HedgedReadState::OnTimer(void* arg) {
+    // 定时任务运行在bthread timer线程中，不能阻塞，启动bthread发送hedge请求
+    bthread_t tid;
+    if (bthread_start_background(&tid, nullptr, SendHedgedRead, arg) != 0) {
+        LOG(WARNING) << "start bthread to send hedged read failed";
+        delete static_cast<std::shared_ptr<HedgedReadState>*>(arg);
+    }
+}
+
+void* HedgedReadState::SendHedgedRead(void* arg) {
+    std::unique_ptr<std::shared_ptr<HedgedReadState>> holder(
+        static_cast<std::shared_ptr<HedgedReadState>*>(arg));
+    HedgedReadState* state = holder->get();
+
+    std::lock_guard<bthread::Mutex> lk(state->mtx_);
+    state->timerArmed_ = false;
+    state->timerArg_ = nullptr;
+    if (state->finished_) {
+        return nullptr;
+    }
+
+    state->client_->SendHedgedRead(*holder, state->done_, state->idinfo_,
+                                   state->offset_, state->length_,
+                                   state->appliedindex_, state->primaryId_);
+    return nullptr;
+}
+
+void ReadChunkClosure::Run() {
+    if (hedgedState_ != nullptr) {
+        RecordReadLatency();
+        // hedge请求已经先返回，当前请求的结果直接丢弃
+        if (!hedgedState_->TryFinish()) {
+            Discard();
+            return;
+        }
+    }
+
+    ClientClosure::Run();
+}
+
+void ReadChunkClosure::RecordReadLatency() {
+    if (!cntl_->Failed()) {
+        UnstableHelper::GetInstance().RecordReadLatency(
+            chunkserverID_, cntl_->latency_us());
+    }
+}
+
+void ReadChunkClosure::Discard() {
+    delete cntl_;
+    delete this;
+}
+
+void HedgedReadClosure::Run() {
+    RecordReadLatency();
+
+    // hedge请求失败时直接丢弃，由原始请求完成重试
+    CHUNK_OP_STATUS status = response_->status();
+    bool usable = !cntl_->Failed() &&
+        (status == CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS ||
+         status == CHUNK_OP_STATUS::CHUNK_OP_STATUS_CHUNK_NOTEXIST);
+    if (!usable || !hedgedState_->TryFinish()) {
+        Discard();
+        return;
+    }
+
+    MetricHelper::IncremHedgedReadWinCount(
+        static_cast<RequestClosure*>(done_)->GetMetric());
+    ClientClosure::Run();
+}
+
+void ReadChunkClosure::OnRedirected() {
+    if (!reqCtx_->readFromFollower_) {
+        ClientClosure::OnRedirected();
+        return;
+    }
+
+    // follower的appliedindex落后于请求的appliedindex，标记该follower一段时间
+    // 内不再接收follower read，本次请求直接重试到leader，不需要刷新leader信息
+    LOG(INFO) << "read from follower redirected, " << *reqCtx_
+        << ", retried times = " << reqDone_->GetRetriedTimes()
+        << ", IO id = " << reqDone_->GetIOTracker()->GetID()
+        << ", request id = " << reqCtx_->id_
+        << ", remote side = " << remoteAddress_;
+
+    client_->OnFollowerReadLagging(chunkIdInfo_, chunkserverID_);
+    reqCtx_->followerReadFallback_ = true;
+    retryDirectly_ = true;
+}
+
 void ReadChunkClosure::SendRetryRequest() {
+    // follower read失败之后，重试请求都发往leader
+    if (reqCtx_->readFromFollower_) {
+        reqCtx_->followerReadFallback_ = true;
+    }
+
     client_->ReadChunk(reqCtx_->idinfo_, reqCtx_->seq_,
                        reqCtx_->offset_,
                        reqCtx_->rawlength_,
@@ -583,6 +756,15 @@ void GetChunkInfoClosure::OnSuccess() {
         reqCtx_->chunkinfodetail_->chunkSn.push_back(
             chunkinforesponse_->chunksn(i));
     }
+
+    for (int i = 0; i < chunkinforesponse_->changedblocks_size(); ++i) {
+        const auto& blocks = chunkinforesponse_->changedblocks(i);
+        ChunkChangedInfo& info =
+            reqCtx_->chunkinfodetail_->changedInfo[blocks.sn()];
+        info.baseSn = blocks.basesn();
+        info.blockSize = blocks.blocksize();
+        info.bitmap = blocks.bitmap();
+    }
 }
 
 void GetChunkInfoClosure::OnRedirected() {
@@ -616,6 +798,23 @@ void CreateCloneChunkClosure::SendRetryRequest() {
                               done_);
 }
 
+void CreateCloneChunksClosure::SendRetryRequest() {
+    client_->CreateCloneChunks(reqCtx_->idinfo_,
+                               reqCtx_->cloneChunks_,
+                               reqCtx_->correctedSeq_,
+                               reqCtx_->chunksize_,
+                               done_);
+}
+
+void CreateCloneChunksClosure::OnSuccess() {
+    ClientClosure::OnSuccess();
+
+    if (reqCtx_->existChunkIds_ != nullptr) {
+        reqCtx_->existChunkIds_->assign(response_->existchunkids().begin(),
+                                        response_->existchunkids().end());
+    }
+}
+
 void RecoverChunkClosure::SendRetryRequest() {
     client_->RecoverChunk(reqCtx_->idinfo_,
                           reqCtx_->offset_,
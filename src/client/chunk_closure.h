@@ -26,10 +26,13 @@
 #include <google/protobuf/stubs/callback.h>
 #include <brpc/controller.h>
 #include <bthread/bthread.h>
+#include <bthread/mutex.h>
 #include <brpc/errno.pb.h>
+#include <bvar/bvar.h>
 #include <unordered_map>  // NOLINT
 #include <unordered_set>  // NOLINT
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 
 #include "proto/chunk.pb.h"
@@ -49,6 +52,9 @@ using curve::chunkserver::GetChunkInfoResponse;
 using ::google::protobuf::Message;
 using ::google::protobuf::Closure;
 using curve::common::SpinLock;
+using curve::common::RWLock;
+using curve::common::ReadLockGuard;
+using curve::common::WriteLockGuard;
 
 class RequestSenderManager;
 class MetaCache;
@@ -100,10 +106,37 @@ class UnstableHelper {
         option_ = opt;
     }
 
+    /**
+     * @brief 记录发往chunkserver的读请求时延，用于计算hedged read的等待时间
+     *
+     * @param: csId chunkserver id
+     * @param: latencyUs 读请求时延
+     */
+    void RecordReadLatency(ChunkServerID csId, uint64_t latencyUs);
+
+    /**
+     * @brief 获取发往chunkserver的读请求时延分位值
+     *
+     * @param: csId chunkserver id
+     * @param: ratio 分位值，取值(0, 1)
+     * @return: 时延分位值(us)，没有统计数据时返回0
+     */
+    uint64_t GetReadLatencyPercentile(ChunkServerID csId, double ratio);
+
+    /**
+     * @brief chunkserver不再承载缓存中的copyset时，删除它的时延统计
+     *
+     * @param: csId chunkserver id
+     */
+    void RemoveReadLatency(ChunkServerID csId);
+
     // 测试使用，重置计数器
     void ResetState() {
         timeoutTimes_.clear();
         serverUnstabledChunkservers_.clear();
+
+        WriteLockGuard wrlk(latencyLock_);
+        readLatency_.clear();
     }
 
  private:
@@ -129,6 +162,12 @@ class UnstableHelper {
 
     // 同一server上unstable chunkserver的id
     std::unordered_map<std::string, std::unordered_set<ChunkServerID>> serverUnstabledChunkservers_;  // NOLINT
+
+    // 保护readLatency_，记录时延只需要读锁
+    RWLock latencyLock_;
+
+    // 每个chunkserver的读请求时延统计
+    std::unordered_map<ChunkServerID, std::unique_ptr<bvar::LatencyRecorder>> readLatency_;  // NOLINT
 };
 
 /**
@@ -333,14 +372,96 @@ class WriteChunkClosure : public ClientClosure {
     void SendRetryRequest() override;
 };
 
+/**
+ * hedged read的状态，由原始读请求和hedge请求共享。
+ * 原始请求返回时（无论成功失败）或者hedge请求成功返回时，通过TryFinish
+ * 争抢上层的done，只有争抢成功的请求会处理结果并回调上层，另一个请求返回时
+ * 不能再访问done及request context
+ */
+class HedgedReadState {
+ public:
+    HedgedReadState(CopysetClient* client,
+                    Closure* done,
+                    const ChunkIDInfo& idinfo,
+                    off_t offset,
+                    size_t length,
+                    uint64_t appliedindex)
+        : client_(client), done_(done), idinfo_(idinfo), offset_(offset),
+          length_(length), appliedindex_(appliedindex), primaryId_(0),
+          finished_(false), timerArmed_(false), timer_(0),
+          timerArg_(nullptr) {}
+
+    /**
+     * @brief 尝试接管上层的done
+     * @return: true 接管成功，由当前请求回调上层 / false 另一个请求已经接管
+     */
+    bool TryFinish();
+
+    /**
+     * @brief 在delayUs之后发送hedge请求，如果届时请求已经结束则不发送
+     * @param: self 指向当前对象的shared_ptr，由定时任务持有
+     * @param: primaryId 原始请求发往的chunkserver，hedge请求不会发往该节点
+     * @param: delayUs 等待时间
+     */
+    static void ArmTimer(const std::shared_ptr<HedgedReadState>& self,
+                         ChunkServerID primaryId,
+                         uint64_t delayUs);
+
+ private:
+    static void OnTimer(void* arg);
+    static void* SendHedgedRead(void* arg);
+
+    CopysetClient* client_;
+    Closure* done_;
+    ChunkIDInfo idinfo_;
+    off_t offset_;
+    size_t length_;
+    uint64_t appliedindex_;
+    ChunkServerID primaryId_;
+
+    // 保护以下状态，发送hedge请求的过程也在锁内，避免请求结束后再访问client
+    bthread::Mutex mtx_;
+    bool finished_;
+    bool timerArmed_;
+    bthread_timer_t timer_;
+    std::shared_ptr<HedgedReadState>* timerArg_;
+};
+
 class ReadChunkClosure : public ClientClosure {
  public:
     ReadChunkClosure(CopysetClient *client, Closure *done)
      : ClientClosure(client, done) {}
 
+    ReadChunkClosure(CopysetClient *client, Closure *done,
+                     std::shared_ptr<HedgedReadState> hedgedState)
+     : ClientClosure(client, done), hedgedState_(hedgedState) {}
+
+    void Run() override;
     void OnSuccess() override;
     void OnChunkNotExist() override;
+    void OnRedirected() override;
     void SendRetryRequest() override;
+
+ protected:
+    // 记录读请求时延，用于计算hedged read的等待时间
+    void RecordReadLatency();
+
+    // 请求结果被丢弃，释放当前closure，不回调上层
+    void Discard();
+
+    // 开启hedged read时，原始请求与hedge请求共享的状态
+    std::shared_ptr<HedgedReadState> hedgedState_;
+};
+
+// hedge请求的回调，只有成功返回时才会争抢上层的done，失败直接丢弃，
+// 由原始请求继续完成重试逻辑
+class HedgedReadClosure : public ReadChunkClosure {
+ public:
+    HedgedReadClosure(CopysetClient *client, Closure *done,
+                      std::shared_ptr<HedgedReadState> hedgedState)
+     : ReadChunkClosure(client, done, hedgedState) {}
+
+    void Run() override;
 };
 
 class ReadChunkSnapClosure : public ClientClosure {
@@ -389,6 +510,15 @@ class CreateCloneChunkClosure : public ClientClosure {
     void SendRetryRequest() override;
 };
 
+class CreateCloneChunksClosure : public ClientClosure {
+ public:
+    CreateCloneChunksClosure(CopysetClient *client, Closure *done)
+     : ClientClosure(client, done) {}
+
+    void OnSuccess() override;
+    void SendRetryRequest() override;
+};
+
 class RecoverChunkClosure : public ClientClosure {
  public:
     RecoverChunkClosure(CopysetClient *client, Closure *done)
@@ -30,10 +30,12 @@
 #include <unistd.h>
 #include <string>
 #include <atomic>
+#include <map>
 #include <vector>
 
 #include "include/client/libcurve.h"
 #include "src/common/net_common.h"
+#include "src/common/throttle.h"
 
 namespace curve {
 namespace client {
@@ -57,6 +59,7 @@ enum class OpType {
     CREATE_CLONE,
     RECOVER_CHUNK,
     GET_CHUNK_INFO,
+    CREATE_CLONE_BATCH,
     UNKNOWN
 };
 
@@ -106,11 +109,34 @@ typedef struct ChunkIDInfo {
     }
 } ChunkIDInfo_t;
 
+// chunk某个版本相对上一个版本写过的区域
+typedef struct ChunkChangedInfo {
+    // 相对的上一个版本号
+    uint64_t baseSn;
+    // bitmap中每个bit表示的区域大小
+    uint32_t blockSize;
+    // 相对上一个版本写过的block
+    std::string bitmap;
+
+    ChunkChangedInfo() : baseSn(0), blockSize(0) {}
+} ChunkChangedInfo_t;
+
 // 保存每个chunk对应的版本信息
 typedef struct ChunkInfoDetail {
     std::vector<uint64_t> chunkSn;
+    // 有记录的版本写过的区域，key为chunk版本号
+    std::map<uint64_t, ChunkChangedInfo> changedInfo;
 } ChunkInfoDetail_t;
 
+// 批量创建clone chunk时每个chunk的信息
+typedef struct CloneChunkDesc {
+    ChunkID         cid;
+    // chunk的版本号
+    uint64_t        seq;
+    // 数据源位置信息
+    std::string     location;
+} CloneChunkDesc_t;
+
 typedef struct LeaseSession {
     std::string sessionID;
     uint32_t leaseTime;
@@ -155,6 +181,9 @@ typedef struct FInfo {
     FileStatus      filestatus;
     std::string     cloneSource;
     uint64_t        cloneLength{0};
+    // mds下发的文件QoS限制，burst为0时由client根据配置计算
+    std::map<curve::common::ThrottleType,
+             curve::common::ThrottleParams> throttleParams;
 
     FInfo() {
         id = 0;
@@ -54,11 +54,83 @@ int ClientConfig::Init(const char* configpath) {
     LOG_IF(ERROR, ret == false) << "config no global.fileIOSplitMaxSizeKB info";           // NOLINT
     RETURN_IF_FALSE(ret)
 
+    ret = conf_.GetBoolValue("global.enableLargeIOFastPath",
+          &fileServiceOption_.ioOpt.ioSplitOpt.enableLargeIOFastPath);
+    LOG_IF(WARNING, ret == false)
+        << "config no global.enableLargeIOFastPath info, using default value "
+        << fileServiceOption_.ioOpt.ioSplitOpt.enableLargeIOFastPath;
+
+    ret = conf_.GetUInt64Value("throttle.readIOPS",
+          &fileServiceOption_.ioOpt.throttleOpt.readIOPS);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.readIOPS info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.readIOPS;
+
+    ret = conf_.GetUInt64Value("throttle.writeIOPS",
+          &fileServiceOption_.ioOpt.throttleOpt.writeIOPS);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.writeIOPS info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.writeIOPS;
+
+    ret = conf_.GetUInt64Value("throttle.readBPS",
+          &fileServiceOption_.ioOpt.throttleOpt.readBPS);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.readBPS info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.readBPS;
+
+    ret = conf_.GetUInt64Value("throttle.writeBPS",
+          &fileServiceOption_.ioOpt.throttleOpt.writeBPS);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.writeBPS info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.writeBPS;
+
+    ret = conf_.GetUInt64Value("throttle.burstSeconds",
+          &fileServiceOption_.ioOpt.throttleOpt.burstSeconds);
+    LOG_IF(WARNING, ret == false)
+        << "config no throttle.burstSeconds info, using default value "
+        << fileServiceOption_.ioOpt.throttleOpt.burstSeconds;
+
     ret = conf_.GetBoolValue("chunkserver.enableAppliedIndexRead",
           &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverEnableAppliedIndexRead);        // NOLINT
     LOG_IF(ERROR, ret == false) << "config no chunkserver.enableAppliedIndexRead info";     // NOLINT
     RETURN_IF_FALSE(ret)
 
+    ret = conf_.GetBoolValue("chunkserver.enableFollowerRead",
+          &fileServiceOption_.ioOpt.ioSenderOpt.followerReadOpt.enableFollowerRead);    // NOLINT
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.enableFollowerRead info, using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.followerReadOpt.enableFollowerRead;    // NOLINT
+
+    ret = conf_.GetUInt64Value("chunkserver.followerReadLagBackoffMS",
+          &fileServiceOption_.ioOpt.ioSenderOpt.followerReadOpt.followerLagBackoffMS);    // NOLINT
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.followerReadLagBackoffMS info, using default value "    // NOLINT
+        << fileServiceOption_.ioOpt.ioSenderOpt.followerReadOpt.followerLagBackoffMS;    // NOLINT
+
+    ret = conf_.GetBoolValue("chunkserver.enableHedgedRead",
+          &fileServiceOption_.ioOpt.ioSenderOpt.hedgedReadOpt.enableHedgedRead);    // NOLINT
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.enableHedgedRead info, using default value "
+        << fileServiceOption_.ioOpt.ioSenderOpt.hedgedReadOpt.enableHedgedRead;    // NOLINT
+
+    ret = conf_.GetDoubleValue("chunkserver.hedgedReadLatencyPercentile",
+          &fileServiceOption_.ioOpt.ioSenderOpt.hedgedReadOpt.latencyPercentile);    // NOLINT
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.hedgedReadLatencyPercentile info, using default value "    // NOLINT
+        << fileServiceOption_.ioOpt.ioSenderOpt.hedgedReadOpt.latencyPercentile;    // NOLINT
+
+    ret = conf_.GetUInt64Value("chunkserver.hedgedReadMinDelayUS",
+          &fileServiceOption_.ioOpt.ioSenderOpt.hedgedReadOpt.minDelayUS);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.hedgedReadMinDelayUS info, using default value "    // NOLINT
+        << fileServiceOption_.ioOpt.ioSenderOpt.hedgedReadOpt.minDelayUS;
+
+    ret = conf_.GetUInt64Value("chunkserver.hedgedReadMaxDelayUS",
+          &fileServiceOption_.ioOpt.ioSenderOpt.hedgedReadOpt.maxDelayUS);
+    LOG_IF(WARNING, ret == false)
+        << "config no chunkserver.hedgedReadMaxDelayUS info, using default value "    // NOLINT
+        << fileServiceOption_.ioOpt.ioSenderOpt.hedgedReadOpt.maxDelayUS;
+
     ret = conf_.GetUInt32Value("chunkserver.opMaxRetry",
           &fileServiceOption_.ioOpt.ioSenderOpt.failRequestOpt.chunkserverOPMaxRetry);    // NOLINT
     LOG_IF(ERROR, ret == false) << "config no chunkserver.opMaxRetry info";
@@ -142,6 +214,18 @@ int ClientConfig::Init(const char* configpath) {
     LOG_IF(ERROR, ret == false) << "config no mds.refreshTimesPerLease info";
     RETURN_IF_FALSE(ret)
 
+    ret = conf_.GetBoolValue("mds.enableBatchRefreshSession",
+        &fileServiceOption_.leaseOpt.enableBatchRefresh);
+    LOG_IF(WARNING, ret == false)
+        << "config no mds.enableBatchRefreshSession info, using default value "
+        << fileServiceOption_.leaseOpt.enableBatchRefresh;
+
+    ret = conf_.GetUInt32Value("mds.maxBatchRefreshFileNum",
+        &fileServiceOption_.leaseOpt.maxBatchRefreshFileNum);
+    LOG_IF(WARNING, ret == false)
+        << "config no mds.maxBatchRefreshFileNum info, using default value "
+        << fileServiceOption_.leaseOpt.maxBatchRefreshFileNum;
+
     fileServiceOption_.ioOpt.reqSchdulerOpt.ioSenderOpt
     = fileServiceOption_.ioOpt.ioSenderOpt;
 
@@ -119,6 +119,15 @@ struct FileMetric {
     // 当前文件上的悬挂IO数量
     IOSuspendMetric suspendRPCMetric;
 
+    // 发送的hedged read请求qps
+    PerSecondMetric hedgedReadQPS;
+    // hedged read请求先于原始请求返回的qps
+    PerSecondMetric hedgedReadWinQPS;
+
+    // 被QoS限制的读写请求的等待时间
+    bvar::LatencyRecorder readThrottleWait;
+    bvar::LatencyRecorder writeThrottleWait;
+
     explicit FileMetric(const std::string& name)
         : filename(name),
           userRead(prefix, filename + "_read"),
@@ -129,7 +138,11 @@ struct FileMetric {
           getLeaderRetryQPS(prefix, filename + "_get_leader_retry_rpc"),
           writeSizeRecorder(prefix, filename + "_write_request_size_recoder"),
           readSizeRecorder(prefix, filename + "_read_request_size_recoder"),
-          suspendRPCMetric(prefix, filename + "_suspend_io_num") {}
+          suspendRPCMetric(prefix, filename + "_suspend_io_num"),
+          hedgedReadQPS(prefix, filename + "_hedged_read_rpc"),
+          hedgedReadWinQPS(prefix, filename + "_hedged_read_win_rpc"),
+          readThrottleWait(prefix, filename + "_read_throttle_wait"),
+          writeThrottleWait(prefix, filename + "_write_throttle_wait") {}
 };
 
 // 用于全局mds接口统计信息调用信息统计
@@ -150,6 +163,8 @@ struct MDSClientMetric {
     InterfaceMetric getFile;
     // RefreshSession接口统计信息
     InterfaceMetric refreshSession;
+    // RefreshSessionBatch接口统计信息
+    InterfaceMetric refreshSessionBatch;
     // GetServerList接口统计信息
     InterfaceMetric getServerList;
     // GetOrAllocateSegment接口统计信息
@@ -183,6 +198,7 @@ struct MDSClientMetric {
           closeFile(prefix, "closeFile"),
           getFile(prefix, "getFileInfo"),
           refreshSession(prefix, "refreshSession"),
+          refreshSessionBatch(prefix, "refreshSessionBatch"),
           getServerList(prefix, "getServerList"),
           getOrAllocateSegment(prefix, "getOrAllocateSegment"),
           renameFile(prefix, "renameFile"),
@@ -433,6 +449,49 @@ class MetricHelper {
         }
     }
 
+    /**
+     * 统计发送的hedged read请求次数
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremHedgedReadCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->hedgedReadQPS.count << 1;
+        }
+    }
+
+    /**
+     * 统计hedged read请求先于原始请求返回的次数
+     * @param: fm为当前文件的metric指针
+     */
+    static void IncremHedgedReadWinCount(FileMetric* fm) {
+        if (fm != nullptr) {
+            fm->hedgedReadWinQPS.count << 1;
+        }
+    }
+
+    /**
+     * 统计请求因QoS限制等待的时间
+     * @param: fm为当前文件的metric指针
+     * @param: waitUs为等待时间
+     * @param: type为请求类型
+     */
+    static void ThrottleWaitRecord(FileMetric* fm,
+                                   uint64_t waitUs,
+                                   OpType type) {
+        if (fm != nullptr) {
+            switch (type) {
+                case OpType::READ:
+                    fm->readThrottleWait << waitUs;
+                    break;
+                case OpType::WRITE:
+                    fm->writeThrottleWait << waitUs;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
     static void IncremInflightRPC(FileMetric* fm) {
         if (fm != nullptr) {
             fm->inflightRPCNum << 1;
@@ -90,8 +90,14 @@ typedef struct MetaServerOption {
  */
 typedef struct LeaseOption {
     uint32_t mdsRefreshTimesPerLease;
+    // 是否开启批量续约，开启后同一进程内打开的文件由LeaseManager统一续约
+    bool enableBatchRefresh;
+    // 一次批量续约rpc中最多包含的文件数
+    uint32_t maxBatchRefreshFileNum;
     LeaseOption() {
         mdsRefreshTimesPerLease = 5;
+        enableBatchRefresh = false;
+        maxBatchRefreshFileNum = 100;
     }
 } LeaseOption_t;
 
@@ -165,16 +171,48 @@ typedef struct FailureRequestOption {
     }
 } FailureRequestOption_t;
 
+/**
+ * follower read配置，依赖chunkserverEnableAppliedIndexRead
+ * @enableFollowerRead: 是否开启follower read，开启后带appliedindex的读请求
+ *                      会优先发往与client同机的副本，否则在各副本间轮询
+ * @followerLagBackoffMS: 某个follower因数据落后拒绝读请求之后，在该时间内
+ *                      不再向其发送follower read请求
+ */
+struct FollowerReadOption {
+    bool enableFollowerRead{false};
+    uint64_t followerLagBackoffMS{1000};
+};
+
+/**
+ * hedged read配置，依赖chunkserverEnableAppliedIndexRead
+ * @enableHedgedRead: 是否开启hedged read，开启后带appliedindex的读请求如果
+ *                    在一定时间内没有返回，会向copyset的另一个副本再发送一次，
+ *                    以先返回的结果为准
+ * @latencyPercentile: 等待时间取目标chunkserver最近读请求时延的该分位值
+ * @minDelayUS: 发送hedge请求前的最小等待时间
+ * @maxDelayUS: 发送hedge请求前的最大等待时间
+ */
+struct HedgedReadOption {
+    bool enableHedgedRead{false};
+    double latencyPercentile{0.99};
+    uint64_t minDelayUS{2000};
+    uint64_t maxDelayUS{100000};
+};
+
 /**
  * 发送rpc给chunkserver的配置
  * @chunkserverEnableAppliedIndexRead: 是否开启使用appliedindex read
  * @inflightOpt: 一个文件向chunkserver发送请求时的inflight 请求控制配置
  * @failRequestOpt: rpc发送失败之后，需要进行rpc重试的相关配置
+ * @followerReadOpt: follower read相关配置
+ * @hedgedReadOpt: hedged read相关配置
  */
 typedef struct IOSenderOption {
     bool chunkserverEnableAppliedIndexRead;
     InFlightIOCntlInfo_t inflightOpt;
     FailureRequestOption_t failRequestOpt;
+    FollowerReadOption followerReadOpt;
+    HedgedReadOption hedgedReadOpt;
 } IOSenderOption_t;
 
 /**
@@ -230,11 +268,15 @@ typedef struct MetaCacheOption {
  * IO 拆分模块配置信息
  * @fileIOSplitMaxSizeKB: 用户下发IO大小client没有限制，但是client会将用户的IO进行拆分，
  *                        发向同一个chunkserver的请求锁携带的数据大小不能超过该值。
+ * @enableLargeIOFastPath: 大IO模式，开启后chunk内的IO不再按fileIOSplitMaxSizeKB拆分，
+ *                         最大一个chunk大小的IO作为一个rpc下发，数据以IOBuf链式携带
  */
 typedef struct IOSplitOPtion {
     uint64_t  fileIOSplitMaxSizeKB;
+    bool      enableLargeIOFastPath;
     IOSplitOPtion() {
         fileIOSplitMaxSizeKB = 64;
+        enableLargeIOFastPath = false;
     }
 } IOSplitOPtion_t;
 
@@ -254,6 +296,21 @@ typedef struct TaskThreadOption {
     }
 } TaskThreadOption_t;
 
+/**
+ * 文件的QoS限制，打开文件时作为默认值，mds在OpenFile和RefreshSession
+ * 返回的文件信息中携带的限制会覆盖对应项，各项为0表示不限制
+ * @readIOPS/writeIOPS: 读写IOPS限制
+ * @readBPS/writeBPS: 读写带宽限制，单位byte/s
+ * @burstSeconds: 空闲时最多积累burstSeconds秒的额度，用于应对突发IO
+ */
+struct ThrottleOption {
+    uint64_t readIOPS{0};
+    uint64_t writeIOPS{0};
+    uint64_t readBPS{0};
+    uint64_t writeBPS{0};
+    uint64_t burstSeconds{1};
+};
+
 /**
  * IOOption存储了当前io 操作所需要的所有配置信息
  */
@@ -263,6 +320,7 @@ typedef struct IOOption {
     MetaCacheOption_t       metaCacheOpt;
     TaskThreadOption_t      taskThreadOpt;
     RequestScheduleOption_t reqSchdulerOpt;
+    ThrottleOption          throttleOpt;
 } IOOption_t;
 
 /**
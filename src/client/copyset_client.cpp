@@ -26,12 +26,15 @@
 #include <unistd.h>
 #include <memory>
 #include <utility>
+#include <algorithm>
 
 #include "src/client/request_sender.h"
 #include "src/client/metacache.h"
 #include "src/client/client_config.h"
 #include "src/client/request_scheduler.h"
 #include "src/client/request_closure.h"
+#include "src/common/net_common.h"
+#include "src/common/timeutility.h"
 
 using google::protobuf::Closure;
 namespace curve {
@@ -53,13 +56,28 @@ int CopysetClient::Init(MetaCache *metaCache,
     }
     iosenderopt_ = ioSenderOpt;
 
+    if (iosenderopt_.followerReadOpt.enableFollowerRead ||
+        iosenderopt_.hedgedReadOpt.enableHedgedRead) {
+        std::string ip;
+        if (!curve::common::NetCommon::GetLocalIP(&ip) ||
+            0 != butil::str2ip(ip.c_str(), &localIp_)) {
+            LOG(WARNING) << "Get local ip failed, follower read will not "
+                         << "prefer local replica";
+            localIp_ = butil::IP_ANY;
+        }
+    }
+
     LOG(INFO) << "CopysetClient init success, conf info: "
               << ", chunkserverOPRetryIntervalUS = "
               << iosenderopt_.failRequestOpt.chunkserverOPRetryIntervalUS
               << ", chunkserverOPMaxRetry = "
               << iosenderopt_.failRequestOpt.chunkserverOPMaxRetry
               << ", chunkserverMaxRPCTimeoutMS = "
-              << iosenderopt_.failRequestOpt.chunkserverMaxRPCTimeoutMS;
+              << iosenderopt_.failRequestOpt.chunkserverMaxRPCTimeoutMS
+              << ", enableFollowerRead = "
+              << iosenderopt_.followerReadOpt.enableFollowerRead
+              << ", enableHedgedRead = "
+              << iosenderopt_.hedgedReadOpt.enableHedgedRead;
     return 0;
 }
 bool CopysetClient::FetchLeader(LogicPoolID lpid, CopysetID cpid,
@@ -122,13 +140,42 @@ int CopysetClient::ReadChunk(const ChunkIDInfo& idinfo, uint64_t sn,
         }
     }
 
+    // hedge请求可能发往follower，与follower read一样只能用于带appliedindex
+    // 且不需要从源端拷贝数据的读请求
+    bool hedgedRead = iosenderopt_.chunkserverEnableAppliedIndexRead &&
+                      iosenderopt_.hedgedReadOpt.enableHedgedRead &&
+                      appliedindex > 0 &&
+                      sourceInfo.cloneFileSource.empty();
+
     auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
-        ReadChunkClosure *readDone = new ReadChunkClosure(this, done);
+        if (!hedgedRead) {
+            ReadChunkClosure *readDone = new ReadChunkClosure(this, done);
+            senderPtr->ReadChunk(idinfo, sn, offset, length,
+                                 appliedindex, sourceInfo, readDone);
+            return;
+        }
+
+        auto state = std::make_shared<HedgedReadState>(
+            this, done, idinfo, offset, length, appliedindex);
+        ChunkServerID primaryId = senderPtr->GetChunkServerId();
+        ReadChunkClosure *readDone = new ReadChunkClosure(this, done, state);
         senderPtr->ReadChunk(idinfo, sn, offset, length,
                              appliedindex, sourceInfo, readDone);
+        // 原始请求发送之后done可能已经被回调，之后不能再访问done
+        HedgedReadState::ArmTimer(state, primaryId,
+                                  GetHedgedReadDelayUs(primaryId));
     };
 
-    return DoRPCTask(idinfo, task, doneGuard.release());
+    // follower read只用于带appliedindex的读请求，chunkserver端只有在
+    // follower的appliedindex不小于请求的appliedindex时才会处理，否则返回
+    // REDIRECTED，clone chunk的读可能需要从源端拷贝数据写入，只能发往leader
+    bool followerRead = iosenderopt_.chunkserverEnableAppliedIndexRead &&
+                        iosenderopt_.followerReadOpt.enableFollowerRead &&
+                        appliedindex > 0 &&
+                        sourceInfo.cloneFileSource.empty() &&
+                        !reqclosure->GetReqCtx()->followerReadFallback_;
+
+    return DoRPCTask(idinfo, task, doneGuard.release(), followerRead);
 }
 
 int CopysetClient::WriteChunk(const ChunkIDInfo& idinfo, uint64_t sn,
@@ -226,6 +273,20 @@ int CopysetClient::CreateCloneChunk(const ChunkIDInfo& idinfo,
     return DoRPCTask(idinfo, task, done);
 }
 
+int CopysetClient::CreateCloneChunks(const ChunkIDInfo& idinfo,
+                                     const std::vector<CloneChunkDesc>& chunks,
+                                     uint64_t correntSn, uint64_t chunkSize,
+                                     Closure* done) {
+    auto task = [&](Closure* done, std::shared_ptr<RequestSender> senderPtr) {
+        CreateCloneChunksClosure* createClonesDone =
+            new CreateCloneChunksClosure(this, done);
+        senderPtr->CreateCloneChunks(idinfo, createClonesDone, chunks,
+                                     correntSn, chunkSize);
+    };
+
+    return DoRPCTask(idinfo, task, done);
+}
+
 int CopysetClient::RecoverChunk(const ChunkIDInfo& idinfo,
                                  uint64_t offset,
                                 uint64_t len, Closure* done) {
@@ -241,8 +302,10 @@ int CopysetClient::RecoverChunk(const ChunkIDInfo& idinfo,
 
 int CopysetClient::DoRPCTask(const ChunkIDInfo& idinfo,
     std::function<void(Closure* done,
-    std::shared_ptr<RequestSender> senderptr)> task, Closure *done) {
+    std::shared_ptr<RequestSender> senderptr)> task, Closure *done,
+    bool followerRead) {
     RequestClosure* reqclosure = static_cast<RequestClosure*>(done);
+    RequestContext* reqCtx = reqclosure->GetReqCtx();
 
     ChunkServerID leaderId;
     butil::EndPoint leaderAddr;
@@ -251,7 +314,15 @@ int CopysetClient::DoRPCTask(const ChunkIDInfo& idinfo,
     while (reqclosure->GetRetriedTimes() <
         iosenderopt_.failRequestOpt.chunkserverOPMaxRetry) {
         reqclosure->IncremRetriedTimes();
-        if (false == FetchLeader(idinfo.lpid_, idinfo.cpid_,
+        bool isLeader = true;
+        if (followerRead) {
+            reqCtx->readFromFollower_ = false;
+        }
+
+        if (followerRead && 0 == metaCache_->GetFollowerReadPeer(idinfo.lpid_,
+            idinfo.cpid_, localIp_, &leaderId, &leaderAddr, &isLeader)) {
+            reqCtx->readFromFollower_ = !isLeader;
+        } else if (false == FetchLeader(idinfo.lpid_, idinfo.cpid_,
             &leaderId, &leaderAddr)) {
             bthread_usleep(
             iosenderopt_.failRequestOpt.chunkserverOPRetryIntervalUS);
@@ -274,5 +345,50 @@ int CopysetClient::DoRPCTask(const ChunkIDInfo& idinfo,
 
     return 0;
 }
+
+void CopysetClient::SendHedgedRead(std::shared_ptr<HedgedReadState> state,
+                                   Closure* done,
+                                   const ChunkIDInfo& idinfo,
+                                   off_t offset,
+                                   size_t length,
+                                   uint64_t appliedindex,
+                                   ChunkServerID excludeId) {
+    ChunkServerID csid;
+    butil::EndPoint csAddr;
+    bool isLeader = false;
+    if (0 != metaCache_->GetFollowerReadPeer(idinfo.lpid_, idinfo.cpid_,
+        localIp_, &csid, &csAddr, &isLeader, excludeId)) {
+        return;
+    }
+
+    auto senderPtr = senderManager_->GetOrCreateSender(csid, csAddr,
+                                                       iosenderopt_);
+    if (nullptr == senderPtr) {
+        LOG(WARNING) << "create or reset sender failed, chunkserver id = "
+                     << csid;
+        return;
+    }
+
+    MetricHelper::IncremHedgedReadCount(fileMetric_);
+    HedgedReadClosure* hedgedDone = new HedgedReadClosure(this, done, state);
+    senderPtr->HedgedReadChunk(idinfo, offset, length, appliedindex,
+                               hedgedDone);
+}
+
+uint64_t CopysetClient::GetHedgedReadDelayUs(ChunkServerID csid) {
+    const HedgedReadOption& opt = iosenderopt_.hedgedReadOpt;
+    uint64_t delayUs = UnstableHelper::GetInstance().GetReadLatencyPercentile(
+        csid, opt.latencyPercentile);
+    delayUs = std::max(delayUs, opt.minDelayUS);
+    delayUs = std::min(delayUs, opt.maxDelayUS);
+    return delayUs;
+}
+
+void CopysetClient::OnFollowerReadLagging(const ChunkIDInfo& idinfo,
+                                          ChunkServerID csid) {
+    uint64_t untilMs = curve::common::TimeUtility::GetTimeofDayMs() +
+                       iosenderopt_.followerReadOpt.followerLagBackoffMS;
+    metaCache_->SetFollowerLagging(idinfo.lpid_, idinfo.cpid_, csid, untilMs);
+}
 }   // namespace client
 }   // namespace curve
@@ -30,6 +30,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "src/common/concurrent/concurrent.h"
 #include "src/client/client_metric.h"
@@ -63,7 +64,8 @@ class CopysetClient : public Uncopyable {
         metaCache_(nullptr),
         senderManager_(nullptr),
         scheduler_(nullptr),
-        exitFlag_(false) {}
+        exitFlag_(false),
+        localIp_(butil::IP_ANY) {}
 
     virtual ~CopysetClient() {
         delete senderManager_;
@@ -165,6 +167,21 @@ class CopysetClient : public Uncopyable {
                   uint64_t chunkSize,
                   Closure *done);
 
+    /**
+    * @brief 批量创建同一copyset上的clone chunk
+    * @param idinfo为copyset相关的id信息
+    * @param:chunks 要创建的chunk
+    * @param:correntSn 用于修改chunk的correctedSn
+    * @param:chunkSize chunk的大小
+    * @param done:上一层异步回调的closure
+    * @return 错误码
+    */
+    int CreateCloneChunks(const ChunkIDInfo& idinfo,
+                  const std::vector<CloneChunkDesc> &chunks,
+                  uint64_t correntSn,
+                  uint64_t chunkSize,
+                  Closure *done);
+
    /**
     * @brief 实际恢复chunk数据
     * @param idinfo为chunk相关的id信息
@@ -216,6 +233,7 @@ class CopysetClient : public Uncopyable {
  private:
     friend class WriteChunkClosure;
     friend class ReadChunkClosure;
+    friend class HedgedReadState;
 
     // 拉取新的leader信息
     bool FetchLeader(LogicPoolID lpid,
@@ -232,7 +250,40 @@ class CopysetClient : public Uncopyable {
      */
     int DoRPCTask(const ChunkIDInfo& idinfo,
         std::function<void(Closure*, std::shared_ptr<RequestSender>)> task,
-        Closure *done);
+        Closure *done, bool followerRead = false);
+
+    /**
+     * follower因数据落后拒绝读请求，在followerLagBackoffMS内不再向其发送follower read
+     * @param[in]: idinfo为当前rpc task的id信息
+     * @param[in]: csid为拒绝读请求的chunkserver id
+     */
+    void OnFollowerReadLagging(const ChunkIDInfo& idinfo, ChunkServerID csid);
+
+    /**
+     * 向copyset中除excludeId以外的副本发送hedge读请求，请求结果由
+     * HedgedReadClosure与原始请求争抢
+     * @param[in]: state为原始请求与hedge请求共享的状态
+     * @param[in]: done为上层的回调
+     * @param[in]: idinfo为chunk相关的id信息
+     * @param[in]: offset为读的偏移
+     * @param[in]: length为读的长度
+     * @param[in]: appliedindex为需要读到>=appliedIndex的数据
+     * @param[in]: excludeId为原始请求发往的chunkserver
+     */
+    void SendHedgedRead(std::shared_ptr<HedgedReadState> state,
+                        Closure* done,
+                        const ChunkIDInfo& idinfo,
+                        off_t offset,
+                        size_t length,
+                        uint64_t appliedindex,
+                        ChunkServerID excludeId);
+
+    /**
+     * 计算发送hedge请求前的等待时间，取chunkserver读时延的分位值
+     * @param[in]: csid为原始请求发往的chunkserver
+     * @return: 等待时间(us)
+     */
+    uint64_t GetHedgedReadDelayUs(ChunkServerID csid);
 
  private:
     // 元数据缓存
@@ -255,6 +306,9 @@ class CopysetClient : public Uncopyable {
 
     // 是否在停止状态中，如果是在关闭过程中且session失效，需要将rpc直接返回不下发
     bool exitFlag_;
+
+    // client所在节点的ip，follower read时优先选择同机副本
+    butil::ip_t localIp_;
 };
 
 }   // namespace client
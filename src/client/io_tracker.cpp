@@ -234,6 +234,40 @@ void IOTracker::CreateCloneChunk(const std::string& location,
     }
 }
 
+void IOTracker::CreateCloneChunks(const ChunkIDInfo& cinfo,
+                                  const std::vector<CloneChunkDesc>& chunks,
+                                  uint64_t correntSn, uint64_t chunkSize,
+                                  std::vector<ChunkID>* existChunkIds,
+                                  SnapCloneClosure* scc) {
+    type_ = OpType::CREATE_CLONE_BATCH;
+    scc_ = scc;
+
+    int ret = -1;
+    do {
+        RequestContext* newreqNode = GetInitedRequestContext();
+        if (newreqNode == nullptr) {
+            break;
+        }
+
+        newreqNode->chunksize_   = chunkSize;
+        newreqNode->correctedSeq_  = correntSn;
+        newreqNode->cloneChunks_ = chunks;
+        newreqNode->existChunkIds_ = existChunkIds;
+        FillCommonFields(cinfo, newreqNode);
+
+        reqlist_.push_back(newreqNode);
+        reqcount_.store(reqlist_.size(), std::memory_order_release);
+
+        ret = scheduler_->ScheduleRequest(reqlist_);
+    } while (false);
+
+    if (ret == -1) {
+        LOG(ERROR) << "CreateCloneChunks request schedule failed,"
+                   << "return and recyle resource!";
+        ReturnOnFail();
+    }
+}
+
 void IOTracker::RecoverChunk(const ChunkIDInfo& cinfo, uint64_t offset,
                              uint64_t len, SnapCloneClosure* scc) {
     type_ = OpType::RECOVER_CHUNK;
@@ -87,6 +87,17 @@ int IOManager4Chunk::CreateCloneChunk(const std::string &location,
     return 0;
 }
 
+int IOManager4Chunk::CreateCloneChunks(const ChunkIDInfo &copysetidinfo,
+    const std::vector<CloneChunkDesc> &chunks, uint64_t correntSn,
+    uint64_t chunkSize, std::vector<ChunkID> *existChunkIds,
+    SnapCloneClosure* scc) {
+
+    IOTracker* temp = new IOTracker(this, &mc_, scheduler_);
+    temp->CreateCloneChunks(copysetidinfo, chunks, correntSn,
+                            chunkSize, existChunkIds, scc);
+    return 0;
+}
+
 int IOManager4Chunk::RecoverChunk(const ChunkIDInfo& chunkIdInfo,
                                   uint64_t offset, uint64_t len,
                                   SnapCloneClosure* scc) {
@@ -26,6 +26,7 @@
 #include <atomic>
 #include <mutex>    // NOLINT
 #include <string>
+#include <vector>
 #include <condition_variable>   // NOLINT
 
 #include "src/client/metacache.h"
@@ -97,6 +98,23 @@ class IOManager4Chunk : public IOManager {
                                 uint64_t chunkSize,
                                 SnapCloneClosure* scc);
 
+    /**
+    * @brief 批量创建同一copyset上的clone chunk
+    * @param:copysetidinfo 目标copyset，chunk id为第一个要创建的chunk
+    * @param:chunks 要创建的chunk
+    * @param:correntSn 用于修改chunk的correctedSn
+    * @param:chunkSize chunk的大小
+    * @param:existChunkIds 出参，已存在且信息与请求不符的chunk
+    * @param: scc是异步回调
+    * @return 成功返回0， 否则-1
+    */
+    int CreateCloneChunks(const ChunkIDInfo &copysetidinfo,
+                          const std::vector<CloneChunkDesc> &chunks,
+                          uint64_t correntSn,
+                          uint64_t chunkSize,
+                          std::vector<ChunkID> *existChunkIds,
+                          SnapCloneClosure* scc);
+
     /**
      * @brief 实际恢复chunk数据
      * @param chunkidinfo chunkidinfo
@@ -22,8 +22,13 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <bthread/bthread.h>
+#include <bthread/unstable.h>
+#include <butil/time.h>
 
 #include <chrono>   // NOLINT
+#include <algorithm>
+#include <memory>
 
 #include "src/client/metacache.h"
 #include "src/client/iomanager4file.h"
@@ -31,6 +36,9 @@
 #include "src/client/io_tracker.h"
 #include "src/client/splitor.h"
 
+using curve::common::ThrottleType;
+using curve::common::ThrottleParams;
+
 namespace curve {
 namespace client {
 Atomic<uint64_t> IOManager::idRecorder_(1);
@@ -48,6 +56,9 @@ bool IOManager4File::Initialize(const std::string& filename,
     inflightRpcCntl_.SetMaxInflightNum(
         ioopt_.ioSenderOpt.inflightOpt.fileMaxInFlightRPCNum);
 
+    // 使用配置文件中的限制
+    UpdateThrottleParams({});
+
     fileMetric_ = new (std::nothrow) FileMetric(filename);
     if (fileMetric_ == nullptr) {
         LOG(ERROR) << "allocate client metric failed!";
@@ -129,6 +140,7 @@ int IOManager4File::Read(char* buf, off_t offset,
     size_t length, MDSClient* mdsclient) {
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::READ);
     FlightIOGuard guard(this);
+    WaitThrottle(OpType::READ, length);
 
     IOTracker temp(this, &mc_, scheduler_, fileMetric_);
     temp.StartRead(nullptr, buf, offset, length, mdsclient,
@@ -142,6 +154,7 @@ int IOManager4File::Write(const char* buf, off_t offset,
     size_t length, MDSClient* mdsclient) {
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::WRITE);
     FlightIOGuard guard(this);
+    WaitThrottle(OpType::WRITE, length);
 
     IOTracker temp(this, &mc_, scheduler_, fileMetric_);
     temp.StartWrite(nullptr, buf, offset, length, mdsclient,
@@ -165,9 +178,12 @@ int IOManager4File::AioRead(CurveAioContext* ctx, MDSClient* mdsclient) {
 
     inflightCntl_.IncremInflightNum();
     auto task = [this, ctx, mdsclient, temp]() {
-        temp->StartRead(ctx, static_cast<char*>(ctx->buf),
-                        ctx->offset, ctx->length, mdsclient,
-                        this->GetFileInfo());
+        StartAfterThrottle(OpType::READ, ctx->length,
+            [this, ctx, mdsclient, temp]() {
+                temp->StartRead(ctx, static_cast<char*>(ctx->buf),
+                                ctx->offset, ctx->length, mdsclient,
+                                this->GetFileInfo());
+            });
     };
 
     taskPool_.Enqueue(task);
@@ -188,9 +204,12 @@ int IOManager4File::AioWrite(CurveAioContext* ctx, MDSClient* mdsclient) {
 
     inflightCntl_.IncremInflightNum();
     auto task = [this, ctx, mdsclient, temp]() {
-        temp->StartWrite(ctx, static_cast<const char*>(ctx->buf),
-                         ctx->offset, ctx->length, mdsclient,
-                         this->GetFileInfo());
+        StartAfterThrottle(OpType::WRITE, ctx->length,
+            [this, ctx, mdsclient, temp]() {
+                temp->StartWrite(ctx, static_cast<const char*>(ctx->buf),
+                                 ctx->offset, ctx->length, mdsclient,
+                                 this->GetFileInfo());
+            });
     };
 
     taskPool_.Enqueue(task);
@@ -199,6 +218,90 @@ int IOManager4File::AioWrite(CurveAioContext* ctx, MDSClient* mdsclient) {
 
 void IOManager4File::UpdateFileInfo(const FInfo_t& fi) {
     mc_.UpdateFileInfo(fi);
+    UpdateThrottleParams(fi.throttleParams);
+}
+
+void IOManager4File::UpdateThrottleParams(
+    const std::map<ThrottleType, ThrottleParams>& params) {
+    // mds没有下发的限制项使用配置文件中的值，mds取消限制后恢复为配置的限制
+    const ThrottleOption& throttleOpt = ioopt_.throttleOpt;
+    std::map<ThrottleType, ThrottleParams> merged = {
+        {ThrottleType::IOPS_READ, ThrottleParams(throttleOpt.readIOPS, 0)},
+        {ThrottleType::IOPS_WRITE, ThrottleParams(throttleOpt.writeIOPS, 0)},
+        {ThrottleType::BPS_READ, ThrottleParams(throttleOpt.readBPS, 0)},
+        {ThrottleType::BPS_WRITE, ThrottleParams(throttleOpt.writeBPS, 0)}};
+    for (const auto& item : params) {
+        merged[item.first] = item.second;
+    }
+
+    for (const auto& item : merged) {
+        ThrottleParams newParams = item.second;
+        if (newParams.burst == 0) {
+            newParams.burst =
+                newParams.limit * ioopt_.throttleOpt.burstSeconds;
+        }
+
+        // 限制没有变化时不重新设置，避免重置令牌桶的额度
+        ThrottleParams oldParams = throttle_.GetThrottleParams(item.first);
+        if (oldParams.limit == newParams.limit &&
+            oldParams.burst == std::max(newParams.limit, newParams.burst)) {
+            continue;
+        }
+
+        LOG(INFO) << "update throttle params, type = " << item.first
+                  << ", limit = " << newParams.limit
+                  << ", burst = " << newParams.burst;
+        throttle_.UpdateThrottleParams(item.first, newParams);
+    }
+}
+
+void IOManager4File::WaitThrottle(OpType type, size_t length) {
+    uint64_t waitUs = throttle_.Add(type == OpType::READ, length);
+    if (waitUs == 0) {
+        return;
+    }
+
+    MetricHelper::ThrottleWaitRecord(fileMetric_, waitUs, type);
+    bthread_usleep(waitUs);
+}
+
+namespace {
+
+void* RunThrottledIO(void* arg) {
+    std::unique_ptr<std::function<void()>> task(
+        static_cast<std::function<void()>*>(arg));
+    (*task)();
+    return nullptr;
+}
+
+void OnThrottleTimer(void* arg) {
+    // 定时器线程中不执行IO的拆分和下发
+    bthread_t tid;
+    if (bthread_start_background(&tid, nullptr, RunThrottledIO, arg) != 0) {
+        RunThrottledIO(arg);
+    }
+}
+
+}  // namespace
+
+void IOManager4File::StartAfterThrottle(OpType type, size_t length,
+                                        std::function<void()> task) {
+    uint64_t waitUs = throttle_.Add(type == OpType::READ, length);
+    if (waitUs == 0) {
+        task();
+        return;
+    }
+
+    // 不在task thread pool中等待，避免阻塞同一文件上的其他IO
+    MetricHelper::ThrottleWaitRecord(fileMetric_, waitUs, type);
+    auto* arg = new std::function<void()>(std::move(task));
+    bthread_timer_t timer;
+    if (bthread_timer_add(&timer, butil::microseconds_from_now(waitUs),
+                          OnThrottleTimer, arg) != 0) {
+        LOG(WARNING) << "add throttle timer failed, wait in task pool";
+        bthread_usleep(waitUs);
+        RunThrottledIO(arg);
+    }
 }
 
 void IOManager4File::HandleAsyncIOResponse(IOTracker* iotracker) {
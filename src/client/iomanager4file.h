@@ -23,6 +23,8 @@
 #ifndef SRC_CLIENT_IOMANAGER4FILE_H_
 #define SRC_CLIENT_IOMANAGER4FILE_H_
 
+#include <functional>
+#include <map>
 #include <string>
 #include <atomic>
 #include <mutex>  // NOLINT
@@ -37,6 +39,7 @@
 #include "src/client/request_scheduler.h"
 #include "include/curve_compiler_specific.h"
 #include "src/client/inflight_controller.h"
+#include "src/common/throttle.h"
 
 using curve::common::Atomic;
 
@@ -145,6 +148,22 @@ class IOManager4File : public IOManager {
    */
   void UpdateFileInfo(const FInfo_t& fi);
 
+  /**
+   * 更新文件的QoS限制，打开文件及lease续约时由mds下发
+   * @param: params为mds下发的限制项，burst为0时根据配置计算，
+   *         没有下发的限制项恢复为配置文件中的限制
+   */
+  void UpdateThrottleParams(
+      const std::map<curve::common::ThrottleType,
+                     curve::common::ThrottleParams>& params);
+
+  /**
+   * 获取文件当前的QoS限制，测试使用
+   */
+  curve::common::Throttle* GetThrottle() {
+    return &throttle_;
+  }
+
   const FInfo* GetFileInfo() const {
     return mc_.GetFileInfo();
   }
@@ -190,6 +209,23 @@ class IOManager4File : public IOManager {
    */
   void HandleAsyncIOResponse(IOTracker* iotracker) override;
 
+  /**
+   * 根据QoS限制等待，直到当前IO可以下发
+   * @param: type为IO类型
+   * @param: length为IO大小
+   */
+  void WaitThrottle(OpType type, size_t length);
+
+  /**
+   * 根据QoS限制延迟下发异步IO，需要等待时通过bthread定时器下发，
+   * 不占用task thread pool的线程
+   * @param: type为IO类型
+   * @param: length为IO大小
+   * @param: task为下发IO的任务
+   */
+  void StartAfterThrottle(OpType type, size_t length,
+                          std::function<void()> task);
+
   class FlightIOGuard {
    public:
     explicit FlightIOGuard(IOManager4File* iomana) {
@@ -227,6 +263,9 @@ class IOManager4File : public IOManager {
   // inflight rpc控制
   InflightControl inflightRpcCntl_;
 
+  // 文件的QoS限制
+  curve::common::Throttle throttle_;
+
   // 是否退出
   bool exit_;
 
@@ -23,6 +23,7 @@
 
 #include "src/common/timeutility.h"
 #include "src/client/lease_executor.h"
+#include "src/client/lease_manager.h"
 #include "src/client/service_helper.h"
 
 using curve::common::TimeUtility;
@@ -34,7 +35,8 @@ LeaseExecutor::LeaseExecutor(const LeaseOption_t& leaseOpt,
                            MDSClient* mdsclient,
                            IOManager4File* iomanager):
                            isleaseAvaliable_(true),
-                           failedrefreshcount_(0) {
+                           failedrefreshcount_(0),
+                           registered_(false) {
     userinfo_    = userinfo;
     mdsclient_   = mdsclient;
     iomanager_   = iomanager;
@@ -43,6 +45,10 @@ LeaseExecutor::LeaseExecutor(const LeaseOption_t& leaseOpt,
 }
 
 LeaseExecutor::~LeaseExecutor() {
+    if (registered_.exchange(false)) {
+        LeaseManager::GetInstance().Unregister(mdsclient_, this);
+    }
+
     if (task_) {
         task_->WaitTaskExit();
     }
@@ -68,6 +74,13 @@ bool LeaseExecutor::Start(const FInfo_t& fi, const LeaseSession_t&  lease) {
     auto interval =
         leasesession_.leaseTime / leaseoption_.mdsRefreshTimesPerLease;
 
+    if (leaseoption_.enableBatchRefresh) {
+        LeaseManager::GetInstance().Register(
+            mdsclient_, this, interval, leaseoption_.maxBatchRefreshFileNum);
+        registered_.store(true);
+        return true;
+    }
+
     task_.reset(new (std::nothrow) RefreshSessionTask(this, interval));
     if (task_ == nullptr) {
         LOG(ERROR) << "Allocate RefreshSessionTask failed, filename = "
@@ -82,15 +95,32 @@ bool LeaseExecutor::Start(const FInfo_t& fi, const LeaseSession_t&  lease) {
 }
 
 bool LeaseExecutor::RefreshLease() {
+    BlockIOIfLeaseInvalid();
+
+    LeaseRefreshResult response;
+    LIBCURVE_ERROR ret = mdsclient_->RefreshSession(
+        fullFileName_, userinfo_, leasesession_.sessionID, &response);
+
+    return HandleRefreshResult(ret, response);
+}
+
+void LeaseExecutor::BlockIOIfLeaseInvalid() {
     if (!LeaseValid()) {
         LOG(INFO) << "lease not valid!";
         iomanager_->LeaseTimeoutBlockIO();
     }
+}
 
-    LeaseRefreshResult response;
-    LIBCURVE_ERROR ret = mdsclient_->RefreshSession(
-        fullFileName_, userinfo_, leasesession_.sessionID, &response);
+RefreshSessionContext LeaseExecutor::GetRefreshSessionContext() {
+    RefreshSessionContext context;
+    context.filename = fullFileName_;
+    context.userinfo = userinfo_;
+    context.sessionid = leasesession_.sessionID;
+    return context;
+}
 
+bool LeaseExecutor::HandleRefreshResult(LIBCURVE_ERROR ret,
+                                        const LeaseRefreshResult& response) {
     if (LIBCURVE_ERROR::FAILED == ret) {
         LOG(WARNING) << "Refresh session rpc failed, filename = "
                      << fullFileName_;
@@ -105,6 +135,8 @@ bool LeaseExecutor::RefreshLease() {
 
     if (response.status == LeaseRefreshResult::Status::OK) {
         CheckNeedUpdateVersion(response.finfo.seqnum);
+        // 没有下发限制时恢复为配置的限制
+        iomanager_->UpdateThrottleParams(response.finfo.throttleParams);
         failedrefreshcount_.store(0);
         isleaseAvaliable_.store(true);
         iomanager_->RefeshSuccAndResumeIO();
@@ -128,6 +160,10 @@ std::string LeaseExecutor::GetLeaseSessionID() {
 }
 
 void LeaseExecutor::Stop() {
+    if (registered_.exchange(false)) {
+        LeaseManager::GetInstance().Unregister(mdsclient_, this);
+    }
+
     if (task_ != nullptr) {
         task_->Stop();
     }
@@ -114,6 +114,25 @@ class LeaseExecutor {
      */
     bool RefreshLease();
 
+    /**
+     * @brief 续约前检查lease，lease已经失效时阻塞IO
+     */
+    void BlockIOIfLeaseInvalid();
+
+    /**
+     * @brief 获取批量续约需要的文件信息
+     */
+    RefreshSessionContext GetRefreshSessionContext();
+
+    /**
+     * @brief 处理续约结果，单个续约和批量续约共用
+     * @param ret 续约rpc的返回值
+     * @param response 续约结果
+     * @return 是否继续续约
+     */
+    bool HandleRefreshResult(LIBCURVE_ERROR ret,
+                             const LeaseRefreshResult& response);
+
     /**
      * @brief 测试使用，重置refresh session task
      */
@@ -159,6 +178,9 @@ class LeaseExecutor {
 
     // refresh session定时任务，会间隔固定时间执行一次
     std::unique_ptr<RefreshSessionTask> task_;
+
+    // 开启批量续约时，是否已经注册到LeaseManager
+    std::atomic<bool>       registered_;
 };
 
 // RefreshSessin定期任务
@@ -0,0 +1,261 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <limits>
+
+#include "src/client/lease_executor.h"
+#include "src/client/lease_manager.h"
+#include "src/common/timeutility.h"
+
+using curve::common::TimeUtility;
+
+namespace curve {
+namespace client {
+
+LeaseRefreshGroup::LeaseRefreshGroup(MDSClient* mdsclient,
+                                     uint32_t maxBatchSize,
+                                     uint64_t batchRetryIntervalUs)
+    : mdsclient_(mdsclient),
+      maxBatchSize_(std::max(maxBatchSize, 1u)),
+      batchSupported_(true),
+      batchRetryIntervalUs_(batchRetryIntervalUs),
+      nextBatchRetryUs_(0),
+      running_(false) {}
+
+LeaseRefreshGroup::~LeaseRefreshGroup() {
+    Stop();
+}
+
+void LeaseRefreshGroup::Start() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (running_) {
+        return;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&LeaseRefreshGroup::Run, this);
+}
+
+void LeaseRefreshGroup::Stop() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        cond_.notify_all();
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void LeaseRefreshGroup::Add(LeaseExecutor* executor, uint64_t intervalUs) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    Entry entry;
+    entry.intervalUs = intervalUs;
+    entry.nextRefreshUs = TimeUtility::GetTimeofDayUs() + intervalUs;
+    entries_[executor] = entry;
+    cond_.notify_all();
+}
+
+void LeaseRefreshGroup::Remove(LeaseExecutor* executor) {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        entries_.erase(executor);
+    }
+
+    // 等待正在进行的续约结束，之后的续约不会再包含该文件
+    std::lock_guard<std::mutex> lk(refreshMtx_);
+}
+
+size_t LeaseRefreshGroup::Size() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return entries_.size();
+}
+
+void LeaseRefreshGroup::Run() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lk(mtx_);
+            while (running_) {
+                uint64_t nextUs = std::numeric_limits<uint64_t>::max();
+                for (const auto& item : entries_) {
+                    nextUs = std::min(nextUs, item.second.nextRefreshUs);
+                }
+
+                uint64_t nowUs = TimeUtility::GetTimeofDayUs();
+                if (nextUs <= nowUs) {
+                    break;
+                }
+
+                if (nextUs == std::numeric_limits<uint64_t>::max()) {
+                    cond_.wait(lk);
+                } else {
+                    cond_.wait_for(lk,
+                                   std::chrono::microseconds(nextUs - nowUs));
+                }
+            }
+
+            if (!running_) {
+                return;
+            }
+        }
+
+        std::lock_guard<std::mutex> refreshLk(refreshMtx_);
+        std::vector<LeaseExecutor*> executors;
+        CollectDueExecutors(TimeUtility::GetTimeofDayUs(), &executors);
+
+        std::vector<LeaseExecutor*> stopped;
+        for (size_t i = 0; i < executors.size(); i += maxBatchSize_) {
+            size_t end = std::min(executors.size(),
+                                  i + static_cast<size_t>(maxBatchSize_));
+            std::vector<LeaseExecutor*> batch(executors.begin() + i,
+                                              executors.begin() + end);
+            RefreshBatch(batch, &stopped);
+        }
+
+        if (!stopped.empty()) {
+            std::lock_guard<std::mutex> lk(mtx_);
+            for (auto executor : stopped) {
+                entries_.erase(executor);
+            }
+        }
+    }
+}
+
+void LeaseRefreshGroup::CollectDueExecutors(
+    uint64_t nowUs, std::vector<LeaseExecutor*>* executors) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    for (auto& item : entries_) {
+        Entry& entry = item.second;
+        if (entry.nextRefreshUs <= nowUs + entry.intervalUs / 2) {
+            executors->push_back(item.first);
+            entry.nextRefreshUs = nowUs + entry.intervalUs;
+        }
+    }
+}
+
+void LeaseRefreshGroup::RefreshBatch(
+    const std::vector<LeaseExecutor*>& executors,
+    std::vector<LeaseExecutor*>* stopped) {
+    uint64_t nowUs = TimeUtility::GetTimeofDayUs();
+    if (batchSupported_ || nowUs >= nextBatchRetryUs_) {
+        std::vector<RefreshSessionContext> sessions;
+        sessions.reserve(executors.size());
+        for (auto executor : executors) {
+            executor->BlockIOIfLeaseInvalid();
+            sessions.push_back(executor->GetRefreshSessionContext());
+        }
+
+        std::vector<LIBCURVE_ERROR> rets;
+        std::vector<LeaseRefreshResult> resps;
+        LIBCURVE_ERROR ret =
+            mdsclient_->RefreshSessionBatch(sessions, &rets, &resps);
+        if (ret == LIBCURVE_ERROR::OK) {
+            if (!batchSupported_) {
+                LOG(INFO) << "mds support RefreshSessionBatch now";
+                batchSupported_ = true;
+            }
+            for (size_t i = 0; i < executors.size(); ++i) {
+                if (!executors[i]->HandleRefreshResult(rets[i], resps[i])) {
+                    stopped->push_back(executors[i]);
+                }
+            }
+            return;
+        } else if (ret != LIBCURVE_ERROR::NOT_SUPPORT) {
+            LeaseRefreshResult failed;
+            failed.status = LeaseRefreshResult::Status::FAILED;
+            for (auto executor : executors) {
+                executor->HandleRefreshResult(LIBCURVE_ERROR::FAILED, failed);
+            }
+            return;
+        }
+
+        LOG(WARNING) << "mds not support RefreshSessionBatch, "
+                     << "fallback to refresh session one by one, retry after "
+                     << batchRetryIntervalUs_ << " us";
+        batchSupported_ = false;
+        nextBatchRetryUs_ = nowUs + batchRetryIntervalUs_;
+    }
+
+    for (auto executor : executors) {
+        if (!executor->RefreshLease()) {
+            stopped->push_back(executor);
+        }
+    }
+}
+
+void LeaseManager::Register(MDSClient* mdsclient, LeaseExecutor* executor,
+                            uint64_t intervalUs, uint32_t maxBatchSize) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto iter = groups_.find(mdsclient);
+    if (iter == groups_.end()) {
+        std::shared_ptr<LeaseRefreshGroup> group =
+            std::make_shared<LeaseRefreshGroup>(mdsclient, maxBatchSize);
+        group->Start();
+        iter = groups_.emplace(mdsclient, std::move(group)).first;
+    }
+
+    iter->second->Add(executor, intervalUs);
+}
+
+void LeaseManager::Unregister(MDSClient* mdsclient, LeaseExecutor* executor) {
+    std::shared_ptr<LeaseRefreshGroup> group;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        auto iter = groups_.find(mdsclient);
+        if (iter == groups_.end()) {
+            return;
+        }
+        group = iter->second;
+    }
+
+    // 等待正在进行的续约结束时不持有mtx_
+    group->Remove(executor);
+
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        auto iter = groups_.find(mdsclient);
+        if (iter == groups_.end() || iter->second != group ||
+            group->Size() != 0) {
+            return;
+        }
+        groups_.erase(iter);
+    }
+
+    // 分组已经移除，不会再有新的文件加入，在锁外等待续约线程退出
+    group->Stop();
+}
+
+size_t LeaseManager::GetRegisteredNum(MDSClient* mdsclient) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto iter = groups_.find(mdsclient);
+    return iter == groups_.end() ? 0 : iter->second->Size();
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#ifndef SRC_CLIENT_LEASE_MANAGER_H_
+#define SRC_CLIENT_LEASE_MANAGER_H_
+
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>               // NOLINT
+#include <thread>              // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "src/client/mds_client.h"
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace client {
+
+class LeaseExecutor;
+
+// mds不支持批量续约时，每隔该时间重新尝试批量续约，mds升级后client不需要重启
+const uint64_t kBatchRefreshRetryIntervalUs = 10 * 60 * 1000 * 1000ull;
+
+/**
+ * 同一个mds上需要续约的文件，由一个后台线程统一续约。
+ * 某个文件到期时，会把在半个续约周期内到期的其他文件一起续约，
+ * 这样同样续约周期的文件会逐渐对齐，每个周期只需要少量的rpc
+ */
+class LeaseRefreshGroup : public curve::common::Uncopyable {
+ public:
+    LeaseRefreshGroup(MDSClient* mdsclient, uint32_t maxBatchSize,
+        uint64_t batchRetryIntervalUs = kBatchRefreshRetryIntervalUs);
+
+    ~LeaseRefreshGroup();
+
+    /**
+     * @brief 启动后台续约线程
+     */
+    void Start();
+
+    /**
+     * @brief 停止后台续约线程
+     */
+    void Stop();
+
+    /**
+     * @brief 添加需要续约的文件
+     * @param executor 文件对应的续约执行者
+     * @param intervalUs 续约间隔
+     */
+    void Add(LeaseExecutor* executor, uint64_t intervalUs);
+
+    /**
+     * @brief 移除续约的文件，返回时保证不会再调用executor
+     * @param executor 文件对应的续约执行者
+     */
+    void Remove(LeaseExecutor* executor);
+
+    /**
+     * @brief 获取当前续约的文件数量
+     */
+    size_t Size();
+
+ private:
+    struct Entry {
+        uint64_t intervalUs;
+        uint64_t nextRefreshUs;
+    };
+
+    void Run();
+
+    /**
+     * @brief 获取已经到期或者在半个续约周期内到期的文件，并更新下次续约时间
+     * @param nowUs 当前时间
+     * @param[out] executors 需要续约的文件
+     */
+    void CollectDueExecutors(uint64_t nowUs,
+                             std::vector<LeaseExecutor*>* executors);
+
+    /**
+     * @brief 续约一批文件，mds不支持批量续约时逐个文件续约
+     * @param executors 需要续约的文件
+     * @param[out] stopped 不再需要续约的文件
+     */
+    void RefreshBatch(const std::vector<LeaseExecutor*>& executors,
+                      std::vector<LeaseExecutor*>* stopped);
+
+ private:
+    MDSClient* mdsclient_;
+    uint32_t maxBatchSize_;
+
+    // mds是否支持批量续约，不支持时逐个文件续约，
+    // 并在nextBatchRetryUs_之后重新尝试批量续约
+    bool batchSupported_;
+    uint64_t batchRetryIntervalUs_;
+    uint64_t nextBatchRetryUs_;
+
+    // 保护entries_和running_
+    std::mutex mtx_;
+    std::condition_variable cond_;
+    std::unordered_map<LeaseExecutor*, Entry> entries_;
+    bool running_;
+
+    // 续约过程中持有，Remove通过该锁等待正在进行的续约结束
+    std::mutex refreshMtx_;
+
+    std::thread thread_;
+};
+
+/**
+ * 进程内所有文件的批量续约管理，按mds对文件分组，
+ * 每个分组使用批量续约rpc，mds的续约压力不随打开文件数线性增长
+ */
+class LeaseManager : public curve::common::Uncopyable {
+ public:
+    static LeaseManager& GetInstance() {
+        static LeaseManager leaseManager;
+        return leaseManager;
+    }
+
+    /**
+     * @brief 注册需要续约的文件
+     * @param mdsclient 与mds续约的client，相同mdsclient的文件在同一分组
+     * @param executor 文件对应的续约执行者
+     * @param intervalUs 续约间隔
+     * @param maxBatchSize 一次批量续约最多包含的文件数
+     */
+    void Register(MDSClient* mdsclient, LeaseExecutor* executor,
+                  uint64_t intervalUs, uint32_t maxBatchSize);
+
+    /**
+     * @brief 取消文件的续约，分组为空时停止分组的续约线程
+     * @param mdsclient 与mds续约的client
+     * @param executor 文件对应的续约执行者
+     */
+    void Unregister(MDSClient* mdsclient, LeaseExecutor* executor);
+
+    /**
+     * @brief 获取mdsclient对应分组中的文件数量，测试使用
+     */
+    size_t GetRegisteredNum(MDSClient* mdsclient);
+
+ private:
+    LeaseManager() = default;
+
+    // 只保护groups_，等待分组中正在进行的续约时不持有该锁，
+    // 避免一个分组的慢续约阻塞其他分组的注册和取消
+    std::mutex mtx_;
+    std::unordered_map<MDSClient*, std::shared_ptr<LeaseRefreshGroup>> groups_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_LEASE_MANAGER_H_
@@ -259,6 +259,17 @@ int SnapshotClient::CreateCloneChunk(const std::string &location,
                                              sn, correntSn, chunkSize, scc);
 }
 
+int SnapshotClient::CreateCloneChunks(const ChunkIDInfo &copysetidinfo,
+                                      const std::vector<CloneChunkDesc> &chunks,
+                                      uint64_t correntSn,
+                                      uint64_t chunkSize,
+                                      std::vector<ChunkID> *existChunkIds,
+                                      SnapCloneClosure* scc) {
+    return iomanager4chunk_.CreateCloneChunks(copysetidinfo, chunks,
+                                              correntSn, chunkSize,
+                                              existChunkIds, scc);
+}
+
 int SnapshotClient::RecoverChunk(const ChunkIDInfo &chunkidinfo,
                                         uint64_t offset,
                                         uint64_t len,
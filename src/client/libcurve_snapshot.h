@@ -187,6 +187,24 @@ class SnapshotClient {
                        uint64_t correntSn, uint64_t chunkSize,
                        SnapCloneClosure* scc);
 
+  /**
+   * @brief 批量创建同一copyset上的clone chunk，所有chunk在一条raft日志中创建
+   * @param:copysetidinfo 目标copyset，chunk id为第一个要创建的chunk
+   * @param:chunks 要创建的chunk
+   * @param:correntSn 用于修改chunk的correctedSn
+   * @param:chunkSize chunk的大小
+   * @param:existChunkIds 出参，已存在且信息与请求不符的chunk，
+   *                      scc执行前填充
+   * @param: scc是异步回调
+   *
+   * @return 错误码
+   */
+  int CreateCloneChunks(const ChunkIDInfo &copysetidinfo,
+                        const std::vector<CloneChunkDesc> &chunks,
+                        uint64_t correntSn, uint64_t chunkSize,
+                        std::vector<ChunkID> *existChunkIds,
+                        SnapCloneClosure* scc);
+
   /**
    * @brief 实际恢复chunk数据
    *
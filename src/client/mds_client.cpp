@@ -62,6 +62,7 @@ using curve::mds::ProtoSession;
 using curve::mds::OpenFileResponse;
 using curve::mds::CloseFileResponse;
 using curve::mds::ReFreshSessionResponse;
+using curve::mds::RefreshSessionBatchResponse;
 using curve::mds::CreateCloneFileResponse;
 using curve::mds::SetCloneFileStatusResponse;
 using curve::mds::topology::CopySetServerInfo;
@@ -578,6 +579,61 @@ LIBCURVE_ERROR MDSClient::GetSnapshotSegmentInfo(const std::string& filename,
     return rpcExcutor.DoRPCTask(task, metaServerOpt_.mdsMaxRetryMS);
 }
 
+static LIBCURVE_ERROR ParseRefreshSessionResponse(
+    const ReFreshSessionResponse& response, const std::string& filename,
+    const UserInfo_t& userinfo, const std::string& sessionid,
+    LeaseRefreshResult* resp, LeaseSession* lease) {
+    StatusCode stcode = response.statuscode();
+    LOG_IF(WARNING, stcode != StatusCode::kOK)
+        << "RefreshSession NOT OK: filename = "
+        << filename.c_str() << ", owner = "
+        << userinfo.owner << ", sessionid = "
+        << sessionid << ", status code = "
+        << StatusCode_Name(stcode);
+
+    LOG_EVERY_N(INFO, 10) << "RefreshSession returned: filename = "
+        << filename.c_str() << ", owner = "
+        << userinfo.owner << ", sessionid = "
+        << sessionid << ", status code = "
+        << StatusCode_Name(stcode);
+
+    switch (stcode) {
+        case StatusCode::kSessionNotExist:
+        case StatusCode::kFileNotExists:
+            resp->status = LeaseRefreshResult::Status::NOT_EXIST;
+            break;
+        case StatusCode::kOwnerAuthFail:
+            resp->status = LeaseRefreshResult::Status::FAILED;
+            return LIBCURVE_ERROR::AUTHFAIL;
+            break;
+        case StatusCode::kOK:
+            if (response.has_fileinfo()) {
+                FileInfo finfo = response.fileinfo();
+                ServiceHelper::ProtoFileInfo2Local(&finfo, &resp->finfo);
+                resp->status = LeaseRefreshResult::Status::OK;
+            } else {
+                LOG(WARNING) << "session response has no fileinfo!";
+                return LIBCURVE_ERROR::FAILED;
+            }
+            if (nullptr != lease) {
+                if (!response.has_protosession()) {
+                    LOG(ERROR) << "session response has no protosession";
+                    return LIBCURVE_ERROR::FAILED;
+                }
+                ProtoSession leasesession = response.protosession();
+                lease->sessionID = leasesession.sessionid();
+                lease->leaseTime = leasesession.leasetime();
+                lease->createTime = leasesession.createtime();
+            }
+            break;
+        default:
+            resp->status = LeaseRefreshResult::Status::FAILED;
+            return LIBCURVE_ERROR::FAILED;
+            break;
+    }
+    return LIBCURVE_ERROR::OK;
+}
+
 LIBCURVE_ERROR MDSClient::RefreshSession(const std::string& filename,
     const UserInfo_t& userinfo, const std::string& sessionid,
     LeaseRefreshResult* resp, LeaseSession* lease) {
@@ -596,53 +652,53 @@ LIBCURVE_ERROR MDSClient::RefreshSession(const std::string& filename,
             return -cntl->ErrorCode();
         }
 
+        return ParseRefreshSessionResponse(response, filename, userinfo,
+                                           sessionid, resp, lease);
+    };
+    return rpcExcutor.DoRPCTask(task, metaServerOpt_.mdsMaxRetryMS);
+}
+
+LIBCURVE_ERROR MDSClient::RefreshSessionBatch(
+    const std::vector<RefreshSessionContext>& sessions,
+    std::vector<LIBCURVE_ERROR>* rets,
+    std::vector<LeaseRefreshResult>* resps) {
+    auto task = RPCTaskDefine {
+        RefreshSessionBatchResponse response;
+        mdsClientMetric_.refreshSessionBatch.qps.count << 1;
+        LatencyGuard lg(&mdsClientMetric_.refreshSessionBatch.latency);
+        mdsClientBase_.RefreshSessionBatch(sessions, &response, cntl, channel);
+        if (cntl->Failed()) {
+            mdsClientMetric_.refreshSessionBatch.eps.count << 1;
+            // 老版本的mds不支持批量续约，由调用方退化为逐个文件续约
+            if (cntl->ErrorCode() == brpc::ENOMETHOD) {
+                LOG(WARNING) << "RefreshSessionBatch not supported by mds, "
+                             << cntl->ErrorText();
+                return LIBCURVE_ERROR::NOT_SUPPORT;
+            }
+            LOG(WARNING) << "Fail to send RefreshSessionBatchRequest, "
+                << cntl->ErrorText()
+                << ", file num = " << sessions.size();
+            return -cntl->ErrorCode();
+        }
+
         StatusCode stcode = response.statuscode();
-        LOG_IF(WARNING, stcode != StatusCode::kOK)
-            << "RefreshSession NOT OK: filename = "
-            << filename.c_str() << ", owner = "
-            << userinfo.owner << ", sessionid = "
-            << sessionid << ", status code = "
-            << StatusCode_Name(stcode);
-
-        LOG_EVERY_N(INFO, 10) << "RefreshSession returned: filename = "
-            << filename.c_str() << ", owner = "
-            << userinfo.owner << ", sessionid = "
-            << sessionid << ", status code = "
-            << StatusCode_Name(stcode);
-
-        switch (stcode) {
-            case StatusCode::kSessionNotExist:
-            case StatusCode::kFileNotExists:
-                resp->status = LeaseRefreshResult::Status::NOT_EXIST;
-                break;
-            case StatusCode::kOwnerAuthFail:
-                resp->status = LeaseRefreshResult::Status::FAILED;
-                return LIBCURVE_ERROR::AUTHFAIL;
-                break;
-            case StatusCode::kOK:
-                if (response.has_fileinfo()) {
-                    FileInfo finfo = response.fileinfo();
-                    ServiceHelper::ProtoFileInfo2Local(&finfo, &resp->finfo);
-                    resp->status = LeaseRefreshResult::Status::OK;
-                } else {
-                    LOG(WARNING) << "session response has no fileinfo!";
-                    return LIBCURVE_ERROR::FAILED;
-                }
-                if (nullptr != lease) {
-                    if (!response.has_protosession()) {
-                        LOG(ERROR) << "session response has no protosession";
-                        return LIBCURVE_ERROR::FAILED;
-                    }
-                    ProtoSession leasesession = response.protosession();
-                    lease->sessionID = leasesession.sessionid();
-                    lease->leaseTime = leasesession.leasetime();
-                    lease->createTime = leasesession.createtime();
-                }
-                break;
-            default:
-                resp->status = LeaseRefreshResult::Status::FAILED;
-                return LIBCURVE_ERROR::FAILED;
-                break;
+        if (stcode != StatusCode::kOK ||
+            response.responses_size() != static_cast<int>(sessions.size())) {
+            LOG(WARNING) << "RefreshSessionBatch NOT OK: file num = "
+                << sessions.size() << ", response num = "
+                << response.responses_size() << ", status code = "
+                << StatusCode_Name(stcode);
+            return LIBCURVE_ERROR::FAILED;
+        }
+
+        rets->clear();
+        resps->clear();
+        resps->resize(sessions.size());
+        for (size_t i = 0; i < sessions.size(); ++i) {
+            rets->push_back(ParseRefreshSessionResponse(
+                response.responses(i), sessions[i].filename,
+                sessions[i].userinfo, sessions[i].sessionid,
+                &(*resps)[i], nullptr));
         }
         return LIBCURVE_ERROR::OK;
     };
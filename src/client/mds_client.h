@@ -58,7 +58,7 @@ struct LeaseRefreshResult;
 class MDSClient {
  public:
     MDSClient();
-    ~MDSClient() = default;
+    virtual ~MDSClient() = default;
     using RPCFunc = std::function<int(int, uint64_t,
                     brpc::Channel*, brpc::Controller*)>;
     /**
@@ -231,11 +231,25 @@ class MDSClient {
      * @return: 成功返回LIBCURVE_ERROR::OK,如果认证失败返回LIBCURVE_ERROR::AUTHFAIL，
      *          否则返回LIBCURVE_ERROR::FAILED
      */
-    LIBCURVE_ERROR RefreshSession(const std::string& filename,
+    virtual LIBCURVE_ERROR RefreshSession(const std::string& filename,
                             const UserInfo_t& userinfo,
                             const std::string& sessionid,
                             LeaseRefreshResult* resp,
                             LeaseSession* lease = nullptr);
+
+    /**
+     * 批量续约多个文件，用于一个进程打开大量文件的场景，减少mds的rpc压力
+     * @param: sessions是需要续约的文件信息
+     * @param[out]: rets是每个文件的续约返回值，含义与RefreshSession一致
+     * @param[out]: resps是每个文件的续约结果
+     * @return: rpc成功返回LIBCURVE_ERROR::OK，此时各文件的结果见rets和resps；
+     *          mds不支持批量续约返回LIBCURVE_ERROR::NOT_SUPPORT，
+     *          否则返回LIBCURVE_ERROR::FAILED
+     */
+    virtual LIBCURVE_ERROR RefreshSessionBatch(
+        const std::vector<RefreshSessionContext>& sessions,
+        std::vector<LIBCURVE_ERROR>* rets,
+        std::vector<LeaseRefreshResult>* resps);
     /**
      * 关闭文件，需要携带sessionid，这样mds端会在数据库删除该session信息
      * @param: filename是要续约的文件名
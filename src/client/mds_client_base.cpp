@@ -235,6 +235,36 @@ void MDSClientBase::RefreshSession(const std::string& filename,
     stub.RefreshSession(cntl, &request, response, nullptr);
 }
 
+void MDSClientBase::RefreshSessionBatch(
+    const std::vector<RefreshSessionContext>& sessions,
+    RefreshSessionBatchResponse* response,
+    brpc::Controller* cntl,
+    brpc::Channel* channel) {
+    RefreshSessionBatchRequest request;
+
+    static ClientDummyServerInfo& clientInfo =
+        ClientDummyServerInfo::GetInstance();
+
+    for (const auto& session : sessions) {
+        ReFreshSessionRequest* req = request.add_requests();
+        req->set_filename(session.filename);
+        req->set_sessionid(session.sessionid);
+        req->set_clientversion(curve::common::CurveVersion());
+        if (clientInfo.GetRegister()) {
+            req->set_clientip(clientInfo.GetIP());
+            req->set_clientport(clientInfo.GetPort());
+        }
+        FillUserInfo<ReFreshSessionRequest>(req, session.userinfo);
+    }
+
+    LOG_EVERY_N(INFO, 10) << "RefreshSessionBatch: file num = "
+                          << sessions.size()
+                          << ", log id = " << cntl->log_id();
+
+    curve::mds::CurveFSService_Stub stub(channel);
+    stub.RefreshSessionBatch(cntl, &request, response, nullptr);
+}
+
 void MDSClientBase::CheckSnapShotStatus(const std::string& filename,
                                 const UserInfo_t& userinfo,
                                 uint64_t seq,
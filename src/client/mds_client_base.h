@@ -59,6 +59,8 @@ using curve::mds::DeleteSnapShotRequest;
 using curve::mds::DeleteSnapShotResponse;
 using curve::mds::ReFreshSessionRequest;
 using curve::mds::ReFreshSessionResponse;
+using curve::mds::RefreshSessionBatchRequest;
+using curve::mds::RefreshSessionBatchResponse;
 using curve::mds::ListDirRequest;
 using curve::mds::ListDirResponse;
 using curve::mds::ChangeOwnerRequest;
@@ -90,6 +92,14 @@ extern const char* kRootUserName;
 
 namespace curve {
 namespace client {
+
+// 批量续约时每个文件的续约信息
+struct RefreshSessionContext {
+    std::string filename;
+    UserInfo_t userinfo;
+    std::string sessionid;
+};
+
 // MDSClientBase将所有与mds的RPC接口抽离，与业务逻辑解耦
 // 这里只负责rpc的发送，具体的业务处理逻辑通过reponse和controller向上
 // 返回给调用者，有调用者处理
@@ -236,6 +246,18 @@ class MDSClientBase {
                         ReFreshSessionResponse* response,
                         brpc::Controller* cntl,
                         brpc::Channel* channel);
+
+    /**
+     * 批量续约同一个mds上的多个文件
+     * @param: sessions为需要续约的文件信息
+     * @param[out]: response为该rpc的response，提供给外部处理
+     * @param[in|out]: cntl既是入参，也是出参，返回RPC状态
+     * @param[in]:channel是当前与mds建立的通道
+     */
+    void RefreshSessionBatch(const std::vector<RefreshSessionContext>& sessions,
+                             RefreshSessionBatchResponse* response,
+                             brpc::Controller* cntl,
+                             brpc::Channel* channel);
     /**
      * 获取快照状态
      * @param: filenam文件名
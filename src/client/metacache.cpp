@@ -30,13 +30,16 @@
 #include "proto/cli.pb.h"
 
 #include "src/client/metacache.h"
+#include "src/client/chunk_closure.h"
 #include "src/client/mds_client.h"
 #include "src/client/client_common.h"
 #include "src/common/concurrent/concurrent.h"
+#include "src/common/timeutility.h"
 
 using curve::common::WriteLockGuard;
 using curve::common::ReadLockGuard;
 using curve::client::ClientConfig;
+using curve::common::TimeUtility;
 
 namespace curve {
 namespace client {
@@ -134,6 +137,40 @@ int MetaCache::GetLeader(LogicPoolID logicPoolId,
     return targetInfo.GetLeaderInfo(serverId, serverAddr);
 }
 
+int MetaCache::GetFollowerReadPeer(LogicPoolID logicPoolId,
+                                   CopysetID copysetId,
+                                   const butil::ip_t& localIp,
+                                   ChunkServerID* serverId,
+                                   EndPoint* serverAddr,
+                                   bool* isLeader,
+                                   ChunkServerID excludeId) {
+    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
+
+    ReadLockGuard rdlk(rwlock4CopysetInfo_);
+    auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
+    if (iter == lpcsid2CopsetInfoMap_.end()) {
+        return -1;
+    }
+
+    return iter->second.GetReadPeerInfo(localIp, TimeUtility::GetTimeofDayMs(),
+                                        serverId, serverAddr, isLeader,
+                                        excludeId);
+}
+
+void MetaCache::SetFollowerLagging(LogicPoolID logicPoolId,
+                                   CopysetID copysetId,
+                                   ChunkServerID csid,
+                                   uint64_t untilMs) {
+    std::string mapkey = LogicPoolCopysetID2Str(logicPoolId, copysetId);
+
+    ReadLockGuard rdlk(rwlock4CopysetInfo_);
+    auto iter = lpcsid2CopsetInfoMap_.find(mapkey);
+    if (iter == lpcsid2CopsetInfoMap_.end()) {
+        return;
+    }
+    iter->second.SetPeerLagging(csid, untilMs);
+}
+
 int MetaCache::UpdateLeaderInternal(LogicPoolID logicPoolId,
                                     CopysetID copysetId,
                                     CopysetInfo* toupdateCopyset,
@@ -379,13 +416,19 @@ void MetaCache::UpdateChunkserverCopysetInfo(LogicPoolID lpid,
 
         // 删除变更的copyset信息
         for (auto chunkserverid : changedID) {
+            bool removed = false;
             {
                 WriteLockGuard wrlk(rwlock4CSCopysetIDMap_);
                 auto iter = chunkserverCopysetIDMap_.find(chunkserverid);
                 if (iter != chunkserverCopysetIDMap_.end()) {
                     iter->second.erase(CopysetIDInfo(lpid, cpinfo.cpid_));
+                    removed = iter->second.empty();
                 }
             }
+            // chunkserver上已经没有缓存的copyset，不再需要它的时延统计
+            if (removed) {
+                UnstableHelper::GetInstance().RemoveReadLatency(chunkserverid);
+            }
         }
 
         // 更新新的copyset信息到chunkserver
@@ -111,6 +111,38 @@ class MetaCache {
                                 butil::EndPoint* serverAddr,
                                 bool refresh = false,
                                 FileMetric* fm = nullptr);
+    /**
+     * follower read时获取读请求的目标节点，优先选择与client同机的副本，
+     * 否则在未落后的副本间轮询，没有可用副本时返回leader。
+     * leader信息未确定时返回-1，由外部通过GetLeader刷新leader
+     * @param: lpid逻辑池id
+     * @param: cpid是copysetid
+     * @param: localIp为client所在节点的ip
+     * @param: serverId是出参
+     * @param: serverAddr是出参
+     * @param: isLeader是出参，选中的节点是否为leader
+     * @param: excludeId为不参与选择的chunkserver，hedged read时用于排除
+     *         原始请求发往的节点，为0时不排除
+     * @param: 成功返回0， 否则返回-1
+     */
+    virtual int GetFollowerReadPeer(LogicPoolID logicPoolId,
+                                    CopysetID copysetId,
+                                    const butil::ip_t& localIp,
+                                    ChunkServerID* serverId,
+                                    butil::EndPoint* serverAddr,
+                                    bool* isLeader,
+                                    ChunkServerID excludeId = 0);
+    /**
+     * follower因数据落后拒绝读请求时，标记该follower在一段时间内不可读
+     * @param: lpid逻辑池id
+     * @param: cpid是copysetid
+     * @param: csid为落后的chunkserver id
+     * @param: untilMs为标记过期时间
+     */
+    virtual void SetFollowerLagging(LogicPoolID logicPoolId,
+                                    CopysetID copysetId,
+                                    ChunkServerID csid,
+                                    uint64_t untilMs);
     /**
      * 更新某个copyset的leader信息
      * @param logicPoolId 逻辑池id
@@ -94,6 +94,10 @@ typedef struct CURVE_CACHELINE_ALIGNMENT CopysetInfo {
     int16_t     leaderindex_;
     // 当前copyset的id信息
     CopysetID   cpid_;
+    // 数据落后的follower及其不再接收follower read的截止时间(ms)
+    std::unordered_map<ChunkServerID, uint64_t> laggingPeers_;
+    // follower read在各副本间轮询时的游标
+    uint32_t    readCursor_;
     // 用于保护对copyset信息的修改
     SpinLock    spinlock_;
 
@@ -102,6 +106,7 @@ typedef struct CURVE_CACHELINE_ALIGNMENT CopysetInfo {
         leaderindex_ = -1;
         lastappliedindex_ = 0;
         leaderMayChange_ = false;
+        readCursor_ = 0;
     }
 
     ~CopysetInfo() {
@@ -115,6 +120,8 @@ typedef struct CURVE_CACHELINE_ALIGNMENT CopysetInfo {
         this->leaderindex_ = other.leaderindex_;
         this->lastappliedindex_.store(other.lastappliedindex_);
         this->leaderMayChange_ = other.leaderMayChange_;
+        this->laggingPeers_ = other.laggingPeers_;
+        this->readCursor_ = other.readCursor_;
         return *this;
     }
 
@@ -123,7 +130,9 @@ typedef struct CURVE_CACHELINE_ALIGNMENT CopysetInfo {
           csinfos_(other.csinfos_),
           lastappliedindex_(other.lastappliedindex_.load()),
           leaderindex_(other.leaderindex_),
-          cpid_(other.cpid_) {}
+          cpid_(other.cpid_),
+          laggingPeers_(other.laggingPeers_),
+          readCursor_(other.readCursor_) {}
 
     uint64_t GetAppliedIndex() const {
         return lastappliedindex_.load(std::memory_order_acquire);
@@ -228,6 +237,75 @@ typedef struct CURVE_CACHELINE_ALIGNMENT CopysetInfo {
         return 0;
     }
 
+    /**
+     * 获取follower read的目标节点，优先选择与client同机的副本，
+     * 否则在未落后的副本间轮询，没有可用副本时返回leader
+     * @param: localIp为client所在节点的ip
+     * @param: nowMs为当前时间，用于判断落后标记是否过期
+     * @param: chunkserverid是出参
+     * @param: ep是出参
+     * @param: isLeader是出参，选中的节点是否为leader
+     * @param: excludeId为不参与选择的chunkserver，为0时不排除
+     * @return: leader信息未确定、leader可能变更或者没有可选节点时返回-1
+     */
+    int GetReadPeerInfo(const butil::ip_t& localIp, uint64_t nowMs,
+                        ChunkServerID* chunkserverid, EndPoint* ep,
+                        bool* isLeader, ChunkServerID excludeId = 0) {
+        spinlock_.Lock();
+        if (leaderMayChange_ || leaderindex_ < 0 ||
+            leaderindex_ >= csinfos_.size()) {
+            spinlock_.UnLock();
+            return -1;
+        }
+
+        std::vector<int> candidates;
+        for (int i = 0; i < csinfos_.size(); ++i) {
+            if (csinfos_[i].chunkserverID == excludeId) {
+                continue;
+            }
+
+            auto iter = laggingPeers_.find(csinfos_[i].chunkserverID);
+            if (iter != laggingPeers_.end()) {
+                if (iter->second > nowMs) {
+                    continue;
+                }
+                laggingPeers_.erase(iter);
+            }
+
+            if (csinfos_[i].externalAddr.addr_.ip == localIp) {
+                candidates.clear();
+                candidates.push_back(i);
+                break;
+            }
+            candidates.push_back(i);
+        }
+
+        int index = leaderindex_;
+        if (!candidates.empty()) {
+            index = candidates[readCursor_++ % candidates.size()];
+        } else if (csinfos_[leaderindex_].chunkserverID == excludeId) {
+            spinlock_.UnLock();
+            return -1;
+        }
+
+        *chunkserverid = csinfos_[index].chunkserverID;
+        *ep = csinfos_[index].externalAddr.addr_;
+        *isLeader = (index == leaderindex_);
+        spinlock_.UnLock();
+        return 0;
+    }
+
+    /**
+     * 标记follower数据落后，在untilMs之前不再向其发送follower read
+     * @param: csid为落后的chunkserver id
+     * @param: untilMs为标记过期时间
+     */
+    void SetPeerLagging(ChunkServerID csid, uint64_t untilMs) {
+        spinlock_.Lock();
+        laggingPeers_[csid] = untilMs;
+        spinlock_.UnLock();
+    }
+
     /**
      * 添加copyset的peerinfo
      * @param: csinfo为待添加的peer信息
@@ -35,6 +35,7 @@ RequestContext::RequestContext() {
     readBuffer_ = nullptr;
     writeBuffer_ = nullptr;
     chunkinfodetail_ = nullptr;
+    existChunkIds_ = nullptr;
 
     id_         = reqCtxID_.fetch_add(1);
 
@@ -43,6 +44,9 @@ RequestContext::RequestContext() {
     rawlength_  = 0;
 
     appliedindex_ = 0;
+
+    readFromFollower_ = false;
+    followerReadFallback_ = false;
 }
 bool RequestContext::Init() {
     done_ = new (std::nothrow) RequestClosure(this);
@@ -25,6 +25,7 @@
 
 #include <atomic>
 #include <string>
+#include <vector>
 
 #include "src/client/client_common.h"
 #include "src/client/request_closure.h"
@@ -80,6 +81,11 @@ class RequestContext {
     // appliedindex_表示当前IO是否走chunkserver端的raft协议，为0的时候走raft
     uint64_t            appliedindex_;
 
+    // 当前读请求是否发往了follower
+    bool                readFromFollower_;
+    // follower read失败之后，后续重试直接发往leader
+    bool                followerReadFallback_;
+
     // 这个对应的GetChunkInfo的出参
     ChunkInfoDetail*    chunkinfodetail_;
 
@@ -90,6 +96,11 @@ class RequestContext {
     // create clone chunk时候用于修改chunk的correctedSn
     uint64_t            correctedSeq_;
 
+    // 批量创建clone chunk时要创建的chunk，这些chunk属于idinfo_所在的copyset
+    std::vector<CloneChunkDesc> cloneChunks_;
+    // 批量创建clone chunk的出参，已存在且信息与请求不符的chunk
+    std::vector<ChunkID>* existChunkIds_;
+
     // 当前request context id
     uint64_t            id_;
 
@@ -194,6 +194,13 @@ void RequestScheduler::Process() {
                                         req->chunksize_,
                                         guard.release());
                     break;
+                case OpType::CREATE_CLONE_BATCH:
+                    client_.CreateCloneChunks(req->idinfo_,
+                                        req->cloneChunks_,
+                                        req->correctedSeq_,
+                                        req->chunksize_,
+                                        guard.release());
+                    break;
                 case OpType::RECOVER_CHUNK:
                     client_.RecoverChunk(req->idinfo_,
                                          req->offset_, req->rawlength_,
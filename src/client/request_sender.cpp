@@ -94,6 +94,36 @@ int RequestSender::ReadChunk(ChunkIDInfo idinfo,
     return 0;
 }
 
+int RequestSender::HedgedReadChunk(ChunkIDInfo idinfo,
+                                   off_t offset,
+                                   size_t length,
+                                   uint64_t appliedindex,
+                                   ClientClosure *done) {
+    brpc::ClosureGuard doneGuard(done);
+
+    brpc::Controller *cntl = new brpc::Controller();
+    cntl->set_timeout_ms(iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS);
+    done->SetCntl(cntl);
+    ChunkResponse *response = new ChunkResponse();
+    done->SetResponse(response);
+    done->SetChunkServerID(chunkServerId_);
+    done->SetChunkServerEndPoint(serverEndPoint_);
+
+    ChunkRequest request;
+    request.set_optype(curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_READ);
+    request.set_logicpoolid(idinfo.lpid_);
+    request.set_copysetid(idinfo.cpid_);
+    request.set_chunkid(idinfo.cid_);
+    request.set_offset(offset);
+    request.set_size(length);
+    request.set_appliedindex(appliedindex);
+
+    ChunkService_Stub stub(&channel_);
+    stub.ReadChunk(cntl, &request, response, doneGuard.release());
+
+    return 0;
+}
+
 int RequestSender::WriteChunk(ChunkIDInfo idinfo,
                               uint64_t sn,
                               const char *buf,
@@ -253,6 +283,42 @@ int RequestSender::CreateCloneChunk(ChunkIDInfo idinfo,
     stub.CreateCloneChunk(cntl, &request, response, doneGuard.release());
 }
 
+int RequestSender::CreateCloneChunks(ChunkIDInfo idinfo,
+                                ClientClosure *done,
+                                const std::vector<CloneChunkDesc> &chunks,
+                                uint64_t correntSn,
+                                uint64_t chunkSize) {
+    brpc::ClosureGuard doneGuard(done);
+
+    RequestClosure* rc = static_cast<RequestClosure*>(done->GetClosure());
+    brpc::Controller *cntl = new brpc::Controller();
+    cntl->set_timeout_ms(
+    std::max(rc->GetNextTimeoutMS(),
+        iosenderopt_.failRequestOpt.chunkserverRPCTimeoutMS));
+    done->SetCntl(cntl);
+    ChunkResponse *response = new ChunkResponse();
+    done->SetResponse(response);
+
+    ChunkRequest request;
+    request.set_optype(
+        curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH);
+    request.set_logicpoolid(idinfo.lpid_);
+    request.set_copysetid(idinfo.cpid_);
+    request.set_chunkid(idinfo.cid_);
+    request.set_correctedsn(correntSn);
+    request.set_size(chunkSize);
+    for (const auto &chunk : chunks) {
+        auto meta = request.add_clonechunks();
+        meta->set_chunkid(chunk.cid);
+        meta->set_sn(chunk.seq);
+        meta->set_location(chunk.location);
+    }
+
+    ChunkService_Stub stub(&channel_);
+    stub.CreateCloneChunks(cntl, &request, response, doneGuard.release());
+    return 0;
+}
+
 int RequestSender::RecoverChunk(const ChunkIDInfo& idinfo,
                                 ClientClosure *done,
                                 uint64_t offset,
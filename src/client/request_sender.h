@@ -27,6 +27,7 @@
 #include <butil/endpoint.h>
 
 #include <string>
+#include <vector>
 
 #include "src/client/client_config.h"
 #include "src/client/client_common.h"
@@ -59,6 +60,10 @@ class RequestSender {
 
     int Init(const IOSenderOption_t& ioSenderOpt);
 
+    ChunkServerID GetChunkServerId() const {
+        return chunkServerId_;
+    }
+
     /**
      * 读Chunk
      * @param idinfo为chunk相关的id信息
@@ -77,6 +82,21 @@ class RequestSender {
                   const RequestSourceInfo& sourceInfo,
                   ClientClosure *done);
 
+    /**
+     * 发送hedge读请求，与ReadChunk不同，不会访问上层的RequestClosure，
+     * 因为此时原始请求可能已经返回
+     * @param idinfo为chunk相关的id信息
+     * @param offset:读的偏移
+     * @param length:读的长度
+     * @param appliedindex:需要读到>=appliedIndex的数据
+     * @param done:hedge请求的closure
+     */
+    int HedgedReadChunk(ChunkIDInfo idinfo,
+                        off_t offset,
+                        size_t length,
+                        uint64_t appliedindex,
+                        ClientClosure *done);
+
     /**
    * 写Chunk
    * @param idinfo为chunk相关的id信息
@@ -153,6 +173,22 @@ class RequestSender {
                   uint64_t correntSn,
                   uint64_t chunkSize);
 
+   /**
+    * 批量创建同一copyset上的clone chunk，所有chunk在一条raft日志中创建
+    * @param idinfo为copyset相关的id信息，chunk id为第一个要创建的chunk
+    * @param done:上一层异步回调的closure
+    * @param:chunks 要创建的chunk
+    * @param:correntSn 用于修改chunk的correctedSn
+    * @param:chunkSize chunk的大小
+    *
+    * @return 错误码
+    */
+    int CreateCloneChunks(ChunkIDInfo idinfo,
+                  ClientClosure *done,
+                  const std::vector<CloneChunkDesc> &chunks,
+                  uint64_t correntSn,
+                  uint64_t chunkSize);
+
    /**
     * @brief 实际恢复chunk数据
     * @param idinfo为chunk相关的id信息
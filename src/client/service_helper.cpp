@@ -79,6 +79,30 @@ void ServiceHelper::ProtoFileInfo2Local(const curve::mds::FileInfo* finfo,
     if (finfo->has_clonelength()) {
         fi->cloneLength = finfo->clonelength();
     }
+    if (finfo->has_throttleparams()) {
+        for (const auto& param : finfo->throttleparams().throttleparams()) {
+            curve::common::ThrottleType type;
+            switch (param.type()) {
+                case curve::mds::ThrottleType::IOPS_READ:
+                    type = curve::common::ThrottleType::IOPS_READ;
+                    break;
+                case curve::mds::ThrottleType::IOPS_WRITE:
+                    type = curve::common::ThrottleType::IOPS_WRITE;
+                    break;
+                case curve::mds::ThrottleType::BPS_READ:
+                    type = curve::common::ThrottleType::BPS_READ;
+                    break;
+                case curve::mds::ThrottleType::BPS_WRITE:
+                    type = curve::common::ThrottleType::BPS_WRITE;
+                    break;
+                default:
+                    LOG(WARNING) << "unknown throttle type " << param.type();
+                    continue;
+            }
+            fi->throttleParams[type] = curve::common::ThrottleParams(
+                param.limit(), param.has_burst() ? param.burst() : 0);
+        }
+    }
 }
 
 class GetLeaderProxy : public std::enable_shared_from_this<GetLeaderProxy> {
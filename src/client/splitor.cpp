@@ -166,7 +166,10 @@ bool Splitor::AssignInternal(IOTracker* iotracker,
                             MDSClient* mdsclient,
                             const FInfo_t* fileinfo,
                             ChunkIndex chunkidx) {
-    auto max_split_size_bytes = 1024 * iosplitopt_.fileIOSplitMaxSizeKB;
+    // 大IO模式下chunk内的IO不再拆分，整段数据作为一个rpc下发
+    uint64_t max_split_size_bytes = iosplitopt_.enableLargeIOFastPath
+                                  ? fileinfo->chunksize
+                                  : 1024 * iosplitopt_.fileIOSplitMaxSizeKB;
 
     ChunkIDInfo_t chinfo;
     SegmentInfo segInfo;
@@ -33,6 +33,8 @@ const char CURVE_TYPE[] = "cs";
 const char S3_TYPE[] = "s3";
 const char kOriginTypeSeprator[] = "@";
 const char kOriginPathSeprator[] = ":";
+// 按内容哈希命名的s3对象名前缀，同名对象的内容始终相同
+const char kContentAddressedObjectPrefix[] = "cas-";
 
 enum class OriginType {
     S3Origin = 0,
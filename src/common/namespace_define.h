@@ -39,17 +39,24 @@ const char CHUNKSTOREKEYEND[] = "06";
 const char LEADERCAMPAIGNNPFX[] = "07leader";
 const char SEGMENTALLOCSIZEKEY[] = "08";
 const char SEGMENTALLOCSIZEKEYEND[] = "09";
+const char SEGMENTALLOCCHECKPOINTKEY[] = "09alloccheckpoint";
 const char TOPOLOGYITEMPRIFIX[] = "10";
+const char TOPOLOGYITEMEND[] = "11";
 
 const char SNAPINFOKEYPREFIX[] = "11";
 const char SNAPINFOKEYEND[] = "12";
 const char CLONEINFOKEYPREFIX[] = "12";
 const char CLONEINFOKEYEND[] = "13";
+const char CHUNKDATAREFKEYPREFIX[] = "13";
+const char CHUNKDATAREFKEYEND[] = "14";
+const char FILEALLOCKEYPREFIX[] = "14";
+const char FILEALLOCKEYEND[] = "15";
 
 // TODO(hzsunjianliang): if use single prefix for snapshot file?
 const int COMMON_PREFIX_LENGTH = 2;
 const int LEADER_PREFIX_LENGTH = 8;
 const int SEGMENTKEYLEN = 18;
+const int FILEALLOCKEYLEN = 10;
 
 }  // namespace common
 }  // namespace curve
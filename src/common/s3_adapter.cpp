@@ -387,6 +387,74 @@ Aws::S3::Model::CompletedPart S3Adapter:: UploadOnePart(
     }
 }
 
+void S3Adapter::UploadPartAsync(
+    std::shared_ptr<UploadPartAsyncContext> context) {
+    Aws::S3::Model::UploadPartRequest request;
+    request.SetBucket(bucketName_);
+    request.SetKey(Aws::String(context->key.c_str(), context->key.size()));
+    request.SetUploadId(
+        Aws::String(context->uploadId.c_str(), context->uploadId.size()));
+    request.SetPartNumber(context->partNum);
+    request.SetContentLength(context->len);
+    auto input_data =
+            Aws::MakeShared<Aws::StringStream>("UploadPartAsyncStream");
+    input_data->write(context->buf, context->len);
+    request.SetBody(input_data);
+
+    Aws::S3::UploadPartResponseReceivedHandler handler = [this] (
+        const Aws::S3::S3Client* client,
+        const Aws::S3::Model::UploadPartRequest& request,
+        const Aws::S3::Model::UploadPartOutcome& response,
+        const std::shared_ptr<const Aws::Client::AsyncCallerContext>& awsCtx) {
+        std::shared_ptr<const UploadPartAsyncContext> cctx =
+            std::dynamic_pointer_cast<const UploadPartAsyncContext>(awsCtx);
+        std::shared_ptr<UploadPartAsyncContext> ctx =
+            std::const_pointer_cast<UploadPartAsyncContext>(cctx);
+        if (response.IsSuccess()) {
+            const Aws::String &etag = response.GetResult().GetETag();
+            ctx->etag = std::string(etag.c_str(), etag.size());
+            ctx->retCode = 0;
+        } else {
+            LOG(ERROR) << "UploadPartAsync error: "
+                    << response.GetError().GetExceptionName()
+                    << response.GetError().GetMessage();
+            ctx->retCode = -1;
+        }
+        ctx->cb(this, ctx);
+    };
+    s3Client_->UploadPartAsync(request, handler, context);
+}
+
+Aws::S3::Model::CompletedPart S3Adapter::UploadPartCopy(
+    const Aws::String &key,
+    const Aws::String &uploadId,
+    int partNum,
+    const Aws::String &srcKey,
+    uint64_t offset,
+    int partSize) {
+    Aws::S3::Model::UploadPartCopyRequest request;
+    request.SetBucket(bucketName_);
+    request.SetKey(key);
+    request.SetUploadId(uploadId);
+    request.SetPartNumber(partNum);
+    request.SetCopySource(bucketName_ + "/" +
+        Aws::Utils::StringUtils::URLEncode(srcKey.c_str()));
+    std::string range = "bytes=" + std::to_string(offset) + "-" +
+        std::to_string(offset + partSize - 1);
+    request.SetCopySourceRange(Aws::String(range.c_str(), range.size()));
+    auto result = s3Client_->UploadPartCopy(request);
+    if (result.IsSuccess()) {
+        return Aws::S3::Model::CompletedPart()
+            .WithETag(result.GetResult().GetCopyPartResult().GetETag())
+            .WithPartNumber(partNum);
+    } else {
+        LOG(ERROR) << "UploadPartCopy error: "
+                   << result.GetError().GetMessage();
+        return Aws::S3::Model::CompletedPart()
+                .WithETag("errorTag").WithPartNumber(-1);
+    }
+}
+
 int S3Adapter::CompleteMultiUpload(const Aws::String &key,
                 const Aws::String &uploadId,
             const Aws::Vector<Aws::S3::Model::CompletedPart> &cp_v) {
@@ -39,6 +39,7 @@
 #include <aws/s3/model/DeleteObjectRequest.h>  //NOLINT
 #include <aws/s3/model/CreateMultipartUploadRequest.h>  //NOLINT
 #include <aws/s3/model/UploadPartRequest.h>  //NOLINT
+#include <aws/s3/model/UploadPartCopyRequest.h>  //NOLINT
 #include <aws/s3/model/CompleteMultipartUploadRequest.h>  //NOLINT
 #include <aws/s3/model/AbortMultipartUploadRequest.h>   //NOLINT
 #include <aws/core/http/HttpRequest.h>  //NOLINT
@@ -46,6 +47,7 @@
 #include <aws/core/http/Scheme.h>  //NOLINT
 #include <aws/core/utils/memory/stl/AWSString.h>  //NOLINT
 #include <aws/core/utils/memory/stl/AWSStringStream.h>  //NOLINT
+#include <aws/core/utils/StringUtils.h>  //NOLINT
 #include <aws/s3/model/BucketLocationConstraint.h>  //NOLINT
 #include <aws/s3/model/CreateBucketConfiguration.h>  //NOLINT
 #include <aws/core/utils/threading/Executor.h> // NOLINT
@@ -70,6 +72,26 @@ struct GetObjectAsyncContext : public Aws::Client::AsyncCallerContext {
     int retCode;
 };
 
+struct UploadPartAsyncContext;
+
+typedef std::function<void(const S3Adapter*,
+    const std::shared_ptr<UploadPartAsyncContext>&)>
+        UploadPartAsyncCallBack;
+
+struct UploadPartAsyncContext : public Aws::Client::AsyncCallerContext {
+    std::string key;
+    std::string uploadId;
+    // 第几个分片（从1开始）
+    int partNum;
+    // 分片数据在发起请求时拷贝，请求发起后即可释放
+    const char *buf;
+    size_t len;
+    UploadPartAsyncCallBack cb;
+    int retCode;
+    // 上传成功后分片的etag
+    std::string etag;
+};
+
 class S3Adapter {
  public:
     S3Adapter() {}
@@ -174,6 +196,31 @@ class S3Adapter {
             int partNum,
             int partSize,
             const char* buf);
+    /**
+     * @brief 异步增加一个分片到分片上传任务中，完成后调用context中的回调
+     *
+     * @param context 异步上下文
+     */
+    virtual void UploadPartAsync(
+        std::shared_ptr<UploadPartAsyncContext> context);
+    /**
+     * 将已有对象中的一段数据作为一个分片添加到分片上传任务中，
+     * 数据在s3内部拷贝，不经过本地
+     * @param 对象名
+     * @param 任务名
+     * @param 第几个分片（从1开始）
+     * @param 源对象名
+     * @param 数据在源对象中的偏移
+     * @param 分片大小
+     * @return: 分片任务管理对象
+     */
+    virtual Aws::S3::Model::CompletedPart UploadPartCopy(
+            const Aws::String &key,
+            const Aws::String &uploadId,
+            int partNum,
+            const Aws::String &srcKey,
+            uint64_t offset,
+            int partSize);
     /**
      * 完成分片上传任务
      * @param 对象名
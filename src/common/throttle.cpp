@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include "src/common/throttle.h"
+
+#include <algorithm>
+
+#include "src/common/timeutility.h"
+
+namespace curve {
+namespace common {
+
+void TokenBucket::SetLimit(uint64_t rate, uint64_t burst) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    rate_ = rate;
+    burst_ = std::max(rate, burst);
+
+    // 重新设置限制之后，从满额度开始计算
+    tokens_ = static_cast<double>(burst_);
+    lastUs_ = 0;
+}
+
+uint64_t TokenBucket::Acquire(uint64_t count, uint64_t nowUs) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (rate_ == 0) {
+        return 0;
+    }
+
+    if (lastUs_ != 0 && nowUs > lastUs_) {
+        tokens_ += static_cast<double>(nowUs - lastUs_) * rate_ / 1000000;
+        tokens_ = std::min(tokens_, static_cast<double>(burst_));
+    }
+    if (lastUs_ == 0 || nowUs > lastUs_) {
+        lastUs_ = nowUs;
+    }
+
+    tokens_ -= count;
+    if (tokens_ >= 0) {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(-tokens_ * 1000000 / rate_);
+}
+
+void Throttle::UpdateThrottleParams(ThrottleType type,
+                                    const ThrottleParams& params) {
+    buckets_[static_cast<int>(type)].SetLimit(params.limit, params.burst);
+}
+
+ThrottleParams Throttle::GetThrottleParams(ThrottleType type) {
+    TokenBucket& bucket = buckets_[static_cast<int>(type)];
+    return ThrottleParams(bucket.GetRate(), bucket.GetBurst());
+}
+
+uint64_t Throttle::Add(bool isRead, uint64_t length) {
+    uint64_t nowUs = TimeUtility::GetTimeofDayUs();
+
+    ThrottleType iopsType =
+        isRead ? ThrottleType::IOPS_READ : ThrottleType::IOPS_WRITE;
+    ThrottleType bpsType =
+        isRead ? ThrottleType::BPS_READ : ThrottleType::BPS_WRITE;
+
+    uint64_t iopsWait = buckets_[static_cast<int>(iopsType)].Acquire(1, nowUs);
+    uint64_t bpsWait =
+        buckets_[static_cast<int>(bpsType)].Acquire(length, nowUs);
+
+    return std::max(iopsWait, bpsWait);
+}
+
+}  // namespace common
+}  // namespace curve
@@ -0,0 +1,145 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#ifndef SRC_COMMON_THROTTLE_H_
+#define SRC_COMMON_THROTTLE_H_
+
+#include <stdint.h>
+#include <mutex>  // NOLINT
+#include <ostream>
+
+namespace curve {
+namespace common {
+
+/**
+ * 令牌桶，令牌按rate每秒的速率产生，空闲时最多积累burst个令牌。
+ * 令牌不足时允许预支，调用方根据返回的等待时间自行等待，
+ * 后续请求会排在预支的请求之后，从而保证长期速率不超过rate
+ */
+class TokenBucket {
+ public:
+    TokenBucket() : rate_(0), burst_(0), tokens_(0), lastUs_(0) {}
+
+    /**
+     * @brief 设置令牌桶的速率
+     * @param rate 每秒产生的令牌数，为0表示不限制
+     * @param burst 最多积累的令牌数，小于rate时取rate
+     */
+    void SetLimit(uint64_t rate, uint64_t burst);
+
+    /**
+     * @brief 获取count个令牌
+     * @param count 需要的令牌数
+     * @param nowUs 当前时间
+     * @return 需要等待的时间(us)，0表示不需要等待
+     */
+    uint64_t Acquire(uint64_t count, uint64_t nowUs);
+
+    uint64_t GetRate() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return rate_;
+    }
+
+    uint64_t GetBurst() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        return burst_;
+    }
+
+ private:
+    std::mutex mtx_;
+    uint64_t rate_;
+    uint64_t burst_;
+    // 当前可用的令牌数，预支时为负数
+    double tokens_;
+    // 上一次补充令牌的时间
+    uint64_t lastUs_;
+};
+
+enum class ThrottleType {
+    IOPS_READ = 0,
+    IOPS_WRITE = 1,
+    BPS_READ = 2,
+    BPS_WRITE = 3,
+};
+
+inline std::ostream& operator<<(std::ostream& os, ThrottleType type) {
+    switch (type) {
+        case ThrottleType::IOPS_READ:
+            return os << "IOPS_READ";
+        case ThrottleType::IOPS_WRITE:
+            return os << "IOPS_WRITE";
+        case ThrottleType::BPS_READ:
+            return os << "BPS_READ";
+        case ThrottleType::BPS_WRITE:
+            return os << "BPS_WRITE";
+        default:
+            return os << "UNKNOWN";
+    }
+}
+
+struct ThrottleParams {
+    // 每秒允许的请求数或字节数，为0表示不限制
+    uint64_t limit{0};
+    // 空闲时最多积累的额度，小于limit时取limit
+    uint64_t burst{0};
+
+    ThrottleParams() = default;
+    ThrottleParams(uint64_t l, uint64_t b) : limit(l), burst(b) {}
+};
+
+/**
+ * 读写IOPS、带宽限制，每个限制项对应一个令牌桶，
+ * 一个请求需要同时满足IOPS和带宽限制
+ */
+class Throttle {
+ public:
+    Throttle() = default;
+
+    /**
+     * @brief 更新某一项限制
+     * @param type 限制项
+     * @param params 限制参数
+     */
+    void UpdateThrottleParams(ThrottleType type, const ThrottleParams& params);
+
+    /**
+     * @brief 获取某一项限制
+     */
+    ThrottleParams GetThrottleParams(ThrottleType type);
+
+    /**
+     * @brief 请求下发前获取额度
+     * @param isRead 是否是读请求
+     * @param length 请求大小
+     * @return 需要等待的时间(us)，0表示不需要等待
+     */
+    uint64_t Add(bool isRead, uint64_t length);
+
+ private:
+    static constexpr int kThrottleTypeNum = 4;
+
+    TokenBucket buckets_[kThrottleTypeNum];
+};
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_THROTTLE_H_
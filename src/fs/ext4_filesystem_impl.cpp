@@ -25,6 +25,8 @@
 #include <sys/utsname.h>
 #include <linux/version.h>
 #include <dirent.h>
+#include <limits.h>
+#include <sys/uio.h>
 
 #include "src/common/string_util.h"
 #include "src/fs/ext4_filesystem_impl.h"
@@ -322,6 +324,13 @@ int Ext4FileSystemImpl::Write(int fd,
             LOG(ERROR) << "pwrite failed: " << strerror(errno);
             return -errno;
         }
+        // 没有写入任何数据，继续重试会一直循环下去
+        if (ret == 0) {
+            LOG(ERROR) << "pwrite returns zero."
+                       << "offset: " << offset
+                       << ", length: " << remainLength;
+            return -EIO;
+        }
         remainLength -= ret;
         offset += ret;
         relativeOffset += ret;
@@ -329,6 +338,51 @@ int Ext4FileSystemImpl::Write(int fd,
     return length;
 }
 
+int Ext4FileSystemImpl::Writev(int fd,
+                               const butil::IOBuf& buf,
+                               uint64_t offset,
+                               int length) {
+    if (buf.size() < static_cast<size_t>(length)) {
+        LOG(ERROR) << "pwritev failed, buffer size " << buf.size()
+                   << " is less than length " << length;
+        return -EINVAL;
+    }
+    // IOBuf拷贝只增加block引用计数，写入过程中逐步pop掉已写完的数据
+    butil::IOBuf remain;
+    buf.append_to(&remain, length);
+    struct iovec iov[IOV_MAX];
+    int retryTimes = 0;
+    while (!remain.empty()) {
+        int iovcnt = 0;
+        size_t nblock = remain.backing_block_num();
+        for (size_t i = 0; i < nblock && iovcnt < IOV_MAX; ++i) {
+            butil::StringPiece block = remain.backing_block(i);
+            iov[iovcnt].iov_base = const_cast<char*>(block.data());
+            iov[iovcnt].iov_len = block.size();
+            ++iovcnt;
+        }
+        ssize_t ret = posixWrapper_->pwritev(fd, iov, iovcnt, offset);
+        if (ret < 0) {
+            if (errno == EINTR && retryTimes < MAX_RETYR_TIME) {
+                ++retryTimes;
+                continue;
+            }
+            LOG(ERROR) << "pwritev failed: " << strerror(errno);
+            return -errno;
+        }
+        // 没有写入任何数据，继续重试会一直循环下去
+        if (ret == 0) {
+            LOG(ERROR) << "pwritev returns zero."
+                       << "offset: " << offset
+                       << ", length: " << remain.size();
+            return -EIO;
+        }
+        remain.pop_front(ret);
+        offset += ret;
+    }
+    return length;
+}
+
 int Ext4FileSystemImpl::Append(int fd,
                                const char *buf,
                                int length) {
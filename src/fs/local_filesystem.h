@@ -33,6 +33,8 @@
 #include <cstring>
 #include <mutex>  // NOLINT
 
+#include <butil/iobuf.h>
+
 #include "src/fs/fs_common.h"
 
 using std::vector;
@@ -159,6 +161,20 @@ class LocalFileSystem {
      */
     virtual int Write(int fd, const char* buf, uint64_t offset, int length) = 0;
 
+    /**
+     * 以向量写的方式将IOBuf中的数据写入文件指定区域
+     * IOBuf中的多个block直接组成iovec下发，不需要先拷贝成连续内存
+     * @param fd：文件句柄id，通过Open接口获取
+     * @param buf：待写入数据的IOBuf
+     * @param offset：写入区域的起始偏移
+     * @param length：写入数据的长度
+     * @return 返回成功写入的数据长度，失败返回-1
+     */
+    virtual int Writev(int fd,
+                       const butil::IOBuf& buf,
+                       uint64_t offset,
+                       int length) = 0;
+
     /**
      * 向文件末尾追加数据
      * @param fd：文件句柄id，通过Open接口获取
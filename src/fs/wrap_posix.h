@@ -27,6 +27,7 @@
 #include <unistd.h>
 #include <sys/vfs.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/stat.h>
 #include <sys/utsname.h>
 #include <dirent.h>
@@ -59,6 +60,10 @@ class PosixWrapper {
                            const void *buf,
                            size_t count,
                            off_t offset);
+    virtual ssize_t pwritev(int fd,
+                            const struct iovec *iov,
+                            int iovcnt,
+                            off_t offset);
     virtual int fstat(int fd, struct stat *buf);
     virtual int fallocate(int fd, int mode, off_t offset, off_t len);
     virtual int fsync(int fd);
@@ -186,6 +186,78 @@ int EtcdClientImp::TxnN(const std::vector<Operation> &ops) {
     return errCode;
 }
 
+int EtcdClientImp::TxnWithRevision(
+    const std::vector<Operation> &ops, int64_t *revision) {
+    if (ops.empty() || ops.size() > kEtcdMaxTxnOps) {
+        LOG(ERROR) << "do not support Txn " << ops.size();
+        return EtcdErrCode::EtcdInvalidArgument;
+    }
+
+    bool needRetry = false;
+    int retry = 0;
+    int errCode;
+    do {
+        EtcdClientTxnNWithRevision_return res = EtcdClientTxnNWithRevision(
+            timeout_, const_cast<Operation*>(ops.data()), ops.size());
+        if (res.r0 == EtcdErrCode::EtcdOK) {
+            *revision = res.r1;
+        }
+        errCode = res.r0;
+        needRetry = NeedRetry(errCode);
+    } while (needRetry && ++retry <= retryTimes_);
+
+    return errCode;
+}
+
+int EtcdClientImp::BatchPut(const std::vector<KVPair> &kvs) {
+    std::vector<Operation> ops;
+    uint64_t txnBytes = 0;
+    for (const auto &kv : kvs) {
+        uint64_t size = kv.first.size() + kv.second.size();
+        if (!ops.empty() &&
+            (ops.size() >= kEtcdMaxTxnOps ||
+             txnBytes + size > kEtcdMaxTxnBytes)) {
+            int errCode = CommitTxn(ops);
+            if (errCode != EtcdErrCode::EtcdOK) {
+                return errCode;
+            }
+            ops.clear();
+            txnBytes = 0;
+        }
+
+        Operation op{OpType::OpPut,
+                     const_cast<char*>(kv.first.c_str()),
+                     const_cast<char*>(kv.second.c_str()),
+                     static_cast<int>(kv.first.size()),
+                     static_cast<int>(kv.second.size())};
+        ops.emplace_back(op);
+        txnBytes += size;
+    }
+
+    if (ops.empty()) {
+        return EtcdErrCode::EtcdOK;
+    }
+    return CommitTxn(ops);
+}
+
+int EtcdClientImp::CommitTxn(const std::vector<Operation> &ops) {
+    bool needRetry = false;
+    int retry = 0;
+    int errCode;
+    do {
+        errCode = EtcdClientTxnN(timeout_,
+                                 const_cast<Operation*>(ops.data()),
+                                 ops.size());
+        needRetry = NeedRetry(errCode);
+    } while (needRetry && ++retry <= retryTimes_);
+
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(WARNING) << "commit txn with " << ops.size()
+                     << " ops fail, errCode: " << errCode;
+    }
+    return errCode;
+}
+
 int EtcdClientImp::GetCurrentRevision(int64_t *revision) {
     bool needRetry = false;
     int retry = 0;
@@ -257,6 +329,58 @@ int EtcdClientImp::ListWithLimitAndRevision(const std::string &startKey,
     return errCode;
 }
 
+int EtcdClientImp::ListChanges(const std::string &startKey,
+    const std::string &endKey, int64_t startRevision, int64_t endRevision,
+    std::vector<KVChange> *changes) {
+    bool needRetry = false;
+    int retry = 0;
+    int errCode;
+    do {
+        changes->clear();
+        EtcdClientListChanges_return res = EtcdClientListChanges(
+            timeout_, const_cast<char*>(startKey.c_str()),
+            const_cast<char*>(endKey.c_str()), startKey.size(),
+            endKey.size(), startRevision, endRevision);
+
+        errCode = res.r0;
+        needRetry = NeedRetry(errCode);
+        if (res.r0 != EtcdErrCode::EtcdOK) {
+            LOG(WARNING) << "ListChanges [start:" << startKey
+                         << ", end:" << endKey << "] revision ("
+                         << startRevision << ", " << endRevision
+                         << "] err: " << res.r0 << ", retry: " << retry
+                         << ", needRetry: " << needRetry;
+            continue;
+        }
+
+        for (int i = 0; i < res.r2; i++) {
+            EtcdClientGetChangeObject_return objRes =
+                EtcdClientGetChangeObject(res.r1, i);
+            if (objRes.r0 != EtcdErrCode::EtcdOK) {
+                LOG(ERROR) << "get change object:" << res.r1
+                           << " index:" << i << ", count:" << res.r2
+                           << " err: " << objRes.r0;
+                EtcdClientRemoveObject(res.r1);
+                return objRes.r0;
+            }
+
+            KVChange change;
+            change.type = objRes.r1;
+            change.key = std::string(objRes.r2, objRes.r2 + objRes.r3);
+            change.value = std::string(objRes.r4, objRes.r4 + objRes.r5);
+            change.prevValue = std::string(objRes.r6, objRes.r6 + objRes.r7);
+            change.revision = objRes.r8;
+            changes->emplace_back(std::move(change));
+            free(objRes.r2);
+            free(objRes.r4);
+            free(objRes.r6);
+        }
+        EtcdClientRemoveObject(res.r1);
+    } while (needRetry && ++retry <= retryTimes_);
+
+    return errCode;
+}
+
 int EtcdClientImp::CompareAndSwap(const std::string &key,
     const std::string &preV, const std::string &target) {
     bool needRetry = false;
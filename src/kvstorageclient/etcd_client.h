@@ -25,10 +25,32 @@
 
 #include <libetcdclient.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace curve {
 namespace kvstorage {
+
+// BatchPut中单个事务最多包含的操作数，与etcd默认的--max-txn-ops一致
+const uint32_t kEtcdMaxTxnOps = 128;
+// BatchPut中单个事务key和value的最大字节数，小于etcd默认的
+// --max-request-bytes(1.5MB)
+const uint64_t kEtcdMaxTxnBytes = 1024 * 1024;
+
+using KVPair = std::pair<std::string, std::string>;
+
+// etcd中key的一次变化
+struct KVChange {
+    OpType type;
+    std::string key;
+    // 变化之后的value, delete时为空
+    std::string value;
+    // 变化之前的value, 新建key时为空
+    std::string prevValue;
+    // 变化对应的revision
+    int64_t revision;
+};
+
 class KVStorageClient {
  public:
     KVStorageClient() {}
@@ -107,6 +129,29 @@ class KVStorageClient {
     */
     virtual int TxnN(const std::vector<Operation> &ops) = 0;
 
+    /**
+     * @brief TxnWithRevision 事务，ops中的操作原子生效，
+     *        操作数不能超过kEtcdMaxTxnOps
+     *
+     * @param[in] ops 操作集合
+     * @param[out] revision 本次事务的版本号
+     *
+     * @return 错误码
+     */
+    virtual int TxnWithRevision(
+        const std::vector<Operation> &ops, int64_t *revision) = 0;
+
+    /**
+     * @brief BatchPut 批量存储key-value，按照kEtcdMaxTxnOps和kEtcdMaxTxnBytes
+     *        拆分成多个事务依次提交。每个事务内的put原子生效，
+     *        某个事务失败时直接返回，之前已提交的事务不回滚
+     *
+     * @param[in] kvs 需要存储的key-value
+     *
+     * @return 错误码
+     */
+    virtual int BatchPut(const std::vector<KVPair> &kvs) = 0;
+
     /**
      * @brief CompareAndSwap 事务，实现CAS
      *
@@ -158,6 +203,11 @@ class EtcdClientImp : public KVStorageClient {
 
     int TxnN(const std::vector<Operation> &ops) override;
 
+    int TxnWithRevision(
+        const std::vector<Operation> &ops, int64_t *revision) override;
+
+    int BatchPut(const std::vector<KVPair> &kvs) override;
+
     int CompareAndSwap(const std::string &key, const std::string &preV,
         const std::string &target) override;
 
@@ -178,6 +228,22 @@ class EtcdClientImp : public KVStorageClient {
         const std::string &endKey, int64_t limit, int64_t revision,
         std::vector<std::string> *values, std::string *lastKey);
 
+    /**
+     * @brief ListChanges 获取[startKey, endKey)在
+     *        (startRevision, endRevision]之间的所有变化, 按revision递增排列
+     *
+     * @param[in] startKey 起始key
+     * @param[in] endKey 终止key, 不包含
+     * @param[in] startRevision 起始revision, 不包含
+     * @param[in] endRevision 终止revision, 包含
+     * @param[out] changes 变化的集合
+     *
+     * @return 错误码, startRevision已经被compact时返回EtcdOutOfRange
+     */
+    virtual int ListChanges(const std::string &startKey,
+        const std::string &endKey, int64_t startRevision,
+        int64_t endRevision, std::vector<KVChange> *changes);
+
     /**
      * @brief CampaignLeader 通过etcd竞选leader,如果成功则返回; 如果未竞选成功，
      *      electionTimeoutMs>0的情况下会返回失败， electionTimeoutMs=0的情况
@@ -226,6 +292,11 @@ class EtcdClientImp : public KVStorageClient {
  private:
     bool NeedRetry(int errCode);
 
+    /**
+     * @brief 将ops作为一个事务提交，失败时按照retryTimes_重试
+     */
+    int CommitTxn(const std::vector<Operation> &ops);
+
  private:
     // 每个接口的超时时间，单位是ms
     int timeout_;
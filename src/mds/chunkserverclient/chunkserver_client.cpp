@@ -228,6 +228,101 @@ int ChunkServerClient::DeleteChunk(ChunkServerIdType leaderId,
     return kMdsSuccess;
 }
 
+int ChunkServerClient::DeleteChunks(ChunkServerIdType leaderId,
+    LogicalPoolID logicalPoolId,
+    CopysetID copysetId,
+    const std::vector<ChunkID> &chunkIds,
+    uint64_t sn) {
+    if (chunkIds.empty()) {
+        return kMdsSuccess;
+    }
+    ChannelPtr channelPtr;
+    int res = GetOrInitChannel(leaderId, &channelPtr);
+    if (res != kMdsSuccess) {
+        return res;
+    }
+    ChunkService_Stub stub(channelPtr.get());
+
+    brpc::Controller cntl;
+    cntl.set_timeout_ms(rpcTimeoutMs_);
+
+    ChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH);
+    request.set_logicpoolid(logicalPoolId);
+    request.set_copysetid(copysetId);
+    request.set_chunkid(chunkIds.front());
+    request.set_sn(sn);
+    for (ChunkID chunkId : chunkIds) {
+        request.add_deletechunkids(chunkId);
+    }
+
+    ChunkResponse response;
+    uint32_t retry = 0;
+    do {
+        cntl.Reset();
+        cntl.set_timeout_ms(rpcTimeoutMs_);
+        stub.DeleteChunks(&cntl,
+            &request,
+            &response,
+            nullptr);
+        LOG(INFO) << "Send DeleteChunks[log_id=" << cntl.log_id()
+                  << "] from " << cntl.local_side()
+                  << " to " << cntl.remote_side()
+                  << ". logicalPoolId = " << logicalPoolId
+                  << ", copysetId = " << copysetId
+                  << ", chunk count = " << chunkIds.size()
+                  << ", sn = " << sn;
+        if (cntl.Failed()) {
+            LOG(WARNING) << "Send DeleteChunks error, "
+                       << "cntl.errorText = "
+                       << cntl.ErrorText()
+                       << ", retry, time = "
+                       << retry;
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(rpcRetryIntervalMs_));
+        }
+        retry++;
+    } while (cntl.Failed() && retry < rpcRetryTimes_);
+
+    if (cntl.Failed()) {
+        LOG(ERROR) << "Send DeleteChunks error, retry fail,"
+                   << "cntl.errorText = "
+                   << cntl.ErrorText() << std::endl;
+        return kRpcFail;
+    } else {
+        switch (response.status()) {
+            case CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS: {
+                    LOG(INFO) << "Received DeleteChunks[log_id="
+                          << cntl.log_id()
+                          << "] from " << cntl.remote_side()
+                          << " to " << cntl.local_side()
+                          << ". [ChunkResponse] "
+                          << response.DebugString();
+                    return kMdsSuccess;
+                }
+            case CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED: {
+                    LOG(INFO) << "Received DeleteChunks, not leader, redirect."
+                              << " [log_id=" << cntl.log_id()
+                              << "] from " << cntl.remote_side()
+                              << " to " << cntl.local_side()
+                              << ". [ChunkResponse] "
+                              << response.DebugString();
+                    return kCsClientNotLeader;
+                }
+            default: {
+                    LOG(ERROR) << "Received DeleteChunks error, [log_id="
+                              << cntl.log_id()
+                              << "] from " << cntl.remote_side()
+                              << " to " << cntl.local_side()
+                              << ". [ChunkResponse] "
+                              << response.DebugString();
+                    return kCsClientReturnFail;
+                }
+        }
+    }
+    return kMdsSuccess;
+}
+
 int ChunkServerClient::GetLeader(ChunkServerIdType csId,
     LogicalPoolID logicalPoolId,
     CopysetID copysetId,
@@ -28,6 +28,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "src/mds/common/mds_define.h"
 #include "src/mds/topology/topology.h"
@@ -92,6 +93,23 @@ class ChunkServerClient {
         ChunkID chunkId,
         uint64_t sn);
 
+    /**
+     * @brief 在一个请求中删除同一复制组内的多个非快照chunk文件
+     *
+     * @param leaderId leader的ID
+     * @param logicalPoolId 逻辑池的ID
+     * @param copysetId 复制组的ID
+     * @param chunkIds chunk文件ID
+     * @param sn 文件版本号
+     *
+     * @return 错误码
+     */
+    virtual int DeleteChunks(ChunkServerIdType leaderId,
+        LogicalPoolID logicalPoolId,
+        CopysetID copysetId,
+        const std::vector<ChunkID> &chunkIds,
+        uint64_t sn);
+
     /**
      * @brief 获取leader
      * @detail
@@ -35,12 +35,15 @@ struct ChunkServerClientOption {
     uint32_t rpcRetryIntervalMs;
     uint32_t updateLeaderRetryTimes;
     uint32_t updateLeaderRetryIntervalMs;
+    // 批量删除chunk时一个rpc中最多包含的chunk数量，0表示逐个chunk删除
+    uint32_t deleteChunkBatchSize;
     ChunkServerClientOption()
         : rpcTimeoutMs(500),
           rpcRetryTimes(10),
           rpcRetryIntervalMs(500),
           updateLeaderRetryTimes(3),
-          updateLeaderRetryIntervalMs(5000) {}
+          updateLeaderRetryIntervalMs(5000),
+          deleteChunkBatchSize(0) {}
 };
 
 }  // namespace chunkserverclient
@@ -22,6 +22,7 @@
 
 #include <thread> //NOLINT
 #include <chrono> //NOLINT
+#include <algorithm>
 
 #include "src/mds/chunkserverclient/copyset_client.h"
 
@@ -38,7 +39,23 @@ int CopysetClient::DeleteChunkSnapshotOrCorrectSn(LogicalPoolID logicalPoolId,
     CopysetID copysetId,
     ChunkID chunkId,
     uint64_t correctedSn) {
-    int ret = kMdsFail;
+    return DeleteChunkSnapshotsOrCorrectSn(logicalPoolId, copysetId,
+        std::vector<ChunkID>{chunkId}, correctedSn);
+}
+
+int CopysetClient::DeleteChunk(LogicalPoolID logicalPoolId,
+                                    CopysetID copysetId,
+                                    ChunkID chunkId,
+                                    uint64_t sn) {
+    return DeleteChunks(logicalPoolId, copysetId,
+        std::vector<ChunkID>{chunkId}, sn);
+}
+
+int CopysetClient::DeleteChunkSnapshotsOrCorrectSn(
+    LogicalPoolID logicalPoolId,
+    CopysetID copysetId,
+    const std::vector<ChunkID> &chunkIds,
+    uint64_t correctedSn) {
     CopySetInfo copyset;
     if (true != topo_->GetCopySet(
         CopySetKey(logicalPoolId, copysetId),
@@ -47,56 +64,23 @@ int CopysetClient::DeleteChunkSnapshotOrCorrectSn(LogicalPoolID logicalPoolId,
         return kMdsFail;
     }
 
-    ChunkServerIdType leaderId =
-        copyset.GetLeader();
-
-    if (leaderId != UNINTIALIZE_ID) {
-        ret = chunkserverClient_->DeleteChunkSnapshotOrCorrectSn(
-            leaderId, logicalPoolId, copysetId, chunkId, correctedSn);
-        if (kMdsSuccess == ret) {
+    for (ChunkID chunkId : chunkIds) {
+        int ret = SendToLeader(&copyset,
+            [&](ChunkServerIdType leaderId) {
+                return chunkserverClient_->DeleteChunkSnapshotOrCorrectSn(
+                    leaderId, logicalPoolId, copysetId, chunkId, correctedSn);
+            });
+        if (kMdsSuccess != ret) {
             return ret;
         }
     }
-
-    uint32_t retry = 0;
-    while ((retry < updateLeaderRetryTimes_) &&
-           ((UNINTIALIZE_ID == leaderId) ||
-            (kCsClientCSOffline == ret) ||
-            (kRpcFail == ret) ||
-            (kCsClientNotLeader == ret))) {
-        std::this_thread::sleep_for(
-                std::chrono::milliseconds(updateLeaderRetryIntervalMs_));
-        ret = UpdateLeader(&copyset);
-        if (ret < 0) {
-            LOG(ERROR) << "UpdateLeader fail."
-                       << " logicalPoolId = " << logicalPoolId
-                       << ", copysetId = " << copysetId;
-            break;
-        }
-
-        leaderId = copyset.GetLeader();
-        LOG(INFO) << "UpdateLeader success, new leaderId = " << leaderId;
-
-        if (leaderId != UNINTIALIZE_ID) {
-            ret = chunkserverClient_->DeleteChunkSnapshotOrCorrectSn(
-                leaderId, logicalPoolId, copysetId, chunkId, correctedSn);
-            if (kMdsSuccess == ret) {
-                break;
-            }
-        } else {
-            LOG(ERROR) << "UpdateLeader success, but leaderId is uninit.";
-            return kMdsFail;
-        }
-        retry++;
-    }
-    return ret;
+    return kMdsSuccess;
 }
 
-int CopysetClient::DeleteChunk(LogicalPoolID logicalPoolId,
-                                    CopysetID copysetId,
-                                    ChunkID chunkId,
-                                    uint64_t sn) {
-    int ret = kMdsFail;
+int CopysetClient::DeleteChunks(LogicalPoolID logicalPoolId,
+    CopysetID copysetId,
+    const std::vector<ChunkID> &chunkIds,
+    uint64_t sn) {
     CopySetInfo copyset;
     if (true != topo_->GetCopySet(
         CopySetKey(logicalPoolId, copysetId),
@@ -105,19 +89,52 @@ int CopysetClient::DeleteChunk(LogicalPoolID logicalPoolId,
         return kMdsFail;
     }
 
-    ChunkServerIdType leaderId =
-        copyset.GetLeader();
+    if (deleteChunkBatchSize_ == 0) {
+        for (ChunkID chunkId : chunkIds) {
+            int ret = SendToLeader(&copyset,
+                [&](ChunkServerIdType leaderId) {
+                    return chunkserverClient_->DeleteChunk(
+                        leaderId, logicalPoolId, copysetId, chunkId, sn);
+                });
+            if (kMdsSuccess != ret) {
+                return ret;
+            }
+        }
+        return kMdsSuccess;
+    }
+
+    // 每deleteChunkBatchSize_个chunk通过一个rpc删除，在chunkserver上
+    // 作为一条raft日志apply
+    for (size_t begin = 0; begin < chunkIds.size();
+        begin += deleteChunkBatchSize_) {
+        size_t end = std::min(chunkIds.size(),
+            begin + static_cast<size_t>(deleteChunkBatchSize_));
+        std::vector<ChunkID> batch(chunkIds.begin() + begin,
+                                   chunkIds.begin() + end);
+        int ret = SendToLeader(&copyset,
+            [&](ChunkServerIdType leaderId) {
+                return chunkserverClient_->DeleteChunks(
+                    leaderId, logicalPoolId, copysetId, batch, sn);
+            });
+        if (kMdsSuccess != ret) {
+            return ret;
+        }
+    }
+    return kMdsSuccess;
+}
 
+int CopysetClient::SendToLeader(CopySetInfo *copyset, const SendFunc &send) {
+    int ret = kMdsFail;
+    ChunkServerIdType leaderId = copyset->GetLeader();
     if (leaderId != UNINTIALIZE_ID) {
-        ret = chunkserverClient_->DeleteChunk(
-            leaderId, logicalPoolId, copysetId, chunkId, sn);
+        ret = send(leaderId);
         if (kMdsSuccess == ret) {
             return ret;
         }
     }
 
-    // delete Chunk在kCsClientCSOffline、kRpcFail、kCsClientNotLeader
-    // 这三种返回值时需要进行重试
+    // 在kCsClientCSOffline、kRpcFail、kCsClientNotLeader
+    // 这三种返回值时需要更新leader后进行重试
     uint32_t retry = 0;
     while ((retry < updateLeaderRetryTimes_) &&
            ((UNINTIALIZE_ID == leaderId) ||
@@ -126,20 +143,19 @@ int CopysetClient::DeleteChunk(LogicalPoolID logicalPoolId,
             (kCsClientNotLeader == ret))) {
         std::this_thread::sleep_for(
                 std::chrono::milliseconds(updateLeaderRetryIntervalMs_));
-        ret = UpdateLeader(&copyset);
+        ret = UpdateLeader(copyset);
         if (ret < 0) {
             LOG(ERROR) << "UpdateLeader fail."
-                       << " logicalPoolId = " << logicalPoolId
-                       << ", copysetId = " << copysetId;
+                       << " logicalPoolId = " << copyset->GetLogicalPoolId()
+                       << ", copysetId = " << copyset->GetId();
             break;
         }
 
-        leaderId = copyset.GetLeader();
+        leaderId = copyset->GetLeader();
         LOG(INFO) << "UpdateLeader success, new leaderId = " << leaderId;
 
         if (leaderId != UNINTIALIZE_ID) {
-            ret = chunkserverClient_->DeleteChunk(
-                leaderId, logicalPoolId, copysetId, chunkId, sn);
+            ret = send(leaderId);
             if (kMdsSuccess == ret) {
                 break;
             }
@@ -23,7 +23,9 @@
 #ifndef SRC_MDS_CHUNKSERVERCLIENT_COPYSET_CLIENT_H_
 #define SRC_MDS_CHUNKSERVERCLIENT_COPYSET_CLIENT_H_
 
+#include <functional>
 #include <memory>
+#include <vector>
 #include "src/mds/common/mds_define.h"
 #include "src/mds/topology/topology.h"
 
@@ -52,7 +54,8 @@ class CopysetClient {
           chunkserverClient_(
             std::make_shared<ChunkServerClient>(topo, option, channelPool)),
           updateLeaderRetryTimes_(option.updateLeaderRetryTimes),
-          updateLeaderRetryIntervalMs_(option.updateLeaderRetryIntervalMs) {
+          updateLeaderRetryIntervalMs_(option.updateLeaderRetryIntervalMs),
+          deleteChunkBatchSize_(option.deleteChunkBatchSize) {
     }
 
     void SetChunkServerClient(std::shared_ptr<ChunkServerClient> csClient) {
@@ -90,6 +93,40 @@ class CopysetClient {
         ChunkID chunkId,
         uint64_t sn);
 
+    /**
+     * @brief 批量删除同一个复制组内的快照或修改correctedSn，
+     *        复制组的leader只查询一次，leader切换后后续chunk使用新的leader
+     *
+     * @param logicPoolId 逻辑池id
+     * @param copysetId 复制组id
+     * @param chunkIds 复制组内的Chunk文件id
+     * @param correctedSn chunk不存在快照文件时需要修正的版本号
+     *
+     * @return 错误码，遇到第一个失败的chunk即返回
+     */
+    int DeleteChunkSnapshotsOrCorrectSn(LogicalPoolID logicalPoolId,
+        CopysetID copysetId,
+        const std::vector<ChunkID> &chunkIds,
+        uint64_t correctedSn);
+
+    /**
+     * @brief 批量删除同一个复制组内非快照文件的Chunk文件，
+     *        复制组的leader只查询一次，leader切换后后续chunk使用新的leader，
+     *        deleteChunkBatchSize不为0时每deleteChunkBatchSize个chunk
+     *        通过一个DeleteChunks rpc删除，否则逐个chunk删除
+     *
+     * @param logicPoolId 逻辑池id
+     * @param copysetId 复制组id
+     * @param chunkIds 复制组内的Chunk文件id
+     * @param sn 文件版本号
+     *
+     * @return 错误码，遇到第一个失败的请求即返回
+     */
+    int DeleteChunks(LogicalPoolID logicalPoolId,
+        CopysetID copysetId,
+        const std::vector<ChunkID> &chunkIds,
+        uint64_t sn);
+
     /**
      * @brief 更新leader
      *
@@ -100,11 +137,26 @@ class CopysetClient {
     int UpdateLeader(CopySetInfo *copyset);
 
  private:
+    using SendFunc = std::function<int(ChunkServerIdType leaderId)>;
+
+    /**
+     * @brief 向复制组的leader发送请求，leader未知、chunkserver离线、
+     *        rpc失败或者不是leader时更新leader后重试
+     *
+     * @param[in][out] copyset 复制组，leader变化时更新其中的leader
+     * @param send 向指定leader发送请求
+     *
+     * @return 错误码
+     */
+    int SendToLeader(CopySetInfo *copyset, const SendFunc &send);
+
     std::shared_ptr<Topology> topo_;
     std::shared_ptr<ChunkServerClient> chunkserverClient_;
 
     uint32_t updateLeaderRetryTimes_;
     uint32_t updateLeaderRetryIntervalMs_;
+    // 一个DeleteChunks rpc中最多包含的chunk数量，0表示逐个chunk删除
+    uint32_t deleteChunkBatchSize_;
 };
 
 }  // namespace chunkserverclient
@@ -46,7 +46,8 @@ HeartbeatManager::HeartbeatManager(HeartbeatOption option,
     std::shared_ptr<TopologyStat> topologyStat,
     std::shared_ptr<Coordinator> coordinator)
     : topology_(topology),
-      topologyStat_(topologyStat) {
+      topologyStat_(topologyStat),
+      coordinator_(coordinator) {
     healthyChecker_ =
         std::make_shared<ChunkserverHealthyChecker>(option, topology);
 
@@ -118,8 +119,9 @@ void HeartbeatManager::UpdateChunkServerDiskStatus(
     }
 }
 
-void HeartbeatManager::UpdateChunkServerStatistics(
+bool HeartbeatManager::UpdateChunkServerStatistics(
     const ChunkServerHeartbeatRequest &request) {
+    bool hasLastStat = true;
     ChunkServerStat stat;
     stat.leaderCount = request.leadercount();
     stat.copysetCount = request.copysetcount();
@@ -172,17 +174,38 @@ void HeartbeatManager::UpdateChunkServerStatistics(
             stat.copysetStats.push_back(cstat);
         }
 
+        // 增量上报中未上报的copyset沿用上一次的统计数据
+        if (request.isdeltareport()) {
+            ChunkServerStat lastStat;
+            if (topologyStat_->GetChunkServerStat(
+                    request.chunkserverid(), &lastStat)) {
+                std::set<CopySetKey> reported;
+                for (const auto &cstat : stat.copysetStats) {
+                    reported.emplace(cstat.logicalPoolId, cstat.copysetId);
+                }
+                for (const auto &cstat : lastStat.copysetStats) {
+                    if (reported.count(CopySetKey(
+                            cstat.logicalPoolId, cstat.copysetId)) == 0) {
+                        stat.copysetStats.push_back(cstat);
+                    }
+                }
+            } else {
+                hasLastStat = false;
+            }
+        }
     } else {
         LOG(WARNING) << "hearbeat manager receive request "
                      << "do not have ChunkServerStatisticInfo";
     }
     topologyStat_->UpdateChunkServerStat(request.chunkserverid(), stat);
+    return hasLastStat;
 }
 
 void HeartbeatManager::ChunkServerHeartbeat(
     const ChunkServerHeartbeatRequest &request,
     ChunkServerHeartbeatResponse *response) {
     response->set_statuscode(HeartbeatStatusCode::hbOK);
+    response->set_supportdeltareport(true);
     // 检查request的合法性
     HeartbeatStatusCode ret = CheckRequest(request);
     if (ret != HeartbeatStatusCode::hbOK) {
@@ -203,13 +226,22 @@ void HeartbeatManager::ChunkServerHeartbeat(
 
     UpdateChunkServerDiskStatus(request);
 
-    UpdateChunkServerStatistics(request);
-    // request里面没有copyset信息
-    if (request.copysetinfos_size() == 0) {
+    if (!UpdateChunkServerStatistics(request)) {
+        // mds没有该chunkserver之前上报的信息(例如mds刚启动)，
+        // 需要chunkserver进行一次全量上报
+        LOG(INFO) << "heartbeatManager receive delta report from chunkserver "
+                  << request.chunkserverid() << " without last report, "
+                  << "request full report";
+        response->set_needfullreport(true);
+    }
+    // 全量上报的request里面没有copyset信息
+    if (!request.isdeltareport() && request.copysetinfos_size() == 0) {
         response->set_statuscode(HeartbeatStatusCode::hbRequestNoCopyset);
     }
     // 处理心跳中的copyset
+    std::set<CopySetKey> reported;
     for (auto &value : request.copysetinfos()) {
+        reported.emplace(value.logicalpoolid(), value.copysetid());
         // 逻辑池不可用时，不处理该逻辑池的copyset信息
         ::curve::mds::topology::LogicalPool lPool;
         if (topology_->GetLogicalPool(value.logicalpoolid(), &lPool)) {
@@ -245,6 +277,36 @@ void HeartbeatManager::ChunkServerHeartbeat(
             topoUpdater_->UpdateTopo(reportCopySetInfo);
         }
     }
+
+    if (request.isdeltareport()) {
+        GenCopysetConfForUnreported(
+            request.chunkserverid(), reported, response);
+    }
+}
+
+void HeartbeatManager::GenCopysetConfForUnreported(
+    ChunkServerIdType reportId, const std::set<CopySetKey> &reported,
+    ChunkServerHeartbeatResponse *response) {
+    for (const auto &key : coordinator_->GetCopySetsWithOperator()) {
+        if (reported.count(key) > 0) {
+            continue;
+        }
+
+        ::curve::mds::topology::CopySetInfo recordCopySetInfo;
+        if (!topology_->GetCopySet(key, &recordCopySetInfo) ||
+            recordCopySetInfo.GetLeader() != reportId) {
+            continue;
+        }
+
+        // 未上报说明该copyset与上次上报相比没有变化，也没有正在进行的配置变更，
+        // 使用mds记录的信息代替leader的上报
+        recordCopySetInfo.ClearCandidate();
+        CopySetConf conf;
+        if (copysetConfGenerator_->GenCopysetConf(reportId, recordCopySetInfo,
+                ConfigChangeInfo(), &conf)) {
+            *response->add_needupdatecopysets() = conf;
+        }
+    }
 }
 
 HeartbeatStatusCode HeartbeatManager::CheckRequest(
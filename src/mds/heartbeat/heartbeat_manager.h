@@ -25,6 +25,7 @@
 
 #include <vector>
 #include <map>
+#include <set>
 #include <atomic>
 #include <string>
 #include <memory>
@@ -43,6 +44,7 @@
 using ::curve::mds::topology::CopySetInfo;
 using ::curve::mds::topology::PoolIdType;
 using ::curve::mds::topology::CopySetIdType;
+using ::curve::mds::topology::CopySetKey;
 using ::curve::mds::topology::Topology;
 using ::curve::mds::topology::TopologyStat;
 using ::curve::mds::schedule::Coordinator;
@@ -113,14 +115,27 @@ class HeartbeatManager {
         const ChunkServerHeartbeatRequest &request);
 
     /**
-     * @brief 更新chunkserver统计数据
+     * @brief 更新chunkserver统计数据，增量上报时合并上一次上报的copyset统计
      *
      * @param request 请求报文
-     * @param response 回复报文
+     *
+     * @return 增量上报且mds没有该chunkserver上一次的统计数据时返回false
      */
-    void UpdateChunkServerStatistics(
+    bool UpdateChunkServerStatistics(
         const ChunkServerHeartbeatRequest &request);
 
+    /**
+     * @brief 增量上报时，为leader在该chunkserver上但未上报的、
+     *        有operator的copyset生成配置下发
+     *
+     * @param reportId 上报心跳的chunkserver
+     * @param reported 本次心跳上报的copyset
+     * @param response 回复报文
+     */
+    void GenCopysetConfForUnreported(ChunkServerIdType reportId,
+        const std::set<CopySetKey> &reported,
+        ChunkServerHeartbeatResponse *response);
+
     /**
      * @brief ChunkServerHealthyChecker 心跳超时检查后端线程
      */
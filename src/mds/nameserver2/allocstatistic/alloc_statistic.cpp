@@ -26,10 +26,12 @@
 #include "src/mds/nameserver2/allocstatistic/alloc_statistic_helper.h"
 #include "src/mds/nameserver2/helper/namespace_helper.h"
 #include "src/common/concurrent/concurrent.h"
+#include "src/common/namespace_define.h"
 
 using ::curve::common::Thread;
 using ::curve::common::ReadLockGuard;
 using ::curve::common::WriteLockGuard;
+using ::curve::common::SEGMENTALLOCCHECKPOINTKEY;
 
 namespace curve {
 namespace mds {
@@ -43,21 +45,63 @@ int AllocStatistic::Init() {
 
     res = AllocStatisticHelper::GetExistSegmentAllocValues(
         &existSegmentAllocValues_, client_);
-    return res;
+    if (res != 0) {
+        return res;
+    }
+
+    loadFromCheckpoint_ = LoadFromCheckpoint();
+    return 0;
+}
+
+bool AllocStatistic::LoadFromCheckpoint() {
+    int64_t revision;
+    std::map<PoolIdType, int64_t> alloc;
+    int res = AllocStatisticHelper::GetSegmentAllocCheckpoint(
+        client_, &revision, &alloc);
+    if (res != 0) {
+        return false;
+    }
+
+    // 检查点之后的历史已经被compact时，只能统计全部segment
+    if (revision > curRevision_ ||
+        AllocStatisticHelper::ReplaySegmentChanges(
+            revision, curRevision_, client_, &alloc) != 0) {
+        LOG(WARNING) << "replay segment alloc checkpoint at revision "
+                     << revision << " fail, calculate from all segments";
+        return false;
+    }
+
+    {
+        WriteLockGuard guard(segmentAllocLock_);
+        segmentAlloc_ = alloc;
+    }
+    lastRevision_ = curRevision_;
+    segmentAllocFromEtcdOK_.store(true);
+    currentValueAvalible_.store(true);
+    LOG(INFO) << "load segment alloc from checkpoint at revision " << revision
+              << " and replay to revision " << curRevision_ << " ok";
+    return true;
 }
 
 void AllocStatistic::Run() {
     stop_.store(false);
-    periodicPersist_ = Thread(&AllocStatistic::CalculateSegmentAlloc, this);
-    calculateAlloc_ = Thread(&AllocStatistic::PeriodicPersist, this);
+    if (!loadFromCheckpoint_) {
+        calculateAlloc_ =
+            Thread(&AllocStatistic::CalculateSegmentAlloc, this);
+    }
+    periodicPersist_ = Thread(&AllocStatistic::PeriodicPersist, this);
 }
 
 void AllocStatistic::Stop() {
     if (!stop_.exchange(true)) {
         LOG(INFO) << "start stop AllocStatistic...";
         sleeper_.interrupt();
-        periodicPersist_.join();
-        calculateAlloc_.join();
+        if (periodicPersist_.joinable()) {
+            periodicPersist_.join();
+        }
+        if (calculateAlloc_.joinable()) {
+            calculateAlloc_.join();
+        }
         LOG(INFO) << "stop AllocStatistic ok!";
     }
 }
@@ -99,6 +143,7 @@ void AllocStatistic::AllocSpace(
     if (true == segmentAllocFromEtcdOK_.load()) {
         WriteLockGuard guard(segmentAllocLock_);
         segmentAlloc_[lid] += changeSize;
+        recentChange_[lid][revision] = changeSize;
     // 如果etcd中的数据还未统计结束，将change更新到segmentChange_中
     } else {
         WriteLockGuard guard(segmentChangeLock_);
@@ -116,6 +161,7 @@ void AllocStatistic::DeAllocSpace(
     if (true == segmentAllocFromEtcdOK_.load()) {
         WriteLockGuard guard(segmentAllocLock_);
         segmentAlloc_[lid] -= changeSize;
+        recentChange_[lid][revision] = 0L - changeSize;
     } else {
         WriteLockGuard guard(segmentChangeLock_);
         segmentChange_[lid][revision] = 0L - changeSize;
@@ -140,6 +186,7 @@ void AllocStatistic::CalculateSegmentAlloc() {
 
     // 做一次合并
     DoMerge();
+    lastRevision_ = curRevision_;
 
     // 设置segmentAlloc_可用
     currentValueAvalible_.store(true);
@@ -207,12 +254,48 @@ void AllocStatistic::PeriodicPersist() {
                 lastPersist.erase(item.first);
             }
         }
+
+        PersistCheckpoint();
         LOG(INFO) << "periodic persist to etcd end";
     }
 
     lastPersist.clear();
 }
 
+void AllocStatistic::PersistCheckpoint() {
+    if (false == currentValueAvalible_.load()) {
+        return;
+    }
+
+    // lastRevision_之前的变化都已经更新到segmentAlloc_中,
+    // 减去之后的变化即为该revision对应的分配量
+    std::map<PoolIdType, int64_t> checkpoint;
+    {
+        WriteLockGuard guard(segmentAllocLock_);
+        checkpoint = segmentAlloc_;
+        for (auto &pool : recentChange_) {
+            auto end = pool.second.upper_bound(lastRevision_);
+            for (auto iter = end; iter != pool.second.end(); ++iter) {
+                checkpoint[pool.first] -= iter->second;
+            }
+            pool.second.erase(pool.second.begin(), end);
+        }
+    }
+
+    // 检查点写入的revision作为下一轮检查点的revision,
+    // 持久化间隔内该revision之前的变化都已经更新到segmentAlloc_中
+    int64_t revision = 0;
+    int errCode = client_->PutRewithRevision(SEGMENTALLOCCHECKPOINTKEY,
+        NameSpaceStorageCodec::EncodeSegmentAllocCheckpoint(
+            lastRevision_, checkpoint), &revision);
+    if (EtcdErrCode::EtcdOK != errCode) {
+        LOG(WARNING) << "persist segment alloc checkpoint at revision "
+                     << lastRevision_ << " fail, errCode: " << errCode;
+        return;
+    }
+    lastRevision_ = revision;
+}
+
 void AllocStatistic::DoMerge() {
     // 将revision之前的alloc数据和revision之后的数据进行合并
     std::set<PoolIdType> logicalPools = GetCurrentLogicalPools();
@@ -244,6 +327,7 @@ std::map<PoolIdType, int64_t> AllocStatistic::GetLatestSegmentAllocInfo() {
 void AllocStatistic::UpdateSegmentAllocByCurrrevision(PoolIdType lid) {
     // 获取>revision之后的值
     int64_t sumChangeUntilNow = 0;
+    std::map<int64_t, int64_t> merged;
 
     {
         WriteLockGuard guard(segmentChangeLock_);
@@ -261,7 +345,7 @@ void AllocStatistic::UpdateSegmentAllocByCurrrevision(PoolIdType lid) {
                     for (auto item : liter->second) {
                         sumChangeUntilNow += item.second;
                     }
-                    liter->second.clear();
+                    merged.swap(liter->second);
                 }
             }
         }
@@ -271,6 +355,10 @@ void AllocStatistic::UpdateSegmentAllocByCurrrevision(PoolIdType lid) {
     WriteLockGuard guard(segmentAllocLock_);
     if (segmentAlloc_.find(lid) != segmentAlloc_.end()) {
         segmentAlloc_[lid] += sumChangeUntilNow;
+        // 合并的变化都在curRevision_之后, 计算检查点时需要减去
+        for (auto &item : merged) {
+            recentChange_[lid][item.first] += item.second;
+        }
     }
 }
 
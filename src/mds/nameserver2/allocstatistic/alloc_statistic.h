@@ -31,6 +31,7 @@
 #include "src/mds/common/mds_define.h"
 #include "src/common/concurrent/concurrent.h"
 #include "src/common/interruptible_sleeper.h"
+#include "src/mds/nameserver2/allocstatistic/file_alloc_statistic.h"
 
 using ::curve::mds::topology::PoolIdType;
 using ::curve::common::Atomic;
@@ -61,6 +62,10 @@ using ::curve::kvstorage::EtcdClientImp;
  * 根据当前的统计状态给外部提供segment分配量:
  * 1. 如果part1部分全部完成，从mergeMap_中获取数据
  * 2. 如果part1部分未完成，从existSegmentAllocValues_中获取数据
+ *
+ * 检查点:
+ * 后台持久化时同时写入带revision的分配量检查点，mds启动或切换leader时
+ * 如果检查点可用，只需要回放检查点之后的segment变化，不再统计全部segment
  */
 class AllocStatistic {
  public:
@@ -77,6 +82,8 @@ class AllocStatistic {
         client_(client),
         currentValueAvalible_(false),
         segmentAllocFromEtcdOK_(false),
+        loadFromCheckpoint_(false),
+        lastRevision_(0),
         stop_(true),
         periodicPersistInterMs_(periodicPersistInterMs),
         retryInterMs_(retryInterMs) {}
@@ -89,6 +96,8 @@ class AllocStatistic {
      * @brief Init 从etcd中获取定期持久化的每个physical-pool对应的已分配的segment信息
      *             以及recycleBin中的信息
      *
+     *             检查点可用时回放检查点之后的变化，直接得到当前的分配量
+     *
      * @return 0-init成功 1-init失败
      */
     int Init();
@@ -134,6 +143,13 @@ class AllocStatistic {
     virtual void DeAllocSpace(
         PoolIdType, int64_t changeSize, int64_t revision);
 
+    /**
+     * @brief GetFileAllocStatistic 获取文件和目录维度的分配量统计
+     */
+    FileAllocStatistic* GetFileAllocStatistic() {
+        return &fileAllocStatistic_;
+    }
+
  private:
      /**
      * @brief CalculateSegmentAlloc 从etcd中获取指定revision的所有segment记录
@@ -146,6 +162,18 @@ class AllocStatistic {
      */
     void PeriodicPersist();
 
+    /**
+     * @brief LoadFromCheckpoint 从检查点加载分配量并回放之后的segment变化
+     *
+     * @return true表示加载成功，false表示需要统计全部segment
+     */
+    bool LoadFromCheckpoint();
+
+    /**
+     * @brief PersistCheckpoint 持久化lastRevision_对应的分配量检查点
+     */
+    void PersistCheckpoint();
+
      /**
      * @brief HandleResult
      *        用于处理获取指定revision的所有segment记录过程中发生错误的情况
@@ -203,6 +231,19 @@ class AllocStatistic {
     std::map<PoolIdType, std::map<int64_t, int64_t>> segmentChange_;
     RWLock segmentChangeLock_;
 
+    // 直接更新到segmentAlloc_中的变化, 用于计算检查点
+    // PoolIdType: poolId
+    // std::map<int64_t, int64_t> first表示版本, second表示变化量
+    // 由segmentAllocLock_保护
+    std::map<PoolIdType, std::map<int64_t, int64_t>> recentChange_;
+
+    // 是否通过检查点加载了分配量
+    bool loadFromCheckpoint_;
+
+    // 下一次持久化检查点使用的revision, 该revision之前的变化
+    // 都已经更新到segmentAlloc_中
+    int64_t lastRevision_;
+
     // segmentAlloc_中的值是否可以使用
     // 经过至少一次合并之后即可用
     Atomic<bool> currentValueAvalible_;
@@ -223,6 +264,9 @@ class AllocStatistic {
 
     // 统计指定revision下已分配segment大小的线程
     Thread calculateAlloc_;
+
+    // 文件和目录维度的分配量统计
+    FileAllocStatistic fileAllocStatistic_;
 };
 }  // namespace mds
 }  // namespace curve
@@ -33,8 +33,10 @@ namespace mds {
 
 using ::curve::common::SEGMENTALLOCSIZEKEYEND;
 using ::curve::common::SEGMENTALLOCSIZEKEY;
+using ::curve::common::SEGMENTALLOCCHECKPOINTKEY;
 using ::curve::common::SEGMENTINFOKEYPREFIX;
 using ::curve::common::SEGMENTINFOKEYEND;
+using ::curve::kvstorage::KVChange;
 
 const int GETBUNDLE = 1000;
 
@@ -119,5 +121,65 @@ int AllocStatisticHelper::CalculateSegmentAlloc(
               << " ms";
     return 0;
 }
+
+int AllocStatisticHelper::GetSegmentAllocCheckpoint(
+    const std::shared_ptr<EtcdClientImp> &client,
+    int64_t *revision, std::map<PoolIdType, int64_t> *out) {
+    std::string value;
+    int res = client->Get(SEGMENTALLOCCHECKPOINTKEY, &value);
+    if (res != EtcdErrCode::EtcdOK) {
+        LOG(INFO) << "get segment alloc checkpoint fail, errCode: " << res;
+        return -1;
+    }
+
+    if (!NameSpaceStorageCodec::DecodeSegmentAllocCheckpoint(
+        value, revision, out)) {
+        LOG(ERROR) << "decode segment alloc checkpoint: " << value << " fail";
+        return -1;
+    }
+    return 0;
+}
+
+int AllocStatisticHelper::ReplaySegmentChanges(
+    int64_t startRevision, int64_t endRevision,
+    const std::shared_ptr<EtcdClientImp> &client,
+    std::map<PoolIdType, int64_t> *out) {
+    std::vector<KVChange> changes;
+    int res = client->ListChanges(SEGMENTINFOKEYPREFIX, SEGMENTINFOKEYEND,
+        startRevision, endRevision, &changes);
+    if (res != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "list segment changes in (" << startRevision << ", "
+                   << endRevision << "] fail, errCode: " << res;
+        return -1;
+    }
+
+    for (auto &change : changes) {
+        PageFileSegment segment;
+        // segment被覆盖或删除时减去旧的分配量
+        if (!change.prevValue.empty()) {
+            if (!NameSpaceStorageCodec::DecodeSegment(
+                change.prevValue, &segment)) {
+                LOG(ERROR) << "decode segment item{"
+                           << change.prevValue << "} fail";
+                return -1;
+            }
+            (*out)[segment.logicalpoolid()] -= segment.segmentsize();
+        }
+
+        if (change.type == OpType::OpPut) {
+            if (!NameSpaceStorageCodec::DecodeSegment(
+                change.value, &segment)) {
+                LOG(ERROR) << "decode segment item{"
+                           << change.value << "} fail";
+                return -1;
+            }
+            (*out)[segment.logicalpoolid()] += segment.segmentsize();
+        }
+    }
+
+    LOG(INFO) << "replay " << changes.size() << " segment changes in ("
+              << startRevision << ", " << endRevision << "] ok";
+    return 0;
+}
 }  // namespace mds
 }  // namespace curve
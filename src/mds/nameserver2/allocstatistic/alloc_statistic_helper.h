@@ -45,6 +45,17 @@ class AllocStatisticHelper {
     static int CalculateSegmentAlloc(
         int64_t revision, const std::shared_ptr<EtcdClientImp> &client,
         std::map<PoolIdType, int64_t> *out);
+
+    // 获取分配量检查点及其对应的revision, 检查点不存在或解析失败返回-1
+    static int GetSegmentAllocCheckpoint(
+        const std::shared_ptr<EtcdClientImp> &client,
+        int64_t *revision, std::map<PoolIdType, int64_t> *out);
+
+    // 在out的基础上回放(startRevision, endRevision]之间segment的变化
+    static int ReplaySegmentChanges(
+        int64_t startRevision, int64_t endRevision,
+        const std::shared_ptr<EtcdClientImp> &client,
+        std::map<PoolIdType, int64_t> *out);
 };
 }  // namespace mds
 }  // namespace curve
@@ -0,0 +1,189 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include "src/mds/nameserver2/allocstatistic/file_alloc_statistic.h"
+
+using ::curve::common::LockGuard;
+
+namespace curve {
+namespace mds {
+
+AllocatedSize& AllocatedSize::operator+=(const AllocatedSize& rhs) {
+    total += rhs.total;
+    for (const auto& item : rhs.allocSizeMap) {
+        allocSizeMap[item.first] += item.second;
+    }
+    return *this;
+}
+
+static void ApplyChange(AllocatedSize *allocSize,
+                        PoolIdType lid, int64_t change) {
+    allocSize->total += change;
+    allocSize->allocSizeMap[lid] += change;
+    if (allocSize->allocSizeMap[lid] == 0) {
+        allocSize->allocSizeMap.erase(lid);
+    }
+}
+
+bool FileAllocStatistic::GetFileAlloc(InodeID id, AllocatedSize *allocSize) {
+    LockGuard guard(fileAllocLock_);
+    auto iter = fileAlloc_.find(id);
+    if (iter == fileAlloc_.end()) {
+        return false;
+    }
+
+    *allocSize = iter->second;
+    return true;
+}
+
+void FileAllocStatistic::LoadFileAlloc(InodeID id,
+                                       const AllocatedSize &allocSize) {
+    LockGuard guard(fileAllocLock_);
+    if (fileAlloc_.size() >= maxFileNum_ &&
+        fileAlloc_.find(id) == fileAlloc_.end()) {
+        // 被淘汰的文件下次查询时重新加载
+        fileAlloc_.erase(fileAlloc_.begin());
+    }
+    fileAlloc_[id] = allocSize;
+}
+
+void FileAllocStatistic::AllocSpace(InodeID id, InodeID parentId,
+                                    PoolIdType lid, uint64_t size) {
+    UpdateAlloc(id, parentId, lid, static_cast<int64_t>(size));
+}
+
+void FileAllocStatistic::DeAllocSpace(InodeID id, InodeID parentId,
+                                      PoolIdType lid, uint64_t size) {
+    UpdateAlloc(id, parentId, lid, 0L - static_cast<int64_t>(size));
+}
+
+void FileAllocStatistic::RemoveFile(InodeID id) {
+    LockGuard guard(fileAllocLock_);
+    fileAlloc_.erase(id);
+}
+
+void FileAllocStatistic::UpdateAlloc(InodeID id, InodeID parentId,
+                                     PoolIdType lid, int64_t change) {
+    {
+        LockGuard guard(fileAllocLock_);
+        auto iter = fileAlloc_.find(id);
+        if (iter != fileAlloc_.end()) {
+            ApplyChange(&iter->second, lid, change);
+        }
+    }
+
+    // 目录缓存的分配量包含其下所有子目录，所以某一级目录未缓存时，
+    // 其上各级目录也不会被缓存，更新到第一个未缓存的目录为止
+    LockGuard guard(dirAllocLock_);
+    InodeID cur = parentId;
+    while (true) {
+        auto iter = dirAlloc_.find(cur);
+        if (iter == dirAlloc_.end()) {
+            // 可能有正在计算的目录包含该文件，使其计算结果不缓存
+            ++dirVersion_;
+            break;
+        }
+
+        ApplyChange(&iter->second.allocSize, lid, change);
+        if (cur == ROOTINODEID || iter->second.parentId == cur) {
+            break;
+        }
+        cur = iter->second.parentId;
+    }
+}
+
+bool FileAllocStatistic::GetDirAlloc(InodeID id, AllocatedSize *allocSize) {
+    LockGuard guard(dirAllocLock_);
+    auto iter = dirAlloc_.find(id);
+    if (iter == dirAlloc_.end()) {
+        return false;
+    }
+
+    *allocSize = iter->second.allocSize;
+    return true;
+}
+
+uint64_t FileAllocStatistic::GetDirVersion() {
+    LockGuard guard(dirAllocLock_);
+    return dirVersion_;
+}
+
+void FileAllocStatistic::PutDirAlloc(InodeID id, InodeID parentId,
+                                     const AllocatedSize &allocSize,
+                                     uint64_t version) {
+    LockGuard guard(dirAllocLock_);
+    if (version != dirVersion_) {
+        return;
+    }
+    PutDirEntry(id, parentId, allocSize);
+}
+
+void FileAllocStatistic::AddDir(InodeID id, InodeID parentId) {
+    LockGuard guard(dirAllocLock_);
+    if (dirAlloc_.find(parentId) == dirAlloc_.end()) {
+        // 可能有正在计算的目录没有读到新目录，使其计算结果不缓存
+        ++dirVersion_;
+        return;
+    }
+    PutDirEntry(id, parentId, AllocatedSize());
+}
+
+void FileAllocStatistic::PutDirEntry(InodeID id, InodeID parentId,
+                                     const AllocatedSize &allocSize) {
+    if (dirAlloc_.size() >= maxDirNum_ &&
+        dirAlloc_.find(id) == dirAlloc_.end()) {
+        // 只淘汰部分目录会使已缓存目录的子目录未缓存，所以全部清空，
+        // 正在计算的上级目录也不再缓存
+        dirAlloc_.clear();
+        ++dirVersion_;
+        return;
+    }
+
+    DirEntry entry;
+    entry.parentId = parentId;
+    entry.allocSize = allocSize;
+    dirAlloc_[id] = entry;
+}
+
+void FileAllocStatistic::InvalidateDir(InodeID id) {
+    // 已缓存目录的各级子目录都已缓存，所以只需移除该目录及其上各级目录，
+    // 遇到未缓存的目录即可停止
+    LockGuard guard(dirAllocLock_);
+    InodeID cur = id;
+    while (true) {
+        auto iter = dirAlloc_.find(cur);
+        if (iter == dirAlloc_.end()) {
+            break;
+        }
+
+        InodeID parentId = iter->second.parentId;
+        dirAlloc_.erase(iter);
+        if (cur == ROOTINODEID || parentId == cur) {
+            break;
+        }
+        cur = parentId;
+    }
+    // 正在计算的目录可能读到了变化之前的目录结构，使其计算结果不缓存
+    ++dirVersion_;
+}
+
+}  // namespace mds
+}  // namespace curve
@@ -0,0 +1,214 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#ifndef SRC_MDS_NAMESERVER2_ALLOCSTATISTIC_FILE_ALLOC_STATISTIC_H_
+#define SRC_MDS_NAMESERVER2_ALLOCSTATISTIC_FILE_ALLOC_STATISTIC_H_
+
+#include <string>
+#include <unordered_map>
+#include "src/mds/common/mds_define.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/concurrent/name_lock.h"
+
+using ::curve::mds::topology::PoolIdType;
+
+namespace curve {
+namespace mds {
+
+struct AllocatedSize {
+    // mds给文件分配的segment的大小
+    uint64_t total;
+    // 在每个池子里的分配大小
+    std::unordered_map<PoolIdType, uint64_t> allocSizeMap;
+    AllocatedSize() : total(0) {}
+    AllocatedSize& operator+=(const AllocatedSize& rhs);
+};
+
+/**
+ * FileAllocStatistic 在内存中维护文件和目录的已分配segment大小
+ *
+ * 文件:
+ *   文件的分配量与segment在同一个etcd事务中持久化，第一次使用时从etcd加载，
+ *   之后由segment的分配和删除增量更新。
+ *   加载和segment的分配、删除都需要持有该文件的锁(GetFileLock)，
+ *   保证加载过程中不会漏掉或重复统计segment的变化
+ * 目录:
+ *   目录的分配量为目录下所有文件和子目录分配量之和，计算后缓存，
+ *   文件分配量变化时沿着父目录向上更新已缓存的目录。
+ *   目录被缓存时其下的各级子目录也都已缓存，新建目录时如果父目录已缓存，
+ *   新目录以0缓存，因此向上更新时遇到未缓存的目录即可停止。
+ *   目录结构变化(rename、删除目录等)时，变化路径上已缓存的各级目录失效。
+ *   计算目录分配量的过程中如果有分配量变化，则本次结果不缓存
+ * 缓存数量:
+ *   文件数量达到上限时淘汰任意一个文件，下次查询时重新加载；
+ *   目录数量达到上限时清空目录缓存，保证上述目录缓存的约束
+ */
+class FileAllocStatistic {
+ public:
+    explicit FileAllocStatistic(
+        uint64_t maxFileNum = kDefaultMaxFileAllocNum,
+        uint64_t maxDirNum = kDefaultMaxDirAllocNum)
+        : maxFileNum_(maxFileNum), maxDirNum_(maxDirNum), dirVersion_(0) {}
+
+    /**
+     * @brief 获取文件的分配量
+     *
+     * @param[in] id 文件的inodeid
+     * @param[out] allocSize 文件的分配量
+     *
+     * @return true表示获取成功，false表示文件的分配量还未加载
+     */
+    bool GetFileAlloc(InodeID id, AllocatedSize *allocSize);
+
+    /**
+     * @brief 加载文件的分配量，调用方需持有文件的锁
+     *
+     * @param[in] id 文件的inodeid
+     * @param[in] allocSize 通过ListSegment统计的分配量
+     */
+    void LoadFileAlloc(InodeID id, const AllocatedSize &allocSize);
+
+    /**
+     * @brief segment分配后更新文件及其所在目录的分配量，调用方需持有文件的锁
+     *
+     * @param[in] id 文件的inodeid
+     * @param[in] parentId 文件所在目录的inodeid
+     * @param[in] lid segment所在的逻辑池
+     * @param[in] size segment大小
+     */
+    void AllocSpace(InodeID id, InodeID parentId,
+                    PoolIdType lid, uint64_t size);
+
+    /**
+     * @brief segment删除后更新文件及其所在目录的分配量，调用方需持有文件的锁
+     *
+     * @param[in] id 文件的inodeid
+     * @param[in] parentId 文件所在目录的inodeid
+     * @param[in] lid segment所在的逻辑池
+     * @param[in] size segment大小
+     */
+    void DeAllocSpace(InodeID id, InodeID parentId,
+                      PoolIdType lid, uint64_t size);
+
+    /**
+     * @brief 文件删除后移除文件的分配量
+     *
+     * @param[in] id 文件的inodeid
+     */
+    void RemoveFile(InodeID id);
+
+    /**
+     * @brief 获取目录的分配量
+     *
+     * @param[in] id 目录的inodeid
+     * @param[out] allocSize 目录的分配量
+     *
+     * @return true表示获取成功，false表示目录的分配量未缓存
+     */
+    bool GetDirAlloc(InodeID id, AllocatedSize *allocSize);
+
+    /**
+     * @brief 获取目录缓存的版本，计算目录分配量之前获取
+     */
+    uint64_t GetDirVersion();
+
+    /**
+     * @brief 缓存目录的分配量，如果计算过程中版本发生了变化则不缓存
+     *
+     * @param[in] id 目录的inodeid
+     * @param[in] parentId 目录的父目录inodeid
+     * @param[in] allocSize 目录的分配量
+     * @param[in] version 开始计算时的目录缓存版本
+     */
+    void PutDirAlloc(InodeID id, InodeID parentId,
+                     const AllocatedSize &allocSize, uint64_t version);
+
+    /**
+     * @brief 新建目录后调用，父目录已缓存时新目录以0缓存
+     *
+     * @param[in] id 新目录的inodeid
+     * @param[in] parentId 新目录的父目录inodeid
+     */
+    void AddDir(InodeID id, InodeID parentId);
+
+    /**
+     * @brief 目录结构发生变化时，使该目录及其已缓存的各级父目录失效
+     *
+     * @param[in] id 发生变化的目录的inodeid
+     */
+    void InvalidateDir(InodeID id);
+
+    /**
+     * @brief 获取文件锁，加载和更新文件分配量时使用
+     *        加锁的key通过FileLockKey获取
+     */
+    ::curve::common::NameLock& GetFileLock() {
+        return fileLock_;
+    }
+
+    static std::string FileLockKey(InodeID id) {
+        return std::to_string(id);
+    }
+
+    static const uint64_t kDefaultMaxFileAllocNum = 1000000;
+    static const uint64_t kDefaultMaxDirAllocNum = 100000;
+
+ private:
+    struct DirEntry {
+        InodeID parentId;
+        AllocatedSize allocSize;
+    };
+
+    /**
+     * @brief 更新文件及已缓存的各级父目录的分配量
+     */
+    void UpdateAlloc(InodeID id, InodeID parentId,
+                     PoolIdType lid, int64_t change);
+
+    /**
+     * @brief 缓存目录的分配量，需持有dirAllocLock_
+     */
+    void PutDirEntry(InodeID id, InodeID parentId,
+                     const AllocatedSize &allocSize);
+
+ private:
+    // 缓存的文件和目录数量上限
+    uint64_t maxFileNum_;
+    uint64_t maxDirNum_;
+
+    // 已加载的文件分配量
+    std::unordered_map<InodeID, AllocatedSize> fileAlloc_;
+    ::curve::common::Mutex fileAllocLock_;
+
+    // 已缓存的目录分配量
+    std::unordered_map<InodeID, DirEntry> dirAlloc_;
+    // 目录缓存的版本，分配量变化或目录结构变化时递增
+    uint64_t dirVersion_;
+    ::curve::common::Mutex dirAllocLock_;
+
+    // 文件锁，保证文件分配量加载和更新的一致性
+    ::curve::common::NameLock fileLock_;
+};
+
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_NAMESERVER2_ALLOCSTATISTIC_FILE_ALLOC_STATISTIC_H_
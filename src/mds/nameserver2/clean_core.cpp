@@ -20,10 +20,85 @@
  * Author: hzsunjianliang
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  //NOLINT
+#include <map>
+#include <thread>  //NOLINT
+
 #include "src/mds/nameserver2/clean_core.h"
+#include "src/common/concurrent/count_down_event.h"
+#include "src/common/timeutility.h"
+
+using ::curve::common::NameLockGuard;
+using ::curve::common::CountDownEvent;
+using ::curve::common::TimeUtility;
+using ::curve::mds::topology::CopySetKey;
 
 namespace curve {
 namespace mds {
+
+// 每轮处理的segment数，同一轮内同一复制组的chunk合并为一批删除
+static const uint32_t kSegmentNumPerRound = 16;
+
+CleanCore::CleanCore(std::shared_ptr<NameServerStorage> storage,
+    std::shared_ptr<CopysetClient> copysetClient,
+    std::shared_ptr<AllocStatistic> allocStatistic,
+    const CleanCoreOption &option)
+    : storage_(storage),
+      copysetClient_(copysetClient),
+      allocStatistic_(allocStatistic) {
+    deletePool_.Start(std::max(option.deleteChunkConcurrency, 1u));
+    deleteLimiter_.SetLimit(option.deleteChunkLimitPerSecond,
+                            option.deleteChunkLimitPerSecond);
+}
+
+CleanCore::~CleanCore() {
+    deletePool_.Stop();
+}
+
+int CleanCore::DeleteChunksInSegments(
+    const std::vector<PageFileSegment> &segments,
+    const DeleteChunksFunc &deleteFunc) {
+    std::map<CopySetKey, std::vector<ChunkID>> batches;
+    for (const auto &segment : segments) {
+        for (const auto &chunk : segment.chunks()) {
+            batches[CopySetKey(segment.logicalpoolid(), chunk.copysetid())]
+                .push_back(chunk.chunkid());
+        }
+    }
+    if (batches.empty()) {
+        return 0;
+    }
+
+    std::atomic<int> result(0);
+    CountDownEvent done(batches.size());
+    for (const auto &batch : batches) {
+        const CopySetKey *key = &batch.first;
+        const std::vector<ChunkID> *chunkIds = &batch.second;
+        deletePool_.Enqueue([&, key, chunkIds]() {
+            // 已经有批次失败时不再继续删除，尽快返回错误
+            if (result.load() == 0) {
+                uint64_t waitUs = deleteLimiter_.Acquire(chunkIds->size(),
+                    TimeUtility::GetTimeofDayUs());
+                if (waitUs > 0) {
+                    std::this_thread::sleep_for(
+                        std::chrono::microseconds(waitUs));
+                }
+
+                int ret = deleteFunc(key->first, key->second, *chunkIds);
+                if (ret != 0) {
+                    int expected = 0;
+                    result.compare_exchange_strong(expected, ret);
+                }
+            }
+            done.Signal();
+        });
+    }
+    done.Wait();
+    return result.load();
+}
+
 StatusCode CleanCore::CleanSnapShotFile(const FileInfo & fileInfo,
                                         TaskProgress* progress) {
     if (fileInfo.segmentsize() == 0) {
@@ -32,49 +107,52 @@ StatusCode CleanCore::CleanSnapShotFile(const FileInfo & fileInfo,
     }
     uint32_t  segmentNum = fileInfo.length() / fileInfo.segmentsize();
     uint64_t segmentSize = fileInfo.segmentsize();
-    for (uint32_t i = 0; i < segmentNum; i++) {
-        // load  segment
-        PageFileSegment segment;
-        StoreStatus storeRet = storage_->GetSegment(fileInfo.parentid(),
-                                                    i * segmentSize,
-                                                    &segment);
-        if (storeRet == StoreStatus::KeyNotExist) {
-            continue;
-        } else if (storeRet !=  StoreStatus::OK) {
-            LOG(ERROR) << "cleanSnapShot File Error: "
-            << "GetSegment Error, inodeid = " << fileInfo.id()
-            << ", filename = " << fileInfo.filename()
-            << ", offset = " << i * segmentSize
-            << ", sequenceNum = " << fileInfo.seqnum();
-            progress->SetStatus(TaskStatus::FAILED);
-            return StatusCode::kSnapshotFileDeleteError;
-        }
-
-        // delete chunks in chunkserver
-        LogicalPoolID logicalPoolID = segment.logicalpoolid();
-        uint32_t chunkNum = segment.chunks_size();
-        for (uint32_t j = 0; j != chunkNum; j++) {
-            // 删除快照时如果chunk不存在快照，则需要修改chunk的correctedSn
-            // 防止删除快照后，后续的写触发chunk的快照
-            // correctSn为创建快照后文件的版本号，也就是快照版本号+1
-            SeqNum correctSn = fileInfo.seqnum() + 1;
-            int ret = copysetClient_->DeleteChunkSnapshotOrCorrectSn(
-                logicalPoolID,
-                segment.chunks()[j].copysetid(),
-                segment.chunks()[j].chunkid(),
-                correctSn);
-            if (ret != 0) {
-                LOG(ERROR) << "CleanSnapShotFile Error: "
-                    << "DeleteChunkSnapshotOrCorrectSn Error"
-                    << ", ret = " << ret
-                    << ", inodeid = " << fileInfo.id()
-                    << ", filename = " << fileInfo.filename()
-                    << ", correctSn = " << correctSn;
+    for (uint32_t begin = 0; begin < segmentNum;
+         begin += kSegmentNumPerRound) {
+        uint32_t end = std::min(segmentNum, begin + kSegmentNumPerRound);
+        std::vector<PageFileSegment> segments;
+        for (uint32_t i = begin; i < end; i++) {
+            // load  segment
+            PageFileSegment segment;
+            StoreStatus storeRet = storage_->GetSegment(fileInfo.parentid(),
+                                                        i * segmentSize,
+                                                        &segment);
+            if (storeRet == StoreStatus::KeyNotExist) {
+                continue;
+            } else if (storeRet !=  StoreStatus::OK) {
+                LOG(ERROR) << "cleanSnapShot File Error: "
+                << "GetSegment Error, inodeid = " << fileInfo.id()
+                << ", filename = " << fileInfo.filename()
+                << ", offset = " << i * segmentSize
+                << ", sequenceNum = " << fileInfo.seqnum();
                 progress->SetStatus(TaskStatus::FAILED);
                 return StatusCode::kSnapshotFileDeleteError;
             }
+            segments.emplace_back(std::move(segment));
+        }
+
+        // delete chunks in chunkserver
+        // 删除快照时如果chunk不存在快照，则需要修改chunk的correctedSn
+        // 防止删除快照后，后续的写触发chunk的快照
+        // correctSn为创建快照后文件的版本号，也就是快照版本号+1
+        SeqNum correctSn = fileInfo.seqnum() + 1;
+        int ret = DeleteChunksInSegments(segments,
+            [&](LogicalPoolID logicalPoolID, CopysetID copysetId,
+                const std::vector<ChunkID> &chunkIds) {
+                return copysetClient_->DeleteChunkSnapshotsOrCorrectSn(
+                    logicalPoolID, copysetId, chunkIds, correctSn);
+            });
+        if (ret != 0) {
+            LOG(ERROR) << "CleanSnapShotFile Error: "
+                << "DeleteChunkSnapshotOrCorrectSn Error"
+                << ", ret = " << ret
+                << ", inodeid = " << fileInfo.id()
+                << ", filename = " << fileInfo.filename()
+                << ", correctSn = " << correctSn;
+            progress->SetStatus(TaskStatus::FAILED);
+            return StatusCode::kSnapshotFileDeleteError;
         }
-        progress->SetProgress(100 * (i+1) / segmentNum);
+        progress->SetProgress(100 * end / segmentNum);
     }
 
     // delete the storage
@@ -102,61 +180,102 @@ StatusCode CleanCore::CleanFile(const FileInfo & commonFile,
         return StatusCode::KInternalError;
     }
 
-    int  segmentNum = commonFile.length() / commonFile.segmentsize();
+    uint32_t segmentNum = commonFile.length() / commonFile.segmentsize();
     uint64_t segmentSize = commonFile.segmentsize();
-    for (int i = 0; i != segmentNum; i++) {
-        // load  segment
-        PageFileSegment segment;
-        StoreStatus storeRet = storage_->GetSegment(commonFile.id(),
-                                    i * segmentSize, &segment);
-        if (storeRet == StoreStatus::KeyNotExist) {
-            continue;
-        } else if (storeRet !=  StoreStatus::OK) {
-            LOG(ERROR) << "Clean common File Error: "
-                << "GetSegment Error, inodeid = " << commonFile.id()
-                << ", filename = " << commonFile.filename()
-                << ", offset = " << i * segmentSize;
-            progress->SetStatus(TaskStatus::FAILED);
-            return StatusCode::kCommonFileDeleteError;
-        }
-
-        // delete chunks in chunkserver
-        LogicalPoolID logicalPoolID = segment.logicalpoolid();
-        uint32_t chunkNum = segment.chunks_size();
-        for (uint32_t j = 0; j != chunkNum; j++) {
-            SeqNum seq = commonFile.seqnum();
-            int ret = copysetClient_->DeleteChunk(logicalPoolID,
-                segment.chunks()[j].copysetid(),
-                segment.chunks()[j].chunkid(),
-                seq);
-            if (ret != 0) {
+    for (uint32_t begin = 0; begin < segmentNum;
+         begin += kSegmentNumPerRound) {
+        uint32_t end = std::min(segmentNum, begin + kSegmentNumPerRound);
+        std::vector<PageFileSegment> segments;
+        std::vector<uint64_t> offsets;
+        for (uint32_t i = begin; i < end; i++) {
+            // load  segment
+            PageFileSegment segment;
+            StoreStatus storeRet = storage_->GetSegment(commonFile.id(),
+                                        i * segmentSize, &segment);
+            if (storeRet == StoreStatus::KeyNotExist) {
+                continue;
+            } else if (storeRet !=  StoreStatus::OK) {
                 LOG(ERROR) << "Clean common File Error: "
-                    << "DeleteChunk Error"
-                    << ", ret = " << ret
-                    << ", inodeid = " << commonFile.id()
+                    << "GetSegment Error, inodeid = " << commonFile.id()
                     << ", filename = " << commonFile.filename()
-                    << ", sequenceNum = " << seq;
+                    << ", offset = " << i * segmentSize;
                 progress->SetStatus(TaskStatus::FAILED);
                 return StatusCode::kCommonFileDeleteError;
             }
+            segments.emplace_back(std::move(segment));
+            offsets.push_back(i * segmentSize);
         }
 
-        // delete segment
-        int64_t revision;
-        storeRet = storage_->DeleteSegment(
-            commonFile.id(), i * segmentSize, &revision);
-        if (storeRet != StoreStatus::OK) {
+        // delete chunks in chunkserver
+        SeqNum seq = commonFile.seqnum();
+        int ret = DeleteChunksInSegments(segments,
+            [&](LogicalPoolID logicalPoolID, CopysetID copysetId,
+                const std::vector<ChunkID> &chunkIds) {
+                return copysetClient_->DeleteChunks(
+                    logicalPoolID, copysetId, chunkIds, seq);
+            });
+        if (ret != 0) {
             LOG(ERROR) << "Clean common File Error: "
-            << "DeleteSegment Error, inodeid = " << commonFile.id()
-            << ", filename = " << commonFile.filename()
-            << ", offset = " << i * segmentSize
-            << ", sequenceNum = " << commonFile.seqnum();
+                << "DeleteChunk Error"
+                << ", ret = " << ret
+                << ", inodeid = " << commonFile.id()
+                << ", filename = " << commonFile.filename()
+                << ", sequenceNum = " << seq;
             progress->SetStatus(TaskStatus::FAILED);
             return StatusCode::kCommonFileDeleteError;
         }
-        allocStatistic_->DeAllocSpace(segment.logicalpoolid(),
-            segment.segmentsize(), revision);
-        progress->SetProgress(100 * (i + 1) / segmentNum);
+
+        // delete segment
+        FileAllocStatistic* fileAllocStatistic =
+            allocStatistic_->GetFileAllocStatistic();
+        for (size_t k = 0; k < segments.size(); k++) {
+            const PageFileSegment &segment = segments[k];
+            NameLockGuard guard(fileAllocStatistic->GetFileLock(),
+                FileAllocStatistic::FileLockKey(commonFile.id()));
+            AllocatedSize fileAlloc;
+            if (!fileAllocStatistic->GetFileAlloc(commonFile.id(),
+                                                  &fileAlloc)) {
+                if (storage_->GetFileAlloc(commonFile.id(), &fileAlloc)
+                    != StoreStatus::OK) {
+                    LOG(ERROR) << "Clean common File Error: "
+                    << "GetFileAlloc Error, inodeid = " << commonFile.id()
+                    << ", filename = " << commonFile.filename();
+                    progress->SetStatus(TaskStatus::FAILED);
+                    return StatusCode::kCommonFileDeleteError;
+                }
+                fileAllocStatistic->LoadFileAlloc(commonFile.id(), fileAlloc);
+            }
+
+            // 文件的分配量与segment在同一个事务中持久化
+            auto iter = fileAlloc.allocSizeMap.find(segment.logicalpoolid());
+            if (iter != fileAlloc.allocSizeMap.end() &&
+                iter->second >= segment.segmentsize() &&
+                fileAlloc.total >= segment.segmentsize()) {
+                fileAlloc.total -= segment.segmentsize();
+                iter->second -= segment.segmentsize();
+                if (iter->second == 0) {
+                    fileAlloc.allocSizeMap.erase(iter);
+                }
+            }
+            int64_t revision;
+            StoreStatus storeRet = storage_->DeleteSegment(
+                commonFile.id(), offsets[k], fileAlloc, &revision);
+            if (storeRet != StoreStatus::OK) {
+                LOG(ERROR) << "Clean common File Error: "
+                << "DeleteSegment Error, inodeid = " << commonFile.id()
+                << ", filename = " << commonFile.filename()
+                << ", offset = " << offsets[k]
+                << ", sequenceNum = " << commonFile.seqnum();
+                progress->SetStatus(TaskStatus::FAILED);
+                return StatusCode::kCommonFileDeleteError;
+            }
+            allocStatistic_->DeAllocSpace(segment.logicalpoolid(),
+                segment.segmentsize(), revision);
+            fileAllocStatistic->DeAllocSpace(commonFile.id(),
+                commonFile.parentid(), segment.logicalpoolid(),
+                segment.segmentsize());
+        }
+        progress->SetProgress(100 * end / segmentNum);
     }
 
     // delete the storage
@@ -167,6 +286,7 @@ StatusCode CleanCore::CleanFile(const FileInfo & commonFile,
         progress->SetStatus(TaskStatus::FAILED);
         return StatusCode::kCommonFileDeleteError;
     } else {
+        allocStatistic_->GetFileAllocStatistic()->RemoveFile(commonFile.id());
         LOG(INFO) << "inodeid = " << commonFile.id()
             << ", filename = " << commonFile.filename()
             << ", seq = " << commonFile.seqnum() << ", deleted";
@@ -23,13 +23,17 @@
 #ifndef SRC_MDS_NAMESERVER2_CLEAN_CORE_H_
 #define SRC_MDS_NAMESERVER2_CLEAN_CORE_H_
 
+#include <functional>
 #include <memory>
+#include <vector>
 #include "src/mds/nameserver2/namespace_storage.h"
 #include "src/mds/common/mds_define.h"
 #include "src/mds/nameserver2/task_progress.h"
 #include "src/mds/chunkserverclient/copyset_client.h"
 #include "src/mds/topology/topology.h"
 #include "src/mds/nameserver2/allocstatistic/alloc_statistic.h"
+#include "src/common/concurrent/task_thread_pool.h"
+#include "src/common/throttle.h"
 
 using ::curve::mds::chunkserverclient::CopysetClient;
 using ::curve::mds::topology::Topology;
@@ -37,14 +41,29 @@ using ::curve::mds::topology::Topology;
 namespace curve {
 namespace mds {
 
+struct CleanCoreOption {
+    // 并发删除chunk的线程数，所有清理任务共享
+    uint32_t deleteChunkConcurrency;
+    // 每秒最多删除的chunk数，为0表示不限制
+    uint64_t deleteChunkLimitPerSecond;
+    CleanCoreOption()
+        : deleteChunkConcurrency(8),
+          deleteChunkLimitPerSecond(0) {}
+};
+
+/**
+ * 文件和快照的chunk删除：每轮读取一批segment，
+ * 将其中的chunk按复制组分组后由线程池并发删除，
+ * 同一复制组的chunk只查询一次leader，删除速率由令牌桶限制
+ */
 class CleanCore {
  public:
     CleanCore(std::shared_ptr<NameServerStorage> storage,
         std::shared_ptr<CopysetClient> copysetClient,
-        std::shared_ptr<AllocStatistic> allocStatistic)
-        : storage_(storage),
-          copysetClient_(copysetClient),
-          allocStatistic_(allocStatistic) {}
+        std::shared_ptr<AllocStatistic> allocStatistic,
+        const CleanCoreOption &option = CleanCoreOption());
+
+    ~CleanCore();
 
     /**
      * @brief 删除快照文件，更新task状态
@@ -65,10 +84,28 @@ class CleanCore {
     StatusCode CleanFile(const FileInfo & commonFile,
                         TaskProgress* progress);
 
+ private:
+    using DeleteChunksFunc = std::function<int(LogicalPoolID,
+        CopysetID, const std::vector<ChunkID> &)>;
+
+    /**
+     * @brief 按复制组分组并发删除segment中的chunk
+     * @param segments: 需要删除chunk的segment
+     * @param deleteFunc: 删除一个复制组内的一批chunk
+     * @return 全部删除成功返回0，否则返回失败的错误码
+     */
+    int DeleteChunksInSegments(const std::vector<PageFileSegment> &segments,
+                               const DeleteChunksFunc &deleteFunc);
+
  private:
     std::shared_ptr<NameServerStorage> storage_;
     std::shared_ptr<CopysetClient> copysetClient_;
     std::shared_ptr<AllocStatistic> allocStatistic_;
+
+    // 并发删除chunk的线程池
+    ::curve::common::TaskThreadPool deletePool_;
+    // 删除chunk的速率限制
+    ::curve::common::TokenBucket deleteLimiter_;
 };
 
 }  // namespace mds
@@ -33,6 +33,7 @@
 #include "src/mds/common/mds_define.h"
 
 using curve::common::TimeUtility;
+using curve::common::NameLockGuard;
 using ::std::chrono::steady_clock;
 using ::std::chrono::microseconds;
 using curve::mds::topology::LogicalPool;
@@ -101,6 +102,8 @@ bool CurveFS::Init(std::shared_ptr<NameServerStorage> storage,
 
     defaultChunkSize_ = curveFSOptions.defaultChunkSize;
     topology_ = topology;
+    dentryCache_ =
+        std::make_shared<DentryCache>(curveFSOptions.dentryCacheSize);
 
     InitRootFile();
     bool ret = InitRecycleBinDir();
@@ -126,6 +129,7 @@ void CurveFS::Uninit() {
     cleanManager_ = nullptr;
     allocStatistic_ = nullptr;
     fileRecordManager_ = nullptr;
+    dentryCache_ = nullptr;
 }
 
 void CurveFS::InitRootFile(void) {
@@ -135,6 +139,16 @@ void CurveFS::InitRootFile(void) {
     rootFileInfo_.set_owner(GetRootOwner());
 }
 
+// 把路径的前count级拼接为目录缓存的key，如"/dir1/dir2"
+static std::string JoinPath(const std::vector<std::string> &paths,
+                            size_t count) {
+    std::string path;
+    for (size_t i = 0; i < count; i++) {
+        path += "/" + paths[i];
+    }
+    return path;
+}
+
 StatusCode CurveFS::WalkPath(const std::string &fileName,
                         FileInfo *fileInfo, std::string  *lastEntry) const  {
     assert(lastEntry != nullptr);
@@ -150,6 +164,13 @@ StatusCode CurveFS::WalkPath(const std::string &fileName,
     *lastEntry = paths.back();
     uint64_t parentID = rootFileInfo_.id();
 
+    // 父目录已缓存时不需要逐级查找
+    if (paths.size() > 1 &&
+        dentryCache_->Get(JoinPath(paths, paths.size() - 1), fileInfo)) {
+        return StatusCode::kOK;
+    }
+
+    std::string path;
     for (uint32_t i = 0; i < paths.size() - 1; i++) {
         auto ret = storage_->GetFile(parentID, paths[i], fileInfo);
 
@@ -166,11 +187,19 @@ StatusCode CurveFS::WalkPath(const std::string &fileName,
         }
         // assert(fileInfo->parentid() != parentID);
         parentID =  fileInfo->id();
+        path += "/" + paths[i];
+        dentryCache_->Put(path, *fileInfo);
     }
     return StatusCode::kOK;
 }
 
 
+void CurveFS::RemoveDentryCache(const std::string &fileName) {
+    std::vector<std::string> paths;
+    ::curve::common::SplitString(fileName, "/", &paths);
+    dentryCache_->Remove(JoinPath(paths, paths.size()));
+}
+
 StatusCode CurveFS::LookUpFile(const FileInfo & parentFileInfo,
                     const std::string &fileName, FileInfo *fileInfo) const {
     assert(fileInfo != nullptr);
@@ -278,6 +307,10 @@ StatusCode CurveFS::CreateFile(const std::string & fileName,
         fileInfo.set_filestatus(FileStatus::kFileCreated);
 
         ret = PutFile(fileInfo);
+        if (ret == StatusCode::kOK && filetype == FileType::INODE_DIRECTORY) {
+            allocStatistic_->GetFileAllocStatistic()->AddDir(
+                inodeID, parentFileInfo.id());
+        }
         return ret;
     }
 }
@@ -302,14 +335,6 @@ StatusCode CurveFS::GetFileInfo(const std::string & filename,
     }
 }
 
-AllocatedSize& AllocatedSize::operator+=(const AllocatedSize& rhs) {
-    total += rhs.total;
-    for (const auto& item : rhs.allocSizeMap) {
-        allocSizeMap[item.first] += item.second;
-    }
-    return *this;
-}
-
 StatusCode CurveFS::GetAllocatedSize(const std::string& fileName,
                                      AllocatedSize* allocatedSize) {
     assert(allocatedSize != nullptr);
@@ -344,29 +369,52 @@ StatusCode CurveFS::GetAllocatedSize(const std::string& fileName,
 StatusCode CurveFS::GetFileAllocSize(const std::string& fileName,
                                      const FileInfo& fileInfo,
                                      AllocatedSize* allocSize) {
-    std::vector<PageFileSegment> segments;
-    auto listSegmentRet = storage_->ListSegment(fileInfo.id(), &segments);
+    // 文件的分配量已经加载，直接从内存中获取
+    FileAllocStatistic* fileAllocStatistic =
+        allocStatistic_->GetFileAllocStatistic();
+    if (fileAllocStatistic->GetFileAlloc(fileInfo.id(), allocSize)) {
+        return StatusCode::kOK;
+    }
 
-    if (listSegmentRet != StoreStatus::OK) {
-        return StatusCode::kStorageError;
+    // 加载过程中持有文件锁，期间不会有segment的分配和删除
+    NameLockGuard guard(fileAllocStatistic->GetFileLock(),
+                        FileAllocStatistic::FileLockKey(fileInfo.id()));
+    return LoadFileAllocSize(fileInfo.id(), allocSize);
+}
+
+StatusCode CurveFS::LoadFileAllocSize(InodeID id, AllocatedSize* allocSize) {
+    FileAllocStatistic* fileAllocStatistic =
+        allocStatistic_->GetFileAllocStatistic();
+    if (fileAllocStatistic->GetFileAlloc(id, allocSize)) {
+        return StatusCode::kOK;
     }
-    for (const auto& segment : segments) {
-        const auto & poolId = segment.logicalpoolid();
-        allocSize->allocSizeMap[poolId] += fileInfo.segmentsize();
+
+    if (storage_->GetFileAlloc(id, allocSize) != StoreStatus::OK) {
+        LOG(ERROR) << "GetFileAlloc fail, inodeid = " << id;
+        return StatusCode::kStorageError;
     }
-    allocSize->total = fileInfo.segmentsize() * segments.size();
+    fileAllocStatistic->LoadFileAlloc(id, *allocSize);
     return StatusCode::kOK;
 }
 
 StatusCode CurveFS::GetDirAllocSize(const std::string& fileName,
                                     const FileInfo& fileInfo,
                                     AllocatedSize* allocSize) {
+    FileAllocStatistic* fileAllocStatistic =
+        allocStatistic_->GetFileAllocStatistic();
+    if (fileAllocStatistic->GetDirAlloc(fileInfo.id(), allocSize)) {
+        return StatusCode::kOK;
+    }
+
+    // 计算之前获取目录缓存版本，计算期间目录下有分配量变化则不缓存
+    uint64_t version = fileAllocStatistic->GetDirVersion();
     std::vector<FileInfo> files;
     StatusCode ret = ReadDir(fileName, &files);
     if (ret != StatusCode::kOK) {
         LOG(ERROR) << "ReadDir Fail, fileName: " << fileName;
         return ret;
     }
+    bool complete = true;
     for (const auto& file : files) {
         std::string fullPathName;
         if (fileName == "/") {
@@ -378,10 +426,16 @@ StatusCode CurveFS::GetDirAllocSize(const std::string& fileName,
         if (GetAllocatedSize(fullPathName, file, &size) != 0) {
             std::cout << "Get allocated size of " << fullPathName
                       << " fail!" << std::endl;
+            complete = false;
             continue;
         }
         *allocSize += size;
     }
+
+    if (complete) {
+        fileAllocStatistic->PutDirAlloc(fileInfo.id(), fileInfo.parentid(),
+                                        *allocSize, version);
+    }
     return StatusCode::kOK;
 }
 
@@ -561,6 +615,9 @@ StatusCode CurveFS::DeleteFile(const std::string & filename, uint64_t fileId,
             return StatusCode::kStorageError;
         }
 
+        RemoveDentryCache(filename);
+        allocStatistic_->GetFileAllocStatistic()->InvalidateDir(
+            fileInfo.id());
         LOG(INFO) << "delete file success, file is directory"
                   << ", filename = " << filename;
         return StatusCode::kOK;
@@ -589,6 +646,10 @@ StatusCode CurveFS::DeleteFile(const std::string & filename, uint64_t fileId,
                         << ", ret = " << ret1;
                 return StatusCode::kStorageError;
             }
+            FileAllocStatistic* fileAllocStatistic =
+                allocStatistic_->GetFileAllocStatistic();
+            fileAllocStatistic->InvalidateDir(fileInfo.parentid());
+            fileAllocStatistic->InvalidateDir(RECYCLEBININODEID);
             LOG(INFO) << "file delete to recyclebin, fileName = " << filename
                       << ", recycle filename = " << recycleFileInfo.filename();
             return StatusCode::kOK;
@@ -814,6 +875,12 @@ StatusCode CurveFS::RenameFile(const std::string & oldFileName,
 
             return StatusCode::kStorageError;
         }
+        // 目录结构发生变化，源目录、目标目录和回收站的分配量缓存失效
+        FileAllocStatistic* fileAllocStatistic =
+            allocStatistic_->GetFileAllocStatistic();
+        fileAllocStatistic->InvalidateDir(oldFileInfo.parentid());
+        fileAllocStatistic->InvalidateDir(parentFileInfo.id());
+        fileAllocStatistic->InvalidateDir(RECYCLEBININODEID);
         return StatusCode::kOK;
     } else if (ret3 == StatusCode::kFileNotExists) {
         // newFileName不存在, 直接rename
@@ -827,6 +894,10 @@ StatusCode CurveFS::RenameFile(const std::string & oldFileName,
             LOG(ERROR) << "storage_ renamefile error, error = " << ret;
             return StatusCode::kStorageError;
         }
+        FileAllocStatistic* fileAllocStatistic =
+            allocStatistic_->GetFileAllocStatistic();
+        fileAllocStatistic->InvalidateDir(oldFileInfo.parentid());
+        fileAllocStatistic->InvalidateDir(parentFileInfo.id());
         return StatusCode::kOK;
     } else {
         LOG(INFO) << "dest file LookUpFile return: " << ret3;
@@ -929,6 +1000,35 @@ StatusCode CurveFS::ChangeOwner(const std::string &filename,
 
     // 修改文件owner
     fileInfo.set_owner(newOwner);
+    ret = PutFile(fileInfo);
+    if (ret == StatusCode::kOK &&
+        fileInfo.filetype() == FileType::INODE_DIRECTORY) {
+        RemoveDentryCache(filename);
+    }
+    return ret;
+}
+
+StatusCode CurveFS::UpdateFileThrottleParams(const std::string &filename,
+                                        const FileThrottleParams &params) {
+    FileInfo  fileInfo;
+    StatusCode ret = GetFileInfo(filename, &fileInfo);
+    if (ret != StatusCode::kOK) {
+        LOG(INFO) << "get source file error, errCode = " << ret;
+        return  ret;
+    }
+
+    // 只有普通文件有QoS限制
+    if (fileInfo.filetype() != FileType::INODE_PAGEFILE) {
+        LOG(ERROR) << "file type not support throttle"
+                   << ", filename = " << filename;
+        return StatusCode::kNotSupported;
+    }
+
+    if (params.throttleparams_size() == 0) {
+        fileInfo.clear_throttleparams();
+    } else {
+        fileInfo.mutable_throttleparams()->CopyFrom(params);
+    }
     return PutFile(fileInfo);
 }
 
@@ -968,6 +1068,17 @@ StatusCode CurveFS::GetOrAllocateSegment(const std::string & filename,
                       << ", not allocated";
             return  StatusCode::kSegmentNotAllocated;
         } else {
+            // 持有文件锁，保证文件分配量的加载和更新不会交错
+            FileAllocStatistic* fileAllocStatistic =
+                allocStatistic_->GetFileAllocStatistic();
+            NameLockGuard guard(fileAllocStatistic->GetFileLock(),
+                FileAllocStatistic::FileLockKey(fileInfo.id()));
+            AllocatedSize fileAlloc;
+            if (LoadFileAllocSize(fileInfo.id(), &fileAlloc)
+                != StatusCode::kOK) {
+                return StatusCode::kStorageError;
+            }
+
             // TODO(hzsunjianliang): check the user and define the logical pool
             auto ifok = chunkSegAllocator_->AllocateChunkSegment(
                             fileInfo.filetype(), fileInfo.segmentsize(),
@@ -976,8 +1087,14 @@ StatusCode CurveFS::GetOrAllocateSegment(const std::string & filename,
                 LOG(ERROR) << "AllocateChunkSegment error";
                 return StatusCode::kSegmentAllocateError;
             }
+
+            // 文件的分配量与segment在同一个事务中持久化
+            fileAlloc.total += segment->segmentsize();
+            fileAlloc.allocSizeMap[segment->logicalpoolid()] +=
+                segment->segmentsize();
             int64_t revision;
-            if (storage_->PutSegment(fileInfo.id(), offset, segment, &revision)
+            if (storage_->PutSegment(fileInfo.id(), offset, segment,
+                                     fileAlloc, &revision)
                 != StoreStatus::OK) {
                 LOG(ERROR) << "PutSegment fail, fileInfo.id() = "
                            << fileInfo.id()
@@ -988,6 +1105,10 @@ StatusCode CurveFS::GetOrAllocateSegment(const std::string & filename,
             allocStatistic_->AllocSpace(segment->logicalpoolid(),
                     segment->segmentsize(),
                     revision);
+            fileAllocStatistic->AllocSpace(fileInfo.id(),
+                    fileInfo.parentid(),
+                    segment->logicalpoolid(),
+                    segment->segmentsize());
 
             LOG(INFO) << "alloc segment success, fileInfo.id() = "
                       << fileInfo.id()
@@ -1579,9 +1700,18 @@ StatusCode CurveFS::CheckPathOwnerInternal(const std::string &filename,
     *lastEntry = paths.back();
     uint64_t tempParentID = rootFileInfo_.id();
 
+    std::string path;
     for (uint32_t i = 0; i < paths.size() - 1; i++) {
         FileInfo  fileInfo;
-        auto ret = storage_->GetFile(tempParentID, paths[i], &fileInfo);
+        path += "/" + paths[i];
+        StoreStatus ret = StoreStatus::OK;
+        if (!dentryCache_->Get(path, &fileInfo)) {
+            ret = storage_->GetFile(tempParentID, paths[i], &fileInfo);
+            if (ret == StoreStatus::OK &&
+                fileInfo.filetype() == FileType::INODE_DIRECTORY) {
+                dentryCache_->Put(path, fileInfo);
+            }
+        }
 
         if (ret ==  StoreStatus::OK) {
             if (fileInfo.filetype() !=  FileType::INODE_DIRECTORY) {
@@ -37,6 +37,7 @@
 #include "src/mds/nameserver2/clean_manager.h"
 #include "src/mds/nameserver2/async_delete_snapshot_entity.h"
 #include "src/mds/nameserver2/file_record.h"
+#include "src/mds/nameserver2/dentry_cache.h"
 #include "src/mds/nameserver2/idgenerator/inode_id_generator.h"
 #include "src/common/authenticator.h"
 #include "src/mds/nameserver2/allocstatistic/alloc_statistic.h"
@@ -52,17 +53,12 @@ struct RootAuthOption {
 
 struct CurveFSOption {
     uint64_t defaultChunkSize;
+    // 目录路径缓存的最大目录数，为0时不缓存
+    uint64_t dentryCacheSize;
     RootAuthOption authOptions;
     FileRecordOptions fileRecordOptions;
-};
 
-struct AllocatedSize {
-    // mds给文件分配的segment的大小
-    uint64_t total;
-    // 在每个池子里的分配大小
-    std::unordered_map<PoolIdType, uint64_t> allocSizeMap;
-    AllocatedSize() : total(0) {}
-    AllocatedSize& operator+=(const AllocatedSize& rhs);
+    CurveFSOption() : defaultChunkSize(0), dentryCacheSize(0) {}
 };
 
 using ::curve::mds::DeleteSnapShotResponse;
@@ -206,6 +202,15 @@ class CurveFS {
     StatusCode ChangeOwner(const std::string &filename,
                            const std::string &newOwner);
 
+    /**
+     *  @brief 修改文件的QoS限制，client在RefreshSession时获取新的限制
+     *  @param fileName: 文件名
+     *         params: 新的QoS限制，为空时清除原来的限制
+     *  @return 是否成功，成功返回StatusCode::kOK
+     */
+    StatusCode UpdateFileThrottleParams(const std::string &filename,
+                                        const FileThrottleParams &params);
+
     // segment(chunk) ops
     /**
      *  @brief 查询segment信息，如果segment不存在，根据allocateIfNoExist决定是否
@@ -479,6 +484,12 @@ class CurveFS {
                           const std::string & fileName,
                           FileInfo *fileInfo) const;
 
+    /**
+     * @brief 目录被修改或删除后，移除目录路径缓存
+     * @param fileName: 目录的完整路径
+     */
+    void RemoveDentryCache(const std::string &fileName);
+
     StatusCode PutFile(const FileInfo & fileInfo);
 
     /**
@@ -571,6 +582,14 @@ class CurveFS {
                                 const FileInfo& fileInfo,
                                 AllocatedSize* allocSize);
 
+    /**
+     *  @brief 获取文件分配大小，未加载时从storage加载，调用方需持有文件锁
+     *  @param: id 文件的inodeid
+     *  @param[out]: allocSize： 文件的分配大小
+     *  @return 是否成功，成功返回StatusCode::kOK
+     */
+    StatusCode LoadFileAllocSize(InodeID id, AllocatedSize* allocSize);
+
     /**
      *  @brief 获取目录分配大小
      *  @param: dirName：目录名
@@ -602,6 +621,8 @@ class CurveFS {
     std::shared_ptr<CleanManagerInterface> cleanManager_;
     std::shared_ptr<AllocStatistic> allocStatistic_;
     std::shared_ptr<Topology> topology_;
+    // 目录路径缓存，加速WalkPath
+    std::shared_ptr<DentryCache> dentryCache_;
     struct RootAuthOption       rootAuthOptions_;
 
     uint64_t defaultChunkSize_;
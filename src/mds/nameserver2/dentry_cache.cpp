@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include "src/mds/nameserver2/dentry_cache.h"
+
+using ::curve::common::ReadLockGuard;
+using ::curve::common::WriteLockGuard;
+
+namespace curve {
+namespace mds {
+
+bool DentryCache::Get(const std::string &path, FileInfo *fileInfo) {
+    ReadLockGuard guard(lock_);
+    auto iter = dentries_.find(path);
+    if (iter == dentries_.end()) {
+        return false;
+    }
+
+    fileInfo->CopyFrom(iter->second);
+    return true;
+}
+
+void DentryCache::Put(const std::string &path, const FileInfo &fileInfo) {
+    if (maxCount_ == 0) {
+        return;
+    }
+
+    WriteLockGuard guard(lock_);
+    auto iter = dentries_.find(path);
+    if (iter != dentries_.end()) {
+        iter->second.CopyFrom(fileInfo);
+        return;
+    }
+
+    if (dentries_.size() >= maxCount_) {
+        dentries_.erase(dentries_.begin());
+    }
+    dentries_.emplace(path, fileInfo);
+}
+
+void DentryCache::Remove(const std::string &path) {
+    WriteLockGuard guard(lock_);
+    dentries_.erase(path);
+}
+
+uint64_t DentryCache::Size() {
+    ReadLockGuard guard(lock_);
+    return dentries_.size();
+}
+
+}  // namespace mds
+}  // namespace curve
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#ifndef SRC_MDS_NAMESERVER2_DENTRY_CACHE_H_
+#define SRC_MDS_NAMESERVER2_DENTRY_CACHE_H_
+
+#include <string>
+#include <unordered_map>
+#include "proto/nameserver2.pb.h"
+#include "src/common/concurrent/concurrent.h"
+
+namespace curve {
+namespace mds {
+
+/**
+ * DentryCache 缓存目录的完整路径到目录FileInfo的映射，
+ * WalkPath解析路径时父目录可以一次查到，不用逐级读取和解码。
+ *
+ * 只缓存目录，目录的修改(删除、change owner)都要求目录为空，
+ * 并且在FileLockManager的写锁下进行，而填充缓存时持有路径上各级目录的读锁，
+ * 所以修改目录后移除该路径即可保证一致
+ */
+class DentryCache {
+ public:
+    /**
+     * @param maxCount 最多缓存的目录数
+     */
+    explicit DentryCache(uint64_t maxCount) : maxCount_(maxCount) {}
+
+    /**
+     * @brief 获取目录的FileInfo
+     *
+     * @param[in] path 目录的完整路径，如"/dir1/dir2"
+     * @param[out] fileInfo 目录的FileInfo
+     *
+     * @return true表示命中，false表示未缓存
+     */
+    bool Get(const std::string &path, FileInfo *fileInfo);
+
+    /**
+     * @brief 缓存目录的FileInfo，超过最大数量时淘汰任意一个目录
+     *
+     * @param[in] path 目录的完整路径
+     * @param[in] fileInfo 目录的FileInfo
+     */
+    void Put(const std::string &path, const FileInfo &fileInfo);
+
+    /**
+     * @brief 目录被修改或删除后移除缓存
+     *
+     * @param[in] path 目录的完整路径
+     */
+    void Remove(const std::string &path);
+
+    /**
+     * @brief 获取缓存的目录数
+     */
+    uint64_t Size();
+
+ private:
+    // 最多缓存的目录数
+    uint64_t maxCount_;
+
+    std::unordered_map<std::string, FileInfo> dentries_;
+    ::curve::common::RWLock lock_;
+};
+
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_NAMESERVER2_DENTRY_CACHE_H_
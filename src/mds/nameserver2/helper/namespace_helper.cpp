@@ -20,6 +20,9 @@
  * Author: tongguangxun
  */
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/wire_format_lite.h>
 #include <vector>
 #include "src/mds/nameserver2/helper/namespace_helper.h"
 #include "src/common/string_util.h"
@@ -31,9 +34,25 @@ using ::curve::common::SNAPSHOTFILEINFOKEYPREFIX;
 using ::curve::common::SEGMENTKEYLEN;
 using ::curve::common::SEGMENTINFOKEYPREFIX;
 using ::curve::common::SEGMENTALLOCSIZEKEY;
+using ::curve::common::FILEALLOCKEYLEN;
+using ::curve::common::FILEALLOCKEYPREFIX;
+using ::google::protobuf::io::CodedInputStream;
+using ::google::protobuf::io::CodedOutputStream;
+using ::google::protobuf::io::StringOutputStream;
+using ::google::protobuf::internal::WireFormatLite;
 
 namespace curve {
 namespace mds {
+// 紧凑编码的segment的第一个字节和版本号
+const char kSegmentCompactMagic = 0;
+const char kSegmentCompactVersion = 1;
+
+std::atomic<bool> NameSpaceStorageCodec::segmentCompactEncoding_(false);
+
+void NameSpaceStorageCodec::SetSegmentCompactEncoding(bool enable) {
+    segmentCompactEncoding_.store(enable);
+}
+
 std::string NameSpaceStorageCodec::EncodeFileStoreKey(uint64_t parentID,
                                                 const std::string &fileName) {
     std::string storeKey;
@@ -80,12 +99,82 @@ bool NameSpaceStorageCodec::DecodeFileInfo(const std::string info,
 
 bool NameSpaceStorageCodec::EncodeSegment(const PageFileSegment &segment,
                                     std::string *out) {
-    return segment.SerializeToString(out);
+    if (!segmentCompactEncoding_.load()) {
+        return segment.SerializeToString(out);
+    }
+
+    // 格式: magic|version|logicalPoolID|segmentSize|chunkSize|startOffset|
+    //       chunkNum|{chunkID与前一个chunkID的差值|copysetID}...
+    // 除magic和version外都是varint, chunkID的差值使用zigzag编码
+    out->clear();
+    {
+        StringOutputStream stream(out);
+        CodedOutputStream output(&stream);
+        output.WriteRaw(&kSegmentCompactMagic, 1);
+        output.WriteRaw(&kSegmentCompactVersion, 1);
+        output.WriteVarint32(segment.logicalpoolid());
+        output.WriteVarint32(segment.segmentsize());
+        output.WriteVarint32(segment.chunksize());
+        output.WriteVarint64(segment.startoffset());
+        output.WriteVarint32(segment.chunks_size());
+        uint64_t prevChunkId = 0;
+        for (const auto &chunk : segment.chunks()) {
+            output.WriteVarint64(WireFormatLite::ZigZagEncode64(
+                static_cast<int64_t>(chunk.chunkid() - prevChunkId)));
+            output.WriteVarint32(chunk.copysetid());
+            prevChunkId = chunk.chunkid();
+        }
+        if (output.HadError()) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool NameSpaceStorageCodec::DecodeSegment(const std::string info,
                                     PageFileSegment *segment) {
-    return segment->ParseFromString(info);
+    // protobuf编码的第一个字节是字段的tag, 不会为0, 以此区分两种格式
+    if (info.size() < 2 || info[0] != kSegmentCompactMagic) {
+        return segment->ParseFromString(info);
+    }
+    if (info[1] != kSegmentCompactVersion) {
+        LOG(ERROR) << "unknown segment encoding version: "
+                   << static_cast<int>(info[1]);
+        return false;
+    }
+
+    CodedInputStream input(
+        reinterpret_cast<const uint8_t *>(info.data()) + 2, info.size() - 2);
+    uint32_t logicalPoolId, segmentSize, chunkSize, chunkNum;
+    uint64_t startOffset;
+    if (!input.ReadVarint32(&logicalPoolId) ||
+        !input.ReadVarint32(&segmentSize) ||
+        !input.ReadVarint32(&chunkSize) ||
+        !input.ReadVarint64(&startOffset) ||
+        !input.ReadVarint32(&chunkNum) ||
+        chunkNum > info.size()) {
+        return false;
+    }
+
+    segment->Clear();
+    segment->set_logicalpoolid(logicalPoolId);
+    segment->set_segmentsize(segmentSize);
+    segment->set_chunksize(chunkSize);
+    segment->set_startoffset(startOffset);
+    segment->mutable_chunks()->Reserve(chunkNum);
+    uint64_t chunkId = 0;
+    for (uint32_t i = 0; i < chunkNum; i++) {
+        uint64_t delta;
+        uint32_t copysetId;
+        if (!input.ReadVarint64(&delta) || !input.ReadVarint32(&copysetId)) {
+            return false;
+        }
+        chunkId += WireFormatLite::ZigZagDecode64(delta);
+        PageFileChunkInfo *chunk = segment->add_chunks();
+        chunk->set_chunkid(chunkId);
+        chunk->set_copysetid(copysetId);
+    }
+    return input.CurrentPosition() == static_cast<int>(info.size() - 2);
 }
 
 std::string NameSpaceStorageCodec::EncodeID(uint64_t value) {
@@ -132,5 +221,76 @@ bool NameSpaceStorageCodec::DecodeSegmentAllocValue(
 
     return true;
 }
+
+std::string NameSpaceStorageCodec::EncodeSegmentAllocCheckpoint(
+    int64_t revision, const std::map<uint16_t, int64_t> &allocs) {
+    std::string value = std::to_string(revision);
+    for (auto &item : allocs) {
+        value += "|" + EncodeSegmentAllocValue(item.first, item.second);
+    }
+    return value;
+}
+
+bool NameSpaceStorageCodec::DecodeSegmentAllocCheckpoint(
+    const std::string &value, int64_t *revision,
+    std::map<uint16_t, int64_t> *allocs) {
+    std::vector<std::string> res;
+    ::curve::common::SplitString(value, "|", &res);
+    uint64_t tmpRevision;
+    if (res.empty() || !::curve::common::StringToUll(res[0], &tmpRevision)) {
+        LOG(ERROR) << "segment alloc checkpoint: "
+                   << value << " is in unknownn format";
+        return false;
+    }
+    *revision = tmpRevision;
+
+    allocs->clear();
+    for (size_t i = 1; i < res.size(); i++) {
+        uint16_t lid;
+        uint64_t alloc;
+        if (!DecodeSegmentAllocValue(res[i], &lid, &alloc)) {
+            return false;
+        }
+        (*allocs)[lid] = alloc;
+    }
+    return true;
+}
+
+std::string NameSpaceStorageCodec::EncodeFileAllocKey(uint64_t inodeID) {
+    std::string storeKey;
+    storeKey.resize(FILEALLOCKEYLEN);
+    memcpy(&(storeKey[0]), FILEALLOCKEYPREFIX, COMMON_PREFIX_LENGTH);
+    ::curve::common::EncodeBigEndian(&(storeKey[2]), inodeID);
+    return storeKey;
+}
+
+std::string NameSpaceStorageCodec::EncodeFileAllocValue(
+    const std::map<uint16_t, uint64_t> &allocs) {
+    std::string value;
+    for (auto &item : allocs) {
+        if (!value.empty()) {
+            value += "|";
+        }
+        value += EncodeSegmentAllocValue(item.first, item.second);
+    }
+    return value;
+}
+
+bool NameSpaceStorageCodec::DecodeFileAllocValue(const std::string &value,
+    std::map<uint16_t, uint64_t> *allocs) {
+    std::vector<std::string> res;
+    ::curve::common::SplitString(value, "|", &res);
+
+    allocs->clear();
+    for (auto &item : res) {
+        uint16_t lid;
+        uint64_t alloc;
+        if (!DecodeSegmentAllocValue(item, &lid, &alloc)) {
+            return false;
+        }
+        (*allocs)[lid] = alloc;
+    }
+    return true;
+}
 }   // namespace mds
 }   // namespace curve
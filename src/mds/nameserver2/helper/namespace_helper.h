@@ -22,6 +22,8 @@
 
 #ifndef SRC_MDS_NAMESERVER2_HELPER_NAMESPACE_HELPER_H_
 #define SRC_MDS_NAMESERVER2_HELPER_NAMESPACE_HELPER_H_
+#include <atomic>
+#include <map>
 #include <string>
 
 #include "src/common/encode.h"
@@ -41,6 +43,8 @@ class NameSpaceStorageCodec {
 
     static bool EncodeFileInfo(const FileInfo &finlInfo, std::string *out);
     static bool DecodeFileInfo(const std::string info, FileInfo *fileInfo);
+    // 开启紧凑编码时chunkID按差值编码, 其余字段为varint, 否则使用protobuf编码
+    // 解码时两种格式都兼容
     static bool EncodeSegment(const PageFileSegment &segment, std::string *out);
     static bool DecodeSegment(const std::string info, PageFileSegment *segment);
     static std::string EncodeID(uint64_t value);
@@ -50,6 +54,25 @@ class NameSpaceStorageCodec {
     static std::string EncodeSegmentAllocValue(uint16_t lid, uint64_t alloc);
     static bool DecodeSegmentAllocValue(
         const std::string &value, uint16_t *lid, uint64_t *alloc);
+
+    // 分配量检查点的格式为: revision|lid_alloc|lid_alloc...
+    static std::string EncodeSegmentAllocCheckpoint(
+        int64_t revision, const std::map<uint16_t, int64_t> &allocs);
+    static bool DecodeSegmentAllocCheckpoint(const std::string &value,
+        int64_t *revision, std::map<uint16_t, int64_t> *allocs);
+
+    // 文件分配量的格式为: lid_alloc|lid_alloc...
+    static std::string EncodeFileAllocKey(uint64_t inodeID);
+    static std::string EncodeFileAllocValue(
+        const std::map<uint16_t, uint64_t> &allocs);
+    static bool DecodeFileAllocValue(const std::string &value,
+        std::map<uint16_t, uint64_t> *allocs);
+
+    // 设置segment是否使用紧凑编码, 降级到不支持紧凑编码的mds之前需要关闭
+    static void SetSegmentCompactEncoding(bool enable);
+
+ private:
+    static std::atomic<bool> segmentCompactEncoding_;
 };
 }   // namespace mds
 }   // namespace curve
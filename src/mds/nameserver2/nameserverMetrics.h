@@ -35,7 +35,8 @@ class NameserverCacheMetrics {
         cacheCount(NameServerMetricsPrefix, "cache_count"),
         cacheBytes(NameServerMetricsPrefix, "cache_bytes"),
         cacheHit(NameServerMetricsPrefix, "cache_hit"),
-        cacheMiss(NameServerMetricsPrefix, "cache_miss") {}
+        cacheMiss(NameServerMetricsPrefix, "cache_miss"),
+        cacheEviction(NameServerMetricsPrefix, "cache_eviction") {}
 
     void UpdateAddToCacheCount();
 
@@ -53,6 +54,10 @@ class NameserverCacheMetrics {
         cacheMiss << 1;
     }
 
+    void OnCacheEviction() {
+        cacheEviction << 1;
+    }
+
  public:
     const std::string NameServerMetricsPrefix = "mds_nameserver_cache_metric";
 
@@ -60,6 +65,7 @@ class NameserverCacheMetrics {
     bvar::Adder<uint64_t> cacheBytes;
     bvar::Adder<uint64_t> cacheHit;
     bvar::Adder<uint64_t> cacheMiss;
+    bvar::Adder<uint64_t> cacheEviction;
 };
 
 }  // namespace mds
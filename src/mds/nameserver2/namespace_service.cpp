@@ -624,6 +624,72 @@ void NameSpaceService::ChangeOwner(
     return;
 }
 
+void NameSpaceService::UpdateFileThrottleParams(
+                ::google::protobuf::RpcController* controller,
+                const ::curve::mds::UpdateFileThrottleParamsRequest* request,
+                ::curve::mds::UpdateFileThrottleParamsResponse* response,
+                ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    ExpiredTime expiredTime;
+
+    if (!isPathValid(request->filename())) {
+        response->set_statuscode(StatusCode::kParaError);
+        LOG(ERROR) << "logid = " << cntl->log_id()
+                << ", UpdateFileThrottleParams request path is invalid"
+                << ", filename = " << request->filename();
+        return;
+    }
+
+    LOG(INFO) << "logid = " << cntl->log_id()
+              << ", UpdateFileThrottleParams request, filename = "
+              << request->filename()
+              << ", throttleParams = "
+              << request->throttleparams().ShortDebugString();
+
+    FileWriteLockGuard guard(fileLockManager_, request->filename());
+
+    StatusCode retCode;
+    // UpdateFileThrottleParams()接口，只允许root用户调用
+    retCode = kCurveFS.CheckRootOwner(request->filename(), request->rootowner(),
+                                      request->signature(), request->date());
+    if (retCode != StatusCode::kOK) {
+        response->set_statuscode(retCode);
+        LOG(WARNING) << "logid = " << cntl->log_id()
+            << ", CheckRootOwner fail, filename = " <<  request->filename()
+            << ", owner = " << request->rootowner()
+            << ", statusCode = " << retCode;
+        return;
+    }
+
+    retCode = kCurveFS.UpdateFileThrottleParams(request->filename(),
+                                                request->throttleparams());
+    if (retCode != StatusCode::kOK)  {
+        response->set_statuscode(retCode);
+        if (google::ERROR != GetMdsLogLevel(retCode)) {
+            LOG(WARNING) << "logid = " << cntl->log_id()
+                         << ", UpdateFileThrottleParams fail, filename = "
+                         << request->filename()
+                         << ", statusCode = " << retCode
+                         << ", StatusCode_Name = " << StatusCode_Name(retCode)
+                         << ", cost " << expiredTime.ExpiredMs() << " ms";
+        } else {
+            LOG(ERROR) << "logid = " << cntl->log_id()
+                       << ", UpdateFileThrottleParams fail, filename = "
+                       << request->filename()
+                       << ", statusCode = " << retCode
+                       << ", StatusCode_Name = " << StatusCode_Name(retCode)
+                       << ", cost " << expiredTime.ExpiredMs() << " ms";
+        }
+    } else {
+        response->set_statuscode(StatusCode::kOK);
+        LOG(INFO) << "logid = " << cntl->log_id()
+                  << ", UpdateFileThrottleParams ok, filename = "
+                  << request->filename() << ", cost "
+                  << expiredTime.ExpiredMs() << " ms";
+    }
+}
+
 void NameSpaceService::ListDir(::google::protobuf::RpcController* controller,
                        const ::curve::mds::ListDirRequest* request,
                        ::curve::mds::ListDirResponse* response,
@@ -1317,6 +1383,42 @@ void NameSpaceService::RefreshSession(
                     ::google::protobuf::Closure* done) {
     brpc::ClosureGuard doneGuard(done);
     brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    DoRefreshSession(cntl, request, response);
+}
+
+void NameSpaceService::RefreshSessionBatch(
+                    ::google::protobuf::RpcController* controller,
+                    const ::curve::mds::RefreshSessionBatchRequest* request,
+                    ::curve::mds::RefreshSessionBatchResponse* response,
+                    ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    ExpiredTime expiredTime;
+
+    if (request->requests_size() == 0) {
+        response->set_statuscode(StatusCode::kParaError);
+        LOG(ERROR) << "logid = " << cntl->log_id()
+                   << ", RefreshSessionBatch request is empty, clientip = "
+                   << butil::ip2str(cntl->remote_side().ip).c_str();
+        return;
+    }
+
+    for (int i = 0; i < request->requests_size(); ++i) {
+        DoRefreshSession(cntl, &request->requests(i),
+                         response->add_responses());
+    }
+
+    response->set_statuscode(StatusCode::kOK);
+    DVLOG(6) << "logid = " << cntl->log_id()
+             << ", RefreshSessionBatch ok, file num = "
+             << request->requests_size()
+             << ", cost = " << expiredTime.ExpiredMs() << " ms";
+}
+
+void NameSpaceService::DoRefreshSession(
+                    brpc::Controller* cntl,
+                    const ::curve::mds::ReFreshSessionRequest* request,
+                    ::curve::mds::ReFreshSessionResponse* response) {
     ExpiredTime expiredTime;
 
     std::string clientIP = butil::ip2str(cntl->remote_side().ip).c_str();
@@ -104,6 +104,12 @@ class NameSpaceService: public CurveFSService {
                        ::curve::mds::ChangeOwnerResponse* response,
                        ::google::protobuf::Closure* done) override;
 
+    void UpdateFileThrottleParams(
+                ::google::protobuf::RpcController* controller,
+                const ::curve::mds::UpdateFileThrottleParamsRequest* request,
+                ::curve::mds::UpdateFileThrottleParamsResponse* response,
+                ::google::protobuf::Closure* done) override;
+
     void ListDir(::google::protobuf::RpcController* controller,
                        const ::curve::mds::ListDirRequest* request,
                        ::curve::mds::ListDirResponse* response,
@@ -142,6 +148,10 @@ class NameSpaceService: public CurveFSService {
                         const ::curve::mds::ReFreshSessionRequest* request,
                         ::curve::mds::ReFreshSessionResponse* response,
                         ::google::protobuf::Closure* done) override;
+    void RefreshSessionBatch(::google::protobuf::RpcController* controller,
+                const ::curve::mds::RefreshSessionBatchRequest* request,
+                ::curve::mds::RefreshSessionBatchResponse* response,
+                ::google::protobuf::Closure* done) override;
     void CreateCloneFile(::google::protobuf::RpcController* controller,
                        const ::curve::mds::CreateCloneFileRequest* request,
                        ::curve::mds::CreateCloneFileResponse* response,
@@ -168,6 +178,14 @@ class NameSpaceService: public CurveFSService {
         ::curve::mds::FindFileMountPointResponse* response,
         ::google::protobuf::Closure* done) override;
 
+ private:
+    /**
+     * @brief 续约单个文件的session，RefreshSession和RefreshSessionBatch共用
+     */
+    void DoRefreshSession(brpc::Controller* cntl,
+                          const ::curve::mds::ReFreshSessionRequest* request,
+                          ::curve::mds::ReFreshSessionResponse* response);
+
  private:
     FileLockManager *fileLockManager_;
 };
@@ -31,6 +31,12 @@ using ::curve::common::SNAPSHOTFILEINFOKEYEND;
 namespace curve {
 namespace mds {
 
+static std::string EncodeFileAlloc(const AllocatedSize &fileAlloc) {
+    std::map<uint16_t, uint64_t> allocs(fileAlloc.allocSizeMap.begin(),
+                                        fileAlloc.allocSizeMap.end());
+    return NameSpaceStorageCodec::EncodeFileAllocValue(allocs);
+}
+
 std::ostream& operator << (std::ostream & os, StoreStatus &s) {
     os << static_cast<std::underlying_type<StoreStatus>::type>(s);
     return os;
@@ -463,6 +469,7 @@ StoreStatus NameServerStorageImp::ListFileInternal(
 StoreStatus NameServerStorageImp::PutSegment(InodeID id,
                                              uint64_t off,
                                              const PageFileSegment *segment,
+                                             const AllocatedSize &fileAlloc,
                                              int64_t *revision) {
     std::string storeKey =
         NameSpaceStorageCodec::EncodeSegmentStoreKey(id, off);
@@ -470,8 +477,24 @@ StoreStatus NameServerStorageImp::PutSegment(InodeID id,
     if (!NameSpaceStorageCodec::EncodeSegment(*segment, &encodeSegment)) {
         return StoreStatus::InternalError;
     }
+    std::string allocKey = NameSpaceStorageCodec::EncodeFileAllocKey(id);
+    std::string allocValue = EncodeFileAlloc(fileAlloc);
 
-    int errCode = client_->PutRewithRevision(storeKey, encodeSegment, revision);
+    // segment和文件的分配量在同一个事务中更新
+    Operation op1{
+        OpType::OpPut,
+        const_cast<char*>(storeKey.c_str()),
+        const_cast<char*>(encodeSegment.c_str()),
+        static_cast<int>(storeKey.size()),
+        static_cast<int>(encodeSegment.size())};
+    Operation op2{
+        OpType::OpPut,
+        const_cast<char*>(allocKey.c_str()),
+        const_cast<char*>(allocValue.c_str()),
+        static_cast<int>(allocKey.size()),
+        static_cast<int>(allocValue.size())};
+    std::vector<Operation> ops{op1, op2};
+    int errCode = client_->TxnWithRevision(ops, revision);
     if (errCode != EtcdErrCode::EtcdOK) {
         LOG(ERROR) << "put segment of logicalPoolId:"
                    << segment->logicalpoolid() << "err:" << errCode;
@@ -510,11 +533,35 @@ StoreStatus NameServerStorageImp::GetSegment(InodeID id,
     return getErrorCode(errCode);
 }
 
-StoreStatus NameServerStorageImp::DeleteSegment(
-    InodeID id, uint64_t off, int64_t *revision) {
+StoreStatus NameServerStorageImp::DeleteSegment(InodeID id,
+                                                uint64_t off,
+                                                const AllocatedSize &fileAlloc,
+                                                int64_t *revision) {
     std::string storeKey =
         NameSpaceStorageCodec::EncodeSegmentStoreKey(id, off);
-    int errCode = client_->DeleteRewithRevision(storeKey, revision);
+    std::string allocKey = NameSpaceStorageCodec::EncodeFileAllocKey(id);
+    std::string allocValue = EncodeFileAlloc(fileAlloc);
+
+    // segment和文件的分配量在同一个事务中更新，文件的segment全部删除后
+    // 删除分配量记录
+    Operation op1{
+        OpType::OpDelete,
+        const_cast<char*>(storeKey.c_str()), "",
+        static_cast<int>(storeKey.size()), 0};
+    Operation op2{
+        OpType::OpPut,
+        const_cast<char*>(allocKey.c_str()),
+        const_cast<char*>(allocValue.c_str()),
+        static_cast<int>(allocKey.size()),
+        static_cast<int>(allocValue.size())};
+    if (fileAlloc.total == 0) {
+        op2 = Operation{
+            OpType::OpDelete,
+            const_cast<char*>(allocKey.c_str()), "",
+            static_cast<int>(allocKey.size()), 0};
+    }
+    std::vector<Operation> ops{op1, op2};
+    int errCode = client_->TxnWithRevision(ops, revision);
 
     // 先更新缓存，再更新etcd
     cache_->Remove(storeKey);
@@ -525,6 +572,45 @@ StoreStatus NameServerStorageImp::DeleteSegment(
     return getErrorCode(errCode);
 }
 
+StoreStatus NameServerStorageImp::GetFileAlloc(InodeID id,
+                                               AllocatedSize *fileAlloc) {
+    fileAlloc->total = 0;
+    fileAlloc->allocSizeMap.clear();
+
+    std::string out;
+    int errCode = client_->Get(
+        NameSpaceStorageCodec::EncodeFileAllocKey(id), &out);
+    if (errCode == EtcdErrCode::EtcdOK) {
+        std::map<uint16_t, uint64_t> allocs;
+        if (!NameSpaceStorageCodec::DecodeFileAllocValue(out, &allocs)) {
+            LOG(ERROR) << "decode file alloc of inodeid: " << id << " err";
+            return StoreStatus::InternalError;
+        }
+        for (const auto &item : allocs) {
+            fileAlloc->allocSizeMap[item.first] = item.second;
+            fileAlloc->total += item.second;
+        }
+        return StoreStatus::OK;
+    } else if (errCode != EtcdErrCode::EtcdKeyNotExist) {
+        LOG(ERROR) << "get file alloc of inodeid: " << id
+                   << " err: " << errCode;
+        return getErrorCode(errCode);
+    }
+
+    // 没有分配量记录，通过segment统计
+    std::vector<PageFileSegment> segments;
+    StoreStatus ret = ListSegment(id, &segments);
+    if (ret != StoreStatus::OK) {
+        return ret;
+    }
+    for (const auto &segment : segments) {
+        fileAlloc->allocSizeMap[segment.logicalpoolid()] +=
+            segment.segmentsize();
+        fileAlloc->total += segment.segmentsize();
+    }
+    return StoreStatus::OK;
+}
+
 StoreStatus NameServerStorageImp::SnapShotFile(const FileInfo *originFInfo,
                                             const FileInfo *snapshotFInfo) {
     std::string originFileKey;
@@ -34,6 +34,7 @@
 #include "src/mds/common/mds_define.h"
 #include "src/kvstorageclient/etcd_client.h"
 #include "src/mds/nameserver2/namespace_storage_cache.h"
+#include "src/mds/nameserver2/allocstatistic/file_alloc_statistic.h"
 
 namespace curve {
 namespace mds {
@@ -188,11 +189,12 @@ class NameServerStorage {
                                     PageFileSegment *segment) = 0;
 
     /**
-     * @brief PutSegment 存储指定的segment信息
+     * @brief PutSegment 事务，存储指定的segment信息，同时更新文件的分配量
      *
      * @param[in] id为当前文件的inode
      * @param[in] off为当前segment的偏移
      * @param[out] segment segment信息
+     * @param[in] fileAlloc 分配该segment之后文件的分配量
      * @param[out] revision 本次put的版本号
      *
      * @return StoreStatus 错误码
@@ -200,19 +202,35 @@ class NameServerStorage {
     virtual StoreStatus PutSegment(InodeID id,
                                     uint64_t off,
                                     const PageFileSegment * segment,
+                                    const AllocatedSize &fileAlloc,
                                     int64_t *revision) = 0;
 
     /**
-     * @brief DeleteSegment 删除指定的segment元数据
+     * @brief DeleteSegment 事务，删除指定的segment元数据，
+     *        同时更新文件的分配量，分配量为0时删除文件的分配量记录
      *
      * @param[in] id为当前文件的inode
      * @param[in] off为当前segment的偏移
+     * @param[in] fileAlloc 删除该segment之后文件的分配量
      * @param[out] revision 本次delete的版本号
      *
      * @return StoreStatus 错误码
      */
-    virtual StoreStatus DeleteSegment(
-        InodeID id, uint64_t off, int64_t *revision) = 0;
+    virtual StoreStatus DeleteSegment(InodeID id,
+                                      uint64_t off,
+                                      const AllocatedSize &fileAlloc,
+                                      int64_t *revision) = 0;
+
+    /**
+     * @brief GetFileAlloc 获取文件的分配量，
+     *        没有分配量记录的文件(升级前创建的文件等)通过ListSegment统计
+     *
+     * @param[in] id 文件的inode id
+     * @param[out] fileAlloc 文件的分配量
+     *
+     * @return StoreStatus 错误码
+     */
+    virtual StoreStatus GetFileAlloc(InodeID id, AllocatedSize *fileAlloc) = 0;
 
     /**
      * @brief SnapShotFile 事务，存储snapshotFile的元数据信息，更新源文件元数据
@@ -283,10 +301,15 @@ class NameServerStorageImp : public NameServerStorage {
     StoreStatus PutSegment(InodeID id,
                             uint64_t off,
                             const PageFileSegment * segment,
+                            const AllocatedSize &fileAlloc,
                             int64_t *revision) override;
 
-    StoreStatus DeleteSegment(
-        InodeID id, uint64_t off, int64_t *revision) override;
+    StoreStatus DeleteSegment(InodeID id,
+                              uint64_t off,
+                              const AllocatedSize &fileAlloc,
+                              int64_t *revision) override;
+
+    StoreStatus GetFileAlloc(InodeID id, AllocatedSize *fileAlloc) override;
 
     StoreStatus SnapShotFile(const FileInfo *originalFileInfo,
                             const FileInfo * snapshotFileInfo) override;
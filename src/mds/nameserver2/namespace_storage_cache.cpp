@@ -21,6 +21,8 @@
  */
 
 #include <glog/logging.h>
+#include <algorithm>
+#include <functional>
 #include "src/mds/nameserver2/namespace_storage_cache.h"
 
 namespace curve {
@@ -90,6 +92,7 @@ void LRUCache::MoveToFront(const std::list<Item>::iterator &elem) {
 
 void LRUCache::RemoveOldest() {
     if (ll_.begin() != ll_.end()) {
+        cacheMetrics_->OnCacheEviction();
         RemoveElement(--ll_.end());
     }
 }
@@ -104,5 +107,112 @@ void LRUCache::RemoveElement(const std::list<Item>::iterator &elem) {
     ll_.erase(elem);
 }
 
+ShardedClockCache::ShardedClockCache(uint64_t maxBytes, uint32_t shardNum) {
+    shardNum = std::max(shardNum, 1u);
+    shardMaxBytes_ = maxBytes == 0 ?
+        0 : std::max<uint64_t>(maxBytes / shardNum, 1);
+    for (uint32_t i = 0; i < shardNum; i++) {
+        shards_.emplace_back(new Shard());
+    }
+    cacheMetrics_ = std::make_shared<NameserverCacheMetrics>();
+}
+
+ShardedClockCache::Shard *ShardedClockCache::GetShard(const std::string &key) {
+    return shards_[std::hash<std::string>()(key) % shards_.size()].get();
+}
+
+void ShardedClockCache::Put(const std::string &key, const std::string &value) {
+    Shard *shard = GetShard(key);
+    uint64_t size = key.size() + value.size();
+
+    ::curve::common::WriteLockGuard guard(shard->lock);
+    auto iter = shard->index.find(key);
+    if (iter != shard->index.end()) {
+        RemoveLocked(shard, iter->second);
+    }
+
+    // 超过分片容量的元素不缓存
+    if (shardMaxBytes_ != 0 && size > shardMaxBytes_) {
+        return;
+    }
+    EvictLocked(shard, size);
+
+    // 插入到指针之前，即最后一个被检查的位置
+    auto elem = shard->items.emplace(shard->hand, key, value);
+    shard->index.emplace(key, elem);
+    shard->usedBytes += size;
+    cacheMetrics_->UpdateAddToCacheCount();
+    cacheMetrics_->UpdateAddToCacheBytes(size);
+}
+
+bool ShardedClockCache::Get(const std::string &key, std::string *value) {
+    Shard *shard = GetShard(key);
+
+    ::curve::common::ReadLockGuard guard(shard->lock);
+    auto iter = shard->index.find(key);
+    if (iter == shard->index.end()) {
+        cacheMetrics_->OnCacheMiss();
+        return false;
+    }
+
+    cacheMetrics_->OnCacheHit();
+    iter->second->referenced.store(true, std::memory_order_relaxed);
+    *value = iter->second->value;
+    return true;
+}
+
+void ShardedClockCache::Remove(const std::string &key) {
+    Shard *shard = GetShard(key);
+
+    ::curve::common::WriteLockGuard guard(shard->lock);
+    auto iter = shard->index.find(key);
+    if (iter != shard->index.end()) {
+        RemoveLocked(shard, iter->second);
+    }
+}
+
+std::shared_ptr<NameserverCacheMetrics>
+ShardedClockCache::GetCacheMetrics() const {
+    return cacheMetrics_;
+}
+
+void ShardedClockCache::RemoveLocked(Shard *shard,
+    const std::list<ClockItem>::iterator &item) {
+    // item可能就是shard->hand，先复制一份
+    auto elem = item;
+    uint64_t size = elem->key.size() + elem->value.size();
+    cacheMetrics_->UpdateRemoveFromCacheCount();
+    cacheMetrics_->UpdateRemoveFromCacheBytes(size);
+
+    if (shard->hand == elem) {
+        ++shard->hand;
+    }
+    shard->usedBytes -= size;
+    shard->index.erase(elem->key);
+    shard->items.erase(elem);
+}
+
+void ShardedClockCache::EvictLocked(Shard *shard, uint64_t size) {
+    if (shardMaxBytes_ == 0) {
+        return;
+    }
+
+    while (!shard->items.empty() &&
+           shard->usedBytes + size > shardMaxBytes_) {
+        if (shard->hand == shard->items.end()) {
+            shard->hand = shard->items.begin();
+        }
+
+        if (shard->hand->referenced.load(std::memory_order_relaxed)) {
+            // 最近被访问过，清除标记给一次机会
+            shard->hand->referenced.store(false, std::memory_order_relaxed);
+            ++shard->hand;
+        } else {
+            cacheMetrics_->OnCacheEviction();
+            RemoveLocked(shard, shard->hand);
+        }
+    }
+}
+
 }  // namespace mds
 }  // namespace curve
@@ -23,10 +23,12 @@
 #ifndef SRC_MDS_NAMESERVER2_NAMESPACE_STORAGE_CACHE_H_
 #define SRC_MDS_NAMESERVER2_NAMESPACE_STORAGE_CACHE_H_
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "src/common/concurrent/concurrent.h"
 #include "src/mds/nameserver2/nameserverMetrics.h"
 
@@ -128,6 +130,72 @@ class LRUCache : public Cache {
     std::shared_ptr<NameserverCacheMetrics> cacheMetrics_;
 };
 
+/**
+ * ShardedClockCache 按key的hash分片的缓存，使用CLOCK算法淘汰
+ *
+ * 每个分片一把读写锁，命中时只设置元素的访问标记，只需要读锁，
+ * Put和Remove只锁住对应的分片。容量按key和value的字节数计算，
+ * 平均分配到各个分片
+ */
+class ShardedClockCache : public Cache {
+ public:
+    /**
+     * @param maxBytes 缓存的最大字节数，为0表示不限制
+     * @param shardNum 分片数
+     */
+    explicit ShardedClockCache(uint64_t maxBytes, uint32_t shardNum = 32);
+
+    void Put(const std::string &key, const std::string &value) override;
+    bool Get(const std::string &key, std::string *value) override;
+    void Remove(const std::string &key) override;
+    std::shared_ptr<NameserverCacheMetrics> GetCacheMetrics() const;
+
+ private:
+    struct ClockItem {
+        std::string key;
+        std::string value;
+        // 访问标记，淘汰时跳过被访问过的元素并清除标记
+        std::atomic<bool> referenced;
+
+        ClockItem(const std::string &k, const std::string &v)
+            : key(k), value(v), referenced(false) {}
+    };
+
+    struct Shard {
+        ::curve::common::RWLock lock;
+        // 分片的元素，按插入顺序组成环
+        std::list<ClockItem> items;
+        std::unordered_map<std::string, std::list<ClockItem>::iterator> index;
+        // CLOCK的指针，指向下一个淘汰候选
+        std::list<ClockItem>::iterator hand;
+        // 分片已使用的字节数
+        uint64_t usedBytes;
+
+        Shard() : hand(items.end()), usedBytes(0) {}
+    };
+
+    Shard *GetShard(const std::string &key);
+
+    /**
+     * @brief 移除分片中的元素，调用方需持有分片的写锁
+     */
+    void RemoveLocked(Shard *shard,
+                      const std::list<ClockItem>::iterator &elem);
+
+    /**
+     * @brief 淘汰元素直到分片可以放下size字节，调用方需持有分片的写锁
+     */
+    void EvictLocked(Shard *shard, uint64_t size);
+
+ private:
+    // 每个分片的最大字节数，为0表示不限制
+    uint64_t shardMaxBytes_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    // cache相关metric统计
+    std::shared_ptr<NameserverCacheMetrics> cacheMetrics_;
+};
+
 }  // namespace mds
 }  // namespace curve
 
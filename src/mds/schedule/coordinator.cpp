@@ -273,6 +273,14 @@ bool Coordinator::BuildCopySetConf(
     return true;
 }
 
+std::vector<CopySetKey> Coordinator::GetCopySetsWithOperator() {
+    std::vector<CopySetKey> keys;
+    for (auto &op : opController_->GetOperators()) {
+        keys.emplace_back(op.copysetID);
+    }
+    return keys;
+}
+
 bool Coordinator::ChunkserverGoingToAdd(
     ChunkServerIdType csId, CopySetKey key) {
     Operator op;
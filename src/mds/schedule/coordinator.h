@@ -87,6 +87,12 @@ class Coordinator {
      */
     virtual bool ChunkserverGoingToAdd(ChunkServerIdType csId, CopySetKey key);
 
+    /**
+     * @brief 获取当前有operator的copyset，
+     *        用于处理增量心跳中未上报的copyset上的operator
+     */
+    virtual std::vector<CopySetKey> GetCopySetsWithOperator();
+
     /**
      * @brief 根据配置初始化scheduler
      *
@@ -71,6 +71,7 @@ CopySetInfo::~CopySetInfo() {
 CopySetInfo::CopySetInfo(const CopySetInfo &in) {
     this->id.first = in.id.first;
     this->id.second = in.id.second;
+    this->logicalPoolWork = in.logicalPoolWork;
     this->epoch = in.epoch;
     this->leader = in.leader;
     this->peers = in.peers;
@@ -151,7 +152,8 @@ bool ChunkServerInfo::IsHealthy() const {
 TopoAdapterImpl::TopoAdapterImpl(
     std::shared_ptr<Topology> topo,
     std::shared_ptr<TopologyServiceManager> manager,
-    std::shared_ptr<TopologyStat> stat) {
+    std::shared_ptr<TopologyStat> stat)
+    : viewInited_(false), viewVersion_(0) {
     this->topo_ = topo;
     this->topoServiceManager_ = manager;
     this->topoStat_ = stat;
@@ -183,13 +185,14 @@ bool TopoAdapterImpl::GetCopySetInfo(const CopySetKey &id, CopySetInfo *info) {
 }
 
 std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfos() {
+    ::curve::common::LockGuard guard(viewMutex_);
+    SyncCopySetView();
+
     std::vector<CopySetInfo> infos;
-    for (auto copySetKey : topo_->GetCopySetsInCluster()) {
-        CopySetInfo copySetInfo;
-        if (GetCopySetInfo(copySetKey, &copySetInfo)) {
-            if (copySetInfo.logicalPoolWork) {
-                infos.push_back(copySetInfo);
-            }
+    infos.reserve(copySetView_.size());
+    for (auto &item : copySetView_) {
+        if (item.second.logicalPoolWork) {
+            infos.push_back(item.second);
         }
     }
     return infos;
@@ -197,15 +200,18 @@ std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfos() {
 
 std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInChunkServer(
     ChunkServerIdType id) {
-    std::vector<CopySetKey> keys = topo_->GetCopySetsInChunkServer(id);
+    ::curve::common::LockGuard guard(viewMutex_);
+    SyncCopySetView();
 
     std::vector<CopySetInfo> out;
-    for (auto key : keys) {
-        CopySetInfo info;
-        if (GetCopySetInfo(key, &info)) {
-            if (info.logicalPoolWork) {
-                out.emplace_back(info);
-            }
+    auto iter = chunkServerIndex_.find(id);
+    if (iter == chunkServerIndex_.end()) {
+        return out;
+    }
+    for (auto &key : iter->second) {
+        auto &info = copySetView_[key];
+        if (info.logicalPoolWork) {
+            out.emplace_back(info);
         }
     }
     return out;
@@ -213,15 +219,83 @@ std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInChunkServer(
 
 std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInLogicalPool(
     PoolIdType lid) {
+    ::curve::common::LockGuard guard(viewMutex_);
+    SyncCopySetView();
+
     std::vector<CopySetInfo> infos;
-    for (auto &copysetInfo : topo_->GetCopySetInfosInLogicalPool(lid)) {
-        ::curve::mds::schedule::CopySetInfo out;
-        if (CopySetFromTopoToSchedule(copysetInfo, &out)) {
-            infos.emplace_back(out);
+    auto iter = logicalPoolIndex_.find(lid);
+    if (iter == logicalPoolIndex_.end()) {
+        return infos;
+    }
+    infos.reserve(iter->second.size());
+    for (auto &key : iter->second) {
+        infos.emplace_back(copySetView_[key]);
+    }
+    return infos;
+}
+
+void TopoAdapterImpl::SyncCopySetView() {
+    std::vector<CopySetKey> changed;
+    uint64_t version = 0;
+    bool incremental =
+        topo_->GetChangedCopySets(viewVersion_, &changed, &version);
+    if (viewInited_ && incremental) {
+        for (auto &key : changed) {
+            RefreshCopySetInView(key);
         }
+        viewVersion_ = version;
+        return;
     }
 
-    return infos;
+    // 首次构建或者有影响所有copyset的变化，全量重建。
+    // 版本号在重建之前获取，重建过程中发生的变化在下一次同步时再更新
+    copySetView_.clear();
+    chunkServerIndex_.clear();
+    logicalPoolIndex_.clear();
+    for (auto &key : topo_->GetCopySetsInCluster()) {
+        RefreshCopySetInView(key);
+    }
+    viewVersion_ = version;
+    viewInited_ = true;
+}
+
+void TopoAdapterImpl::RefreshCopySetInView(const CopySetKey &key) {
+    RemoveCopySetFromView(key);
+
+    CopySetInfo info;
+    if (!GetCopySetInfo(key, &info)) {
+        return;
+    }
+    for (auto &peer : info.peers) {
+        chunkServerIndex_[peer.id].insert(key);
+    }
+    logicalPoolIndex_[key.first].insert(key);
+    copySetView_.emplace(key, info);
+}
+
+void TopoAdapterImpl::RemoveCopySetFromView(const CopySetKey &key) {
+    auto iter = copySetView_.find(key);
+    if (iter == copySetView_.end()) {
+        return;
+    }
+
+    for (auto &peer : iter->second.peers) {
+        auto ix = chunkServerIndex_.find(peer.id);
+        if (ix != chunkServerIndex_.end()) {
+            ix->second.erase(key);
+            if (ix->second.empty()) {
+                chunkServerIndex_.erase(ix);
+            }
+        }
+    }
+    auto ix = logicalPoolIndex_.find(key.first);
+    if (ix != logicalPoolIndex_.end()) {
+        ix->second.erase(key);
+        if (ix->second.empty()) {
+            logicalPoolIndex_.erase(ix);
+        }
+    }
+    copySetView_.erase(iter);
 }
 
 bool TopoAdapterImpl::GetChunkServerInfo(ChunkServerIdType id,
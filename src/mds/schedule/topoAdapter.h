@@ -26,11 +26,13 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <set>
 #include <memory>
 #include "src/mds/topology/topology.h"
 #include "src/mds/topology/topology_service_manager.h"
 #include "src/mds/topology/topology_stat.h"
 #include "src/mds/common/mds_define.h"
+#include "src/common/concurrent/concurrent.h"
 #include "proto/topology.pb.h"
 #include "proto/heartbeat.pb.h"
 
@@ -312,9 +314,11 @@ class TopoAdapter {
 };
 
 // adapter实现
+// 各调度器共享同一个adapter，copyset信息维护在视图中，
+// 根据topology记录的copyset变化增量更新，避免每轮调度都从topology全量转化
 class TopoAdapterImpl : public TopoAdapter {
  public:
-    TopoAdapterImpl() = default;
+    TopoAdapterImpl() : viewInited_(false), viewVersion_(0) {}
     explicit TopoAdapterImpl(std::shared_ptr<Topology> topo,
                              std::shared_ptr<TopologyServiceManager> manager,
                              std::shared_ptr<TopologyStat> stat);
@@ -363,10 +367,31 @@ class TopoAdapterImpl : public TopoAdapter {
  private:
     bool GetPeerInfo(ChunkServerIdType id, PeerInfo *peerInfo);
 
+    /**
+     * @brief 根据topology中copyset的变化更新视图，调用方需持有viewMutex_
+     */
+    void SyncCopySetView();
+
+    /**
+     * @brief 从topology重新获取copyset更新到视图，获取不到则从视图中删除
+     */
+    void RefreshCopySetInView(const CopySetKey &key);
+
+    void RemoveCopySetFromView(const CopySetKey &key);
+
  private:
     std::shared_ptr<Topology> topo_;
     std::shared_ptr<TopologyServiceManager> topoServiceManager_;
     std::shared_ptr<TopologyStat> topoStat_;
+
+    // copyset视图及按chunkserver、逻辑池的索引
+    std::map<CopySetKey, CopySetInfo> copySetView_;
+    std::map<ChunkServerIdType, std::set<CopySetKey>> chunkServerIndex_;
+    std::map<PoolIdType, std::set<CopySetKey>> logicalPoolIndex_;
+    bool viewInited_;
+    // 视图对应的topology copyset变化版本号
+    uint64_t viewVersion_;
+    ::curve::common::Mutex viewMutex_;
 };
 }  // namespace schedule
 }  // namespace mds
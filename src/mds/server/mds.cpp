@@ -27,6 +27,7 @@
 
 using ::curve::mds::topology::TopologyStorageEtcd;
 using ::curve::mds::topology::TopologyStorageCodec;
+using ::curve::mds::topology::ClusterInformation;
 
 namespace curve {
 namespace mds {
@@ -55,9 +56,14 @@ void MDS::InitMdsOptions(std::shared_ptr<Configuration> conf) {
     conf_->GetValueFatalIfFail(
         "mds.segment.alloc.periodic.persistInterMs",
         &options_.periodicPersistInterMs);
+    conf_->GetValueFatalIfFail(
+        "mds.segment.compactEncoding", &options_.segmentCompactEncoding);
+    NameSpaceStorageCodec::SetSegmentCompactEncoding(
+        options_.segmentCompactEncoding);
 
     // namestorage的缓存大小
-    conf_->GetValueFatalIfFail("mds.cache.count", &options_.mdsCacheCount);
+    conf_->GetValueFatalIfFail("mds.cache.maxBytes",
+                               &options_.mdsCacheMaxBytes);
 
     // 获取mds监听地址
     conf_->GetValueFatalIfFail("mds.listen.addr", &options_.mdsListenAddr);
@@ -67,6 +73,13 @@ void MDS::InitMdsOptions(std::shared_ptr<Configuration> conf) {
     // 获取mds的文件锁桶大小
     conf_->GetValueFatalIfFail(
         "mds.filelock.bucketNum", &options_.mdsFilelockBucketNum);
+    // 获取warm standby相关配置
+    conf_->GetValueFatalIfFail(
+        "mds.warmStandby.enable", &options_.warmStandbyEnable);
+    conf_->GetValueFatalIfFail("mds.warmStandby.refreshIntervalMs",
+        &options_.warmStandbyOption.refreshIntervalMs);
+    conf_->GetValueFatalIfFail("mds.warmStandby.topologyReloadIntervalMs",
+        &options_.warmStandbyOption.topologyReloadIntervalMs);
 }
 
 void MDS::StartDummy() {
@@ -97,6 +110,11 @@ void MDS::StartCompaginLeader() {
     InitEtcdConf(&etcdConf);
     InitEtcdClient(etcdConf, etcdTimeout, etcdRetryTimes);
 
+    // 竞选期间预热topology和元数据缓存
+    if (options_.warmStandbyEnable) {
+        StartWarmStandby();
+    }
+
     // 进行leader选举
     LeaderElectionOptions leaderElectionOp;
     InitMdsLeaderElectionOption(&leaderElectionOp);
@@ -108,6 +126,9 @@ void MDS::StartCompaginLeader() {
                   << " campaign for leader again";
     }
     LOG(INFO) << "Campain leader ok, I am the leader now";
+    if (warmStandby_ != nullptr) {
+        StopWarmStandby();
+    }
     status_.set_value("leader");
     leaderElection_->StartObserverLeader();
 }
@@ -116,10 +137,14 @@ void MDS::Init() {
     // 初始化Segment统计模块
     InitSegmentAllocStatistic(options_.retryInterTimes,
                               options_.periodicPersistInterMs);
-    // 初始化NameServer存储模块
-    InitNameServerStorage(options_.mdsCacheCount);
-    // init topology
-    InitTopology(options_.topologyOption);
+    // 初始化NameServer存储模块, 已经预热的缓存可以直接使用
+    if (warmStandby_ == nullptr || !warmStandby_->IsCacheValid()) {
+        InitNameServerStorage(options_.mdsCacheMaxBytes);
+    }
+    // init topology, 已经预热的topology可以直接使用
+    if (warmStandby_ == nullptr || !warmStandby_->IsTopologyLoaded()) {
+        InitTopology(options_.topologyOption);
+    }
     // init TopologyStat
     InitTopologyStat();
     // init TopologyChunkAllocator
@@ -321,6 +346,9 @@ void MDS::InitTopologyOption(TopologyOption *topologyOption) {
     conf_->GetValueFatalIfFail(
         "mds.topology.choosePoolPolicy",
         &topologyOption->choosePoolPolicy);
+    conf_->GetValueFatalIfFail(
+        "mds.topology.CopySetWeightUpdateIntervalMs",
+        &topologyOption->CopySetWeightUpdateIntervalMs);
 }
 
 void MDS::InitTopology(const TopologyOption& option) {
@@ -344,6 +372,34 @@ void MDS::InitTopology(const TopologyOption& option) {
     LOG(INFO) << "init topology success.";
 }
 
+int MDS::LoadTopology(const TopologyOption& option) {
+    auto codec = std::make_shared<TopologyStorageCodec>();
+    auto topologyStorage =
+        std::make_shared<TopologyStorageEtcd>(etcdClient_, codec);
+
+    // follower不能创建集群信息，避免多个mds同时启动时创建出不同的集群
+    std::vector<ClusterInformation> infos;
+    if (!topologyStorage->LoadClusterInfo(&infos) || infos.empty()) {
+        LOG(INFO) << "cluster info not exist, skip load topology.";
+        return -1;
+    }
+
+    auto topologyIdGenerator = std::make_shared<DefaultIdGenerator>();
+    auto topologyTokenGenerator = std::make_shared<DefaultTokenGenerator>();
+    auto newTopology = std::make_shared<TopologyImpl>(topologyIdGenerator,
+                                                      topologyTokenGenerator,
+                                                      topologyStorage);
+    int ret = newTopology->Init(option);
+    if (ret != topology::kTopoErrCodeSuccess) {
+        LOG(ERROR) << "load topology fail, ret = " << ret;
+        return ret;
+    }
+
+    topology_ = newTopology;
+    LOG(INFO) << "load topology success.";
+    return 0;
+}
+
 void MDS::InitTopologyStat() {
     topologyStat_ =
         std::make_shared<TopologyStatImpl>(topology_);
@@ -397,21 +453,52 @@ void MDS::InitCopysetOption(CopysetOption *copysetOption) {
 void MDS::InitTopologyChunkAllocator(const TopologyOption& option) {
     topologyChunkAllocator_ =
           std::make_shared<TopologyChunkAllocatorImpl>(topology_,
-               segmentAllocStatistic_, option);
+               segmentAllocStatistic_, topologyStat_, option);
     LOG(INFO) << "init topologyChunkAllocator success.";
 }
 
-void MDS::InitNameServerStorage(int mdsCacheCount) {
-    // init LRUCache
-    auto cache = std::make_shared<LRUCache>(mdsCacheCount);
-    LOG(INFO) << "init LRUCache success.";
+void MDS::InitNameServerStorage(uint64_t mdsCacheMaxBytes) {
+    // init ShardedClockCache
+    nameServerCache_ = std::make_shared<ShardedClockCache>(mdsCacheMaxBytes);
+    LOG(INFO) << "init ShardedClockCache success, maxBytes = "
+              << mdsCacheMaxBytes;
 
     // init NameServerStorage
-    nameServerStorage_ = std::make_shared<NameServerStorageImp>(etcdClient_,
-                                                                cache);
+    nameServerStorage_ = std::make_shared<NameServerStorageImp>(
+        etcdClient_, nameServerCache_);
     LOG(INFO) << "init NameServerStorage success.";
 }
 
+void MDS::StartWarmStandby() {
+    InitNameServerStorage(options_.mdsCacheMaxBytes);
+    warmStandby_ = std::make_shared<WarmStandby>(
+        etcdClient_, nameServerCache_,
+        [this]() { return LoadTopology(options_.topologyOption); },
+        [this]() { return topology_; },
+        options_.warmStandbyOption);
+    if (warmStandby_->Init() != 0) {
+        LOG(WARNING) << "init warm standby fail, start cold after campaign";
+        warmStandby_ = nullptr;
+        return;
+    }
+    warmStandby_->Start();
+    LOG(INFO) << "start warm standby success.";
+}
+
+void MDS::StopWarmStandby() {
+    warmStandby_->Stop();
+    // 追赶到当前的revision，失败时缓存和topology都重新加载
+    if (warmStandby_->Refresh() != 0) {
+        warmStandby_ = nullptr;
+        LOG(WARNING) << "warm standby catch up fail, start cold.";
+        return;
+    }
+    LOG(INFO) << "warm standby catch up to revision "
+              << warmStandby_->GetRevision()
+              << ", cache valid: " << warmStandby_->IsCacheValid()
+              << ", topology loaded: " << warmStandby_->IsTopologyLoaded();
+}
+
 void MDS::InitCurveFS(const CurveFSOption& curveFSOptions) {
     // init InodeIDGenerator
     auto inodeIdGenerator = std::make_shared<InodeIdGeneratorImp>(etcdClient_);
@@ -458,6 +545,8 @@ void MDS::InitAuthOptions(RootAuthOption *authOptions) {
 void MDS::InitCurveFSOptions(CurveFSOption *curveFSOptions) {
     conf_->GetValueFatalIfFail(
         "mds.curvefs.defaultChunkSize", &curveFSOptions->defaultChunkSize);
+    conf_->GetValueFatalIfFail(
+        "mds.curvefs.dentryCacheSize", &curveFSOptions->dentryCacheSize);
     FileRecordOptions fileRecordOptions;
     InitFileRecordOptions(&curveFSOptions->fileRecordOptions);
 
@@ -476,9 +565,12 @@ void MDS::InitCleanManager() {
         std::make_shared<CopysetClient>(topology_, chunkServerClientOption,
                                                         channelPool);
 
+    CleanCoreOption cleanCoreOption;
+    InitCleanCoreOption(&cleanCoreOption);
     auto cleanCore = std::make_shared<CleanCore>(nameServerStorage_,
                                                  copysetClient,
-                                                 segmentAllocStatistic_);
+                                                 segmentAllocStatistic_,
+                                                 cleanCoreOption);
 
     cleanManager_ = std::make_shared<CleanManager>(cleanCore,
                                             taskManager, nameServerStorage_);
@@ -497,6 +589,15 @@ void MDS::InitChunkServerClientOption(ChunkServerClientOption *option) {
     conf_->GetValueFatalIfFail(
         "mds.chunkserverclient.updateLeaderRetryIntervalMs",
         &option->updateLeaderRetryIntervalMs);
+    conf_->GetValueFatalIfFail("mds.chunkserverclient.deleteChunkBatchSize",
+        &option->deleteChunkBatchSize);
+}
+
+void MDS::InitCleanCoreOption(CleanCoreOption *option) {
+    conf_->GetValueFatalIfFail("mds.clean.deleteChunkConcurrency",
+        &option->deleteChunkConcurrency);
+    conf_->GetValueFatalIfFail("mds.clean.deleteChunkLimitPerSecond",
+        &option->deleteChunkLimitPerSecond);
 }
 
 void MDS::InitCoordinator() {
@@ -56,6 +56,7 @@
 #include "src/common/curve_version.h"
 #include "src/common/channel_pool.h"
 #include "src/mds/schedule/scheduleService/scheduleService.h"
+#include "src/mds/server/warm_standby.h"
 
 using ::curve::mds::topology::TopologyChunkAllocatorImpl;
 using ::curve::mds::topology::TopologyServiceImpl;
@@ -90,10 +91,15 @@ struct MDSOptions {
     // segmentAlloc相关配置
     uint64_t retryInterTimes;
     uint64_t periodicPersistInterMs;
-    // namestorage的缓存大小
-    int mdsCacheCount;
+    // segment是否使用紧凑编码
+    bool segmentCompactEncoding;
+    // namestorage的缓存最大字节数，为0表示不限制
+    uint64_t mdsCacheMaxBytes;
     // mds的文件锁桶大小
     int mdsFilelockBucketNum;
+    // follower是否预先加载topology和元数据缓存
+    bool warmStandbyEnable;
+    WarmStandbyOption warmStandbyOption;
 
     FileRecordOptions fileRecordOptions;
     RootAuthOption authOptions;
@@ -204,6 +210,12 @@ class MDS {
      */
     void InitChunkServerClientOption(ChunkServerClientOption *option);
 
+    /**
+     * @brief 初始化文件清理选项
+     * @param[out] option 并发删除chunk相关选项
+     */
+    void InitCleanCoreOption(CleanCoreOption *option);
+
     /**
      * @brief 初始化etcd client
      * @param etcdConf etcd配置项
@@ -230,9 +242,19 @@ class MDS {
 
     /**
      * @brief 初始化nameserver存储模块
-     * @param mdsCacheCount 缓存大小
+     * @param mdsCacheMaxBytes 缓存的最大字节数
      */
-    void InitNameServerStorage(int mdsCacheCount);
+    void InitNameServerStorage(uint64_t mdsCacheMaxBytes);
+
+    /**
+     * @brief follower上预先加载topology和元数据缓存，并在后台追赶etcd的变化
+     */
+    void StartWarmStandby();
+
+    /**
+     * @brief 成为leader后停止后台追赶，并追赶到etcd最新的revision
+     */
+    void StopWarmStandby();
 
     /**
      * @brief 开启brpc server
@@ -250,6 +272,14 @@ class MDS {
      */
     void InitTopology(const TopologyOption& option);
 
+    /**
+     * @brief 从etcd加载topology，加载成功后替换topology_，warm standby使用
+     *        集群信息还不存在时不加载，由leader负责创建
+     * @param option topology相关选项
+     * @return 0表示成功，其他表示失败
+     */
+    int LoadTopology(const TopologyOption& option);
+
     /**
      * @brief 初始化topology统计模块
      */
@@ -313,6 +343,10 @@ class MDS {
     std::shared_ptr<AllocStatistic> segmentAllocStatistic_;
     // NameServer存储模块
     std::shared_ptr<NameServerStorage> nameServerStorage_;
+    // NameServer存储模块的缓存
+    std::shared_ptr<Cache> nameServerCache_;
+    // follower上预热topology和元数据缓存
+    std::shared_ptr<WarmStandby> warmStandby_;
     // topology模块，用于定期把内存中的topology数据持久化
     std::shared_ptr<TopologyImpl> topology_;
     // topology统计模块
@@ -0,0 +1,198 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include <glog/logging.h>
+#include <string>
+#include <vector>
+#include "src/mds/server/warm_standby.h"
+#include "src/mds/topology/topology_storage_codec.h"
+#include "src/common/namespace_define.h"
+#include "src/common/timeutility.h"
+
+using ::curve::common::COMMON_PREFIX_LENGTH;
+using ::curve::common::FILEINFOKEYPREFIX;
+using ::curve::common::SNAPSHOTFILEINFOKEYEND;
+using ::curve::common::TOPOLOGYITEMPRIFIX;
+using ::curve::common::TOPOLOGYITEMEND;
+using ::curve::common::TimeUtility;
+using ::curve::mds::topology::ChunkServer;
+using ::curve::mds::topology::CopySetInfo;
+using ::curve::mds::topology::CopySetKey;
+using ::curve::mds::topology::TopologyStorageCodec;
+using ::curve::mds::topology::kTopoErrCodeSuccess;
+
+namespace curve {
+namespace mds {
+
+int WarmStandby::Init() {
+    int res = client_->GetCurrentRevision(&revision_);
+    if (res != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "warm standby get current revision fail, errCode: "
+                   << res;
+        return -1;
+    }
+
+    ReloadTopology();
+    LOG(INFO) << "warm standby init at revision " << revision_
+              << ", topology loaded: " << topologyLoaded_;
+    return 0;
+}
+
+void WarmStandby::Start() {
+    stop_.store(false);
+    refreshThread_ = Thread(&WarmStandby::RefreshFunc, this);
+}
+
+void WarmStandby::Stop() {
+    if (!stop_.exchange(true)) {
+        LOG(INFO) << "start stop WarmStandby...";
+        sleeper_.interrupt();
+        refreshThread_.join();
+        LOG(INFO) << "stop WarmStandby ok!";
+    }
+}
+
+void WarmStandby::RefreshFunc() {
+    while (sleeper_.wait_for(
+        std::chrono::milliseconds(option_.refreshIntervalMs))) {
+        Refresh();
+    }
+}
+
+int WarmStandby::Refresh() {
+    int64_t revision;
+    int res = client_->GetCurrentRevision(&revision);
+    if (res != EtcdErrCode::EtcdOK) {
+        LOG(WARNING) << "warm standby get current revision fail, errCode: "
+                     << res;
+        return -1;
+    }
+
+    std::vector<KVChange> changes;
+    res = client_->ListChanges(
+        FILEINFOKEYPREFIX, TOPOLOGYITEMEND, revision_, revision, &changes);
+    if (res == EtcdErrCode::EtcdOutOfRange) {
+        // 历史已经被compact, 无法得知缓存中哪些元数据已经过期
+        LOG(WARNING) << "warm standby revision " << revision_
+                     << " compacted, invalidate cache and reload topology";
+        cacheValid_ = false;
+        revision_ = revision;
+        ReloadTopology();
+        return 0;
+    } else if (res != EtcdErrCode::EtcdOK) {
+        LOG(WARNING) << "warm standby list changes in (" << revision_
+                     << ", " << revision << "] fail, errCode: " << res;
+        return -1;
+    }
+
+    // topology未加载时不需要增量更新, 直接重新加载
+    bool needReload = !topologyLoaded_;
+    for (auto &change : changes) {
+        if (change.key.compare(
+            0, COMMON_PREFIX_LENGTH, TOPOLOGYITEMPRIFIX) == 0) {
+            if (!needReload && !ApplyTopologyChange(change)) {
+                needReload = true;
+            }
+        } else if (change.key < SNAPSHOTFILEINFOKEYEND) {
+            // 文件、segment和快照的变化直接更新到缓存
+            if (change.type == OpType::OpPut) {
+                cache_->Put(change.key, change.value);
+            } else {
+                cache_->Remove(change.key);
+            }
+        }
+    }
+    revision_ = revision;
+
+    if (needReload) {
+        ReloadTopology();
+    }
+    return 0;
+}
+
+void WarmStandby::ReloadTopology() {
+    uint64_t nowMs = TimeUtility::GetTimeofDayMs();
+    if (lastReloadMs_ != 0 &&
+        nowMs < lastReloadMs_ + option_.topologyReloadIntervalMs) {
+        // 成为leader时topology未加载会重新初始化
+        topologyLoaded_ = false;
+        return;
+    }
+
+    lastReloadMs_ = nowMs;
+    topologyLoaded_ = (reloadTopology_() == 0);
+    if (!topologyLoaded_) {
+        LOG(WARNING) << "warm standby reload topology fail, retry later";
+    }
+}
+
+bool WarmStandby::ApplyTopologyChange(const KVChange &change) {
+    std::shared_ptr<Topology> topology = getTopology_();
+    // 删除需要同时更新所属的物理池和逻辑池, 重新加载
+    if (topology == nullptr || change.type != OpType::OpPut) {
+        return false;
+    }
+
+    TopologyStorageCodec codec;
+    std::string chunkServerPrefix =
+        TopologyStorageCodec::GetChunkServerKeyPrefix();
+    std::string copysetPrefix =
+        TopologyStorageCodec::GetCopysetKeyPrefix();
+    if (change.key.compare(
+        0, chunkServerPrefix.size(), chunkServerPrefix) == 0) {
+        ChunkServer cs;
+        ChunkServer old;
+        if (!codec.DecodeChunkServerData(change.value, &cs) ||
+            !topology->GetChunkServer(cs.GetId(), &old)) {
+            return false;
+        }
+        // chunkserver的位置变化需要重新计算所属的server和物理池
+        if (cs.GetServerId() != old.GetServerId() ||
+            cs.GetHostIp() != old.GetHostIp() ||
+            cs.GetPort() != old.GetPort() ||
+            cs.GetMountPoint() != old.GetMountPoint()) {
+            return false;
+        }
+        // 心跳上报的状态和统计信息
+        return topology->UpdateChunkServerRwState(
+                   cs.GetStatus(), cs.GetId()) == kTopoErrCodeSuccess &&
+               topology->UpdateChunkServerOnlineState(
+                   cs.GetOnlineState(), cs.GetId()) == kTopoErrCodeSuccess &&
+               topology->UpdateChunkServerDiskStatus(
+                   cs.GetChunkServerState(), cs.GetId()) ==
+                   kTopoErrCodeSuccess;
+    } else if (change.key.compare(
+        0, copysetPrefix.size(), copysetPrefix) == 0) {
+        CopySetInfo info;
+        CopySetInfo old;
+        if (!codec.DecodeCopySetData(change.value, &info) ||
+            !topology->GetCopySet(
+                CopySetKey(info.GetLogicalPoolId(), info.GetId()), &old)) {
+            return false;
+        }
+        return topology->UpdateCopySetTopo(info) == kTopoErrCodeSuccess;
+    }
+
+    return false;
+}
+
+}  // namespace mds
+}  // namespace curve
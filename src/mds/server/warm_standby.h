@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#ifndef SRC_MDS_SERVER_WARM_STANDBY_H_
+#define SRC_MDS_SERVER_WARM_STANDBY_H_
+
+#include <functional>
+#include <memory>
+#include "src/kvstorageclient/etcd_client.h"
+#include "src/mds/nameserver2/namespace_storage_cache.h"
+#include "src/mds/topology/topology.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/interruptible_sleeper.h"
+
+namespace curve {
+namespace mds {
+
+using ::curve::kvstorage::EtcdClientImp;
+using ::curve::common::Atomic;
+using ::curve::common::Thread;
+using ::curve::common::InterruptibleSleeper;
+using ::curve::kvstorage::KVChange;
+using ::curve::mds::topology::Topology;
+
+struct WarmStandbyOption {
+    // 追赶etcd中元数据变化的间隔, 单位ms
+    uint32_t refreshIntervalMs;
+    // 重新加载topology的最小间隔, 单位ms
+    uint32_t topologyReloadIntervalMs;
+
+    WarmStandbyOption()
+        : refreshIntervalMs(1000), topologyReloadIntervalMs(60000) {}
+};
+
+/**
+ * WarmStandby 在follower上预先加载topology和元数据缓存,
+ * 并在后台定期追赶etcd中的变化, 成为leader之后不需要冷启动
+ *
+ * 元数据缓存: 文件、segment和快照的变化直接更新到缓存中,
+ *            缓存中保留的是最近变化的热点元数据
+ * topology: chunkserver和copyset的变化直接更新到内存中,
+ *           其他拓扑结构的变化按照最小间隔重新加载
+ * etcd的历史被compact导致无法追赶时, 缓存不再可用, topology重新加载
+ */
+class WarmStandby {
+ public:
+    /**
+     * @param client etcdClient
+     * @param cache 需要预热的元数据缓存
+     * @param reloadTopology 重新加载topology的回调, 返回0表示成功
+     * @param getTopology 获取当前已经加载的topology
+     * @param option 配置项
+     */
+    WarmStandby(std::shared_ptr<EtcdClientImp> client,
+                std::shared_ptr<Cache> cache,
+                std::function<int()> reloadTopology,
+                std::function<std::shared_ptr<Topology>()> getTopology,
+                const WarmStandbyOption &option)
+        : client_(client),
+          cache_(cache),
+          reloadTopology_(reloadTopology),
+          getTopology_(getTopology),
+          option_(option),
+          revision_(0),
+          cacheValid_(true),
+          topologyLoaded_(false),
+          lastReloadMs_(0),
+          stop_(true) {}
+
+    ~WarmStandby() {
+        Stop();
+    }
+
+    /**
+     * @brief Init 记录etcd当前的revision并加载topology
+     *
+     * @return 0-成功 -1-获取revision失败
+     */
+    int Init();
+
+    /**
+     * @brief Start 启动后台追赶线程
+     */
+    void Start();
+
+    /**
+     * @brief Stop 停止后台追赶线程
+     */
+    void Stop();
+
+    /**
+     * @brief Refresh 追赶到etcd当前的revision
+     *
+     * @return 0-成功 -1-失败
+     */
+    int Refresh();
+
+    /**
+     * @brief IsCacheValid 缓存是否与etcd一致
+     */
+    bool IsCacheValid() const {
+        return cacheValid_;
+    }
+
+    /**
+     * @brief IsTopologyLoaded topology是否已经加载到最新
+     */
+    bool IsTopologyLoaded() const {
+        return topologyLoaded_;
+    }
+
+    /**
+     * @brief GetRevision 获取已经追赶到的revision
+     */
+    int64_t GetRevision() const {
+        return revision_;
+    }
+
+ private:
+    void RefreshFunc();
+
+    /**
+     * @brief ReloadTopology 重新加载topology, 距离上次加载不足最小间隔时
+     *        只标记topology未加载, 下次追赶时再加载
+     */
+    void ReloadTopology();
+
+    /**
+     * @brief ApplyTopologyChange 把chunkserver和copyset的变化更新到topology,
+     *        只更新内存, 成为leader之后由topology刷回etcd
+     *
+     * @return true-已经更新 false-无法增量更新, 需要重新加载
+     */
+    bool ApplyTopologyChange(const KVChange &change);
+
+ private:
+    std::shared_ptr<EtcdClientImp> client_;
+    std::shared_ptr<Cache> cache_;
+    std::function<int()> reloadTopology_;
+    std::function<std::shared_ptr<Topology>()> getTopology_;
+    WarmStandbyOption option_;
+
+    // 已经追赶到的revision
+    int64_t revision_;
+    // 缓存是否与etcd一致
+    bool cacheValid_;
+    // topology是否已经加载到最新
+    bool topologyLoaded_;
+    // 上次重新加载topology的时间, 单位ms
+    uint64_t lastReloadMs_;
+
+    Atomic<bool> stop_;
+    InterruptibleSleeper sleeper_;
+    Thread refreshThread_;
+};
+
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_SERVER_WARM_STANDBY_H_
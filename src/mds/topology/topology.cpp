@@ -23,15 +23,22 @@
 
 #include <glog/logging.h>
 #include <chrono>  //NOLINT
+#include <set>
 
 #include "src/common/uuid.h"
+#include "src/common/timeutility.h"
 
 using ::curve::common::UUIDGenerator;
+using ::curve::common::TimeUtility;
+using ::curve::common::LockGuard;
 
 namespace curve {
 namespace mds {
 namespace topology {
 
+// copyset变化记录的最大条数，超过后丢弃最早的记录
+const size_t kMaxCopySetChangeLogSize = 100000;
+
 PoolIdType TopologyImpl::AllocateLogicalPoolId() {
     return idGenerator_->GenLogicalPoolId();
 }
@@ -66,6 +73,7 @@ int TopologyImpl::AddLogicalPool(const LogicalPool &data) {
                 return kTopoErrCodeStorgeFail;
             }
             logicalPoolMap_[data.GetId()] = data;
+            ResetCopySetChange();
             return kTopoErrCodeSuccess;
         } else {
             return kTopoErrCodeIdDuplicated;
@@ -119,6 +127,7 @@ int TopologyImpl::AddServer(const Server &data) {
             }
             it->second.AddServer(data.GetId());
             serverMap_[data.GetId()] = data;
+            ResetCopySetChange();
             return kTopoErrCodeSuccess;
         } else {
             return kTopoErrCodeIdDuplicated;
@@ -151,6 +160,7 @@ int TopologyImpl::AddChunkServer(const ChunkServer &data) {
                 it->second.AddChunkServer(data.GetId());
                 chunkServerMap_[data.GetId()] = data;
                 csCapacity = data.GetChunkServerState().GetDiskCapacity();
+                ResetCopySetChange();
             } else {
                 return kTopoErrCodeIdDuplicated;
             }
@@ -178,6 +188,7 @@ int TopologyImpl::RemoveLogicalPool(PoolIdType id) {
             return kTopoErrCodeStorgeFail;
         }
         logicalPoolMap_.erase(it);
+        ResetCopySetChange();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeLogicalPoolNotFound;
@@ -239,6 +250,7 @@ int TopologyImpl::RemoveServer(ServerIdType id) {
             ix->second.RemoveServer(id);
         }
         serverMap_.erase(it);
+        ResetCopySetChange();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeServerNotFound;
@@ -261,6 +273,7 @@ int TopologyImpl::RemoveChunkServer(ChunkServerIdType id) {
             ix->second.RemoveChunkServer(id);
         }
         chunkServerMap_.erase(it);
+        ResetCopySetChange();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeChunkServerNotFound;
@@ -275,6 +288,7 @@ int TopologyImpl::UpdateLogicalPool(const LogicalPool &data) {
             return kTopoErrCodeStorgeFail;
         }
         it->second = data;
+        ResetCopySetChange();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeLogicalPoolNotFound;
@@ -317,6 +331,7 @@ int TopologyImpl::UpdateServer(const Server &data) {
             return kTopoErrCodeStorgeFail;
         }
         it->second = data;
+        ResetCopySetChange();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeServerNotFound;
@@ -338,6 +353,7 @@ int TopologyImpl::UpdateChunkServerTopo(const ChunkServer &data) {
         }
         it->second = temp;
         it->second.SetDirtyFlag(false);
+        ResetCopySetChange();
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeChunkServerNotFound;
@@ -370,6 +386,9 @@ int TopologyImpl::UpdateChunkServerRwState(const ChunkServerStatus &rwState,
             it->second.SetDirtyFlag(true);
         }
     }
+    if (lastRwState != rwState) {
+        copySetDistributionVersion_.fetch_add(1, std::memory_order_release);
+    }
     // 更新物理池
     switch (lastRwState) {
         case ChunkServerStatus::READWRITE:
@@ -473,6 +492,11 @@ int TopologyImpl::UpdateChunkServerDiskStatus(const ChunkServerState &state,
             WriteLockGuard wlockChunkServer(it->second.GetRWLockRef());
             diff = state.GetDiskCapacity() -
                 it->second.GetChunkServerState().GetDiskCapacity();
+            if (state.GetDiskState() !=
+                it->second.GetChunkServerState().GetDiskState()) {
+                copySetDistributionVersion_.fetch_add(1,
+                    std::memory_order_release);
+            }
             // 心跳数据，只更新内存，后台定期刷入数据库
             it->second.SetChunkServerState(state);
             it->second.SetDirtyFlag(true);
@@ -1023,6 +1047,9 @@ int TopologyImpl::AddCopySet(const CopySetInfo &data) {
                 return kTopoErrCodeStorgeFail;
             }
             copySetMap_[key] = data;
+            copySetDistributionVersion_.fetch_add(1,
+                std::memory_order_release);
+            RecordCopySetChange(key);
             return kTopoErrCodeSuccess;
         } else {
             return kTopoErrCodeIdDuplicated;
@@ -1040,6 +1067,8 @@ int TopologyImpl::RemoveCopySet(CopySetKey key) {
             return kTopoErrCodeStorgeFail;
         }
         copySetMap_.erase(key);
+        copySetDistributionVersion_.fetch_add(1, std::memory_order_release);
+        RecordCopySetChange(key);
         return kTopoErrCodeSuccess;
     } else {
         return kTopoErrCodeCopySetNotFound;
@@ -1054,6 +1083,10 @@ int TopologyImpl::UpdateCopySetTopo(const CopySetInfo &data) {
         WriteLockGuard wlockCopySet(it->second.GetRWLockRef());
         it->second.SetLeader(data.GetLeader());
         it->second.SetEpoch(data.GetEpoch());
+        if (it->second.GetCopySetMembers() != data.GetCopySetMembers()) {
+            copySetDistributionVersion_.fetch_add(1,
+                std::memory_order_release);
+        }
         it->second.SetCopySetMembers(data.GetCopySetMembers());
         if (data.HasCandidate()) {
             it->second.SetCandidate(data.GetCandidate());
@@ -1061,6 +1094,7 @@ int TopologyImpl::UpdateCopySetTopo(const CopySetInfo &data) {
             it->second.ClearCandidate();
         }
         it->second.SetDirtyFlag(true);
+        RecordCopySetChange(key);
         return kTopoErrCodeSuccess;
     } else {
         LOG(WARNING) << "UpdateCopySetTopo can not find copyset, "
@@ -1070,6 +1104,39 @@ int TopologyImpl::UpdateCopySetTopo(const CopySetInfo &data) {
     }
 }
 
+void TopologyImpl::RecordCopySetChange(const CopySetKey &key) {
+    LockGuard guard(copySetChangeMutex_);
+    copySetChangeLog_.emplace_back(++copySetChangeVersion_, key);
+    if (copySetChangeLog_.size() > kMaxCopySetChangeLogSize) {
+        copySetChangeBase_ = copySetChangeLog_.front().first;
+        copySetChangeLog_.pop_front();
+    }
+}
+
+void TopologyImpl::ResetCopySetChange() {
+    LockGuard guard(copySetChangeMutex_);
+    copySetChangeLog_.clear();
+    copySetChangeBase_ = ++copySetChangeVersion_;
+}
+
+bool TopologyImpl::GetChangedCopySets(uint64_t sinceVersion,
+    std::vector<CopySetKey> *changed, uint64_t *version) const {
+    LockGuard guard(copySetChangeMutex_);
+    *version = copySetChangeVersion_;
+    if (sinceVersion < copySetChangeBase_ ||
+        sinceVersion > copySetChangeVersion_) {
+        return false;
+    }
+
+    std::set<CopySetKey> keys;
+    for (auto it = copySetChangeLog_.rbegin();
+        it != copySetChangeLog_.rend() && it->first > sinceVersion; ++it) {
+        keys.insert(it->second);
+    }
+    changed->assign(keys.begin(), keys.end());
+    return true;
+}
+
 bool TopologyImpl::GetCopySet(CopySetKey key, CopySetInfo *out) const {
     ReadLockGuard rlockCopySetMap(copySetMutex_);
     auto it = copySetMap_.find(key);
@@ -1172,12 +1239,26 @@ void TopologyImpl::FlushCopySetToStorage() {
             }
         }
     }
-    for (auto &v : toUpdate) {
-        if (!storage_->UpdateCopySet(v)) {
-            LOG(WARNING) << "update copyset{" << v.GetLogicalPoolId()
-                         << "," << v.GetId() << "} to repo fail";
+    if (toUpdate.empty()) {
+        return;
+    }
+
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    if (!storage_->UpdateCopySets(toUpdate)) {
+        LOG(WARNING) << "update " << toUpdate.size()
+                     << " copysets to repo fail, retry next round";
+        // 重新置dirty，下一轮再刷
+        ReadLockGuard rlockCopySetMap(copySetMutex_);
+        for (auto &v : toUpdate) {
+            auto it = copySetMap_.find(
+                CopySetKey(v.GetLogicalPoolId(), v.GetId()));
+            if (it != copySetMap_.end()) {
+                ReadLockGuard rlockCopySet(it->second.GetRWLockRef());
+                it->second.SetDirtyFlag(true);
+            }
         }
     }
+    flushCopySetLatency_ << TimeUtility::GetTimeofDayUs() - startUs;
 }
 
 void TopologyImpl::FlushChunkServerToStorage() {
@@ -1193,12 +1274,25 @@ void TopologyImpl::FlushChunkServerToStorage() {
             }
         }
     }
-    for (auto &v : toUpdate) {
-        if (!storage_->UpdateChunkServer(v)) {
-            LOG(WARNING) << "update chunkserver to repo fail"
-                         << ", chunkserverid = " << v.GetId();
+    if (toUpdate.empty()) {
+        return;
+    }
+
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    if (!storage_->UpdateChunkServers(toUpdate)) {
+        LOG(WARNING) << "update " << toUpdate.size()
+                     << " chunkservers to repo fail, retry next round";
+        // 重新置dirty，下一轮再刷
+        ReadLockGuard rlockChunkServerMap(chunkServerMutex_);
+        for (auto &v : toUpdate) {
+            auto it = chunkServerMap_.find(v.GetId());
+            if (it != chunkServerMap_.end()) {
+                ReadLockGuard rlockChunkServer(it->second.GetRWLockRef());
+                it->second.SetDirtyFlag(true);
+            }
         }
     }
+    flushChunkServerLatency_ << TimeUtility::GetTimeofDayUs() - startUs;
 }
 
 int TopologyImpl::LoadClusterInfo() {
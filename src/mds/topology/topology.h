@@ -22,12 +22,17 @@
 #ifndef SRC_MDS_TOPOLOGY_TOPOLOGY_H_
 #define SRC_MDS_TOPOLOGY_TOPOLOGY_H_
 
+#include <bvar/bvar.h>
+
 #include <unordered_map>
 #include <string>
 #include <list>
 #include <memory>
 #include <vector>
 #include <map>
+#include <deque>
+#include <utility>
+#include <atomic>
 
 #include "proto/topology.pb.h"
 #include "src/mds/common/mds_define.h"
@@ -162,6 +167,33 @@ class Topology {
      */
     virtual int UpdateCopySetTopo(const CopySetInfo &data) = 0;
 
+    /**
+     * @brief 获取copyset分布的版本号
+     * @detail
+     * - copyset增删、copyset成员变化、chunkserver读写状态变化时递增
+     * - chunk分配索引据此判断是否需要重建
+     *
+     * @return 版本号
+     */
+    virtual uint64_t GetCopySetDistributionVersion() const = 0;
+
+    /**
+     * @brief 获取指定版本之后发生变化的copyset
+     * @detail
+     * - copyset增删、leader/epoch/成员/candidate变化时逐个记录
+     * - 逻辑池、server、chunkserver等影响所有copyset的变化不逐个记录，
+     *   此时返回false，调用方需要全量重建
+     * - 调度模块据此增量更新copyset视图
+     *
+     * @param sinceVersion 上一次获取到的版本号
+     * @param[out] changed sinceVersion之后发生变化的copyset
+     * @param[out] version 当前的版本号
+     *
+     * @return true-changed包含sinceVersion之后的全部变化，false-需要全量重建
+     */
+    virtual bool GetChangedCopySets(uint64_t sinceVersion,
+        std::vector<CopySetKey> *changed, uint64_t *version) const = 0;
+
     virtual PoolIdType
         FindLogicalPool(const std::string &logicalPoolName,
                         const std::string &physicalPoolName) const = 0;
@@ -315,6 +347,11 @@ class TopologyImpl : public Topology {
         : idGenerator_(idGenerator),
           tokenGenerator_(tokenGenerator),
           storage_(storage),
+          copySetDistributionVersion_(0),
+          copySetChangeVersion_(0),
+          copySetChangeBase_(0),
+          flushCopySetLatency_("topology_flush_copyset_us"),
+          flushChunkServerLatency_("topology_flush_chunkserver_us"),
           isStop_(true) {
     }
 
@@ -369,6 +406,13 @@ class TopologyImpl : public Topology {
 
     int UpdateCopySetTopo(const CopySetInfo &data) override;
 
+    uint64_t GetCopySetDistributionVersion() const override {
+        return copySetDistributionVersion_.load(std::memory_order_acquire);
+    }
+
+    bool GetChangedCopySets(uint64_t sinceVersion,
+        std::vector<CopySetKey> *changed, uint64_t *version) const override;
+
     PoolIdType FindLogicalPool(const std::string &logicalPoolName,
         const std::string &physicalPoolName) const override;
     PoolIdType FindPhysicalPool(
@@ -551,6 +595,16 @@ class TopologyImpl : public Topology {
 
     void SetChunkServerExternalIp();
 
+    /**
+     * @brief 记录发生变化的copyset
+     */
+    void RecordCopySetChange(const CopySetKey &key);
+
+    /**
+     * @brief 发生影响所有copyset的变化，清空变化记录，调用方需要全量重建
+     */
+    void ResetCopySetChange();
+
  private:
     std::unordered_map<PoolIdType, LogicalPool> logicalPoolMap_;
     std::unordered_map<PoolIdType, PhysicalPool> physicalPoolMap_;
@@ -575,6 +629,20 @@ class TopologyImpl : public Topology {
     mutable curve::common::RWLock chunkServerMutex_;
     mutable curve::common::RWLock copySetMutex_;
 
+    // copyset分布的版本号
+    std::atomic<uint64_t> copySetDistributionVersion_;
+
+    // copyset的变化记录，<版本号, copyset>
+    std::deque<std::pair<uint64_t, CopySetKey>> copySetChangeLog_;
+    uint64_t copySetChangeVersion_;
+    // 可以增量获取变化的最小版本号，更早的版本需要全量重建
+    uint64_t copySetChangeBase_;
+    mutable curve::common::Mutex copySetChangeMutex_;
+
+    // 每次刷新dirty copyset/chunkserver到存储的耗时
+    bvar::LatencyRecorder flushCopySetLatency_;
+    bvar::LatencyRecorder flushChunkServerLatency_;
+
     TopologyOption option_;
     curve::common::Thread backEndThread_;
     curve::common::Atomic<bool> isStop_;
@@ -24,12 +24,16 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
 #include <vector>
 #include <list>
 #include <random>
 
+#include "src/common/timeutility.h"
+
+using ::curve::common::TimeUtility;
 
 namespace curve {
 namespace mds {
@@ -52,20 +56,29 @@ bool TopologyChunkAllocatorImpl::AllocateChunkRandomInSingleLogicalPool(
         return false;
     }
 
-    std::vector<CopySetIdType> copySetIds =
-        topology_->GetCopySetsInLogicalPool(logicalPoolChosenId);
+    std::shared_ptr<CopySetAllocIndex> index =
+        GetAllocIndex(logicalPoolChosenId);
 
-    if (0 == copySetIds.size()) {
+    if (0 == index->copySetIds.size()) {
         LOG(ERROR) << "[AllocateChunkRandomInSingleLogicalPool]:"
                    << " Does not have any available copySets,"
                    << " logicalPoolId = " << logicalPoolChosenId;
         return false;
     }
-    ret = AllocateChunkPolicy::AllocateChunkRandomInSingleLogicalPool(
-               copySetIds,
-               logicalPoolChosenId,
-               chunkNumber,
-               infos);
+    if (index->weightPrefixSum.empty()) {
+        ret = AllocateChunkPolicy::AllocateChunkRandomInSingleLogicalPool(
+                   index->copySetIds,
+                   logicalPoolChosenId,
+                   chunkNumber,
+                   infos);
+    } else {
+        ret = AllocateChunkPolicy::AllocateChunkByWeightInSingleLogicalPool(
+                   index->copySetIds,
+                   index->weightPrefixSum,
+                   logicalPoolChosenId,
+                   chunkNumber,
+                   infos);
+    }
     return ret;
 }
 
@@ -86,41 +99,204 @@ bool TopologyChunkAllocatorImpl::AllocateChunkRoundRobinInSingleLogicalPool(
         return false;
     }
 
-    std::vector<CopySetIdType> copySetIds =
-        topology_->GetCopySetsInLogicalPool(logicalPoolChosenId);
+    std::shared_ptr<CopySetAllocIndex> index =
+        GetAllocIndex(logicalPoolChosenId);
 
-    if (0 == copySetIds.size()) {
+    if (0 == index->copySetIds.size()) {
         LOG(ERROR) << "[AllocateChunkRoundRobinInSingleLogicalPool]:"
                    << " Does not have any available copySets,"
                    << " logicalPoolId = " << logicalPoolChosenId;
         return false;
     }
 
-    uint32_t nextIndex = 0;
+    // 并发分配时各自占用连续的一段位置
+    uint32_t nextIndex = static_cast<uint32_t>(
+        index->nextIndex.fetch_add(chunkNumber) % index->copySetIds.size());
 
-    ::curve::common::LockGuard guard(nextIndexMapLock_);
-    auto it = nextIndexMap_.find(logicalPoolChosenId);
-    if (it != nextIndexMap_.end()) {
-        nextIndex = it->second;
+    ret = AllocateChunkPolicy::AllocateChunkRoundRobinInSingleLogicalPool(
+               index->copySetIds,
+               logicalPoolChosenId,
+               &nextIndex,
+               chunkNumber,
+               infos);
+    return ret;
+}
+
+std::shared_ptr<CopySetAllocIndex> TopologyChunkAllocatorImpl::GetAllocIndex(
+    PoolIdType logicalPoolId) {
+    std::shared_ptr<const AllocIndexMap> indexes =
+        std::atomic_load(&allocIndexes_);
+    std::shared_ptr<CopySetAllocIndex> index;
+    auto it = indexes->find(logicalPoolId);
+    if (it != indexes->end()) {
+        index = it->second;
+        if (!NeedRebuildAllocIndex(index)) {
+            return index;
+        }
+    }
+
+    ::curve::common::UniqueLock lk(allocIndexBuildLock_, std::defer_lock);
+    if (index != nullptr) {
+        // 其他线程正在重建，先使用旧的索引
+        if (!lk.try_lock()) {
+            return index;
+        }
     } else {
+        lk.lock();
+    }
+
+    indexes = std::atomic_load(&allocIndexes_);
+    it = indexes->find(logicalPoolId);
+    if (it != indexes->end()) {
+        index = it->second;
+        if (!NeedRebuildAllocIndex(index)) {
+            return index;
+        }
+    }
+
+    std::shared_ptr<CopySetAllocIndex> newIndex =
+        BuildAllocIndex(logicalPoolId, index);
+    std::shared_ptr<AllocIndexMap> newIndexes =
+        std::make_shared<AllocIndexMap>(*indexes);
+    (*newIndexes)[logicalPoolId] = newIndex;
+    std::atomic_store(&allocIndexes_,
+        std::shared_ptr<const AllocIndexMap>(newIndexes));
+    return newIndex;
+}
+
+bool TopologyChunkAllocatorImpl::NeedRebuildAllocIndex(
+    const std::shared_ptr<CopySetAllocIndex> &index) const {
+    if (index->version != topology_->GetCopySetDistributionVersion()) {
+        return true;
+    }
+    // 没有统计数据时权值只和copyset分布有关
+    if (topologyStat_ == nullptr) {
+        return false;
+    }
+    return TimeUtility::GetTimeofDayMs() >=
+        index->buildTimeMs + weightUpdateIntervalMs_;
+}
+
+std::shared_ptr<CopySetAllocIndex> TopologyChunkAllocatorImpl::BuildAllocIndex(
+    PoolIdType logicalPoolId,
+    const std::shared_ptr<CopySetAllocIndex> &oldIndex) {
+    std::shared_ptr<CopySetAllocIndex> index =
+        std::make_shared<CopySetAllocIndex>();
+    // 先获取版本号，构建过程中的变化会触发下一次重建
+    index->version = topology_->GetCopySetDistributionVersion();
+    index->buildTimeMs = TimeUtility::GetTimeofDayMs();
+
+    std::vector<CopySetInfo> copysets =
+        topology_->GetCopySetInfosInLogicalPool(logicalPoolId);
+    std::set<ChunkServerIdType> chunkservers;
+    for (const auto &copyset : copysets) {
+        for (auto csId : copyset.GetCopySetMembers()) {
+            chunkservers.insert(csId);
+        }
+    }
+    std::map<ChunkServerIdType, double> csWeights;
+    GetChunkServerWeights(chunkservers, &csWeights);
+
+    // copyset的权值取决于其中权值最小的chunkserver
+    std::vector<double> weights;
+    bool sameWeight = true;
+    for (const auto &copyset : copysets) {
+        double weight = copyset.GetCopySetMembers().empty() ? 0 : 1;
+        for (auto csId : copyset.GetCopySetMembers()) {
+            weight = std::min(weight, csWeights[csId]);
+        }
+        if (weight > 0) {
+            if (!weights.empty() && weight != weights.front()) {
+                sameWeight = false;
+            }
+            index->copySetIds.push_back(copyset.GetId());
+            weights.push_back(weight);
+        }
+    }
+
+    if (index->copySetIds.empty() && !copysets.empty()) {
+        // 所有copyset都不可分配时退化为等概率分配，不影响可用性
+        LOG(WARNING) << "BuildAllocIndex find no copyset can be weighted, "
+                     << "allocate in all copysets equally, logicalPoolId = "
+                     << logicalPoolId
+                     << ", copyset num = " << copysets.size();
+        for (const auto &copyset : copysets) {
+            index->copySetIds.push_back(copyset.GetId());
+        }
+    } else if (!sameWeight) {
+        double sum = 0;
+        for (auto weight : weights) {
+            sum += weight;
+            index->weightPrefixSum.push_back(sum);
+        }
+    }
+
+    if (oldIndex != nullptr) {
+        index->nextIndex.store(oldIndex->nextIndex.load());
+    } else if (!index->copySetIds.empty()) {
         // TODO(xuchaojie): 后续可以使用剩余容量最大的作为起始。
         std::random_device rd;  // 将用于为随机数引擎获得种子
         std::mt19937 gen(rd());  // 以播种标准 mersenne_twister_engine
-        std::uniform_int_distribution<> dis(0, copySetIds.size() - 1);
-        nextIndex = dis(gen);
-        nextIndexMap_.emplace(logicalPoolChosenId, nextIndex);
+        std::uniform_int_distribution<> dis(0, index->copySetIds.size() - 1);
+        index->nextIndex.store(dis(gen));
     }
 
-    ret = AllocateChunkPolicy::AllocateChunkRoundRobinInSingleLogicalPool(
-               copySetIds,
-               logicalPoolChosenId,
-               &nextIndex,
-               chunkNumber,
-               infos);
-    if (ret) {
-        nextIndexMap_[logicalPoolChosenId] = nextIndex;
+    LOG(INFO) << "BuildAllocIndex success, logicalPoolId = " << logicalPoolId
+              << ", version = " << index->version
+              << ", copyset num = " << copysets.size()
+              << ", available copyset num = " << index->copySetIds.size()
+              << ", weighted = " << !index->weightPrefixSum.empty();
+    return index;
+}
+
+void TopologyChunkAllocatorImpl::GetChunkServerWeights(
+    const std::set<ChunkServerIdType> &chunkservers,
+    std::map<ChunkServerIdType, double> *weights) {
+    std::map<ChunkServerIdType, uint64_t> iopsMap;
+    uint64_t totalIops = 0;
+    for (auto csId : chunkservers) {
+        ChunkServer cs;
+        if (!topology_->GetChunkServer(csId, &cs) ||
+            cs.GetStatus() != ChunkServerStatus::READWRITE ||
+            cs.GetChunkServerState().GetDiskState() == DiskState::DISKERROR) {
+            (*weights)[csId] = 0;
+            continue;
+        }
+
+        ChunkServerStat stat;
+        if (topologyStat_ == nullptr ||
+            !topologyStat_->GetChunkServerStat(csId, &stat)) {
+            (*weights)[csId] = 1;
+            continue;
+        }
+
+        // 以剩余容量比例作为权值，使用率超过上限时不再分配
+        uint64_t total = stat.chunkSizeUsedBytes + stat.chunkSizeLeftBytes;
+        double weight = 1;
+        if (total > 0) {
+            if (stat.chunkSizeUsedBytes * 100 >=
+                total * poolUsagePercentLimit_) {
+                (*weights)[csId] = 0;
+                continue;
+            }
+            weight = static_cast<double>(stat.chunkSizeLeftBytes) / total;
+        }
+        (*weights)[csId] = weight;
+
+        uint64_t iops = stat.readIOPS + stat.writeIOPS;
+        iopsMap[csId] = iops;
+        totalIops += iops;
+    }
+
+    if (iopsMap.empty() || totalIops == 0) {
+        return;
+    }
+
+    // 负载等于平均值时系数为1，负载越高系数越小
+    double avgIops = static_cast<double>(totalIops) / iopsMap.size();
+    for (const auto &item : iopsMap) {
+        (*weights)[item.first] *= 2 * avgIops / (avgIops + item.second);
     }
-    return ret;
 }
 
 bool TopologyChunkAllocatorImpl::ChooseSingleLogicalPool(
@@ -205,7 +381,7 @@ bool TopologyChunkAllocatorImpl::ChooseSingleLogicalPool(
 }
 
 bool AllocateChunkPolicy::AllocateChunkRandomInSingleLogicalPool(
-    std::vector<CopySetIdType> copySetIds,
+    const std::vector<CopySetIdType> &copySetIds,
     PoolIdType logicalPoolId,
     uint32_t chunkNumber,
     std::vector<CopysetIdInfo> *infos) {
@@ -226,7 +402,7 @@ bool AllocateChunkPolicy::AllocateChunkRandomInSingleLogicalPool(
 }
 
 bool AllocateChunkPolicy::AllocateChunkRoundRobinInSingleLogicalPool(
-    std::vector<CopySetIdType> copySetIds,
+    const std::vector<CopySetIdType> &copySetIds,
     PoolIdType logicalPoolId,
     uint32_t *nextIndex,
     uint32_t chunkNumber,
@@ -247,6 +423,36 @@ bool AllocateChunkPolicy::AllocateChunkRoundRobinInSingleLogicalPool(
     return true;
 }
 
+bool AllocateChunkPolicy::AllocateChunkByWeightInSingleLogicalPool(
+    const std::vector<CopySetIdType> &copySetIds,
+    const std::vector<double> &weightPrefixSum,
+    PoolIdType logicalPoolId,
+    uint32_t chunkNumber,
+    std::vector<CopysetIdInfo> *infos) {
+    if (copySetIds.empty() || copySetIds.size() != weightPrefixSum.size() ||
+        weightPrefixSum.back() <= 0) {
+        return false;
+    }
+    infos->clear();
+
+    // 每个线程使用独立的随机数引擎，分配时无需加锁
+    static thread_local std::mt19937 gen(std::random_device{}());
+    std::uniform_real_distribution<> dis(0, weightPrefixSum.back());
+
+    for (uint32_t i = 0; i < chunkNumber; i++) {
+        auto it = std::upper_bound(weightPrefixSum.begin(),
+            weightPrefixSum.end(), dis(gen));
+        if (it == weightPrefixSum.end()) {
+            --it;
+        }
+        CopysetIdInfo idInfo;
+        idInfo.logicalPoolId = logicalPoolId;
+        idInfo.copySetId = copySetIds[it - weightPrefixSum.begin()];
+        infos->push_back(idInfo);
+    }
+    return true;
+}
+
 bool AllocateChunkPolicy::ChooseSingleLogicalPoolByWeight(
     const std::map<PoolIdType, double> &poolWeightMap,
     PoolIdType *poolIdOut) {
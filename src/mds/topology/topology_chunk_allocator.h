@@ -27,11 +27,15 @@
 #include <memory>
 #include <functional>
 #include <map>
+#include <atomic>
+#include <unordered_map>
+#include <set>
 
 #include "src/mds/topology/topology.h"
 #include "proto/nameserver2.pb.h"
 #include "src/common/concurrent/concurrent.h"
 #include "src/mds/topology/topology_item.h"
+#include "src/mds/topology/topology_stat.h"
 #include "src/mds/nameserver2/allocstatistic/alloc_statistic.h"
 
 namespace curve {
@@ -45,6 +49,30 @@ enum class ChoosePoolPolicy {
     kWeight,
 };
 
+/**
+ * @brief 单个逻辑池的chunk分配索引
+ * @detail
+ * - 构建之后只读，分配chunk时不再访问topology
+ * - copyset分布版本号变化或权值过期时重建
+ */
+struct CopySetAllocIndex {
+    // 构建时的copyset分布版本号
+    uint64_t version;
+    // 构建时间
+    uint64_t buildTimeMs;
+    // 可分配的copyset
+    std::vector<CopySetIdType> copySetIds;
+    // copyset权值的前缀和，为空时各copyset等概率分配
+    std::vector<double> weightPrefixSum;
+    // RoundRobin的下一个分配位置
+    std::atomic<uint64_t> nextIndex;
+
+    CopySetAllocIndex()
+        : version(0),
+          buildTimeMs(0),
+          nextIndex(0) {}
+};
+
 class TopologyChunkAllocator {
  public:
     TopologyChunkAllocator() {}
@@ -66,9 +94,22 @@ class TopologyChunkAllocatorImpl : public TopologyChunkAllocator {
     TopologyChunkAllocatorImpl(std::shared_ptr<Topology> topology,
         std::shared_ptr<AllocStatistic> allocStatistic,
         const TopologyOption &option)
+        : TopologyChunkAllocatorImpl(topology, allocStatistic,
+            nullptr, option) {}
+
+    /**
+     * @param topologyStat 不为空时根据chunkserver的容量和负载计算copyset权值
+     */
+    TopologyChunkAllocatorImpl(std::shared_ptr<Topology> topology,
+        std::shared_ptr<AllocStatistic> allocStatistic,
+        std::shared_ptr<TopologyStat> topologyStat,
+        const TopologyOption &option)
         : topology_(topology),
         allocStatistic_(allocStatistic),
+        topologyStat_(topologyStat),
         poolUsagePercentLimit_(option.PoolUsagePercentLimit),
+        weightUpdateIntervalMs_(option.CopySetWeightUpdateIntervalMs),
+        allocIndexes_(std::make_shared<AllocIndexMap>()),
         policy_(static_cast<ChoosePoolPolicy>(option.choosePoolPolicy)) {
         std::srand(std::time(nullptr));
     }
@@ -122,23 +163,76 @@ class TopologyChunkAllocatorImpl : public TopologyChunkAllocator {
     bool ChooseSingleLogicalPool(curve::mds::FileType fileType,
         PoolIdType *poolOut);
 
+    /**
+     * @brief 获取逻辑池的chunk分配索引，索引过期时重建
+     * @detail
+     * 已有索引时只由一个线程重建，其他线程继续使用旧索引，不会阻塞
+     *
+     * @param logicalPoolId 逻辑池id
+     *
+     * @return 分配索引
+     */
+    std::shared_ptr<CopySetAllocIndex> GetAllocIndex(
+        PoolIdType logicalPoolId);
+
+    /**
+     * @brief 判断分配索引是否需要重建
+     */
+    bool NeedRebuildAllocIndex(
+        const std::shared_ptr<CopySetAllocIndex> &index) const;
+
+    /**
+     * @brief 构建逻辑池的chunk分配索引
+     *
+     * @param logicalPoolId 逻辑池id
+     * @param oldIndex 旧的索引，用于延续RoundRobin的分配位置，可以为空
+     *
+     * @return 新的分配索引
+     */
+    std::shared_ptr<CopySetAllocIndex> BuildAllocIndex(
+        PoolIdType logicalPoolId,
+        const std::shared_ptr<CopySetAllocIndex> &oldIndex);
+
+    /**
+     * @brief 计算chunkserver的权值
+     * @detail
+     * - 非READWRITE状态或磁盘故障的chunkserver权值为0
+     * - 使用率超过poolUsagePercentLimit_的chunkserver权值为0
+     * - 其余chunkserver按剩余容量比例和相对于平均iops的负载计算权值
+     *
+     * @param chunkservers chunkserver列表
+     * @param[out] weights chunkserver的权值
+     */
+    void GetChunkServerWeights(const std::set<ChunkServerIdType> &chunkservers,
+        std::map<ChunkServerIdType, double> *weights);
+
  private:
+    using AllocIndexMap =
+        std::unordered_map<PoolIdType, std::shared_ptr<CopySetAllocIndex>>;
+
     std::shared_ptr<Topology> topology_;
 
     // 分配统计模块
     std::shared_ptr<AllocStatistic> allocStatistic_;
 
+    // 心跳上报的统计数据，用于计算copyset权值
+    std::shared_ptr<TopologyStat> topologyStat_;
+
     // pool使用百分比上限
     uint32_t poolUsagePercentLimit_;
 
+    // copyset权值的更新间隔
+    uint32_t weightUpdateIntervalMs_;
+
     /**
-     * @brief RoundRobin各逻辑池起始点map
+     * @brief 各逻辑池的分配索引，整体替换，
+     *        通过std::atomic_load/std::atomic_store访问
      */
-    std::map<PoolIdType, uint32_t> nextIndexMap_;
+    std::shared_ptr<const AllocIndexMap> allocIndexes_;
     /**
-     * @brief 保护上述map的锁
+     * @brief 重建分配索引的锁
      */
-    ::curve::common::Mutex nextIndexMapLock_;
+    ::curve::common::Mutex allocIndexBuildLock_;
     // 选pool策略
     ChoosePoolPolicy policy_;
 };
@@ -161,7 +255,7 @@ class AllocateChunkPolicy {
      * @retval false 分配失败
      */
     static bool AllocateChunkRandomInSingleLogicalPool(
-        std::vector<CopySetIdType> copySetIds,
+        const std::vector<CopySetIdType> &copySetIds,
         PoolIdType logicalPoolId,
         uint32_t chunkNumber,
         std::vector<CopysetIdInfo> *infos);
@@ -180,12 +274,31 @@ class AllocateChunkPolicy {
      * @retval false 分配失败
      */
     static bool AllocateChunkRoundRobinInSingleLogicalPool(
-        std::vector<CopySetIdType> copySetIds,
+        const std::vector<CopySetIdType> &copySetIds,
         PoolIdType logicalPoolId,
         uint32_t *nextIndex,
         uint32_t chunkNumber,
         std::vector<CopysetIdInfo> *infos);
 
+    /**
+     * @brief 在单个逻辑池中按copyset的权值随机分配若干个chunk
+     *
+     * @param copySetIds 指定逻辑池内的copysetId列表
+     * @param weightPrefixSum copyset权值的前缀和，与copySetIds一一对应
+     * @param logicalPoolId 逻辑池Id
+     * @param chunkNumber 分配chunk数
+     * @param infos 分配到的copyset列表
+     *
+     * @retval true 分配成功
+     * @retval false 分配失败
+     */
+    static bool AllocateChunkByWeightInSingleLogicalPool(
+        const std::vector<CopySetIdType> &copySetIds,
+        const std::vector<double> &weightPrefixSum,
+        PoolIdType logicalPoolId,
+        uint32_t chunkNumber,
+        std::vector<CopysetIdInfo> *infos);
+
     /**
      * @brief 根据权值选择单个逻辑池
      *
@@ -45,6 +45,8 @@ struct TopologyOption {
     uint32_t PoolUsagePercentLimit;
     // ChoosePoolPolicy
     int choosePoolPolicy;
+    // chunk分配时copyset权值的更新间隔
+    uint32_t CopySetWeightUpdateIntervalMs;
 
     TopologyOption()
         : TopologyUpdateToRepoSec(0),
@@ -53,7 +55,8 @@ struct TopologyOption {
           CreateCopysetRpcRetrySleepTimeMs(500),
           UpdateMetricIntervalSec(0),
           PoolUsagePercentLimit(100),
-          choosePoolPolicy(0) {}
+          choosePoolPolicy(0),
+          CopySetWeightUpdateIntervalMs(10000) {}
 };
 
 }  // namespace topology
@@ -82,6 +82,10 @@ class TopologyStorage {
     virtual bool UpdateChunkServer(const ChunkServer &data) = 0;
     virtual bool UpdateCopySet(const CopySetInfo &data) = 0;
 
+    // 批量更新，用于后台刷新dirty的chunkserver和copyset
+    virtual bool UpdateChunkServers(const std::vector<ChunkServer> &datas) = 0;
+    virtual bool UpdateCopySets(const std::vector<CopySetInfo> &datas) = 0;
+
     virtual bool LoadClusterInfo(std::vector<ClusterInformation> *info) = 0;
     virtual bool StorageClusterInfo(const ClusterInformation &info) = 0;
 };
@@ -479,6 +479,66 @@ bool TopologyStorageEtcd::UpdateCopySet(const CopySetInfo &data) {
     return StorageCopySet(data);
 }
 
+bool TopologyStorageEtcd::UpdateChunkServers(
+    const std::vector<ChunkServer> &datas) {
+    bool ret = true;
+    std::vector<KVPair> kvs;
+    kvs.reserve(datas.size());
+    for (const auto &data : datas) {
+        std::string value;
+        if (!codec_->EncodeChunkServerData(data, &value)) {
+            LOG(ERROR) << "EncodeChunkServerData err"
+                       << ", chunkServerId = " << data.GetId();
+            ret = false;
+            continue;
+        }
+        kvs.emplace_back(codec_->EncodeChunkServerKey(data.GetId()), value);
+    }
+
+    if (kvs.empty()) {
+        return ret;
+    }
+    int errCode = client_->BatchPut(kvs);
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "BatchPut ChunkServer into etcd err"
+                   << ", errcode = " << errCode
+                   << ", chunkserver num = " << kvs.size();
+        return false;
+    }
+    return ret;
+}
+
+bool TopologyStorageEtcd::UpdateCopySets(
+    const std::vector<CopySetInfo> &datas) {
+    bool ret = true;
+    std::vector<KVPair> kvs;
+    kvs.reserve(datas.size());
+    for (const auto &data : datas) {
+        std::string value;
+        if (!codec_->EncodeCopySetData(data, &value)) {
+            LOG(ERROR) << "EncodeCopySetData err"
+                       << ", logicalPoolId = " << data.GetLogicalPoolId()
+                       << ", copysetId = " << data.GetId();
+            ret = false;
+            continue;
+        }
+        CopySetKey id(data.GetLogicalPoolId(), data.GetId());
+        kvs.emplace_back(codec_->EncodeCopySetKey(id), value);
+    }
+
+    if (kvs.empty()) {
+        return ret;
+    }
+    int errCode = client_->BatchPut(kvs);
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "BatchPut Copyset into etcd err"
+                   << ", errcode = " << errCode
+                   << ", copyset num = " << kvs.size();
+        return false;
+    }
+    return ret;
+}
+
 bool TopologyStorageEtcd::LoadClusterInfo(
     std::vector<ClusterInformation> *info) {
     std::string key = TopologyStorageCodec::GetClusterInfoKey();
@@ -38,6 +38,7 @@ namespace topology {
 
 using ::curve::kvstorage::EtcdClientImp;
 using ::curve::kvstorage::KVStorageClient;
+using ::curve::kvstorage::KVPair;
 
 
 
@@ -88,6 +89,9 @@ class TopologyStorageEtcd : public TopologyStorage {
     bool UpdateChunkServer(const ChunkServer &data) override;
     bool UpdateCopySet(const CopySetInfo &data) override;
 
+    bool UpdateChunkServers(const std::vector<ChunkServer> &datas) override;
+    bool UpdateCopySets(const std::vector<CopySetInfo> &datas) override;
+
     bool LoadClusterInfo(std::vector<ClusterInformation> *info) override;
     bool StorageClusterInfo(const ClusterInformation &info) override;
 
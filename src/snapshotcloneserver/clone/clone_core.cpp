@@ -26,6 +26,10 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <map>
+#include <set>
+#include <utility>
+#include <algorithm>
 
 #include "src/snapshotcloneserver/clone/clone_task.h"
 #include "src/common/location_operator.h"
@@ -664,18 +668,54 @@ int CloneCoreImpl::CreateCloneChunk(
     } else {
         correctSn = fInfo.seqnum;
     }
+    if (createCloneChunkBatchSize_ > 0) {
+        ret = CreateCloneChunkInBatch(task, correctSn, chunkSize, segInfos);
+    } else {
+        ret = CreateCloneChunkOneByOne(task, correctSn, chunkSize, segInfos);
+    }
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (IsLazy(task) && IsFile(task)) {
+        task->GetCloneInfo().SetNextStep(CloneStep::kRecoverChunk);
+    } else {
+        task->GetCloneInfo().SetNextStep(CloneStep::kCompleteCloneMeta);
+    }
+    ret = metaStore_->UpdateCloneInfo(task->GetCloneInfo());
+    if (ret < 0) {
+        LOG(ERROR) << "UpdateCloneInfo after CreateCloneChunk error."
+                   << " ret = " << ret
+                   << ", taskid = " << task->GetTaskId();
+        return kErrCodeInternalError;
+    }
+    return kErrCodeSuccess;
+}
+
+std::string CloneCoreImpl::GetCloneChunkLocation(
+    std::shared_ptr<CloneTaskInfo> task,
+    const CloneChunkInfo &cloneChunkInfo) {
+    if (IsSnapshot(task)) {
+        return LocationOperator::GenerateS3Location(
+            cloneChunkInfo.location);
+    } else {
+        return LocationOperator::GenerateCurveLocation(
+            task->GetCloneInfo().GetSrc(),
+            std::stoull(cloneChunkInfo.location));
+    }
+}
+
+int CloneCoreImpl::CreateCloneChunkOneByOne(
+    std::shared_ptr<CloneTaskInfo> task,
+    uint64_t csn,
+    uint64_t chunkSize,
+    CloneSegmentMap *segInfos) {
+    int ret = kErrCodeSuccess;
     auto tracker = std::make_shared<CreateCloneChunkTaskTracker>();
     for (auto & cloneSegmentInfo : *segInfos) {
         for (auto & cloneChunkInfo : cloneSegmentInfo.second) {
-            std::string location;
-            if (IsSnapshot(task)) {
-                location = LocationOperator::GenerateS3Location(
-                    cloneChunkInfo.second.location);
-            } else {
-                location = LocationOperator::GenerateCurveLocation(
-                    task->GetCloneInfo().GetSrc(),
-                    std::stoull(cloneChunkInfo.second.location));
-            }
+            std::string location =
+                GetCloneChunkLocation(task, cloneChunkInfo.second);
             ChunkIDInfo cidInfo = cloneChunkInfo.second.chunkIdInfo;
 
             auto context = std::make_shared<CreateCloneChunkContext>();
@@ -683,7 +723,7 @@ int CloneCoreImpl::CreateCloneChunk(
             context->cidInfo = cidInfo;
             context->cloneChunkInfo = &cloneChunkInfo.second;
             context->sn = cloneChunkInfo.second.seqNum;
-            context->csn = correctSn;
+            context->csn = csn;
             context->chunkSize = chunkSize;
             context->taskid = task->GetTaskId();
             context->startTime = TimeUtility::GetTimeofDaySec();
@@ -720,26 +760,175 @@ int CloneCoreImpl::CreateCloneChunk(
             return kErrCodeInternalError;
         }
     } while (true);
+    return kErrCodeSuccess;
+}
 
-    if (IsLazy(task) && IsFile(task)) {
-        task->GetCloneInfo().SetNextStep(CloneStep::kRecoverChunk);
-    } else {
-        task->GetCloneInfo().SetNextStep(CloneStep::kCompleteCloneMeta);
+int CloneCoreImpl::CreateCloneChunkInBatch(
+    std::shared_ptr<CloneTaskInfo> task,
+    uint64_t csn,
+    uint64_t chunkSize,
+    CloneSegmentMap *segInfos) {
+    // 按copyset分组，同一copyset上的chunk在一条raft日志中创建
+    std::map<std::pair<LogicPoolID, CopysetID>,
+        std::vector<CloneChunkInfo *>> copysetChunks;
+    for (auto & cloneSegmentInfo : *segInfos) {
+        for (auto & cloneChunkInfo : cloneSegmentInfo.second) {
+            const ChunkIDInfo &cidInfo = cloneChunkInfo.second.chunkIdInfo;
+            copysetChunks[std::make_pair(cidInfo.lpid_, cidInfo.cpid_)]
+                .push_back(&cloneChunkInfo.second);
+        }
     }
-    ret = metaStore_->UpdateCloneInfo(task->GetCloneInfo());
-    if (ret < 0) {
-        LOG(ERROR) << "UpdateCloneInfo after CreateCloneChunk error."
-                   << " ret = " << ret
+
+    int ret = kErrCodeSuccess;
+    auto tracker = std::make_shared<CreateCloneChunksTaskTracker>();
+    for (auto & item : copysetChunks) {
+        std::vector<CloneChunkInfo *> &chunkInfos = item.second;
+        for (size_t begin = 0; begin < chunkInfos.size();
+            begin += createCloneChunkBatchSize_) {
+            size_t end = std::min<size_t>(
+                begin + createCloneChunkBatchSize_, chunkInfos.size());
+            auto context = std::make_shared<CreateCloneChunksContext>();
+            context->cidInfo = chunkInfos[begin]->chunkIdInfo;
+            for (size_t i = begin; i < end; i++) {
+                CloneChunkDesc chunk;
+                chunk.cid = chunkInfos[i]->chunkIdInfo.cid_;
+                chunk.seq = chunkInfos[i]->seqNum;
+                chunk.location = GetCloneChunkLocation(task, *chunkInfos[i]);
+                context->chunks.emplace_back(std::move(chunk));
+                context->cloneChunkInfos.push_back(chunkInfos[i]);
+            }
+            context->csn = csn;
+            context->chunkSize = chunkSize;
+            context->taskid = task->GetTaskId();
+            context->startTime = TimeUtility::GetTimeofDaySec();
+            context->clientAsyncMethodRetryTimeSec =
+                clientAsyncMethodRetryTimeSec_;
+
+            ret = StartAsyncCreateCloneChunks(task, tracker, context);
+            if (ret < 0) {
+                return kErrCodeInternalError;
+            }
+
+            if (tracker->GetTaskNum() >= createCloneChunkConcurrency_) {
+                tracker->WaitSome(1);
+            }
+            std::list<CreateCloneChunksContextPtr> results =
+                tracker->PopResultContexts();
+            ret = HandleCreateCloneChunksResultsAndRetry(
+                task, tracker, results);
+            if (ret < 0) {
+                return kErrCodeInternalError;
+            }
+        }
+    }
+    // 最后剩余数量不足的任务
+    do {
+        tracker->WaitSome(1);
+        std::list<CreateCloneChunksContextPtr> results =
+            tracker->PopResultContexts();
+        if (0 == results.size()) {
+            // 已经完成，没有新的结果了
+            break;
+        }
+        ret = HandleCreateCloneChunksResultsAndRetry(task, tracker, results);
+        if (ret < 0) {
+            return kErrCodeInternalError;
+        }
+    } while (true);
+    return kErrCodeSuccess;
+}
+
+int CloneCoreImpl::StartAsyncCreateCloneChunks(
+    std::shared_ptr<CloneTaskInfo> task,
+    std::shared_ptr<CreateCloneChunksTaskTracker> tracker,
+    std::shared_ptr<CreateCloneChunksContext> context) {
+    context->slot.Acquire(concurrencyController_,
+        task->GetCloneInfo().GetUser());
+    CreateCloneChunksClosure *cb =
+        new CreateCloneChunksClosure(tracker, context);
+    tracker->AddOneTrace();
+    context->existChunkIds.clear();
+    LOG(INFO) << "Doing CreateCloneChunks"
+              << ", logicalPoolId = " << context->cidInfo.lpid_
+              << ", copysetId = " << context->cidInfo.cpid_
+              << ", chunkId = " << context->cidInfo.cid_
+              << ", chunkNum = " << context->chunks.size()
+              << ", csn = " << context->csn
+              << ", taskid = " << task->GetTaskId();
+    int ret = client_->CreateCloneChunks(context->cidInfo,
+        context->chunks,
+        context->csn,
+        context->chunkSize,
+        &context->existChunkIds,
+        cb);
+
+    if (ret != LIBCURVE_ERROR::OK) {
+        context->slot.Release(false);
+        LOG(ERROR) << "CreateCloneChunks fail"
+                   << ", ret = " << ret
+                   << ", logicalPoolId = " << context->cidInfo.lpid_
+                   << ", copysetId = " << context->cidInfo.cpid_
+                   << ", chunkId = " << context->cidInfo.cid_
+                   << ", chunkNum = " << context->chunks.size()
+                   << ", csn = " << context->csn
                    << ", taskid = " << task->GetTaskId();
-        return kErrCodeInternalError;
+        return ret;
     }
     return kErrCodeSuccess;
 }
 
+int CloneCoreImpl::HandleCreateCloneChunksResultsAndRetry(
+    std::shared_ptr<CloneTaskInfo> task,
+    std::shared_ptr<CreateCloneChunksTaskTracker> tracker,
+    const std::list<CreateCloneChunksContextPtr> &results) {
+    int ret = kErrCodeSuccess;
+    for (auto context : results) {
+        if (context->retCode == LIBCURVE_ERROR::OK) {
+            std::set<ChunkID> existIds(context->existChunkIds.begin(),
+                                       context->existChunkIds.end());
+            for (auto cloneChunkInfo : context->cloneChunkInfos) {
+                const ChunkIDInfo &cidInfo = cloneChunkInfo->chunkIdInfo;
+                if (existIds.count(cidInfo.cid_) > 0) {
+                    LOG(INFO) << "CreateCloneChunks chunk exist"
+                              << ", logicalPoolId = " << cidInfo.lpid_
+                              << ", copysetId = " << cidInfo.cpid_
+                              << ", chunkId = " << cidInfo.cid_
+                              << ", seqNum = " << cloneChunkInfo->seqNum
+                              << ", csn = " << context->csn
+                              << ", taskid = " << task->GetTaskId();
+                    cloneChunkInfo->needRecover = false;
+                }
+            }
+        } else {
+            uint64_t nowTime = TimeUtility::GetTimeofDaySec();
+            if (nowTime - context->startTime <
+                context->clientAsyncMethodRetryTimeSec) {
+                // retry
+                std::this_thread::sleep_for(
+                    std::chrono::milliseconds(
+                        clientAsyncMethodRetryIntervalMs_));
+                ret = StartAsyncCreateCloneChunks(
+                    task, tracker, context);
+                if (ret < 0) {
+                    return kErrCodeInternalError;
+                }
+            } else {
+                LOG(ERROR) << "CreateCloneChunks tracker GetResult fail"
+                           << ", ret = " << ret
+                           << ", taskid = " << task->GetTaskId();
+                return kErrCodeInternalError;
+            }
+        }
+    }
+    return ret;
+}
+
 int CloneCoreImpl::StartAsyncCreateCloneChunk(
     std::shared_ptr<CloneTaskInfo> task,
     std::shared_ptr<CreateCloneChunkTaskTracker> tracker,
     std::shared_ptr<CreateCloneChunkContext> context) {
+    context->slot.Acquire(concurrencyController_,
+        task->GetCloneInfo().GetUser());
     CreateCloneChunkClosure *cb =
         new CreateCloneChunkClosure(tracker, context);
     tracker->AddOneTrace();
@@ -759,6 +948,7 @@ int CloneCoreImpl::StartAsyncCreateCloneChunk(
         cb);
 
     if (ret != LIBCURVE_ERROR::OK) {
+        context->slot.Release(false);
         LOG(ERROR) << "CreateCloneChunk fail"
                    << ", ret = " << ret
                    << ", location = " << context->location
@@ -859,8 +1049,10 @@ int CloneCoreImpl::RecoverChunk(
     double progressPerData = static_cast<double>(totalProgress) / segNum;
     uint32_t index = 0;
 
-    if (0 == cloneChunkSplitSize_ ||
-        chunkSize % cloneChunkSplitSize_ != 0) {
+    // 分片大小为0时按整个chunk恢复，由chunkserver一次从源端拷贝整个chunk
+    uint64_t partSize =
+        (0 == cloneChunkSplitSize_) ? chunkSize : cloneChunkSplitSize_;
+    if (chunkSize % partSize != 0) {
         LOG(ERROR) << "chunk is not align to cloneChunkSplitSize"
                    << ", taskid = " << task->GetTaskId();
         return kErrCodeChunkSizeNotAligned;
@@ -889,9 +1081,9 @@ int CloneCoreImpl::RecoverChunk(
             workingChunkNum++;
             auto context = std::make_shared<RecoverChunkContext>();
             context->cidInfo = cloneChunkInfo.second.chunkIdInfo;
-            context->totalPartNum = chunkSize / cloneChunkSplitSize_;
+            context->totalPartNum = chunkSize / partSize;
             context->partIndex = 0;
-            context->partSize = cloneChunkSplitSize_;
+            context->partSize = partSize;
             context->taskid = task->GetTaskId();
             context->startTime = TimeUtility::GetTimeofDaySec();
             context->clientAsyncMethodRetryTimeSec =
@@ -942,6 +1134,8 @@ int CloneCoreImpl::StartAsyncRecoverChunkPart(
     std::shared_ptr<CloneTaskInfo> task,
     std::shared_ptr<RecoverChunkTaskTracker> tracker,
     std::shared_ptr<RecoverChunkContext> context) {
+    context->slot.Acquire(concurrencyController_,
+        task->GetCloneInfo().GetUser());
     RecoverChunkClosure *cb = new RecoverChunkClosure(tracker, context);
     tracker->AddOneTrace();
     uint64_t offset = context->partIndex * context->partSize;
@@ -958,6 +1152,7 @@ int CloneCoreImpl::StartAsyncRecoverChunkPart(
         context->partSize,
         cb);
     if (ret != LIBCURVE_ERROR::OK) {
+        context->slot.Release(false);
         LOG(ERROR) << "RecoverChunk fail"
                    << ", ret = " << ret
                    << ", logicalPoolId = "
@@ -1314,6 +1509,12 @@ int CloneCoreImpl::GetCloneInfoByFileName(
     return metaStore_->GetCloneInfoByFileName(fileName, list);
 }
 
+int CloneCoreImpl::GetCloneInfoByUser(
+    const std::string &user, std::vector<CloneInfo> *list) {
+    metaStore_->GetCloneInfoByUser(user, list);
+    return kErrCodeSuccess;
+}
+
 inline bool CloneCoreImpl::IsLazy(std::shared_ptr<CloneTaskInfo> task) {
     return task->GetCloneInfo().GetIsLazy();
 }
@@ -36,6 +36,7 @@
 #include "src/snapshotcloneserver/common/snapshot_reference.h"
 #include "src/snapshotcloneserver/clone/clone_reference.h"
 #include "src/snapshotcloneserver/common/thread_pool.h"
+#include "src/snapshotcloneserver/common/concurrency_controller.h"
 #include "src/common/concurrent/name_lock.h"
 
 using ::curve::common::NameLock;
@@ -148,6 +149,17 @@ class CloneCore {
     virtual int GetCloneInfoByFileName(
     const std::string &fileName, std::vector<CloneInfo> *list) = 0;
 
+    /**
+     * @brief 获取指定用户的克隆/恢复任务
+     *
+     * @param user  用户名
+     * @param list 克隆/恢复任务列表
+     *
+     * @return 错误码
+     */
+    virtual int GetCloneInfoByUser(
+    const std::string &user, std::vector<CloneInfo> *list) = 0;
+
     /**
      * @brief 获取快照引用管理模块
      *
@@ -205,16 +217,20 @@ class CloneCoreImpl : public CloneCore {
         std::shared_ptr<SnapshotDataStore> dataStore,
         std::shared_ptr<SnapshotReference> snapshotRef,
         std::shared_ptr<CloneReference> cloneRef,
-        const SnapshotCloneServerOptions option)
+        const SnapshotCloneServerOptions option,
+        std::shared_ptr<ConcurrencyController> concurrencyController =
+            nullptr)
       : client_(client),
         metaStore_(metaStore),
         dataStore_(dataStore),
         snapshotRef_(snapshotRef),
         cloneRef_(cloneRef),
+        concurrencyController_(concurrencyController),
         cloneChunkSplitSize_(option.cloneChunkSplitSize),
         cloneTempDir_(option.cloneTempDir),
         mdsRootUser_(option.mdsRootUser),
         createCloneChunkConcurrency_(option.createCloneChunkConcurrency),
+        createCloneChunkBatchSize_(option.createCloneChunkBatchSize),
         recoverChunkConcurrency_(option.recoverChunkConcurrency),
         clientAsyncMethodRetryTimeSec_(option.clientAsyncMethodRetryTimeSec),
         clientAsyncMethodRetryIntervalMs_(
@@ -252,6 +268,9 @@ class CloneCoreImpl : public CloneCore {
     int GetCloneInfoByFileName(
         const std::string &fileName, std::vector<CloneInfo> *list) override;
 
+    int GetCloneInfoByUser(
+        const std::string &user, std::vector<CloneInfo> *list) override;
+
     std::shared_ptr<SnapshotReference> GetSnapshotRef() {
         return snapshotRef_;
     }
@@ -370,6 +389,79 @@ class CloneCoreImpl : public CloneCore {
         const FInfo &fInfo,
         CloneSegmentMap *segInfos);
 
+    /**
+     * @brief 生成clone chunk的数据源位置信息
+     *
+     * @param task 任务信息
+     * @param cloneChunkInfo chunk信息
+     *
+     * @return 数据源位置信息
+     */
+    std::string GetCloneChunkLocation(
+        std::shared_ptr<CloneTaskInfo> task,
+        const CloneChunkInfo &cloneChunkInfo);
+
+    /**
+     * @brief 逐个chunk创建新clone文件的chunk
+     *
+     * @param task 任务信息
+     * @param csn 用于修改chunk的correctedSn
+     * @param chunkSize chunk的大小
+     * @param segInfos 新文件所需的segment信息
+     *
+     * @return 错误码
+     */
+    int CreateCloneChunkOneByOne(
+        std::shared_ptr<CloneTaskInfo> task,
+        uint64_t csn,
+        uint64_t chunkSize,
+        CloneSegmentMap *segInfos);
+
+    /**
+     * @brief 按copyset分组批量创建新clone文件的chunk，
+     *        同一copyset上的chunk每createCloneChunkBatchSize_个一次请求
+     *
+     * @param task 任务信息
+     * @param csn 用于修改chunk的correctedSn
+     * @param chunkSize chunk的大小
+     * @param segInfos 新文件所需的segment信息
+     *
+     * @return 错误码
+     */
+    int CreateCloneChunkInBatch(
+        std::shared_ptr<CloneTaskInfo> task,
+        uint64_t csn,
+        uint64_t chunkSize,
+        CloneSegmentMap *segInfos);
+
+    /**
+     * @brief 开始CreateCloneChunks的异步请求
+     *
+     * @param task 任务信息
+     * @param tracker CreateCloneChunks任务追踪器
+     * @param context CreateCloneChunks上下文
+     *
+     * @return 错误码
+     */
+    int StartAsyncCreateCloneChunks(
+        std::shared_ptr<CloneTaskInfo> task,
+        std::shared_ptr<CreateCloneChunksTaskTracker> tracker,
+        std::shared_ptr<CreateCloneChunksContext> context);
+
+    /**
+     * @brief 处理CreateCloneChunks的结果并重试
+     *
+     * @param task 任务信息
+     * @param tracker CreateCloneChunks任务追踪器
+     * @param results CreateCloneChunks结果列表
+     *
+     * @return 错误码
+     */
+    int HandleCreateCloneChunksResultsAndRetry(
+        std::shared_ptr<CloneTaskInfo> task,
+        std::shared_ptr<CreateCloneChunksTaskTracker> tracker,
+        const std::list<CreateCloneChunksContextPtr> &results);
+
     /**
      * @brief 开始CreateCloneChunk的异步请求
      *
@@ -560,6 +652,8 @@ class CloneCoreImpl : public CloneCore {
     std::shared_ptr<SnapshotDataStore> dataStore_;
     std::shared_ptr<SnapshotReference> snapshotRef_;
     std::shared_ptr<CloneReference> cloneRef_;
+    // 数据搬迁的全局并发控制，为空时只受每个任务的并发数限制
+    std::shared_ptr<ConcurrencyController> concurrencyController_;
 
     // clone chunk分片大小
     uint64_t cloneChunkSplitSize_;
@@ -569,6 +663,8 @@ class CloneCoreImpl : public CloneCore {
     std::string mdsRootUser_;
     // CreateCloneChunk同时进行的异步请求数量
     uint32_t createCloneChunkConcurrency_;
+    // 一次CreateCloneChunks请求创建的chunk数量上限，0表示逐个创建
+    uint32_t createCloneChunkBatchSize_;
     // RecoverChunk同时进行的异步请求数量
     uint32_t recoverChunkConcurrency_;
     // client异步请求重试时间
@@ -242,10 +242,11 @@ int CloneServiceManager::Flatten(
 int CloneServiceManager::GetCloneTaskInfo(const std::string &user,
     std::vector<TaskCloneInfo> *info) {
     std::vector<CloneInfo> cloneInfos;
-    int ret = cloneCore_->GetCloneInfoList(&cloneInfos);
+    int ret = cloneCore_->GetCloneInfoByUser(user, &cloneInfos);
     if (ret < 0) {
-        LOG(ERROR) << "GetCloneInfoList fail"
-                   << ", ret = " << ret;
+        LOG(ERROR) << "GetCloneInfoByUser fail"
+                   << ", ret = " << ret
+                   << ", user = " << user;
         return kErrCodeFileNotExist;
     }
     return GetCloneTaskInfoInner(cloneInfos, user, info);
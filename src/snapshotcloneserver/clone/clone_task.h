@@ -25,6 +25,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "src/snapshotcloneserver/clone/clone_core.h"
 #include "src/snapshotcloneserver/common/define.h"
@@ -149,6 +150,8 @@ struct CreateCloneChunkContext {
     uint64_t clientAsyncMethodRetryTimeSec;
     // chunk信息
     struct CloneChunkInfo *cloneChunkInfo;
+    // 请求占用的全局并发额度
+    ConcurrencySlot slot;
 };
 
 using CreateCloneChunkContextPtr = std::shared_ptr<CreateCloneChunkContext>;
@@ -162,6 +165,9 @@ struct CreateCloneChunkClosure : public SnapCloneClosure {
     void Run() {
         std::unique_ptr<CreateCloneChunkClosure> self_guard(this);
         context_->retCode = GetRetCode();
+        // chunk已经存在是正常的返回，不是后端繁忙
+        context_->slot.Release(context_->retCode >= 0 ||
+            context_->retCode == -LIBCURVE_ERROR::EXISTS);
         if (context_->retCode < 0) {
             LOG(WARNING) << "CreateCloneChunkClosure return fail"
                        << ", ret = " << context_->retCode
@@ -180,6 +186,60 @@ struct CreateCloneChunkClosure : public SnapCloneClosure {
     CreateCloneChunkContextPtr context_;
 };
 
+struct CreateCloneChunksContext {
+    // copyset信息，chunk id为第一个要创建的chunk
+    ChunkIDInfo cidInfo;
+    // 要创建的chunk
+    std::vector<CloneChunkDesc> chunks;
+    // 与chunks一一对应的chunk信息
+    std::vector<struct CloneChunkInfo *> cloneChunkInfos;
+    // correctSn
+    uint64_t csn;
+    // chunk size
+    uint64_t chunkSize;
+    // 已存在且信息与请求不符的chunk
+    std::vector<ChunkID> existChunkIds;
+    // 返回值
+    int retCode;
+    // taskid
+    TaskIdType taskid;
+    // 异步请求开始时间
+    uint64_t startTime;
+    // 异步请求重试总时间
+    uint64_t clientAsyncMethodRetryTimeSec;
+    // 请求占用的全局并发额度
+    ConcurrencySlot slot;
+};
+
+using CreateCloneChunksContextPtr = std::shared_ptr<CreateCloneChunksContext>;
+
+struct CreateCloneChunksClosure : public SnapCloneClosure {
+    CreateCloneChunksClosure(
+        std::shared_ptr<CreateCloneChunksTaskTracker> tracker,
+        CreateCloneChunksContextPtr context)
+        : tracker_(tracker),
+          context_(context) {}
+    void Run() {
+        std::unique_ptr<CreateCloneChunksClosure> self_guard(this);
+        context_->retCode = GetRetCode();
+        context_->slot.Release(context_->retCode >= 0);
+        if (context_->retCode < 0) {
+            LOG(WARNING) << "CreateCloneChunksClosure return fail"
+                       << ", ret = " << context_->retCode
+                       << ", logicalPoolId = " << context_->cidInfo.lpid_
+                       << ", copysetId = " << context_->cidInfo.cpid_
+                       << ", chunkId = " << context_->cidInfo.cid_
+                       << ", chunkNum = " << context_->chunks.size()
+                       << ", csn = " << context_->csn
+                       << ", taskid = " << context_->taskid;
+        }
+        tracker_->PushResultContext(context_);
+        tracker_->HandleResponse(context_->retCode);
+    }
+    std::shared_ptr<CreateCloneChunksTaskTracker> tracker_;
+    CreateCloneChunksContextPtr context_;
+};
+
 struct RecoverChunkContext {
     // chunkid 信息
     ChunkIDInfo cidInfo;
@@ -197,6 +257,8 @@ struct RecoverChunkContext {
     uint64_t startTime;
     // 异步请求重试总时间
     uint64_t clientAsyncMethodRetryTimeSec;
+    // 请求占用的全局并发额度
+    ConcurrencySlot slot;
 };
 
 using RecoverChunkContextPtr = std::shared_ptr<RecoverChunkContext>;
@@ -209,6 +271,7 @@ struct RecoverChunkClosure : public SnapCloneClosure {
     void Run() {
         std::unique_ptr<RecoverChunkClosure> self_guard(this);
         context_->retCode = GetRetCode();
+        context_->slot.Release(context_->retCode >= 0);
         if (context_->retCode < 0) {
             LOG(WARNING) << "RecoverChunkClosure return fail"
                          << ", ret = " << context_->retCode
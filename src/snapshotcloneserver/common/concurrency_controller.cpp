@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include "src/snapshotcloneserver/common/concurrency_controller.h"
+
+#include <glog/logging.h>
+#include <algorithm>
+
+#include "src/common/timeutility.h"
+
+using ::curve::common::TimeUtility;
+
+namespace curve {
+namespace snapshotcloneserver {
+
+ConcurrencyController::ConcurrencyController(
+    const ConcurrencyControllerOption &option)
+    : option_(option),
+      inflight_(0),
+      waiting_(0),
+      lastChunkServerDecreaseUs_(0),
+      lastS3DecreaseUs_(0) {
+    option_.maxConcurrency = std::max<uint32_t>(option_.maxConcurrency, 1);
+    option_.minConcurrency = std::max<uint32_t>(option_.minConcurrency, 1);
+    option_.minConcurrency =
+        std::min(option_.minConcurrency, option_.maxConcurrency);
+    // 从上限开始，后端繁忙时再减小
+    limit_ = option_.maxConcurrency;
+    metric_.limit.set_value(option_.maxConcurrency);
+}
+
+void ConcurrencyController::Acquire(const std::string &tenant) {
+    std::unique_lock<Mutex> lk(mtx_);
+    TenantState &state = tenants_[tenant];
+    state.waiting++;
+    waiting_++;
+    if (!CanAcquire(tenant)) {
+        metric_.waiting << 1;
+        cv_.wait(lk, [this, &tenant] () {
+            return CanAcquire(tenant);
+        });
+        metric_.waiting << -1;
+    }
+    state.waiting--;
+    waiting_--;
+    state.inflight++;
+    inflight_++;
+    metric_.inflight << 1;
+}
+
+void ConcurrencyController::Release(const std::string &tenant) {
+    std::unique_lock<Mutex> lk(mtx_);
+    auto iter = tenants_.find(tenant);
+    if (iter == tenants_.end() || iter->second.inflight == 0) {
+        LOG(ERROR) << "Release concurrency without acquire"
+                   << ", tenant = " << tenant;
+        return;
+    }
+    iter->second.inflight--;
+    if (iter->second.inflight == 0 && iter->second.waiting == 0) {
+        tenants_.erase(iter);
+    }
+    inflight_--;
+    metric_.inflight << -1;
+    cv_.notify_all();
+}
+
+void ConcurrencyController::OnChunkServerResponse(
+    uint64_t latencyUs, bool success) {
+    std::unique_lock<Mutex> lk(mtx_);
+    OnResponse(latencyUs, option_.chunkServerLatencyTargetUs, success,
+        &lastChunkServerDecreaseUs_);
+}
+
+void ConcurrencyController::OnS3Response(uint64_t latencyUs, bool success) {
+    std::unique_lock<Mutex> lk(mtx_);
+    OnResponse(latencyUs, option_.s3LatencyTargetUs, success,
+        &lastS3DecreaseUs_);
+}
+
+uint32_t ConcurrencyController::GetLimit() const {
+    std::unique_lock<Mutex> lk(mtx_);
+    return static_cast<uint32_t>(limit_);
+}
+
+uint32_t ConcurrencyController::GetInflight() const {
+    std::unique_lock<Mutex> lk(mtx_);
+    return inflight_;
+}
+
+bool ConcurrencyController::CanAcquire(const std::string &tenant) {
+    if (inflight_ >= static_cast<uint32_t>(limit_)) {
+        return false;
+    }
+    const TenantState &state = tenants_[tenant];
+    uint32_t tenantNum = tenants_.size();
+    uint32_t share =
+        (static_cast<uint32_t>(limit_) + tenantNum - 1) / tenantNum;
+    if (state.inflight < share) {
+        return true;
+    }
+    // 超过公平份额时，只能使用其他租户不需要的额度
+    return waiting_ == state.waiting;
+}
+
+void ConcurrencyController::OnResponse(uint64_t latencyUs,
+    uint64_t targetUs, bool success, uint64_t *lastDecreaseUs) {
+    uint32_t oldLimit = static_cast<uint32_t>(limit_);
+    if (success && (0 == targetUs || latencyUs <= targetUs)) {
+        limit_ = std::min<double>(
+            option_.maxConcurrency, limit_ + 1.0 / limit_);
+    } else {
+        uint64_t now = TimeUtility::GetTimeofDayUs();
+        if (now - *lastDecreaseUs < targetUs ||
+            limit_ <= option_.minConcurrency) {
+            return;
+        }
+        *lastDecreaseUs = now;
+        limit_ = std::max<double>(
+            option_.minConcurrency, limit_ * option_.decreaseRatio);
+        metric_.decrease << 1;
+        LOG(INFO) << "Decrease data movement concurrency limit"
+                  << ", from " << oldLimit
+                  << " to " << static_cast<uint32_t>(limit_)
+                  << ", latencyUs = " << latencyUs
+                  << ", targetUs = " << targetUs
+                  << ", success = " << success;
+    }
+    uint32_t newLimit = static_cast<uint32_t>(limit_);
+    metric_.limit.set_value(newLimit);
+    if (newLimit > oldLimit) {
+        cv_.notify_all();
+    }
+}
+
+void ConcurrencySlot::Acquire(std::shared_ptr<ConcurrencyController> ctrl,
+    const std::string &user) {
+    if (nullptr == ctrl) {
+        return;
+    }
+    ctrl->Acquire(user);
+    controller = ctrl;
+    tenant = user;
+    startUs = TimeUtility::GetTimeofDayUs();
+}
+
+void ConcurrencySlot::Release(bool success) {
+    if (nullptr == controller) {
+        return;
+    }
+    controller->OnChunkServerResponse(
+        TimeUtility::GetTimeofDayUs() - startUs, success);
+    controller->Release(tenant);
+    controller = nullptr;
+}
+
+}  // namespace snapshotcloneserver
+}  // namespace curve
@@ -0,0 +1,186 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#ifndef SRC_SNAPSHOTCLONESERVER_COMMON_CONCURRENCY_CONTROLLER_H_
+#define SRC_SNAPSHOTCLONESERVER_COMMON_CONCURRENCY_CONTROLLER_H_
+
+#include <bvar/bvar.h>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "src/common/concurrent/concurrent.h"
+
+using ::curve::common::Mutex;
+using ::curve::common::ConditionVariable;
+
+namespace curve {
+namespace snapshotcloneserver {
+
+struct ConcurrencyControllerOption {
+    // 全局并发数的上限和下限
+    uint32_t maxConcurrency;
+    uint32_t minConcurrency;
+    // chunkserver请求的延迟超过该值时认为后端繁忙(单位：us)
+    uint64_t chunkServerLatencyTargetUs;
+    // s3上传分片的延迟超过该值时认为后端繁忙(单位：us)
+    uint64_t s3LatencyTargetUs;
+    // 后端繁忙时并发数乘以该系数
+    double decreaseRatio;
+
+    ConcurrencyControllerOption() : maxConcurrency(0)
+                                  , minConcurrency(1)
+                                  , chunkServerLatencyTargetUs(0)
+                                  , s3LatencyTargetUs(0)
+                                  , decreaseRatio(0.5) {}
+};
+
+struct ConcurrencyControllerMetric {
+    const std::string prefix = "snapshotcloneserver_concurrency_controller_";
+
+    // 当前的全局并发上限
+    bvar::Status<uint32_t> limit;
+    // 正在进行的请求数
+    bvar::Adder<int64_t> inflight;
+    // 因为超过全局上限或者租户份额而等待的请求数
+    bvar::Adder<int64_t> waiting;
+    // 并发上限减小的次数
+    bvar::Adder<uint64_t> decrease;
+
+    ConcurrencyControllerMetric() :
+        limit(prefix, "limit", 0),
+        inflight(prefix, "inflight"),
+        waiting(prefix, "waiting"),
+        decrease(prefix, "decrease") {}
+};
+
+/**
+ * @brief 快照转储和克隆的数据搬迁请求的全局并发控制
+ * @detail
+ *  所有快照和克隆任务发往chunkserver的异步请求都需要先获取一个并发额度，
+ *  全局并发上限按照AIMD调整：
+ *  - chunkserver请求或s3上传成功且延迟低于目标时，每完成一个窗口的请求，
+ *    上限加1
+ *  - 请求失败或延迟超过目标时，上限乘以decreaseRatio，同一后端两次减小
+ *    至少间隔一个目标延迟，避免同一窗口内的慢请求连续减小
+ *  额度在租户(用户)之间公平分配，租户占用的额度超过公平份额时，
+ *  只有在没有其他租户等待时才能继续获取
+ */
+class ConcurrencyController {
+ public:
+    explicit ConcurrencyController(const ConcurrencyControllerOption &option);
+
+    /**
+     * @brief 获取一个并发额度，超过全局上限或租户份额时阻塞
+     *
+     * @param tenant 租户
+     */
+    void Acquire(const std::string &tenant);
+
+    /**
+     * @brief 归还一个并发额度
+     *
+     * @param tenant 租户
+     */
+    void Release(const std::string &tenant);
+
+    /**
+     * @brief 反馈一次chunkserver请求的结果
+     *
+     * @param latencyUs 请求的延迟
+     * @param success 请求是否成功
+     */
+    void OnChunkServerResponse(uint64_t latencyUs, bool success);
+
+    /**
+     * @brief 反馈一次s3上传的结果
+     *
+     * @param latencyUs 上传的延迟
+     * @param success 上传是否成功
+     */
+    void OnS3Response(uint64_t latencyUs, bool success);
+
+    uint32_t GetLimit() const;
+
+    uint32_t GetInflight() const;
+
+ private:
+    struct TenantState {
+        uint32_t inflight;
+        uint32_t waiting;
+
+        TenantState() : inflight(0), waiting(0) {}
+    };
+
+    // 以下函数需要持有mtx_
+    bool CanAcquire(const std::string &tenant);
+    void OnResponse(uint64_t latencyUs, uint64_t targetUs, bool success,
+                    uint64_t *lastDecreaseUs);
+
+ private:
+    ConcurrencyControllerOption option_;
+
+    mutable Mutex mtx_;
+    ConditionVariable cv_;
+    // 全局并发上限，加性增加时每次增加1/limit_，因此使用浮点数
+    double limit_;
+    uint32_t inflight_;
+    // 等待获取额度的请求数
+    uint32_t waiting_;
+    // 有请求正在进行或等待的租户
+    std::map<std::string, TenantState> tenants_;
+    // 上次因为chunkserver和s3繁忙减小上限的时间
+    uint64_t lastChunkServerDecreaseUs_;
+    uint64_t lastS3DecreaseUs_;
+
+    ConcurrencyControllerMetric metric_;
+};
+
+/**
+ * @brief 异步请求占用的并发额度，请求完成时归还并反馈请求的延迟
+ */
+struct ConcurrencySlot {
+    std::shared_ptr<ConcurrencyController> controller;
+    std::string tenant;
+    // 获取额度的时间
+    uint64_t startUs;
+
+    ConcurrencySlot() : startUs(0) {}
+
+    /**
+     * @brief 获取额度，controller为空时不做并发控制
+     */
+    void Acquire(std::shared_ptr<ConcurrencyController> ctrl,
+                 const std::string &user);
+
+    /**
+     * @brief 归还额度，未获取额度时直接返回
+     *
+     * @param success 请求是否成功，chunk已存在等正常的返回也是成功，
+     *        只有请求失败时才认为后端繁忙
+     */
+    void Release(bool success);
+};
+
+}  // namespace snapshotcloneserver
+}  // namespace curve
+
+#endif  // SRC_SNAPSHOTCLONESERVER_COMMON_CONCURRENCY_CONTROLLER_H_
@@ -67,6 +67,12 @@ struct SnapshotCloneServerOptions {
     uint32_t mdsSessionTimeUs;
     // ReadChunkSnapshot同时进行的异步请求数量
     uint32_t readChunkSnapshotConcurrency;
+    // 转储时是否跳过数据全为0的chunk
+    bool elideZeroChunk;
+    // 每个chunk转储时同时异步上传到s3的分片数量，0表示同步上传
+    uint32_t uploadPartConcurrency;
+    // 是否按内容哈希存储数据chunk，相同内容的chunk只保存一份
+    bool contentAddressedChunk;
 
     // 用于Lazy克隆元数据部分的线程池线程数
     int stage1PoolThreadNum;
@@ -76,7 +82,7 @@ struct SnapshotCloneServerOptions {
     int commonPoolThreadNum;
     // CloneTaskManager 后台线程扫描间隔
     uint32_t cloneTaskManagerScanIntervalMs;
-    // clone chunk分片大小
+    // clone chunk分片大小，0表示按整个chunk恢复
     uint64_t cloneChunkSplitSize;
     // 克隆临时目录
     std::string cloneTempDir;
@@ -84,8 +90,18 @@ struct SnapshotCloneServerOptions {
     std::string mdsRootUser;
     // CreateCloneChunk同时进行的异步请求数量
     uint32_t createCloneChunkConcurrency;
+    // 一次CreateCloneChunks请求创建的chunk数量上限，0表示逐个创建
+    uint32_t createCloneChunkBatchSize;
     // RecoverChunk同时进行的异步请求数量
     uint32_t recoverChunkConcurrency;
+    // 数据搬迁请求的全局并发上限，0表示不启用全局自适应并发控制
+    uint32_t dataMovementMaxConcurrency;
+    // 数据搬迁请求的全局并发下限
+    uint32_t dataMovementMinConcurrency;
+    // chunkserver请求延迟超过该值时减小全局并发(单位：ms)
+    uint32_t dataMovementChunkServerLatencyTargetMs;
+    // s3上传分片延迟超过该值时减小全局并发(单位：ms)
+    uint32_t dataMovementS3LatencyTargetMs;
 };
 
 }  // namespace snapshotcloneserver
@@ -217,6 +217,26 @@ int CurveFsClientImpl::CreateCloneChunk(
         clientMethodRetryIntervalMs_);
 }
 
+int CurveFsClientImpl::CreateCloneChunks(
+    const ChunkIDInfo &copysetidinfo,
+    const std::vector<CloneChunkDesc> &chunks,
+    uint64_t csn,
+    uint64_t chunkSize,
+    std::vector<ChunkID> *existChunkIds,
+    SnapCloneClosure* scc) {
+    RetryMethod method = [this, &copysetidinfo, &chunks,
+        csn, chunkSize, existChunkIds, scc] () {
+        return snapClient_->CreateCloneChunks(copysetidinfo, chunks,
+                csn, chunkSize, existChunkIds, scc);
+    };
+    RetryCondition condition = [] (int ret) {
+        return ret < 0;
+    };
+    RetryHelper retryHelper(method, condition);
+    return retryHelper.RetryTimeSecAndReturn(clientMethodRetryTimeSec_,
+        clientMethodRetryIntervalMs_);
+}
+
 int CurveFsClientImpl::RecoverChunk(
     const ChunkIDInfo &chunkidinfo,
     uint64_t offset,
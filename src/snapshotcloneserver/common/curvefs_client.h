@@ -44,7 +44,9 @@ using ::curve::client::LogicPoolID;
 using ::curve::client::CopysetID;
 using ::curve::client::ChunkID;
 using ::curve::client::ChunkInfoDetail;
+using ::curve::client::ChunkChangedInfo;
 using ::curve::client::ChunkIDInfo;
+using ::curve::client::CloneChunkDesc;
 using ::curve::client::FInfo;
 using ::curve::client::FileStatus;
 using ::curve::client::SnapCloneClosure;
@@ -256,6 +258,26 @@ class CurveFsClient {
         uint64_t chunkSize,
         SnapCloneClosure* scc) = 0;
 
+    /**
+     * @brief 批量创建同一copyset上的clone chunk，所有chunk在一条raft日志中创建
+     *
+     * @param copysetidinfo 目标copyset，chunk id为第一个要创建的chunk
+     * @param chunks 要创建的chunk
+     * @param csn correct sn
+     * @param chunkSize chunk的大小
+     * @param existChunkIds 出参，已存在且信息与请求不符的chunk，scc执行前填充
+     * @param: scc是异步回调
+     *
+     * @return 错误码
+     */
+    virtual int CreateCloneChunks(
+        const ChunkIDInfo &copysetidinfo,
+        const std::vector<CloneChunkDesc> &chunks,
+        uint64_t csn,
+        uint64_t chunkSize,
+        std::vector<ChunkID> *existChunkIds,
+        SnapCloneClosure* scc) = 0;
+
 
     /**
      * @brief 实际恢复chunk数据
@@ -462,6 +484,14 @@ class CurveFsClientImpl : public CurveFsClient {
         uint64_t chunkSize,
         SnapCloneClosure* scc) override;
 
+    int CreateCloneChunks(
+        const ChunkIDInfo &copysetidinfo,
+        const std::vector<CloneChunkDesc> &chunks,
+        uint64_t csn,
+        uint64_t chunkSize,
+        std::vector<ChunkID> *existChunkIds,
+        SnapCloneClosure* scc) override;
+
     int RecoverChunk(
         const ChunkIDInfo &chunkidinfo,
         uint64_t offset,
@@ -125,12 +125,55 @@ class SnapshotCloneMetaStore {
     virtual int GetCloneInfoByFileName(
         const std::string &fileName, std::vector<CloneInfo> *list) = 0;
 
+    /**
+     * @brief 获取指定用户的clone任务信息
+     *
+     * @param user 用户名
+     * @param[out] clone记录信息的指针
+     * @return: 0 获取成功/ -1 获取失败
+     */
+    virtual int GetCloneInfoByUser(
+        const std::string &user, std::vector<CloneInfo> *list) = 0;
+
     /**
      * @brief 获取所有clone任务的信息列表
      * @param[out] 只想clone任务vector指针
      * @return: 0 获取成功/ -1 获取失败
      */
     virtual int GetCloneInfoList(std::vector<CloneInfo> *list) = 0;
+
+    /**
+     * @brief 增加数据chunk对按内容存储的对象的引用，
+     *        同一个数据chunk重复增加时只计一次
+     *
+     * @param name 数据chunk名
+     * @param hash 数据chunk的内容哈希
+     * @param[out] refCount 该内容当前的引用数
+     * @return: 0 增加成功/ -1 增加失败
+     */
+    virtual int AddChunkDataRef(const std::string &name,
+        const std::string &hash, uint32_t *refCount) = 0;
+
+    /**
+     * @brief 获取数据chunk引用的内容哈希
+     *
+     * @param name 数据chunk名
+     * @param[out] hash 数据chunk的内容哈希
+     * @return: 0 获取成功/ -1 该数据chunk没有引用
+     */
+    virtual int GetChunkDataRef(const std::string &name,
+        std::string *hash) = 0;
+
+    /**
+     * @brief 删除数据chunk对按内容存储的对象的引用
+     *
+     * @param name 数据chunk名
+     * @param hash 数据chunk的内容哈希
+     * @param[out] refCount 该内容剩余的引用数
+     * @return: 0 删除成功/ -1 删除失败
+     */
+    virtual int RemoveChunkDataRef(const std::string &name,
+        const std::string &hash, uint32_t *refCount) = 0;
 };
 
 }  // namespace snapshotcloneserver
@@ -37,6 +37,10 @@ int SnapshotCloneMetaStoreEtcd::Init() {
     if (ret < 0) {
         return -1;
     }
+    ret = LoadChunkDataRefs();
+    if (ret < 0) {
+        return -1;
+    }
     return 0;
 }
 
@@ -59,7 +63,14 @@ int SnapshotCloneMetaStoreEtcd::AddSnapshot(const SnapshotInfo &info) {
         return -1;
     }
 
-    snapInfos_.emplace(info.GetUuid(), info);
+    auto search = snapInfos_.find(info.GetUuid());
+    if (search != snapInfos_.end()) {
+        RemoveSnapshotIndex(search->second);
+        search->second = info;
+    } else {
+        snapInfos_.emplace(info.GetUuid(), info);
+    }
+    AddSnapshotIndex(info);
     return 0;
 }
 
@@ -75,6 +86,7 @@ int SnapshotCloneMetaStoreEtcd::DeleteSnapshot(const UUID &uuid) {
     }
     auto search = snapInfos_.find(uuid);
     if (search != snapInfos_.end()) {
+        RemoveSnapshotIndex(search->second);
         snapInfos_.erase(search);
     }
     return 0;
@@ -90,6 +102,15 @@ int SnapshotCloneMetaStoreEtcd::UpdateSnapshot(const SnapshotInfo &info) {
         return -1;
     }
     WriteLockGuard guard(snapInfos_mutex);
+    auto search = snapInfos_.find(info.GetUuid());
+    if (search != snapInfos_.end()) {
+        // 记录没有变化时不需要写etcd
+        std::string oldValue;
+        if (codec_->EncodeSnapshotData(search->second, &oldValue) &&
+            oldValue == value) {
+            return 0;
+        }
+    }
     int errCode = client_->Put(key, value);
     if (errCode != EtcdErrCode::EtcdOK) {
         LOG(ERROR) << "Put snapInfo into etcd err"
@@ -97,12 +118,13 @@ int SnapshotCloneMetaStoreEtcd::UpdateSnapshot(const SnapshotInfo &info) {
                    << ", snapInfo : " << info;
         return -1;
     }
-    auto search = snapInfos_.find(info.GetUuid());
     if (search != snapInfos_.end()) {
+        RemoveSnapshotIndex(search->second);
         search->second = info;
     } else {
         snapInfos_.emplace(info.GetUuid(), info);
     }
+    AddSnapshotIndex(info);
     return 0;
 }
 
@@ -120,12 +142,12 @@ int SnapshotCloneMetaStoreEtcd::GetSnapshotInfo(
 int SnapshotCloneMetaStoreEtcd::GetSnapshotList(const std::string &filename,
     std::vector<SnapshotInfo> *v) {
     ReadLockGuard guard(snapInfos_mutex);
-    for (auto it = snapInfos_.begin();
-         it != snapInfos_.end();
-         it++) {
-        if (filename == it->second.GetFileName()) {
-            v->push_back(it->second);
-        }
+    auto index = snapFileIndex_.find(filename);
+    if (index == snapFileIndex_.end()) {
+        return -1;
+    }
+    for (auto &uuid : index->second) {
+        v->push_back(snapInfos_.at(uuid));
     }
     if (v->size() != 0) {
         return 0;
@@ -169,7 +191,14 @@ int SnapshotCloneMetaStoreEtcd::AddCloneInfo(const CloneInfo &info) {
                    << ", cloneInfo : " << info;
         return -1;
     }
-    cloneInfos_.emplace(info.GetTaskId(), info);
+    auto search = cloneInfos_.find(info.GetTaskId());
+    if (search != cloneInfos_.end()) {
+        RemoveCloneInfoIndex(search->second);
+        search->second = info;
+    } else {
+        cloneInfos_.emplace(info.GetTaskId(), info);
+    }
+    AddCloneInfoIndex(info);
     return 0;
 }
 
@@ -185,6 +214,7 @@ int SnapshotCloneMetaStoreEtcd::DeleteCloneInfo(const std::string &uuid) {
     }
     auto search = cloneInfos_.find(uuid);
     if (search != cloneInfos_.end()) {
+        RemoveCloneInfoIndex(search->second);
         cloneInfos_.erase(search);
     }
     return 0;
@@ -200,6 +230,15 @@ int SnapshotCloneMetaStoreEtcd::UpdateCloneInfo(const CloneInfo &info) {
         return -1;
     }
     WriteLockGuard guard(cloneInfos_lock_);
+    auto search = cloneInfos_.find(info.GetTaskId());
+    if (search != cloneInfos_.end()) {
+        // 记录没有变化时不需要写etcd
+        std::string oldValue;
+        if (codec_->EncodeCloneInfoData(search->second, &oldValue) &&
+            oldValue == value) {
+            return 0;
+        }
+    }
     int errCode = client_->Put(key, value);
     if (errCode != EtcdErrCode::EtcdOK) {
         LOG(ERROR) << "Put cloneInfo into etcd err"
@@ -207,12 +246,13 @@ int SnapshotCloneMetaStoreEtcd::UpdateCloneInfo(const CloneInfo &info) {
                    << ", cloneInfo : " << info;
         return -1;
     }
-    auto search = cloneInfos_.find(info.GetTaskId());
     if (search != cloneInfos_.end()) {
+        RemoveCloneInfoIndex(search->second);
         search->second = info;
     } else {
         cloneInfos_.emplace(info.GetTaskId(), info);
     }
+    AddCloneInfoIndex(info);
     return 0;
 }
 
@@ -230,10 +270,28 @@ int SnapshotCloneMetaStoreEtcd::GetCloneInfo(
 int SnapshotCloneMetaStoreEtcd::GetCloneInfoByFileName(
     const std::string &fileName, std::vector<CloneInfo> *list) {
     ReadLockGuard guard(cloneInfos_lock_);
-    for (auto it = cloneInfos_.begin(); it != cloneInfos_.end(); it++) {
-        if (it->second.GetDest() == fileName) {
-            list->push_back(it->second);
-        }
+    auto index = cloneFileIndex_.find(fileName);
+    if (index == cloneFileIndex_.end()) {
+        return -1;
+    }
+    for (auto &taskId : index->second) {
+        list->push_back(cloneInfos_.at(taskId));
+    }
+    if (list->size() != 0) {
+        return 0;
+    }
+    return -1;
+}
+
+int SnapshotCloneMetaStoreEtcd::GetCloneInfoByUser(
+    const std::string &user, std::vector<CloneInfo> *list) {
+    ReadLockGuard guard(cloneInfos_lock_);
+    auto index = cloneUserIndex_.find(user);
+    if (index == cloneUserIndex_.end()) {
+        return -1;
+    }
+    for (auto &taskId : index->second) {
+        list->push_back(cloneInfos_.at(taskId));
     }
     if (list->size() != 0) {
         return 0;
@@ -272,6 +330,7 @@ int SnapshotCloneMetaStoreEtcd::LoadSnapshotInfos() {
             return -1;
         }
         snapInfos_.emplace(data.GetUuid(), data);
+        AddSnapshotIndex(data);
     }
     LOG(INFO) << "LoadSnapshotInfos size = " << snapInfos_.size();
     return 0;
@@ -295,11 +354,146 @@ int SnapshotCloneMetaStoreEtcd::LoadCloneInfos() {
             return -1;
         }
         cloneInfos_.emplace(data.GetTaskId(), data);
+        AddCloneInfoIndex(data);
     }
     LOG(INFO) << "LoadCloneInfos size = " << cloneInfos_.size();
     return 0;
 }
 
+int SnapshotCloneMetaStoreEtcd::LoadChunkDataRefs() {
+    std::string startKey = SnapshotCloneCodec::GetChunkDataRefKeyPrefix();
+    std::string endKey = SnapshotCloneCodec::GetChunkDataRefKeyEnd();
+    WriteLockGuard guard(chunkDataRefs_lock_);
+    std::vector<std::string> out;
+    int errCode = client_->List(startKey, endKey, &out);
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "etcd list err:" << errCode;
+        return -1;
+    }
+    for (int i = 0; i < out.size(); i++) {
+        std::string name;
+        std::string hash;
+        if (!codec_->DecodeChunkDataRefData(out[i], &name, &hash)) {
+            LOG(ERROR) << "DecodeChunkDataRefData err";
+            return -1;
+        }
+        if (chunkDataRefs_.emplace(name, hash).second) {
+            chunkDataRefCounts_[hash]++;
+        }
+    }
+    LOG(INFO) << "LoadChunkDataRefs size = " << chunkDataRefs_.size()
+              << ", content num = " << chunkDataRefCounts_.size();
+    return 0;
+}
+
+int SnapshotCloneMetaStoreEtcd::AddChunkDataRef(const std::string &name,
+    const std::string &hash, uint32_t *refCount) {
+    WriteLockGuard guard(chunkDataRefs_lock_);
+    auto search = chunkDataRefs_.find(name);
+    if (search != chunkDataRefs_.end()) {
+        if (search->second != hash) {
+            LOG(ERROR) << "ChunkData already refer to another content"
+                       << ", name = " << name
+                       << ", hash = " << search->second
+                       << ", new hash = " << hash;
+            return -1;
+        }
+        *refCount = chunkDataRefCounts_[hash];
+        return 0;
+    }
+
+    std::string key = codec_->EncodeChunkDataRefKey(name);
+    std::string value;
+    if (!codec_->EncodeChunkDataRefData(name, hash, &value)) {
+        LOG(ERROR) << "EncodeChunkDataRefData err"
+                   << ", name = " << name;
+        return -1;
+    }
+    int errCode = client_->Put(key, value);
+    if (errCode != EtcdErrCode::EtcdOK) {
+        LOG(ERROR) << "Put chunkDataRef into etcd err"
+                   << ", errcode = " << errCode
+                   << ", name = " << name;
+        return -1;
+    }
+    chunkDataRefs_.emplace(name, hash);
+    *refCount = ++chunkDataRefCounts_[hash];
+    return 0;
+}
+
+int SnapshotCloneMetaStoreEtcd::GetChunkDataRef(const std::string &name,
+    std::string *hash) {
+    ReadLockGuard guard(chunkDataRefs_lock_);
+    auto search = chunkDataRefs_.find(name);
+    if (search == chunkDataRefs_.end()) {
+        return -1;
+    }
+    *hash = search->second;
+    return 0;
+}
+
+int SnapshotCloneMetaStoreEtcd::RemoveChunkDataRef(const std::string &name,
+    const std::string &hash, uint32_t *refCount) {
+    WriteLockGuard guard(chunkDataRefs_lock_);
+    auto search = chunkDataRefs_.find(name);
+    if (search != chunkDataRefs_.end()) {
+        std::string key = codec_->EncodeChunkDataRefKey(name);
+        int errCode = client_->Delete(key);
+        if (errCode != EtcdErrCode::EtcdOK) {
+            LOG(ERROR) << "delete chunkDataRef from etcd err"
+                       << ", errcode = " << errCode
+                       << ", name = " << name;
+            return -1;
+        }
+        auto count = chunkDataRefCounts_.find(search->second);
+        if (count != chunkDataRefCounts_.end() && --count->second == 0) {
+            chunkDataRefCounts_.erase(count);
+        }
+        chunkDataRefs_.erase(search);
+    }
+    // 引用已经删除时也返回成功，使删除可以重试
+    auto count = chunkDataRefCounts_.find(hash);
+    *refCount = (count == chunkDataRefCounts_.end()) ? 0 : count->second;
+    return 0;
+}
+
+void SnapshotCloneMetaStoreEtcd::AddSnapshotIndex(const SnapshotInfo &info) {
+    snapFileIndex_[info.GetFileName()].insert(info.GetUuid());
+}
+
+void SnapshotCloneMetaStoreEtcd::RemoveSnapshotIndex(
+    const SnapshotInfo &info) {
+    auto index = snapFileIndex_.find(info.GetFileName());
+    if (index != snapFileIndex_.end()) {
+        index->second.erase(info.GetUuid());
+        if (index->second.empty()) {
+            snapFileIndex_.erase(index);
+        }
+    }
+}
+
+void SnapshotCloneMetaStoreEtcd::AddCloneInfoIndex(const CloneInfo &info) {
+    cloneFileIndex_[info.GetDest()].insert(info.GetTaskId());
+    cloneUserIndex_[info.GetUser()].insert(info.GetTaskId());
+}
+
+void SnapshotCloneMetaStoreEtcd::RemoveCloneInfoIndex(const CloneInfo &info) {
+    auto index = cloneFileIndex_.find(info.GetDest());
+    if (index != cloneFileIndex_.end()) {
+        index->second.erase(info.GetTaskId());
+        if (index->second.empty()) {
+            cloneFileIndex_.erase(index);
+        }
+    }
+    index = cloneUserIndex_.find(info.GetUser());
+    if (index != cloneUserIndex_.end()) {
+        index->second.erase(info.GetTaskId());
+        if (index->second.empty()) {
+            cloneUserIndex_.erase(index);
+        }
+    }
+}
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
 
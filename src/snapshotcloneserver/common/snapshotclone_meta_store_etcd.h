@@ -26,6 +26,7 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <set>
 #include <string>
 
 #include "src/snapshotcloneserver/common/snapshotclone_meta_store.h"
@@ -77,8 +78,19 @@ class SnapshotCloneMetaStoreEtcd : public SnapshotCloneMetaStore {
     int GetCloneInfoByFileName(
         const std::string &fileName, std::vector<CloneInfo> *list) override;
 
+    int GetCloneInfoByUser(
+        const std::string &user, std::vector<CloneInfo> *list) override;
+
     int GetCloneInfoList(std::vector<CloneInfo> *list) override;
 
+    int AddChunkDataRef(const std::string &name,
+        const std::string &hash, uint32_t *refCount) override;
+
+    int GetChunkDataRef(const std::string &name, std::string *hash) override;
+
+    int RemoveChunkDataRef(const std::string &name,
+        const std::string &hash, uint32_t *refCount) override;
+
  private:
     /**
      * @brief 加载快照信息
@@ -94,6 +106,19 @@ class SnapshotCloneMetaStoreEtcd : public SnapshotCloneMetaStore {
      */
     int LoadCloneInfos();
 
+    /**
+     * @brief 加载数据chunk的引用
+     *
+     * @return 0 加载成功/ -1 加载失败
+     */
+    int LoadChunkDataRefs();
+
+    // 以下函数维护二级索引，需要持有对应map的写锁
+    void AddSnapshotIndex(const SnapshotInfo &info);
+    void RemoveSnapshotIndex(const SnapshotInfo &info);
+    void AddCloneInfoIndex(const CloneInfo &info);
+    void RemoveCloneInfoIndex(const CloneInfo &info);
+
  private:
     std::shared_ptr<KVStorageClient> client_;
     std::shared_ptr<SnapshotCloneCodec> codec_;
@@ -102,10 +127,22 @@ class SnapshotCloneMetaStoreEtcd : public SnapshotCloneMetaStore {
     std::map<UUID, SnapshotInfo> snapInfos_;
     // snap info lock
     RWLock snapInfos_mutex;
+    // 文件名 -> 该文件的快照uuid，由snapInfos_mutex保护
+    std::map<std::string, std::set<UUID>> snapFileIndex_;
     // key is TaskIdType, map 需要考虑并发保护
     std::map<std::string, CloneInfo> cloneInfos_;
+    // 目标文件名 -> clone任务id，由cloneInfos_lock_保护
+    std::map<std::string, std::set<TaskIdType>> cloneFileIndex_;
+    // 用户名 -> clone任务id，由cloneInfos_lock_保护
+    std::map<std::string, std::set<TaskIdType>> cloneUserIndex_;
     // clone info map lock
     RWLock cloneInfos_lock_;
+    // 数据chunk名 -> 引用的内容哈希
+    std::map<std::string, std::string> chunkDataRefs_;
+    // 内容哈希 -> 引用数
+    std::map<std::string, uint32_t> chunkDataRefCounts_;
+    // 保护chunkDataRefs_和chunkDataRefCounts_
+    RWLock chunkDataRefs_lock_;
 };
 
 }  // namespace snapshotcloneserver
@@ -22,6 +22,8 @@
 
 #include "src/snapshotcloneserver/common/snapshotclonecodec.h"
 
+#include "proto/snapshotcloneserver.pb.h"
+
 namespace curve {
 namespace snapshotcloneserver {
 
@@ -59,6 +61,32 @@ bool SnapshotCloneCodec::DecodeCloneInfoData(
     return data->ParseFromString(value);
 }
 
+std::string SnapshotCloneCodec::EncodeChunkDataRefKey(
+    const std::string &name) {
+    std::string key = SnapshotCloneCodec::GetChunkDataRefKeyPrefix();
+    key += name;
+    return key;
+}
+
+bool SnapshotCloneCodec::EncodeChunkDataRefData(const std::string &name,
+    const std::string &hash, std::string *value) {
+    ChunkDataRefData data;
+    data.set_name(name);
+    data.set_hash(hash);
+    return data.SerializeToString(value);
+}
+
+bool SnapshotCloneCodec::DecodeChunkDataRefData(const std::string &value,
+    std::string *name, std::string *hash) {
+    ChunkDataRefData data;
+    if (!data.ParseFromString(value)) {
+        return false;
+    }
+    *name = data.name();
+    *hash = data.hash();
+    return true;
+}
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
 
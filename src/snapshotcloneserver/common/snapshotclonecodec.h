@@ -32,6 +32,8 @@ using ::curve::common::SNAPINFOKEYPREFIX;
 using ::curve::common::SNAPINFOKEYEND;
 using ::curve::common::CLONEINFOKEYPREFIX;
 using ::curve::common::CLONEINFOKEYEND;
+using ::curve::common::CHUNKDATAREFKEYPREFIX;
+using ::curve::common::CHUNKDATAREFKEYEND;
 
 namespace curve {
 namespace snapshotcloneserver {
@@ -46,6 +48,14 @@ class SnapshotCloneCodec {
     bool EncodeCloneInfoData(const CloneInfo &data, std::string *value);
     bool DecodeCloneInfoData(const std::string &value, CloneInfo *data);
 
+    std::string EncodeChunkDataRefKey(const std::string &name);
+    bool EncodeChunkDataRefData(const std::string &name,
+                                const std::string &hash,
+                                std::string *value);
+    bool DecodeChunkDataRefData(const std::string &value,
+                                std::string *name,
+                                std::string *hash);
+
     static std::string GetSnapshotInfoKeyPrefix() {
         return std::string(SNAPINFOKEYPREFIX);
     }
@@ -61,6 +71,14 @@ class SnapshotCloneCodec {
     static std::string GetCloneInfoKeyEnd() {
         return std::string(CLONEINFOKEYEND);
     }
+
+    static std::string GetChunkDataRefKeyPrefix() {
+        return std::string(CHUNKDATAREFKEYPREFIX);
+    }
+
+    static std::string GetChunkDataRefKeyEnd() {
+        return std::string(CHUNKDATAREFKEYEND);
+    }
 };
 
 }  // namespace snapshotcloneserver
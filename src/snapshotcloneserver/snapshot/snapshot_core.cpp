@@ -30,14 +30,52 @@
 #include "src/snapshotcloneserver/snapshot/snapshot_task.h"
 
 #include "src/common/uuid.h"
+#include "src/common/bitmap.h"
 
 using ::curve::common::UUIDGenerator;
 using ::curve::common::NameLockGuard;
 using ::curve::common::LockGuard;
+using ::curve::common::Bitmap;
 
 namespace curve {
 namespace snapshotcloneserver {
 
+namespace {
+
+/**
+ * @brief 将chunkserver记录的写过的block转换为写过的分片
+ *
+ * @return false表示记录不合法
+ */
+bool BuildChangedParts(const ChunkChangedInfo &changedInfo,
+    uint64_t chunkSize,
+    uint64_t chunkSplitSize,
+    std::vector<bool> *changedParts) {
+    uint64_t blockSize = changedInfo.blockSize;
+    if (0 == blockSize || 0 == chunkSplitSize ||
+        chunkSize % blockSize != 0 || chunkSize % chunkSplitSize != 0) {
+        return false;
+    }
+    uint64_t blockNum = chunkSize / blockSize;
+    if (changedInfo.bitmap.size() != (blockNum + 8 - 1) / 8) {
+        return false;
+    }
+    Bitmap blocks(blockNum, changedInfo.bitmap.data());
+    changedParts->assign(chunkSize / chunkSplitSize, false);
+    for (uint32_t i = blocks.NextSetBit(0);
+        i != Bitmap::NO_POS;
+        i = blocks.NextSetBit(i + 1)) {
+        uint64_t begin = i * blockSize / chunkSplitSize;
+        uint64_t end = ((i + 1) * blockSize - 1) / chunkSplitSize;
+        for (uint64_t j = begin; j <= end; j++) {
+            (*changedParts)[j] = true;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 int SnapshotCoreImpl::Init() {
     int ret = threadPool_->Start();
     if (ret < 0) {
@@ -223,6 +261,8 @@ void SnapshotCoreImpl::HandleCreateSnapshotTask(
     ChunkIndexDataName name(fileName, seqNum);
     // the key is segment index
     std::map<uint64_t, SegmentInfo> segInfos;
+    // 重新加载的索引块没有写过区域的记录，全量转储
+    ChunkDataChangeMap changes;
     if (existIndexData) {
         ret = dataStore_->GetChunkIndexData(name, &indexData);
         if (ret < 0) {
@@ -247,7 +287,8 @@ void SnapshotCoreImpl::HandleCreateSnapshotTask(
             return;
         }
     } else {
-        ret = BuildChunkIndexData(*info, &indexData, &segInfos, task);
+        ret = BuildChunkIndexData(*info, &indexData, &segInfos, &changes,
+            task);
         if (ret < 0) {
             LOG(ERROR) << "BuildChunkIndexData error, "
                        << " ret = " << ret
@@ -293,17 +334,19 @@ void SnapshotCoreImpl::HandleCreateSnapshotTask(
     task->UpdateMetric();
 
     if (existIndexData) {
-        ret = TransferSnapshotData(indexData,
+        ret = TransferSnapshotData(&indexData,
             *info,
             segInfos,
+            changes,
             [this] (const ChunkDataName &chunkDataName) {
                 return dataStore_->ChunkDataExist(chunkDataName);
             },
             task);
     } else {
-        ret = TransferSnapshotData(indexData,
+        ret = TransferSnapshotData(&indexData,
             *info,
             segInfos,
+            changes,
             [&fileSnapshotMap] (const ChunkDataName &chunkDataName) {
                 return fileSnapshotMap.IsExistChunk(chunkDataName);
             },
@@ -401,9 +444,8 @@ void SnapshotCoreImpl::CancelAfterTransferSnapshotData(
     for (auto &chunkIndex : chunkIndexVec) {
         ChunkDataName chunkDataName;
         indexData.GetChunkDataName(chunkIndex, &chunkDataName);
-        if ((!fileSnapshotMap.IsExistChunk(chunkDataName)) &&
-            (dataStore_->ChunkDataExist(chunkDataName))) {
-            int ret =  dataStore_->DeleteChunkData(chunkDataName);
+        if (!fileSnapshotMap.IsExistChunk(chunkDataName)) {
+            int ret = RemoveChunkData(chunkDataName);
             if (ret < 0) {
                 LOG(ERROR) << "DeleteChunkData error"
                            << "while canceling CreateSnapshot, "
@@ -649,6 +691,7 @@ int SnapshotCoreImpl::BuildChunkIndexData(
     const SnapshotInfo &info,
     ChunkIndexData *indexData,
     std::map<uint64_t, SegmentInfo> *segInfos,
+    ChunkDataChangeMap *changes,
     std::shared_ptr<SnapshotTaskInfo> task) {
     std::string fileName = info.GetFileName();
     std::string user = info.GetUser();
@@ -694,19 +737,13 @@ int SnapshotCoreImpl::BuildChunkIndexData(
                 //    大于时, 表示打快照时为空，是快照之后首次写的版本(seqNum+1)
                 // 没有sn，从未写过
                 // 大于2个sn，错误，报错
+                uint64_t seq = 0;
                 if (chunkInfo.chunkSn.size() == 2) {
-                    uint64_t seq =
-                        std::min(chunkInfo.chunkSn[0],
+                    seq = std::min(chunkInfo.chunkSn[0],
                                 chunkInfo.chunkSn[1]);
-                    chunkIndex = i * (segmentSize / chunkSize) + j;
-                    ChunkDataName chunkDataName(fileName, seq, chunkIndex);
-                    indexData->PutChunkDataName(chunkDataName);
                 } else if (chunkInfo.chunkSn.size() == 1) {
-                    uint64_t seq = chunkInfo.chunkSn[0];
-                    if (seq <= seqNum) {
-                        chunkIndex = i * (segmentSize / chunkSize) + j;
-                        ChunkDataName chunkDataName(fileName, seq, chunkIndex);
-                        indexData->PutChunkDataName(chunkDataName);
+                    if (chunkInfo.chunkSn[0] <= seqNum) {
+                        seq = chunkInfo.chunkSn[0];
                     }
                 } else if (chunkInfo.chunkSn.size() == 0) {
                     // nothing
@@ -718,6 +755,22 @@ int SnapshotCoreImpl::BuildChunkIndexData(
                                << ", uuid = " << task->GetUuid();
                     return kErrCodeInternalError;
                 }
+                if (seq != 0) {
+                    chunkIndex = i * (segmentSize / chunkSize) + j;
+                    ChunkDataName chunkDataName(fileName, seq, chunkIndex);
+                    indexData->PutChunkDataName(chunkDataName);
+                    // 记录该版本相对上一个版本写过的分片，用于增量转储
+                    auto it = chunkInfo.changedInfo.find(seq);
+                    ChunkDataChange change;
+                    if (it != chunkInfo.changedInfo.end() &&
+                        it->second.baseSn < seq &&
+                        BuildChangedParts(it->second, chunkSize,
+                            chunkSplitSize_, &change.changedParts)) {
+                        change.baseName = ChunkDataName(
+                            fileName, it->second.baseSn, chunkIndex);
+                        changes->emplace(chunkIndex, std::move(change));
+                    }
+                }
                 if (task->IsCanceled()) {
                     return kErrCodeSuccess;
                 }
@@ -779,9 +832,10 @@ int SnapshotCoreImpl::BuildSegmentInfo(
 }
 
 int SnapshotCoreImpl::TransferSnapshotData(
-    const ChunkIndexData indexData,
+    ChunkIndexData *indexData,
     const SnapshotInfo &info,
     const std::map<uint64_t, SegmentInfo> &segInfos,
+    const ChunkDataChangeMap &changes,
     const ChunkDataExistFilter &filter,
     std::shared_ptr<SnapshotTaskInfo> task) {
     int ret = 0;
@@ -795,7 +849,7 @@ int SnapshotCoreImpl::TransferSnapshotData(
         return kErrCodeChunkSizeNotAligned;
     }
 
-    std::vector<ChunkIndexType> chunkIndexVec = indexData.GetAllChunkIndex();
+    std::vector<ChunkIndexType> chunkIndexVec = indexData->GetAllChunkIndex();
 
     uint32_t totalProgress = kProgressTransferSnapshotDataComplete -
         kProgressTransferSnapshotDataStart;
@@ -832,23 +886,68 @@ int SnapshotCoreImpl::TransferSnapshotData(
     }
 
     auto tracker = std::make_shared<TaskTracker>();
+    std::vector<std::shared_ptr<TransferSnapshotDataChunkTaskInfo>>
+        transferTaskInfos;
+    // 按内容存储时，已经转储过的chunk只需要在索引块中记录内容哈希
+    uint32_t hashChunkNum = 0;
     for (auto &chunkIndex : chunkIndexVec) {
         ChunkDataName chunkDataName;
-        indexData.GetChunkDataName(chunkIndex, &chunkDataName);
+        indexData->GetChunkDataName(chunkIndex, &chunkDataName);
         uint64_t segNum = chunkIndex / chunkPerSegment;
         uint64_t chunkIndexInSegment = chunkIndex % chunkPerSegment;
 
+        bool exist = false;
+        if (contentAddressedChunk_ &&
+            (!chunkDataName.contentHash_.empty() ||
+             metaStore_->GetChunkDataRef(chunkDataName.ToLogicalChunkKey(),
+                 &chunkDataName.contentHash_) == 0)) {
+            // 与之前的快照共用或者任务重启前已经转储的chunk，
+            // 有引用但对象不存在说明上次上传没有完成
+            exist = dataStore_->ChunkDataExist(chunkDataName);
+            if (exist) {
+                indexData->SetChunkDataHash(chunkIndex,
+                    chunkDataName.contentHash_);
+                hashChunkNum++;
+            }
+        } else {
+            exist = filter(chunkDataName);
+        }
+
         auto it = segInfos.find(segNum);
         if (it != segInfos.end()) {
             ChunkIDInfo cidInfo =
                 it->second.chunkvec[chunkIndexInSegment];
-            if (!filter(chunkDataName)) {
+            if (!exist) {
                 auto taskInfo =
                     std::make_shared<TransferSnapshotDataChunkTaskInfo>(
                         chunkDataName, chunkSize, cidInfo, chunkSplitSize_,
                         clientAsyncMethodRetryTimeSec_,
                         clientAsyncMethodRetryIntervalMs_,
-                        readChunkSnapshotConcurrency_);
+                        readChunkSnapshotConcurrency_,
+                        elideZeroChunk_);
+                taskInfo->concurrencyController_ = concurrencyController_;
+                taskInfo->user_ = info.GetUser();
+                taskInfo->uploadPartConcurrency_ = uploadPartConcurrency_;
+                auto change = changes.find(chunkIndex);
+                if (contentAddressedChunk_) {
+                    // 对象名由整个chunk的内容决定，需要全量读取
+                    taskInfo->contentAddressed_ = true;
+                    taskInfo->addChunkDataRef_ = [this] (
+                        const ChunkDataName &name, bool *needTransfer) {
+                        return AddChunkDataRef(name, needTransfer);
+                    };
+                    taskInfo->releaseChunkDataRef_ = [this] (
+                        const ChunkDataName &name) {
+                        bool released = false;
+                        return ReleaseChunkDataRef(name, &released);
+                    };
+                } else if (change != changes.end() &&
+                    filter(change->second.baseName)) {
+                    // 上一个版本已经转储过时，只需要读取写过的分片
+                    taskInfo->baseName_ = change->second.baseName;
+                    taskInfo->changedParts_ = change->second.changedParts;
+                }
+                transferTaskInfos.push_back(taskInfo);
                 UUID taskId = UUIDGenerator().GenerateUUID();
                 auto task = new TransferSnapshotDataChunkTask(
                     taskId,
@@ -889,6 +988,32 @@ int SnapshotCoreImpl::TransferSnapshotData(
         return ret;
     }
 
+    // 全0的chunk没有转储，从索引中移除，与未写过的chunk一样，
+    // 克隆时不需要创建和恢复
+    uint32_t zeroChunkNum = 0;
+    for (auto &taskInfo : transferTaskInfos) {
+        if (taskInfo->isZeroChunk_) {
+            indexData->DeleteChunkDataName(taskInfo->name_.chunkIndex_);
+            zeroChunkNum++;
+        } else if (!taskInfo->name_.contentHash_.empty()) {
+            indexData->SetChunkDataHash(taskInfo->name_.chunkIndex_,
+                taskInfo->name_.contentHash_);
+            hashChunkNum++;
+        }
+    }
+    if (zeroChunkNum > 0 || hashChunkNum > 0) {
+        ChunkIndexDataName name(info.GetFileName(), info.GetSeqNum());
+        ret = dataStore_->PutChunkIndexData(name, *indexData);
+        if (ret < 0) {
+            LOG(ERROR) << "PutChunkIndexData after transfer fail"
+                       << ", ret = " << ret
+                       << ", uuid = " << task->GetUuid();
+            return ret;
+        }
+        LOG(INFO) << "TransferSnapshotData elide " << zeroChunkNum
+                  << " zero chunks, " << hashChunkNum
+                  << " content addressed chunks, uuid = " << task->GetUuid();
+    }
     return kErrCodeSuccess;
 }
 
@@ -1009,9 +1134,8 @@ void SnapshotCoreImpl::HandleDeleteSnapshotTask(
         for (auto &chunkIndex : chunkIndexVec) {
             ChunkDataName chunkDataName;
             indexData.GetChunkDataName(chunkIndex, &chunkDataName);
-            if ((!fileSnapshotMap.IsExistChunk(chunkDataName)) &&
-                (dataStore_->ChunkDataExist(chunkDataName))) {
-                ret =  dataStore_->DeleteChunkData(chunkDataName);
+            if (!fileSnapshotMap.IsExistChunk(chunkDataName)) {
+                ret = RemoveChunkData(chunkDataName);
                 if (ret < 0) {
                     LOG(ERROR) << "DeleteChunkData error, "
                                << " ret = " << ret
@@ -1161,6 +1285,79 @@ int SnapshotCoreImpl::HandleCancelUnSchduledSnapshotTask(
     return kErrCodeSuccess;
 }
 
+int SnapshotCoreImpl::AddChunkDataRef(const ChunkDataName &name,
+    bool *needTransfer) {
+    NameLockGuard lockGuard(chunkDataRefLock_, name.contentHash_);
+    uint32_t refCount = 0;
+    int ret = metaStore_->AddChunkDataRef(name.ToLogicalChunkKey(),
+        name.contentHash_, &refCount);
+    if (ret < 0) {
+        LOG(ERROR) << "AddChunkDataRef fail"
+                   << ", ret = " << ret
+                   << ", chunkDataName = " << name.ToLogicalChunkKey()
+                   << ", hash = " << name.contentHash_;
+        return kErrCodeInternalError;
+    }
+    // 其他引用者可能还在上传，以对象是否存在为准，重复上传的内容相同
+    *needTransfer = !dataStore_->ChunkDataExist(name);
+    return kErrCodeSuccess;
+}
+
+int SnapshotCoreImpl::ReleaseChunkDataRef(const ChunkDataName &name,
+    bool *released) {
+    std::string logicalName = name.ToLogicalChunkKey();
+    ChunkDataName casName = name;
+    *released = false;
+    if (metaStore_->GetChunkDataRef(logicalName,
+        &casName.contentHash_) < 0) {
+        return kErrCodeSuccess;
+    }
+    *released = true;
+    NameLockGuard lockGuard(chunkDataRefLock_, casName.contentHash_);
+    uint32_t refCount = 0;
+    int ret = metaStore_->RemoveChunkDataRef(logicalName,
+        casName.contentHash_, &refCount);
+    if (ret < 0) {
+        LOG(ERROR) << "RemoveChunkDataRef fail"
+                   << ", ret = " << ret
+                   << ", chunkDataName = " << logicalName
+                   << ", hash = " << casName.contentHash_;
+        return kErrCodeInternalError;
+    }
+    if (refCount > 0 || !dataStore_->ChunkDataExist(casName)) {
+        return kErrCodeSuccess;
+    }
+    ret = dataStore_->DeleteChunkData(casName);
+    if (ret < 0) {
+        LOG(ERROR) << "DeleteChunkData error"
+                   << ", ret = " << ret
+                   << ", chunkDataName = " << logicalName
+                   << ", hash = " << casName.contentHash_;
+        // 恢复引用，使重试时可以再次删除对象
+        metaStore_->AddChunkDataRef(logicalName, casName.contentHash_,
+            &refCount);
+        return ret;
+    }
+    return kErrCodeSuccess;
+}
+
+int SnapshotCoreImpl::RemoveChunkData(const ChunkDataName &name) {
+    if (contentAddressedChunk_ || !name.contentHash_.empty()) {
+        bool released = false;
+        int ret = ReleaseChunkDataRef(name, &released);
+        if (ret < 0 || released) {
+            return ret;
+        }
+    }
+    // 按逻辑名称存储的数据chunk
+    ChunkDataName logicalName = name;
+    logicalName.contentHash_.clear();
+    if (dataStore_->ChunkDataExist(logicalName)) {
+        return dataStore_->DeleteChunkData(logicalName);
+    }
+    return kErrCodeSuccess;
+}
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
 
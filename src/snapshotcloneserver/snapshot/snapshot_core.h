@@ -36,6 +36,7 @@
 #include "src/snapshotcloneserver/common/snapshot_reference.h"
 #include "src/common/concurrent/name_lock.h"
 #include "src/snapshotcloneserver/common/thread_pool.h"
+#include "src/snapshotcloneserver/common/concurrency_controller.h"
 
 using ::curve::common::NameLock;
 
@@ -70,6 +71,19 @@ struct FileSnapMap {
     }
 };
 
+/**
+ * @brief 快照chunk相对上一个版本写过的区域，用于增量转储
+ */
+struct ChunkDataChange {
+    // 上一个版本的数据chunk
+    ChunkDataName baseName;
+    // 相对上一个版本写过的分片
+    std::vector<bool> changedParts;
+};
+
+// key为chunk索引
+using ChunkDataChangeMap = std::map<ChunkIndexType, ChunkDataChange>;
+
 /**
  * @brief 快照核心模块
  */
@@ -166,17 +180,21 @@ class SnapshotCoreImpl : public SnapshotCore {
       * @param client curve客户端对象
       * @param metaStore  meta存储对象
       * @param dataStore  data存储对象
+      * @param concurrencyController 数据搬迁的全局并发控制，可以为空
       */
     SnapshotCoreImpl(
         std::shared_ptr<CurveFsClient> client,
         std::shared_ptr<SnapshotCloneMetaStore> metaStore,
         std::shared_ptr<SnapshotDataStore> dataStore,
         std::shared_ptr<SnapshotReference> snapshotRef,
-        const SnapshotCloneServerOptions &option)
+        const SnapshotCloneServerOptions &option,
+        std::shared_ptr<ConcurrencyController> concurrencyController =
+            nullptr)
     : client_(client),
       metaStore_(metaStore),
       dataStore_(dataStore),
       snapshotRef_(snapshotRef),
+      concurrencyController_(concurrencyController),
       chunkSplitSize_(option.chunkSplitSize),
       checkSnapshotStatusIntervalMs_(option.checkSnapshotStatusIntervalMs),
       maxSnapshotLimit_(option.maxSnapshotLimit),
@@ -185,7 +203,10 @@ class SnapshotCoreImpl : public SnapshotCore {
       clientAsyncMethodRetryTimeSec_(option.clientAsyncMethodRetryTimeSec),
       clientAsyncMethodRetryIntervalMs_(
                 option.clientAsyncMethodRetryIntervalMs),
-      readChunkSnapshotConcurrency_(option.readChunkSnapshotConcurrency) {
+      readChunkSnapshotConcurrency_(option.readChunkSnapshotConcurrency),
+      elideZeroChunk_(option.elideZeroChunk),
+      uploadPartConcurrency_(option.uploadPartConcurrency),
+      contentAddressedChunk_(option.contentAddressedChunk) {
         threadPool_ = std::make_shared<ThreadPool>(
             option.snapshotCoreThreadNum);
     }
@@ -279,6 +300,7 @@ class SnapshotCoreImpl : public SnapshotCore {
      * @param info 快照信息
      * @param[out] indexData 索引块
      * @param[out] segInfos Segment信息
+     * @param[out] changes chunkserver记录了写过区域的chunk
      * @param task 快照任务信息
      *
      * @return 错误码
@@ -287,6 +309,7 @@ class SnapshotCoreImpl : public SnapshotCore {
         const SnapshotInfo &info,
         ChunkIndexData *indexData,
         std::map<uint64_t, SegmentInfo> *segInfos,
+        ChunkDataChangeMap *changes,
         std::shared_ptr<SnapshotTaskInfo> task);
 
     using ChunkDataExistFilter =
@@ -294,19 +317,26 @@ class SnapshotCoreImpl : public SnapshotCore {
 
     /**
      * @brief 转储快照过程
+     *        数据全为0的chunk不转储，并从索引块中移除后重新保存索引块
+     *        上一个版本已经转储过的chunk，只读取写过的分片，其余分片从
+     *        上一个版本的数据chunk拷贝
+     *        按内容存储时不做增量转储，内容已经存在的chunk只增加引用，
+     *        转储完成后将内容哈希记录到索引块中
      *
-     * @param indexData 索引块
+     * @param[in,out] indexData 索引块
      * @param info 快照信息
      * @param segInfos Segment信息
+     * @param changes chunk相对上一个版本写过的区域
      * @param filter 转储数据块过滤器
      * @param task 快照任务信息
      *
      * @return  错误码
      */
     int TransferSnapshotData(
-        const ChunkIndexData indexData,
+        ChunkIndexData *indexData,
         const SnapshotInfo &info,
         const std::map<uint64_t, SegmentInfo> &segInfos,
+        const ChunkDataChangeMap &changes,
         const ChunkDataExistFilter &filter,
         std::shared_ptr<SnapshotTaskInfo> task);
 
@@ -390,6 +420,35 @@ class SnapshotCoreImpl : public SnapshotCore {
     int ClearErrorSnapBeforeCreateSnapshot(
         std::shared_ptr<SnapshotTaskInfo> task);
 
+    /**
+     * @brief 增加数据chunk对内容的引用
+     *
+     * @param name 包含内容哈希的数据chunk名
+     * @param[out] needTransfer 内容对应的对象是否需要上传
+     *
+     * @return 错误码
+     */
+    int AddChunkDataRef(const ChunkDataName &name, bool *needTransfer);
+
+    /**
+     * @brief 删除数据chunk对内容的引用，内容没有其他引用时删除对应的对象
+     *
+     * @param name 数据chunk名
+     * @param[out] released 数据chunk是否按内容存储
+     *
+     * @return 错误码
+     */
+    int ReleaseChunkDataRef(const ChunkDataName &name, bool *released);
+
+    /**
+     * @brief 删除快照不再使用的数据chunk，按内容存储时只删除引用
+     *
+     * @param name 数据chunk名
+     *
+     * @return 错误码
+     */
+    int RemoveChunkData(const ChunkDataName &name);
+
  private:
     // curvefs客户端对象
     std::shared_ptr<CurveFsClient> client_;
@@ -402,9 +461,13 @@ class SnapshotCoreImpl : public SnapshotCore {
 
     // 执行并发步骤的线程池
     std::shared_ptr<ThreadPool> threadPool_;
+    // 数据搬迁的全局并发控制，为空时只受每个任务的并发数限制
+    std::shared_ptr<ConcurrencyController> concurrencyController_;
 
     // 锁住打快照的文件名，防止并发同时对其打快照，同一文件的快照需排队
     NameLock snapshotNameLock_;
+    // 按内容哈希加锁，防止增加引用与删除对象并发
+    NameLock chunkDataRefLock_;
 
     // 转储chunk分片大小
     uint64_t chunkSplitSize_;
@@ -422,6 +485,12 @@ class SnapshotCoreImpl : public SnapshotCore {
     uint64_t clientAsyncMethodRetryIntervalMs_;
     // 异步ReadChunkSnapshot的并发数
     uint32_t readChunkSnapshotConcurrency_;
+    // 转储时是否跳过数据全为0的chunk
+    bool elideZeroChunk_;
+    // 每个chunk同时异步上传到s3的分片数量
+    uint32_t uploadPartConcurrency_;
+    // 是否按内容哈希存储数据chunk
+    bool contentAddressedChunk_;
 };
 
 }  // namespace snapshotcloneserver
@@ -63,7 +63,10 @@ bool ChunkIndexData::Serialize(std::string *data) const {
         map.mutable_indexmap()->
             insert({m.first,
                 ChunkDataName(fileName_, m.second, m.first).
-                ToDataChunkKey()});
+                ToLogicalChunkKey()});
+    }
+    for (const auto &m : this->hashMap_) {
+        map.mutable_hashmap()->insert({m.first, m.second});
     }
     // Todo：可以转化为stream给adpater接口使用SerializeToOstream
     return map.SerializeToString(data);
@@ -82,6 +85,9 @@ bool ChunkIndexData::Unserialize(const std::string &data) {
                 return false;
             }
         }
+        for (const auto &m : map.hashmap()) {
+            this->hashMap_.emplace(m.first, m.second);
+        }
         return true;
     } else {
         return false;
@@ -93,6 +99,10 @@ bool ChunkIndexData::GetChunkDataName(ChunkIndexType index,
     auto it = chunkMap_.find(index);
     if (it != chunkMap_.end()) {
         *nameOut = ChunkDataName(fileName_, it->second, index);
+        auto hash = hashMap_.find(index);
+        if (hash != hashMap_.end()) {
+            nameOut->contentHash_ = hash->second;
+        }
         return true;
     } else {
         return false;
@@ -33,6 +33,7 @@
 #include <memory>
 
 #include "src/common/concurrent/concurrent.h"
+#include "src/common/location_operator.h"
 
 using ::curve::common::SpinLock;
 using ::curve::common::LockGuard;
@@ -57,10 +58,10 @@ class ChunkDataName {
           chunkSeqNum_(seq),
           chunkIndex_(chunkIndex) {}
     /**
-     * 构建datachunk对象的名称 文件名-chunk索引-版本号
-     * @return: 对象名称字符串
+     * 构建datachunk的逻辑名称 文件名-chunk索引-版本号
+     * @return: 逻辑名称字符串
      */
-    std::string ToDataChunkKey() const {
+    std::string ToLogicalChunkKey() const {
         return fileName_
             + kChunkDataNameSeprator
             + std::to_string(this->chunkIndex_)
@@ -68,9 +69,24 @@ class ChunkDataName {
             + std::to_string(this->chunkSeqNum_);
     }
 
+    /**
+     * 构建datachunk对象的名称，按内容存储时为 前缀+内容哈希，
+     * 否则为逻辑名称
+     * @return: 对象名称字符串
+     */
+    std::string ToDataChunkKey() const {
+        if (!contentHash_.empty()) {
+            return curve::common::kContentAddressedObjectPrefix
+                + contentHash_;
+        }
+        return ToLogicalChunkKey();
+    }
+
     std::string fileName_;
     SnapshotSeqType chunkSeqNum_;
     ChunkIndexType chunkIndex_;
+    // 数据chunk的内容哈希，为空表示按逻辑名称存储
+    std::string contentHash_;
 };
 
 inline bool operator==(const ChunkDataName &lhs, const ChunkDataName &rhs) {
@@ -134,6 +150,18 @@ class ChunkIndexData {
 
     void PutChunkDataName(const ChunkDataName &name) {
         chunkMap_.emplace(name.chunkIndex_, name.chunkSeqNum_);
+        if (!name.contentHash_.empty()) {
+            hashMap_.emplace(name.chunkIndex_, name.contentHash_);
+        }
+    }
+
+    void DeleteChunkDataName(ChunkIndexType index) {
+        chunkMap_.erase(index);
+        hashMap_.erase(index);
+    }
+
+    void SetChunkDataHash(ChunkIndexType index, const std::string &hash) {
+        hashMap_[index] = hash;
     }
 
     bool GetChunkDataName(ChunkIndexType index, ChunkDataName* nameOut) const;
@@ -155,6 +183,8 @@ class ChunkIndexData {
     std::string fileName_;
     // 快照文件索引信息map
     std::map<ChunkIndexType, SnapshotSeqType> chunkMap_;
+    // 按内容存储的chunk的内容哈希
+    std::map<ChunkIndexType, std::string> hashMap_;
 };
 
 
@@ -185,6 +215,9 @@ class TransferTask {
      std::map<int, std::string> partInfo_;
 };
 
+// 异步转储分片完成的回调，参数为返回值 0 成功/ -1 失败
+using TransferPartDone = std::function<void(int)>;
+
 class SnapshotDataStore {
  public:
      SnapshotDataStore() {}
@@ -273,6 +306,38 @@ class SnapshotDataStore {
                                        int partNum,
                                        int partSize,
                                        const char* buf) = 0;
+    /**
+     * 异步添加数据chunk的一个分片到转储任务中，分片数据在返回前拷贝，
+     * buf在返回后即可释放。默认实现为同步上传
+     * @param 数据chunk名
+     * @param 转储任务
+     * @param 第几个分片
+     * @param 分片大小
+     * @param 分片的数据内容
+     * @param done 分片转储完成后的回调
+     */
+    virtual void DataChunkTranferAddPartAsync(const ChunkDataName &name,
+                                        std::shared_ptr<TransferTask> task,
+                                        int partNum,
+                                        int partSize,
+                                        const char* buf,
+                                        TransferPartDone done) {
+        done(DataChunkTranferAddPart(name, task, partNum, partSize, buf));
+    }
+    /**
+     * 将已转储的数据chunk中对应的分片拷贝到转储任务中，用于增量转储
+     * @param 数据chunk名
+     * @param 转储任务
+     * @param 第几个分片
+     * @param 分片大小
+     * @param 分片数据所在的已转储数据chunk
+     * @return: 0 拷贝成功/ -1 拷贝失败
+     */
+    virtual int DataChunkTranferCopyPart(const ChunkDataName &name,
+                                         std::shared_ptr<TransferTask> task,
+                                         int partNum,
+                                         int partSize,
+                                         const ChunkDataName &srcName) = 0;
     /**
      * 完成数据chunk的转储任务
      * @param 数据chunk名
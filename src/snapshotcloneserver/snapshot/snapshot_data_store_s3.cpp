@@ -27,6 +27,9 @@
 #include <aws/core/utils/memory/stl/AWSString.h>  //NOLINT
 #include <aws/core/utils/memory/stl/AWSMap.h>  //NOLINT
 #include <aws/core/utils/StringUtils.h>   //NOLINT
+
+using ::curve::common::UploadPartAsyncContext;
+
 namespace curve {
 namespace snapshotcloneserver {
 
@@ -177,6 +180,58 @@ int S3SnapshotDataStore::DataChunkTranferAddPart(const ChunkDataName &name,
     return 0;
 }
 
+void S3SnapshotDataStore::DataChunkTranferAddPartAsync(
+                                        const ChunkDataName &name,
+                                        std::shared_ptr<TransferTask> task,
+                                        int partNum,
+                                        int partSize,
+                                        const char *buf,
+                                        TransferPartDone done) {
+    auto context = std::make_shared<UploadPartAsyncContext>();
+    context->key = name.ToDataChunkKey();
+    context->uploadId = task->uploadId_;
+    context->partNum = partNum + 1;
+    context->buf = buf;
+    context->len = partSize;
+    context->cb = [task, done] (const S3Adapter *adapter,
+        const std::shared_ptr<UploadPartAsyncContext> &ctx) {
+        if (ctx->retCode < 0) {
+            LOG(ERROR) << "Failed to UploadPartAsync"
+                       << ", key = " << ctx->key
+                       << ", partNum = " << ctx->partNum;
+            done(-1);
+            return;
+        }
+        task->AddPartInfo(ctx->partNum, ctx->etag);
+        done(0);
+    };
+    s3Adapter4Data_->UploadPartAsync(context);
+}
+
+int S3SnapshotDataStore::DataChunkTranferCopyPart(const ChunkDataName &name,
+                                        std::shared_ptr<TransferTask> task,
+                                        int partNum,
+                                        int partSize,
+                                        const ChunkDataName &srcName) {
+    std::string key = name.ToDataChunkKey();
+    const Aws::String aws_key(key.c_str(), key.size());
+    const Aws::String uploadId(task->uploadId_.c_str(), task->uploadId_.size());
+    std::string srcKey = srcName.ToDataChunkKey();
+    const Aws::String aws_srcKey(srcKey.c_str(), srcKey.size());
+    uint64_t offset = static_cast<uint64_t>(partNum) * partSize;
+    Aws::S3::Model::CompletedPart cp =
+        s3Adapter4Data_->UploadPartCopy(
+            aws_key, uploadId, partNum + 1, aws_srcKey, offset, partSize);
+    std::string etag(cp.GetETag().c_str(), cp.GetETag().size());
+    int tmp_partnum = cp.GetPartNumber();
+    if (etag == "errorTag" && tmp_partnum == -1) {
+        LOG(ERROR) << "Failed to UploadPartCopy";
+        return -1;
+    }
+    task->AddPartInfo(tmp_partnum, etag);
+    return 0;
+}
+
 int S3SnapshotDataStore::DataChunkTranferComplete(const ChunkDataName &name,
                                         std::shared_ptr<TransferTask> task) {
     std::string key = name.ToDataChunkKey();
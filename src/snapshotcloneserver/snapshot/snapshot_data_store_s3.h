@@ -66,6 +66,17 @@ class S3SnapshotDataStore : public SnapshotDataStore {
                                         int partNum,
                                         int partSize,
                                         const char* buf) override;
+    void DataChunkTranferAddPartAsync(const ChunkDataName &name,
+                                      std::shared_ptr<TransferTask> task,
+                                      int partNum,
+                                      int partSize,
+                                      const char* buf,
+                                      TransferPartDone done) override;
+    int DataChunkTranferCopyPart(const ChunkDataName &name,
+                                 std::shared_ptr<TransferTask> task,
+                                 int partNum,
+                                 int partSize,
+                                 const ChunkDataName &srcName) override;
      int DataChunkTranferComplete(const ChunkDataName &name,
                                 std::shared_ptr<TransferTask> task) override;
      int DataChunkTranferAbort(const ChunkDataName &name,
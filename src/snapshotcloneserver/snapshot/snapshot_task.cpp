@@ -20,6 +20,9 @@
  * Author: xuchaojie
  */
 
+#include <openssl/sha.h>
+#include <string.h>
+#include <algorithm>
 #include <list>
 
 #include "src/common/timeutility.h"
@@ -28,9 +31,32 @@
 namespace curve {
 namespace snapshotcloneserver {
 
+namespace {
+
+bool IsZeroBuffer(const char *buf, uint64_t len) {
+    if (0 == len) {
+        return true;
+    }
+    return 0 == buf[0] && 0 == memcmp(buf, buf + 1, len - 1);
+}
+
+std::string ToHexString(const unsigned char *buf, uint64_t len) {
+    static const char kHexChars[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(len * 2);
+    for (uint64_t i = 0; i < len; i++) {
+        hex.push_back(kHexChars[buf[i] >> 4]);
+        hex.push_back(kHexChars[buf[i] & 0x0f]);
+    }
+    return hex;
+}
+
+}  // namespace
+
 void ReadChunkSnapshotClosure::Run() {
     std::unique_ptr<ReadChunkSnapshotClosure> self_guard(this);
     context_->retCode = GetRetCode();
+    context_->slot.Release(context_->retCode >= 0);
     if (context_->retCode < 0) {
         LOG(WARNING) << "ReadChunkSnapshotClosure return fail"
                      << ", ret = " << context_->retCode
@@ -52,11 +78,20 @@ void ReadChunkSnapshotClosure::Run() {
  *  步骤如下：
  *  1. 创建一个转储任务transferTask，并调用DataChunkTranferInit初始化
  *  2. 调用ReadChunkSnapshot从curvefs读取chunk的一个分片
- *  3. 调用DataChunkTranferAddPart转储一个分片
- *  4. 重复2、3直到所有分片转储完成，调用DataChunkTranferComplete结束转储任务
+ *  3. 调用DataChunkTranferAddPart转储一个分片，uploadPartConcurrency_
+ *  不为0时异步上传，上传与后续分片的读取重叠进行
+ *  4. 重复2、3直到所有分片转储完成，等待异步上传完成后，
+ *  调用DataChunkTranferComplete结束转储任务
  *  5. 中间如有读取或转储发生错误，则调用DataChunkTranferAbort放弃转储，
  *  并返回错误码
  *
+ *  开启elideZeroChunk时，全0的分片先不转储，读到第一个非0分片时才初始化
+ *  转储任务，全部分片读完后再补上跳过的全0分片；如果所有分片都是0，
+ *  则不转储该chunk，由调用方从索引中移除
+ *
+ *  按内容存储时对象名由整个chunk的哈希决定，因此先读取所有分片，
+ *  再由TransferContentAddressedChunk计算哈希并转储
+ *
  * @return 错误码
  */
 int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
@@ -67,22 +102,35 @@ int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
 
     std::shared_ptr<TransferTask> transferTask =
         std::make_shared<TransferTask>();
-    int ret = dataStore_->DataChunkTranferInit(name,
-            transferTask);
-    if (ret < 0) {
-        LOG(ERROR) << "DataChunkTranferInit error, "
-                   << " ret = " << ret
-                   << ", chunkDataName = " << name.ToDataChunkKey()
-                   << ", logicalPool = " << cidInfo.lpid_
-                   << ", copysetId = " << cidInfo.cpid_
-                   << ", chunkId = " << cidInfo.cid_;
-        return ret;
+    int ret = kErrCodeSuccess;
+    bool incremental = taskInfo_->baseName_.chunkSeqNum_ != 0;
+    if ((!taskInfo_->elideZeroChunk_ || incremental) &&
+        !taskInfo_->contentAddressed_) {
+        ret = InitTransfer(transferTask);
+        if (ret < 0) {
+            return ret;
+        }
     }
 
     auto tracker = std::make_shared<ReadChunkSnapshotTaskTracker>();
     for (uint64_t i = 0;
         i < chunkSize / chunkSplitSize;
         i++) {
+        // 未写过的分片直接从上一个版本的数据chunk拷贝
+        if (incremental && !taskInfo_->changedParts_[i]) {
+            ret = dataStore_->DataChunkTranferCopyPart(
+                name, transferTask, i, chunkSplitSize, taskInfo_->baseName_);
+            if (ret < 0) {
+                LOG(ERROR) << "DataChunkTranferCopyPart fail"
+                           << ", ret = " << ret
+                           << ", chunkDataName = " << name.ToDataChunkKey()
+                           << ", baseChunkDataName = "
+                           << taskInfo_->baseName_.ToDataChunkKey()
+                           << ", index = " << i;
+                break;
+            }
+            continue;
+        }
         auto context = std::make_shared<ReadChunkSnapshotContext>();
         context->cidInfo = taskInfo_->cidInfo_;
         context->seqNum = taskInfo_->name_.chunkSeqNum_;
@@ -122,6 +170,24 @@ int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
                 break;
             }
         } while (true);
+        if (ret >= 0 && taskInfo_->contentAddressed_) {
+            return TransferContentAddressedChunk(transferTask);
+        }
+        if (ret >= 0) {
+            ret = WaitUploadParts();
+        }
+        if (ret >= 0 && !transferInited_) {
+            LOG(INFO) << "Skip transfer zero chunk"
+                      << ", chunkDataName = " << name.ToDataChunkKey()
+                      << ", logicalPool = " << cidInfo.lpid_
+                      << ", copysetId = " << cidInfo.cpid_
+                      << ", chunkId = " << cidInfo.cid_;
+            taskInfo_->isZeroChunk_ = true;
+            return kErrCodeSuccess;
+        }
+        if (ret >= 0) {
+            ret = TransferZeroParts(transferTask);
+        }
         if (ret >= 0) {
             ret =
                 dataStore_->DataChunkTranferComplete(name, transferTask);
@@ -136,6 +202,11 @@ int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
         }
     }
     if (ret < 0) {
+            // 中止转储前等待已经发起的上传完成
+            uploadTracker_->Wait();
+            if (!transferInited_) {
+                return ret;
+            }
             int ret2 =
                 dataStore_->DataChunkTranferAbort(
                 name,
@@ -156,6 +227,8 @@ int TransferSnapshotDataChunkTask::TransferSnapshotDataChunk() {
 int TransferSnapshotDataChunkTask::StartAsyncReadChunkSnapshot(
     std::shared_ptr<ReadChunkSnapshotTaskTracker> tracker,
     std::shared_ptr<ReadChunkSnapshotContext> context) {
+    context->slot.Acquire(taskInfo_->concurrencyController_,
+        taskInfo_->user_);
     ReadChunkSnapshotClosure *cb =
         new ReadChunkSnapshotClosure(tracker, context);
     tracker->AddOneTrace();
@@ -174,6 +247,7 @@ int TransferSnapshotDataChunkTask::StartAsyncReadChunkSnapshot(
         context->buf.get(),
         cb);
     if (ret < 0) {
+        context->slot.Release(false);
         LOG(ERROR) << "ReadChunkSnapshot error, "
                    << " ret = " << ret
                    << ", logicalPool = " << context->cidInfo.lpid_
@@ -210,19 +284,20 @@ int TransferSnapshotDataChunkTask::HandleReadChunkSnapshotResultsAndRetry(
                            << ", ret = " << ret;
                 return ret;
             }
+        } else if (taskInfo_->contentAddressed_) {
+            readParts_.push_back(context);
+        } else if (taskInfo_->elideZeroChunk_ &&
+            IsZeroBuffer(context->buf.get(), context->len)) {
+            zeroParts_.push_back(context->partIndex);
         } else {
-            ret = dataStore_->DataChunkTranferAddPart(
-                taskInfo_->name_,
-                transferTask,
-                context->partIndex,
-                context->len,
-                context->buf.get());
+            if (!transferInited_) {
+                ret = InitTransfer(transferTask);
+                if (ret < 0) {
+                    return ret;
+                }
+            }
+            ret = AddPart(transferTask, context);
             if (ret < 0) {
-                LOG(ERROR) << "DataChunkTranferAddPart fail"
-                           << ", ret = " << ret
-                           << ", chunkDataName = "
-                           << taskInfo_->name_.ToDataChunkKey()
-                           << ", index = " << context->partIndex;
                 return ret;
             }
         }
@@ -230,5 +305,224 @@ int TransferSnapshotDataChunkTask::HandleReadChunkSnapshotResultsAndRetry(
     return ret;
 }
 
+int TransferSnapshotDataChunkTask::AddPart(
+    std::shared_ptr<TransferTask> transferTask,
+    const ReadChunkSnapshotContextPtr &context) {
+    std::shared_ptr<ConcurrencyController> controller =
+        taskInfo_->concurrencyController_;
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    if (0 == taskInfo_->uploadPartConcurrency_) {
+        int ret = dataStore_->DataChunkTranferAddPart(
+            taskInfo_->name_,
+            transferTask,
+            context->partIndex,
+            context->len,
+            context->buf.get());
+        if (controller != nullptr) {
+            controller->OnS3Response(
+                TimeUtility::GetTimeofDayUs() - startUs, ret >= 0);
+        }
+        if (ret < 0) {
+            LOG(ERROR) << "DataChunkTranferAddPart fail"
+                       << ", ret = " << ret
+                       << ", chunkDataName = "
+                       << taskInfo_->name_.ToDataChunkKey()
+                       << ", index = " << context->partIndex;
+            return ret;
+        }
+        return kErrCodeSuccess;
+    }
+
+    // 限制上传中的分片数量，避免读取速度超过上传速度时占用过多内存
+    if (uploadTracker_->GetTaskNum() >= taskInfo_->uploadPartConcurrency_) {
+        uploadTracker_->WaitSome(1);
+    }
+    int ret = uploadTracker_->GetResult();
+    if (ret < 0) {
+        LOG(ERROR) << "DataChunkTranferAddPartAsync fail"
+                   << ", ret = " << ret
+                   << ", chunkDataName = "
+                   << taskInfo_->name_.ToDataChunkKey();
+        return ret;
+    }
+    uploadTracker_->AddOneTrace();
+    std::shared_ptr<TaskTracker> tracker = uploadTracker_;
+    dataStore_->DataChunkTranferAddPartAsync(
+        taskInfo_->name_,
+        transferTask,
+        context->partIndex,
+        context->len,
+        context->buf.get(),
+        [tracker, controller, startUs] (int retCode) {
+            if (controller != nullptr) {
+                controller->OnS3Response(
+                    TimeUtility::GetTimeofDayUs() - startUs, retCode >= 0);
+            }
+            tracker->HandleResponse(retCode);
+        });
+    return kErrCodeSuccess;
+}
+
+int TransferSnapshotDataChunkTask::WaitUploadParts() {
+    uploadTracker_->Wait();
+    int ret = uploadTracker_->GetResult();
+    if (ret < 0) {
+        LOG(ERROR) << "DataChunkTranferAddPartAsync fail"
+                   << ", ret = " << ret
+                   << ", chunkDataName = "
+                   << taskInfo_->name_.ToDataChunkKey();
+    }
+    return ret;
+}
+
+int TransferSnapshotDataChunkTask::InitTransfer(
+    std::shared_ptr<TransferTask> transferTask) {
+    int ret = dataStore_->DataChunkTranferInit(taskInfo_->name_,
+            transferTask);
+    if (ret < 0) {
+        LOG(ERROR) << "DataChunkTranferInit error, "
+                   << " ret = " << ret
+                   << ", chunkDataName = "
+                   << taskInfo_->name_.ToDataChunkKey()
+                   << ", logicalPool = " << taskInfo_->cidInfo_.lpid_
+                   << ", copysetId = " << taskInfo_->cidInfo_.cpid_
+                   << ", chunkId = " << taskInfo_->cidInfo_.cid_;
+        return ret;
+    }
+    transferInited_ = true;
+    return kErrCodeSuccess;
+}
+
+int TransferSnapshotDataChunkTask::TransferZeroParts(
+    std::shared_ptr<TransferTask> transferTask) {
+    if (zeroParts_.empty()) {
+        return kErrCodeSuccess;
+    }
+    uint64_t len = taskInfo_->chunkSplitSize_;
+    std::unique_ptr<char[]> zeroBuf(new char[len]());
+    for (auto partIndex : zeroParts_) {
+        int ret = dataStore_->DataChunkTranferAddPart(
+            taskInfo_->name_,
+            transferTask,
+            partIndex,
+            len,
+            zeroBuf.get());
+        if (ret < 0) {
+            LOG(ERROR) << "DataChunkTranferAddPart fail"
+                       << ", ret = " << ret
+                       << ", chunkDataName = "
+                       << taskInfo_->name_.ToDataChunkKey()
+                       << ", index = " << partIndex;
+            return ret;
+        }
+    }
+    return kErrCodeSuccess;
+}
+
+/**
+ * @brief 按内容哈希转储已经读取的整个chunk
+ * @detail
+ *  1. 按分片顺序计算整个chunk的sha256，开启elideZeroChunk且全为0时不转储
+ *  2. 增加数据chunk对该内容的引用，内容对应的对象已经存在时不再上传
+ *  3. 否则将所有分片上传到以哈希命名的对象，上传失败时删除增加的引用
+ *
+ * @return 错误码
+ */
+int TransferSnapshotDataChunkTask::TransferContentAddressedChunk(
+    std::shared_ptr<TransferTask> transferTask) {
+    std::sort(readParts_.begin(), readParts_.end(),
+        [] (const ReadChunkSnapshotContextPtr &a,
+            const ReadChunkSnapshotContextPtr &b) {
+            return a->partIndex < b->partIndex;
+        });
+    bool isZero = true;
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    for (auto &context : readParts_) {
+        SHA256_Update(&ctx, context->buf.get(), context->len);
+        if (isZero && !IsZeroBuffer(context->buf.get(), context->len)) {
+            isZero = false;
+        }
+    }
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256_Final(digest, &ctx);
+    ChunkIDInfo cidInfo = taskInfo_->cidInfo_;
+    if (taskInfo_->elideZeroChunk_ && isZero) {
+        LOG(INFO) << "Skip transfer zero chunk"
+                  << ", chunkDataName = "
+                  << taskInfo_->name_.ToDataChunkKey()
+                  << ", logicalPool = " << cidInfo.lpid_
+                  << ", copysetId = " << cidInfo.cpid_
+                  << ", chunkId = " << cidInfo.cid_;
+        taskInfo_->isZeroChunk_ = true;
+        return kErrCodeSuccess;
+    }
+    taskInfo_->name_.contentHash_ = ToHexString(digest, SHA256_DIGEST_LENGTH);
+
+    bool needTransfer = false;
+    int ret = taskInfo_->addChunkDataRef_(taskInfo_->name_, &needTransfer);
+    if (ret < 0) {
+        LOG(ERROR) << "AddChunkDataRef fail"
+                   << ", ret = " << ret
+                   << ", chunkDataName = "
+                   << taskInfo_->name_.ToLogicalChunkKey()
+                   << ", hash = " << taskInfo_->name_.contentHash_;
+        return ret;
+    }
+    if (!needTransfer) {
+        LOG(INFO) << "Skip transfer duplicate chunk"
+                  << ", chunkDataName = "
+                  << taskInfo_->name_.ToLogicalChunkKey()
+                  << ", hash = " << taskInfo_->name_.contentHash_;
+        return kErrCodeSuccess;
+    }
+
+    ret = InitTransfer(transferTask);
+    for (auto &context : readParts_) {
+        if (ret < 0) {
+            break;
+        }
+        ret = AddPart(transferTask, context);
+    }
+    if (ret >= 0) {
+        ret = WaitUploadParts();
+    }
+    if (ret >= 0) {
+        ret = dataStore_->DataChunkTranferComplete(taskInfo_->name_,
+            transferTask);
+        if (ret < 0) {
+            LOG(ERROR) << "DataChunkTranferComplete fail"
+                       << ", ret = " << ret
+                       << ", chunkDataName = "
+                       << taskInfo_->name_.ToDataChunkKey()
+                       << ", logicalPool = " << cidInfo.lpid_
+                       << ", copysetId = " << cidInfo.cpid_
+                       << ", chunkId = " << cidInfo.cid_;
+        }
+    }
+    if (ret < 0) {
+        uploadTracker_->Wait();
+        if (transferInited_) {
+            int ret2 = dataStore_->DataChunkTranferAbort(taskInfo_->name_,
+                transferTask);
+            if (ret2 < 0) {
+                LOG(ERROR) << "DataChunkTranferAbort fail"
+                           << ", ret = " << ret2
+                           << ", chunkDataName = "
+                           << taskInfo_->name_.ToDataChunkKey();
+            }
+        }
+        int ret2 = taskInfo_->releaseChunkDataRef_(taskInfo_->name_);
+        if (ret2 < 0) {
+            LOG(ERROR) << "ReleaseChunkDataRef fail"
+                       << ", ret = " << ret2
+                       << ", chunkDataName = "
+                       << taskInfo_->name_.ToLogicalChunkKey();
+        }
+        return ret;
+    }
+    return kErrCodeSuccess;
+}
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
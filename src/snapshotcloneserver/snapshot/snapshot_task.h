@@ -26,6 +26,8 @@
 #include <string>
 #include <memory>
 #include <list>
+#include <vector>
+#include <functional>
 
 #include "src/snapshotcloneserver/snapshot/snapshot_core.h"
 #include "src/snapshotcloneserver/common/define.h"
@@ -33,6 +35,7 @@
 #include "src/snapshotcloneserver/common/task_info.h"
 #include "src/snapshotcloneserver/common/snapshotclone_metric.h"
 #include "src/snapshotcloneserver/common/task_tracker.h"
+#include "src/snapshotcloneserver/common/concurrency_controller.h"
 
 namespace curve {
 namespace snapshotcloneserver {
@@ -190,6 +193,8 @@ struct ReadChunkSnapshotContext {
     uint64_t startTime;
     // 异步请求重试总时间
     uint64_t clientAsyncMethodRetryTimeSec;
+    // 请求占用的全局并发额度
+    ConcurrencySlot slot;
 };
 
 using ReadChunkSnapshotContextPtr = std::shared_ptr<ReadChunkSnapshotContext>;
@@ -207,6 +212,13 @@ struct ReadChunkSnapshotClosure : public SnapCloneClosure {
     std::shared_ptr<ReadChunkSnapshotContext> context_;
 };
 
+// 增加数据chunk对内容的引用，needTransfer返回内容对应的对象是否需要上传
+using AddChunkDataRefFunc =
+    std::function<int(const ChunkDataName &name, bool *needTransfer)>;
+// 删除数据chunk对内容的引用，内容没有其他引用时删除对应的对象
+using ReleaseChunkDataRefFunc =
+    std::function<int(const ChunkDataName &name)>;
+
 struct TransferSnapshotDataChunkTaskInfo : public TaskInfo {
     ChunkDataName name_;
     uint64_t chunkSize_;
@@ -215,6 +227,24 @@ struct TransferSnapshotDataChunkTaskInfo : public TaskInfo {
     uint64_t clientAsyncMethodRetryTimeSec_;
     uint64_t clientAsyncMethodRetryIntervalMs_;
     uint32_t readChunkSnapshotConcurrency_;
+    // 是否跳过数据全为0的chunk
+    bool elideZeroChunk_;
+    // 转储结果，chunk数据全为0，没有转储
+    bool isZeroChunk_;
+    // 增量转储时已转储的上一个版本的数据chunk，版本号为0表示全量转储
+    ChunkDataName baseName_;
+    // 增量转储时相对上一个版本写过的分片，未写过的分片从baseName_拷贝
+    std::vector<bool> changedParts_;
+    // 数据搬迁的全局并发控制，为空时不做全局控制
+    std::shared_ptr<ConcurrencyController> concurrencyController_;
+    // 快照所属的用户，全局并发额度按用户公平分配
+    std::string user_;
+    // 同时异步上传到s3的分片数量上限，0表示同步上传
+    uint32_t uploadPartConcurrency_;
+    // 是否按内容哈希存储，转储完成后name_中包含内容哈希
+    bool contentAddressed_;
+    AddChunkDataRefFunc addChunkDataRef_;
+    ReleaseChunkDataRefFunc releaseChunkDataRef_;
 
     TransferSnapshotDataChunkTaskInfo(const ChunkDataName &name,
         uint64_t chunkSize,
@@ -222,14 +252,19 @@ struct TransferSnapshotDataChunkTaskInfo : public TaskInfo {
         uint64_t chunkSplitSize,
         uint64_t clientAsyncMethodRetryTimeSec,
         uint64_t clientAsyncMethodRetryIntervalMs,
-        uint32_t readChunkSnapshotConcurrency)
+        uint32_t readChunkSnapshotConcurrency,
+        bool elideZeroChunk = false)
         : name_(name),
           chunkSize_(chunkSize),
           cidInfo_(cidInfo),
           chunkSplitSize_(chunkSplitSize),
           clientAsyncMethodRetryTimeSec_(clientAsyncMethodRetryTimeSec),
           clientAsyncMethodRetryIntervalMs_(clientAsyncMethodRetryIntervalMs),
-          readChunkSnapshotConcurrency_(readChunkSnapshotConcurrency) {}
+          readChunkSnapshotConcurrency_(readChunkSnapshotConcurrency),
+          elideZeroChunk_(elideZeroChunk),
+          isZeroChunk_(false),
+          uploadPartConcurrency_(0),
+          contentAddressed_(false) {}
 };
 
 class TransferSnapshotDataChunkTask : public TrackerTask {
@@ -241,7 +276,9 @@ class TransferSnapshotDataChunkTask : public TrackerTask {
         : TrackerTask(taskId),
           taskInfo_(taskInfo),
           client_(client),
-          dataStore_(dataStore) {}
+          dataStore_(dataStore),
+          transferInited_(false),
+          uploadTracker_(std::make_shared<TaskTracker>()) {}
 
     std::shared_ptr<TransferSnapshotDataChunkTaskInfo> GetTaskInfo() const {
         return taskInfo_;
@@ -287,10 +324,65 @@ class TransferSnapshotDataChunkTask : public TrackerTask {
         std::shared_ptr<TransferTask> transferTask,
         const std::list<ReadChunkSnapshotContextPtr> &results);
 
+    /**
+     * @brief 转储读取到的一个分片，uploadPartConcurrency_不为0时异步上传，
+     *        上传中的分片数量达到上限时等待
+     *
+     * @param transferTask 转储任务
+     * @param context 读取到的分片
+     *
+     * @return 错误码
+     */
+    int AddPart(std::shared_ptr<TransferTask> transferTask,
+        const ReadChunkSnapshotContextPtr &context);
+
+    /**
+     * @brief 等待异步上传的分片全部完成
+     *
+     * @return 错误码
+     */
+    int WaitUploadParts();
+
+    /**
+     * @brief 初始化转储任务
+     *
+     * @param transferTask 转储任务
+     *
+     * @return 错误码
+     */
+    int InitTransfer(std::shared_ptr<TransferTask> transferTask);
+
+    /**
+     * @brief 转储之前跳过的全0分片
+     *
+     * @param transferTask 转储任务
+     *
+     * @return 错误码
+     */
+    int TransferZeroParts(std::shared_ptr<TransferTask> transferTask);
+
+    /**
+     * @brief 按内容哈希转储已经读取的整个chunk
+     *
+     * @param transferTask 转储任务
+     *
+     * @return 错误码
+     */
+    int TransferContentAddressedChunk(
+        std::shared_ptr<TransferTask> transferTask);
+
  protected:
     std::shared_ptr<TransferSnapshotDataChunkTaskInfo> taskInfo_;
     std::shared_ptr<CurveFsClient> client_;
     std::shared_ptr<SnapshotDataStore> dataStore_;
+    // 转储任务是否已经初始化，跳过全0的chunk时，读到非0分片才初始化
+    bool transferInited_;
+    // 暂时跳过的全0分片的索引
+    std::vector<uint64_t> zeroParts_;
+    // 异步上传分片的追踪器
+    std::shared_ptr<TaskTracker> uploadTracker_;
+    // 按内容存储时读取到的分片，计算哈希后再上传
+    std::vector<ReadChunkSnapshotContextPtr> readParts_;
 };
 
 
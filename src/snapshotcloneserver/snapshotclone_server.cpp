@@ -81,6 +81,12 @@ void InitSnapshotCloneServerOptions(std::shared_ptr<Configuration> conf,
                                         &serverOption->mdsSessionTimeUs);
     conf->GetValueFatalIfFail("server.readChunkSnapshotConcurrency",
             &serverOption->readChunkSnapshotConcurrency);
+    conf->GetValueFatalIfFail("server.elideZeroChunk",
+                                        &serverOption->elideZeroChunk);
+    conf->GetValueFatalIfFail("server.uploadPartConcurrency",
+            &serverOption->uploadPartConcurrency);
+    conf->GetValueFatalIfFail("server.contentAddressedChunk",
+                                        &serverOption->contentAddressedChunk);
 
     conf->GetValueFatalIfFail("server.stage1PoolThreadNum",
                                      &serverOption->stage1PoolThreadNum);
@@ -100,8 +106,19 @@ void InitSnapshotCloneServerOptions(std::shared_ptr<Configuration> conf,
                                         &serverOption->mdsRootUser);
     conf->GetValueFatalIfFail("server.createCloneChunkConcurrency",
                             &serverOption->createCloneChunkConcurrency);
+    conf->GetValueFatalIfFail("server.createCloneChunkBatchSize",
+                            &serverOption->createCloneChunkBatchSize);
     conf->GetValueFatalIfFail("server.recoverChunkConcurrency",
                             &serverOption->recoverChunkConcurrency);
+    conf->GetValueFatalIfFail("server.dataMovementMaxConcurrency",
+                            &serverOption->dataMovementMaxConcurrency);
+    conf->GetValueFatalIfFail("server.dataMovementMinConcurrency",
+                            &serverOption->dataMovementMinConcurrency);
+    conf->GetValueFatalIfFail(
+        "server.dataMovementChunkServerLatencyTargetMs",
+        &serverOption->dataMovementChunkServerLatencyTargetMs);
+    conf->GetValueFatalIfFail("server.dataMovementS3LatencyTargetMs",
+                            &serverOption->dataMovementS3LatencyTargetMs);
 }
 
 void InitEtcdConf(std::shared_ptr<Configuration> conf, EtcdConf* etcdConf) {
@@ -245,6 +262,22 @@ bool SnapShotCloneServer::Init() {
     }
 
 
+    const SnapshotCloneServerOptions &serverOption =
+        snapshotCloneServerOptions_.serverOption;
+    if (serverOption.dataMovementMaxConcurrency > 0) {
+        ConcurrencyControllerOption controllerOption;
+        controllerOption.maxConcurrency =
+            serverOption.dataMovementMaxConcurrency;
+        controllerOption.minConcurrency =
+            serverOption.dataMovementMinConcurrency;
+        controllerOption.chunkServerLatencyTargetUs =
+            serverOption.dataMovementChunkServerLatencyTargetMs * 1000;
+        controllerOption.s3LatencyTargetUs =
+            serverOption.dataMovementS3LatencyTargetMs * 1000;
+        concurrencyController_ =
+            std::make_shared<ConcurrencyController>(controllerOption);
+    }
+
     snapshotRef_ = std::make_shared<SnapshotReference>();
     snapshotMetric_ = std::make_shared<SnapshotMetric>(metaStore_);
     snapshotCore_ =  std::make_shared<SnapshotCoreImpl>(
@@ -252,7 +285,8 @@ bool SnapShotCloneServer::Init() {
                         metaStore_,
                         dataStore_,
                         snapshotRef_,
-                        snapshotCloneServerOptions_.serverOption);
+                        snapshotCloneServerOptions_.serverOption,
+                        concurrencyController_);
     if (snapshotCore_->Init() < 0) {
         LOG(ERROR) << "SnapshotCore init fail.";
         return false;
@@ -277,7 +311,8 @@ bool SnapShotCloneServer::Init() {
                          dataStore_,
                          snapshotRef_,
                          cloneRef_,
-                         snapshotCloneServerOptions_.serverOption);
+                         snapshotCloneServerOptions_.serverOption,
+                         concurrencyController_);
     if (cloneCore_->Init() < 0) {
         LOG(ERROR) << "CloneCore init fail.";
         return false;
@@ -37,6 +37,7 @@
 #include "src/snapshotcloneserver/common/curvefs_client.h"
 #include "src/snapshotcloneserver/common/snapshotclone_meta_store.h"
 #include "src/snapshotcloneserver/common/snapshotclone_metric.h"
+#include "src/snapshotcloneserver/common/concurrency_controller.h"
 
 #include "src/snapshotcloneserver/snapshot/snapshot_data_store.h"
 #include "src/snapshotcloneserver/snapshot/snapshot_data_store_s3.h"
@@ -140,6 +141,7 @@ class SnapShotCloneServer {
     std::shared_ptr<SnapshotCloneMetaStoreEtcd> metaStore_;
     std::shared_ptr<SnapshotDataStore>  dataStore_;
     std::shared_ptr<SnapshotReference>  snapshotRef_;
+    std::shared_ptr<ConcurrencyController> concurrencyController_;
     std::shared_ptr<SnapshotMetric>     snapshotMetric_;
     std::shared_ptr<SnapshotCoreImpl>   snapshotCore_;
     std::shared_ptr<SnapshotTaskManager> snapshotTaskManager_;
@@ -455,6 +455,141 @@ TEST_F(ChunkService2Test, illegial_parameters_test) {
         ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST,
                   response.status());
     }
+    /* create clone chunks op类型错误 */
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        ChunkRequest request;
+        ChunkResponse response;
+        request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE);
+        request.set_logicpoolid(logicPoolId);
+        request.set_copysetid(copysetId);
+        request.set_chunkid(chunkId);
+        request.set_correctedsn(sn);
+        request.set_size(kMaxChunkSize);
+        CloneChunkMeta *meta = request.add_clonechunks();
+        meta->set_chunkid(chunkId);
+        meta->set_sn(sn);
+        meta->set_location("test@cs");
+        stub.CreateCloneChunks(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST,
+                  response.status());
+    }
+    /* create clone chunks 大小与copyset配置不一致 */
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        ChunkRequest request;
+        ChunkResponse response;
+        request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH);
+        request.set_logicpoolid(logicPoolId);
+        request.set_copysetid(copysetId);
+        request.set_chunkid(chunkId);
+        request.set_correctedsn(sn);
+        request.set_size(kMaxChunkSize / 2);
+        CloneChunkMeta *meta = request.add_clonechunks();
+        meta->set_chunkid(chunkId);
+        meta->set_sn(sn);
+        meta->set_location("test@cs");
+        stub.CreateCloneChunks(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST,
+                  response.status());
+    }
+    /* create clone chunks 没有要创建的chunk */
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        ChunkRequest request;
+        ChunkResponse response;
+        request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH);
+        request.set_logicpoolid(logicPoolId);
+        request.set_copysetid(copysetId);
+        request.set_chunkid(chunkId);
+        request.set_correctedsn(sn);
+        request.set_size(kMaxChunkSize);
+        stub.CreateCloneChunks(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST,
+                  response.status());
+    }
+    /* create clone chunks copyset 不存在 */
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        ChunkRequest request;
+        ChunkResponse response;
+        request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH);
+        request.set_logicpoolid(logicPoolId + 1);
+        request.set_copysetid(copysetId + 1);
+        request.set_chunkid(chunkId);
+        request.set_correctedsn(sn);
+        request.set_size(kMaxChunkSize);
+        CloneChunkMeta *meta = request.add_clonechunks();
+        meta->set_chunkid(chunkId);
+        meta->set_sn(sn);
+        meta->set_location("test@cs");
+        meta = request.add_clonechunks();
+        meta->set_chunkid(chunkId + 1);
+        meta->set_sn(sn);
+        meta->set_location("test@cs");
+        stub.CreateCloneChunks(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST,
+                  response.status());
+    }
+    /* delete chunks op类型错误 */
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        ChunkRequest request;
+        ChunkResponse response;
+        request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE);
+        request.set_logicpoolid(logicPoolId);
+        request.set_copysetid(copysetId);
+        request.set_chunkid(chunkId);
+        request.set_sn(sn);
+        request.add_deletechunkids(chunkId);
+        stub.DeleteChunks(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST,
+                  response.status());
+    }
+    /* delete chunks 没有要删除的chunk */
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        ChunkRequest request;
+        ChunkResponse response;
+        request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH);
+        request.set_logicpoolid(logicPoolId);
+        request.set_copysetid(copysetId);
+        request.set_chunkid(chunkId);
+        request.set_sn(sn);
+        stub.DeleteChunks(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST,
+                  response.status());
+    }
+    /* delete chunks copyset 不存在 */
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        ChunkRequest request;
+        ChunkResponse response;
+        request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH);
+        request.set_logicpoolid(logicPoolId + 1);
+        request.set_copysetid(copysetId + 1);
+        request.set_chunkid(chunkId);
+        request.set_sn(sn);
+        request.add_deletechunkids(chunkId);
+        request.add_deletechunkids(chunkId + 1);
+        stub.DeleteChunks(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST,
+                  response.status());
+    }
     /* 不是 leader */
     {
         PeerId peer1;
@@ -556,6 +691,44 @@ TEST_F(ChunkService2Test, illegial_parameters_test) {
                       response.status());
             // ASSERT_EQ(response.redirect(), leader.to_string());
         }
+        // create clone chunks
+        {
+            brpc::Controller cntl;
+            cntl.set_timeout_ms(rpcTimeoutMs);
+            ChunkRequest request;
+            ChunkResponse response;
+            request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH);
+            request.set_logicpoolid(logicPoolId);
+            request.set_copysetid(copysetId);
+            request.set_chunkid(chunkId);
+            request.set_correctedsn(sn);
+            request.set_size(kMaxChunkSize);
+            CloneChunkMeta *meta = request.add_clonechunks();
+            meta->set_chunkid(chunkId);
+            meta->set_sn(sn);
+            meta->set_location("test@cs");
+            stub.CreateCloneChunks(&cntl, &request, &response, nullptr);
+            ASSERT_FALSE(cntl.Failed());
+            ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                      response.status());
+        }
+        // delete chunks
+        {
+            brpc::Controller cntl;
+            cntl.set_timeout_ms(rpcTimeoutMs);
+            ChunkRequest request;
+            ChunkResponse response;
+            request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH);
+            request.set_logicpoolid(logicPoolId);
+            request.set_copysetid(copysetId);
+            request.set_chunkid(chunkId);
+            request.set_sn(sn);
+            request.add_deletechunkids(chunkId);
+            stub.DeleteChunks(&cntl, &request, &response, nullptr);
+            ASSERT_FALSE(cntl.Failed());
+            ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                      response.status());
+        }
     }
 }
 
@@ -693,6 +866,38 @@ TEST_F(ChunkService2Test, overload_test) {
         ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD, response.status());
     }
 
+    // create clone chunks
+    {
+        LogicPoolID logicPoolId = 1;
+        CopysetID copysetId = 10000;
+        brpc::Controller cntl;
+        ChunkRequest request;
+        ChunkResponse response;
+        ChunkServiceTestClosure done;
+        request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH);
+        request.set_logicpoolid(logicPoolId);
+        request.set_copysetid(copysetId);
+        request.set_chunkid(chunkId);
+        chunkService.CreateCloneChunks(&cntl, &request, &response, &done);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD, response.status());
+    }
+
+    // delete chunks
+    {
+        LogicPoolID logicPoolId = 1;
+        CopysetID copysetId = 10000;
+        brpc::Controller cntl;
+        ChunkRequest request;
+        ChunkResponse response;
+        ChunkServiceTestClosure done;
+        request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH);
+        request.set_logicpoolid(logicPoolId);
+        request.set_copysetid(copysetId);
+        request.set_chunkid(chunkId);
+        chunkService.DeleteChunks(&cntl, &request, &response, &done);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD, response.status());
+    }
+
     // recover chunk
     {
         LogicPoolID logicPoolId = 1;
@@ -23,6 +23,11 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <glog/logging.h>
+#include <string.h>
+#include <future>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "include/client/libcurve.h"
 #include "src/chunkserver/clone_copyer.h"
@@ -238,6 +243,347 @@ TEST_F(CloneCopyerTest, BasicTest) {
     }
 }
 
+TEST_F(CloneCopyerTest, CurveFileCacheTest) {
+    OriginCopyer copyer;
+    CopyerOptions options;
+    options.curveConf = CURVE_CONF;
+    options.s3Conf = S3_CONF;
+    options.curveUser.owner = ROOT_OWNER;
+    options.curveUser.password = ROOT_PWD;
+    options.curveClient = curveClient_;
+    options.s3Client = nullptr;
+    // 每个shard最多保持打开一个文件
+    options.curveFileCacheCapacity = 1;
+    EXPECT_CALL(*curveClient_, Init(StrEq(CURVE_CONF)))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+    ASSERT_EQ(0, copyer.Init(options));
+
+    // 找到两个分在同一个shard中的文件
+    std::string file1 = "file0";
+    std::string file2;
+    std::hash<std::string> hasher;
+    for (int i = 1; file2.empty(); ++i) {
+        std::string name = "file" + std::to_string(i);
+        if (hasher(name) % kCurveFileShardNum ==
+            hasher(file1) % kCurveFileShardNum) {
+            file2 = name;
+        }
+    }
+
+    char* buf = new char[4096];
+    AsyncDownloadContext context;
+    context.offset = 0;
+    context.size = 4096;
+    context.buf = buf;
+    MockDownloadClosure closure(&context);
+    CurveAioContext* pending = nullptr;
+
+    // 读取file1，读完成后file1可以被关闭
+    context.location = file1 + ":0@cs";
+    EXPECT_CALL(*curveClient_, Open4ReadOnly(file1, _))
+        .WillOnce(Return(1));
+    EXPECT_CALL(*curveClient_, AioRead(1, _))
+        .WillOnce(Invoke([](int fd, CurveAioContext* context){
+            context->ret = 4096;
+            context->cb(context);
+            return LIBCURVE_ERROR::OK;
+        }));
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    closure.Reset();
+
+    // 打开file2时超出上限，关闭最久未使用的file1
+    context.location = file2 + ":0@cs";
+    EXPECT_CALL(*curveClient_, Open4ReadOnly(file2, _))
+        .WillOnce(Return(2));
+    EXPECT_CALL(*curveClient_, Close(1))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+    EXPECT_CALL(*curveClient_, AioRead(2, _))
+        .WillOnce(Invoke([&pending](int fd, CurveAioContext* context){
+            pending = context;
+            return LIBCURVE_ERROR::OK;
+        }));
+    copyer.DownloadAsync(&closure);
+    ASSERT_FALSE(closure.IsRun());
+
+    // file2有正在进行的读请求，重新打开file1时不关闭file2
+    MockDownloadClosure closure2(&context);
+    context.location = file1 + ":0@cs";
+    EXPECT_CALL(*curveClient_, Open4ReadOnly(file1, _))
+        .WillOnce(Return(3));
+    EXPECT_CALL(*curveClient_, AioRead(3, _))
+        .WillOnce(Invoke([](int fd, CurveAioContext* context){
+            context->ret = 4096;
+            context->cb(context);
+            return LIBCURVE_ERROR::OK;
+        }));
+    copyer.DownloadAsync(&closure2);
+    ASSERT_TRUE(closure2.IsRun());
+
+    pending->ret = 4096;
+    pending->cb(pending);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+
+    EXPECT_CALL(*curveClient_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*curveClient_, Close(3))
+        .Times(1);
+    EXPECT_CALL(*curveClient_, UnInit())
+        .Times(1);
+    ASSERT_EQ(0, copyer.Fini());
+    delete [] buf;
+}
+
+TEST_F(CloneCopyerTest, CurveFileOpenTest) {
+    OriginCopyer copyer;
+    CopyerOptions options;
+    options.curveConf = CURVE_CONF;
+    options.s3Conf = S3_CONF;
+    options.curveUser.owner = ROOT_OWNER;
+    options.curveUser.password = ROOT_PWD;
+    options.curveClient = curveClient_;
+    options.s3Client = nullptr;
+    options.curveFileCacheCapacity = 0;
+    EXPECT_CALL(*curveClient_, Init(StrEq(CURVE_CONF)))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+    ASSERT_EQ(0, copyer.Init(options));
+
+    // 找到两个分在同一个shard中的文件
+    std::string file1 = "file0";
+    std::string file2;
+    std::hash<std::string> hasher;
+    for (int i = 1; file2.empty(); ++i) {
+        std::string name = "file" + std::to_string(i);
+        if (hasher(name) % kCurveFileShardNum ==
+            hasher(file1) % kCurveFileShardNum) {
+            file2 = name;
+        }
+    }
+
+    char* buf = new char[4096];
+    auto readDone = [](int fd, CurveAioContext* context){
+        context->ret = 4096;
+        context->cb(context);
+        return LIBCURVE_ERROR::OK;
+    };
+
+    // 先打开file2
+    AsyncDownloadContext context2;
+    context2.location = file2 + ":0@cs";
+    context2.offset = 0;
+    context2.size = 4096;
+    context2.buf = buf;
+    MockDownloadClosure closure2(&context2);
+    EXPECT_CALL(*curveClient_, Open4ReadOnly(file2, _))
+        .WillOnce(Return(2));
+    EXPECT_CALL(*curveClient_, AioRead(2, _))
+        .Times(2)
+        .WillRepeatedly(Invoke(readDone));
+    copyer.DownloadAsync(&closure2);
+    ASSERT_TRUE(closure2.IsRun());
+    closure2.Reset();
+
+    // file1打开过程中卡住，同一个文件的其他请求等待打开完成，只打开一次
+    std::promise<void> opening;
+    std::promise<void> release;
+    std::shared_future<void> releaseFuture = release.get_future().share();
+    EXPECT_CALL(*curveClient_, Open4ReadOnly(file1, _))
+        .WillOnce(Invoke([&opening, releaseFuture](const std::string&,
+                                                   const UserInfo_t&) {
+            opening.set_value();
+            releaseFuture.wait();
+            return 1;
+        }));
+    EXPECT_CALL(*curveClient_, AioRead(1, _))
+        .Times(2)
+        .WillRepeatedly(Invoke(readDone));
+
+    AsyncDownloadContext context1;
+    context1.location = file1 + ":0@cs";
+    context1.offset = 0;
+    context1.size = 4096;
+    context1.buf = buf;
+    MockDownloadClosure closure1(&context1);
+    MockDownloadClosure closure3(&context1);
+    std::thread opener([&copyer, &closure1]() {
+        copyer.DownloadAsync(&closure1);
+    });
+    opening.get_future().wait();
+    std::thread waiter([&copyer, &closure3]() {
+        copyer.DownloadAsync(&closure3);
+    });
+
+    // 打开file1时不持有shard的锁，同一shard上file2的读请求不受影响
+    copyer.DownloadAsync(&closure2);
+    ASSERT_TRUE(closure2.IsRun());
+    ASSERT_FALSE(closure2.IsFailed());
+    ASSERT_FALSE(closure1.IsRun());
+
+    release.set_value();
+    opener.join();
+    waiter.join();
+    ASSERT_TRUE(closure1.IsRun());
+    ASSERT_FALSE(closure1.IsFailed());
+    ASSERT_TRUE(closure3.IsRun());
+    ASSERT_FALSE(closure3.IsFailed());
+
+    EXPECT_CALL(*curveClient_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*curveClient_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*curveClient_, UnInit())
+        .Times(1);
+    ASSERT_EQ(0, copyer.Fini());
+    delete [] buf;
+}
+
+TEST_F(CloneCopyerTest, S3CacheBypassTest) {
+    const uint32_t blockSize = 4096;
+    const uint32_t objectSize = 4 * blockSize;
+    OriginCopyer copyer;
+    CopyerOptions options;
+    options.s3Conf = S3_CONF;
+    options.curveClient = nullptr;
+    options.s3Client = s3Client_;
+    options.s3CacheOptions.blockSize = blockSize;
+    options.s3CacheOptions.memCapacity = objectSize;
+    options.s3CacheOptions.objectSize = objectSize;
+    ASSERT_EQ(0, copyer.Init(options));
+
+    std::vector<std::pair<off_t, size_t>> fetched;
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .WillRepeatedly(Invoke(
+            [&] (const std::shared_ptr<GetObjectAsyncContext>& context) {
+                fetched.emplace_back(context->offset, context->len);
+                context->retCode = 0;
+                context->cb(s3Client_.get(), context);
+            }));
+
+    char* buf = new char[objectSize];
+    AsyncDownloadContext context;
+    context.location = "cas-0123abcd@s3";
+    context.buf = buf;
+    MockDownloadClosure closure(&context);
+
+    /* 用例:下载整个对象
+     * 预期:按请求的范围下载一次，不写入缓存
+     */
+    context.offset = 0;
+    context.size = objectSize;
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(1, fetched.size());
+    ASSERT_EQ(0, fetched[0].first);
+    ASSERT_EQ(objectSize, fetched[0].second);
+    closure.Reset();
+
+    context.size = blockSize;
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_EQ(2, fetched.size());
+    ASSERT_EQ(blockSize, fetched[1].second);
+    closure.Reset();
+
+    /* 用例:再次读取小块数据
+     * 预期:命中缓存，不再下载
+     */
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(2, fetched.size());
+    closure.Reset();
+
+    /* 用例:recover请求读取小块数据
+     * 预期:不经过缓存，直接下载
+     */
+    context.recover = true;
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(3, fetched.size());
+    closure.Reset();
+
+    EXPECT_CALL(*s3Client_, Deinit())
+        .Times(1);
+    ASSERT_EQ(0, copyer.Fini());
+    delete [] buf;
+}
+
+TEST_F(CloneCopyerTest, S3CacheNameReuseTest) {
+    const uint32_t blockSize = 4096;
+    const uint32_t objectSize = 4 * blockSize;
+    OriginCopyer copyer;
+    CopyerOptions options;
+    options.s3Conf = S3_CONF;
+    options.curveClient = nullptr;
+    options.s3Client = s3Client_;
+    options.s3CacheOptions.blockSize = blockSize;
+    options.s3CacheOptions.memCapacity = objectSize;
+    options.s3CacheOptions.objectSize = objectSize;
+    ASSERT_EQ(0, copyer.Init(options));
+
+    // 每次下载返回不同的内容，模拟同名对象被删除后重建
+    char version = 'a';
+    int fetchCount = 0;
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .WillRepeatedly(Invoke(
+            [&] (const std::shared_ptr<GetObjectAsyncContext>& context) {
+                fetchCount++;
+                memset(context->buf, version, context->len);
+                context->retCode = 0;
+                context->cb(s3Client_.get(), context);
+            }));
+
+    char buf[blockSize];
+    AsyncDownloadContext context;
+    context.offset = 0;
+    context.size = blockSize;
+    context.buf = buf;
+    MockDownloadClosure closure(&context);
+
+    /* 用例:按逻辑名称存储的对象被重建后再次读取
+     * 预期:不经过缓存，读到重建后的内容
+     */
+    context.location = "file1-0-1@s3";
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ('a', buf[0]);
+    closure.Reset();
+
+    version = 'b';
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ('b', buf[0]);
+    ASSERT_EQ(2, fetchCount);
+    closure.Reset();
+
+    /* 用例:重复读取按内容哈希命名的对象
+     * 预期:第二次读取命中缓存
+     */
+    context.location = "cas-0123abcd@s3";
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ(3, fetchCount);
+    closure.Reset();
+
+    copyer.DownloadAsync(&closure);
+    ASSERT_TRUE(closure.IsRun());
+    ASSERT_FALSE(closure.IsFailed());
+    ASSERT_EQ('b', buf[0]);
+    ASSERT_EQ(3, fetchCount);
+    closure.Reset();
+
+    EXPECT_CALL(*s3Client_, Deinit())
+        .Times(1);
+    ASSERT_EQ(0, copyer.Fini());
+}
+
 TEST_F(CloneCopyerTest, DisableTest) {
     OriginCopyer copyer;
     CopyerOptions options;
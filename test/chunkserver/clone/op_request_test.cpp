@@ -24,6 +24,7 @@
 #include <gmock/gmock.h>
 #include <glog/logging.h>
 #include <memory>
+#include <vector>
 
 #include "src/chunkserver/op_request.h"
 #include "test/chunkserver/clone/clone_test_util.h"
@@ -310,6 +311,441 @@ TEST_F(OpRequestTest, CreateCloneTest) {
     closure->Release();
 }
 
+TEST_F(OpRequestTest, CreateClonesTest) {
+    // 创建CreateCloneChunksRequest
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint64_t chunkId1 = 12345;
+    uint64_t chunkId2 = 12346;
+    uint32_t size = CHUNK_SIZE;
+    uint64_t sn = 1;
+    uint64_t correctedSn = 2;
+    string location1("test1@cs");
+    string location2("test2@cs");
+    ChunkRequest* request = new ChunkRequest();
+    request->set_logicpoolid(logicPoolId);
+    request->set_copysetid(copysetId);
+    request->set_chunkid(chunkId1);
+    request->set_optype(CHUNK_OP_CREATE_CLONE_BATCH);
+    request->set_size(size);
+    request->set_correctedsn(correctedSn);
+    CloneChunkMeta* meta = request->add_clonechunks();
+    meta->set_chunkid(chunkId1);
+    meta->set_sn(sn);
+    meta->set_location(location1);
+    meta = request->add_clonechunks();
+    meta->set_chunkid(chunkId2);
+    meta->set_sn(sn);
+    meta->set_location(location2);
+    brpc::Controller *cntl = new brpc::Controller();
+    ChunkResponse *response = new ChunkResponse();
+    UnitTestClosure *closure = new UnitTestClosure();
+    closure->SetCntl(cntl);
+    closure->SetRequest(request);
+    closure->SetResponse(response);
+    std::shared_ptr<CreateCloneChunksRequest> opReq =
+        std::make_shared<CreateCloneChunksRequest>(node_,
+                                                   cntl,
+                                                   request,
+                                                   response,
+                                                   closure);
+    // 校验传给datastore的chunk信息
+    auto checkChunks = [&](const std::vector<CloneChunkDesc>& chunks) {
+        return chunks.size() == 2 &&
+               chunks[0].id == chunkId1 &&
+               chunks[0].sn == sn &&
+               chunks[0].location == location1 &&
+               chunks[1].id == chunkId2 &&
+               chunks[1].sn == sn &&
+               chunks[1].location == location2;
+    };
+    /**
+     * 测试Encode/Decode
+     */
+    {
+        butil::IOBuf log;
+        ASSERT_EQ(0, opReq->Encode(request, &cntl->request_attachment(), &log));
+
+        butil::IOBuf data;
+        auto req = ChunkOpRequest::Decode(log, request, &data);
+        auto req1 = dynamic_cast<CreateCloneChunksRequest*>(req.get());
+        ASSERT_TRUE(req1 != nullptr);
+
+        ASSERT_EQ(CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH,
+                  request->optype());
+        ASSERT_EQ(logicPoolId, request->logicpoolid());
+        ASSERT_EQ(copysetId, request->copysetid());
+        ASSERT_EQ(chunkId1, request->chunkid());
+        ASSERT_EQ(size, request->size());
+        ASSERT_EQ(correctedSn, request->correctedsn());
+        ASSERT_EQ(2, request->clonechunks_size());
+        ASSERT_EQ(chunkId2, request->clonechunks(1).chunkid());
+        ASSERT_EQ(location2, request->clonechunks(1).location());
+    }
+    /**
+     * 测试Process
+     * 用例： node_->IsLeaderTerm() == false
+     * 预期： 会要求转发请求，返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        // 设置预期
+        EXPECT_CALL(*node_, IsLeaderTerm())
+            .WillRepeatedly(Return(false));
+        EXPECT_CALL(*node_, Propose(_))
+            .Times(0);
+
+        opReq->Process();
+
+        // 验证结果
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_FALSE(response->has_appliedindex());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  closure->response_->status());
+    }
+    /**
+     * 测试Process
+     * 用例： node_->IsLeaderTerm() == true
+     * 预期： 会调用Propose，且不会调用closure
+     */
+    {
+        // 重置closure
+        closure->Reset();
+
+        // 设置预期
+        EXPECT_CALL(*node_, IsLeaderTerm())
+            .WillRepeatedly(Return(true));
+        braft::Task task;
+        EXPECT_CALL(*node_, Propose(_))
+            .WillOnce(SaveArg<0>(&task));
+
+        opReq->Process();
+
+        // 验证结果
+        ASSERT_FALSE(closure->isDone_);
+        ASSERT_FALSE(response->has_appliedindex());
+        ASSERT_FALSE(closure->response_->has_status());
+        // 由于这里node是mock的，因此需要主动来执行task.done.Run来释放资源
+        ASSERT_NE(nullptr, task.done);
+        task.done->Run();
+        ASSERT_TRUE(closure->isDone_);
+    }
+    /**
+     * 测试OnApply
+     * 用例：CreateCloneChunks成功，部分chunk已存在且信息不符
+     * 预期：返回 CHUNK_OP_STATUS_SUCCESS，带上冲突的chunk，并更新apply index
+     */
+    {
+        // 重置closure
+        closure->Reset();
+
+        // 设置预期
+        std::vector<ChunkID> conflictIds = {chunkId2};
+        EXPECT_CALL(*datastore_, CreateCloneChunks(Truly(checkChunks),
+                                                   correctedSn,
+                                                   size,
+                                                   NotNull()))
+            .WillOnce(DoAll(SetArgPointee<3>(conflictIds),
+                            Return(CSErrorCode::Success)));
+        EXPECT_CALL(*node_, UpdateAppliedIndex(3))
+            .Times(1);
+
+        opReq->OnApply(3, closure);
+
+        // 验证结果
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(LAST_INDEX, response->appliedindex());
+        ASSERT_TRUE(response->has_status());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  closure->response_->status());
+        ASSERT_EQ(1, response->existchunkids_size());
+        ASSERT_EQ(chunkId2, response->existchunkids(0));
+    }
+    /**
+     * 测试OnApply
+     * 用例：CreateCloneChunks成功，没有冲突的chunk
+     * 预期：返回 CHUNK_OP_STATUS_SUCCESS，existChunkIds为空
+     */
+    {
+        // 重置closure
+        closure->Reset();
+        response->clear_existchunkids();
+
+        // 设置预期
+        EXPECT_CALL(*datastore_, CreateCloneChunks(_, _, _, _))
+            .WillOnce(Return(CSErrorCode::Success));
+        EXPECT_CALL(*node_, UpdateAppliedIndex(3))
+            .Times(1);
+
+        opReq->OnApply(3, closure);
+
+        // 验证结果
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  closure->response_->status());
+        ASSERT_EQ(0, response->existchunkids_size());
+    }
+    /**
+     * 测试OnApply
+     * 用例：CreateCloneChunks失败
+     * 预期：进程退出
+     */
+    {
+        // 重置closure
+        closure->Reset();
+
+        // 设置预期
+        EXPECT_CALL(*datastore_, CreateCloneChunks(_, _, _, _))
+            .WillRepeatedly(Return(CSErrorCode::InternalError));
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_))
+            .Times(0);
+
+        ASSERT_DEATH(opReq->OnApply(3, closure), "");
+    }
+    /**
+     * 测试OnApply
+     * 用例：CreateCloneChunks失败,返回其他错误
+     * 预期：返回CHUNK_OP_STATUS_FAILURE_UNKNOWN，不更新apply index
+     */
+    {
+        // 重置closure
+        closure->Reset();
+
+        // 设置预期
+        EXPECT_CALL(*datastore_, CreateCloneChunks(_, _, _, _))
+            .WillRepeatedly(Return(CSErrorCode::InvalidArgError));
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_))
+            .Times(0);
+
+        opReq->OnApply(3, closure);
+
+        // 验证结果
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(LAST_INDEX, response->appliedindex());
+        ASSERT_TRUE(response->has_status());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN,
+                  closure->response_->status());
+    }
+    /**
+     * 测试 OnApplyFromLog
+     * 用例：CreateCloneChunks成功
+     * 预期：无返回
+     */
+    {
+        // 重置closure
+        closure->Reset();
+
+        // 设置预期
+        std::vector<ChunkID> conflictIds = {chunkId2};
+        EXPECT_CALL(*datastore_, CreateCloneChunks(Truly(checkChunks),
+                                                   correctedSn,
+                                                   size,
+                                                   NotNull()))
+            .WillOnce(DoAll(SetArgPointee<3>(conflictIds),
+                            Return(CSErrorCode::Success)));
+
+        butil::IOBuf data;
+        opReq->OnApplyFromLog(datastore_, *request, data);
+    }
+    /**
+     * 测试 OnApplyFromLog
+     * 用例：CreateCloneChunks失败，返回InternalError
+     * 预期：进程退出
+     */
+    {
+        // 重置closure
+        closure->Reset();
+
+        // 设置预期
+        EXPECT_CALL(*datastore_, CreateCloneChunks(_, _, _, _))
+            .WillRepeatedly(Return(CSErrorCode::InternalError));
+
+        butil::IOBuf data;
+        ASSERT_DEATH(opReq->OnApplyFromLog(datastore_, *request, data), "");
+    }
+    /**
+     * 测试 OnApplyFromLog
+     * 用例：CreateCloneChunks失败，返回其他错误
+     * 预期：无返回
+     */
+    {
+        // 重置closure
+        closure->Reset();
+
+        // 设置预期
+        EXPECT_CALL(*datastore_, CreateCloneChunks(_, _, _, _))
+            .WillRepeatedly(Return(CSErrorCode::InvalidArgError));
+
+        butil::IOBuf data;
+        opReq->OnApplyFromLog(datastore_, *request, data);
+    }
+    // 释放资源
+    closure->Release();
+}
+
+TEST_F(OpRequestTest, DeleteChunksTest) {
+    // 创建DeleteChunksRequest
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint64_t chunkId1 = 12345;
+    uint64_t chunkId2 = 12346;
+    uint64_t sn = 1;
+    ChunkRequest* request = new ChunkRequest();
+    request->set_logicpoolid(logicPoolId);
+    request->set_copysetid(copysetId);
+    request->set_chunkid(chunkId1);
+    request->set_optype(CHUNK_OP_DELETE_BATCH);
+    request->set_sn(sn);
+    request->add_deletechunkids(chunkId1);
+    request->add_deletechunkids(chunkId2);
+    brpc::Controller *cntl = new brpc::Controller();
+    ChunkResponse *response = new ChunkResponse();
+    UnitTestClosure *closure = new UnitTestClosure();
+    closure->SetCntl(cntl);
+    closure->SetRequest(request);
+    closure->SetResponse(response);
+    std::shared_ptr<DeleteChunksRequest> opReq =
+        std::make_shared<DeleteChunksRequest>(node_,
+                                              cntl,
+                                              request,
+                                              response,
+                                              closure);
+    /**
+     * 测试Encode/Decode
+     */
+    {
+        butil::IOBuf log;
+        ASSERT_EQ(0, opReq->Encode(request, &cntl->request_attachment(), &log));
+
+        butil::IOBuf data;
+        auto req = ChunkOpRequest::Decode(log, request, &data);
+        auto req1 = dynamic_cast<DeleteChunksRequest*>(req.get());
+        ASSERT_TRUE(req1 != nullptr);
+
+        ASSERT_EQ(CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH, request->optype());
+        ASSERT_EQ(logicPoolId, request->logicpoolid());
+        ASSERT_EQ(copysetId, request->copysetid());
+        ASSERT_EQ(sn, request->sn());
+        ASSERT_EQ(2, request->deletechunkids_size());
+        ASSERT_EQ(chunkId2, request->deletechunkids(1));
+    }
+    /**
+     * 测试Process
+     * 用例： node_->IsLeaderTerm() == false
+     * 预期： 会要求转发请求，返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        // 设置预期
+        EXPECT_CALL(*node_, IsLeaderTerm())
+            .WillRepeatedly(Return(false));
+        EXPECT_CALL(*node_, Propose(_))
+            .Times(0);
+
+        opReq->Process();
+
+        // 验证结果
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_FALSE(response->has_appliedindex());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  closure->response_->status());
+    }
+    /**
+     * 测试OnApply
+     * 用例：所有chunk都删除成功
+     * 预期：返回 CHUNK_OP_STATUS_SUCCESS，并更新apply index
+     */
+    {
+        // 重置closure
+        closure->Reset();
+
+        // 设置预期
+        EXPECT_CALL(*datastore_, DeleteChunk(chunkId1, sn))
+            .WillOnce(Return(CSErrorCode::Success));
+        EXPECT_CALL(*datastore_, DeleteChunk(chunkId2, sn))
+            .WillOnce(Return(CSErrorCode::Success));
+        EXPECT_CALL(*node_, UpdateAppliedIndex(3))
+            .Times(1);
+
+        opReq->OnApply(3, closure);
+
+        // 验证结果
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(LAST_INDEX, response->appliedindex());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  closure->response_->status());
+    }
+    /**
+     * 测试OnApply
+     * 用例：删除第一个chunk失败,返回其他错误
+     * 预期：不再删除后面的chunk，返回CHUNK_OP_STATUS_FAILURE_UNKNOWN，
+     *      不更新apply index
+     */
+    {
+        // 重置closure
+        closure->Reset();
+
+        // 设置预期
+        EXPECT_CALL(*datastore_, DeleteChunk(chunkId1, sn))
+            .WillOnce(Return(CSErrorCode::BackwardRequestError));
+        EXPECT_CALL(*datastore_, DeleteChunk(chunkId2, _))
+            .Times(0);
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_))
+            .Times(0);
+
+        opReq->OnApply(3, closure);
+
+        // 验证结果
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(LAST_INDEX, response->appliedindex());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN,
+                  closure->response_->status());
+    }
+    /**
+     * 测试OnApply
+     * 用例：删除chunk返回InternalError
+     * 预期：进程退出
+     */
+    {
+        // 重置closure
+        closure->Reset();
+
+        // 设置预期
+        EXPECT_CALL(*datastore_, DeleteChunk(_, _))
+            .WillRepeatedly(Return(CSErrorCode::InternalError));
+
+        ASSERT_DEATH(opReq->OnApply(3, closure), "");
+    }
+    /**
+     * 测试 OnApplyFromLog
+     * 用例：所有chunk都删除成功
+     * 预期：每个chunk都被删除
+     */
+    {
+        // 设置预期
+        EXPECT_CALL(*datastore_, DeleteChunk(chunkId1, sn))
+            .WillOnce(Return(CSErrorCode::Success));
+        EXPECT_CALL(*datastore_, DeleteChunk(chunkId2, sn))
+            .WillOnce(Return(CSErrorCode::Success));
+
+        butil::IOBuf data;
+        opReq->OnApplyFromLog(datastore_, *request, data);
+    }
+    /**
+     * 测试 OnApplyFromLog
+     * 用例：删除chunk返回InternalError
+     * 预期：进程退出
+     */
+    {
+        // 设置预期
+        EXPECT_CALL(*datastore_, DeleteChunk(_, _))
+            .WillRepeatedly(Return(CSErrorCode::InternalError));
+
+        butil::IOBuf data;
+        ASSERT_DEATH(opReq->OnApplyFromLog(datastore_, *request, data), "");
+    }
+    // 释放资源
+    closure->Release();
+}
+
 TEST_F(OpRequestTest, PasteChunkTest) {
     // 生成临时的readrequest
     ChunkResponse *response = new ChunkResponse();
@@ -976,6 +1412,153 @@ TEST_F(OpRequestTest, ReadChunkTest) {
     closure->Release();
 }
 
+TEST_F(OpRequestTest, FollowerReadTest) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint64_t chunkId = 12345;
+    uint32_t offset = 0;
+    uint32_t length = 5 * PAGE_SIZE;
+    ChunkRequest* request = new ChunkRequest();
+    request->set_logicpoolid(logicPoolId);
+    request->set_copysetid(copysetId);
+    request->set_chunkid(chunkId);
+    request->set_optype(CHUNK_OP_READ);
+    request->set_offset(offset);
+    request->set_size(length);
+    brpc::Controller *cntl = new brpc::Controller();
+    ChunkResponse *response = new ChunkResponse();
+    UnitTestClosure *closure = new UnitTestClosure();
+    closure->SetCntl(cntl);
+    closure->SetRequest(request);
+    closure->SetResponse(response);
+    std::shared_ptr<ReadChunkRequest> opReq =
+        std::make_shared<ReadChunkRequest>(node_,
+                                           cloneMgr_.get(),
+                                           cntl,
+                                           request,
+                                           response,
+                                           closure);
+    // 以下用例都在follower上处理
+    EXPECT_CALL(*node_, IsLeaderTerm())
+        .WillRepeatedly(Return(false));
+
+    /**
+     * 测试Process
+     * 用例： 请求的 apply index 大于 follower的 apply index
+     * 预期： follower落后，返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        request->set_appliedindex(LAST_INDEX + 1);
+        EXPECT_CALL(*node_, Propose(_))
+            .Times(0);
+
+        opReq->Process();
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  closure->response_->status());
+    }
+    /**
+     * 测试Process
+     * 用例： 请求的 apply index 等于 follower的 apply index，
+     *       但op类型为CHUNK_OP_RECOVER
+     * 预期： 只有普通读可以在follower上处理，返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        closure->Reset();
+        request->set_appliedindex(LAST_INDEX);
+        request->set_optype(CHUNK_OP_RECOVER);
+        EXPECT_CALL(*node_, Propose(_))
+            .Times(0);
+
+        opReq->Process();
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  closure->response_->status());
+        request->set_optype(CHUNK_OP_READ);
+    }
+    /**
+     * 测试Process
+     * 用例： 请求的 apply index 小于等于 follower的 apply index
+     * 预期： follower已经追上，不走一致性协议，
+     *       请求提交给concurrentApplyModule_处理
+     */
+    {
+        closure->Reset();
+        request->set_appliedindex(LAST_INDEX);
+        EXPECT_CALL(*node_, Propose(_))
+            .Times(0);
+
+        opReq->Process();
+
+        ASSERT_FALSE(closure->isDone_);
+        ASSERT_FALSE(closure->response_->has_status());
+    }
+    CSChunkInfo info;
+    info.isClone = false;
+    info.pageSize = PAGE_SIZE;
+    info.chunkSize = CHUNK_SIZE;
+    info.bitmap = std::make_shared<Bitmap>(CHUNK_SIZE / PAGE_SIZE);
+    /**
+     * 测试OnApply
+     * 用例：follower上读非clone chunk
+     * 预期：从本地读chunk,返回 CHUNK_OP_STATUS_SUCCESS
+     */
+    {
+        char chunkData[length];  // NOLINT
+        memset(chunkData, 'a', length);
+        EXPECT_CALL(*datastore_, GetChunkInfo(_, _))
+            .WillOnce(DoAll(SetArgPointee<1>(info),
+                            Return(CSErrorCode::Success)));
+        EXPECT_CALL(*datastore_, ReadChunk(_, _, _, offset, length))
+            .WillOnce(DoAll(SetArrayArgument<2>(chunkData,
+                                                chunkData + length),
+                            Return(CSErrorCode::Success)));
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_))
+            .Times(1);
+
+        opReq->OnApply(LAST_INDEX, closure);
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  response->status());
+        ASSERT_EQ(LAST_INDEX, response->appliedindex());
+        ASSERT_EQ(memcmp(chunkData,
+                         cntl->response_attachment().to_string().c_str(),  //NOLINT
+                         length), 0);
+    }
+    /**
+     * 测试OnApply
+     * 用例：follower上读clone chunk，请求区域未写过
+     * 预期：不下发clone任务，返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        closure->Reset();
+        info.isClone = true;
+        info.bitmap->Clear();
+        EXPECT_CALL(*datastore_, GetChunkInfo(_, _))
+            .WillOnce(DoAll(SetArgPointee<1>(info),
+                            Return(CSErrorCode::Success)));
+        EXPECT_CALL(*datastore_, ReadChunk(_, _, _, _, _))
+            .Times(0);
+        EXPECT_CALL(*cloneMgr_, GenerateCloneTask(_, _))
+            .Times(0);
+        EXPECT_CALL(*cloneMgr_, IssueCloneTask(_))
+            .Times(0);
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_))
+            .Times(0);
+
+        opReq->OnApply(LAST_INDEX, closure);
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  response->status());
+    }
+    // 释放资源
+    closure->Release();
+}
+
 TEST_F(OpRequestTest, RecoverChunkTest) {
     // 创建CreateCloneChunkRequest
     LogicPoolID logicPoolId = 1;
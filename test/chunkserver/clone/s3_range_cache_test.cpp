@@ -0,0 +1,213 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/chunkserver/s3_range_cache.h"
+#include "src/fs/local_filesystem.h"
+
+using curve::fs::FileSystemType;
+using curve::fs::LocalFsFactory;
+
+namespace curve {
+namespace chunkserver {
+
+const char kCacheDir[] = "./s3_range_cache_test";
+const uint32_t kBlockSize = 4096;
+
+class S3RangeCacheTest : public testing::Test {
+ public:
+    void SetUp() {
+        lfs_ = LocalFsFactory::CreateFs(FileSystemType::EXT4, "");
+        options_.blockSize = kBlockSize;
+        options_.memCapacity = 2 * kBlockSize;
+        options_.diskCapacity = 4 * kBlockSize;
+        options_.diskPath = kCacheDir;
+        fetchRet_ = 0;
+        // 对象中每个字节的内容为所在block的序号
+        fetcher_ = [this] (const std::string& name, off_t offset,
+                           size_t length, char* buf, RangeFetchDone done) {
+            fetched_.push_back(offset);
+            memset(buf, 'a' + offset / kBlockSize, length);
+            if (delayFetch_) {
+                pendingDone_.push_back(done);
+            } else {
+                done(fetchRet_);
+            }
+        };
+        delayFetch_ = false;
+    }
+
+    void TearDown() {
+        lfs_->Delete(kCacheDir);
+    }
+
+    int Read(S3RangeCache* cache, off_t offset, size_t length, char* buf) {
+        int ret = 1;
+        cache->Read("obj", offset, length, buf,
+                    [&ret] (int retCode) { ret = retCode; });
+        return ret;
+    }
+
+ protected:
+    std::shared_ptr<LocalFileSystem> lfs_;
+    S3RangeCacheOptions options_;
+    RangeFetcher fetcher_;
+    int fetchRet_;
+    bool delayFetch_;
+    std::vector<off_t> fetched_;
+    std::vector<RangeFetchDone> pendingDone_;
+};
+
+TEST_F(S3RangeCacheTest, ReadTest) {
+    S3RangeCache cache(options_, lfs_, fetcher_);
+    ASSERT_EQ(0, cache.Init());
+    ASSERT_TRUE(lfs_->DirExists(kCacheDir));
+
+    // 跨block的读按照block对齐从s3下载
+    char buf[3 * kBlockSize];
+    ASSERT_EQ(0, Read(&cache, kBlockSize / 2, kBlockSize, buf));
+    ASSERT_EQ(2, fetched_.size());
+    ASSERT_EQ(0, fetched_[0]);
+    ASSERT_EQ(kBlockSize, fetched_[1]);
+    ASSERT_EQ('a', buf[0]);
+    ASSERT_EQ('a', buf[kBlockSize / 2 - 1]);
+    ASSERT_EQ('b', buf[kBlockSize / 2]);
+    ASSERT_EQ('b', buf[kBlockSize - 1]);
+    ASSERT_EQ(2, cache.GetMetric().miss.get_value());
+
+    // 再次读取命中内存缓存
+    ASSERT_EQ(0, Read(&cache, 0, 2 * kBlockSize, buf));
+    ASSERT_EQ(2, fetched_.size());
+    ASSERT_EQ('a', buf[0]);
+    ASSERT_EQ('b', buf[2 * kBlockSize - 1]);
+    ASSERT_EQ(2, cache.GetMetric().memHit.get_value());
+    ASSERT_EQ(2 * kBlockSize, cache.GetMetric().memBytes.get_value());
+
+    // 内存缓存淘汰的block从磁盘缓存读取
+    ASSERT_EQ(0, Read(&cache, 2 * kBlockSize, 2 * kBlockSize, buf));
+    ASSERT_EQ(4, fetched_.size());
+    ASSERT_EQ(2 * kBlockSize, cache.GetMetric().memBytes.get_value());
+    ASSERT_EQ(4 * kBlockSize, cache.GetMetric().diskBytes.get_value());
+    ASSERT_EQ(0, Read(&cache, 0, kBlockSize, buf));
+    ASSERT_EQ(4, fetched_.size());
+    ASSERT_EQ('a', buf[kBlockSize - 1]);
+    ASSERT_EQ(1, cache.GetMetric().diskHit.get_value());
+
+    // 磁盘缓存淘汰后重新从s3下载
+    ASSERT_EQ(0, Read(&cache, 4 * kBlockSize, kBlockSize, buf));
+    ASSERT_EQ(5, fetched_.size());
+    ASSERT_EQ(4 * kBlockSize, cache.GetMetric().diskBytes.get_value());
+    ASSERT_EQ(0, Read(&cache, kBlockSize, kBlockSize, buf));
+    ASSERT_EQ(6, fetched_.size());
+    ASSERT_EQ('b', buf[0]);
+
+    // 下载失败时返回失败，不缓存
+    fetchRet_ = -1;
+    ASSERT_EQ(-1, Read(&cache, 8 * kBlockSize, kBlockSize, buf));
+    ASSERT_EQ(-1, Read(&cache, 8 * kBlockSize, kBlockSize, buf));
+    ASSERT_EQ(8, fetched_.size());
+}
+
+TEST_F(S3RangeCacheTest, CoalesceTest) {
+    options_.diskCapacity = 0;
+    S3RangeCache cache(options_, lfs_, fetcher_);
+    ASSERT_EQ(0, cache.Init());
+    ASSERT_FALSE(lfs_->DirExists(kCacheDir));
+
+    // 相同block的并发请求只下载一次
+    delayFetch_ = true;
+    char buf1[kBlockSize];
+    char buf2[2 * kBlockSize];
+    int ret1 = 1;
+    int ret2 = 1;
+    cache.Read("obj", 0, kBlockSize, buf1,
+               [&ret1] (int retCode) { ret1 = retCode; });
+    cache.Read("obj", 0, 2 * kBlockSize, buf2,
+               [&ret2] (int retCode) { ret2 = retCode; });
+    ASSERT_EQ(2, fetched_.size());
+    ASSERT_EQ(1, cache.GetMetric().coalesced.get_value());
+    ASSERT_EQ(2, pendingDone_.size());
+
+    // 所有block完成后才返回
+    pendingDone_[0](0);
+    ASSERT_EQ(0, ret1);
+    ASSERT_EQ(1, ret2);
+    pendingDone_[1](-1);
+    ASSERT_EQ(-1, ret2);
+    ASSERT_EQ('a', buf1[0]);
+    ASSERT_EQ('a', buf2[kBlockSize - 1]);
+
+    // 不同对象的block不会合并
+    cache.Read("obj2", 0, kBlockSize, buf1, [] (int retCode) {});
+    ASSERT_EQ(3, fetched_.size());
+    pendingDone_[2](0);
+    ASSERT_DOUBLE_EQ(1.0 / 4, cache.GetMetric().hitRate.get_value());
+}
+
+TEST_F(S3RangeCacheTest, ReadAheadTest) {
+    options_.diskCapacity = 0;
+    options_.memCapacity = 8 * kBlockSize;
+    options_.objectSize = 4 * kBlockSize;
+    options_.readAheadBlocks = 2;
+    S3RangeCache cache(options_, lfs_, fetcher_);
+    ASSERT_EQ(0, cache.Init());
+
+    // 从对象开头读取时向后预读
+    char buf[kBlockSize];
+    ASSERT_EQ(0, Read(&cache, 0, kBlockSize, buf));
+    ASSERT_EQ(3, fetched_.size());
+    ASSERT_EQ(kBlockSize, fetched_[1]);
+    ASSERT_EQ(2 * kBlockSize, fetched_[2]);
+    ASSERT_EQ(2, cache.GetMetric().readAhead.get_value());
+
+    // 预读的block直接命中
+    ASSERT_EQ(0, Read(&cache, kBlockSize, kBlockSize, buf));
+    ASSERT_EQ('b', buf[0]);
+    ASSERT_EQ(3, fetched_.size());
+    ASSERT_EQ(1, cache.GetMetric().memHit.get_value());
+
+    // 顺序读未命中时预读不超出对象的范围
+    ASSERT_EQ(0, Read(&cache, 2 * kBlockSize, kBlockSize, buf));
+    ASSERT_EQ(2, cache.GetMetric().memHit.get_value());
+    ASSERT_EQ(0, Read(&cache, 3 * kBlockSize, kBlockSize, buf));
+    ASSERT_EQ(4, fetched_.size());
+    ASSERT_EQ(2, cache.GetMetric().readAhead.get_value());
+
+    // 非顺序读不预读
+    cache.Read("obj2", 2 * kBlockSize, kBlockSize, buf, [] (int retCode) {});
+    ASSERT_EQ(5, fetched_.size());
+    ASSERT_EQ(2, cache.GetMetric().readAhead.get_value());
+}
+
+TEST_F(S3RangeCacheTest, IsCacheableTest) {
+    // 只有按内容哈希命名的对象可以缓存
+    ASSERT_TRUE(S3RangeCache::IsCacheable("cas-0123abcd"));
+    ASSERT_FALSE(S3RangeCache::IsCacheable("file1-0-1"));
+    ASSERT_FALSE(S3RangeCache::IsCacheable("cas-"));
+    ASSERT_FALSE(S3RangeCache::IsCacheable("file-cas-0"));
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -31,16 +31,20 @@
 #include <vector>
 #include <string>
 #include <cstdlib>
+#include <atomic>
+#include <thread>
 
 #include "test/fs/mock_local_filesystem.h"
 #include "src/chunkserver/copyset_node_manager.h"
 #include "src/chunkserver/copyset_node.h"
+#include "src/chunkserver/op_request.h"
 #include "test/chunkserver/fake_datastore.h"
 #include "test/chunkserver/mock_node.h"
 #include "src/chunkserver/conf_epoch_file.h"
 #include "proto/heartbeat.pb.h"
 #include "src/chunkserver/raftsnapshot/curve_snapshot_attachment.h"
 #include "test/chunkserver/mock_curve_filesystem_adaptor.h"
+#include "test/chunkserver/datastore/mock_datastore.h"
 
 namespace curve {
 namespace chunkserver {
@@ -54,6 +58,7 @@ using ::testing::SetArgPointee;
 using ::testing::SetArgReferee;
 using ::testing::InSequence;
 using ::testing::AtLeast;
+using ::testing::Matcher;
 using ::testing::SaveArgPointee;
 
 using curve::fs::MockLocalFileSystem;
@@ -1009,5 +1014,274 @@ TEST_F(CopysetNodeTest, get_leader_status) {
     }
 }
 
+TEST_F(CopysetNodeTest, apply_task_test) {
+    LogicPoolID logicPoolID = 123;
+    CopysetID copysetID = 1345;
+    Configuration conf;
+    std::shared_ptr<CopysetNode> copysetNode =
+        std::make_shared<CopysetNode>(logicPoolID, copysetID, conf);
+    ASSERT_EQ(0, copysetNode->Init(defaultOptions_));
+    std::shared_ptr<MockDataStore> dataStore =
+        std::make_shared<MockDataStore>();
+    copysetNode->SetCSDateStore(dataStore);
+
+    const uint32_t kMaxChunkSize = 16 * 1024 * 1024;
+    const std::thread::id callerId = std::this_thread::get_id();
+    // 普通op在并发apply模块中执行，执行前先睡眠一会，确保后面的批量op需要等待
+    std::atomic<int> finished(0);
+    std::atomic<bool> normalInCaller(false);
+    auto normalTask = [&]() {
+        ::usleep(100 * 1000);
+        if (std::this_thread::get_id() == callerId) {
+            normalInCaller = true;
+        }
+        finished.fetch_add(1);
+    };
+
+    // 1. 批量op等之前的普通op都执行完，然后在调用线程中执行
+    {
+        finished = 0;
+        copysetNode->ApplyTask(CHUNK_OP_TYPE::CHUNK_OP_WRITE, 1, normalTask);
+        copysetNode->ApplyTask(CHUNK_OP_TYPE::CHUNK_OP_WRITE, 2, normalTask);
+        int finishedBeforeBatch = -1;
+        std::thread::id batchId;
+        copysetNode->ApplyTask(CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH, 1,
+            [&]() {
+                finishedBeforeBatch = finished.load();
+                batchId = std::this_thread::get_id();
+            });
+        // ApplyTask返回时批量op已经执行完
+        ASSERT_EQ(2, finishedBeforeBatch);
+        ASSERT_EQ(callerId, batchId);
+        ASSERT_FALSE(normalInCaller);
+
+        // 批量op之后的普通op仍然分发到并发apply模块执行
+        copysetNode->ApplyTask(CHUNK_OP_TYPE::CHUNK_OP_WRITE, 1, normalTask);
+        concurrentModule_.Flush();
+        ASSERT_EQ(3, finished.load());
+        ASSERT_FALSE(normalInCaller);
+    }
+
+    ChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_CREATE_CLONE_BATCH);
+    request.set_logicpoolid(logicPoolID);
+    request.set_copysetid(copysetID);
+    request.set_chunkid(1);
+    request.set_correctedsn(2);
+    request.set_size(kMaxChunkSize);
+    CloneChunkMeta *meta = request.add_clonechunks();
+    meta->set_chunkid(1);
+    meta->set_sn(1);
+    meta->set_location("test1@cs");
+    meta = request.add_clonechunks();
+    meta->set_chunkid(2);
+    meta->set_sn(1);
+    meta->set_location("test2@cs");
+    std::vector<ChunkID> conflictIds = {2};
+
+    // 2. leader apply：从closure中拿到op，批量op等之前的op执行完后执行
+    {
+        finished = 0;
+        ChunkResponse response;
+        FakeClosure done;
+        std::shared_ptr<ChunkOpRequest> opReq =
+            std::make_shared<CreateCloneChunksRequest>(copysetNode,
+                                                       nullptr,
+                                                       &request,
+                                                       &response,
+                                                       nullptr);
+        int finishedBeforeBatch = -1;
+        EXPECT_CALL(*dataStore, CreateCloneChunks(_, 2, kMaxChunkSize, _))
+            .WillOnce(DoAll(Invoke([&](const std::vector<CloneChunkDesc>&,
+                                       SequenceNum,
+                                       ChunkSizeType,
+                                       std::vector<ChunkID>*) {
+                                finishedBeforeBatch = finished.load();
+                            }),
+                            SetArgPointee<3>(conflictIds),
+                            Return(CSErrorCode::Success)));
+
+        copysetNode->ApplyTask(CHUNK_OP_TYPE::CHUNK_OP_WRITE, 2, normalTask);
+        auto task = std::bind(&ChunkOpRequest::OnApply, opReq, 10, &done);
+        copysetNode->ApplyTask(opReq->OpType(), opReq->ChunkId(), task);
+
+        ASSERT_EQ(1, finishedBeforeBatch);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS, response.status());
+        ASSERT_EQ(1, response.existchunkids_size());
+        ASSERT_EQ(2, response.existchunkids(0));
+        ASSERT_EQ(10, copysetNode->GetAppliedIndex());
+        ASSERT_EQ(10, response.appliedindex());
+    }
+
+    // 3. follower apply：从日志中解析出op，批量op等之前的op执行完后执行
+    {
+        finished = 0;
+        butil::IOBuf log;
+        butil::IOBuf data;
+        ASSERT_EQ(0, ChunkOpRequest::Encode(&request, &data, &log));
+        ChunkRequest logRequest;
+        butil::IOBuf logData;
+        auto opReq = ChunkOpRequest::Decode(log, &logRequest, &logData);
+        ASSERT_TRUE(nullptr !=
+            dynamic_cast<CreateCloneChunksRequest *>(opReq.get()));
+
+        int finishedBeforeBatch = -1;
+        EXPECT_CALL(*dataStore, CreateCloneChunks(_, 2, kMaxChunkSize, _))
+            .WillOnce(DoAll(Invoke([&](const std::vector<CloneChunkDesc>&,
+                                       SequenceNum,
+                                       ChunkSizeType,
+                                       std::vector<ChunkID>*) {
+                                finishedBeforeBatch = finished.load();
+                            }),
+                            SetArgPointee<3>(conflictIds),
+                            Return(CSErrorCode::Success)));
+
+        copysetNode->ApplyTask(CHUNK_OP_TYPE::CHUNK_OP_WRITE, 2, normalTask);
+        auto task = std::bind(&CopysetNode::ApplyFromLog,
+                              copysetNode.get(),
+                              opReq,
+                              copysetNode->GetDataStore(),
+                              logRequest,
+                              logData,
+                              11);
+        copysetNode->ApplyTask(logRequest.optype(),
+                               logRequest.chunkid(),
+                               task);
+
+        ASSERT_EQ(1, finishedBeforeBatch);
+        ASSERT_EQ(11, copysetNode->GetAppliedIndex());
+    }
+
+    ChunkRequest deleteRequest;
+    deleteRequest.set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH);
+    deleteRequest.set_logicpoolid(logicPoolID);
+    deleteRequest.set_copysetid(copysetID);
+    deleteRequest.set_chunkid(1);
+    deleteRequest.set_sn(3);
+    deleteRequest.add_deletechunkids(1);
+    deleteRequest.add_deletechunkids(2);
+
+    // 4. 批量删除：leader apply，等之前的op执行完后依次删除每个chunk
+    {
+        finished = 0;
+        ChunkResponse response;
+        FakeClosure done;
+        std::shared_ptr<ChunkOpRequest> opReq =
+            std::make_shared<DeleteChunksRequest>(copysetNode,
+                                                  nullptr,
+                                                  &deleteRequest,
+                                                  &response,
+                                                  nullptr);
+        std::vector<int> finishedBeforeDelete;
+        auto deleteChunk = [&](ChunkID, SequenceNum) {
+            finishedBeforeDelete.push_back(finished.load());
+            return CSErrorCode::Success;
+        };
+        EXPECT_CALL(*dataStore, DeleteChunk(1, 3))
+            .WillOnce(Invoke(deleteChunk));
+        EXPECT_CALL(*dataStore, DeleteChunk(2, 3))
+            .WillOnce(Invoke(deleteChunk));
+
+        copysetNode->ApplyTask(CHUNK_OP_TYPE::CHUNK_OP_WRITE, 2, normalTask);
+        auto task = std::bind(&ChunkOpRequest::OnApply, opReq, 12, &done);
+        copysetNode->ApplyTask(opReq->OpType(), opReq->ChunkId(), task);
+
+        ASSERT_EQ(std::vector<int>({1, 1}), finishedBeforeDelete);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS, response.status());
+        ASSERT_EQ(12, copysetNode->GetAppliedIndex());
+    }
+
+    // 5. 批量删除：follower apply，从日志中解析出op后同样等之前的op执行完
+    {
+        finished = 0;
+        butil::IOBuf log;
+        butil::IOBuf data;
+        ASSERT_EQ(0, ChunkOpRequest::Encode(&deleteRequest, &data, &log));
+        ChunkRequest logRequest;
+        butil::IOBuf logData;
+        auto opReq = ChunkOpRequest::Decode(log, &logRequest, &logData);
+        ASSERT_TRUE(nullptr !=
+            dynamic_cast<DeleteChunksRequest *>(opReq.get()));
+
+        std::vector<int> finishedBeforeDelete;
+        auto deleteChunk = [&](ChunkID, SequenceNum) {
+            finishedBeforeDelete.push_back(finished.load());
+            return CSErrorCode::Success;
+        };
+        EXPECT_CALL(*dataStore, DeleteChunk(1, 3))
+            .WillOnce(Invoke(deleteChunk));
+        EXPECT_CALL(*dataStore, DeleteChunk(2, 3))
+            .WillOnce(Invoke(deleteChunk));
+
+        copysetNode->ApplyTask(CHUNK_OP_TYPE::CHUNK_OP_WRITE, 2, normalTask);
+        auto task = std::bind(&CopysetNode::ApplyFromLog,
+                              copysetNode.get(),
+                              opReq,
+                              copysetNode->GetDataStore(),
+                              logRequest,
+                              logData,
+                              13);
+        copysetNode->ApplyTask(logRequest.optype(),
+                               logRequest.chunkid(),
+                               task);
+
+        ASSERT_EQ(std::vector<int>({1, 1}), finishedBeforeDelete);
+        ASSERT_EQ(13, copysetNode->GetAppliedIndex());
+    }
+}
+
+TEST_F(CopysetNodeTest, follower_applied_index_test) {
+    LogicPoolID logicPoolID = 123;
+    CopysetID copysetID = 1345;
+    Configuration conf;
+    std::shared_ptr<CopysetNode> copysetNode =
+        std::make_shared<CopysetNode>(logicPoolID, copysetID, conf);
+    ASSERT_EQ(0, copysetNode->Init(defaultOptions_));
+    std::shared_ptr<MockDataStore> dataStore =
+        std::make_shared<MockDataStore>();
+    copysetNode->SetCSDateStore(dataStore);
+    ASSERT_EQ(0, copysetNode->GetAppliedIndex());
+
+    // follower从日志中解析出写请求
+    ChunkRequest request;
+    request.set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    request.set_logicpoolid(logicPoolID);
+    request.set_copysetid(copysetID);
+    request.set_chunkid(1);
+    request.set_sn(1);
+    request.set_offset(0);
+    request.set_size(4096);
+    butil::IOBuf log;
+    butil::IOBuf data;
+    data.append(std::string(4096, 'a'));
+    ASSERT_EQ(0, ChunkOpRequest::Encode(&request, &data, &log));
+    ChunkRequest logRequest;
+    butil::IOBuf logData;
+    auto opReq = ChunkOpRequest::Decode(log, &logRequest, &logData);
+    ASSERT_TRUE(nullptr != opReq);
+
+    EXPECT_CALL(*dataStore, WriteChunk(1, 1, Matcher<const butil::IOBuf&>(_),
+                                       0, 4096, _, _))
+        .Times(3)
+        .WillRepeatedly(Return(CSErrorCode::Success));
+
+    // 1. follower apply日志后推进applied index
+    copysetNode->ApplyTask(logRequest.optype(), logRequest.chunkid(),
+        std::bind(&CopysetNode::ApplyFromLog, copysetNode.get(), opReq,
+                  copysetNode->GetDataStore(), logRequest, logData, 5));
+    concurrentModule_.Flush();
+    ASSERT_EQ(5, copysetNode->GetAppliedIndex());
+
+    // 2. 并发apply时较小的index后执行完，applied index不回退
+    copysetNode->ApplyFromLog(opReq, copysetNode->GetDataStore(),
+                              logRequest, logData, 3);
+    ASSERT_EQ(5, copysetNode->GetAppliedIndex());
+
+    // 3. 继续apply更大的index
+    copysetNode->ApplyFromLog(opReq, copysetNode->GetDataStore(),
+                              logRequest, logData, 7);
+    ASSERT_EQ(7, copysetNode->GetAppliedIndex());
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -24,6 +24,7 @@
 #include <gmock/gmock.h>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "include/chunkserver/chunkserver_common.h"
 #include "src/common/bitmap.h"
@@ -2244,6 +2245,140 @@ TEST_F(CSDataStore_test, WriteChunkErrorTest6) {
         .Times(1);
 }
 
+/**
+ * WriteChunkTest
+ * 以IOBuf形式写chunk
+ * case1:chunk存在，且是clone chunk，写入区域之前未写过
+ * 预期结果1:通过Writev写入数据，并更新bitmap
+ * case2:Writev写数据失败(如pwritev返回0)
+ * 预期结果2:返回InternalError，不会更新bitmap
+ * case3:chunk存在，且不是clone chunk
+ * 预期结果3:通过Writev写入数据，不会更新metapage
+ */
+TEST_F(CSDataStore_test, WriteChunkIOBufTest) {
+    // initialize
+    FakeEnv();
+    EXPECT_TRUE(dataStore->Initialize());
+
+    ChunkID id = 3;
+    SequenceNum sn = 1;
+    SequenceNum correctedSn = 0;
+    off_t offset = 0;
+    size_t length = PAGE_SIZE;
+    butil::IOBuf buf;
+    buf.append(std::string(2 * PAGE_SIZE, 'a'));
+    CSChunkInfo info;
+    // 创建 clone chunk
+    {
+        char chunk3MetaPage[PAGE_SIZE];
+        memset(chunk3MetaPage, 0, sizeof(chunk3MetaPage));
+        shared_ptr<Bitmap> bitmap =
+            make_shared<Bitmap>(CHUNK_SIZE / PAGE_SIZE);
+        FakeEncodeChunk(chunk3MetaPage, correctedSn, sn, bitmap, location);
+        // create new chunk and open it
+        string chunk3Path = string(baseDir) + "/" +
+                            FileNameOperator::GenerateChunkFileName(id);
+        // expect call chunkfile pool GetChunk
+        EXPECT_CALL(*lfs_, FileExists(chunk3Path))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*fpool_, GetChunk(chunk3Path, NotNull()))
+            .WillOnce(Return(0));
+        EXPECT_CALL(*lfs_, Open(chunk3Path, _))
+            .Times(1)
+            .WillOnce(Return(4));
+        // will read metapage
+        EXPECT_CALL(*lfs_, Read(4, NotNull(), 0, PAGE_SIZE))
+            .WillOnce(DoAll(SetArrayArgument<1>(chunk3MetaPage,
+                            chunk3MetaPage + PAGE_SIZE),
+                            Return(PAGE_SIZE)));
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore->CreateCloneChunk(id,
+                                              sn,
+                                              correctedSn,
+                                              CHUNK_SIZE,
+                                              location));
+    }
+
+    // case1:chunk存在，且是clone chunk，写入区域之前未写过
+    {
+        id = 3;
+        offset = PAGE_SIZE;
+        length = 2 * PAGE_SIZE;
+        EXPECT_CALL(*lfs_, Writev(4, _, PAGE_SIZE + offset, length))
+            .WillOnce(Return(length));
+        EXPECT_CALL(*lfs_, Write(4, NotNull(), PAGE_SIZE + offset, length))
+            .Times(0);
+        // update metapage
+        EXPECT_CALL(*lfs_, Write(4, NotNull(), 0, PAGE_SIZE))
+            .Times(1);
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore->WriteChunk(id,
+                                        sn,
+                                        buf,
+                                        offset,
+                                        length,
+                                        nullptr));
+        ASSERT_EQ(CSErrorCode::Success, dataStore->GetChunkInfo(id, &info));
+        ASSERT_EQ(true, info.isClone);
+        ASSERT_EQ(1, info.bitmap->NextSetBit(0));
+        ASSERT_EQ(3, info.bitmap->NextClearBit(1));
+        ASSERT_EQ(Bitmap::NO_POS, info.bitmap->NextSetBit(3));
+    }
+
+    // case2:Writev写数据失败
+    {
+        id = 3;
+        offset = 4 * PAGE_SIZE;
+        length = PAGE_SIZE;
+        EXPECT_CALL(*lfs_, Writev(4, _, PAGE_SIZE + offset, length))
+            .WillOnce(Return(-EIO));
+        // update metapage
+        EXPECT_CALL(*lfs_, Write(4, NotNull(), 0, PAGE_SIZE))
+            .Times(0);
+        ASSERT_EQ(CSErrorCode::InternalError,
+                  dataStore->WriteChunk(id,
+                                        sn,
+                                        buf,
+                                        offset,
+                                        length,
+                                        nullptr));
+        ASSERT_EQ(CSErrorCode::Success, dataStore->GetChunkInfo(id, &info));
+        ASSERT_EQ(true, info.isClone);
+        ASSERT_EQ(Bitmap::NO_POS, info.bitmap->NextSetBit(3));
+    }
+
+    // case3:chunk存在，且不是clone chunk
+    {
+        id = 2;
+        sn = 2;
+        offset = 0;
+        length = PAGE_SIZE;
+        EXPECT_CALL(*lfs_, Writev(3, _, PAGE_SIZE + offset, length))
+            .WillOnce(Return(length));
+        EXPECT_CALL(*lfs_, Write(3, NotNull(), 0, PAGE_SIZE))
+            .Times(0);
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore->WriteChunk(id,
+                                        sn,
+                                        buf,
+                                        offset,
+                                        length,
+                                        nullptr));
+        ASSERT_EQ(CSErrorCode::Success, dataStore->GetChunkInfo(id, &info));
+        ASSERT_EQ(2, info.curSn);
+        ASSERT_EQ(false, info.isClone);
+    }
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(4))
+        .Times(1);
+}
+
 /**
  * ReadChunkTest
  * case:chunk不存在
@@ -3634,6 +3769,91 @@ TEST_F(CSDataStore_test, CreateCloneChunkErrorTest) {
         .Times(1);
 }
 
+/**
+ * CreateCloneChunksTest
+ * case1:其中一个chunk的参数不合法
+ * 预期结果1:返回InvalidArgError，不会创建任何chunk
+ * case2:新chunk和已存在且信息不符的chunk一起创建
+ * 预期结果2:返回成功，新chunk创建成功，已存在的chunk记录到conflictIds中
+ */
+TEST_F(CSDataStore_test, CreateCloneChunksTest) {
+    // initialize
+    FakeEnv();
+    EXPECT_TRUE(dataStore->Initialize());
+
+    ChunkID id = 3;
+    SequenceNum sn = 1;
+    SequenceNum correctedSn = 2;
+    CSChunkInfo info;
+    char chunk3MetaPage[PAGE_SIZE];
+    memset(chunk3MetaPage, 0, sizeof(chunk3MetaPage));
+    shared_ptr<Bitmap> bitmap = make_shared<Bitmap>(CHUNK_SIZE / PAGE_SIZE);
+    FakeEncodeChunk(chunk3MetaPage, correctedSn, sn, bitmap, location);
+
+    std::vector<CloneChunkDesc> chunks(2);
+    chunks[0].id = id;
+    chunks[0].sn = sn;
+    chunks[0].location = location;
+    chunks[1].id = 1;
+    chunks[1].sn = 2;
+    chunks[1].location = location;
+    std::vector<ChunkID> conflictIds;
+
+    // case1:其中一个chunk的参数不合法
+    {
+        chunks[1].sn = 0;
+        EXPECT_CALL(*fpool_, GetChunk(_, _))
+            .Times(0);
+        EXPECT_EQ(CSErrorCode::InvalidArgError,
+                  dataStore->CreateCloneChunks(chunks,
+                                               correctedSn,
+                                               CHUNK_SIZE,
+                                               &conflictIds));
+        ASSERT_EQ(CSErrorCode::ChunkNotExistError,
+                  dataStore->GetChunkInfo(id, &info));
+        ASSERT_TRUE(conflictIds.empty());
+        chunks[1].sn = 2;
+    }
+
+    // case2:新chunk和已存在且信息不符的chunk一起创建
+    {
+        string chunk3Path = string(baseDir) + "/" +
+                            FileNameOperator::GenerateChunkFileName(id);
+        EXPECT_CALL(*lfs_, FileExists(chunk3Path))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*fpool_, GetChunk(chunk3Path, NotNull()))
+            .WillOnce(Return(0));
+        EXPECT_CALL(*lfs_, Open(chunk3Path, _))
+            .Times(1)
+            .WillOnce(Return(4));
+        EXPECT_CALL(*lfs_, Read(4, NotNull(), 0, PAGE_SIZE))
+            .WillOnce(DoAll(SetArrayArgument<1>(chunk3MetaPage,
+                            chunk3MetaPage + PAGE_SIZE),
+                            Return(PAGE_SIZE)));
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore->CreateCloneChunks(chunks,
+                                               correctedSn,
+                                               CHUNK_SIZE,
+                                               &conflictIds));
+        ASSERT_EQ(1, conflictIds.size());
+        ASSERT_EQ(1, conflictIds[0]);
+        ASSERT_EQ(CSErrorCode::Success, dataStore->GetChunkInfo(id, &info));
+        ASSERT_EQ(sn, info.curSn);
+        ASSERT_EQ(correctedSn, info.correctedSn);
+        ASSERT_TRUE(info.isClone);
+        ASSERT_STREQ(location, info.location.c_str());
+    }
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(4))
+        .Times(1);
+}
+
 /**
  * PasteChunkTedt
  * case1:chunk 不存在
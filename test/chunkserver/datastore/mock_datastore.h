@@ -25,6 +25,7 @@
 
 #include <gmock/gmock.h>
 #include <string>
+#include <vector>
 
 #include "src/chunkserver/datastore/chunkserver_datastore.h"
 
@@ -56,16 +57,31 @@ class MockDataStore : public CSDataStore {
                                          size_t,
                                          uint32_t*,
                                          const string&));
+    MOCK_METHOD7(WriteChunk, CSErrorCode(ChunkID,
+                                         SequenceNum,
+                                         const butil::IOBuf&,
+                                         off_t,
+                                         size_t,
+                                         uint32_t*,
+                                         const string&));
     MOCK_METHOD5(CreateCloneChunk, CSErrorCode(ChunkID,
                                                SequenceNum,
                                                SequenceNum,
                                                ChunkSizeType,
                                                const string&));
+    MOCK_METHOD4(CreateCloneChunks,
+                 CSErrorCode(const std::vector<CloneChunkDesc>&,
+                             SequenceNum,
+                             ChunkSizeType,
+                             std::vector<ChunkID>*));
     MOCK_METHOD4(PasteChunk, CSErrorCode(ChunkID,
                                          const char*,
                                          off_t,
                                          size_t));
     MOCK_METHOD2(GetChunkInfo, CSErrorCode(ChunkID, CSChunkInfo*));
+    MOCK_METHOD3(GetChunkChangedBlocks, CSErrorCode(ChunkID,
+                                                    SequenceNum,
+                                                    CSChunkChangedBlocks*));
     MOCK_METHOD0(GetStatus, DataStoreStatus());
 };
 
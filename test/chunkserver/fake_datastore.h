@@ -146,6 +146,24 @@ class FakeCSDataStore : public CSDataStore {
         return CSErrorCode::Success;
     }
 
+    CSErrorCode WriteChunk(ChunkID id,
+                           SequenceNum sn,
+                           const butil::IOBuf& buf,
+                           off_t offset,
+                           size_t length,
+                           uint32_t *cost,
+                           const std::string & csl = "") override {
+        CSErrorCode errorCode = HasInjectError();
+        if (errorCode != CSErrorCode::Success) {
+            return errorCode;
+        }
+        buf.copy_to(chunk_+offset, length);
+        *cost = length;
+        chunkIds_.insert(id);
+        sn_ = sn;
+        return CSErrorCode::Success;
+    }
+
     CSErrorCode CreateCloneChunk(ChunkID id,
                                  SequenceNum sn,
                                  SequenceNum correctedSn,
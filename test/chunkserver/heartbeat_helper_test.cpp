@@ -208,6 +208,63 @@ TEST(HeartbeatHelperTest, test_ChunkServerLoadCopySetFin) {
     delete copysetNodeManager;
 }
 
+TEST(HeartbeatHelperTest, test_CopySetInfoChanged) {
+    CopySetInfo last;
+    last.set_logicalpoolid(1);
+    last.set_copysetid(1);
+    last.set_epoch(2);
+    for (int i = 1; i <= 3; i++) {
+        last.add_peers()->set_address(
+            "192.168.10." + std::to_string(i) + ":9000:0");
+    }
+    last.mutable_leaderpeer()->set_address("192.168.10.1:9000:0");
+    CopysetStatistics *stats = last.mutable_stats();
+    stats->set_readrate(100);
+    stats->set_writerate(100);
+    stats->set_readiops(10);
+    stats->set_writeiops(10);
+
+    // 1. 没有变化
+    CopySetInfo cur = last;
+    ASSERT_FALSE(HeartbeatHelper::CopySetInfoChanged(last, cur));
+
+    // 2. io统计变化未超过阈值
+    cur.mutable_stats()->set_readrate(110);
+    ASSERT_FALSE(HeartbeatHelper::CopySetInfoChanged(last, cur));
+
+    // 3. io统计变化超过阈值
+    cur.mutable_stats()->set_writeiops(20);
+    ASSERT_TRUE(HeartbeatHelper::CopySetInfoChanged(last, cur));
+
+    // 4. epoch变化
+    cur = last;
+    cur.set_epoch(3);
+    ASSERT_TRUE(HeartbeatHelper::CopySetInfoChanged(last, cur));
+
+    // 5. leader变化
+    cur = last;
+    cur.mutable_leaderpeer()->set_address("192.168.10.2:9000:0");
+    ASSERT_TRUE(HeartbeatHelper::CopySetInfoChanged(last, cur));
+
+    // 6. 成员变化
+    cur = last;
+    cur.mutable_peers(2)->set_address("192.168.10.4:9000:0");
+    ASSERT_TRUE(HeartbeatHelper::CopySetInfoChanged(last, cur));
+
+    // 7. 有正在进行的配置变更
+    cur = last;
+    cur.mutable_configchangeinfo()->mutable_peer()->set_address(
+        "192.168.10.4:9000:0");
+    cur.mutable_configchangeinfo()->set_type(
+        curve::mds::heartbeat::ADD_PEER);
+    cur.mutable_configchangeinfo()->set_finished(false);
+    ASSERT_TRUE(HeartbeatHelper::CopySetInfoChanged(last, cur));
+
+    // 8. 统计信息缺失
+    cur = last;
+    cur.clear_stats();
+    ASSERT_TRUE(HeartbeatHelper::CopySetInfoChanged(last, cur));
+}
 }  // namespace chunkserver
 }  // namespace curve
 
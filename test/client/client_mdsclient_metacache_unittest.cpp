@@ -33,6 +33,7 @@
 #include <thread>   //NOLINT
 #include <chrono>   //NOLINT
 #include <vector>
+#include <set>
 #include <algorithm>
 
 #include "src/client/client_common.h"
@@ -49,6 +50,7 @@
 #include "test/client/fake/fakeMDS.h"
 #include "src/client/metacache_struct.h"
 #include "src/common/net_common.h"
+#include "src/common/timeutility.h"
 #include "test/integration/cluster_common/cluster.h"
 #include "test/util/config_generator.h"
 #include "test/client/mock_curvefs_service.h"
@@ -1829,6 +1831,85 @@ TEST_F(MDSClientTest, ListDir) {
     delete fakeret2;
 }
 
+TEST(MetaCacheFollowerReadTest, GetFollowerReadPeerTest) {
+    curve::client::MetaCache mc;
+    MetaCacheOption mcOpt;
+    mc.Init(mcOpt, nullptr);
+
+    curve::client::CopysetInfo_t cslist;
+    curve::client::ChunkServerAddr addr;
+    addr.Parse("10.182.26.1:9120:0");
+    cslist.AddCopysetPeerInfo(curve::client::CopysetPeerInfo(1, addr, addr));
+    addr.Parse("10.182.26.2:9120:0");
+    cslist.AddCopysetPeerInfo(curve::client::CopysetPeerInfo(2, addr, addr));
+    addr.Parse("10.182.26.3:9120:0");
+    cslist.AddCopysetPeerInfo(curve::client::CopysetPeerInfo(3, addr, addr));
+
+    butil::ip_t localIp;
+    butil::str2ip("10.182.26.2", &localIp);
+    butil::ip_t remoteIp;
+    butil::str2ip("10.182.26.100", &remoteIp);
+
+    curve::client::ChunkServerID csid;
+    curve::client::EndPoint ep;
+    bool isLeader = false;
+
+    // 1. copyset不存在或leader信息未确定，返回-1
+    ASSERT_EQ(-1, mc.GetFollowerReadPeer(1, 1, localIp, &csid, &ep,
+                                         &isLeader));
+    mc.UpdateCopysetInfo(1, 1, cslist);
+    ASSERT_EQ(-1, mc.GetFollowerReadPeer(1, 1, localIp, &csid, &ep,
+                                         &isLeader));
+
+    cslist.UpdateLeaderIndex(0);
+    mc.UpdateCopysetInfo(1, 1, cslist);
+
+    // 2. 优先选择同机副本
+    ASSERT_EQ(0, mc.GetFollowerReadPeer(1, 1, localIp, &csid, &ep,
+                                        &isLeader));
+    ASSERT_EQ(2, csid);
+    ASSERT_FALSE(isLeader);
+    ASSERT_EQ(localIp, ep.ip);
+
+    // 3. 没有同机副本时在各副本间轮询
+    std::set<curve::client::ChunkServerID> selected;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(0, mc.GetFollowerReadPeer(1, 1, remoteIp, &csid, &ep,
+                                            &isLeader));
+        selected.insert(csid);
+    }
+    ASSERT_EQ(3, selected.size());
+
+    // 4. 同机副本落后之后，不再选择该副本
+    uint64_t nowMs = curve::common::TimeUtility::GetTimeofDayMs();
+    mc.SetFollowerLagging(1, 1, 2, nowMs + 100000);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(0, mc.GetFollowerReadPeer(1, 1, localIp, &csid, &ep,
+                                            &isLeader));
+        ASSERT_NE(2, csid);
+    }
+
+    // 5. 所有副本都落后时，返回leader
+    mc.SetFollowerLagging(1, 1, 1, nowMs + 100000);
+    mc.SetFollowerLagging(1, 1, 3, nowMs + 100000);
+    ASSERT_EQ(0, mc.GetFollowerReadPeer(1, 1, remoteIp, &csid, &ep,
+                                        &isLeader));
+    ASSERT_EQ(1, csid);
+    ASSERT_TRUE(isLeader);
+
+    // 6. 落后标记过期之后，可以重新选择该副本
+    mc.SetFollowerLagging(1, 1, 2, nowMs - 1);
+    ASSERT_EQ(0, mc.GetFollowerReadPeer(1, 1, localIp, &csid, &ep,
+                                        &isLeader));
+    ASSERT_EQ(2, csid);
+
+    // 7. leader可能变更时，返回-1由外部刷新leader
+    cslist.SetLeaderUnstableFlag();
+    mc.UpdateCopysetInfo(1, 1, cslist);
+    ASSERT_EQ(-1, mc.GetFollowerReadPeer(1, 1, localIp, &csid, &ep,
+                                         &isLeader));
+}
+
 TEST(LibcurveInterface, InvokeWithOutInit) {
     CurveAioContext aioctx;
     UserInfo_t      userinfo;
@@ -2246,6 +2327,14 @@ static void MockRefreshSession(::google::protobuf::RpcController* controller,
     response->set_sessionid("");
 }
 
+static void MockRefreshSessionBatch(
+    ::google::protobuf::RpcController* controller,
+    const curve::mds::RefreshSessionBatchRequest* request,
+    curve::mds::RefreshSessionBatchResponse* response,
+    ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard guard(done);
+}
+
 class MDSClientRefreshSessionTest : public ::testing::Test {
  public:
     void SetUp() override {
@@ -2323,5 +2412,86 @@ TEST_F(MDSClientRefreshSessionTest, NoStartDummyServerTest) {
     ASSERT_FALSE(request.has_clientip());
 }
 
+TEST_F(MDSClientRefreshSessionTest, RefreshSessionBatchTest) {
+    curve::client::ClientDummyServerInfo::GetInstance().SetRegister(false);
+
+    MDSClient mdsClient;
+    MetaServerOption opt;
+    opt.metaaddrvec.push_back(kServerAddress);
+    ASSERT_EQ(0, mdsClient.Initialize(opt));
+
+    UserInfo userInfo;
+    userInfo.owner = "test";
+    std::vector<RefreshSessionContext> sessions(3);
+    for (int i = 0; i < 3; ++i) {
+        sessions[i].filename = "/filename" + std::to_string(i);
+        sessions[i].userinfo = userInfo;
+        sessions[i].sessionid = "session" + std::to_string(i);
+    }
+
+    // 1. 每个文件的结果单独返回
+    {
+        curve::mds::RefreshSessionBatchRequest request;
+        curve::mds::RefreshSessionBatchResponse response;
+        response.set_statuscode(curve::mds::StatusCode::kOK);
+        auto resp = response.add_responses();
+        resp->set_statuscode(curve::mds::StatusCode::kOK);
+        resp->set_sessionid("session0");
+        curve::mds::FileInfo* fileInfo = new curve::mds::FileInfo();
+        fileInfo->set_seqnum(2);
+        resp->set_allocated_fileinfo(fileInfo);
+        resp = response.add_responses();
+        resp->set_statuscode(curve::mds::StatusCode::kSessionNotExist);
+        resp->set_sessionid("session1");
+        resp = response.add_responses();
+        resp->set_statuscode(curve::mds::StatusCode::kOwnerAuthFail);
+        resp->set_sessionid("session2");
+
+        EXPECT_CALL(curveFsService_, RefreshSessionBatch(_, _, _, _))
+            .WillOnce(DoAll(SaveArgPointee<1>(&request),
+                            SetArgPointee<2>(response),
+                            Invoke(MockRefreshSessionBatch)));
+
+        std::vector<LIBCURVE_ERROR> rets;
+        std::vector<LeaseRefreshResult> results;
+        ASSERT_EQ(LIBCURVE_ERROR::OK,
+                  mdsClient.RefreshSessionBatch(sessions, &rets, &results));
+
+        ASSERT_EQ(3, request.requests_size());
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_EQ(sessions[i].filename, request.requests(i).filename());
+            ASSERT_EQ(sessions[i].sessionid, request.requests(i).sessionid());
+            ASSERT_EQ("test", request.requests(i).owner());
+        }
+
+        ASSERT_EQ(3, rets.size());
+        ASSERT_EQ(3, results.size());
+        ASSERT_EQ(LIBCURVE_ERROR::OK, rets[0]);
+        ASSERT_EQ(LeaseRefreshResult::Status::OK, results[0].status);
+        ASSERT_EQ(2, results[0].finfo.seqnum);
+        ASSERT_EQ(LIBCURVE_ERROR::OK, rets[1]);
+        ASSERT_EQ(LeaseRefreshResult::Status::NOT_EXIST, results[1].status);
+        ASSERT_EQ(LIBCURVE_ERROR::AUTHFAIL, rets[2]);
+        ASSERT_EQ(LeaseRefreshResult::Status::FAILED, results[2].status);
+    }
+
+    // 2. 返回的结果数量与请求不一致
+    {
+        curve::mds::RefreshSessionBatchResponse response;
+        response.set_statuscode(curve::mds::StatusCode::kOK);
+        response.add_responses()->set_statuscode(
+            curve::mds::StatusCode::kOK);
+
+        EXPECT_CALL(curveFsService_, RefreshSessionBatch(_, _, _, _))
+            .WillOnce(DoAll(SetArgPointee<2>(response),
+                            Invoke(MockRefreshSessionBatch)));
+
+        std::vector<LIBCURVE_ERROR> rets;
+        std::vector<LeaseRefreshResult> results;
+        ASSERT_EQ(LIBCURVE_ERROR::FAILED,
+                  mdsClient.RefreshSessionBatch(sessions, &rets, &results));
+    }
+}
+
 }  // namespace client
 }  // namespace curve
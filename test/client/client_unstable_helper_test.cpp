@@ -25,8 +25,12 @@
 #include <gflags/gflags.h>
 #include <butil/endpoint.h>
 #include <utility>
+#include <memory>
+#include <thread>  // NOLINT
+#include <chrono>  // NOLINT
 
 #include "src/client/chunk_closure.h"
+#include "src/client/metacache.h"
 
 namespace curve {
 namespace client {
@@ -117,5 +121,90 @@ TEST(UnstableHelperTest, normal_test) {
                       chunkserver5.first, chunkserver5.second));
 }
 
+TEST(UnstableHelperTest, read_latency_test) {
+    UnstableHelper& helper = UnstableHelper::GetInstance();
+    helper.ResetState();
+
+    // 没有统计数据时返回0
+    ASSERT_EQ(0, helper.GetReadLatencyPercentile(1, 0.99));
+
+    for (int i = 0; i < 1000; ++i) {
+        helper.RecordReadLatency(1, 1000);
+    }
+
+    // 分位值由bvar的采样线程计算，等待采样完成
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    uint64_t latency = helper.GetReadLatencyPercentile(1, 0.99);
+    ASSERT_GT(latency, 0);
+    ASSERT_LE(latency, 2000);
+    ASSERT_EQ(0, helper.GetReadLatencyPercentile(2, 0.99));
+
+    helper.ResetState();
+    ASSERT_EQ(0, helper.GetReadLatencyPercentile(1, 0.99));
+}
+
+TEST(UnstableHelperTest, remove_read_latency_test) {
+    UnstableHelper& helper = UnstableHelper::GetInstance();
+    helper.ResetState();
+
+    // copyset 1的副本在chunkserver 1和2上
+    MetaCache metaCache;
+    CopysetInfo_t cpinfo;
+    cpinfo.cpid_ = 1;
+    cpinfo.csinfos_.push_back(
+        CopysetPeerInfo_t(1, ChunkServerAddr(), ChunkServerAddr()));
+    cpinfo.csinfos_.push_back(
+        CopysetPeerInfo_t(2, ChunkServerAddr(), ChunkServerAddr()));
+    metaCache.UpdateCopysetInfo(1, 1, cpinfo);
+    metaCache.AddCopysetIDInfo(1, CopysetIDInfo(1, 1));
+    metaCache.AddCopysetIDInfo(2, CopysetIDInfo(1, 1));
+
+    for (int i = 0; i < 1000; ++i) {
+        helper.RecordReadLatency(1, 1000);
+        helper.RecordReadLatency(2, 1000);
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    ASSERT_GT(helper.GetReadLatencyPercentile(1, 0.99), 0);
+    ASSERT_GT(helper.GetReadLatencyPercentile(2, 0.99), 0);
+
+    // chunkserver 1被替换为3，缓存中已经没有它的copyset，删除时延统计
+    CopysetInfo_t newInfo;
+    newInfo.cpid_ = 1;
+    newInfo.csinfos_.push_back(
+        CopysetPeerInfo_t(2, ChunkServerAddr(), ChunkServerAddr()));
+    newInfo.csinfos_.push_back(
+        CopysetPeerInfo_t(3, ChunkServerAddr(), ChunkServerAddr()));
+    metaCache.UpdateChunkserverCopysetInfo(1, newInfo);
+    ASSERT_EQ(0, helper.GetReadLatencyPercentile(1, 0.99));
+    ASSERT_GT(helper.GetReadLatencyPercentile(2, 0.99), 0);
+
+    // 直接删除
+    helper.RemoveReadLatency(2);
+    ASSERT_EQ(0, helper.GetReadLatencyPercentile(2, 0.99));
+    helper.ResetState();
+}
+
+TEST(HedgedReadStateTest, try_finish_test) {
+    ChunkIDInfo idinfo(1, 2, 3);
+
+    // 只有第一个请求能够接管done
+    auto state = std::make_shared<HedgedReadState>(
+        nullptr, nullptr, idinfo, 0, 4096, 1);
+    ASSERT_TRUE(state->TryFinish());
+    ASSERT_FALSE(state->TryFinish());
+
+    // 请求结束之后不再启动定时任务
+    HedgedReadState::ArmTimer(state, 1, 0);
+    ASSERT_EQ(1, state.use_count());
+
+    // 请求在定时任务执行之前结束，定时任务被取消并释放其持有的引用
+    state = std::make_shared<HedgedReadState>(
+        nullptr, nullptr, idinfo, 0, 4096, 1);
+    HedgedReadState::ArmTimer(state, 1, 10 * 1000 * 1000);
+    ASSERT_EQ(2, state.use_count());
+    ASSERT_TRUE(state->TryFinish());
+    ASSERT_EQ(1, state.use_count());
+}
+
 }  // namespace client
 }  // namespace curve
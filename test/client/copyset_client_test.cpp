@@ -26,6 +26,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <atomic>
 #include <thread>   //NOLINT
 #include <chrono>   // NOLINT
 
@@ -3902,6 +3903,173 @@ TEST_F(CopysetClientTest, retry_rpc_sleep_test) {
     scheduler.Fini();
 }
 
+class HedgedReadRequestClosure : public FakeRequestClosure {
+ public:
+    HedgedReadRequestClosure(curve::common::CountDownEvent *cond,
+                             RequestContext *reqctx)
+        : FakeRequestClosure(cond, reqctx), runCount_(0) {}
+
+    void Run() override {
+        runCount_.fetch_add(1);
+        FakeRequestClosure::Run();
+    }
+
+    int GetRunCount() const {
+        return runCount_.load();
+    }
+
+ private:
+    std::atomic<int> runCount_;
+};
+
+static void SlowReadChunkFunc(::google::protobuf::RpcController *controller,
+                              const ::curve::chunkserver::ChunkRequest *request,    //NOLINT
+                              ::curve::chunkserver::ChunkResponse *response,
+                              google::protobuf::Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+    bthread_usleep(1000 * 1000);
+}
+
+TEST_F(CopysetClientTest, hedged_read_test) {
+    MockChunkServiceImpl mockChunkService;
+    ASSERT_EQ(server_->AddService(&mockChunkService,
+                                  brpc::SERVER_DOESNT_OWN_SERVICE), 0);
+    ASSERT_EQ(server_->Start(listenAddr_.c_str(), nullptr), 0);
+
+    IOSenderOption_t ioSenderOpt;
+    ioSenderOpt.failRequestOpt.chunkserverRPCTimeoutMS = 3000;
+    ioSenderOpt.failRequestOpt.chunkserverOPMaxRetry = 3;
+    ioSenderOpt.failRequestOpt.chunkserverOPRetryIntervalUS = 500;
+    ioSenderOpt.failRequestOpt.chunkserverMaxRPCTimeoutMS = 3500;
+    ioSenderOpt.failRequestOpt.chunkserverMaxRetrySleepIntervalUS = 3500000;
+    ioSenderOpt.chunkserverEnableAppliedIndexRead = 1;
+    ioSenderOpt.hedgedReadOpt.enableHedgedRead = true;
+
+    RequestScheduleOption_t reqopt;
+    reqopt.ioSenderOpt = ioSenderOpt;
+
+    MockMetaCache mockMetaCache;
+    mockMetaCache.DelegateToFake();
+
+    RequestScheduler scheduler;
+    scheduler.Init(reqopt, &mockMetaCache);
+    scheduler.Run();
+
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 100001;
+    ChunkID chunkId = 1;
+    uint64_t sn = 1;
+    uint64_t appliedindex = 10;
+    size_t len = 8;
+    char buff[8 + 1];
+    memset(buff, 'a', 8);
+    buff[8] = '\0';
+    off_t offset = 0;
+
+    // hedge请求发往另一个副本，这里与leader使用同一个server
+    ChunkServerID hedgeId = 10001;
+    butil::EndPoint hedgeAddr;
+    butil::str2endpoint(listenAddr_.c_str(), &hedgeAddr);
+
+    ChunkResponse response;
+    response.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+    response.set_appliedindex(appliedindex);
+    gReadCntlFailedCode = 0;
+
+    /* 原始请求较慢，hedge请求先返回，原始请求的结果被丢弃 */
+    {
+        ioSenderOpt.hedgedReadOpt.minDelayUS = 100 * 1000;
+        ioSenderOpt.hedgedReadOpt.maxDelayUS = 100 * 1000;
+        FileMetric fm("hedged_read_test_1");
+        IOTracker iot(nullptr, nullptr, nullptr, &fm);
+        CopysetClient copysetClient;
+        copysetClient.Init(&mockMetaCache, ioSenderOpt, &scheduler, &fm);
+
+        RequestContext *reqCtx = new FakeRequestContext();
+        reqCtx->optype_ = OpType::READ;
+        reqCtx->idinfo_ = ChunkIDInfo(chunkId, logicPoolId, copysetId);
+        reqCtx->readBuffer_ = buff;
+        reqCtx->offset_ = offset;
+        reqCtx->rawlength_ = len;
+
+        curve::common::CountDownEvent cond(1);
+        HedgedReadRequestClosure *reqDone =
+            new HedgedReadRequestClosure(&cond, reqCtx);
+        reqDone->SetFileMetric(&fm);
+        reqDone->SetIOTracker(&iot);
+        reqCtx->done_ = reqDone;
+
+        EXPECT_CALL(mockMetaCache, GetFollowerReadPeer(logicPoolId, copysetId,
+                                                       _, _, _, _, 10000))
+            .Times(1)
+            .WillOnce(DoAll(SetArgPointee<3>(hedgeId),
+                            SetArgPointee<4>(hedgeAddr),
+                            SetArgPointee<5>(false),
+                            Return(0)));
+        EXPECT_CALL(mockChunkService, ReadChunk(_, _, _, _)).Times(2)
+            .WillOnce(DoAll(SetArgPointee<2>(response),
+                            Invoke(SlowReadChunkFunc)))
+            .WillOnce(DoAll(SetArgPointee<2>(response),
+                            Invoke(ReadChunkFunc)));
+
+        uint64_t startUs = TimeUtility::GetTimeofDayUs();
+        copysetClient.ReadChunk(reqCtx->idinfo_, sn, offset, len,
+                                appliedindex, {}, reqDone);
+        cond.Wait();
+        uint64_t endUs = TimeUtility::GetTimeofDayUs();
+        ASSERT_EQ(0, reqDone->GetErrorCode());
+        ASSERT_LT(endUs - startUs, 1000 * 1000);
+        ASSERT_EQ(1, fm.hedgedReadQPS.count.get_value());
+        ASSERT_EQ(1, fm.hedgedReadWinQPS.count.get_value());
+
+        // 等待原始请求返回，其结果被丢弃，不会再回调上层
+        std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+        ASSERT_EQ(1, reqDone->GetRunCount());
+    }
+
+    /* 原始请求在等待时间内返回，hedge请求被取消，不会发送 */
+    {
+        ioSenderOpt.hedgedReadOpt.minDelayUS = 300 * 1000;
+        ioSenderOpt.hedgedReadOpt.maxDelayUS = 300 * 1000;
+        FileMetric fm("hedged_read_test_2");
+        IOTracker iot(nullptr, nullptr, nullptr, &fm);
+        CopysetClient copysetClient;
+        copysetClient.Init(&mockMetaCache, ioSenderOpt, &scheduler, &fm);
+
+        RequestContext *reqCtx = new FakeRequestContext();
+        reqCtx->optype_ = OpType::READ;
+        reqCtx->idinfo_ = ChunkIDInfo(chunkId, logicPoolId, copysetId);
+        reqCtx->readBuffer_ = buff;
+        reqCtx->offset_ = offset;
+        reqCtx->rawlength_ = len;
+
+        curve::common::CountDownEvent cond(1);
+        HedgedReadRequestClosure *reqDone =
+            new HedgedReadRequestClosure(&cond, reqCtx);
+        reqDone->SetFileMetric(&fm);
+        reqDone->SetIOTracker(&iot);
+        reqCtx->done_ = reqDone;
+
+        EXPECT_CALL(mockMetaCache, GetFollowerReadPeer(_, _, _, _, _, _, _))
+            .Times(0);
+        EXPECT_CALL(mockChunkService, ReadChunk(_, _, _, _)).Times(1)
+            .WillOnce(DoAll(SetArgPointee<2>(response),
+                            Invoke(ReadChunkFunc)));
+
+        copysetClient.ReadChunk(reqCtx->idinfo_, sn, offset, len,
+                                appliedindex, {}, reqDone);
+        cond.Wait();
+        ASSERT_EQ(0, reqDone->GetErrorCode());
+
+        // 超过等待时间之后也不会再发送hedge请求
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+        ASSERT_EQ(1, reqDone->GetRunCount());
+        ASSERT_EQ(0, fm.hedgedReadQPS.count.get_value());
+        ASSERT_EQ(0, fm.hedgedReadWinQPS.count.get_value());
+    }
+    scheduler.Fini();
+}
+
 class TestRunnedRequestClosure : public RequestClosure {
  public:
     TestRunnedRequestClosure() : RequestClosure(nullptr) {}
@@ -810,6 +810,60 @@ TEST_F(IOTrackerSplitorTest, largeIOTest) {
     delete[] buf;
 }
 
+TEST_F(IOTrackerSplitorTest, largeIOFastPathTest) {
+    curve::client::IOSplitOPtion_t splitOpt;
+    splitOpt.fileIOSplitMaxSizeKB = 64;
+    splitOpt.enableLargeIOFastPath = true;
+    Splitor::Init(splitOpt);
+
+    MockRequestScheduler mockschuler;
+    mockschuler.DelegateToFake();
+    /**
+     * io across two chunks will be split into two requests, one per chunk
+     */
+    uint64_t length = 2 * 1024 * 1024;
+    uint64_t offset = 4 * 1024 * 1024 - 1024 * 1024;
+    char* buf = new char[length];
+
+    FInfo_t fi;
+    fi.seqnum = 0;
+    fi.chunksize = 4 * 1024 * 1024;
+    fi.segmentsize = 1 * 1024 * 1024 * 1024ul;
+    curve::client::IOManager4File* iomana = fileinstance_->GetIOManager4File();
+    MetaCache* mc = fileinstance_->GetIOManager4File()->GetMetaCache();
+
+    IOTracker* iotracker = new IOTracker(iomana, mc, &mockschuler);
+
+    mc->UpdateChunkInfoByIndex(0, ChunkIDInfo(1, 2, 3));
+    mc->UpdateChunkInfoByIndex(1, ChunkIDInfo(4, 2, 3));
+
+    std::list<RequestContext*> reqlist;
+    ASSERT_EQ(0, curve::client::Splitor::IO2ChunkRequests(iotracker, mc,
+                                                            &reqlist,
+                                                            buf,
+                                                            offset,
+                                                            length,
+                                                            &mdsclient_,
+                                                            &fi));
+    ASSERT_EQ(2, reqlist.size());
+
+    RequestContext* first = reqlist.front();
+    reqlist.pop_front();
+    RequestContext* second = reqlist.front();
+    reqlist.pop_front();
+
+    ASSERT_EQ(1, first->idinfo_.cid_);
+    ASSERT_EQ(3 * 1024 * 1024, first->offset_);
+    ASSERT_EQ(1024 * 1024, first->rawlength_);
+    ASSERT_EQ(4, second->idinfo_.cid_);
+    ASSERT_EQ(0, second->offset_);
+    ASSERT_EQ(1024 * 1024, second->rawlength_);
+
+    splitOpt.enableLargeIOFastPath = false;
+    Splitor::Init(splitOpt);
+    delete[] buf;
+}
+
 TEST_F(IOTrackerSplitorTest, InvalidParam) {
     uint64_t length = 2 * 64 * 1024;
     uint64_t offset = 4 * 1024 * 1024 - length;
@@ -32,6 +32,9 @@
 #include "src/client/libcurve_file.h"
 #include "src/client/mds_client.h"
 
+using curve::common::ThrottleParams;
+using curve::common::ThrottleType;
+
 namespace curve {
 namespace client {
 
@@ -63,5 +66,43 @@ TEST(LeaseExecutorBaseTest, test_StartFailed) {
     }
 }
 
+TEST(LeaseExecutorBaseTest, test_ResetThrottleParams) {
+    IOManager4File io4File;
+    IOOption ioOption;
+    ioOption.throttleOpt.readIOPS = 100;
+    ASSERT_TRUE(io4File.Initialize("/test_ResetThrottleParams",
+                                   ioOption, nullptr));
+    auto* throttle = io4File.GetThrottle();
+    ASSERT_EQ(100, throttle->GetThrottleParams(ThrottleType::IOPS_READ).limit);
+
+    UserInfo_t userInfo;
+    MDSClient mdsClient;
+    LeaseOption leaseOpt;
+    LeaseExecutor leaseExecutor(leaseOpt, userInfo, &mdsClient, &io4File);
+
+    // 续约时更新mds下发的限制
+    LeaseRefreshResult response;
+    response.status = LeaseRefreshResult::Status::OK;
+    response.finfo.seqnum = 1;
+    response.finfo.throttleParams[ThrottleType::IOPS_READ] =
+        ThrottleParams(200, 0);
+    response.finfo.throttleParams[ThrottleType::BPS_WRITE] =
+        ThrottleParams(4096, 0);
+    ASSERT_TRUE(leaseExecutor.HandleRefreshResult(LIBCURVE_ERROR::OK,
+                                                  response));
+    ASSERT_EQ(200, throttle->GetThrottleParams(ThrottleType::IOPS_READ).limit);
+    ASSERT_EQ(4096,
+              throttle->GetThrottleParams(ThrottleType::BPS_WRITE).limit);
+
+    // mds不再下发限制时恢复为配置的限制
+    response.finfo.throttleParams.clear();
+    ASSERT_TRUE(leaseExecutor.HandleRefreshResult(LIBCURVE_ERROR::OK,
+                                                  response));
+    ASSERT_EQ(100, throttle->GetThrottleParams(ThrottleType::IOPS_READ).limit);
+    ASSERT_EQ(0, throttle->GetThrottleParams(ThrottleType::BPS_WRITE).limit);
+
+    io4File.UnInitialize();
+}
+
 }  // namespace client
 }  // namespace curve
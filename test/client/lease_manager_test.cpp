@@ -0,0 +1,345 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/client/iomanager4file.h"
+#include "src/client/lease_executor.h"
+#include "src/client/lease_manager.h"
+#include "src/common/timeutility.h"
+#include "test/client/mock_mds_client.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+using curve::common::TimeUtility;
+
+namespace curve {
+namespace client {
+
+// 测试中executor只由LeaseRefreshGroup续约，lease足够长，不会自行续约
+const uint64_t kLongLeaseUs = 100 * 1000 * 1000;
+const uint64_t kMsToUs = 1000;
+
+LIBCURVE_ERROR BatchRefreshOK(
+    const std::vector<RefreshSessionContext>& sessions,
+    std::vector<LIBCURVE_ERROR>* rets,
+    std::vector<LeaseRefreshResult>* resps) {
+    LeaseRefreshResult result;
+    result.status = LeaseRefreshResult::Status::OK;
+    result.finfo.seqnum = 1;
+    rets->assign(sessions.size(), LIBCURVE_ERROR::OK);
+    resps->assign(sessions.size(), result);
+    return LIBCURVE_ERROR::OK;
+}
+
+class LeaseManagerTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        IOOption ioOption;
+        ASSERT_TRUE(iomanager_.Initialize("/lease_manager_test",
+                                          ioOption, nullptr));
+    }
+
+    void TearDown() override {
+        executors_.clear();
+        iomanager_.UnInitialize();
+    }
+
+    LeaseExecutor* CreateExecutor(const std::string& filename) {
+        LeaseOption leaseOpt;
+        leaseOpt.enableBatchRefresh = true;
+        std::unique_ptr<LeaseExecutor> executor(new LeaseExecutor(
+            leaseOpt, UserInfo_t(), &mdsclient_, &iomanager_));
+
+        // Start设置文件信息，之后从LeaseManager中取消注册，
+        // 由测试中创建的LeaseRefreshGroup续约
+        FInfo fi;
+        fi.fullPathName = filename;
+        LeaseSession lease;
+        lease.sessionID = filename;
+        lease.leaseTime = kLongLeaseUs;
+        EXPECT_TRUE(executor->Start(fi, lease));
+        executor->Stop();
+
+        executors_.emplace_back(std::move(executor));
+        return executors_.back().get();
+    }
+
+    // 记录每次批量续约的文件
+    void RecordBatch(const std::vector<RefreshSessionContext>& sessions) {
+        std::vector<std::string> files;
+        for (const auto& session : sessions) {
+            files.push_back(session.filename);
+        }
+        std::lock_guard<std::mutex> lk(batchMtx_);
+        batches_.push_back(files);
+    }
+
+    std::vector<std::vector<std::string>> GetBatches() {
+        std::lock_guard<std::mutex> lk(batchMtx_);
+        return batches_;
+    }
+
+    MockMDSClient mdsclient_;
+    IOManager4File iomanager_;
+    std::vector<std::unique_ptr<LeaseExecutor>> executors_;
+
+    std::mutex batchMtx_;
+    std::vector<std::vector<std::string>> batches_;
+};
+
+TEST_F(LeaseManagerTest, BatchSizeTest) {
+    EXPECT_CALL(mdsclient_, RefreshSessionBatch(_, _, _))
+        .WillRepeatedly(Invoke(
+            [this](const std::vector<RefreshSessionContext>& sessions,
+                   std::vector<LIBCURVE_ERROR>* rets,
+                   std::vector<LeaseRefreshResult>* resps) {
+                RecordBatch(sessions);
+                return BatchRefreshOK(sessions, rets, resps);
+            }));
+
+    // 同时到期的5个文件按照每批2个分成3次续约
+    LeaseRefreshGroup group(&mdsclient_, 2);
+    for (int i = 0; i < 5; ++i) {
+        group.Add(CreateExecutor("/file" + std::to_string(i)),
+                  100 * kMsToUs);
+    }
+    group.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    group.Stop();
+
+    auto batches = GetBatches();
+    ASSERT_EQ(3, batches.size());
+    ASSERT_EQ(2, batches[0].size());
+    ASSERT_EQ(2, batches[1].size());
+    ASSERT_EQ(1, batches[2].size());
+    std::set<std::string> files;
+    for (const auto& batch : batches) {
+        files.insert(batch.begin(), batch.end());
+    }
+    ASSERT_EQ(5, files.size());
+    ASSERT_EQ(5, group.Size());
+}
+
+TEST_F(LeaseManagerTest, CollectDueExecutorsTest) {
+    EXPECT_CALL(mdsclient_, RefreshSessionBatch(_, _, _))
+        .WillRepeatedly(Invoke(
+            [this](const std::vector<RefreshSessionContext>& sessions,
+                   std::vector<LIBCURVE_ERROR>* rets,
+                   std::vector<LeaseRefreshResult>* resps) {
+                RecordBatch(sessions);
+                return BatchRefreshOK(sessions, rets, resps);
+            }));
+
+    LeaseRefreshGroup group(&mdsclient_, 10);
+    group.Start();
+    group.Add(CreateExecutor("/fileA"), 100 * kMsToUs);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    // fileC在半个周期内到期，和fileA一起续约；fileB的周期较长，不续约
+    group.Add(CreateExecutor("/fileC"), 100 * kMsToUs);
+    group.Add(CreateExecutor("/fileB"), 1000 * kMsToUs);
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    group.Stop();
+
+    auto batches = GetBatches();
+    ASSERT_EQ(1, batches.size());
+    std::set<std::string> files(batches[0].begin(), batches[0].end());
+    ASSERT_EQ(std::set<std::string>({"/fileA", "/fileC"}), files);
+}
+
+TEST_F(LeaseManagerTest, RemoveStoppedExecutorTest) {
+    // /stop对应的文件已经不存在，不再续约
+    EXPECT_CALL(mdsclient_, RefreshSessionBatch(_, _, _))
+        .WillRepeatedly(Invoke(
+            [this](const std::vector<RefreshSessionContext>& sessions,
+                   std::vector<LIBCURVE_ERROR>* rets,
+                   std::vector<LeaseRefreshResult>* resps) {
+                RecordBatch(sessions);
+                BatchRefreshOK(sessions, rets, resps);
+                for (size_t i = 0; i < sessions.size(); ++i) {
+                    if (sessions[i].filename == "/stop") {
+                        (*resps)[i].status =
+                            LeaseRefreshResult::Status::NOT_EXIST;
+                    }
+                }
+                return LIBCURVE_ERROR::OK;
+            }));
+
+    LeaseRefreshGroup group(&mdsclient_, 10);
+    LeaseExecutor* stopped = CreateExecutor("/stop");
+    LeaseExecutor* normal = CreateExecutor("/normal");
+    group.Add(stopped, 50 * kMsToUs);
+    group.Add(normal, 50 * kMsToUs);
+    group.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(130));
+    group.Stop();
+
+    ASSERT_EQ(1, group.Size());
+    ASSERT_FALSE(stopped->LeaseValid());
+    ASSERT_TRUE(normal->LeaseValid());
+    auto batches = GetBatches();
+    ASSERT_EQ(2, batches.size());
+    ASSERT_EQ(2, batches[0].size());
+    ASSERT_EQ(std::vector<std::string>({"/normal"}), batches[1]);
+}
+
+TEST_F(LeaseManagerTest, BatchRefreshFailedTest) {
+    // rpc失败时保留所有文件，下个周期继续续约
+    std::atomic<int> calls(0);
+    EXPECT_CALL(mdsclient_, RefreshSessionBatch(_, _, _))
+        .WillRepeatedly(Invoke(
+            [&calls](const std::vector<RefreshSessionContext>& sessions,
+                     std::vector<LIBCURVE_ERROR>* rets,
+                     std::vector<LeaseRefreshResult>* resps) {
+                calls++;
+                return LIBCURVE_ERROR::FAILED;
+            }));
+    EXPECT_CALL(mdsclient_, RefreshSession(_, _, _, _, _))
+        .Times(0);
+
+    LeaseRefreshGroup group(&mdsclient_, 10);
+    group.Add(CreateExecutor("/file1"), 50 * kMsToUs);
+    group.Add(CreateExecutor("/file2"), 50 * kMsToUs);
+    group.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(130));
+    group.Stop();
+
+    ASSERT_GE(calls.load(), 2);
+    ASSERT_EQ(2, group.Size());
+}
+
+TEST_F(LeaseManagerTest, NotSupportFallbackTest) {
+    // mds不支持批量续约时逐个文件续约，超过重试间隔后再次尝试批量续约
+    std::atomic<int> batchCalls(0);
+    std::atomic<int> singleCalls(0);
+    EXPECT_CALL(mdsclient_, RefreshSessionBatch(_, _, _))
+        .WillRepeatedly(Invoke(
+            [&batchCalls](const std::vector<RefreshSessionContext>& sessions,
+                          std::vector<LIBCURVE_ERROR>* rets,
+                          std::vector<LeaseRefreshResult>* resps) {
+                if (batchCalls++ == 0) {
+                    return LIBCURVE_ERROR::NOT_SUPPORT;
+                }
+                return BatchRefreshOK(sessions, rets, resps);
+            }));
+    EXPECT_CALL(mdsclient_, RefreshSession(_, _, _, _, _))
+        .WillRepeatedly(Invoke(
+            [&singleCalls](const std::string& filename,
+                           const UserInfo_t& userinfo,
+                           const std::string& sessionid,
+                           LeaseRefreshResult* resp,
+                           LeaseSession* lease) {
+                singleCalls++;
+                resp->status = LeaseRefreshResult::Status::OK;
+                resp->finfo.seqnum = 1;
+                return LIBCURVE_ERROR::OK;
+            }));
+
+    // 续约周期为100ms，第一次续约时不支持批量续约，250ms之后重新尝试
+    LeaseRefreshGroup group(&mdsclient_, 10, 250 * kMsToUs);
+    group.Add(CreateExecutor("/file1"), 100 * kMsToUs);
+    group.Add(CreateExecutor("/file2"), 100 * kMsToUs);
+    group.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(450));
+    group.Stop();
+
+    // 100ms、200ms、300ms逐个续约，400ms重新尝试批量续约成功
+    ASSERT_EQ(2, batchCalls.load());
+    ASSERT_EQ(6, singleCalls.load());
+    ASSERT_EQ(2, group.Size());
+}
+
+TEST_F(LeaseManagerTest, RemoveDuringRefreshTest) {
+    // 续约rpc较慢，Remove需要等待正在进行的续约结束
+    std::atomic<bool> refreshDone(false);
+    EXPECT_CALL(mdsclient_, RefreshSessionBatch(_, _, _))
+        .WillRepeatedly(Invoke(
+            [&refreshDone](const std::vector<RefreshSessionContext>& sessions,
+                           std::vector<LIBCURVE_ERROR>* rets,
+                           std::vector<LeaseRefreshResult>* resps) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(300));
+                refreshDone = true;
+                return BatchRefreshOK(sessions, rets, resps);
+            }));
+
+    LeaseRefreshGroup group(&mdsclient_, 10);
+    LeaseExecutor* executor = CreateExecutor("/file1");
+    group.Add(executor, 50 * kMsToUs);
+    group.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(refreshDone.load());
+    group.Remove(executor);
+    ASSERT_TRUE(refreshDone.load());
+    ASSERT_EQ(0, group.Size());
+    group.Stop();
+}
+
+TEST_F(LeaseManagerTest, UnregisterNotBlockOtherGroupTest) {
+    MockMDSClient slowMds;
+    MockMDSClient otherMds;
+    EXPECT_CALL(slowMds, RefreshSessionBatch(_, _, _))
+        .WillRepeatedly(Invoke(
+            [](const std::vector<RefreshSessionContext>& sessions,
+               std::vector<LIBCURVE_ERROR>* rets,
+               std::vector<LeaseRefreshResult>* resps) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                return BatchRefreshOK(sessions, rets, resps);
+            }));
+    EXPECT_CALL(otherMds, RefreshSessionBatch(_, _, _))
+        .Times(0);
+
+    LeaseManager& manager = LeaseManager::GetInstance();
+    LeaseExecutor* slowExecutor = CreateExecutor("/slow");
+    LeaseExecutor* otherExecutor = CreateExecutor("/other");
+    manager.Register(&slowMds, slowExecutor, 50 * kMsToUs, 10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // slowMds的续约正在进行，取消注册需要等待
+    std::thread unregister([&]() {
+        manager.Unregister(&slowMds, slowExecutor);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // 其他分组的注册和取消注册不受影响
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    manager.Register(&otherMds, otherExecutor, kLongLeaseUs, 10);
+    ASSERT_EQ(1, manager.GetRegisteredNum(&otherMds));
+    manager.Unregister(&otherMds, otherExecutor);
+    ASSERT_LT(TimeUtility::GetTimeofDayUs() - startUs, 200 * kMsToUs);
+    ASSERT_EQ(0, manager.GetRegisteredNum(&otherMds));
+
+    unregister.join();
+    ASSERT_EQ(0, manager.GetRegisteredNum(&slowMds));
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#ifndef TEST_CLIENT_MOCK_MDS_CLIENT_H_
+#define TEST_CLIENT_MOCK_MDS_CLIENT_H_
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+
+#include "src/client/mds_client.h"
+
+namespace curve {
+namespace client {
+
+class MockMDSClient : public MDSClient {
+ public:
+    MockMDSClient() : MDSClient() {}
+    ~MockMDSClient() = default;
+
+    MOCK_METHOD5(RefreshSession, LIBCURVE_ERROR(const std::string&,
+                                                const UserInfo_t&,
+                                                const std::string&,
+                                                LeaseRefreshResult*,
+                                                LeaseSession*));
+    MOCK_METHOD3(RefreshSessionBatch, LIBCURVE_ERROR(
+        const std::vector<RefreshSessionContext>&,
+        std::vector<LIBCURVE_ERROR>*,
+        std::vector<LeaseRefreshResult>*));
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // TEST_CLIENT_MOCK_MDS_CLIENT_H_
@@ -66,6 +66,10 @@ class MockMetaCache : public MetaCache {
                                 butil::EndPoint *, bool, FileMetric*));
     MOCK_METHOD3(UpdateLeader, int(LogicPoolID, CopysetID,
                                    const butil::EndPoint &));
+    MOCK_METHOD7(GetFollowerReadPeer, int(LogicPoolID, CopysetID,
+                                          const butil::ip_t&, ChunkServerID*,
+                                          butil::EndPoint*, bool*,
+                                          ChunkServerID));
 
     void DelegateToFake() {
         ON_CALL(*this, GetLeader(_, _, _, _, _, _))
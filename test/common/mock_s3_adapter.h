@@ -68,6 +68,13 @@ class MockS3Adapter : public S3Adapter {
             int,
             int,
             const char*));
+    MOCK_METHOD6(UploadPartCopy,
+            Aws::S3::Model::CompletedPart(const Aws::String &,
+            const Aws::String &,
+            int,
+            const Aws::String &,
+            uint64_t,
+            int));
     MOCK_METHOD3(CompleteMultiUpload,
                 int(const Aws::String &,
                 const Aws::String &,
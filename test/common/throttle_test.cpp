@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/common/throttle.h"
+
+namespace curve {
+namespace common {
+
+TEST(TokenBucketTest, test) {
+    TokenBucket bucket;
+
+    // 不限制
+    ASSERT_EQ(0, bucket.Acquire(1000000, 1));
+
+    // 100/s, burst 200
+    bucket.SetLimit(100, 200);
+    ASSERT_EQ(100, bucket.GetRate());
+    ASSERT_EQ(200, bucket.GetBurst());
+
+    uint64_t nowUs = 1000000;
+    // 初始额度为burst
+    ASSERT_EQ(0, bucket.Acquire(200, nowUs));
+    // 额度用完之后需要预支，等待时间按速率计算
+    ASSERT_EQ(100000, bucket.Acquire(10, nowUs));
+    ASSERT_EQ(200000, bucket.Acquire(10, nowUs));
+
+    // 经过1s补充100个令牌，抵消预支的20个
+    nowUs += 1000000;
+    ASSERT_EQ(0, bucket.Acquire(80, nowUs));
+    ASSERT_EQ(10000, bucket.Acquire(1, nowUs));
+
+    // 空闲时额度最多积累到burst
+    nowUs += 100 * 1000000ul;
+    ASSERT_EQ(0, bucket.Acquire(200, nowUs));
+    ASSERT_EQ(10000, bucket.Acquire(1, nowUs));
+
+    // burst小于rate时取rate
+    bucket.SetLimit(100, 10);
+    ASSERT_EQ(100, bucket.GetBurst());
+
+    // 取消限制
+    bucket.SetLimit(0, 0);
+    ASSERT_EQ(0, bucket.Acquire(1000000, nowUs));
+}
+
+TEST(ThrottleTest, test) {
+    Throttle throttle;
+    ASSERT_EQ(0, throttle.Add(true, 4096));
+    ASSERT_EQ(0, throttle.Add(false, 4096));
+
+    throttle.UpdateThrottleParams(ThrottleType::IOPS_READ,
+                                  ThrottleParams(10, 10));
+    throttle.UpdateThrottleParams(ThrottleType::BPS_WRITE,
+                                  ThrottleParams(4096, 4096));
+    ASSERT_EQ(10, throttle.GetThrottleParams(ThrottleType::IOPS_READ).limit);
+    ASSERT_EQ(0, throttle.GetThrottleParams(ThrottleType::IOPS_WRITE).limit);
+
+    // 读请求只受读IOPS限制
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(0, throttle.Add(true, 1024 * 1024));
+    }
+    ASSERT_GT(throttle.Add(true, 4096), 0);
+
+    // 写请求只受写带宽限制
+    ASSERT_EQ(0, throttle.Add(false, 4096));
+    ASSERT_GT(throttle.Add(false, 4096), 0);
+
+    // 取消限制
+    throttle.UpdateThrottleParams(ThrottleType::IOPS_READ, ThrottleParams());
+    throttle.UpdateThrottleParams(ThrottleType::BPS_WRITE, ThrottleParams());
+    ASSERT_EQ(0, throttle.Add(true, 4096));
+    ASSERT_EQ(0, throttle.Add(false, 4096));
+}
+
+}  // namespace common
+}  // namespace curve
@@ -441,6 +441,41 @@ TEST_F(Ext4LocalFileSystemTest, WriteTest) {
         .WillOnce(Return(-1))
         .WillOnce(Return(3));
     ASSERT_EQ(lfs->Write(666, buf, 0, 3), 3);
+    // pwrite returns zero
+    EXPECT_CALL(*wrapper, pwrite(_, NotNull(), _, _))
+        .WillOnce(Return(0));
+    ASSERT_EQ(lfs->Write(666, buf, 0, 3), -EIO);
+}
+
+// test writev
+TEST_F(Ext4LocalFileSystemTest, WritevTest) {
+    butil::IOBuf buf;
+    buf.append("abc", 3);
+    // success, partial write will be continued
+    EXPECT_CALL(*wrapper, pwritev(_, NotNull(), _, 0))
+        .WillOnce(Return(1));
+    EXPECT_CALL(*wrapper, pwritev(_, NotNull(), _, 1))
+        .WillOnce(Return(2));
+    ASSERT_EQ(lfs->Writev(666, buf, 0, 3), 3);
+    // buffer is smaller than length
+    ASSERT_EQ(lfs->Writev(666, buf, 0, 4), -EINVAL);
+    // pwritev failed
+    EXPECT_CALL(*wrapper, pwritev(_, NotNull(), _, _))
+        .WillOnce(Return(-1));
+    ASSERT_EQ(lfs->Writev(666, buf, 0, 3), -errno);
+    // set errno = EINTR,but only return -1 once
+    errno = EINTR;
+    EXPECT_CALL(*wrapper, pwritev(_, NotNull(), _, _))
+        .Times(2)
+        .WillOnce(Return(-1))
+        .WillOnce(Return(3));
+    ASSERT_EQ(lfs->Writev(666, buf, 0, 3), 3);
+    // pwritev returns zero after a partial write
+    EXPECT_CALL(*wrapper, pwritev(_, NotNull(), _, 0))
+        .WillOnce(Return(1));
+    EXPECT_CALL(*wrapper, pwritev(_, NotNull(), _, 1))
+        .WillOnce(Return(0));
+    ASSERT_EQ(lfs->Writev(666, buf, 0, 3), -EIO);
 }
 
 // test Fallocate
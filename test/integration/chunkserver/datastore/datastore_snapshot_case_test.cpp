@@ -352,5 +352,114 @@ TEST_F(SnapshotTestSuit, SnapshotTest) {
     ASSERT_EQ(errorCode, CSErrorCode::ChunkNotExistError);
 }
 
+/**
+ * 变化追踪测试
+ * 1.开启变化追踪，写chunk1，首个版本没有变化记录
+ * 2.模拟打快照，写chunk1产生快照，记录新版本写过的block
+ * 3.删除快照，再次打快照，旧版本的记录转移到快照上
+ * 4.重启后变化记录仍然存在
+ * 5.关闭变化追踪后重启，变化记录被清除
+ */
+TEST_F(SnapshotTestSuit, ChangedBlocksTest) {
+    const uint32_t changeBlockSize = 64 * 1024;
+    auto restart = [this](uint32_t blockSize) {
+        DataStoreOptions options;
+        options.baseDir = baseDir;
+        options.chunkSize = CHUNK_SIZE;
+        options.pageSize = PAGE_SIZE;
+        options.changeBlockSize = blockSize;
+        dataStore_ = std::make_shared<CSDataStore>(lfs_,
+                                                   filePool_,
+                                                   options);
+        ASSERT_TRUE(dataStore_->Initialize());
+    };
+    restart(changeBlockSize);
+
+    SequenceNum fileSn = 1;
+    ChunkID id1 = 1;
+    char buf[PAGE_SIZE];
+    memset(buf, '1', PAGE_SIZE);
+    CSChunkChangedBlocks changed;
+
+    // 首个版本没有变化记录
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->WriteChunk(id1, fileSn, buf, 0, PAGE_SIZE, nullptr));
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkChangedBlocks(id1, fileSn, &changed));
+    ASSERT_EQ(0, changed.baseSn);
+    ASSERT_EQ(nullptr, changed.blocks);
+    ASSERT_EQ(CSErrorCode::ChunkNotExistError,
+              dataStore_->GetChunkChangedBlocks(2, fileSn, &changed));
+
+    // 打快照之后的写入记录到新版本中
+    ++fileSn;   // fileSn == 2
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->WriteChunk(id1, fileSn, buf,
+                                     2 * changeBlockSize, PAGE_SIZE,
+                                     nullptr));
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->WriteChunk(id1, fileSn, buf,
+                                     6 * changeBlockSize - PAGE_SIZE,
+                                     2 * PAGE_SIZE,
+                                     nullptr));
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkChangedBlocks(id1, fileSn, &changed));
+    ASSERT_EQ(2, changed.sn);
+    ASSERT_EQ(1, changed.baseSn);
+    ASSERT_NE(nullptr, changed.blocks);
+    ASSERT_EQ(CHUNK_SIZE / changeBlockSize, changed.blocks->Size());
+    ASSERT_EQ(2, changed.blocks->NextSetBit(0));
+    ASSERT_EQ(5, changed.blocks->NextSetBit(3));
+    ASSERT_EQ(6, changed.blocks->NextSetBit(6, 7));
+    ASSERT_EQ(Bitmap::NO_POS, changed.blocks->NextSetBit(7));
+    // 快照保存的版本1没有变化记录
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkChangedBlocks(id1, 1, &changed));
+    ASSERT_EQ(0, changed.baseSn);
+
+    // 删除快照后再次打快照，版本2的记录转移到快照上
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->DeleteSnapshotChunkOrCorrectSn(id1, fileSn));
+    ++fileSn;   // fileSn == 3
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->WriteChunk(id1, fileSn, buf, 0, PAGE_SIZE, nullptr));
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkChangedBlocks(id1, 2, &changed));
+    ASSERT_EQ(1, changed.baseSn);
+    ASSERT_EQ(2, changed.blocks->NextSetBit(0));
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkChangedBlocks(id1, fileSn, &changed));
+    ASSERT_EQ(2, changed.baseSn);
+    ASSERT_EQ(0, changed.blocks->NextSetBit(0));
+    ASSERT_EQ(Bitmap::NO_POS, changed.blocks->NextSetBit(1));
+
+    // 重启后变化记录仍然存在
+    restart(changeBlockSize);
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkChangedBlocks(id1, 2, &changed));
+    ASSERT_EQ(1, changed.baseSn);
+    ASSERT_EQ(5, changed.blocks->NextSetBit(3));
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkChangedBlocks(id1, fileSn, &changed));
+    ASSERT_EQ(2, changed.baseSn);
+
+    // 关闭变化追踪后重启，已有的记录被清除，再次开启后也不会使用
+    restart(0);
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->WriteChunk(id1, fileSn, buf,
+                                     3 * changeBlockSize, PAGE_SIZE,
+                                     nullptr));
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkChangedBlocks(id1, fileSn, &changed));
+    ASSERT_EQ(0, changed.baseSn);
+    restart(changeBlockSize);
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkChangedBlocks(id1, fileSn, &changed));
+    ASSERT_EQ(0, changed.baseSn);
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->GetChunkChangedBlocks(id1, 2, &changed));
+    ASSERT_EQ(0, changed.baseSn);
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -200,6 +200,12 @@ class FakeTopologyStorage : public TopologyStorage {
     bool UpdateCopySet(const CopySetInfo &data) {
         return true;
     }
+    bool UpdateChunkServers(const std::vector<ChunkServer> &datas) {
+        return true;
+    }
+    bool UpdateCopySets(const std::vector<CopySetInfo> &datas) {
+        return true;
+    }
 
     bool LoadClusterInfo(std::vector<ClusterInformation> *info) {
         return true;
@@ -209,6 +209,20 @@ int FakeCurveFsClient::CreateCloneChunk(
     return LIBCURVE_ERROR::OK;
 }
 
+int FakeCurveFsClient::CreateCloneChunks(
+    const ChunkIDInfo &copysetidinfo,
+    const std::vector<CloneChunkDesc> &chunks,
+    uint64_t csn,
+    uint64_t chunkSize,
+    std::vector<ChunkID> *existChunkIds,
+    SnapCloneClosure* scc) {
+    scc->SetRetCode(LIBCURVE_ERROR::OK);
+    scc->Run();
+    fiu_return_on(
+        "test/integration/snapshotcloneserver/FakeCurveFsClient.CreateCloneChunks", -LIBCURVE_ERROR::FAILED);  // NOLINT
+    return LIBCURVE_ERROR::OK;
+}
+
 int FakeCurveFsClient::RecoverChunk(
     const ChunkIDInfo &chunkidinfo,
     uint64_t offset,
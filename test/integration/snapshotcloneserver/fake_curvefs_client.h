@@ -102,6 +102,14 @@ class FakeCurveFsClient : public CurveFsClient {
         uint64_t chunkSize,
         SnapCloneClosure *scc) override;
 
+    int CreateCloneChunks(
+        const ChunkIDInfo &copysetidinfo,
+        const std::vector<CloneChunkDesc> &chunks,
+        uint64_t csn,
+        uint64_t chunkSize,
+        std::vector<ChunkID> *existChunkIds,
+        SnapCloneClosure *scc) override;
+
     int RecoverChunk(
         const ChunkIDInfo &chunkidinfo,
         uint64_t offset,
@@ -96,6 +96,14 @@ int FakeSnapshotDataStore::DataChunkTranferAddPart(const ChunkDataName &name,
     return 0;
 }
 
+int FakeSnapshotDataStore::DataChunkTranferCopyPart(const ChunkDataName &name,
+        std::shared_ptr<TransferTask> task,
+        int partNum,
+        int partSize,
+        const ChunkDataName &srcName) {
+    return 0;
+}
+
 int FakeSnapshotDataStore::DataChunkTranferComplete(const ChunkDataName &name,
         std::shared_ptr<TransferTask> task) {
     std::lock_guard<std::mutex> guard(chunkDataMutex_);
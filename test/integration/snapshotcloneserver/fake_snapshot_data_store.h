@@ -53,6 +53,11 @@ class FakeSnapshotDataStore : public SnapshotDataStore {
                                         int partNum,
                                         int partSize,
                                         const char* buf) override;
+    int DataChunkTranferCopyPart(const ChunkDataName &name,
+                                 std::shared_ptr<TransferTask> task,
+                                 int partNum,
+                                 int partSize,
+                                 const ChunkDataName &srcName) override;
     int DataChunkTranferComplete(const ChunkDataName &name,
                                 std::shared_ptr<TransferTask> task) override;
     int DataChunkTranferAbort(const ChunkDataName &name,
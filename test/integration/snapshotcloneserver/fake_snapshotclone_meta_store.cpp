@@ -150,6 +150,22 @@ int FakeSnapshotCloneMetaStore::GetCloneInfoByFileName(
     return -1;
 }
 
+int FakeSnapshotCloneMetaStore::GetCloneInfoByUser(
+        const std::string &user, std::vector<CloneInfo> *list) {
+    curve::common::ReadLockGuard guard(cloneInfos_lock_);
+    for (auto it = cloneInfos_.begin();
+             it != cloneInfos_.end();
+             it++) {
+        if (it->second.GetUser() == user) {
+            list->push_back(it->second);
+        }
+    }
+    if (list->size() != 0) {
+        return 0;
+    }
+    return -1;
+}
+
 int FakeSnapshotCloneMetaStore::GetCloneInfoList(
     std::vector<CloneInfo> *v) {
     curve::common::ReadLockGuard guard(cloneInfos_lock_);
@@ -164,7 +180,42 @@ int FakeSnapshotCloneMetaStore::GetCloneInfoList(
     return -1;
 }
 
+int FakeSnapshotCloneMetaStore::AddChunkDataRef(const std::string &name,
+    const std::string &hash, uint32_t *refCount) {
+    std::lock_guard<std::mutex> guard(chunkDataRefs_mutex_);
+    chunkDataRefs_.emplace(name, hash);
+    *refCount = 0;
+    for (auto &ref : chunkDataRefs_) {
+        if (ref.second == hash) {
+            (*refCount)++;
+        }
+    }
+    return 0;
+}
 
+int FakeSnapshotCloneMetaStore::GetChunkDataRef(const std::string &name,
+    std::string *hash) {
+    std::lock_guard<std::mutex> guard(chunkDataRefs_mutex_);
+    auto search = chunkDataRefs_.find(name);
+    if (search == chunkDataRefs_.end()) {
+        return -1;
+    }
+    *hash = search->second;
+    return 0;
+}
+
+int FakeSnapshotCloneMetaStore::RemoveChunkDataRef(const std::string &name,
+    const std::string &hash, uint32_t *refCount) {
+    std::lock_guard<std::mutex> guard(chunkDataRefs_mutex_);
+    chunkDataRefs_.erase(name);
+    *refCount = 0;
+    for (auto &ref : chunkDataRefs_) {
+        if (ref.second == hash) {
+            (*refCount)++;
+        }
+    }
+    return 0;
+}
 
 }  // namespace snapshotcloneserver
 }  // namespace curve
@@ -54,14 +54,28 @@ class FakeSnapshotCloneMetaStore : public SnapshotCloneMetaStore {
     int GetCloneInfoByFileName(
         const std::string &fileName, std::vector<CloneInfo> *list) override;
 
+    int GetCloneInfoByUser(
+        const std::string &user, std::vector<CloneInfo> *list) override;
+
     int GetCloneInfoList(std::vector<CloneInfo> *list) override;
 
+    int AddChunkDataRef(const std::string &name,
+        const std::string &hash, uint32_t *refCount) override;
+
+    int GetChunkDataRef(const std::string &name, std::string *hash) override;
+
+    int RemoveChunkDataRef(const std::string &name,
+        const std::string &hash, uint32_t *refCount) override;
+
  private:
     std::map<UUID, SnapshotInfo> snapInfos_;
     std::mutex snapInfos_mutex;
 
     std::map<std::string, CloneInfo> cloneInfos_;
     curve::common::RWLock cloneInfos_lock_;
+
+    std::map<std::string, std::string> chunkDataRefs_;
+    std::mutex chunkDataRefs_mutex_;
 };
 
 
@@ -54,6 +54,7 @@ class SnapshotCloneServerTest : public ::testing::Test {
         options_->cloneTempDir = "/clone";
         options_->mdsRootUser = "root";
         options_->createCloneChunkConcurrency = 8;
+        options_->createCloneChunkBatchSize = 0;
         options_->recoverChunkConcurrency = 8;
         options_->clientAsyncMethodRetryTimeSec = 1;
 
@@ -359,6 +359,43 @@ TEST_F(TestEtcdClinetImp, test_ListWithLimitAndRevision) {
     }
 }
 
+TEST_F(TestEtcdClinetImp, test_BatchPut) {
+    // 1. 空的batch
+    std::vector<KVPair> kvs;
+    ASSERT_EQ(EtcdErrCode::EtcdOK, client_->BatchPut(kvs));
+
+    // 2. 超过单个事务操作数上限，拆分成多个事务
+    int num = 2 * kEtcdMaxTxnOps + 10;
+    for (int i = 0; i < num; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "batch%05d", i);
+        kvs.emplace_back(key, std::string("value") + std::to_string(i));
+    }
+    ASSERT_EQ(EtcdErrCode::EtcdOK, client_->BatchPut(kvs));
+
+    std::vector<std::string> out;
+    ASSERT_EQ(EtcdErrCode::EtcdOK, client_->List("batch", "batci", &out));
+    ASSERT_EQ(num, out.size());
+    for (int i = 0; i < num; i++) {
+        ASSERT_EQ(std::string("value") + std::to_string(i), out[i]);
+    }
+
+    // 3. 超过单个事务字节数上限
+    kvs.clear();
+    std::string bigValue(kEtcdMaxTxnBytes / 2, 'a');
+    for (int i = 0; i < 3; i++) {
+        kvs.emplace_back("big" + std::to_string(i), bigValue);
+    }
+    ASSERT_EQ(EtcdErrCode::EtcdOK, client_->BatchPut(kvs));
+    std::string value;
+    ASSERT_EQ(EtcdErrCode::EtcdOK, client_->Get("big2", &value));
+    ASSERT_EQ(bigValue, value);
+
+    // 4. 超时
+    client_->SetTimeout(0);
+    ASSERT_EQ(EtcdErrCode::EtcdDeadlineExceeded, client_->BatchPut(kvs));
+}
+
 TEST_F(TestEtcdClinetImp, test_return_with_revision) {
     int64_t startRevision;
     int res = client_->GetCurrentRevision(&startRevision);
@@ -372,6 +409,31 @@ TEST_F(TestEtcdClinetImp, test_return_with_revision) {
     res = client_->DeleteRewithRevision("hello", &revision);
     ASSERT_EQ(EtcdErrCode::EtcdOK, res);
     ASSERT_EQ(startRevision + 2, revision);
+
+    // 事务中的多个操作只产生一个revision
+    std::string key1 = "txnkey1", key2 = "txnkey2", value = "txnvalue";
+    Operation op1{OpType::OpPut, const_cast<char*>(key1.c_str()),
+        const_cast<char*>(value.c_str()), key1.size(), value.size()};
+    Operation op2{OpType::OpPut, const_cast<char*>(key2.c_str()),
+        const_cast<char*>(value.c_str()), key2.size(), value.size()};
+    std::vector<Operation> ops{op1, op2};
+    res = client_->TxnWithRevision(ops, &revision);
+    ASSERT_EQ(EtcdErrCode::EtcdOK, res);
+    ASSERT_EQ(startRevision + 3, revision);
+
+    op1.opType = OpType::OpDelete;
+    ops = {op1, op2};
+    res = client_->TxnWithRevision(ops, &revision);
+    ASSERT_EQ(EtcdErrCode::EtcdOK, res);
+    ASSERT_EQ(startRevision + 4, revision);
+    std::string out;
+    ASSERT_EQ(EtcdErrCode::EtcdKeyNotExist, client_->Get(key1, &out));
+    ASSERT_EQ(EtcdErrCode::EtcdOK, client_->Get(key2, &out));
+
+    // 空事务
+    ops.clear();
+    ASSERT_EQ(EtcdErrCode::EtcdInvalidArgument,
+        client_->TxnWithRevision(ops, &revision));
 }
 
 TEST_F(TestEtcdClinetImp, test_CampaignLeader) {
@@ -29,6 +29,7 @@
 
 #include <chrono>  //NOLINT
 #include <thread>  //NOLINT
+#include <vector>
 
 #include "proto/cli.pb.h"
 #include "proto/chunk.pb.h"
@@ -793,6 +794,99 @@ TEST_F(TestChunkServerClient, TestDeleteChunkReturnNotLeader) {
     ASSERT_EQ(kCsClientNotLeader, ret);
 }
 
+TEST_F(TestChunkServerClient, TestDeleteChunksSuccess) {
+    uint32_t port = listenAddr_.port;
+
+    ChunkServerIdType csId = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32, 0x33};
+    uint64_t sn = 100;
+
+    ChunkServer chunkserver(
+        csId, "", "", 0x101, "127.0.0.1", port, "", READWRITE);
+    ChunkServerState csState;
+    csState.SetDiskState(DISKNORMAL);
+    chunkserver.SetOnlineState(ONLINE);
+    chunkserver.SetChunkServerState(csState);
+
+    EXPECT_CALL(*topo_, GetChunkServer(csId, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkserver),
+            Return(true)));
+    ChunkResponse response;
+    response.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+    ChunkRequest sent;
+    EXPECT_CALL(*chunkService, DeleteChunks(_, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(response),
+                Invoke([&](RpcController *controller,
+                          const ChunkRequest *request,
+                          ChunkResponse *response,
+                          Closure *done){
+                          brpc::ClosureGuard doneGuard(done);
+                          sent = *request;
+                    })));
+
+    int ret = client_->DeleteChunks(
+        csId, logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kMdsSuccess, ret);
+    ASSERT_EQ(CHUNK_OP_TYPE::CHUNK_OP_DELETE_BATCH, sent.optype());
+    ASSERT_EQ(logicalPoolId, sent.logicpoolid());
+    ASSERT_EQ(copysetId, sent.copysetid());
+    ASSERT_EQ(sn, sent.sn());
+    ASSERT_EQ(chunkIds.size(), sent.deletechunkids_size());
+    for (int i = 0; i < sent.deletechunkids_size(); ++i) {
+        ASSERT_EQ(chunkIds[i], sent.deletechunkids(i));
+    }
+}
+
+TEST_F(TestChunkServerClient, TestDeleteChunksReturnFail) {
+    uint32_t port = listenAddr_.port;
+
+    ChunkServerIdType csId = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32};
+    uint64_t sn = 100;
+
+    ChunkServer chunkserver(
+        csId, "", "", 0x101, "127.0.0.1", port, "", READWRITE);
+    ChunkServerState csState;
+    csState.SetDiskState(DISKNORMAL);
+    chunkserver.SetOnlineState(ONLINE);
+    chunkserver.SetChunkServerState(csState);
+
+    EXPECT_CALL(*topo_, GetChunkServer(csId, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkserver),
+            Return(true)));
+    ChunkResponse response1;
+    response1.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED);
+    ChunkResponse response2;
+    response2.set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_FAILURE_UNKNOWN);
+    EXPECT_CALL(*chunkService, DeleteChunks(_, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(response1),
+                Invoke([](RpcController *controller,
+                          const ChunkRequest *request,
+                          ChunkResponse *response,
+                          Closure *done){
+                          brpc::ClosureGuard doneGuard(done);
+                    })))
+        .WillOnce(DoAll(SetArgPointee<2>(response2),
+                Invoke([](RpcController *controller,
+                          const ChunkRequest *request,
+                          ChunkResponse *response,
+                          Closure *done){
+                          brpc::ClosureGuard doneGuard(done);
+                    })));
+
+    int ret = client_->DeleteChunks(
+        csId, logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kCsClientNotLeader, ret);
+    ret = client_->DeleteChunks(
+        csId, logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kCsClientReturnFail, ret);
+}
+
 }  // namespace chunkserverclient
 }  // namespace mds
 }  // namespace curve
@@ -28,6 +28,7 @@
 
 #include <chrono>  //NOLINT
 #include <thread>  //NOLINT
+#include <vector>
 
 #include "proto/cli.pb.h"
 #include "proto/chunk.pb.h"
@@ -401,6 +402,135 @@ TEST_F(TestCopysetClient, TestDeleteChunkRedirectFail) {
         logicalPoolId, copysetId, chunkId, sn);
     ASSERT_EQ(kMdsFail, ret);
 }
+
+TEST_F(TestCopysetClient, TestDeleteChunksLeaderChanged) {
+    ChunkServerIdType leader = 0x01;
+    ChunkServerIdType newLeader = 0x02;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32, 0x33};
+    uint64_t sn = 100;
+
+    // 同一复制组只查询一次copyset
+    CopySetInfo copyset(logicalPoolId, copysetId);
+    copyset.SetLeader(leader);
+    copyset.SetCopySetMembers({0x01, 0x02, 0x03});
+    EXPECT_CALL(*topo_, GetCopySet(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(copyset),
+            Return(true)));
+
+    // 第二个chunk删除时leader切换，之后的chunk直接发给新leader
+    EXPECT_CALL(*mockCsClient_, DeleteChunk(
+            leader, logicalPoolId, copysetId, 0x31, sn))
+        .WillOnce(Return(kMdsSuccess));
+    EXPECT_CALL(*mockCsClient_, DeleteChunk(
+            leader, logicalPoolId, copysetId, 0x32, sn))
+        .WillOnce(Return(kCsClientNotLeader));
+    EXPECT_CALL(*mockCsClient_, GetLeader(
+        _, logicalPoolId, copysetId, _))
+        .WillOnce(DoAll(SetArgPointee<3>(newLeader),
+                Return(kMdsSuccess)));
+    EXPECT_CALL(*mockCsClient_, DeleteChunk(
+            newLeader, logicalPoolId, copysetId, 0x32, sn))
+        .WillOnce(Return(kMdsSuccess));
+    EXPECT_CALL(*mockCsClient_, DeleteChunk(
+            newLeader, logicalPoolId, copysetId, 0x33, sn))
+        .WillOnce(Return(kMdsSuccess));
+
+    int ret = client_->DeleteChunks(
+        logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kMdsSuccess, ret);
+}
+
+TEST_F(TestCopysetClient, TestDeleteChunkSnapshotsOrCorrectSnFail) {
+    ChunkServerIdType leader = 0x01;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32, 0x33};
+    uint64_t sn = 100;
+
+    CopySetInfo copyset(logicalPoolId, copysetId);
+    copyset.SetLeader(leader);
+    copyset.SetCopySetMembers({0x01, 0x02, 0x03});
+    EXPECT_CALL(*topo_, GetCopySet(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(copyset),
+            Return(true)));
+
+    // 遇到失败的chunk即返回，不再删除后续chunk
+    EXPECT_CALL(*mockCsClient_, DeleteChunkSnapshotOrCorrectSn(
+            leader, logicalPoolId, copysetId, 0x31, sn))
+        .WillOnce(Return(kMdsSuccess));
+    EXPECT_CALL(*mockCsClient_, DeleteChunkSnapshotOrCorrectSn(
+            leader, logicalPoolId, copysetId, 0x32, sn))
+        .WillOnce(Return(kMdsFail));
+
+    int ret = client_->DeleteChunkSnapshotsOrCorrectSn(
+        logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kMdsFail, ret);
+}
+
+TEST_F(TestCopysetClient, TestDeleteChunksInBatch) {
+    ChunkServerIdType leader = 0x01;
+    ChunkServerIdType newLeader = 0x02;
+    LogicalPoolID logicalPoolId = 0x11;
+    CopysetID copysetId = 0x21;
+    std::vector<ChunkID> chunkIds = {0x31, 0x32, 0x33, 0x34, 0x35};
+    uint64_t sn = 100;
+
+    ChunkServerClientOption option;
+    option.updateLeaderRetryIntervalMs = 0;
+    option.deleteChunkBatchSize = 2;
+    auto client = std::make_shared<CopysetClient>(topo_, option,
+        std::make_shared<ChannelPool>());
+    client->SetChunkServerClient(mockCsClient_);
+
+    CopySetInfo copyset(logicalPoolId, copysetId);
+    copyset.SetLeader(leader);
+    copyset.SetCopySetMembers({0x01, 0x02, 0x03});
+    EXPECT_CALL(*topo_, GetCopySet(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(copyset),
+            Return(true)));
+
+    // 每2个chunk一个请求，不再逐个chunk删除；
+    // 第二个请求时leader切换，之后的请求直接发给新leader
+    EXPECT_CALL(*mockCsClient_, DeleteChunk(_, _, _, _, _))
+        .Times(0);
+    std::vector<ChunkID> batch1 = {0x31, 0x32};
+    std::vector<ChunkID> batch2 = {0x33, 0x34};
+    std::vector<ChunkID> batch3 = {0x35};
+    EXPECT_CALL(*mockCsClient_, DeleteChunks(
+            leader, logicalPoolId, copysetId, batch1, sn))
+        .WillOnce(Return(kMdsSuccess));
+    EXPECT_CALL(*mockCsClient_, DeleteChunks(
+            leader, logicalPoolId, copysetId, batch2, sn))
+        .WillOnce(Return(kCsClientNotLeader));
+    EXPECT_CALL(*mockCsClient_, GetLeader(
+        _, logicalPoolId, copysetId, _))
+        .WillOnce(DoAll(SetArgPointee<3>(newLeader),
+                Return(kMdsSuccess)));
+    EXPECT_CALL(*mockCsClient_, DeleteChunks(
+            newLeader, logicalPoolId, copysetId, batch2, sn))
+        .WillOnce(Return(kMdsSuccess));
+    EXPECT_CALL(*mockCsClient_, DeleteChunks(
+            newLeader, logicalPoolId, copysetId, batch3, sn))
+        .WillOnce(Return(kMdsSuccess));
+
+    int ret = client->DeleteChunks(
+        logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kMdsSuccess, ret);
+
+    // 请求失败时返回，不再删除后续的chunk
+    EXPECT_CALL(*topo_, GetCopySet(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(copyset),
+            Return(true)));
+    EXPECT_CALL(*mockCsClient_, DeleteChunks(
+            leader, logicalPoolId, copysetId, batch1, sn))
+        .WillOnce(Return(kCsClientReturnFail));
+    ret = client->DeleteChunks(
+        logicalPoolId, copysetId, chunkIds, sn);
+    ASSERT_EQ(kCsClientReturnFail, ret);
+}
+
 }  // namespace chunkserverclient
 }  // namespace mds
 }  // namespace curve
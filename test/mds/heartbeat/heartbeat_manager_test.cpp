@@ -915,6 +915,65 @@ TEST_F(TestHeartbeatManager, test_patrol_copySetInfo_return_order) {
     ASSERT_EQ(TRANSFER_LEADER, response.needupdatecopysets(0).type());
     ASSERT_EQ(3, response.needupdatecopysets(0).peers_size());
 }
+TEST_F(TestHeartbeatManager, test_delta_report) {
+    auto request = GetChunkServerHeartbeatRequestForTest();
+    request.clear_copysetinfos();
+    request.set_isdeltareport(true);
+    ChunkServerHeartbeatResponse response;
+    ::curve::mds::topology::ChunkServer chunkServer1(
+        1, "hello", "", 1, "192.168.10.1", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+
+    // 1. mds没有上一次的统计数据，要求全量上报;
+    //    增量上报中没有copyset不返回hbRequestNoCopyset
+    EXPECT_CALL(*topology_, GetChunkServer(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkServer1), Return(true)));
+    EXPECT_CALL(*topologyStat_, GetChunkServerStat(1, _))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*coordinator_, GetCopySetsWithOperator())
+        .WillOnce(Return(std::vector<CopySetKey>{}));
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_TRUE(response.supportdeltareport());
+    ASSERT_TRUE(response.needfullreport());
+    ASSERT_EQ(HeartbeatStatusCode::hbOK, response.statuscode());
+    ASSERT_EQ(0, response.needupdatecopysets_size());
+
+    // 2. 未上报的copyset中，leader在该chunkserver上且有operator的生成配置
+    response.Clear();
+    ::curve::mds::topology::CopySetInfo copySet1(1, 1);
+    copySet1.SetEpoch(10);
+    copySet1.SetLeader(1);
+    copySet1.SetCopySetMembers({1, 2, 3});
+    ::curve::mds::topology::CopySetInfo copySet2(1, 2);
+    copySet2.SetLeader(2);
+    ::curve::mds::topology::ChunkServerStat lastStat;
+    EXPECT_CALL(*topology_, GetChunkServer(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkServer1), Return(true)));
+    EXPECT_CALL(*topologyStat_, GetChunkServerStat(1, _))
+        .WillOnce(DoAll(SetArgPointee<1>(lastStat), Return(true)));
+    EXPECT_CALL(*coordinator_, GetCopySetsWithOperator())
+        .WillOnce(Return(std::vector<CopySetKey>{
+            CopySetKey(1, 1), CopySetKey(1, 2)}));
+    EXPECT_CALL(*topology_, GetCopySet(CopySetKey(1, 1), _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copySet1), Return(true)));
+    EXPECT_CALL(*topology_, GetCopySet(CopySetKey(1, 2), _))
+        .WillOnce(DoAll(SetArgPointee<1>(copySet2), Return(true)));
+    ::curve::mds::heartbeat::CopySetConf res;
+    res.set_logicalpoolid(1);
+    res.set_copysetid(1);
+    res.set_epoch(10);
+    res.set_type(TRANSFER_LEADER);
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(res), Return(2)));
+    EXPECT_CALL(*topology_, UpdateCopySetTopo(_))
+        .WillOnce(Return(::curve::mds::topology::kTopoErrCodeSuccess));
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_FALSE(response.needfullreport());
+    ASSERT_EQ(1, response.needupdatecopysets_size());
+    ASSERT_EQ(1, response.needupdatecopysets(0).copysetid());
+    ASSERT_EQ(TRANSFER_LEADER, response.needupdatecopysets(0).type());
+}
 }  // namespace heartbeat
 }  // namespace mds
 }  // namespace curve
@@ -34,6 +34,8 @@ namespace curve {
 namespace mds {
 
 using ::curve::kvstorage::EtcdClientImp;
+using ::curve::kvstorage::KVPair;
+using ::curve::kvstorage::KVChange;
 
 class MockEtcdClient : public EtcdClientImp {
  public:
@@ -44,6 +46,9 @@ class MockEtcdClient : public EtcdClientImp {
         int(const std::string&, const std::string&, std::vector<std::string>*));
     MOCK_METHOD1(Delete, int(const std::string&));
     MOCK_METHOD1(TxnN, int(const std::vector<Operation>&));
+    MOCK_METHOD2(TxnWithRevision,
+        int(const std::vector<Operation>&, int64_t *));
+    MOCK_METHOD1(BatchPut, int(const std::vector<KVPair>&));
     MOCK_METHOD3(CompareAndSwap, int(const std::string&, const std::string&,
         const std::string&));
     MOCK_METHOD5(CampaignLeader, int(const std::string&, const std::string&,
@@ -58,6 +63,8 @@ class MockEtcdClient : public EtcdClientImp {
     MOCK_METHOD3(PutRewithRevision, int(const std::string &,
         const std::string &, int64_t *));
     MOCK_METHOD2(DeleteRewithRevision, int(const std::string &, int64_t *));
+    MOCK_METHOD5(ListChanges, int(const std::string&, const std::string&,
+        int64_t, int64_t, std::vector<KVChange>*));
 };
 
 class MockLRUCache : public LRUCache {
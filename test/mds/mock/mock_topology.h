@@ -124,6 +124,11 @@ class MockTopology : public Topology {
     MOCK_METHOD1(UpdateCopySetTopo,
         int(const ::curve::mds::topology::CopySetInfo &data));
 
+    MOCK_CONST_METHOD0(GetCopySetDistributionVersion, uint64_t());
+
+    MOCK_CONST_METHOD3(GetChangedCopySets, bool(uint64_t sinceVersion,
+        std::vector<CopySetKey> *changed, uint64_t *version));
+
     MOCK_METHOD3(UpdateCopySetAllocInfo,
         int(CopySetKey key, uint32_t allocChunkNum, uint64_t allocSize));
 
@@ -36,6 +36,7 @@ using ::curve::common::SEGMENTALLOCSIZEKEYEND;
 using ::curve::common::SEGMENTALLOCSIZEKEY;
 using ::curve::common::SEGMENTINFOKEYPREFIX;
 using ::curve::common::SEGMENTINFOKEYEND;
+using ::curve::common::SEGMENTALLOCCHECKPOINTKEY;
 
 namespace curve {
 namespace mds {
@@ -175,6 +176,97 @@ TEST(TestAllocStatisticHelper, test_CalculateSegmentAlloc) {
         ASSERT_EQ(501L * (1 << 30), out[2]);
     }
 }
+
+TEST(TestAllocStatisticHelper, test_GetSegmentAllocCheckpoint) {
+    auto mockEtcdClient = std::make_shared<MockEtcdClient>();
+    int64_t revision;
+    std::map<PoolIdType, int64_t> out;
+    {
+        // 1. 检查点不存在
+        EXPECT_CALL(*mockEtcdClient, Get(SEGMENTALLOCCHECKPOINTKEY, _))
+            .WillOnce(Return(EtcdErrCode::EtcdKeyNotExist));
+        ASSERT_EQ(-1, AllocStatisticHelper::GetSegmentAllocCheckpoint(
+            mockEtcdClient, &revision, &out));
+    }
+    {
+        // 2. 解析失败
+        EXPECT_CALL(*mockEtcdClient, Get(SEGMENTALLOCCHECKPOINTKEY, _))
+            .WillOnce(DoAll(SetArgPointee<1>(std::string("hello")),
+                            Return(EtcdErrCode::EtcdOK)));
+        ASSERT_EQ(-1, AllocStatisticHelper::GetSegmentAllocCheckpoint(
+            mockEtcdClient, &revision, &out));
+    }
+    {
+        // 3. 获取成功
+        EXPECT_CALL(*mockEtcdClient, Get(SEGMENTALLOCCHECKPOINTKEY, _))
+            .WillOnce(DoAll(SetArgPointee<1>(std::string("5|1_1024")),
+                            Return(EtcdErrCode::EtcdOK)));
+        ASSERT_EQ(0, AllocStatisticHelper::GetSegmentAllocCheckpoint(
+            mockEtcdClient, &revision, &out));
+        ASSERT_EQ(5, revision);
+        ASSERT_EQ(1, out.size());
+        ASSERT_EQ(1024, out[1]);
+    }
+}
+
+TEST(TestAllocStatisticHelper, test_ReplaySegmentChanges) {
+    auto mockEtcdClient = std::make_shared<MockEtcdClient>();
+    PageFileSegment segment;
+    segment.set_segmentsize(1 << 30);
+    segment.set_chunksize(16*1024*1024);
+    segment.set_startoffset(0);
+    std::string segmentInPool1, segmentInPool2;
+    segment.set_logicalpoolid(1);
+    ASSERT_TRUE(NameSpaceStorageCodec::EncodeSegment(segment, &segmentInPool1));
+    segment.set_logicalpoolid(2);
+    ASSERT_TRUE(NameSpaceStorageCodec::EncodeSegment(segment, &segmentInPool2));
+
+    {
+        // 1. 获取变化失败, 例如历史已经被compact
+        EXPECT_CALL(*mockEtcdClient, ListChanges(
+            SEGMENTINFOKEYPREFIX, SEGMENTINFOKEYEND, 5, 10, _))
+            .WillOnce(Return(EtcdErrCode::EtcdOutOfRange));
+        std::map<PoolIdType, int64_t> out;
+        ASSERT_EQ(-1, AllocStatisticHelper::ReplaySegmentChanges(
+            5, 10, mockEtcdClient, &out));
+    }
+    {
+        // 2. 解析失败
+        std::vector<KVChange> changes(1);
+        changes[0].type = OpType::OpPut;
+        changes[0].value = "hello";
+        changes[0].revision = 6;
+        EXPECT_CALL(*mockEtcdClient, ListChanges(
+            SEGMENTINFOKEYPREFIX, SEGMENTINFOKEYEND, 5, 10, _))
+            .WillOnce(DoAll(SetArgPointee<4>(changes),
+                            Return(EtcdErrCode::EtcdOK)));
+        std::map<PoolIdType, int64_t> out;
+        ASSERT_EQ(-1, AllocStatisticHelper::ReplaySegmentChanges(
+            5, 10, mockEtcdClient, &out));
+    }
+    {
+        // 3. 回放新建和删除的segment
+        std::vector<KVChange> changes(3);
+        changes[0].type = OpType::OpPut;
+        changes[0].value = segmentInPool1;
+        changes[0].revision = 6;
+        changes[1].type = OpType::OpPut;
+        changes[1].value = segmentInPool1;
+        changes[1].revision = 7;
+        changes[2].type = OpType::OpDelete;
+        changes[2].prevValue = segmentInPool2;
+        changes[2].revision = 8;
+        EXPECT_CALL(*mockEtcdClient, ListChanges(
+            SEGMENTINFOKEYPREFIX, SEGMENTINFOKEYEND, 5, 10, _))
+            .WillOnce(DoAll(SetArgPointee<4>(changes),
+                            Return(EtcdErrCode::EtcdOK)));
+        std::map<PoolIdType, int64_t> out{{1, 1024}, {2, 2L << 30}};
+        ASSERT_EQ(0, AllocStatisticHelper::ReplaySegmentChanges(
+            5, 10, mockEtcdClient, &out));
+        ASSERT_EQ(1024 + (2L << 30), out[1]);
+        ASSERT_EQ(1L << 30, out[2]);
+    }
+}
 }  // namespace mds
 }  // namespace curve
 
@@ -36,6 +36,7 @@ using ::curve::common::SEGMENTALLOCSIZEKEYEND;
 using ::curve::common::SEGMENTALLOCSIZEKEY;
 using ::curve::common::SEGMENTINFOKEYEND;
 using ::curve::common::SEGMENTINFOKEYPREFIX;
+using ::curve::common::SEGMENTALLOCCHECKPOINTKEY;
 
 namespace curve {
 namespace mds {
@@ -88,6 +89,8 @@ TEST_F(AllocStatisticTest, test_Init) {
             SEGMENTALLOCSIZEKEY, SEGMENTALLOCSIZEKEYEND, _))
             .WillOnce(
                 DoAll(SetArgPointee<2>(values), Return(EtcdErrCode::EtcdOK)));
+        EXPECT_CALL(*mockEtcdClient_, Get(SEGMENTALLOCCHECKPOINTKEY, _))
+            .WillOnce(Return(EtcdErrCode::EtcdKeyNotExist));
         ASSERT_EQ(0, allocStatistic_->Init());
         int64_t alloc;
         ASSERT_TRUE(allocStatistic_->GetAllocByLogicalPool(1, &alloc));
@@ -105,6 +108,8 @@ TEST_F(AllocStatisticTest, test_PeriodicPersist_CalculateSegmentAlloc) {
     EXPECT_CALL(*mockEtcdClient_, List(
         SEGMENTALLOCSIZEKEY, SEGMENTALLOCSIZEKEYEND, _))
         .WillOnce(DoAll(SetArgPointee<2>(values), Return(EtcdErrCode::EtcdOK)));
+    EXPECT_CALL(*mockEtcdClient_, Get(SEGMENTALLOCCHECKPOINTKEY, _))
+        .WillOnce(Return(EtcdErrCode::EtcdKeyNotExist));
     ASSERT_EQ(0, allocStatistic_->Init());
 
     PageFileSegment segment;
@@ -194,6 +199,11 @@ TEST_F(AllocStatisticTest, test_PeriodicPersist_CalculateSegmentAlloc) {
         NameSpaceStorageCodec::EncodeSegmentAllocValue(3, 1L << 30)))
         .WillOnce(Return(EtcdErrCode::EtcdOK));
 
+    EXPECT_CALL(*mockEtcdClient_,
+        PutRewithRevision(SEGMENTALLOCCHECKPOINTKEY, _, _))
+        .WillRepeatedly(
+            DoAll(SetArgPointee<2>(20), Return(EtcdErrCode::EtcdOK)));
+
     // 2. 启动定期持久化线程和统计线程
     for (int i = 1; i <= 2; i++) {
         allocStatistic_->AllocSpace(i, 1L << 30, i + 3);
@@ -224,5 +234,66 @@ TEST_F(AllocStatisticTest, test_PeriodicPersist_CalculateSegmentAlloc) {
     allocStatistic_->Stop();
 }
 
+TEST_F(AllocStatisticTest, test_InitFromCheckpoint) {
+    // 检查点: revision=5, logicalPoolId(1):1024
+    // (5, 10]之间logicalPoolId(1)新建了一个segment
+    PageFileSegment segment;
+    segment.set_segmentsize(1 << 30);
+    segment.set_logicalpoolid(1);
+    segment.set_chunksize(16*1024*1024);
+    segment.set_startoffset(0);
+    std::string encodeSegment;
+    ASSERT_TRUE(
+        NameSpaceStorageCodec::EncodeSegment(segment, &encodeSegment));
+    std::vector<KVChange> changes(1);
+    changes[0].type = OpType::OpPut;
+    changes[0].value = encodeSegment;
+    changes[0].revision = 8;
+
+    EXPECT_CALL(*mockEtcdClient_, GetCurrentRevision(_))
+        .WillOnce(DoAll(SetArgPointee<0>(10), Return(EtcdErrCode::EtcdOK)));
+    EXPECT_CALL(*mockEtcdClient_, List(
+        SEGMENTALLOCSIZEKEY, SEGMENTALLOCSIZEKEYEND, _))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+    EXPECT_CALL(*mockEtcdClient_, Get(SEGMENTALLOCCHECKPOINTKEY, _))
+        .WillOnce(DoAll(SetArgPointee<1>(std::string("5|1_1024")),
+                        Return(EtcdErrCode::EtcdOK)));
+    EXPECT_CALL(*mockEtcdClient_, ListChanges(
+        SEGMENTINFOKEYPREFIX, SEGMENTINFOKEYEND, 5, 10, _))
+        .WillOnce(DoAll(SetArgPointee<4>(changes),
+                        Return(EtcdErrCode::EtcdOK)));
+    ASSERT_EQ(0, allocStatistic_->Init());
+
+    // 1. 回放之后直接可以获取到当前的分配量
+    int64_t alloc;
+    ASSERT_TRUE(allocStatistic_->GetAllocByLogicalPool(1, &alloc));
+    ASSERT_EQ(1024 + (1L << 30), alloc);
+
+    // 2. 检查点之后的变化不计入当前检查点, 计入下一个检查点
+    allocStatistic_->AllocSpace(1, 1024, 11);
+    ASSERT_TRUE(allocStatistic_->GetAllocByLogicalPool(1, &alloc));
+    ASSERT_EQ(2048 + (1L << 30), alloc);
+
+    EXPECT_CALL(*mockEtcdClient_, ListWithLimitAndRevision(_, _, _, _, _, _))
+        .Times(0);
+    EXPECT_CALL(*mockEtcdClient_, Put(
+        NameSpaceStorageCodec::EncodeSegmentAllocKey(1),
+        NameSpaceStorageCodec::EncodeSegmentAllocValue(
+            1, 2048 + (1L << 30))))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+    EXPECT_CALL(*mockEtcdClient_, PutRewithRevision(SEGMENTALLOCCHECKPOINTKEY,
+        NameSpaceStorageCodec::EncodeSegmentAllocCheckpoint(
+            10, {{1, 1024 + (1L << 30)}}), _))
+        .WillOnce(DoAll(SetArgPointee<2>(12), Return(EtcdErrCode::EtcdOK)));
+    EXPECT_CALL(*mockEtcdClient_, PutRewithRevision(SEGMENTALLOCCHECKPOINTKEY,
+        NameSpaceStorageCodec::EncodeSegmentAllocCheckpoint(
+            12, {{1, 2048 + (1L << 30)}}), _))
+        .WillRepeatedly(
+            DoAll(SetArgPointee<2>(12), Return(EtcdErrCode::EtcdOK)));
+    allocStatistic_->Run();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    allocStatistic_->Stop();
+}
+
 }  // namespace mds
 }  // namespace curve
@@ -0,0 +1,191 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include <gtest/gtest.h>
+#include "src/mds/nameserver2/allocstatistic/file_alloc_statistic.h"
+
+namespace curve {
+namespace mds {
+
+const uint64_t kSegmentSize = 1ULL * 1024 * 1024 * 1024;
+
+TEST(FileAllocStatisticTest, test_FileAlloc) {
+    FileAllocStatistic statistic;
+    AllocatedSize allocSize;
+
+    // 1. 未加载的文件获取失败，更新也不生效
+    ASSERT_FALSE(statistic.GetFileAlloc(10, &allocSize));
+    statistic.AllocSpace(10, ROOTINODEID, 1, kSegmentSize);
+    ASSERT_FALSE(statistic.GetFileAlloc(10, &allocSize));
+
+    // 2. 加载之后增量更新
+    AllocatedSize loaded;
+    loaded.total = 2 * kSegmentSize;
+    loaded.allocSizeMap[1] = 2 * kSegmentSize;
+    statistic.LoadFileAlloc(10, loaded);
+    statistic.AllocSpace(10, ROOTINODEID, 2, kSegmentSize);
+    ASSERT_TRUE(statistic.GetFileAlloc(10, &allocSize));
+    ASSERT_EQ(3 * kSegmentSize, allocSize.total);
+    ASSERT_EQ(2 * kSegmentSize, allocSize.allocSizeMap[1]);
+    ASSERT_EQ(kSegmentSize, allocSize.allocSizeMap[2]);
+
+    statistic.DeAllocSpace(10, ROOTINODEID, 2, kSegmentSize);
+    ASSERT_TRUE(statistic.GetFileAlloc(10, &allocSize));
+    ASSERT_EQ(2 * kSegmentSize, allocSize.total);
+    ASSERT_EQ(1, allocSize.allocSizeMap.size());
+
+    // 3. 删除文件
+    statistic.RemoveFile(10);
+    ASSERT_FALSE(statistic.GetFileAlloc(10, &allocSize));
+}
+
+TEST(FileAllocStatisticTest, test_DirAlloc) {
+    FileAllocStatistic statistic;
+    AllocatedSize allocSize;
+    AllocatedSize dirSize;
+    dirSize.total = kSegmentSize;
+    dirSize.allocSizeMap[1] = kSegmentSize;
+
+    // 1. 缓存根目录和子目录/dir(id = 20)
+    uint64_t version = statistic.GetDirVersion();
+    statistic.PutDirAlloc(20, ROOTINODEID, dirSize, version);
+    statistic.PutDirAlloc(ROOTINODEID, ROOTINODEID, dirSize, version);
+    ASSERT_TRUE(statistic.GetDirAlloc(20, &allocSize));
+    ASSERT_TRUE(statistic.GetDirAlloc(ROOTINODEID, &allocSize));
+
+    // 2. /dir下的文件分配segment，更新到各级目录
+    statistic.AllocSpace(30, 20, 1, kSegmentSize);
+    ASSERT_TRUE(statistic.GetDirAlloc(20, &allocSize));
+    ASSERT_EQ(2 * kSegmentSize, allocSize.total);
+    ASSERT_TRUE(statistic.GetDirAlloc(ROOTINODEID, &allocSize));
+    ASSERT_EQ(2 * kSegmentSize, allocSize.total);
+    ASSERT_EQ(2 * kSegmentSize, allocSize.allocSizeMap[1]);
+
+    // 3. 未缓存目录下的文件分配segment，正在计算的目录结果不缓存
+    version = statistic.GetDirVersion();
+    statistic.AllocSpace(31, 21, 1, kSegmentSize);
+    statistic.PutDirAlloc(21, ROOTINODEID, dirSize, version);
+    ASSERT_FALSE(statistic.GetDirAlloc(21, &allocSize));
+
+    // 4. 目录结构变化，该目录及其各级父目录失效
+    version = statistic.GetDirVersion();
+    statistic.InvalidateDir(20);
+    ASSERT_FALSE(statistic.GetDirAlloc(20, &allocSize));
+    ASSERT_FALSE(statistic.GetDirAlloc(ROOTINODEID, &allocSize));
+    statistic.PutDirAlloc(20, ROOTINODEID, dirSize, version);
+    ASSERT_FALSE(statistic.GetDirAlloc(20, &allocSize));
+}
+
+TEST(FileAllocStatisticTest, test_InvalidateDir) {
+    FileAllocStatistic statistic;
+    AllocatedSize allocSize;
+    AllocatedSize dirSize;
+    dirSize.total = kSegmentSize;
+    dirSize.allocSizeMap[1] = kSegmentSize;
+
+    // 缓存 /, /a(20), /a/b(21), /a/b/c(22), /d(23)
+    uint64_t version = statistic.GetDirVersion();
+    statistic.PutDirAlloc(22, 21, dirSize, version);
+    statistic.PutDirAlloc(21, 20, dirSize, version);
+    statistic.PutDirAlloc(20, ROOTINODEID, dirSize, version);
+    statistic.PutDirAlloc(23, ROOTINODEID, dirSize, version);
+    statistic.PutDirAlloc(ROOTINODEID, ROOTINODEID, dirSize, version);
+
+    // 1. /a/b变化，/a/b及其上各级目录失效，子目录和其他分支仍然缓存
+    statistic.InvalidateDir(21);
+    ASSERT_FALSE(statistic.GetDirAlloc(21, &allocSize));
+    ASSERT_FALSE(statistic.GetDirAlloc(20, &allocSize));
+    ASSERT_FALSE(statistic.GetDirAlloc(ROOTINODEID, &allocSize));
+    ASSERT_TRUE(statistic.GetDirAlloc(22, &allocSize));
+    ASSERT_TRUE(statistic.GetDirAlloc(23, &allocSize));
+    ASSERT_NE(version, statistic.GetDirVersion());
+
+    // 2. 失效目录下的分配更新到第一个未缓存的目录为止
+    statistic.AllocSpace(30, 22, 1, kSegmentSize);
+    ASSERT_TRUE(statistic.GetDirAlloc(22, &allocSize));
+    ASSERT_EQ(2 * kSegmentSize, allocSize.total);
+    ASSERT_FALSE(statistic.GetDirAlloc(21, &allocSize));
+
+    // 3. 未缓存的目录失效，不影响已缓存的目录
+    statistic.InvalidateDir(24);
+    ASSERT_TRUE(statistic.GetDirAlloc(22, &allocSize));
+    ASSERT_TRUE(statistic.GetDirAlloc(23, &allocSize));
+}
+
+TEST(FileAllocStatisticTest, test_AddDir) {
+    FileAllocStatistic statistic;
+    AllocatedSize allocSize;
+    AllocatedSize dirSize;
+    dirSize.total = kSegmentSize;
+    dirSize.allocSizeMap[1] = kSegmentSize;
+
+    // 1. 父目录未缓存时新目录不缓存，正在计算的目录结果不缓存
+    uint64_t version = statistic.GetDirVersion();
+    statistic.AddDir(21, 20);
+    ASSERT_FALSE(statistic.GetDirAlloc(21, &allocSize));
+    statistic.PutDirAlloc(20, ROOTINODEID, dirSize, version);
+    ASSERT_FALSE(statistic.GetDirAlloc(20, &allocSize));
+
+    // 2. 父目录已缓存时新目录以0缓存，新目录下的分配更新到父目录
+    version = statistic.GetDirVersion();
+    statistic.PutDirAlloc(20, ROOTINODEID, dirSize, version);
+    statistic.AddDir(21, 20);
+    ASSERT_TRUE(statistic.GetDirAlloc(21, &allocSize));
+    ASSERT_EQ(0, allocSize.total);
+    statistic.AllocSpace(30, 21, 1, kSegmentSize);
+    ASSERT_TRUE(statistic.GetDirAlloc(21, &allocSize));
+    ASSERT_EQ(kSegmentSize, allocSize.total);
+    ASSERT_TRUE(statistic.GetDirAlloc(20, &allocSize));
+    ASSERT_EQ(2 * kSegmentSize, allocSize.total);
+}
+
+TEST(FileAllocStatisticTest, test_Limit) {
+    FileAllocStatistic statistic(2, 2);
+    AllocatedSize allocSize;
+    AllocatedSize size;
+    size.total = kSegmentSize;
+    size.allocSizeMap[1] = kSegmentSize;
+
+    // 1. 文件数量达到上限时淘汰一个文件
+    statistic.LoadFileAlloc(10, size);
+    statistic.LoadFileAlloc(11, size);
+    statistic.LoadFileAlloc(11, size);
+    ASSERT_TRUE(statistic.GetFileAlloc(10, &allocSize));
+    statistic.LoadFileAlloc(12, size);
+    ASSERT_TRUE(statistic.GetFileAlloc(12, &allocSize));
+    int loaded = statistic.GetFileAlloc(10, &allocSize) +
+                 statistic.GetFileAlloc(11, &allocSize);
+    ASSERT_EQ(1, loaded);
+
+    // 2. 目录数量达到上限时清空目录缓存
+    uint64_t version = statistic.GetDirVersion();
+    statistic.PutDirAlloc(20, ROOTINODEID, size, version);
+    statistic.AddDir(21, 20);
+    ASSERT_TRUE(statistic.GetDirAlloc(21, &allocSize));
+    statistic.AddDir(22, 20);
+    ASSERT_FALSE(statistic.GetDirAlloc(20, &allocSize));
+    ASSERT_FALSE(statistic.GetDirAlloc(21, &allocSize));
+    ASSERT_FALSE(statistic.GetDirAlloc(22, &allocSize));
+    ASSERT_NE(version, statistic.GetDirVersion());
+}
+
+}  // namespace mds
+}  // namespace curve
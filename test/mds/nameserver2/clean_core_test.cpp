@@ -28,11 +28,18 @@
 #include "test/mds/mock/mock_topology.h"
 #include "src/mds/chunkserverclient/copyset_client.h"
 #include "test/mds/mock/mock_alloc_statistic.h"
+#include "test/mds/chunkserverclient/mock_chunkserverclient.h"
 
 using ::testing::_;
 using ::testing::Return;
+using ::testing::DoAll;
+using ::testing::SetArgPointee;
+using ::testing::SaveArg;
+using ::testing::Invoke;
 using curve::mds::topology::MockTopology;
+using ::curve::mds::topology::CopySetInfo;
 using ::curve::mds::chunkserverclient::ChunkServerClientOption;
+using ::curve::mds::chunkserverclient::MockChunkServerClient;
 
 namespace curve {
 namespace mds {
@@ -249,10 +256,18 @@ TEST(CleanCore, testcleanfile) {
     }
     {
         // get segment ok, DeleteSnapShotChunk ok, DeleteSegment error
+        // 每轮先读取一批segment，再删除其中的chunk和segment
+        uint32_t segmentNum = kMiniFileLength / DefaultSegmentSize;
         EXPECT_CALL(*storage, GetSegment(_, 0, _))
                 .WillOnce(Return(StoreStatus::OK));
+        for (uint32_t i = 1; i < segmentNum; i++) {
+            EXPECT_CALL(*storage, GetSegment(_, i * DefaultSegmentSize, _))
+            .WillOnce(Return(StoreStatus::KeyNotExist));
+        }
 
-        EXPECT_CALL(*storage, DeleteSegment(_, _, _))
+        EXPECT_CALL(*storage, GetFileAlloc(_, _))
+        .WillOnce(Return(StoreStatus::OK));
+        EXPECT_CALL(*storage, DeleteSegment(_, _, _, _))
         .WillOnce(Return(StoreStatus::InternalError));
 
         FileInfo cleanFile;
@@ -264,5 +279,164 @@ TEST(CleanCore, testcleanfile) {
         ASSERT_EQ(progress.GetStatus(), TaskStatus::FAILED);
     }
 }
+
+TEST(CleanCore, testcleanfilebatchdelete) {
+    auto storage = std::make_shared<MockNameServerStorage>();
+    auto topology = std::make_shared<MockTopology>();
+    ChunkServerClientOption option;
+    auto channelPool = std::make_shared<ChannelPool>();
+    auto client = std::make_shared<CopysetClient>(topology,
+                                                    option, channelPool);
+    auto csClient = std::make_shared<MockChunkServerClient>(topology,
+                                                    option, channelPool);
+    client->SetChunkServerClient(csClient);
+    auto allocStatistic = std::make_shared<MockAllocStatistic>();
+    CleanCoreOption cleanOption;
+    cleanOption.deleteChunkConcurrency = 4;
+    auto cleanCore = std::make_shared<CleanCore>(storage,
+                                    client, allocStatistic, cleanOption);
+
+    // 每个segment的chunk分布在两个复制组
+    PageFileSegment segment;
+    segment.set_logicalpoolid(1);
+    segment.set_segmentsize(DefaultSegmentSize);
+    segment.set_chunksize(16 * kMB);
+    segment.set_startoffset(0);
+    for (uint32_t i = 0; i < 4; i++) {
+        PageFileChunkInfo *chunk = segment.add_chunks();
+        chunk->set_chunkid(i);
+        chunk->set_copysetid(i % 2 + 1);
+    }
+    uint32_t segmentNum = kMiniFileLength / DefaultSegmentSize;
+
+    CopySetInfo copyset(1, 1);
+    copyset.SetLeader(1);
+
+    {
+        // 同一复制组的chunk合并删除，每个复制组只查询一次copyset
+        for (uint32_t i = 0; i < segmentNum; i++) {
+            EXPECT_CALL(*storage, GetSegment(_, i * DefaultSegmentSize, _))
+                .WillOnce(DoAll(SetArgPointee<2>(segment),
+                                Return(StoreStatus::OK)));
+        }
+        EXPECT_CALL(*topology, GetCopySet(_, _))
+            .Times(2)
+            .WillRepeatedly(DoAll(SetArgPointee<1>(copyset),
+                                  Return(true)));
+        EXPECT_CALL(*csClient, DeleteChunk(1, 1, _, _, _))
+            .Times(4 * segmentNum)
+            .WillRepeatedly(Return(kMdsSuccess));
+        // 文件的分配量随segment的删除一起持久化，最后减为0
+        AllocatedSize fileAlloc;
+        fileAlloc.total = segmentNum * DefaultSegmentSize;
+        fileAlloc.allocSizeMap[1] = segmentNum * DefaultSegmentSize;
+        EXPECT_CALL(*storage, GetFileAlloc(_, _))
+            .WillOnce(DoAll(SetArgPointee<1>(fileAlloc),
+                            Return(StoreStatus::OK)));
+        AllocatedSize lastAlloc;
+        EXPECT_CALL(*storage, DeleteSegment(_, _, _, _))
+            .Times(segmentNum)
+            .WillRepeatedly(DoAll(SaveArg<2>(&lastAlloc),
+                                  Return(StoreStatus::OK)));
+        EXPECT_CALL(*allocStatistic, DeAllocSpace(_, _, _))
+            .Times(segmentNum);
+        EXPECT_CALL(*storage, DeleteFile(_, _))
+            .WillOnce(Return(StoreStatus::OK));
+
+        FileInfo cleanFile;
+        cleanFile.set_length(kMiniFileLength);
+        cleanFile.set_segmentsize(DefaultSegmentSize);
+        TaskProgress progress;
+        ASSERT_EQ(cleanCore->CleanFile(cleanFile, &progress),
+            StatusCode::kOK);
+        ASSERT_EQ(progress.GetStatus(), TaskStatus::SUCCESS);
+        ASSERT_EQ(progress.GetProgress(), 100);
+        ASSERT_EQ(0, lastAlloc.total);
+        ASSERT_TRUE(lastAlloc.allocSizeMap.empty());
+    }
+
+    {
+        // 删除chunk失败，segment不会被删除
+        for (uint32_t i = 0; i < segmentNum; i++) {
+            EXPECT_CALL(*storage, GetSegment(_, i * DefaultSegmentSize, _))
+                .WillOnce(DoAll(SetArgPointee<2>(segment),
+                                Return(StoreStatus::OK)));
+        }
+        EXPECT_CALL(*topology, GetCopySet(_, _))
+            .WillRepeatedly(DoAll(SetArgPointee<1>(copyset),
+                                  Return(true)));
+        EXPECT_CALL(*csClient, DeleteChunk(_, _, _, _, _))
+            .WillRepeatedly(Return(kMdsFail));
+        EXPECT_CALL(*storage, DeleteSegment(_, _, _, _))
+            .Times(0);
+
+        FileInfo cleanFile;
+        cleanFile.set_length(kMiniFileLength);
+        cleanFile.set_segmentsize(DefaultSegmentSize);
+        TaskProgress progress;
+        ASSERT_EQ(cleanCore->CleanFile(cleanFile, &progress),
+            StatusCode::kCommonFileDeleteError);
+        ASSERT_EQ(progress.GetStatus(), TaskStatus::FAILED);
+    }
+}
+
+TEST(CleanCore, testcleansnapshotfilebatchdelete) {
+    auto storage = std::make_shared<MockNameServerStorage>();
+    auto topology = std::make_shared<MockTopology>();
+    ChunkServerClientOption option;
+    auto channelPool = std::make_shared<ChannelPool>();
+    auto client = std::make_shared<CopysetClient>(topology,
+                                                    option, channelPool);
+    auto csClient = std::make_shared<MockChunkServerClient>(topology,
+                                                    option, channelPool);
+    client->SetChunkServerClient(csClient);
+    auto allocStatistic = std::make_shared<MockAllocStatistic>();
+    CleanCoreOption cleanOption;
+    cleanOption.deleteChunkConcurrency = 4;
+    cleanOption.deleteChunkLimitPerSecond = 1000;
+    auto cleanCore = std::make_shared<CleanCore>(storage,
+                                    client, allocStatistic, cleanOption);
+
+    PageFileSegment segment;
+    segment.set_logicalpoolid(1);
+    segment.set_segmentsize(DefaultSegmentSize);
+    segment.set_chunksize(16 * kMB);
+    segment.set_startoffset(0);
+    for (uint32_t i = 0; i < 4; i++) {
+        PageFileChunkInfo *chunk = segment.add_chunks();
+        chunk->set_chunkid(i);
+        chunk->set_copysetid(i + 1);
+    }
+    uint32_t segmentNum = kMiniFileLength / DefaultSegmentSize;
+
+    CopySetInfo copyset(1, 1);
+    copyset.SetLeader(1);
+
+    // 快照删除使用快照版本号+1修正chunk的correctedSn
+    for (uint32_t i = 0; i < segmentNum; i++) {
+        EXPECT_CALL(*storage, GetSegment(_, i * DefaultSegmentSize, _))
+            .WillOnce(DoAll(SetArgPointee<2>(segment),
+                            Return(StoreStatus::OK)));
+    }
+    EXPECT_CALL(*topology, GetCopySet(_, _))
+        .Times(4)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copyset),
+                              Return(true)));
+    EXPECT_CALL(*csClient, DeleteChunkSnapshotOrCorrectSn(1, 1, _, _, 2))
+        .Times(4 * segmentNum)
+        .WillRepeatedly(Return(kMdsSuccess));
+    EXPECT_CALL(*storage, DeleteSnapshotFile(_, _))
+        .WillOnce(Return(StoreStatus::OK));
+
+    FileInfo cleanFile;
+    cleanFile.set_length(kMiniFileLength);
+    cleanFile.set_segmentsize(DefaultSegmentSize);
+    cleanFile.set_seqnum(1);
+    TaskProgress progress;
+    ASSERT_EQ(cleanCore->CleanSnapShotFile(cleanFile, &progress),
+        StatusCode::kOK);
+    ASSERT_EQ(progress.GetStatus(), TaskStatus::SUCCESS);
+    ASSERT_EQ(progress.GetProgress(), 100);
+}
 }  // namespace mds
 }  // namespace curve
@@ -43,6 +43,7 @@ using ::testing::Return;
 using ::testing::ReturnArg;
 using ::testing::DoAll;
 using ::testing::SetArgPointee;
+using ::testing::SaveArg;
 using curve::common::Authenticator;
 
 using curve::common::TimeUtility;
@@ -275,6 +276,90 @@ TEST_F(CurveFSTest, testGetFileInfo) {
     }
 }
 
+TEST_F(CurveFSTest, testWalkPathWithDentryCache) {
+    // 开启目录路径缓存重新初始化
+    curvefs_->Uninit();
+    FileInfo recycleBinInfo;
+    recycleBinInfo.set_parentid(ROOTINODEID);
+    recycleBinInfo.set_id(RECYCLEBININODEID);
+    recycleBinInfo.set_filename(RECYCLEBINDIRNAME);
+    recycleBinInfo.set_filetype(FileType::INODE_DIRECTORY);
+    recycleBinInfo.set_owner(authOptions_.rootOwner);
+    EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(recycleBinInfo),
+            Return(StoreStatus::OK)));
+    curveFSOptions_.dentryCacheSize = 100;
+    curvefs_->Init(storage_, inodeIdGenerator_, mockChunkAllocator_,
+                    mockcleanManager_,
+                    fileRecordManager_,
+                    allocStatistic_,
+                    curveFSOptions_,
+                    topology_);
+
+    FileInfo dirInfo;
+    dirInfo.set_id(10);
+    dirInfo.set_parentid(ROOTINODEID);
+    dirInfo.set_filename("dir1");
+    dirInfo.set_filetype(FileType::INODE_DIRECTORY);
+    FileInfo fileInfo;
+    fileInfo.set_id(11);
+    fileInfo.set_parentid(10);
+    fileInfo.set_filename("file1");
+    fileInfo.set_filetype(FileType::INODE_PAGEFILE);
+
+    // 1. 第一次逐级查找，并缓存父目录
+    {
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir1", _))
+            .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+                Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, GetFile(10, "file1", _))
+            .WillOnce(DoAll(SetArgPointee<2>(fileInfo),
+                Return(StoreStatus::OK)));
+        FileInfo retInfo;
+        ASSERT_EQ(StatusCode::kOK,
+            curvefs_->GetFileInfo("/dir1/file1", &retInfo));
+        ASSERT_EQ(11, retInfo.id());
+    }
+
+    // 2. 父目录命中缓存，只查找文件
+    {
+        EXPECT_CALL(*storage_, GetFile(10, "file1", _))
+            .Times(2)
+            .WillRepeatedly(DoAll(SetArgPointee<2>(fileInfo),
+                Return(StoreStatus::OK)));
+        FileInfo retInfo;
+        ASSERT_EQ(StatusCode::kOK,
+            curvefs_->GetFileInfo("/dir1/file1", &retInfo));
+        ASSERT_EQ(11, retInfo.id());
+        ASSERT_EQ(StatusCode::kOK,
+            curvefs_->GetFileInfo("//dir1//file1", &retInfo));
+        ASSERT_EQ(11, retInfo.id());
+    }
+
+    // 3. 删除目录之后缓存失效
+    {
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir1", _))
+            .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+                Return(StoreStatus::OK)));
+        std::vector<FileInfo> fileInfoList;
+        EXPECT_CALL(*storage_, ListFile(_, _, _))
+            .WillOnce(DoAll(SetArgPointee<2>(fileInfoList),
+                Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, DeleteFile(ROOTINODEID, "dir1"))
+            .WillOnce(Return(StoreStatus::OK));
+        ASSERT_EQ(StatusCode::kOK,
+            curvefs_->DeleteFile("/dir1", kUnitializedFileID, false));
+
+        EXPECT_CALL(*storage_, GetFile(ROOTINODEID, "dir1", _))
+            .WillOnce(Return(StoreStatus::KeyNotExist));
+        FileInfo retInfo;
+        ASSERT_EQ(StatusCode::kFileNotExists,
+            curvefs_->GetFileInfo("/dir1/file1", &retInfo));
+    }
+
+    curveFSOptions_.dentryCacheSize = 0;
+}
+
 TEST_F(CurveFSTest, testDeleteFile) {
     // test remove root
     ASSERT_EQ(curvefs_->DeleteFile("/", kUnitializedFileID, false),
@@ -583,21 +668,13 @@ TEST_F(CurveFSTest, testGetAllocatedSize) {
     AllocatedSize allocSize;
     FileInfo  fileInfo;
     uint64_t segmentSize = 1 * 1024 * 1024 * 1024ul;
-    fileInfo.set_id(0);
+    fileInfo.set_id(10);
     fileInfo.set_filetype(FileType::INODE_PAGEFILE);
     fileInfo.set_segmentsize(segmentSize);
-    std::vector<PageFileSegment> segments;
-    PageFileSegment segment;
-    for (int i = 0; i < 2; ++i) {
-        segment.set_logicalpoolid(1);
-        segment.set_segmentsize(segmentSize);
-        segment.set_chunksize(curvefs_->GetDefaultChunkSize());
-        segment.set_startoffset(i);
-        segments.emplace_back(segment);
-    }
-    segment.set_logicalpoolid(2);
-    segments.emplace_back(segment);
-
+    // 逻辑池1分配了2个segment，逻辑池2分配了1个segment
+    AllocatedSize fileAlloc;
+    fileAlloc.total = 3 * segmentSize;
+    fileAlloc.allocSizeMap = {{1, 2 * segmentSize}, {2, segmentSize}};
 
     // test page file normal
     {
@@ -605,10 +682,25 @@ TEST_F(CurveFSTest, testGetAllocatedSize) {
         .Times(1)
         .WillOnce(DoAll(SetArgPointee<2>(fileInfo),
             Return(StoreStatus::OK)));
-        EXPECT_CALL(*storage_, ListSegment(_, _))
+        EXPECT_CALL(*storage_, GetFileAlloc(_, _))
+        .Times(1)
+        .WillOnce(DoAll(SetArgPointee<1>(fileAlloc),
+            Return(StoreStatus::OK)));
+        ASSERT_EQ(StatusCode::kOK,
+                    curvefs_->GetAllocatedSize("/tests", &allocSize));
+        ASSERT_EQ(3 * segmentSize, allocSize.total);
+        std::unordered_map<PoolIdType, uint64_t> expected =
+                        {{1, 2 * segmentSize}, {2, segmentSize}};
+        ASSERT_EQ(expected, allocSize.allocSizeMap);
+    }
+    // test page file loaded, get from memory
+    {
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
         .Times(1)
-        .WillOnce(DoAll(SetArgPointee<1>(segments),
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo),
             Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, GetFileAlloc(_, _))
+        .Times(0);
         ASSERT_EQ(StatusCode::kOK,
                     curvefs_->GetAllocatedSize("/tests", &allocSize));
         ASSERT_EQ(3 * segmentSize, allocSize.total);
@@ -617,11 +709,13 @@ TEST_F(CurveFSTest, testGetAllocatedSize) {
         ASSERT_EQ(expected, allocSize.allocSizeMap);
     }
     // test directory normal
+    FileInfo dirInfo;
+    dirInfo.set_id(20);
+    dirInfo.set_filetype(FileType::INODE_DIRECTORY);
     {
-        FileInfo dirInfo;
-        dirInfo.set_filetype(FileType::INODE_DIRECTORY);
         std::vector<FileInfo> files;
         for (int i = 0; i < 3; ++i) {
+            fileInfo.set_id(11 + i);
             files.emplace_back(fileInfo);
         }
         EXPECT_CALL(*storage_, GetFile(_, _, _))
@@ -632,15 +726,30 @@ TEST_F(CurveFSTest, testGetAllocatedSize) {
         .Times(1)
         .WillOnce(DoAll(SetArgPointee<2>(files),
                         Return(StoreStatus::OK)));
-        EXPECT_CALL(*storage_, ListSegment(_, _))
+        EXPECT_CALL(*storage_, GetFileAlloc(_, _))
         .Times(3)
-        .WillRepeatedly(DoAll(SetArgPointee<1>(segments),
+        .WillRepeatedly(DoAll(SetArgPointee<1>(fileAlloc),
             Return(StoreStatus::OK)));
         ASSERT_EQ(StatusCode::kOK,
                     curvefs_->GetAllocatedSize("/tests", &allocSize));
         ASSERT_EQ(9 * segmentSize, allocSize.total);
         std::unordered_map<PoolIdType, uint64_t> expected =
                         {{1, 6 * segmentSize}, {2, 3 * segmentSize}};
+        ASSERT_EQ(expected, allocSize.allocSizeMap);
+    }
+    // test directory cached, get from memory
+    {
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(1)
+        .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListFile(_, _, _))
+        .Times(0);
+        EXPECT_CALL(*storage_, GetFileAlloc(_, _))
+        .Times(0);
+        ASSERT_EQ(StatusCode::kOK,
+                    curvefs_->GetAllocatedSize("/tests", &allocSize));
+        ASSERT_EQ(9 * segmentSize, allocSize.total);
     }
     // test GetFile fail
     {
@@ -661,13 +770,14 @@ TEST_F(CurveFSTest, testGetAllocatedSize) {
         ASSERT_EQ(StatusCode::kNotSupported,
                     curvefs_->GetAllocatedSize("/tests", &allocSize));
     }
-    // test list segment fail
+    // test get file alloc fail
     {
+        fileInfo.set_id(14);
         EXPECT_CALL(*storage_, GetFile(_, _, _))
         .Times(1)
         .WillOnce(DoAll(SetArgPointee<2>(fileInfo),
             Return(StoreStatus::OK)));
-        EXPECT_CALL(*storage_, ListSegment(_, _))
+        EXPECT_CALL(*storage_, GetFileAlloc(_, _))
         .Times(1)
         .WillOnce(Return(StoreStatus::InternalError));
         ASSERT_EQ(StatusCode::kStorageError,
@@ -675,8 +785,7 @@ TEST_F(CurveFSTest, testGetAllocatedSize) {
     }
     // test list directory fail
     {
-        FileInfo dirInfo;
-        dirInfo.set_filetype(FileType::INODE_DIRECTORY);
+        dirInfo.set_id(21);
         EXPECT_CALL(*storage_, GetFile(_, _, _))
         .Times(2)
         .WillRepeatedly(DoAll(SetArgPointee<2>(dirInfo),
@@ -689,6 +798,55 @@ TEST_F(CurveFSTest, testGetAllocatedSize) {
     }
 }
 
+TEST_F(CurveFSTest, testGetAllocatedSizeAfterMkdirUnderCachedDir) {
+    AllocatedSize allocSize;
+    uint64_t segmentSize = 1 * 1024 * 1024 * 1024ul;
+    FileInfo dirInfo;
+    dirInfo.set_id(20);
+    dirInfo.set_parentid(ROOTINODEID);
+    dirInfo.set_filetype(FileType::INODE_DIRECTORY);
+
+    // 1. 缓存空目录/tests
+    {
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<2>(dirInfo),
+            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListFile(_, _, _))
+        .WillOnce(Return(StoreStatus::OK));
+        ASSERT_EQ(StatusCode::kOK,
+                    curvefs_->GetAllocatedSize("/tests", &allocSize));
+        ASSERT_EQ(0, allocSize.total);
+    }
+    // 2. 在/tests下新建目录/tests/sub
+    {
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+            Return(StoreStatus::OK)))
+        .WillOnce(Return(StoreStatus::KeyNotExist));
+        EXPECT_CALL(*inodeIdGenerator_, GenInodeID(_))
+        .WillOnce(DoAll(SetArgPointee<0>(30), Return(true)));
+        EXPECT_CALL(*storage_, PutFile(_))
+        .WillOnce(Return(StoreStatus::OK));
+        ASSERT_EQ(StatusCode::kOK, curvefs_->CreateFile("/tests/sub",
+            "owner1", FileType::INODE_DIRECTORY, 0));
+    }
+    // 3. /tests/sub下的文件分配segment，更新到已缓存的/tests
+    allocStatistic_->GetFileAllocStatistic()->AllocSpace(
+        40, 30, 1, segmentSize);
+    {
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, ListFile(_, _, _))
+        .Times(0);
+        ASSERT_EQ(StatusCode::kOK,
+                    curvefs_->GetAllocatedSize("/tests", &allocSize));
+        ASSERT_EQ(segmentSize, allocSize.total);
+        ASSERT_EQ(segmentSize, allocSize.allocSizeMap[1]);
+    }
+}
+
 TEST_F(CurveFSTest, testGetFileSize) {
     uint64_t fileSize;
     FileInfo  fileInfo;
@@ -1464,6 +1622,91 @@ TEST_F(CurveFSTest, testChangeOwner) {
     }
 }
 
+TEST_F(CurveFSTest, testUpdateFileThrottleParams) {
+    FileThrottleParams params;
+    ThrottleParams *item = params.add_throttleparams();
+    item->set_type(ThrottleType::IOPS_READ);
+    item->set_limit(1000);
+    item = params.add_throttleparams();
+    item->set_type(ThrottleType::BPS_WRITE);
+    item->set_limit(100 * 1024 * 1024);
+    item->set_burst(200 * 1024 * 1024);
+
+    // 设置QoS限制
+    {
+        FileInfo fileInfo1;
+        fileInfo1.set_filetype(FileType::INODE_PAGEFILE);
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                        Return(StoreStatus::OK)));
+        FileInfo putInfo;
+        EXPECT_CALL(*storage_, PutFile(_))
+        .WillOnce(DoAll(SaveArg<0>(&putInfo),
+                        Return(StoreStatus::OK)));
+
+        ASSERT_EQ(StatusCode::kOK,
+                  curvefs_->UpdateFileThrottleParams("/file1", params));
+        ASSERT_TRUE(putInfo.has_throttleparams());
+        ASSERT_EQ(params.SerializeAsString(),
+                  putInfo.throttleparams().SerializeAsString());
+    }
+
+    // 清除QoS限制
+    {
+        FileInfo fileInfo1;
+        fileInfo1.set_filetype(FileType::INODE_PAGEFILE);
+        fileInfo1.mutable_throttleparams()->CopyFrom(params);
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                        Return(StoreStatus::OK)));
+        FileInfo putInfo;
+        EXPECT_CALL(*storage_, PutFile(_))
+        .WillOnce(DoAll(SaveArg<0>(&putInfo),
+                        Return(StoreStatus::OK)));
+
+        ASSERT_EQ(StatusCode::kOK, curvefs_->UpdateFileThrottleParams(
+            "/file1", FileThrottleParams()));
+        ASSERT_FALSE(putInfo.has_throttleparams());
+    }
+
+    // 目录不支持QoS限制
+    {
+        FileInfo dirInfo;
+        dirInfo.set_filetype(FileType::INODE_DIRECTORY);
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(dirInfo),
+                        Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, PutFile(_))
+        .Times(0);
+
+        ASSERT_EQ(StatusCode::kNotSupported,
+                  curvefs_->UpdateFileThrottleParams("/dir1", params));
+    }
+
+    // 文件不存在
+    {
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(Return(StoreStatus::KeyNotExist));
+
+        ASSERT_EQ(StatusCode::kFileNotExists,
+                  curvefs_->UpdateFileThrottleParams("/file1", params));
+    }
+
+    // 写入失败
+    {
+        FileInfo fileInfo1;
+        fileInfo1.set_filetype(FileType::INODE_PAGEFILE);
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                        Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, PutFile(_))
+        .WillOnce(Return(StoreStatus::InternalError));
+
+        ASSERT_EQ(StatusCode::kStorageError,
+                  curvefs_->UpdateFileThrottleParams("/file1", params));
+    }
+}
+
 TEST_F(CurveFSTest, testGetOrAllocateSegment) {
     // test normal get exist segment
     {
@@ -1516,17 +1759,27 @@ TEST_F(CurveFSTest, testGetOrAllocateSegment) {
         .WillOnce(Return(StoreStatus::KeyNotExist));
 
 
-        EXPECT_CALL(*mockChunkAllocator_, AllocateChunkSegment(_, _, _, _, _))
+        EXPECT_CALL(*storage_, GetFileAlloc(_, _))
         .Times(1)
-        .WillOnce(Return(true));
+        .WillOnce(Return(StoreStatus::OK));
 
+        PageFileSegment allocated;
+        allocated.set_logicalpoolid(1);
+        allocated.set_segmentsize(DefaultSegmentSize);
+        EXPECT_CALL(*mockChunkAllocator_, AllocateChunkSegment(_, _, _, _, _))
+        .Times(1)
+        .WillOnce(DoAll(SetArgPointee<4>(allocated), Return(true)));
 
-        EXPECT_CALL(*storage_, PutSegment(_, _, _, _))
+        // 文件的分配量随segment一起持久化
+        AllocatedSize fileAlloc;
+        EXPECT_CALL(*storage_, PutSegment(_, _, _, _, _))
         .Times(1)
-        .WillOnce(Return(StoreStatus::OK));
+        .WillOnce(DoAll(SaveArg<3>(&fileAlloc), Return(StoreStatus::OK)));
 
         ASSERT_EQ(curvefs_->GetOrAllocateSegment("/user1/file2",
                   0, true,  &segment), StatusCode::kOK);
+        ASSERT_EQ(DefaultSegmentSize, fileAlloc.total);
+        ASSERT_EQ(DefaultSegmentSize, fileAlloc.allocSizeMap[1]);
     }
 
     // file is a directory
@@ -1596,6 +1849,41 @@ TEST_F(CurveFSTest, testGetOrAllocateSegment) {
                   kMiniFileLength, false,  &segment), StatusCode::kParaError);
     }
 
+    // load file alloc fail
+    {
+        PageFileSegment segment;
+
+        FileInfo fileInfo1;
+        fileInfo1.set_filetype(FileType::INODE_DIRECTORY);
+
+        FileInfo fileInfo2;
+        fileInfo2.set_id(1);
+        fileInfo2.set_filetype(FileType::INODE_PAGEFILE);
+        fileInfo2.set_length(kMiniFileLength);
+        fileInfo2.set_segmentsize(DefaultSegmentSize);
+
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                        Return(StoreStatus::OK)))
+        .WillOnce(DoAll(SetArgPointee<2>(fileInfo2),
+                        Return(StoreStatus::OK)));
+
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+        .Times(1)
+        .WillOnce(Return(StoreStatus::KeyNotExist));
+
+        EXPECT_CALL(*storage_, GetFileAlloc(_, _))
+        .Times(1)
+        .WillOnce(Return(StoreStatus::InternalError));
+
+        EXPECT_CALL(*mockChunkAllocator_, AllocateChunkSegment(_, _, _, _, _))
+        .Times(0);
+
+        ASSERT_EQ(curvefs_->GetOrAllocateSegment("/user1/file2",
+                  0, true,  &segment), StatusCode::kStorageError);
+    }
+
     // alloc chunk segment fail
     {
         PageFileSegment segment;
@@ -1657,7 +1945,7 @@ TEST_F(CurveFSTest, testGetOrAllocateSegment) {
         .WillOnce(Return(true));
 
 
-        EXPECT_CALL(*storage_, PutSegment(_, _, _, _))
+        EXPECT_CALL(*storage_, PutSegment(_, _, _, _, _))
         .Times(1)
         .WillOnce(Return(StoreStatus::InternalError));
 
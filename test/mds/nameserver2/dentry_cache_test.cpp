@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include <gtest/gtest.h>
+#include "src/mds/nameserver2/dentry_cache.h"
+
+namespace curve {
+namespace mds {
+
+TEST(DentryCacheTest, test_PutGetRemove) {
+    DentryCache cache(2);
+    FileInfo fileInfo;
+
+    // 1. 未缓存
+    ASSERT_FALSE(cache.Get("/dir1", &fileInfo));
+
+    // 2. 缓存之后获取
+    FileInfo dirInfo;
+    dirInfo.set_id(1);
+    dirInfo.set_filename("dir1");
+    dirInfo.set_filetype(FileType::INODE_DIRECTORY);
+    cache.Put("/dir1", dirInfo);
+    ASSERT_TRUE(cache.Get("/dir1", &fileInfo));
+    ASSERT_EQ(1, fileInfo.id());
+
+    // 3. 重复缓存更新已有的项
+    dirInfo.set_owner("owner1");
+    cache.Put("/dir1", dirInfo);
+    ASSERT_TRUE(cache.Get("/dir1", &fileInfo));
+    ASSERT_EQ("owner1", fileInfo.owner());
+    ASSERT_EQ(1, cache.Size());
+
+    // 4. 超过最大数量时淘汰
+    dirInfo.set_id(2);
+    cache.Put("/dir1/dir2", dirInfo);
+    dirInfo.set_id(3);
+    cache.Put("/dir3", dirInfo);
+    ASSERT_EQ(2, cache.Size());
+    ASSERT_TRUE(cache.Get("/dir3", &fileInfo));
+    ASSERT_EQ(3, fileInfo.id());
+
+    // 5. 移除
+    cache.Remove("/dir3");
+    ASSERT_FALSE(cache.Get("/dir3", &fileInfo));
+    ASSERT_EQ(1, cache.Size());
+}
+
+TEST(DentryCacheTest, test_Disabled) {
+    DentryCache cache(0);
+    FileInfo fileInfo;
+    cache.Put("/dir1", fileInfo);
+    ASSERT_FALSE(cache.Get("/dir1", &fileInfo));
+    ASSERT_EQ(0, cache.Size());
+}
+
+}  // namespace mds
+}  // namespace curve
@@ -348,6 +348,7 @@ class FakeNameServerStorage : public NameServerStorage {
     StoreStatus PutSegment(InodeID id,
                            uint64_t off,
                            const PageFileSegment * segment,
+                           const AllocatedSize &fileAlloc,
                            int64_t *revision) override {
         std::lock_guard<std::mutex> guard(lock_);
         std::string storeKey =
@@ -356,11 +357,14 @@ class FakeNameServerStorage : public NameServerStorage {
         std::string value = segment->SerializeAsString();
         memKvMap_.insert(std::move(std::pair<std::string, std::string>
             (storeKey, std::move(value))));
+        fileAllocMap_[id] = fileAlloc;
         return StoreStatus::OK;
     }
 
-    StoreStatus DeleteSegment(
-        InodeID id, uint64_t off, int64_t *revision) override {
+    StoreStatus DeleteSegment(InodeID id,
+                              uint64_t off,
+                              const AllocatedSize &fileAlloc,
+                              int64_t *revision) override {
         std::lock_guard<std::mutex> guard(lock_);
         std::string storeKey =
             NameSpaceStorageCodec::EncodeSegmentStoreKey(id, off);
@@ -370,6 +374,22 @@ class FakeNameServerStorage : public NameServerStorage {
             return StoreStatus::KeyNotExist;
         }
         memKvMap_.erase(iter);
+        if (fileAlloc.total == 0) {
+            fileAllocMap_.erase(id);
+        } else {
+            fileAllocMap_[id] = fileAlloc;
+        }
+        return StoreStatus::OK;
+    }
+
+    StoreStatus GetFileAlloc(InodeID id, AllocatedSize *fileAlloc) override {
+        std::lock_guard<std::mutex> guard(lock_);
+        auto iter = fileAllocMap_.find(id);
+        if (iter == fileAllocMap_.end()) {
+            *fileAlloc = AllocatedSize();
+        } else {
+            *fileAlloc = iter->second;
+        }
         return StoreStatus::OK;
     }
 
@@ -414,6 +434,7 @@ class FakeNameServerStorage : public NameServerStorage {
  private:
     std::mutex lock_;
     std::map<std::string, std::string> memKvMap_;
+    std::map<InodeID, AllocatedSize> fileAllocMap_;
 };
 
 }  // namespace mds
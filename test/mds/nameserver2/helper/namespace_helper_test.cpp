@@ -22,6 +22,7 @@
 
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 #include "src/common/timeutility.h"
 #include "src/common/namespace_define.h"
 #include "src/mds/nameserver2/helper/namespace_helper.h"
@@ -31,6 +32,8 @@ using ::curve::common::FILEINFOKEYPREFIX;
 using ::curve::common::SNAPSHOTFILEINFOKEYPREFIX;
 using ::curve::common::SEGMENTALLOCSIZEKEY;
 using ::curve::common::SEGMENTINFOKEYPREFIX;
+using ::curve::common::FILEALLOCKEYLEN;
+using ::curve::common::FILEALLOCKEYPREFIX;
 
 namespace curve {
 namespace mds {
@@ -185,6 +188,60 @@ TEST(NameSpaceHelperTest, test_EncodeAndDecode_Segment) {
         ASSERT_EQ(i+1, decodeRes.chunks(i).chunkid());
         ASSERT_EQ(i+1, decodeRes.chunks(i).copysetid());
     }
+
+    // 紧凑编码, chunkID连续时不到protobuf编码的一半
+    NameSpaceStorageCodec::SetSegmentCompactEncoding(true);
+    ASSERT_TRUE(NameSpaceStorageCodec::EncodeSegment(segment, &out));
+    NameSpaceStorageCodec::SetSegmentCompactEncoding(false);
+    ASSERT_LT(out.size(), segment.ByteSize() / 2);
+    decodeRes.Clear();
+    ASSERT_TRUE(NameSpaceStorageCodec::DecodeSegment(out, &decodeRes));
+    ASSERT_EQ(segment.SerializeAsString(), decodeRes.SerializeAsString());
+}
+
+TEST(NameSpaceHelperTest, test_DecodeSegment_Compatible) {
+    PageFileSegment segment;
+    segment.set_chunksize(16<<20);
+    segment.set_segmentsize(1 << 30);
+    segment.set_startoffset(2ULL << 40);
+    segment.set_logicalpoolid(16);
+    // chunkID不连续或者递减
+    std::vector<uint64_t> chunkIds{100, 99, 1ULL << 50, 5};
+    for (uint32_t i = 0; i < chunkIds.size(); i++) {
+        PageFileChunkInfo *chunkinfo = segment.add_chunks();
+        chunkinfo->set_chunkid(chunkIds[i]);
+        chunkinfo->set_copysetid(i);
+    }
+
+    // 1. 紧凑编码
+    NameSpaceStorageCodec::SetSegmentCompactEncoding(true);
+    std::string out;
+    PageFileSegment decodeRes;
+    ASSERT_TRUE(NameSpaceStorageCodec::EncodeSegment(segment, &out));
+    ASSERT_TRUE(NameSpaceStorageCodec::DecodeSegment(out, &decodeRes));
+    ASSERT_EQ(segment.SerializeAsString(), decodeRes.SerializeAsString());
+
+    // 2. 旧版本protobuf编码的segment
+    out = segment.SerializeAsString();
+    decodeRes.Clear();
+    ASSERT_TRUE(NameSpaceStorageCodec::DecodeSegment(out, &decodeRes));
+    ASSERT_EQ(segment.SerializeAsString(), decodeRes.SerializeAsString());
+
+    // 3. 关闭紧凑编码
+    NameSpaceStorageCodec::SetSegmentCompactEncoding(false);
+    ASSERT_TRUE(NameSpaceStorageCodec::EncodeSegment(segment, &out));
+    ASSERT_EQ(segment.SerializeAsString(), out);
+    NameSpaceStorageCodec::SetSegmentCompactEncoding(true);
+
+    // 4. 紧凑编码的数据损坏
+    ASSERT_TRUE(NameSpaceStorageCodec::EncodeSegment(segment, &out));
+    ASSERT_FALSE(NameSpaceStorageCodec::DecodeSegment(
+        out.substr(0, out.size() - 1), &decodeRes));
+    ASSERT_FALSE(NameSpaceStorageCodec::DecodeSegment(
+        out + "a", &decodeRes));
+    out[1] = 2;
+    ASSERT_FALSE(NameSpaceStorageCodec::DecodeSegment(out, &decodeRes));
+    NameSpaceStorageCodec::SetSegmentCompactEncoding(false);
 }
 
 TEST(NameSpaceHelperTest, test_EncodeSegmentAllocKey) {
@@ -208,5 +265,48 @@ TEST(NameSpaceHelperTest, test_Encode_Decode_SegmentAllocValue) {
         NameSpaceStorageCodec::DecodeSegmentAllocValue("world", &lid, &alloc));
 }
 
+TEST(NameSpaceHelperTest, test_Encode_Decode_SegmentAllocCheckpoint) {
+    std::map<uint16_t, int64_t> allocs{{1, 1024}, {2, 2048}};
+    std::string value =
+        NameSpaceStorageCodec::EncodeSegmentAllocCheckpoint(10, allocs);
+    ASSERT_EQ("10|1_1024|2_2048", value);
+
+    int64_t revision;
+    std::map<uint16_t, int64_t> out;
+    ASSERT_TRUE(NameSpaceStorageCodec::DecodeSegmentAllocCheckpoint(
+        value, &revision, &out));
+    ASSERT_EQ(10, revision);
+    ASSERT_EQ(allocs, out);
+
+    ASSERT_TRUE(NameSpaceStorageCodec::DecodeSegmentAllocCheckpoint(
+        "10", &revision, &out));
+    ASSERT_TRUE(out.empty());
+
+    ASSERT_FALSE(NameSpaceStorageCodec::DecodeSegmentAllocCheckpoint(
+        "", &revision, &out));
+    ASSERT_FALSE(NameSpaceStorageCodec::DecodeSegmentAllocCheckpoint(
+        "10|world", &revision, &out));
+}
+
+TEST(NameSpaceHelperTest, test_Encode_Decode_FileAlloc) {
+    std::string key = NameSpaceStorageCodec::EncodeFileAllocKey(1);
+    ASSERT_EQ(FILEALLOCKEYLEN, key.size());
+    ASSERT_EQ(FILEALLOCKEYPREFIX, key.substr(0, COMMON_PREFIX_LENGTH));
+    ASSERT_LT(key, NameSpaceStorageCodec::EncodeFileAllocKey(2));
+
+    std::map<uint16_t, uint64_t> allocs{{1, 1024}, {2, 2048}};
+    std::string value = NameSpaceStorageCodec::EncodeFileAllocValue(allocs);
+    ASSERT_EQ("1_1024|2_2048", value);
+
+    std::map<uint16_t, uint64_t> out;
+    ASSERT_TRUE(NameSpaceStorageCodec::DecodeFileAllocValue(value, &out));
+    ASSERT_EQ(allocs, out);
+
+    ASSERT_TRUE(NameSpaceStorageCodec::DecodeFileAllocValue("", &out));
+    ASSERT_TRUE(out.empty());
+    ASSERT_FALSE(NameSpaceStorageCodec::DecodeFileAllocValue(
+        "1_1024|world", &out));
+}
+
 }  // namespace mds
 }  // namespace curve
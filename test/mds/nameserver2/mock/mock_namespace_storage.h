@@ -71,12 +71,18 @@ class MockNameServerStorage : public NameServerStorage {
                                          uint64_t,
                                          PageFileSegment *segment));
 
-    MOCK_METHOD4(PutSegment, StoreStatus(InodeID,
+    MOCK_METHOD5(PutSegment, StoreStatus(InodeID,
                                          uint64_t,
                                          const PageFileSegment *,
+                                         const AllocatedSize &,
                                          int64_t *));
 
-    MOCK_METHOD3(DeleteSegment, StoreStatus(InodeID, uint64_t, int64_t*));
+    MOCK_METHOD4(DeleteSegment, StoreStatus(InodeID,
+                                            uint64_t,
+                                            const AllocatedSize &,
+                                            int64_t*));
+
+    MOCK_METHOD2(GetFileAlloc, StoreStatus(InodeID, AllocatedSize *));
 
     MOCK_METHOD2(SnapShotFile, StoreStatus(const FileInfo *,
                                     const FileInfo *));
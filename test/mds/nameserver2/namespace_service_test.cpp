@@ -688,6 +688,72 @@ TEST_F(NameSpaceServiceTest, test1) {
         }
     }
 
+    // test update file throttle params
+    {
+        cntl.Reset();
+        UpdateFileThrottleParamsRequest request;
+        UpdateFileThrottleParamsResponse response;
+        ThrottleParams *item =
+            request.mutable_throttleparams()->add_throttleparams();
+        item->set_type(ThrottleType::IOPS_WRITE);
+        item->set_limit(1000);
+        uint64_t date = TimeUtility::GetTimeofDayUs();
+        std::string str2sig = Authenticator::GetString2Signature(date,
+                                                    authOptions.rootOwner);
+        std::string sig = Authenticator::CalcString2Signature(str2sig,
+                                                    authOptions.rootPassword);
+
+        // 非root用户，失败
+        request.set_filename("/file1");
+        request.set_rootowner("owner1");
+        request.set_signature(sig);
+        request.set_date(date);
+        stub.UpdateFileThrottleParams(&cntl, &request, &response, NULL);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(StatusCode::kOwnerAuthFail, response.statuscode());
+
+        // root用户设置成功，文件信息中带上新的限制
+        cntl.Reset();
+        request.set_rootowner(authOptions.rootOwner);
+        stub.UpdateFileThrottleParams(&cntl, &request, &response, NULL);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(StatusCode::kOK, response.statuscode());
+
+        cntl.Reset();
+        request1.set_filename("/file1");
+        request1.set_owner("owner1");
+        request1.set_date(TimeUtility::GetTimeofDayUs());
+        stub.GetFileInfo(&cntl, &request1, &response1, NULL);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(StatusCode::kOK, response1.statuscode());
+        ASSERT_EQ(1, response1.fileinfo().throttleparams()
+                        .throttleparams_size());
+        ASSERT_EQ(ThrottleType::IOPS_WRITE, response1.fileinfo()
+                        .throttleparams().throttleparams(0).type());
+        ASSERT_EQ(1000, response1.fileinfo()
+                        .throttleparams().throttleparams(0).limit());
+
+        // 不带限制时清除
+        cntl.Reset();
+        request.clear_throttleparams();
+        stub.UpdateFileThrottleParams(&cntl, &request, &response, NULL);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(StatusCode::kOK, response.statuscode());
+
+        cntl.Reset();
+        stub.GetFileInfo(&cntl, &request1, &response1, NULL);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(StatusCode::kOK, response1.statuscode());
+        ASSERT_FALSE(response1.fileinfo().has_throttleparams());
+
+        // 文件名不规范，失败
+        cntl.Reset();
+        request.set_filename("/file1/");
+        stub.UpdateFileThrottleParams(&cntl, &request, &response, NULL);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(StatusCode::kParaError, response.statuscode());
+    }
+
     // test RenameFile
     // 重命名到根目录下，非root owner，失败
     // fileinfoid不匹配，失败
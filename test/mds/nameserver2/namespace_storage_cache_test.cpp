@@ -24,7 +24,10 @@
 #include <glog/logging.h>
 #include <memory>
 #include <string>
+#include <thread>  //NOLINT
+#include <vector>
 #include "src/mds/nameserver2/namespace_storage_cache.h"
+#include "src/mds/common/mds_define.h"
 #include "src/mds/nameserver2/namespace_storage.h"
 #include "src/mds/nameserver2/helper/namespace_helper.h"
 #include "src/common/timeutility.h"
@@ -158,5 +161,107 @@ TEST(CaCheTest, TestCacheHitAndMissMetric) {
 }
 
 
+TEST(CaCheTest, TestShardedClockCache) {
+    // 单个分片，最多10个字节
+    std::shared_ptr<ShardedClockCache> cache =
+        std::make_shared<ShardedClockCache>(10, 1);
+
+    // 1. 测试 put/get
+    std::string res;
+    for (int i = 1; i <= 5; i++) {
+        cache->Put(std::to_string(i), std::to_string(i));
+        ASSERT_TRUE(cache->Get(std::to_string(i), &res));
+        ASSERT_EQ(std::to_string(i), res);
+    }
+    ASSERT_EQ(5, cache->GetCacheMetrics()->cacheCount.get_value());
+    ASSERT_EQ(10, cache->GetCacheMetrics()->cacheBytes.get_value());
+
+    // 2. 都被访问过，清除标记后淘汰最早插入的元素
+    cache->Put("6", "6");
+    ASSERT_FALSE(cache->Get("1", &res));
+    ASSERT_EQ(1, cache->GetCacheMetrics()->cacheEviction.get_value());
+
+    // 3. 被访问过的元素不会被优先淘汰
+    ASSERT_TRUE(cache->Get("3", &res));
+    cache->Put("7", "7");
+    cache->Put("8", "8");
+    ASSERT_FALSE(cache->Get("2", &res));
+    ASSERT_TRUE(cache->Get("3", &res));
+    ASSERT_FALSE(cache->Get("4", &res));
+    ASSERT_EQ(3, cache->GetCacheMetrics()->cacheEviction.get_value());
+    ASSERT_EQ(10, cache->GetCacheMetrics()->cacheBytes.get_value());
+
+    // 4. 重复put
+    cache->Put("3", "hello");
+    ASSERT_TRUE(cache->Get("3", &res));
+    ASSERT_EQ("hello", res);
+    ASSERT_EQ(10, cache->GetCacheMetrics()->cacheBytes.get_value());
+
+    // 5. 删除元素
+    cache->Remove("3");
+    ASSERT_FALSE(cache->Get("3", &res));
+    ASSERT_EQ(4, cache->GetCacheMetrics()->cacheBytes.get_value());
+
+    // 6. 超过分片容量的元素不缓存
+    cache->Put("big", "helloworld");
+    ASSERT_FALSE(cache->Get("big", &res));
+    ASSERT_EQ(4, cache->GetCacheMetrics()->cacheBytes.get_value());
+}
+
+TEST(CaCheTest, TestShardedClockCacheNoLimit) {
+    std::shared_ptr<ShardedClockCache> cache =
+        std::make_shared<ShardedClockCache>(0);
+
+    std::string res;
+    for (int i = 1; i <= 1000; i++) {
+        cache->Put(std::to_string(i), std::to_string(i));
+    }
+    for (int i = 1; i <= 1000; i++) {
+        ASSERT_TRUE(cache->Get(std::to_string(i), &res));
+        ASSERT_EQ(std::to_string(i), res);
+    }
+    ASSERT_EQ(1000, cache->GetCacheMetrics()->cacheCount.get_value());
+    ASSERT_EQ(0, cache->GetCacheMetrics()->cacheEviction.get_value());
+}
+
+// 多线程并发读写，读到的值都是写入过的值
+static void CacheConcurrentTest(std::shared_ptr<Cache> cache) {
+    const int threadNum = 8;
+    const int opNum = 10000;
+    const int keyNum = 1000;
+    std::string value(512, 'v');
+    for (int i = 0; i < keyNum; i++) {
+        cache->Put(std::to_string(i), value);
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadNum; t++) {
+        threads.emplace_back([cache, t, opNum, keyNum, &value]() {
+            std::string out;
+            for (int i = 0; i < opNum; i++) {
+                std::string key = std::to_string((i * 7 + t) % keyNum);
+                // 读多写少，每10次操作更新一次
+                if (i % 10 == 0) {
+                    cache->Put(key, value);
+                } else if (cache->Get(key, &out)) {
+                    ASSERT_EQ(value, out);
+                }
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+}
+
+TEST(CaCheTest, TestCacheConcurrent) {
+    CacheConcurrentTest(std::make_shared<LRUCache>(100));
+    CacheConcurrentTest(std::make_shared<ShardedClockCache>(100 * 1024));
+
+    auto cache = std::make_shared<ShardedClockCache>(0);
+    CacheConcurrentTest(cache);
+    ASSERT_EQ(1000, cache->GetCacheMetrics()->cacheCount.get_value());
+}
+
 }  // namespace mds
 }  // namespace curve
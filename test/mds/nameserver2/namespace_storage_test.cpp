@@ -34,6 +34,7 @@ using ::testing::Return;
 using ::testing::AtLeast;
 using ::testing::SetArgPointee;
 using ::testing::DoAll;
+using ::testing::Invoke;
 
 namespace curve {
 namespace mds {
@@ -355,13 +356,41 @@ TEST_F(TestNameServerStorageImp, test_putsegment) {
     segment.set_chunksize(16*1024*1024);
     segment.set_startoffset(0);
     segment.set_logicalpoolid(1);
-    EXPECT_CALL(*client_, PutRewithRevision(_, _, _))
-        .WillOnce(Return(EtcdErrCode::EtcdOK))
+    AllocatedSize fileAlloc;
+    fileAlloc.total = 2 * segment.segmentsize();
+    fileAlloc.allocSizeMap[1] = 2 * segment.segmentsize();
+
+    // segment和文件的分配量在同一个事务中写入
+    std::vector<OpType> opTypes;
+    std::vector<std::string> keys;
+    std::vector<std::string> values;
+    EXPECT_CALL(*client_, TxnWithRevision(_, _))
+        .WillOnce(Invoke([&](const std::vector<Operation> &ops,
+                             int64_t *revision) {
+            for (const auto &op : ops) {
+                opTypes.push_back(op.opType);
+                keys.emplace_back(op.key, op.keyLen);
+                values.emplace_back(op.value, op.valueLen);
+            }
+            *revision = 10;
+            return EtcdErrCode::EtcdOK;
+        }))
         .WillOnce(Return(EtcdErrCode::EtcdCanceled));
+    EXPECT_CALL(*cache_, Put(_, _)).Times(1);
     int64_t revision;
-    ASSERT_EQ(StoreStatus::OK, storage_->PutSegment(0, 0, &segment, &revision));
+    ASSERT_EQ(StoreStatus::OK,
+        storage_->PutSegment(0, 0, &segment, fileAlloc, &revision));
+    ASSERT_EQ(10, revision);
+    ASSERT_EQ(2, opTypes.size());
+    ASSERT_EQ(OpType::OpPut, opTypes[0]);
+    ASSERT_EQ(NameSpaceStorageCodec::EncodeSegmentStoreKey(0, 0), keys[0]);
+    ASSERT_EQ(OpType::OpPut, opTypes[1]);
+    ASSERT_EQ(NameSpaceStorageCodec::EncodeFileAllocKey(0), keys[1]);
+    ASSERT_EQ(NameSpaceStorageCodec::EncodeFileAllocValue(
+        {{1, 2 * segment.segmentsize()}}), values[1]);
+
     ASSERT_EQ(StoreStatus::InternalError,
-        storage_->PutSegment(0, 0, &segment, &revision));
+        storage_->PutSegment(0, 0, &segment, fileAlloc, &revision));
 }
 
 TEST_F(TestNameServerStorageImp, test_getSegment) {
@@ -396,13 +425,90 @@ TEST_F(TestNameServerStorageImp, test_getSegment) {
 }
 
 TEST_F(TestNameServerStorageImp, test_deleteSegment) {
-    EXPECT_CALL(*client_, DeleteRewithRevision(_, _))
-        .WillOnce(Return(EtcdErrCode::EtcdOK))
+    std::vector<OpType> opTypes;
+    auto recordOps = [&](const std::vector<Operation> &ops,
+                         int64_t *revision) {
+        opTypes.clear();
+        for (const auto &op : ops) {
+            opTypes.push_back(op.opType);
+        }
+        *revision = 10;
+        return EtcdErrCode::EtcdOK;
+    };
+    EXPECT_CALL(*client_, TxnWithRevision(_, _))
+        .WillOnce(Invoke(recordOps))
+        .WillOnce(Invoke(recordOps))
         .WillOnce(Return(EtcdErrCode::EtcdAborted));
     int64_t revision;
-    ASSERT_EQ(StoreStatus::OK, storage_->DeleteSegment(0, 0, &revision));
+
+    // 1. 删除后文件还有分配量，更新分配量记录
+    AllocatedSize fileAlloc;
+    fileAlloc.total = 1024;
+    fileAlloc.allocSizeMap[1] = 1024;
+    ASSERT_EQ(StoreStatus::OK,
+        storage_->DeleteSegment(0, 0, fileAlloc, &revision));
+    ASSERT_EQ(10, revision);
+    ASSERT_EQ(2, opTypes.size());
+    ASSERT_EQ(OpType::OpDelete, opTypes[0]);
+    ASSERT_EQ(OpType::OpPut, opTypes[1]);
+
+    // 2. 删除最后一个segment，分配量记录一起删除
+    ASSERT_EQ(StoreStatus::OK,
+        storage_->DeleteSegment(0, 0, AllocatedSize(), &revision));
+    ASSERT_EQ(2, opTypes.size());
+    ASSERT_EQ(OpType::OpDelete, opTypes[0]);
+    ASSERT_EQ(OpType::OpDelete, opTypes[1]);
+
+    // 3. 事务失败
+    ASSERT_EQ(StoreStatus::InternalError,
+        storage_->DeleteSegment(0, 0, fileAlloc, &revision));
+}
+
+TEST_F(TestNameServerStorageImp, test_getFileAlloc) {
+    AllocatedSize fileAlloc;
+
+    // 1. 从分配量记录中获取
+    std::string value =
+        NameSpaceStorageCodec::EncodeFileAllocValue({{1, 1024}, {2, 2048}});
+    EXPECT_CALL(*client_, Get(NameSpaceStorageCodec::EncodeFileAllocKey(0), _))
+        .WillOnce(DoAll(SetArgPointee<1>(value),
+                        Return(EtcdErrCode::EtcdOK)));
+    ASSERT_EQ(StoreStatus::OK, storage_->GetFileAlloc(0, &fileAlloc));
+    ASSERT_EQ(3072, fileAlloc.total);
+    ASSERT_EQ(1024, fileAlloc.allocSizeMap[1]);
+    ASSERT_EQ(2048, fileAlloc.allocSizeMap[2]);
+
+    // 2. 分配量记录格式错误
+    EXPECT_CALL(*client_, Get(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(std::string("invalid")),
+                        Return(EtcdErrCode::EtcdOK)));
+    ASSERT_EQ(StoreStatus::InternalError,
+        storage_->GetFileAlloc(0, &fileAlloc));
+
+    // 3. get失败
+    EXPECT_CALL(*client_, Get(_, _))
+        .WillOnce(Return(EtcdErrCode::EtcdCanceled));
     ASSERT_EQ(StoreStatus::InternalError,
-        storage_->DeleteSegment(0, 0, &revision));
+        storage_->GetFileAlloc(0, &fileAlloc));
+
+    // 4. 没有分配量记录，通过segment统计
+    PageFileSegment segment;
+    segment.set_segmentsize(1024);
+    segment.set_chunksize(16*1024*1024);
+    segment.set_startoffset(0);
+    segment.set_logicalpoolid(1);
+    std::string encodeSegment;
+    ASSERT_TRUE(NameSpaceStorageCodec::EncodeSegment(segment, &encodeSegment));
+    EXPECT_CALL(*client_, Get(_, _))
+        .WillOnce(Return(EtcdErrCode::EtcdKeyNotExist));
+    EXPECT_CALL(*client_, List(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(
+            std::vector<std::string>{encodeSegment, encodeSegment}),
+            Return(EtcdErrCode::EtcdOK)));
+    ASSERT_EQ(StoreStatus::OK, storage_->GetFileAlloc(0, &fileAlloc));
+    ASSERT_EQ(2048, fileAlloc.total);
+    ASSERT_EQ(1, fileAlloc.allocSizeMap.size());
+    ASSERT_EQ(2048, fileAlloc.allocSizeMap[1]);
 }
 
 TEST_F(TestNameServerStorageImp, test_Snapshotfile) {
@@ -298,6 +298,13 @@ class FakeTopo : public ::curve::mds::topology::TopologyImpl {
         return -1;
     }
 
+    // 不记录copyset的变化，调度每次从topology全量获取
+    bool GetChangedCopySets(uint64_t sinceVersion,
+        std::vector<CopySetKey> *changed, uint64_t *version) const override {
+        *version = 0;
+        return false;
+    }
+
  private:
     std::map<ServerIdType, Server> serverMap_;
     std::map<ChunkServerIdType, ChunkServer> chunkServerMap_;
@@ -37,6 +37,7 @@ using ::testing::AtLeast;
 using ::testing::SetArgPointee;
 using ::testing::DoAll;
 using ::testing::InSequence;
+using ::testing::Invoke;
 
 namespace curve {
 namespace mds {
@@ -82,6 +83,9 @@ TEST_F(TestTopoAdapterImpl, test_copysetInfo) {
     auto testTopoServer = GetServerForTest();
     ::curve::mds::topology::LogicalPool lpool;
     lpool.SetLogicalPoolAvaliableFlag(true);
+    // 无法增量获取copyset的变化，copyset视图每次全量重建
+    EXPECT_CALL(*mockTopo_, GetChangedCopySets(_, _, _))
+        .WillRepeatedly(Return(false));
     {
         // 1. test GetCopySetInfo cannot get CopySetInfo
         EXPECT_CALL(*mockTopo_, GetCopySet(_, _)).WillOnce(Return(false));
@@ -199,7 +203,7 @@ TEST_F(TestTopoAdapterImpl, test_copysetInfo) {
     {
         // 7. test GetCopySetInfosInChunkServer error
         std::vector<CopySetKey> infos{testcopySetInfo.id};
-        EXPECT_CALL(*mockTopo_, GetCopySetsInChunkServer(_, _))
+        EXPECT_CALL(*mockTopo_, GetCopySetsInCluster(_))
             .WillOnce(Return(infos));
         EXPECT_CALL(*mockTopo_, GetCopySet(_, _)).WillOnce(Return(false));
         ASSERT_EQ(0, topoAdapter_->GetCopySetInfosInChunkServer(1).size());
@@ -207,7 +211,7 @@ TEST_F(TestTopoAdapterImpl, test_copysetInfo) {
     {
         // 8. test GetCopySetInfosInChunkServer success
         std::vector<CopySetKey> infos{testcopySetInfo.id};
-        EXPECT_CALL(*mockTopo_, GetCopySetsInChunkServer(_, _))
+        EXPECT_CALL(*mockTopo_, GetCopySetsInCluster(_))
             .WillOnce(Return(infos));
         EXPECT_CALL(*mockTopo_, GetCopySet(_, _))
             .WillOnce(DoAll(SetArgPointee<1>(testTopoCopySet), Return(true)));
@@ -280,7 +284,7 @@ TEST_F(TestTopoAdapterImpl, test_copysetInfo) {
     {
         // 11. test GetCopySetInfosInChunkServer logical pool unavailable
         std::vector<CopySetKey> infos{testcopySetInfo.id};
-        EXPECT_CALL(*mockTopo_, GetCopySetsInChunkServer(_, _))
+        EXPECT_CALL(*mockTopo_, GetCopySetsInCluster(_))
             .WillOnce(Return(infos));
         EXPECT_CALL(*mockTopo_, GetCopySet(_, _))
             .WillOnce(DoAll(SetArgPointee<1>(testTopoCopySet), Return(true)));
@@ -308,6 +312,83 @@ TEST_F(TestTopoAdapterImpl, test_copysetInfo) {
     }
 }
 
+TEST_F(TestTopoAdapterImpl, test_copysetView_incremental) {
+    auto testTopoCopySet = GetTopoCopySetInfoForTest();
+    testTopoCopySet.ClearCandidate();
+    auto testTopoChunkServer = GetTopoChunkServerForTest();
+    auto testTopoServer = GetServerForTest();
+    ::curve::mds::topology::LogicalPool lpool;
+    lpool.SetLogicalPoolAvaliableFlag(true);
+    EXPECT_CALL(*mockTopo_, GetChunkServer(_, _))
+        .WillRepeatedly(Invoke([&](ChunkServerIdType id,
+            ::curve::mds::topology::ChunkServer *out) {
+                *out = testTopoChunkServer[id - 1];
+                return true;
+            }));
+    EXPECT_CALL(*mockTopo_, GetServer(_, _))
+        .WillRepeatedly(Invoke([&](ServerIdType id,
+            ::curve::mds::topology::Server *out) {
+                *out = testTopoServer[id - 1];
+                return true;
+            }));
+    EXPECT_CALL(*mockTopo_, GetLogicalPool(1, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(lpool), Return(true)));
+
+    // 1. 第一次获取全量构建视图
+    std::vector<CopySetKey> keys{CopySetKey(1, 1)};
+    EXPECT_CALL(*mockTopo_, GetChangedCopySets(0, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(10), Return(true)));
+    EXPECT_CALL(*mockTopo_, GetCopySetsInCluster(_))
+        .WillOnce(Return(keys));
+    EXPECT_CALL(*mockTopo_, GetCopySet(CopySetKey(1, 1), _))
+        .WillOnce(DoAll(SetArgPointee<1>(testTopoCopySet), Return(true)));
+    auto out = topoAdapter_->GetCopySetInfos();
+    ASSERT_EQ(1, out.size());
+    ASSERT_EQ(testTopoCopySet.GetEpoch(), out[0].epoch);
+
+    // 2. 没有变化，不再从topology获取copyset
+    EXPECT_CALL(*mockTopo_, GetChangedCopySets(10, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(10), Return(true)));
+    out = topoAdapter_->GetCopySetInfosInChunkServer(1);
+    ASSERT_EQ(1, out.size());
+
+    // 3. 只更新发生变化的copyset
+    std::vector<CopySetKey> changed{CopySetKey(1, 1), CopySetKey(1, 2)};
+    auto newCopySet = testTopoCopySet;
+    newCopySet.SetEpoch(testTopoCopySet.GetEpoch() + 1);
+    newCopySet.SetCopySetMembers({2, 3, 4});
+    ::curve::mds::topology::CopySetInfo addCopySet(1, 2);
+    addCopySet.SetEpoch(1);
+    addCopySet.SetLeader(1);
+    addCopySet.SetCopySetMembers({1, 2, 3});
+    EXPECT_CALL(*mockTopo_, GetChangedCopySets(10, _, _))
+        .WillOnce(DoAll(SetArgPointee<1>(changed),
+                        SetArgPointee<2>(12), Return(true)));
+    EXPECT_CALL(*mockTopo_, GetCopySet(CopySetKey(1, 1), _))
+        .WillOnce(DoAll(SetArgPointee<1>(newCopySet), Return(true)));
+    EXPECT_CALL(*mockTopo_, GetCopySet(CopySetKey(1, 2), _))
+        .WillOnce(DoAll(SetArgPointee<1>(addCopySet), Return(true)));
+    out = topoAdapter_->GetCopySetInfosInChunkServer(1);
+    ASSERT_EQ(1, out.size());
+    ASSERT_EQ(2, out[0].id.second);
+
+    // 4. copyset被删除
+    changed = {CopySetKey(1, 2)};
+    EXPECT_CALL(*mockTopo_, GetChangedCopySets(12, _, _))
+        .WillOnce(DoAll(SetArgPointee<1>(changed),
+                        SetArgPointee<2>(13), Return(true)));
+    EXPECT_CALL(*mockTopo_, GetCopySet(CopySetKey(1, 2), _))
+        .WillOnce(Return(false));
+    out = topoAdapter_->GetCopySetInfosInLogicalPool(1);
+    ASSERT_EQ(1, out.size());
+    ASSERT_EQ(1, out[0].id.second);
+    ASSERT_EQ(testTopoCopySet.GetEpoch() + 1, out[0].epoch);
+    // copyset(1,1)的成员变更后不再包含chunkserver1
+    EXPECT_CALL(*mockTopo_, GetChangedCopySets(13, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(13), Return(true)));
+    ASSERT_TRUE(topoAdapter_->GetCopySetInfosInChunkServer(1).empty());
+}
+
 TEST_F(TestTopoAdapterImpl, test_chunkserverInfo) {
     ChunkServerInfo info;
     auto testTopoServer = GetServerForTest();
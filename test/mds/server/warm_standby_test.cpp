@@ -0,0 +1,293 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "src/mds/server/warm_standby.h"
+#include "src/mds/topology/topology_storage_codec.h"
+#include "src/common/namespace_define.h"
+#include "test/mds/mock/mock_etcdclient.h"
+#include "test/mds/mock/mock_topology.h"
+
+using ::testing::_;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::DoAll;
+
+using ::curve::common::FILEINFOKEYPREFIX;
+using ::curve::common::TOPOLOGYITEMEND;
+using ::curve::mds::topology::MockTopology;
+using ::curve::mds::topology::TopologyStorageCodec;
+using ::curve::mds::topology::ChunkServer;
+using ::curve::mds::topology::ChunkServerStatus;
+using ::curve::mds::topology::OnlineState;
+using ::curve::mds::topology::CopySetInfo;
+using ::curve::mds::topology::CopySetKey;
+using ::curve::mds::topology::kTopoErrCodeSuccess;
+
+namespace curve {
+namespace mds {
+
+class WarmStandbyTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        client_ = std::make_shared<MockEtcdClient>();
+        cache_ = std::make_shared<ShardedClockCache>(0);
+        topology_ = std::make_shared<MockTopology>();
+        reloadTimes_ = 0;
+        reloadRet_ = 0;
+        CreateWarmStandby(0);
+    }
+
+    void CreateWarmStandby(uint32_t topologyReloadIntervalMs) {
+        WarmStandbyOption option;
+        option.refreshIntervalMs = 10;
+        option.topologyReloadIntervalMs = topologyReloadIntervalMs;
+        warmStandby_ = std::make_shared<WarmStandby>(client_, cache_,
+            [this]() {
+                reloadTimes_++;
+                return reloadRet_;
+            },
+            [this]() { return topology_; }, option);
+    }
+
+    void ExpectRefresh(int64_t startRevision, int64_t endRevision,
+                       const std::vector<KVChange> &changes) {
+        EXPECT_CALL(*client_, GetCurrentRevision(_))
+            .WillOnce(DoAll(SetArgPointee<0>(endRevision),
+                            Return(EtcdErrCode::EtcdOK)));
+        EXPECT_CALL(*client_, ListChanges(FILEINFOKEYPREFIX, TOPOLOGYITEMEND,
+            startRevision, endRevision, _))
+            .WillOnce(DoAll(SetArgPointee<4>(changes),
+                            Return(EtcdErrCode::EtcdOK)));
+    }
+
+ protected:
+    std::shared_ptr<MockEtcdClient> client_;
+    std::shared_ptr<ShardedClockCache> cache_;
+    std::shared_ptr<MockTopology> topology_;
+    std::shared_ptr<WarmStandby> warmStandby_;
+    int reloadTimes_;
+    int reloadRet_;
+};
+
+TEST_F(WarmStandbyTest, test_Init) {
+    // 1. 获取revision失败
+    EXPECT_CALL(*client_, GetCurrentRevision(_))
+        .WillOnce(Return(EtcdErrCode::EtcdCanceled));
+    ASSERT_EQ(-1, warmStandby_->Init());
+    ASSERT_EQ(0, reloadTimes_);
+
+    // 2. topology加载失败, 下次追赶时重新加载
+    reloadRet_ = -1;
+    EXPECT_CALL(*client_, GetCurrentRevision(_))
+        .WillOnce(DoAll(SetArgPointee<0>(10), Return(EtcdErrCode::EtcdOK)));
+    ASSERT_EQ(0, warmStandby_->Init());
+    ASSERT_EQ(1, reloadTimes_);
+    ASSERT_FALSE(warmStandby_->IsTopologyLoaded());
+
+    reloadRet_ = 0;
+    EXPECT_CALL(*client_, GetCurrentRevision(_))
+        .WillOnce(DoAll(SetArgPointee<0>(10), Return(EtcdErrCode::EtcdOK)));
+    EXPECT_CALL(*client_, ListChanges(
+        FILEINFOKEYPREFIX, TOPOLOGYITEMEND, 10, 10, _))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+    ASSERT_EQ(0, warmStandby_->Refresh());
+    ASSERT_EQ(2, reloadTimes_);
+    ASSERT_TRUE(warmStandby_->IsTopologyLoaded());
+    ASSERT_TRUE(warmStandby_->IsCacheValid());
+}
+
+TEST_F(WarmStandbyTest, test_Refresh) {
+    EXPECT_CALL(*client_, GetCurrentRevision(_))
+        .WillOnce(DoAll(SetArgPointee<0>(10), Return(EtcdErrCode::EtcdOK)));
+    ASSERT_EQ(0, warmStandby_->Init());
+    ASSERT_EQ(1, reloadTimes_);
+    cache_->Put("02segment", "oldsegment");
+
+    // 1. 获取变化失败, revision不变
+    EXPECT_CALL(*client_, GetCurrentRevision(_))
+        .WillOnce(DoAll(SetArgPointee<0>(15), Return(EtcdErrCode::EtcdOK)));
+    EXPECT_CALL(*client_, ListChanges(
+        FILEINFOKEYPREFIX, TOPOLOGYITEMEND, 10, 15, _))
+        .WillOnce(Return(EtcdErrCode::EtcdDeadlineExceeded));
+    ASSERT_EQ(-1, warmStandby_->Refresh());
+    ASSERT_EQ(10, warmStandby_->GetRevision());
+
+    // 2. 元数据的变化更新到缓存, topology有变化时重新加载
+    std::vector<KVChange> changes(4);
+    changes[0].type = OpType::OpPut;
+    changes[0].key = "01file";
+    changes[0].value = "file";
+    changes[1].type = OpType::OpDelete;
+    changes[1].key = "02segment";
+    changes[1].prevValue = "oldsegment";
+    changes[2].type = OpType::OpPut;
+    changes[2].key = "04inode";
+    changes[2].value = "100";
+    changes[3].type = OpType::OpPut;
+    changes[3].key = "10copyset";
+    changes[3].value = "copyset";
+    EXPECT_CALL(*client_, GetCurrentRevision(_))
+        .WillOnce(DoAll(SetArgPointee<0>(20), Return(EtcdErrCode::EtcdOK)));
+    EXPECT_CALL(*client_, ListChanges(
+        FILEINFOKEYPREFIX, TOPOLOGYITEMEND, 10, 20, _))
+        .WillOnce(DoAll(SetArgPointee<4>(changes),
+                        Return(EtcdErrCode::EtcdOK)));
+    ASSERT_EQ(0, warmStandby_->Refresh());
+    ASSERT_EQ(20, warmStandby_->GetRevision());
+    ASSERT_EQ(2, reloadTimes_);
+    std::string value;
+    ASSERT_TRUE(cache_->Get("01file", &value));
+    ASSERT_EQ("file", value);
+    ASSERT_FALSE(cache_->Get("02segment", &value));
+    ASSERT_FALSE(cache_->Get("04inode", &value));
+    ASSERT_FALSE(cache_->Get("10copyset", &value));
+    ASSERT_TRUE(warmStandby_->IsCacheValid());
+
+    // 3. 历史已经被compact, 缓存不可用, topology重新加载
+    EXPECT_CALL(*client_, GetCurrentRevision(_))
+        .WillOnce(DoAll(SetArgPointee<0>(30), Return(EtcdErrCode::EtcdOK)));
+    EXPECT_CALL(*client_, ListChanges(
+        FILEINFOKEYPREFIX, TOPOLOGYITEMEND, 20, 30, _))
+        .WillOnce(Return(EtcdErrCode::EtcdOutOfRange));
+    ASSERT_EQ(0, warmStandby_->Refresh());
+    ASSERT_EQ(30, warmStandby_->GetRevision());
+    ASSERT_EQ(3, reloadTimes_);
+    ASSERT_FALSE(warmStandby_->IsCacheValid());
+    ASSERT_TRUE(warmStandby_->IsTopologyLoaded());
+}
+
+TEST_F(WarmStandbyTest, test_ApplyTopologyChange) {
+    EXPECT_CALL(*client_, GetCurrentRevision(_))
+        .WillOnce(DoAll(SetArgPointee<0>(10), Return(EtcdErrCode::EtcdOK)));
+    ASSERT_EQ(0, warmStandby_->Init());
+    ASSERT_EQ(1, reloadTimes_);
+
+    TopologyStorageCodec codec;
+    ChunkServer cs(1, "token", "nvme", 1, "127.0.0.1", 8200, "/data",
+        ChunkServerStatus::READWRITE, OnlineState::ONLINE);
+    CopySetInfo copyset(1, 1);
+    copyset.SetEpoch(2);
+    copyset.SetCopySetMembers({1, 2, 3});
+
+    // 1. chunkserver状态和copyset的变化直接更新到topology
+    std::vector<KVChange> changes(2);
+    changes[0].type = OpType::OpPut;
+    changes[0].key = codec.EncodeChunkServerKey(cs.GetId());
+    ASSERT_TRUE(codec.EncodeChunkServerData(cs, &changes[0].value));
+    changes[1].type = OpType::OpPut;
+    changes[1].key = codec.EncodeCopySetKey(
+        CopySetKey(copyset.GetLogicalPoolId(), copyset.GetId()));
+    ASSERT_TRUE(codec.EncodeCopySetData(copyset, &changes[1].value));
+    ExpectRefresh(10, 20, changes);
+    ChunkServer oldCs(1, "token", "nvme", 1, "127.0.0.1", 8200, "/data");
+    EXPECT_CALL(*topology_, GetChunkServer(1, _))
+        .WillOnce(DoAll(SetArgPointee<1>(oldCs), Return(true)));
+    EXPECT_CALL(*topology_, UpdateChunkServerRwState(
+        ChunkServerStatus::READWRITE, 1))
+        .WillOnce(Return(kTopoErrCodeSuccess));
+    EXPECT_CALL(*topology_, UpdateChunkServerOnlineState(
+        OnlineState::ONLINE, 1))
+        .WillOnce(Return(kTopoErrCodeSuccess));
+    EXPECT_CALL(*topology_, UpdateChunkServerDiskStatus(_, 1))
+        .WillOnce(Return(kTopoErrCodeSuccess));
+    EXPECT_CALL(*topology_, GetCopySet(CopySetKey(1, 1), _))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*topology_, UpdateCopySetTopo(_))
+        .WillOnce(Return(kTopoErrCodeSuccess));
+    ASSERT_EQ(0, warmStandby_->Refresh());
+    ASSERT_EQ(1, reloadTimes_);
+    ASSERT_TRUE(warmStandby_->IsTopologyLoaded());
+
+    // 2. chunkserver的位置变化, 重新加载
+    changes.resize(1);
+    ExpectRefresh(20, 30, changes);
+    oldCs.SetPort(8201);
+    EXPECT_CALL(*topology_, GetChunkServer(1, _))
+        .WillOnce(DoAll(SetArgPointee<1>(oldCs), Return(true)));
+    ASSERT_EQ(0, warmStandby_->Refresh());
+    ASSERT_EQ(2, reloadTimes_);
+
+    // 3. 删除chunkserver, 重新加载
+    changes[0].type = OpType::OpDelete;
+    changes[0].value.clear();
+    ExpectRefresh(30, 40, changes);
+    ASSERT_EQ(0, warmStandby_->Refresh());
+    ASSERT_EQ(3, reloadTimes_);
+
+    // 4. 其他拓扑结构的变化, 重新加载
+    changes[0].type = OpType::OpPut;
+    changes[0].key = TopologyStorageCodec::GetLogicalPoolKeyPrefix() + "1";
+    changes[0].value = "logicalpool";
+    ExpectRefresh(40, 50, changes);
+    ASSERT_EQ(0, warmStandby_->Refresh());
+    ASSERT_EQ(4, reloadTimes_);
+    ASSERT_TRUE(warmStandby_->IsTopologyLoaded());
+}
+
+TEST_F(WarmStandbyTest, test_ReloadTopologyInterval) {
+    CreateWarmStandby(60000);
+    EXPECT_CALL(*client_, GetCurrentRevision(_))
+        .WillOnce(DoAll(SetArgPointee<0>(10), Return(EtcdErrCode::EtcdOK)));
+    ASSERT_EQ(0, warmStandby_->Init());
+    ASSERT_EQ(1, reloadTimes_);
+
+    // 距离上次加载不足最小间隔, 只标记topology未加载
+    std::vector<KVChange> changes(1);
+    changes[0].type = OpType::OpPut;
+    changes[0].key = TopologyStorageCodec::GetZoneKeyPrefix() + "1";
+    changes[0].value = "zone";
+    ExpectRefresh(10, 20, changes);
+    ASSERT_EQ(0, warmStandby_->Refresh());
+    ASSERT_EQ(1, reloadTimes_);
+    ASSERT_FALSE(warmStandby_->IsTopologyLoaded());
+
+    // topology未加载时不再增量更新
+    ChunkServer cs(1, "token", "nvme", 1, "127.0.0.1", 8200, "/data");
+    TopologyStorageCodec codec;
+    changes[0].key = codec.EncodeChunkServerKey(cs.GetId());
+    ASSERT_TRUE(codec.EncodeChunkServerData(cs, &changes[0].value));
+    ExpectRefresh(20, 30, changes);
+    EXPECT_CALL(*topology_, GetChunkServer(_, _))
+        .Times(0);
+    ASSERT_EQ(0, warmStandby_->Refresh());
+    ASSERT_EQ(1, reloadTimes_);
+    ASSERT_FALSE(warmStandby_->IsTopologyLoaded());
+}
+
+TEST_F(WarmStandbyTest, test_StartStop) {
+    EXPECT_CALL(*client_, GetCurrentRevision(_))
+        .WillRepeatedly(
+            DoAll(SetArgPointee<0>(10), Return(EtcdErrCode::EtcdOK)));
+    EXPECT_CALL(*client_, ListChanges(
+        FILEINFOKEYPREFIX, TOPOLOGYITEMEND, 10, 10, _))
+        .WillRepeatedly(Return(EtcdErrCode::EtcdOK));
+    ASSERT_EQ(0, warmStandby_->Init());
+    warmStandby_->Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    warmStandby_->Stop();
+    ASSERT_EQ(10, warmStandby_->GetRevision());
+    ASSERT_EQ(1, reloadTimes_);
+}
+
+}  // namespace mds
+}  // namespace curve
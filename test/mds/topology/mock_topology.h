@@ -146,6 +146,10 @@ class MockStorage : public TopologyStorage {
                      const ChunkServer &data));
     MOCK_METHOD1(UpdateCopySet, bool(
                      const CopySetInfo &data));
+    MOCK_METHOD1(UpdateChunkServers, bool(
+                     const std::vector<ChunkServer> &datas));
+    MOCK_METHOD1(UpdateCopySets, bool(
+                     const std::vector<CopySetInfo> &datas));
 
     MOCK_METHOD1(LoadClusterInfo,
                  bool(std::vector<ClusterInformation> *info));
@@ -312,6 +316,7 @@ class MockCopysetServiceImpl : public CopysetService {
 
 using ::curve::kvstorage::EtcdClientImp;
 using ::curve::kvstorage::KVStorageClient;
+using ::curve::kvstorage::KVPair;
 
 namespace curve {
 namespace kvstorage {
@@ -325,6 +330,9 @@ class MockKVStorageClient : public KVStorageClient {
         int(const std::string&, const std::string&, std::vector<std::string>*));
     MOCK_METHOD1(Delete, int(const std::string&));
     MOCK_METHOD1(TxnN, int(const std::vector<Operation>&));
+    MOCK_METHOD2(TxnWithRevision,
+        int(const std::vector<Operation>&, int64_t *));
+    MOCK_METHOD1(BatchPut, int(const std::vector<KVPair>&));
     MOCK_METHOD3(CompareAndSwap, int(const std::string&, const std::string&,
         const std::string&));
     MOCK_METHOD5(CampaignLeader, int(const std::string&, const std::string&,
@@ -35,6 +35,8 @@ using ::testing::Return;
 using ::testing::_;
 using ::testing::Contains;
 using ::testing::SetArgPointee;
+using ::testing::SaveArg;
+using ::testing::DoAll;
 using ::curve::common::Configuration;
 
 class TestTopology : public ::testing::Test {
@@ -1446,7 +1448,7 @@ TEST_F(TestTopology, UpdateChunkServerDiskStatus_success) {
     ASSERT_EQ(100, pool.GetDiskCapacity());
 
     // 只刷一次
-    EXPECT_CALL(*storage_, UpdateChunkServer(_))
+    EXPECT_CALL(*storage_, UpdateChunkServers(_))
         .WillOnce(Return(true));
     topology_->Run();
     // sleep 等待刷数据库
@@ -1485,7 +1487,7 @@ TEST_F(TestTopology, UpdateChunkServerRwStateToStorage_success) {
     ASSERT_EQ(kTopoErrCodeSuccess, ret);
 
     // 只刷一次
-    EXPECT_CALL(*storage_, UpdateChunkServer(_))
+    EXPECT_CALL(*storage_, UpdateChunkServers(_))
         .WillOnce(Return(true));
     topology_->Run();
     // sleep 等待刷数据库
@@ -1493,6 +1495,34 @@ TEST_F(TestTopology, UpdateChunkServerRwStateToStorage_success) {
     topology_->Stop();
 }
 
+TEST_F(TestTopology, FlushChunkServerToStorage_failAndRetry) {
+    PoolIdType physicalPoolId = 0x11;
+    ZoneIdType zoneId = 0x21;
+    ServerIdType serverId = 0x31;
+    PrepareAddPhysicalPool(physicalPoolId);
+    PrepareAddZone(zoneId);
+    PrepareAddServer(serverId);
+    PrepareAddChunkServer(0x41, "token", "ssd", serverId, "/");
+    PrepareAddChunkServer(0x42, "token", "ssd", serverId, "/");
+
+    ASSERT_EQ(kTopoErrCodeSuccess,
+        topology_->UpdateChunkServerRwState(ChunkServerStatus::PENDDING, 0x41));
+    ASSERT_EQ(kTopoErrCodeSuccess,
+        topology_->UpdateChunkServerRwState(ChunkServerStatus::PENDDING, 0x42));
+
+    // 两个dirty的chunkserver一次批量刷入，失败后重新置dirty，
+    // 下一轮重新刷入，之后没有dirty的chunkserver不再访问存储
+    std::vector<ChunkServer> flushed;
+    EXPECT_CALL(*storage_, UpdateChunkServers(_))
+        .WillOnce(Return(false))
+        .WillOnce(DoAll(SaveArg<0>(&flushed), Return(true)));
+    topology_->Run();
+    // sleep 等待刷数据库
+    sleep(2);
+    topology_->Stop();
+    ASSERT_EQ(2, flushed.size());
+}
+
 TEST_F(TestTopology, UpdateChunkServerRwStateTestPhysicalPoolCapacity_success) {
     PoolIdType physicalPoolId = 0x11;
     ZoneIdType zoneId = 0x21;
@@ -2452,7 +2482,7 @@ TEST_F(TestTopology, UpdateCopySetTopo_success) {
     ASSERT_EQ(kTopoErrCodeSuccess, ret);
 
     // 只刷一次
-    EXPECT_CALL(*storage_, UpdateCopySet(_))
+    EXPECT_CALL(*storage_, UpdateCopySets(_))
         .WillOnce(Return(true));
     topology_->Run();
     // sleep 等待刷数据库
@@ -2460,6 +2490,62 @@ TEST_F(TestTopology, UpdateCopySetTopo_success) {
     topology_->Stop();
 }
 
+TEST_F(TestTopology, GetChangedCopySets) {
+    PoolIdType logicalPoolId = 0x01;
+    PoolIdType physicalPoolId = 0x11;
+    PrepareAddPhysicalPool(physicalPoolId);
+    PrepareAddLogicalPool(logicalPoolId, "logicalPool1", physicalPoolId);
+
+    // 0. 增加逻辑池之后需要全量重建
+    std::vector<CopySetKey> changed;
+    uint64_t version = 0;
+    ASSERT_FALSE(topology_->GetChangedCopySets(0, &changed, &version));
+    uint64_t base = version;
+
+    // 1. 增加copyset
+    PrepareAddCopySet(0x51, logicalPoolId, {0x41, 0x42, 0x43});
+    PrepareAddCopySet(0x52, logicalPoolId, {0x41, 0x42, 0x43});
+    ASSERT_TRUE(topology_->GetChangedCopySets(base, &changed, &version));
+    ASSERT_EQ(2, changed.size());
+    ASSERT_EQ(CopySetKey(logicalPoolId, 0x51), changed[0]);
+    ASSERT_EQ(CopySetKey(logicalPoolId, 0x52), changed[1]);
+    uint64_t lastVersion = version;
+
+    // 2. 更新copyset，同一个copyset多次变化只返回一次
+    CopySetInfo csInfo(logicalPoolId, 0x51);
+    csInfo.SetCopySetMembers({0x41, 0x42, 0x44});
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->UpdateCopySetTopo(csInfo));
+    csInfo.SetLeader(0x41);
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->UpdateCopySetTopo(csInfo));
+    ASSERT_TRUE(
+        topology_->GetChangedCopySets(lastVersion, &changed, &version));
+    ASSERT_EQ(1, changed.size());
+    ASSERT_EQ(CopySetKey(logicalPoolId, 0x51), changed[0]);
+    lastVersion = version;
+
+    // 3. 删除copyset
+    EXPECT_CALL(*storage_, DeleteCopySet(_))
+        .WillOnce(Return(true));
+    ASSERT_EQ(kTopoErrCodeSuccess,
+        topology_->RemoveCopySet(CopySetKey(logicalPoolId, 0x52)));
+    ASSERT_TRUE(
+        topology_->GetChangedCopySets(lastVersion, &changed, &version));
+    ASSERT_EQ(1, changed.size());
+    ASSERT_EQ(CopySetKey(logicalPoolId, 0x52), changed[0]);
+    lastVersion = version;
+
+    // 4. 逻辑池变化，需要全量重建
+    LogicalPool pool;
+    ASSERT_TRUE(topology_->GetLogicalPool(logicalPoolId, &pool));
+    EXPECT_CALL(*storage_, UpdateLogicalPool(_))
+        .WillOnce(Return(true));
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->UpdateLogicalPool(pool));
+    ASSERT_FALSE(
+        topology_->GetChangedCopySets(lastVersion, &changed, &version));
+    ASSERT_TRUE(topology_->GetChangedCopySets(version, &changed, &version));
+    ASSERT_TRUE(changed.empty());
+}
+
 TEST_F(TestTopology, UpdateCopySetTopo_CopySetNotFound) {
     PoolIdType logicalPoolId = 0x01;
     PoolIdType physicalPoolId = 0x11;
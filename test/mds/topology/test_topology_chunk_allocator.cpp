@@ -375,6 +375,131 @@ TEST_F(TestTopologyChunkAllocator,
     ASSERT_FALSE(ret);
 }
 
+TEST_F(TestTopologyChunkAllocator,
+    Test_AllocateChunkRandomInSingleLogicalPool_weightByTopologyStat) {
+    PoolIdType logicalPoolId = 0x01;
+    PoolIdType physicalPoolId = 0x11;
+
+    PrepareAddPhysicalPool(physicalPoolId);
+    PrepareAddZone(0x21, "zone1", physicalPoolId);
+    PrepareAddZone(0x22, "zone2", physicalPoolId);
+    PrepareAddZone(0x23, "zone3", physicalPoolId);
+    PrepareAddServer(0x31, "server1", "127.0.0.1", "127.0.0.1", 0x21, 0x11);
+    PrepareAddServer(0x32, "server2", "127.0.0.1", "127.0.0.1", 0x22, 0x11);
+    PrepareAddServer(0x33, "server3", "127.0.0.1", "127.0.0.1", 0x23, 0x11);
+    PrepareAddChunkServer(0x41, "token1", "nvme", 0x31, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x42, "token2", "nvme", 0x32, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x43, "token3", "nvme", 0x33, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x44, "token4", "nvme", 0x31, "127.0.0.1", 8201);
+    PrepareAddChunkServer(0x45, "token5", "nvme", 0x32, "127.0.0.1", 8201);
+    PrepareAddChunkServer(0x46, "token6", "nvme", 0x33, "127.0.0.1", 8201);
+    PrepareAddLogicalPool(logicalPoolId, "logicalPool1", physicalPoolId,
+        PAGEFILE);
+    PrepareAddCopySet(0x51, logicalPoolId, {0x41, 0x42, 0x43});
+    PrepareAddCopySet(0x52, logicalPoolId, {0x44, 0x45, 0x46});
+
+    EXPECT_CALL(*allocStatistic_, GetAllocByLogicalPool(_, _))
+        .WillRepeatedly(Return(true));
+
+    TopologyOption option;
+    option.PoolUsagePercentLimit = 85;
+    option.CopySetWeightUpdateIntervalMs = 0;
+    auto topologyStat = std::make_shared<TopologyStatImpl>(topology_);
+    auto allocator = std::make_shared<TopologyChunkAllocatorImpl>(
+        topology_, allocStatistic_, topologyStat, option);
+
+    ChunkServerStat stat;
+    stat.chunkSizeUsedBytes = 100;
+    stat.chunkSizeLeftBytes = 900;
+    for (ChunkServerIdType csId = 0x41; csId <= 0x46; csId++) {
+        topologyStat->UpdateChunkServerStat(csId, stat);
+    }
+
+    // 1. 负载和容量相同，两个copyset都能分配到
+    std::map<CopySetIdType, int> allocMap;
+    std::vector<CopysetIdInfo> infos;
+    ASSERT_TRUE(allocator->AllocateChunkRandomInSingleLogicalPool(
+        INODE_PAGEFILE, 1000, 1024, &infos));
+    ASSERT_EQ(1000, infos.size());
+    for (const auto &info : infos) {
+        allocMap[info.copySetId]++;
+    }
+    ASSERT_GT(allocMap[0x51], 0);
+    ASSERT_GT(allocMap[0x52], 0);
+
+    // 2. 0x41使用率超过上限，不再分配到0x51
+    ChunkServerStat fullStat;
+    fullStat.chunkSizeUsedBytes = 900;
+    fullStat.chunkSizeLeftBytes = 100;
+    topologyStat->UpdateChunkServerStat(0x41, fullStat);
+    ASSERT_TRUE(allocator->AllocateChunkRandomInSingleLogicalPool(
+        INODE_PAGEFILE, 1000, 1024, &infos));
+    for (const auto &info : infos) {
+        ASSERT_EQ(0x52, info.copySetId);
+    }
+
+    // 3. 0x44负载远高于平均值，分配倾向于0x51
+    topologyStat->UpdateChunkServerStat(0x41, stat);
+    ChunkServerStat hotStat = stat;
+    hotStat.readIOPS = 10000;
+    hotStat.writeIOPS = 10000;
+    topologyStat->UpdateChunkServerStat(0x44, hotStat);
+    allocMap.clear();
+    ASSERT_TRUE(allocator->AllocateChunkRandomInSingleLogicalPool(
+        INODE_PAGEFILE, 1000, 1024, &infos));
+    for (const auto &info : infos) {
+        allocMap[info.copySetId]++;
+    }
+    ASSERT_GT(allocMap[0x51], allocMap[0x52] * 2);
+}
+
+TEST_F(TestTopologyChunkAllocator,
+    Test_AllocateChunkRoundRobinInSingleLogicalPool_rebuildWhenTopoChange) {
+    PoolIdType logicalPoolId = 0x01;
+    PoolIdType physicalPoolId = 0x11;
+
+    PrepareAddPhysicalPool(physicalPoolId);
+    PrepareAddZone(0x21, "zone1", physicalPoolId);
+    PrepareAddZone(0x22, "zone2", physicalPoolId);
+    PrepareAddZone(0x23, "zone3", physicalPoolId);
+    PrepareAddServer(0x31, "server1", "127.0.0.1", "127.0.0.1", 0x21, 0x11);
+    PrepareAddServer(0x32, "server2", "127.0.0.1", "127.0.0.1", 0x22, 0x11);
+    PrepareAddServer(0x33, "server3", "127.0.0.1", "127.0.0.1", 0x23, 0x11);
+    PrepareAddChunkServer(0x41, "token1", "nvme", 0x31, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x42, "token2", "nvme", 0x32, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x43, "token3", "nvme", 0x33, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x44, "token4", "nvme", 0x31, "127.0.0.1", 8201);
+    PrepareAddChunkServer(0x45, "token5", "nvme", 0x32, "127.0.0.1", 8201);
+    PrepareAddChunkServer(0x46, "token6", "nvme", 0x33, "127.0.0.1", 8201);
+    PrepareAddLogicalPool(logicalPoolId, "logicalPool1", physicalPoolId,
+        PAGEFILE);
+    PrepareAddCopySet(0x51, logicalPoolId, {0x41, 0x42, 0x43});
+
+    EXPECT_CALL(*allocStatistic_, GetAllocByLogicalPool(_, _))
+        .WillRepeatedly(Return(true));
+
+    std::vector<CopysetIdInfo> infos;
+    ASSERT_TRUE(testObj_->AllocateChunkRoundRobinInSingleLogicalPool(
+        INODE_PAGEFILE, 2, 1024, &infos));
+    ASSERT_EQ(0x51, infos[0].copySetId);
+    ASSERT_EQ(0x51, infos[1].copySetId);
+
+    // 1. 新增copyset之后重建索引
+    PrepareAddCopySet(0x52, logicalPoolId, {0x44, 0x45, 0x46});
+    ASSERT_TRUE(testObj_->AllocateChunkRoundRobinInSingleLogicalPool(
+        INODE_PAGEFILE, 2, 1024, &infos));
+    ASSERT_NE(infos[0].copySetId, infos[1].copySetId);
+
+    // 2. chunkserver退役之后不再分配到其所在的copyset
+    ASSERT_EQ(kTopoErrCodeSuccess,
+        topology_->UpdateChunkServerRwState(ChunkServerStatus::RETIRED, 0x44));
+    ASSERT_TRUE(testObj_->AllocateChunkRoundRobinInSingleLogicalPool(
+        INODE_PAGEFILE, 4, 1024, &infos));
+    for (const auto &info : infos) {
+        ASSERT_EQ(0x51, info.copySetId);
+    }
+}
+
 TEST(TestAllocateChunkPolicy, TestAllocateChunkRandomInSingleLogicalPoolPoc) {
     // 2000个copyset分配100000次，每次分配64个chunk
     std::vector<CopySetIdType> copySetIds;
@@ -555,6 +680,29 @@ TEST(TestAllocateChunkPolicy,
               << "pool4 : " << poolMap[4] << std::endl;
 }
 
+TEST(TestAllocateChunkPolicy, TestAllocateChunkByWeightInSingleLogicalPool) {
+    std::vector<CopySetIdType> copySetIds = {1, 2, 3};
+    std::vector<double> weightPrefixSum = {1, 1, 4};
+    std::map<CopySetIdType, int> allocMap;
+    std::vector<CopysetIdInfo> infos;
+    ASSERT_TRUE(AllocateChunkPolicy::AllocateChunkByWeightInSingleLogicalPool(
+        copySetIds, weightPrefixSum, 1, 40000, &infos));
+    ASSERT_EQ(40000, infos.size());
+    for (const auto &info : infos) {
+        ASSERT_EQ(1, info.logicalPoolId);
+        allocMap[info.copySetId]++;
+    }
+    // copyset 2的权值为0，copyset 3的权值为copyset 1的3倍
+    ASSERT_EQ(0, allocMap[2]);
+    ASSERT_GT(allocMap[3], allocMap[1] * 2.5);
+    ASSERT_LT(allocMap[3], allocMap[1] * 3.5);
+
+    // 权值和copyset不匹配
+    weightPrefixSum.pop_back();
+    ASSERT_FALSE(AllocateChunkPolicy::AllocateChunkByWeightInSingleLogicalPool(
+        copySetIds, weightPrefixSum, 1, 1, &infos));
+}
+
 // 测试能否随机到每个pool
 TEST(TestAllocateChunkPolicy,
     TestChooseSingleLogicalPoolRandom) {
@@ -36,6 +36,7 @@ using ::testing::AllOf;
 using ::testing::SetArgPointee;
 using ::testing::Invoke;
 using ::testing::DoAll;
+using ::testing::SaveArg;
 
 namespace curve {
 namespace mds {
@@ -715,6 +716,71 @@ TEST_F(TestTopologyStorageEtcd, test_StotageCopyset_putInfoEtcdFail) {
     ASSERT_FALSE(ret);
 }
 
+TEST_F(TestTopologyStorageEtcd, test_UpdateChunkServers_success) {
+    std::vector<ChunkServer> datas;
+    datas.emplace_back(0x51, "token", "ssd", 0x41, "127.0.0.1", 8080,
+        "/root", ChunkServerStatus::READWRITE, OnlineState::OFFLINE);
+    datas.emplace_back(0x52, "token", "ssd", 0x41, "127.0.0.1", 8081,
+        "/root", ChunkServerStatus::READWRITE, OnlineState::OFFLINE);
+
+    std::vector<KVPair> kvs;
+    EXPECT_CALL(*kvStorageClient_, BatchPut(_))
+        .WillOnce(DoAll(SaveArg<0>(&kvs),
+                        Return(EtcdErrCode::EtcdOK)));
+
+    bool ret = storage_->UpdateChunkServers(datas);
+    ASSERT_TRUE(ret);
+    ASSERT_EQ(2, kvs.size());
+    ASSERT_EQ(codec_->EncodeChunkServerKey(0x51), kvs[0].first);
+    ASSERT_EQ(codec_->EncodeChunkServerKey(0x52), kvs[1].first);
+}
+
+TEST_F(TestTopologyStorageEtcd, test_UpdateChunkServers_putInfoEtcdFail) {
+    std::vector<ChunkServer> datas;
+    datas.emplace_back(0x51, "token", "ssd", 0x41, "127.0.0.1", 8080,
+        "/root", ChunkServerStatus::READWRITE, OnlineState::OFFLINE);
+
+    EXPECT_CALL(*kvStorageClient_, BatchPut(_))
+        .WillOnce(Return(EtcdErrCode::EtcdUnknown));
+
+    bool ret = storage_->UpdateChunkServers(datas);
+    ASSERT_FALSE(ret);
+}
+
+TEST_F(TestTopologyStorageEtcd, test_UpdateCopySets_success) {
+    std::vector<CopySetInfo> datas;
+    for (CopySetIdType id = 1; id <= 3; id++) {
+        CopySetInfo data(0x11, id);
+        data.SetEpoch(100);
+        data.SetCopySetMembers({0x51, 0x52, 0x53});
+        datas.push_back(data);
+    }
+
+    std::vector<KVPair> kvs;
+    EXPECT_CALL(*kvStorageClient_, BatchPut(_))
+        .WillOnce(DoAll(SaveArg<0>(&kvs),
+                        Return(EtcdErrCode::EtcdOK)));
+
+    bool ret = storage_->UpdateCopySets(datas);
+    ASSERT_TRUE(ret);
+    ASSERT_EQ(3, kvs.size());
+    CopySetInfo decoded;
+    ASSERT_TRUE(codec_->DecodeCopySetData(kvs[2].second, &decoded));
+    ASSERT_EQ(3, decoded.GetId());
+    ASSERT_EQ(100, decoded.GetEpoch());
+}
+
+TEST_F(TestTopologyStorageEtcd, test_UpdateCopySets_putInfoEtcdFail) {
+    std::vector<CopySetInfo> datas;
+    datas.emplace_back(0x11, 0x61);
+
+    EXPECT_CALL(*kvStorageClient_, BatchPut(_))
+        .WillOnce(Return(EtcdErrCode::EtcdUnknown));
+
+    bool ret = storage_->UpdateCopySets(datas);
+    ASSERT_FALSE(ret);
+}
+
 TEST_F(TestTopologyStorageEtcd, test_DeleteLogicalPool_success) {
     EXPECT_CALL(*kvStorageClient_, Delete(_))
         .WillOnce(Return(EtcdErrCode::EtcdOK));
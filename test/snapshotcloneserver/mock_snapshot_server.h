@@ -38,6 +38,7 @@
 #include "src/kvstorageclient/etcd_client.h"
 
 using ::curve::kvstorage::KVStorageClient;
+using ::curve::kvstorage::KVPair;
 
 namespace curve {
 namespace snapshotcloneserver {
@@ -100,8 +101,18 @@ class MockSnapshotCloneMetaStore : public SnapshotCloneMetaStore {
         int(const std::string &taskID, CloneInfo *info));
     MOCK_METHOD2(GetCloneInfoByFileName,
         int(const std::string &fileName, std::vector<CloneInfo> *list));
+    MOCK_METHOD2(GetCloneInfoByUser,
+        int(const std::string &user, std::vector<CloneInfo> *list));
     MOCK_METHOD1(GetCloneInfoList,
         int(std::vector<CloneInfo> *list));
+    MOCK_METHOD3(AddChunkDataRef,
+        int(const std::string &name, const std::string &hash,
+            uint32_t *refCount));
+    MOCK_METHOD2(GetChunkDataRef,
+        int(const std::string &name, std::string *hash));
+    MOCK_METHOD3(RemoveChunkDataRef,
+        int(const std::string &name, const std::string &hash,
+            uint32_t *refCount));
 };
 
 class MockSnapshotDataStore : public SnapshotDataStore {
@@ -137,6 +148,19 @@ class MockSnapshotDataStore : public SnapshotDataStore {
             int partNum,
             int partSize,
             const char* buf));
+    MOCK_METHOD6(DataChunkTranferAddPartAsync,
+        void(const ChunkDataName &name,
+            std::shared_ptr<TransferTask> task,
+            int partNum,
+            int partSize,
+            const char* buf,
+            TransferPartDone done));
+    MOCK_METHOD5(DataChunkTranferCopyPart,
+        int(const ChunkDataName &name,
+            std::shared_ptr<TransferTask> task,
+            int partNum,
+            int partSize,
+            const ChunkDataName &srcName));
     MOCK_METHOD2(DataChunkTranferComplete,
         int(const ChunkDataName &name,
             std::shared_ptr<TransferTask> task));
@@ -206,6 +230,14 @@ class MockCurveFsClient : public CurveFsClient {
         uint64_t chunkSize,
         SnapCloneClosure* scc));
 
+    MOCK_METHOD6(CreateCloneChunks,
+        int(const ChunkIDInfo &copysetidinfo,
+        const std::vector<CloneChunkDesc> &chunks,
+        uint64_t csn,
+        uint64_t chunkSize,
+        std::vector<ChunkID> *existChunkIds,
+        SnapCloneClosure* scc));
+
     MOCK_METHOD4(RecoverChunk,
         int(const ChunkIDInfo &chunkidinfo,
         uint64_t offset,
@@ -371,6 +403,9 @@ class MockCloneCore : public CloneCore {
     MOCK_METHOD2(GetCloneInfoByFileName,
         int(const std::string &fileName, std::vector<CloneInfo> *list));
 
+    MOCK_METHOD2(GetCloneInfoByUser,
+        int(const std::string &user, std::vector<CloneInfo> *list));
+
     MOCK_METHOD0(GetSnapshotRef,
         std::shared_ptr<SnapshotReference>());
 
@@ -390,6 +425,9 @@ class MockKVStorageClient : public KVStorageClient {
         int(const std::string&, const std::string&, std::vector<std::string>*));
     MOCK_METHOD1(Delete, int(const std::string&));
     MOCK_METHOD1(TxnN, int(const std::vector<Operation>&));
+    MOCK_METHOD2(TxnWithRevision,
+        int(const std::vector<Operation>&, int64_t *));
+    MOCK_METHOD1(BatchPut, int(const std::vector<KVPair>&));
     MOCK_METHOD3(CompareAndSwap, int(const std::string&, const std::string&,
         const std::string&));
     MOCK_METHOD5(CampaignLeader, int(const std::string&, const std::string&,
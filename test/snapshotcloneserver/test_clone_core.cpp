@@ -60,6 +60,7 @@ class TestCloneCoreImpl : public ::testing::Test {
         option.cloneChunkSplitSize = 1024 * 1024;
         option.mdsRootUser = "root";
         option.createCloneChunkConcurrency = 2;
+        option.createCloneChunkBatchSize = 0;
         option.recoverChunkConcurrency = 2;
         option.clientAsyncMethodRetryTimeSec = 1;
         option.clientAsyncMethodRetryIntervalMs = 500;
@@ -609,6 +610,50 @@ TEST_F(TestCloneCoreImpl,
     core_->HandleCloneOrRecoverTask(task);
 }
 
+TEST_F(TestCloneCoreImpl,
+    HandleCloneOrRecoverTaskStage2RecoverWholeChunk) {
+    option.cloneChunkSplitSize = 0;
+    core_ = std::make_shared<CloneCoreImpl>(client_,
+        metaStore_,
+        dataStore_,
+        snapshotRef_,
+        cloneRef_,
+        option);
+    EXPECT_CALL(*client_, Mkdir(_, _))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+    ASSERT_EQ(core_->Init(), 0);
+
+    CloneInfo info("id1", "user1", CloneTaskType::kClone,
+    "snapid1", "file1", 1, 2, 100, CloneFileType::kSnapshot, true,
+    CloneStep::kRecoverChunk, CloneStatus::cloning);
+    info.SetStatus(CloneStatus::cloning);
+    auto cloneMetric = std::make_shared<CloneInfoMetric>("id1");
+    auto cloneClosure = std::make_shared<CloneClosure>();
+    std::shared_ptr<CloneTaskInfo> task =
+        std::make_shared<CloneTaskInfo>(info, cloneMetric, cloneClosure);
+
+    EXPECT_CALL(*metaStore_, UpdateCloneInfo(_))
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    MockBuildFileInfoFromSnapshotSuccess(task);
+    MockCloneMetaSuccess(task);
+    // 分片大小为0时每个chunk只发送一次覆盖整个chunk的请求
+    EXPECT_CALL(*client_, RecoverChunk(_, 0, 1024 * 1024, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(
+                    Invoke([](const ChunkIDInfo &chunkidinfo,
+                              uint64_t offset,
+                              uint64_t len,
+                              SnapCloneClosure* scc){
+                        scc->SetRetCode(LIBCURVE_ERROR::OK),
+                        scc->Run();
+                        }),
+                    Return(LIBCURVE_ERROR::OK)));
+    MockCompleteCloneFileSuccess(task);
+    core_->HandleCloneOrRecoverTask(task);
+    ASSERT_EQ(CloneStatus::done, task->GetCloneInfo().GetStatus());
+}
+
 TEST_F(TestCloneCoreImpl,
     HandleCloneOrRecoverTaskSuccessForCloneBySnapshotNotLazy) {
     CloneInfo info("id1", "user1", CloneTaskType::kClone,
@@ -635,6 +680,91 @@ TEST_F(TestCloneCoreImpl,
     core_->HandleCloneOrRecoverTask(task);
 }
 
+TEST_F(TestCloneCoreImpl,
+    HandleCloneOrRecoverTaskCreateCloneChunkInBatch) {
+    option.createCloneChunkBatchSize = 2;
+    core_ = std::make_shared<CloneCoreImpl>(client_,
+        metaStore_,
+        dataStore_,
+        snapshotRef_,
+        cloneRef_,
+        option);
+    EXPECT_CALL(*client_, Mkdir(_, _))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+    ASSERT_EQ(core_->Init(), 0);
+
+    CloneInfo info("id1", "user1", CloneTaskType::kClone,
+    "snapid1", "file1", CloneFileType::kSnapshot, false);
+    info.SetStatus(CloneStatus::cloning);
+    auto cloneMetric = std::make_shared<CloneInfoMetric>("id1");
+    auto cloneClosure = std::make_shared<CloneClosure>();
+    std::shared_ptr<CloneTaskInfo> task =
+        std::make_shared<CloneTaskInfo>(info, cloneMetric, cloneClosure);
+
+    EXPECT_CALL(*metaStore_, UpdateCloneInfo(_))
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    MockBuildFileInfoFromSnapshotSuccess(task);
+    MockCreateCloneFileSuccess(task);
+
+    // 两个chunk在同一个copyset上
+    uint32_t chunksize = 1024 * 1024;
+    SegmentInfo segInfoOut;
+    segInfoOut.segmentsize = 2 * chunksize;
+    segInfoOut.chunksize = chunksize;
+    segInfoOut.startoffset = 0;
+    segInfoOut.chunkvec = {{1, 1, 1},
+                           {2, 1, 1}};
+    segInfoOut.lpcpIDInfo.lpid = 1;
+    segInfoOut.lpcpIDInfo.cpidVec = {1};
+    EXPECT_CALL(*client_, GetOrAllocateSegmentInfo(_, 0, _, _, _))
+        .WillRepeatedly(
+            DoAll(SetArgPointee<4>(segInfoOut),
+                Return(LIBCURVE_ERROR::OK)));
+
+    // 两个chunk通过一次请求创建，chunk2已存在
+    EXPECT_CALL(*client_, CreateCloneChunk(_, _, _, _, _, _))
+        .Times(0);
+    EXPECT_CALL(*client_, CreateCloneChunks(_, _, 0, chunksize, _, _))
+        .WillOnce(DoAll(
+            Invoke([](const ChunkIDInfo &copysetidinfo,
+                      const std::vector<CloneChunkDesc> &chunks,
+                      uint64_t csn,
+                      uint64_t chunkSize,
+                      std::vector<ChunkID> *existChunkIds,
+                      SnapCloneClosure* scc){
+                    ASSERT_EQ(1, copysetidinfo.lpid_);
+                    ASSERT_EQ(1, copysetidinfo.cpid_);
+                    ASSERT_EQ(2, chunks.size());
+                    ASSERT_EQ(1, chunks[0].cid);
+                    ASSERT_EQ(2, chunks[1].cid);
+                    existChunkIds->push_back(2);
+                    scc->SetRetCode(LIBCURVE_ERROR::OK);
+                    scc->Run();
+                }),
+            Return(LIBCURVE_ERROR::OK)));
+    MockCompleteCloneMetaSuccess(task);
+
+    // 已存在的chunk不需要恢复
+    EXPECT_CALL(*client_, RecoverChunk(_, _, _, _))
+        .WillOnce(DoAll(
+                    Invoke([](const ChunkIDInfo &chunkidinfo,
+                              uint64_t offset,
+                              uint64_t len,
+                              SnapCloneClosure* scc){
+                        ASSERT_EQ(1, chunkidinfo.cid_);
+                        scc->SetRetCode(LIBCURVE_ERROR::OK),
+                        scc->Run();
+                        }),
+                    Return(LIBCURVE_ERROR::OK)));
+    MockCompleteCloneFileSuccess(task);
+    MockChangeOwnerSuccess(task);
+    MockRenameCloneFileSuccess(task);
+
+    core_->HandleCloneOrRecoverTask(task);
+    ASSERT_EQ(CloneStatus::done, task->GetCloneInfo().GetStatus());
+}
+
 TEST_F(TestCloneCoreImpl,
     HandleCloneOrRecoverTaskFailOnBuildFileInfoFromSnapshot) {
     CloneInfo info("id1", "user1", CloneTaskType::kClone,
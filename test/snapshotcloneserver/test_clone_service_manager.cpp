@@ -473,8 +473,8 @@ TEST_F(TestCloneServiceManager, TestGetCloneTaskInfoSuccess) {
 
     std::vector<CloneInfo> cloneInfos;
     cloneInfos.push_back(cloneInfo);
-    EXPECT_CALL(*cloneCore_, GetCloneInfoList(_))
-        .WillOnce(DoAll(SetArgPointee<0>(cloneInfos),
+    EXPECT_CALL(*cloneCore_, GetCloneInfoByUser(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(cloneInfos),
             Return(kErrCodeSuccess)));
 
     std::vector<TaskCloneInfo> infos;
@@ -621,8 +621,8 @@ TEST_F(TestCloneServiceManager, TestGetCloneTaskInfoByFileNameSuccess) {
 
 TEST_F(TestCloneServiceManager, TestGetCloneTaskInfoFailNotExist) {
     std::vector<CloneInfo> cloneInfos;
-    EXPECT_CALL(*cloneCore_, GetCloneInfoList(_))
-        .WillOnce(DoAll(SetArgPointee<0>(cloneInfos),
+    EXPECT_CALL(*cloneCore_, GetCloneInfoByUser(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(cloneInfos),
             Return(-1)));
 
     std::vector<TaskCloneInfo> infos;
@@ -744,8 +744,8 @@ TEST_F(TestCloneServiceManager, TestGetCloneTaskInfoSuccessCloneTaskDone) {
 
     std::vector<CloneInfo> cloneInfos;
     cloneInfos.push_back(cloneInfo);
-    EXPECT_CALL(*cloneCore_, GetCloneInfoList(_))
-        .WillOnce(DoAll(SetArgPointee<0>(cloneInfos),
+    EXPECT_CALL(*cloneCore_, GetCloneInfoByUser(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(cloneInfos),
             Return(kErrCodeSuccess)));
 
     std::vector<TaskCloneInfo> infos;
@@ -776,8 +776,8 @@ TEST_F(TestCloneServiceManager, TestGetCloneTaskInfoSuccessCloneTaskError) {
 
     std::vector<CloneInfo> cloneInfos;
     cloneInfos.push_back(cloneInfo);
-    EXPECT_CALL(*cloneCore_, GetCloneInfoList(_))
-        .WillOnce(DoAll(SetArgPointee<0>(cloneInfos),
+    EXPECT_CALL(*cloneCore_, GetCloneInfoByUser(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(cloneInfos),
             Return(kErrCodeSuccess)));
 
     std::vector<TaskCloneInfo> infos;
@@ -808,8 +808,8 @@ TEST_F(TestCloneServiceManager, TestGetCloneTaskInfoSuccessCloneTaskDone2) {
 
     std::vector<CloneInfo> cloneInfos;
     cloneInfos.push_back(cloneInfo);
-    EXPECT_CALL(*cloneCore_, GetCloneInfoList(_))
-        .WillOnce(DoAll(SetArgPointee<0>(cloneInfos),
+    EXPECT_CALL(*cloneCore_, GetCloneInfoByUser(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(cloneInfos),
             Return(kErrCodeSuccess)));
 
     cloneInfo.SetStatus(CloneStatus::done);
@@ -845,8 +845,8 @@ TEST_F(TestCloneServiceManager, TestGetCloneTaskInfoSuccessCloneTaskError2) {
 
     std::vector<CloneInfo> cloneInfos;
     cloneInfos.push_back(cloneInfo);
-    EXPECT_CALL(*cloneCore_, GetCloneInfoList(_))
-        .WillOnce(DoAll(SetArgPointee<0>(cloneInfos),
+    EXPECT_CALL(*cloneCore_, GetCloneInfoByUser(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(cloneInfos),
             Return(kErrCodeSuccess)));
 
     cloneInfo.SetStatus(CloneStatus::error);
@@ -882,8 +882,8 @@ TEST_F(TestCloneServiceManager, TestGetCloneTaskInfoFailCanNotReach) {
 
     std::vector<CloneInfo> cloneInfos;
     cloneInfos.push_back(cloneInfo);
-    EXPECT_CALL(*cloneCore_, GetCloneInfoList(_))
-        .WillOnce(DoAll(SetArgPointee<0>(cloneInfos),
+    EXPECT_CALL(*cloneCore_, GetCloneInfoByUser(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(cloneInfos),
             Return(kErrCodeSuccess)));
 
     EXPECT_CALL(*cloneCore_, GetCloneInfo(_, _))
@@ -908,8 +908,8 @@ TEST_F(TestCloneServiceManager, TestGetCloneTaskInfoFailOnGetCloneInfo) {
 
     std::vector<CloneInfo> cloneInfos;
     cloneInfos.push_back(cloneInfo);
-    EXPECT_CALL(*cloneCore_, GetCloneInfoList(_))
-        .WillOnce(DoAll(SetArgPointee<0>(cloneInfos),
+    EXPECT_CALL(*cloneCore_, GetCloneInfoByUser(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(cloneInfos),
             Return(kErrCodeSuccess)));
 
     EXPECT_CALL(*cloneCore_, GetCloneInfo(_, _))
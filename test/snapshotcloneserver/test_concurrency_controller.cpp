@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 20261018
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+
+#include "src/snapshotcloneserver/common/concurrency_controller.h"
+#include "src/snapshotcloneserver/clone/clone_task.h"
+
+namespace curve {
+namespace snapshotcloneserver {
+
+TEST(TestConcurrencyController, AIMDTest) {
+    ConcurrencyControllerOption option;
+    option.maxConcurrency = 8;
+    option.minConcurrency = 2;
+    option.chunkServerLatencyTargetUs = 1000;
+    option.s3LatencyTargetUs = 1000;
+    ConcurrencyController controller(option);
+    ASSERT_EQ(8, controller.GetLimit());
+
+    // 延迟低于目标时不超过上限
+    controller.OnChunkServerResponse(100, true);
+    ASSERT_EQ(8, controller.GetLimit());
+
+    // 延迟超过目标时乘性减小，一个目标延迟内只减小一次
+    controller.OnChunkServerResponse(2000, true);
+    ASSERT_EQ(4, controller.GetLimit());
+    controller.OnChunkServerResponse(2000, true);
+    ASSERT_EQ(4, controller.GetLimit());
+
+    // s3和chunkserver分别计算减小的间隔
+    controller.OnS3Response(500, true);
+    ASSERT_EQ(4, controller.GetLimit());
+    controller.OnS3Response(100, false);
+    ASSERT_EQ(2, controller.GetLimit());
+
+    // 不低于下限
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    controller.OnChunkServerResponse(100, false);
+    ASSERT_EQ(2, controller.GetLimit());
+
+    // 每完成一个窗口的请求加性增加
+    controller.OnChunkServerResponse(100, true);
+    controller.OnChunkServerResponse(100, true);
+    ASSERT_EQ(2, controller.GetLimit());
+    controller.OnChunkServerResponse(100, true);
+    ASSERT_EQ(3, controller.GetLimit());
+}
+
+TEST(TestConcurrencyController, FairShareTest) {
+    ConcurrencyControllerOption option;
+    option.maxConcurrency = 4;
+    option.minConcurrency = 1;
+    ConcurrencyController controller(option);
+
+    // 没有其他租户时可以使用全部额度
+    for (int i = 0; i < 4; i++) {
+        controller.Acquire("user1");
+    }
+    ASSERT_EQ(4, controller.GetInflight());
+
+    // 超过全局上限时等待
+    std::atomic<bool> acquired1(false);
+    std::thread t1([&] () {
+        controller.Acquire("user2");
+        acquired1 = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(acquired1);
+    controller.Release("user1");
+    t1.join();
+    ASSERT_TRUE(acquired1);
+
+    // user1超过公平份额，优先分配给user2
+    std::atomic<bool> acquired2(false);
+    std::atomic<bool> acquired3(false);
+    std::thread t2([&] () {
+        controller.Acquire("user1");
+        acquired2 = true;
+    });
+    std::thread t3([&] () {
+        controller.Acquire("user2");
+        acquired3 = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    controller.Release("user1");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_FALSE(acquired2);
+    ASSERT_TRUE(acquired3);
+
+    // user2没有等待的请求时，user1可以使用空闲的额度
+    controller.Release("user2");
+    t2.join();
+    t3.join();
+    ASSERT_TRUE(acquired2);
+    ASSERT_EQ(4, controller.GetInflight());
+    for (int i = 0; i < 3; i++) {
+        controller.Release("user1");
+    }
+    controller.Release("user2");
+    ASSERT_EQ(0, controller.GetInflight());
+}
+
+TEST(TestConcurrencyController, SlotTest) {
+    ConcurrencyControllerOption option;
+    option.maxConcurrency = 4;
+    option.chunkServerLatencyTargetUs = 1000000;
+    auto controller = std::make_shared<ConcurrencyController>(option);
+
+    // 没有controller时不做控制
+    ConcurrencySlot slot;
+    slot.Acquire(nullptr, "user1");
+    slot.Release(true);
+    ASSERT_EQ(0, controller->GetInflight());
+
+    slot.Acquire(controller, "user1");
+    ASSERT_EQ(1, controller->GetInflight());
+    slot.Release(false);
+    ASSERT_EQ(0, controller->GetInflight());
+    ASSERT_EQ(2, controller->GetLimit());
+
+    // 重复归还不影响计数
+    slot.Release(true);
+    ASSERT_EQ(0, controller->GetInflight());
+}
+
+TEST(TestConcurrencyController, CreateCloneChunkExistTest) {
+    ConcurrencyControllerOption option;
+    option.maxConcurrency = 4;
+    option.chunkServerLatencyTargetUs = 1000000;
+    auto controller = std::make_shared<ConcurrencyController>(option);
+    auto tracker = std::make_shared<CreateCloneChunkTaskTracker>();
+
+    auto runClosure = [&](int retCode) {
+        auto context = std::make_shared<CreateCloneChunkContext>();
+        context->slot.Acquire(controller, "user1");
+        tracker->AddOneTrace();
+        CreateCloneChunkClosure *closure =
+            new CreateCloneChunkClosure(tracker, context);
+        closure->SetRetCode(retCode);
+        closure->Run();
+    };
+
+    // chunk已经存在是正常的返回，不减小并发上限
+    runClosure(-LIBCURVE_ERROR::EXISTS);
+    ASSERT_EQ(0, controller->GetInflight());
+    ASSERT_EQ(4, controller->GetLimit());
+
+    runClosure(LIBCURVE_ERROR::OK);
+    ASSERT_EQ(0, controller->GetInflight());
+    ASSERT_EQ(4, controller->GetLimit());
+
+    // 请求失败时减小并发上限
+    runClosure(-LIBCURVE_ERROR::FAILED);
+    ASSERT_EQ(0, controller->GetInflight());
+    ASSERT_EQ(2, controller->GetLimit());
+    ASSERT_EQ(3, tracker->PopResultContexts().size());
+}
+
+}  // namespace snapshotcloneserver
+}  // namespace curve
@@ -23,6 +23,11 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <thread>  // NOLINT
+
 #include "src/snapshotcloneserver/snapshot/snapshot_core.h"
 #include "src/snapshotcloneserver/common/define.h"
 #include "src/snapshotcloneserver/snapshot/snapshot_task.h"
@@ -40,6 +45,11 @@ using ::testing::AllOf;
 using ::testing::SetArgPointee;
 using ::testing::Invoke;
 using ::testing::DoAll;
+using ::testing::SaveArg;
+
+// 单独测试转储chunk时使用的chunk大小和分片大小
+const uint64_t kChunkSize = 4096;
+const uint64_t kChunkSplitSize = 1024;
 
 class TestSnapshotCoreImpl : public ::testing::Test {
  public:
@@ -60,6 +70,9 @@ class TestSnapshotCoreImpl : public ::testing::Test {
         option.snapshotCoreThreadNum = 1;
         option.clientAsyncMethodRetryTimeSec = 1;
         option.clientAsyncMethodRetryIntervalMs = 500;
+        option.elideZeroChunk = false;
+        option.uploadPartConcurrency = 0;
+        option.contentAddressedChunk = false;
         core_ = std::make_shared<SnapshotCoreImpl>(client_,
                 metaStore_,
                 dataStore_,
@@ -75,7 +88,43 @@ class TestSnapshotCoreImpl : public ::testing::Test {
         core_ = nullptr;
     }
 
+    /**
+     * @brief 转储一个4个分片的chunk，返回转储结果
+     */
+    int TransferSnapshotDataChunk(uint32_t uploadPartConcurrency) {
+        auto taskInfo = std::make_shared<TransferSnapshotDataChunkTaskInfo>(
+            ChunkDataName("file", 1, 0), kChunkSize,
+            ChunkIDInfo(1, 1, 1), kChunkSplitSize, 0, 0, 4);
+        taskInfo->uploadPartConcurrency_ = uploadPartConcurrency;
+        auto tracker = std::make_shared<TaskTracker>();
+        auto task = new TransferSnapshotDataChunkTask(
+            "task", taskInfo, client_, dataStore_);
+        task->SetTracker(tracker);
+        tracker->AddOneTrace();
+        task->Run();
+        tracker->Wait();
+        return tracker->GetResult();
+    }
+
+    void ExpectReadChunkSnapshotSuccess(int times) {
+        EXPECT_CALL(*client_, ReadChunkSnapshot(_, _, _, _, _, _))
+            .Times(times)
+            .WillRepeatedly(DoAll(
+                Invoke([](ChunkIDInfo cidinfo,
+                    uint64_t seq,
+                    uint64_t offset,
+                    uint64_t len,
+                    char *buf,
+                    SnapCloneClosure* scc){
+                    memset(buf, 1, len);
+                    scc->SetRetCode(LIBCURVE_ERROR::OK);
+                    scc->Run();
+                }),
+                Return(LIBCURVE_ERROR::OK)));
+    }
+
  protected:
+
     std::shared_ptr<SnapshotCoreImpl> core_;
     std::shared_ptr<MockCurveFsClient> client_;
     std::shared_ptr<MockSnapshotCloneMetaStore> metaStore_;
@@ -516,6 +565,408 @@ TEST_F(TestSnapshotCoreImpl,
     ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
 }
 
+TEST_F(TestSnapshotCoreImpl,
+    TestHandleCreateSnapshotTaskElideZeroChunk) {
+    option.elideZeroChunk = true;
+    core_ = std::make_shared<SnapshotCoreImpl>(client_,
+            metaStore_,
+            dataStore_,
+            snapshotRef_,
+            option);
+    ASSERT_EQ(core_->Init(), 0);
+
+    UUID uuid = "uuid1";
+    std::string user = "user1";
+    std::string fileName = "file1";
+    std::string desc = "snap1";
+    uint64_t seqNum = 100;
+
+    SnapshotInfo info(uuid, user, fileName, desc);
+    info.SetStatus(Status::pending);
+
+    auto snapshotInfoMetric = std::make_shared<SnapshotInfoMetric>(uuid);
+    std::shared_ptr<SnapshotTaskInfo> task =
+        std::make_shared<SnapshotTaskInfo>(info, snapshotInfoMetric);
+
+    EXPECT_CALL(*client_, CreateSnapshot(fileName, user, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<2>(seqNum),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    FInfo snapInfo;
+    snapInfo.seqnum = 100;
+    snapInfo.chunksize = 2 * option.chunkSplitSize;
+    snapInfo.segmentsize = 2 * snapInfo.chunksize;
+    snapInfo.length = 2 * snapInfo.segmentsize;
+    snapInfo.ctime = 10;
+    EXPECT_CALL(*client_, GetSnapshot(fileName, user, seqNum, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<3>(snapInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*metaStore_, UpdateSnapshot(_))
+        .Times(2)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    SegmentInfo segInfo1;
+    segInfo1.chunkvec.push_back(ChunkIDInfo(1, 1, 1));
+    segInfo1.chunkvec.push_back(ChunkIDInfo(2, 2, 2));
+    SegmentInfo segInfo2;
+    segInfo2.chunkvec.push_back(ChunkIDInfo(3, 3, 3));
+    segInfo2.chunkvec.push_back(ChunkIDInfo(4, 4, 4));
+    EXPECT_CALL(*client_, GetSnapshotSegmentInfo(fileName,
+            user,
+            seqNum,
+            _,
+            _))
+        .Times(2)
+        .WillOnce(DoAll(SetArgPointee<4>(segInfo1),
+                    Return(LIBCURVE_ERROR::OK)))
+        .WillOnce(DoAll(SetArgPointee<4>(segInfo2),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    ChunkInfoDetail chunkInfo;
+    chunkInfo.chunkSn.push_back(100);
+    EXPECT_CALL(*client_, GetChunkInfo(_, _))
+        .Times(4)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    // 第一次保存完整的索引，转储之后移除全0的chunk重新保存
+    std::vector<ChunkIndexType> indexAfterTransfer;
+    EXPECT_CALL(*dataStore_, PutChunkIndexData(_, _))
+        .WillOnce(Return(kErrCodeSuccess))
+        .WillOnce(Invoke([&indexAfterTransfer](
+                const ChunkIndexDataName &name,
+                const ChunkIndexData &meta) {
+                indexAfterTransfer = meta.GetAllChunkIndex();
+                return kErrCodeSuccess;
+            }));
+
+    std::vector<SnapshotInfo> snapInfos;
+    info.SetSeqNum(seqNum);
+    snapInfos.push_back(info);
+    EXPECT_CALL(*metaStore_, GetSnapshotList(fileName, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(
+                    SetArgPointee<1>(snapInfos),
+                    Return(kErrCodeSuccess)));
+
+    // chunk1全为0，chunk2的第一个分片为0，其余分片不为0
+    EXPECT_CALL(*client_, ReadChunkSnapshot(_, _, _, _, _, _))
+        .Times(8)
+        .WillRepeatedly(DoAll(
+                    Invoke([](ChunkIDInfo cidinfo,
+                        uint64_t seq,
+                        uint64_t offset,
+                        uint64_t len,
+                        char *buf,
+                        SnapCloneClosure* scc){
+                        memset(buf, 0, len);
+                        if (cidinfo.cid_ > 2 ||
+                            (cidinfo.cid_ == 2 && offset > 0)) {
+                            buf[len - 1] = 1;
+                        }
+                        scc->SetRetCode(LIBCURVE_ERROR::OK);
+                        scc->Run();
+                        }),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferInit(_, _))
+        .Times(3)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPart(_, _, _, _, _))
+        .Times(6)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferComplete(_, _))
+        .Times(3)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*client_, DeleteSnapshot(fileName, user, seqNum))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+
+    EXPECT_CALL(*client_, CheckSnapShotStatus(_, _, _, _))
+        .WillOnce(Return(-LIBCURVE_ERROR::NOTEXIST));
+
+    core_->HandleCreateSnapshotTask(task);
+
+    ASSERT_TRUE(task->IsFinish());
+    ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
+    ASSERT_EQ(3, indexAfterTransfer.size());
+    ASSERT_EQ(1, indexAfterTransfer[0]);
+}
+
+TEST_F(TestSnapshotCoreImpl,
+    TestHandleCreateSnapshotTaskContentAddressedChunk) {
+    option.contentAddressedChunk = true;
+    core_ = std::make_shared<SnapshotCoreImpl>(client_,
+            metaStore_,
+            dataStore_,
+            snapshotRef_,
+            option);
+    ASSERT_EQ(core_->Init(), 0);
+
+    UUID uuid = "uuid1";
+    std::string user = "user1";
+    std::string fileName = "file1";
+    std::string desc = "snap1";
+    uint64_t seqNum = 100;
+
+    SnapshotInfo info(uuid, user, fileName, desc);
+    info.SetStatus(Status::pending);
+
+    auto snapshotInfoMetric = std::make_shared<SnapshotInfoMetric>(uuid);
+    std::shared_ptr<SnapshotTaskInfo> task =
+        std::make_shared<SnapshotTaskInfo>(info, snapshotInfoMetric);
+
+    EXPECT_CALL(*client_, CreateSnapshot(fileName, user, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<2>(seqNum),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    FInfo snapInfo;
+    snapInfo.seqnum = 100;
+    snapInfo.chunksize = 2 * option.chunkSplitSize;
+    snapInfo.segmentsize = 2 * snapInfo.chunksize;
+    snapInfo.length = snapInfo.segmentsize;
+    snapInfo.ctime = 10;
+    EXPECT_CALL(*client_, GetSnapshot(fileName, user, seqNum, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<3>(snapInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*metaStore_, UpdateSnapshot(_))
+        .Times(2)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    SegmentInfo segInfo;
+    segInfo.chunkvec.push_back(ChunkIDInfo(1, 1, 1));
+    segInfo.chunkvec.push_back(ChunkIDInfo(2, 2, 2));
+    EXPECT_CALL(*client_, GetSnapshotSegmentInfo(fileName,
+            user,
+            seqNum,
+            _,
+            _))
+        .WillOnce(DoAll(SetArgPointee<4>(segInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    ChunkInfoDetail chunkInfo;
+    chunkInfo.chunkSn.push_back(100);
+    EXPECT_CALL(*client_, GetChunkInfo(_, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    // 转储之后在索引中记录内容哈希并重新保存
+    ChunkIndexData indexAfterTransfer;
+    EXPECT_CALL(*dataStore_, PutChunkIndexData(_, _))
+        .WillOnce(Return(kErrCodeSuccess))
+        .WillOnce(DoAll(SaveArg<1>(&indexAfterTransfer),
+                    Return(kErrCodeSuccess)));
+
+    std::vector<SnapshotInfo> snapInfos;
+    info.SetSeqNum(seqNum);
+    snapInfos.push_back(info);
+    EXPECT_CALL(*metaStore_, GetSnapshotList(fileName, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(
+                    SetArgPointee<1>(snapInfos),
+                    Return(kErrCodeSuccess)));
+
+    EXPECT_CALL(*metaStore_, GetChunkDataRef(_, _))
+        .Times(2)
+        .WillRepeatedly(Return(-1));
+
+    // 两个chunk的内容相同
+    EXPECT_CALL(*client_, ReadChunkSnapshot(_, _, _, _, _, _))
+        .Times(4)
+        .WillRepeatedly(DoAll(
+                    Invoke([](ChunkIDInfo cidinfo,
+                        uint64_t seq,
+                        uint64_t offset,
+                        uint64_t len,
+                        char *buf,
+                        SnapCloneClosure* scc){
+                        memset(buf, 1, len);
+                        scc->SetRetCode(LIBCURVE_ERROR::OK);
+                        scc->Run();
+                        }),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    std::vector<std::string> refHashs;
+    EXPECT_CALL(*metaStore_, AddChunkDataRef(_, _, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([&refHashs](const std::string &name,
+                const std::string &hash, uint32_t *refCount) {
+                refHashs.push_back(hash);
+                *refCount = refHashs.size();
+                return kErrCodeSuccess;
+            }));
+
+    // 第二个chunk的内容已经存在，只增加引用不再上传
+    EXPECT_CALL(*dataStore_, ChunkDataExist(_))
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferInit(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPart(_, _, _, _, _))
+        .Times(2)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferComplete(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*client_, DeleteSnapshot(fileName, user, seqNum))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+
+    EXPECT_CALL(*client_, CheckSnapShotStatus(_, _, _, _))
+        .WillOnce(Return(-LIBCURVE_ERROR::NOTEXIST));
+
+    core_->HandleCreateSnapshotTask(task);
+
+    ASSERT_TRUE(task->IsFinish());
+    ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
+    ASSERT_EQ(2, refHashs.size());
+    ASSERT_EQ(64, refHashs[0].size());
+    ASSERT_EQ(refHashs[0], refHashs[1]);
+    ChunkDataName name0, name1;
+    ASSERT_TRUE(indexAfterTransfer.GetChunkDataName(0, &name0));
+    ASSERT_TRUE(indexAfterTransfer.GetChunkDataName(1, &name1));
+    ASSERT_EQ(name0.ToDataChunkKey(), name1.ToDataChunkKey());
+    ASSERT_EQ("cas-" + refHashs[0], name0.ToDataChunkKey());
+}
+
+TEST_F(TestSnapshotCoreImpl,
+    TestHandleCreateSnapshotTaskIncremental) {
+    UUID uuid = "uuid1";
+    std::string user = "user1";
+    std::string fileName = "file1";
+    std::string desc = "snap1";
+    uint64_t seqNum = 100;
+
+    SnapshotInfo info(uuid, user, fileName, desc);
+    info.SetStatus(Status::pending);
+
+    auto snapshotInfoMetric = std::make_shared<SnapshotInfoMetric>(uuid);
+    std::shared_ptr<SnapshotTaskInfo> task =
+        std::make_shared<SnapshotTaskInfo>(info, snapshotInfoMetric);
+
+    EXPECT_CALL(*client_, CreateSnapshot(fileName, user, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<2>(seqNum),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    FInfo snapInfo;
+    snapInfo.seqnum = 100;
+    snapInfo.chunksize = 2 * option.chunkSplitSize;
+    snapInfo.segmentsize = 2 * snapInfo.chunksize;
+    snapInfo.length = snapInfo.segmentsize;
+    snapInfo.ctime = 10;
+    EXPECT_CALL(*client_, GetSnapshot(fileName, user, seqNum, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<3>(snapInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*metaStore_, UpdateSnapshot(_))
+        .Times(2)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    SegmentInfo segInfo;
+    segInfo.chunkvec.push_back(ChunkIDInfo(1, 1, 1));
+    segInfo.chunkvec.push_back(ChunkIDInfo(2, 2, 2));
+    EXPECT_CALL(*client_, GetSnapshotSegmentInfo(fileName,
+            user,
+            seqNum,
+            _,
+            _))
+        .WillOnce(DoAll(SetArgPointee<4>(segInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    // 版本100相对版本99只写过第二个分片
+    ChunkInfoDetail chunkInfo;
+    chunkInfo.chunkSn.push_back(100);
+    ChunkChangedInfo changedInfo;
+    changedInfo.baseSn = 99;
+    changedInfo.blockSize = option.chunkSplitSize;
+    changedInfo.bitmap = std::string(1, 0x02);
+    chunkInfo.changedInfo[100] = changedInfo;
+    EXPECT_CALL(*client_, GetChunkInfo(_, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(chunkInfo),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*dataStore_, PutChunkIndexData(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+
+    std::vector<SnapshotInfo> snapInfos;
+    SnapshotInfo info2(uuid, user, fileName, desc);
+    info.SetSeqNum(seqNum);
+    info2.SetSeqNum(seqNum - 1);
+    info2.SetStatus(Status::done);
+    snapInfos.push_back(info);
+    snapInfos.push_back(info2);
+    EXPECT_CALL(*metaStore_, GetSnapshotList(fileName, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(
+                    SetArgPointee<1>(snapInfos),
+                    Return(kErrCodeSuccess)));
+
+    // 只有chunk0的版本99已经转储过
+    ChunkIndexData indexData;
+    indexData.PutChunkDataName(ChunkDataName(fileName, 99, 0));
+    EXPECT_CALL(*dataStore_, GetChunkIndexData(_, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<1>(indexData),
+                    Return(kErrCodeSuccess)));
+
+    // chunk0只读取写过的分片，chunk1全量读取
+    EXPECT_CALL(*client_, ReadChunkSnapshot(_, _, _, _, _, _))
+        .Times(3)
+        .WillRepeatedly(DoAll(
+                    Invoke([](ChunkIDInfo cidinfo,
+                        uint64_t seq,
+                        uint64_t offset,
+                        uint64_t len,
+                        char *buf,
+                        SnapCloneClosure* scc){
+                        scc->SetRetCode(LIBCURVE_ERROR::OK);
+                        scc->Run();
+                        }),
+                    Return(LIBCURVE_ERROR::OK)));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferInit(_, _))
+        .Times(2)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferCopyPart(
+            ChunkDataName(fileName, seqNum, 0), _, 0,
+            option.chunkSplitSize, ChunkDataName(fileName, 99, 0)))
+        .WillOnce(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPart(_, _, _, _, _))
+        .Times(3)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*dataStore_, DataChunkTranferComplete(_, _))
+        .Times(2)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*client_, DeleteSnapshot(fileName, user, seqNum))
+        .WillOnce(Return(LIBCURVE_ERROR::OK));
+
+    EXPECT_CALL(*client_, CheckSnapShotStatus(_, _, _, _))
+        .WillOnce(Return(-LIBCURVE_ERROR::NOTEXIST));
+
+    core_->HandleCreateSnapshotTask(task);
+
+    ASSERT_TRUE(task->IsFinish());
+    ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
+}
+
 TEST_F(TestSnapshotCoreImpl,
     TestHandleCreateSnapshotTask_CreateSnapshotFail) {
     UUID uuid = "uuid1";
@@ -2248,6 +2699,78 @@ TEST_F(TestSnapshotCoreImpl,
     ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
 }
 
+TEST_F(TestSnapshotCoreImpl,
+    TestHandleDeleteSnapshotTaskContentAddressedChunk) {
+    UUID uuid = "uuid1";
+    std::string user = "user1";
+    std::string fileName = "file1";
+    std::string desc = "snap1";
+    uint64_t seqNum = 100;
+
+    SnapshotInfo info(uuid, user, fileName, desc);
+    info.SetSeqNum(seqNum);
+    info.SetStatus(Status::deleting);
+    auto snapshotInfoMetric = std::make_shared<SnapshotInfoMetric>(uuid);
+    std::shared_ptr<SnapshotTaskInfo> task =
+        std::make_shared<SnapshotTaskInfo>(info, snapshotInfoMetric);
+
+    std::vector<SnapshotInfo> snapInfos;
+    snapInfos.push_back(info);
+    EXPECT_CALL(*metaStore_, GetSnapshotList(fileName, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<1>(snapInfos),
+                    Return(kErrCodeSuccess)));
+
+    ChunkIndexData indexData;
+    indexData.SetFileName(fileName);
+    indexData.PutChunkDataName(ChunkDataName(fileName, seqNum, 0));
+    indexData.SetChunkDataHash(0, "hash1");
+    indexData.PutChunkDataName(ChunkDataName(fileName, seqNum, 1));
+    indexData.SetChunkDataHash(1, "hash2");
+    EXPECT_CALL(*dataStore_, ChunkIndexDataExist(_))
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*dataStore_, GetChunkIndexData(_, _))
+        .WillOnce(DoAll(
+                    SetArgPointee<1>(indexData),
+                    Return(kErrCodeSuccess)));
+
+    EXPECT_CALL(*metaStore_, GetChunkDataRef("file1-0-100", _))
+        .WillOnce(DoAll(SetArgPointee<1>(std::string("hash1")),
+                    Return(kErrCodeSuccess)));
+    EXPECT_CALL(*metaStore_, GetChunkDataRef("file1-1-100", _))
+        .WillOnce(DoAll(SetArgPointee<1>(std::string("hash2")),
+                    Return(kErrCodeSuccess)));
+
+    // hash1仍被其他卷的快照引用，只删除引用；hash2没有其他引用，删除对象
+    EXPECT_CALL(*metaStore_, RemoveChunkDataRef("file1-0-100", "hash1", _))
+        .WillOnce(DoAll(SetArgPointee<2>(1),
+                    Return(kErrCodeSuccess)));
+    EXPECT_CALL(*metaStore_, RemoveChunkDataRef("file1-1-100", "hash2", _))
+        .WillOnce(DoAll(SetArgPointee<2>(0),
+                    Return(kErrCodeSuccess)));
+
+    std::vector<std::string> deletedKeys;
+    EXPECT_CALL(*dataStore_, ChunkDataExist(_))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*dataStore_, DeleteChunkData(_))
+        .WillOnce(Invoke([&deletedKeys](const ChunkDataName &name) {
+                deletedKeys.push_back(name.ToDataChunkKey());
+                return kErrCodeSuccess;
+            }));
+
+    EXPECT_CALL(*dataStore_, DeleteChunkIndexData(_))
+        .WillOnce(Return(kErrCodeSuccess));
+
+    EXPECT_CALL(*metaStore_, DeleteSnapshot(uuid))
+        .WillOnce(Return(kErrCodeSuccess));
+
+    core_->HandleDeleteSnapshotTask(task);
+    ASSERT_TRUE(task->IsFinish());
+    ASSERT_EQ(Status::done, task->GetSnapshotInfo().GetStatus());
+    ASSERT_EQ(1, deletedKeys.size());
+    ASSERT_EQ("cas-hash2", deletedKeys[0]);
+}
+
 TEST_F(TestSnapshotCoreImpl,
     TestHandleDeleteSnapshotTask_GetChunkIndexDataSecondTimeFail) {
     UUID uuid = "uuid1";
@@ -3255,6 +3778,122 @@ TEST_F(TestSnapshotCoreImpl,
     ASSERT_EQ(Status::error, task->GetSnapshotInfo().GetStatus());
 }
 
+TEST_F(TestSnapshotCoreImpl, TestTransferSnapshotDataChunkSyncUpload) {
+    // uploadPartConcurrency为0时同步上传
+    ExpectReadChunkSnapshotSuccess(4);
+    EXPECT_CALL(*dataStore_, DataChunkTranferInit(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPart(_, _, _, _, _))
+        .Times(4)
+        .WillRepeatedly(Return(kErrCodeSuccess));
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPartAsync(_, _, _, _, _, _))
+        .Times(0);
+    EXPECT_CALL(*dataStore_, DataChunkTranferComplete(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+    EXPECT_CALL(*dataStore_, DataChunkTranferAbort(_, _))
+        .Times(0);
+    ASSERT_EQ(kErrCodeSuccess, TransferSnapshotDataChunk(0));
+}
+
+TEST_F(TestSnapshotCoreImpl, TestTransferSnapshotDataChunkAsyncUpload) {
+    // 异步上传，上传中的分片数量不超过uploadPartConcurrency，
+    // 所有上传完成后才结束转储
+    std::atomic<int> inflight(0);
+    std::atomic<int> maxInflight(0);
+    std::atomic<int> finished(0);
+    ExpectReadChunkSnapshotSuccess(4);
+    EXPECT_CALL(*dataStore_, DataChunkTranferInit(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPart(_, _, _, _, _))
+        .Times(0);
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPartAsync(_, _, _, _, _, _))
+        .Times(4)
+        .WillRepeatedly(Invoke([&](const ChunkDataName &name,
+            std::shared_ptr<TransferTask> task,
+            int partNum,
+            int partSize,
+            const char* buf,
+            TransferPartDone done) {
+            int now = ++inflight;
+            int max = maxInflight.load();
+            while (now > max && !maxInflight.compare_exchange_weak(max, now)) {
+            }
+            std::thread([&, done]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                --inflight;
+                ++finished;
+                done(kErrCodeSuccess);
+            }).detach();
+        }));
+    EXPECT_CALL(*dataStore_, DataChunkTranferComplete(_, _))
+        .WillOnce(Invoke([&](const ChunkDataName &name,
+            std::shared_ptr<TransferTask> task) {
+            EXPECT_EQ(4, finished.load());
+            return kErrCodeSuccess;
+        }));
+    EXPECT_CALL(*dataStore_, DataChunkTranferAbort(_, _))
+        .Times(0);
+    ASSERT_EQ(kErrCodeSuccess, TransferSnapshotDataChunk(2));
+    ASSERT_LE(maxInflight.load(), 2);
+}
+
+TEST_F(TestSnapshotCoreImpl, TestTransferSnapshotDataChunkAsyncUploadFail) {
+    // 上传失败后不再发起新的上传，转储失败
+    ExpectReadChunkSnapshotSuccess(2);
+    EXPECT_CALL(*dataStore_, DataChunkTranferInit(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPartAsync(_, _, _, _, _, _))
+        .WillOnce(Invoke([](const ChunkDataName &name,
+            std::shared_ptr<TransferTask> task,
+            int partNum,
+            int partSize,
+            const char* buf,
+            TransferPartDone done) {
+            done(kErrCodeInternalError);
+        }));
+    EXPECT_CALL(*dataStore_, DataChunkTranferComplete(_, _))
+        .Times(0);
+    EXPECT_CALL(*dataStore_, DataChunkTranferAbort(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+    ASSERT_EQ(kErrCodeInternalError, TransferSnapshotDataChunk(1));
+}
+
+TEST_F(TestSnapshotCoreImpl,
+    TestTransferSnapshotDataChunkAsyncUploadFailAfterRead) {
+    // 所有分片读取完成后第一个分片上传失败，
+    // 等待所有上传完成后再中止转储
+    std::atomic<int> finished(0);
+    ExpectReadChunkSnapshotSuccess(4);
+    EXPECT_CALL(*dataStore_, DataChunkTranferInit(_, _))
+        .WillOnce(Return(kErrCodeSuccess));
+    EXPECT_CALL(*dataStore_, DataChunkTranferAddPartAsync(_, _, _, _, _, _))
+        .Times(4)
+        .WillRepeatedly(Invoke([&](const ChunkDataName &name,
+            std::shared_ptr<TransferTask> task,
+            int partNum,
+            int partSize,
+            const char* buf,
+            TransferPartDone done) {
+            int ret = (0 == partNum) ? kErrCodeInternalError
+                                     : kErrCodeSuccess;
+            int delayMs = (0 == partNum) ? 20 : 50;
+            std::thread([&, done, ret, delayMs]() {
+                std::this_thread::sleep_for(
+                    std::chrono::milliseconds(delayMs));
+                ++finished;
+                done(ret);
+            }).detach();
+        }));
+    EXPECT_CALL(*dataStore_, DataChunkTranferComplete(_, _))
+        .Times(0);
+    EXPECT_CALL(*dataStore_, DataChunkTranferAbort(_, _))
+        .WillOnce(Invoke([&](const ChunkDataName &name,
+            std::shared_ptr<TransferTask> task) {
+            EXPECT_EQ(4, finished.load());
+            return kErrCodeSuccess;
+        }));
+    ASSERT_EQ(kErrCodeInternalError, TransferSnapshotDataChunk(4));
+}
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
-
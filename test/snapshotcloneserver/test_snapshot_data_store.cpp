@@ -27,6 +27,8 @@
 #include "src/snapshotcloneserver/snapshot/snapshot_data_store.h"
 #include "test/snapshotcloneserver/mock_s3_adapter.h"
 using ::testing::_;
+using ::testing::Invoke;
+using ::curve::common::UploadPartAsyncContext;
 namespace curve {
 namespace snapshotcloneserver {
 
@@ -164,6 +166,57 @@ TEST_F(TestS3SnapshotDataStore, testDataChunkTransferAddPart) {
               DataChunkTranferAddPart(cdName, task, 2, 1024*1024, buf));
     delete [] buf;
 }
+TEST_F(TestS3SnapshotDataStore, testDataChunkTransferAddPartAsync) {
+    ChunkDataName cdName("test", 1, 1);
+    std::shared_ptr<TransferTask> task = std::make_shared<TransferTask>();
+    task->uploadId_ = "test-uploadID";
+    char buf[1024];
+    memset(buf, 0, sizeof(buf));
+    bool fail = false;
+    EXPECT_CALL(*adapter4Data_, UploadPartAsync(_))
+        .Times(2)
+        .WillRepeatedly(Invoke([&fail](
+            std::shared_ptr<UploadPartAsyncContext> context) {
+            ASSERT_EQ("test-1-1", context->key);
+            ASSERT_EQ("test-uploadID", context->uploadId);
+            ASSERT_EQ(1024, context->len);
+            context->etag = "mytest";
+            context->retCode = fail ? -1 : 0;
+            context->cb(nullptr, context);
+        }));
+    int ret = 1;
+    store_->DataChunkTranferAddPartAsync(cdName, task, 1, 1024, buf,
+        [&ret](int retCode) { ret = retCode; });
+    ASSERT_EQ(0, ret);
+    ASSERT_EQ(1, task->GetPartInfo().size());
+    ASSERT_EQ("mytest", task->GetPartInfo()[2]);
+
+    fail = true;
+    store_->DataChunkTranferAddPartAsync(cdName, task, 2, 1024, buf,
+        [&ret](int retCode) { ret = retCode; });
+    ASSERT_EQ(-1, ret);
+    ASSERT_EQ(1, task->GetPartInfo().size());
+}
+TEST_F(TestS3SnapshotDataStore, testDataChunkTransferCopyPart) {
+    ChunkDataName cdName("test", 2, 1);
+    ChunkDataName srcName("test", 1, 1);
+    std::shared_ptr<TransferTask> task = std::make_shared<TransferTask>();
+    Aws::S3::Model::CompletedPart cp =
+        Aws::S3::Model::CompletedPart().WithETag("mytest").WithPartNumber(3);
+    Aws::S3::Model::CompletedPart cp_err =
+        Aws::S3::Model::CompletedPart().WithETag("errorTag").WithPartNumber(-1);
+    EXPECT_CALL(*adapter4Data_, UploadPartCopy(
+        Aws::String("test-1-2"), _, 3, Aws::String("test-1-1"),
+        2 * 1024 * 1024, 1024 * 1024))
+        .Times(2)
+        .WillOnce(Return(cp))
+        .WillOnce(Return(cp_err));
+    ASSERT_EQ(0, store_->
+              DataChunkTranferCopyPart(cdName, task, 2, 1024*1024, srcName));
+    ASSERT_EQ(1, task->GetPartInfo().size());
+    ASSERT_EQ(-1, store_->
+              DataChunkTranferCopyPart(cdName, task, 2, 1024*1024, srcName));
+}
 TEST_F(TestS3SnapshotDataStore, testDataChunkTransferComplete) {
     ChunkDataName cdName("test", 1, 1);
     std::shared_ptr<TransferTask> task = std::make_shared<TransferTask>();
@@ -280,6 +333,35 @@ TEST(TestChunkIndexData, TestGetAllChunkIndex) {
     ASSERT_EQ(100, ret[0]);
 }
 
+TEST(TestChunkIndexData, TestContentHash) {
+    ChunkIndexData indexData;
+    indexData.SetFileName("file1");
+    ChunkDataName name("file1", 10, 100);
+    name.contentHash_ = "abc";
+    ASSERT_EQ("cas-abc", name.ToDataChunkKey());
+    ASSERT_EQ("file1-100-10", name.ToLogicalChunkKey());
+    indexData.PutChunkDataName(name);
+    indexData.PutChunkDataName(ChunkDataName("file1", 10, 101));
+    indexData.SetChunkDataHash(101, "def");
+
+    // 内容哈希随索引块一起保存
+    std::string data;
+    ASSERT_TRUE(indexData.Serialize(&data));
+    ChunkIndexData indexData2;
+    ASSERT_TRUE(indexData2.Unserialize(data));
+    ChunkDataName out;
+    ASSERT_TRUE(indexData2.GetChunkDataName(100, &out));
+    ASSERT_EQ(name, out);
+    ASSERT_EQ("cas-abc", out.ToDataChunkKey());
+    ASSERT_TRUE(indexData2.GetChunkDataName(101, &out));
+    ASSERT_EQ("cas-def", out.ToDataChunkKey());
+
+    indexData2.DeleteChunkDataName(100);
+    indexData2.PutChunkDataName(ChunkDataName("file1", 10, 100));
+    ASSERT_TRUE(indexData2.GetChunkDataName(100, &out));
+    ASSERT_EQ("file1-100-10", out.ToDataChunkKey());
+}
+
 }  // namespace snapshotcloneserver
 }  // namespace curve
 
@@ -448,6 +448,7 @@ TEST_F(TestSnapshotCloneMetaStoreEtcd,
     int ret = metaStore_->AddCloneInfo(cloneInfo);
     ASSERT_EQ(0, ret);
 
+    cloneInfo.SetStatus(CloneStatus::done);
     EXPECT_CALL(*kvStorageClient_, Put(_, _))
         .WillOnce(Return(EtcdErrCode::EtcdUnknown));
 
@@ -455,6 +456,26 @@ TEST_F(TestSnapshotCloneMetaStoreEtcd,
     ASSERT_EQ(-1, ret);
 }
 
+TEST_F(TestSnapshotCloneMetaStoreEtcd,
+    TestUpdateCloneInfoNotChangedSkipPut) {
+    CloneInfo cloneInfo("uuid1", "user1",
+                     CloneTaskType::kClone, "src1",
+                     "dst1", 1, 2, 3,
+                     CloneFileType::kFile, false,
+                     CloneStep::kCompleteCloneFile,
+                     CloneStatus::cloning);
+
+    EXPECT_CALL(*kvStorageClient_, Put(_, _))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+
+    int ret = metaStore_->AddCloneInfo(cloneInfo);
+    ASSERT_EQ(0, ret);
+
+    // 记录没有变化时不写etcd
+    ret = metaStore_->UpdateCloneInfo(cloneInfo);
+    ASSERT_EQ(0, ret);
+}
+
 TEST_F(TestSnapshotCloneMetaStoreEtcd,
     TestUpdateCloneInfoNotExistAndGetSuccess) {
     CloneInfo cloneInfo("uuid1", "user1",
@@ -507,6 +528,51 @@ TEST_F(TestSnapshotCloneMetaStoreEtcd,
     ASSERT_TRUE(JudgeCloneInfoEqual(cloneInfo, list[0]));
 }
 
+TEST_F(TestSnapshotCloneMetaStoreEtcd,
+    TestGetCloneInfoByFileNameAndUserAfterUpdate) {
+    CloneInfo cloneInfo1("uuid1", "user1",
+                     CloneTaskType::kClone, "src1",
+                     "dst1", 1, 2, 3,
+                     CloneFileType::kFile, false,
+                     CloneStep::kCompleteCloneFile,
+                     CloneStatus::cloning);
+    CloneInfo cloneInfo2("uuid2", "user1",
+                     CloneTaskType::kClone, "src1",
+                     "dst2", 1, 2, 3,
+                     CloneFileType::kFile, false,
+                     CloneStep::kCompleteCloneFile,
+                     CloneStatus::cloning);
+
+    EXPECT_CALL(*kvStorageClient_, Put(_, _))
+        .Times(3)
+        .WillRepeatedly(Return(EtcdErrCode::EtcdOK));
+    EXPECT_CALL(*kvStorageClient_, Delete(_))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+
+    ASSERT_EQ(0, metaStore_->AddCloneInfo(cloneInfo1));
+    ASSERT_EQ(0, metaStore_->AddCloneInfo(cloneInfo2));
+
+    std::vector<CloneInfo> list;
+    ASSERT_EQ(0, metaStore_->GetCloneInfoByUser("user1", &list));
+    ASSERT_EQ(2, list.size());
+    list.clear();
+    ASSERT_EQ(-1, metaStore_->GetCloneInfoByUser("user2", &list));
+
+    // 更新后索引指向新的文件名
+    cloneInfo2.SetDest("dst1");
+    ASSERT_EQ(0, metaStore_->UpdateCloneInfo(cloneInfo2));
+    ASSERT_EQ(-1, metaStore_->GetCloneInfoByFileName("dst2", &list));
+    ASSERT_EQ(0, metaStore_->GetCloneInfoByFileName("dst1", &list));
+    ASSERT_EQ(2, list.size());
+
+    // 删除后从索引中移除
+    ASSERT_EQ(0, metaStore_->DeleteCloneInfo("uuid1"));
+    list.clear();
+    ASSERT_EQ(0, metaStore_->GetCloneInfoByUser("user1", &list));
+    ASSERT_EQ(1, list.size());
+    ASSERT_TRUE(JudgeCloneInfoEqual(cloneInfo2, list[0]));
+}
+
 TEST_F(TestSnapshotCloneMetaStoreEtcd,
     TestGetCloneInfoByFileNameFail) {
     std::vector<CloneInfo> list;
@@ -567,14 +633,26 @@ TEST_F(TestSnapshotCloneMetaStoreEtcd,
     std::vector<std::string> cloneOut;
     cloneOut.push_back(cloneValue);
 
+    std::string refValue;
+    ASSERT_TRUE(codec.EncodeChunkDataRefData("file1-0-1", "hash1",
+        &refValue));
+    std::vector<std::string> refOut;
+    refOut.push_back(refValue);
+
     EXPECT_CALL(*kvStorageClient_, List(_, _, _))
         .WillOnce(DoAll(SetArgPointee<2>(out),
             Return(EtcdErrCode::EtcdOK)))
         .WillOnce(DoAll(SetArgPointee<2>(cloneOut),
+            Return(EtcdErrCode::EtcdOK)))
+        .WillOnce(DoAll(SetArgPointee<2>(refOut),
             Return(EtcdErrCode::EtcdOK)));
 
     int ret = metaStore_->Init();
     ASSERT_EQ(0, ret);
+
+    std::string hash;
+    ASSERT_EQ(0, metaStore_->GetChunkDataRef("file1-0-1", &hash));
+    ASSERT_EQ("hash1", hash);
 }
 
 TEST_F(TestSnapshotCloneMetaStoreEtcd,
@@ -642,8 +720,55 @@ TEST_F(TestSnapshotCloneMetaStoreEtcd,
     ASSERT_EQ(-1, ret);
 }
 
+TEST_F(TestSnapshotCloneMetaStoreEtcd,
+    TestChunkDataRef) {
+    EXPECT_CALL(*kvStorageClient_, Put(_, _))
+        .WillOnce(Return(EtcdErrCode::EtcdUnknown))
+        .WillOnce(Return(EtcdErrCode::EtcdOK))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
+    EXPECT_CALL(*kvStorageClient_, Delete(_))
+        .WillOnce(Return(EtcdErrCode::EtcdUnknown))
+        .WillOnce(Return(EtcdErrCode::EtcdOK))
+        .WillOnce(Return(EtcdErrCode::EtcdOK));
 
-
+    uint32_t refCount = 0;
+    ASSERT_EQ(-1, metaStore_->AddChunkDataRef("file1-0-1", "hash1",
+        &refCount));
+    std::string hash;
+    ASSERT_EQ(-1, metaStore_->GetChunkDataRef("file1-0-1", &hash));
+
+    // 不同的数据chunk引用相同的内容
+    ASSERT_EQ(0, metaStore_->AddChunkDataRef("file1-0-1", "hash1",
+        &refCount));
+    ASSERT_EQ(1, refCount);
+    ASSERT_EQ(0, metaStore_->AddChunkDataRef("file2-0-1", "hash1",
+        &refCount));
+    ASSERT_EQ(2, refCount);
+
+    // 重复增加引用不计数，也不写etcd
+    ASSERT_EQ(0, metaStore_->AddChunkDataRef("file1-0-1", "hash1",
+        &refCount));
+    ASSERT_EQ(2, refCount);
+    ASSERT_EQ(-1, metaStore_->AddChunkDataRef("file1-0-1", "hash2",
+        &refCount));
+    ASSERT_EQ(0, metaStore_->GetChunkDataRef("file2-0-1", &hash));
+    ASSERT_EQ("hash1", hash);
+
+    ASSERT_EQ(-1, metaStore_->RemoveChunkDataRef("file1-0-1", "hash1",
+        &refCount));
+    ASSERT_EQ(0, metaStore_->RemoveChunkDataRef("file1-0-1", "hash1",
+        &refCount));
+    ASSERT_EQ(1, refCount);
+    ASSERT_EQ(0, metaStore_->RemoveChunkDataRef("file2-0-1", "hash1",
+        &refCount));
+    ASSERT_EQ(0, refCount);
+    ASSERT_EQ(-1, metaStore_->GetChunkDataRef("file2-0-1", &hash));
+
+    // 引用已经删除时返回成功
+    ASSERT_EQ(0, metaStore_->RemoveChunkDataRef("file2-0-1", "hash1",
+        &refCount));
+    ASSERT_EQ(0, refCount);
+}
 
 }  // namespace snapshotcloneserver
 }  // namespace curve
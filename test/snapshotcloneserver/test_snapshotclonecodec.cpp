@@ -111,6 +111,22 @@ TEST(TestSnapshotCloneServerCodec, TestEncodeKeyNotEqual) {
     ASSERT_EQ(keyNum * 2, keySet.size());
 }
 
+TEST(TestSnapshotCloneServerCodec, TestChunkDataRefEncodeDecodeEqual) {
+    SnapshotCloneCodec testObj;
+    std::string value;
+    ASSERT_TRUE(testObj.EncodeChunkDataRefData("file1-0-1", "hash1",
+        &value));
+
+    std::string name;
+    std::string hash;
+    ASSERT_TRUE(testObj.DecodeChunkDataRefData(value, &name, &hash));
+    ASSERT_EQ("file1-0-1", name);
+    ASSERT_EQ("hash1", hash);
+    ASSERT_FALSE(testObj.DecodeChunkDataRefData("xxx", &name, &hash));
+    ASSERT_NE(testObj.EncodeChunkDataRefKey("file1-0-1"),
+        testObj.EncodeSnapshotKey("file1-0-1"));
+}
+
 
 
 }  // namespace snapshotcloneserver
@@ -93,6 +93,7 @@ import (
 	"strings"
 	"sync"
 	"time"
+	"unsafe"
 )
 
 const (
@@ -103,7 +104,9 @@ const (
 	EtcdDelete    = "Delete"
 	EtcdTxn2      = "Txn2"
 	EtcdTxn3      = "Txn3"
+	EtcdTxnN      = "TxnN"
 	EtcdCmpAndSwp = "CmpAndSwp"
+	EtcdWatch     = "Watch"
 )
 
 var globalClient *clientv3.Client
@@ -325,6 +328,70 @@ func EtcdClientListWithLimitAndRevision(timeout C.uint, startKey, endKey *C.char
 	return errCode, AddManagedObject(resp.Kvs), len(resp.Kvs), resp.Header.Revision
 }
 
+// 获取[startKey, endKey)在(startRevision, endRevision]之间的所有变化，
+// 通过从startRevision+1开始watch历史事件实现，收到endRevision之后的事件
+// 或者进度通知时说明历史事件已经全部收到。
+// 如果startRevision已经被compact，返回EtcdOutOfRange
+//export EtcdClientListChanges
+func EtcdClientListChanges(timeout C.int, startKey, endKey *C.char,
+	startLen, endLen C.int, startRevision, endRevision int64) (
+	C.enum_EtcdErrCode, uint64, int) {
+	goStartKey := C.GoStringN(startKey, startLen)
+	goEndKey := C.GoStringN(endKey, endLen)
+	ctx, cancel := context.WithTimeout(context.Background(),
+		time.Duration(int(timeout))*time.Millisecond)
+	defer cancel()
+
+	events := []*clientv3.Event{}
+	if startRevision >= endRevision {
+		return C.EtcdOK, AddManagedObject(events), 0
+	}
+
+	watcher := clientv3.NewWatcher(globalClient)
+	defer watcher.Close()
+	wch := watcher.Watch(ctx, goStartKey, clientv3.WithRange(goEndKey),
+		clientv3.WithRev(startRevision+1), clientv3.WithPrevKV())
+
+	ticker := time.NewTicker(100 * time.Millisecond)
+	defer ticker.Stop()
+	for {
+		select {
+		case resp, ok := <-wch:
+			if !ok {
+				return GetErrCode(EtcdWatch, ctx.Err()), 0, 0
+			}
+			if resp.CompactRevision != 0 {
+				log.Printf("watch from revision %v, compacted at %v",
+					startRevision+1, resp.CompactRevision)
+				return C.EtcdOutOfRange, 0, 0
+			}
+			if err := resp.Err(); err != nil {
+				return GetErrCode(EtcdWatch, err), 0, 0
+			}
+
+			done := resp.IsProgressNotify() &&
+				resp.Header.Revision >= endRevision
+			for _, ev := range resp.Events {
+				if ev.Kv.ModRevision > endRevision {
+					done = true
+					break
+				}
+				events = append(events, ev)
+			}
+			if done {
+				return C.EtcdOK, AddManagedObject(events), len(events)
+			}
+		case <-ticker.C:
+			// 只有历史事件全部发送完成的watcher才会收到进度通知
+			if err := watcher.RequestProgress(ctx); err != nil {
+				return GetErrCode(EtcdWatch, err), 0, 0
+			}
+		case <-ctx.Done():
+			return GetErrCode(EtcdWatch, ctx.Err()), 0, 0
+		}
+	}
+}
+
 //export EtcdClientDelete
 func EtcdClientDelete(
 	timeout C.int, key *C.char, keyLen C.int) C.enum_EtcdErrCode {
@@ -388,6 +455,51 @@ func EtcdClientTxn3(
 	return GetErrCode(EtcdTxn3, err)
 }
 
+//export EtcdClientTxnN
+func EtcdClientTxnN(
+	timeout C.int, cops *C.struct_Operation, n C.int) C.enum_EtcdErrCode {
+	if n <= 0 {
+		return C.EtcdInvalidArgument
+	}
+	ops := (*[1 << 20]C.struct_Operation)(unsafe.Pointer(cops))[:int(n):int(n)]
+	etcdOps, err := GenOpList(ops)
+	if err != nil {
+		log.Printf("unknown op types, err: %v", err)
+		return C.EtcdTxnUnkownOp
+	}
+
+	ctx, cancel := context.WithTimeout(context.Background(),
+		time.Duration(int(timeout))*time.Millisecond)
+	defer cancel()
+
+	_, err = globalClient.Txn(ctx).Then(etcdOps...).Commit()
+	return GetErrCode(EtcdTxnN, err)
+}
+
+//export EtcdClientTxnNWithRevision
+func EtcdClientTxnNWithRevision(timeout C.int, cops *C.struct_Operation,
+	n C.int) (C.enum_EtcdErrCode, int64) {
+	if n <= 0 {
+		return C.EtcdInvalidArgument, 0
+	}
+	ops := (*[1 << 20]C.struct_Operation)(unsafe.Pointer(cops))[:int(n):int(n)]
+	etcdOps, err := GenOpList(ops)
+	if err != nil {
+		log.Printf("unknown op types, err: %v", err)
+		return C.EtcdTxnUnkownOp, 0
+	}
+
+	ctx, cancel := context.WithTimeout(context.Background(),
+		time.Duration(int(timeout))*time.Millisecond)
+	defer cancel()
+
+	resp, err := globalClient.Txn(ctx).Then(etcdOps...).Commit()
+	if err == nil {
+		return GetErrCode(EtcdTxnN, err), resp.Header.Revision
+	}
+	return GetErrCode(EtcdTxnN, err), 0
+}
+
 //export EtcdClientCompareAndSwap
 func EtcdClientCompareAndSwap(timeout C.int, key, prev, target *C.char,
 	keyLen, preLen, targetLen C.int) C.enum_EtcdErrCode {
@@ -587,6 +699,34 @@ func EtcdClientGetMultiObject(
 	}
 }
 
+//export EtcdClientGetChangeObject
+func EtcdClientGetChangeObject(oid uint64, serial int) (C.enum_EtcdErrCode,
+	C.enum_OpType, *C.char, int, *C.char, int, *C.char, int, int64) {
+	if value, exist := GetManagedObject(oid); !exist {
+		return C.EtcdObjectNotExist, 0, nil, 0, nil, 0, nil, 0, 0
+	} else if res, ok := value.([]*clientv3.Event); ok {
+		if serial >= len(res) {
+			return C.EtcdObjectLenNotEnough, 0, nil, 0, nil, 0, nil, 0, 0
+		}
+		ev := res[serial]
+		opType := C.enum_OpType(C.OpPut)
+		if ev.Type == clientv3.EventTypeDelete {
+			opType = C.OpDelete
+		}
+		var prevValue []byte
+		if ev.PrevKv != nil {
+			prevValue = ev.PrevKv.Value
+		}
+		return C.EtcdOK, opType,
+			C.CString(string(ev.Kv.Key)), len(ev.Kv.Key),
+			C.CString(string(ev.Kv.Value)), len(ev.Kv.Value),
+			C.CString(string(prevValue)), len(prevValue),
+			ev.Kv.ModRevision
+	} else {
+		return C.EtcdErrObjectType, 0, nil, 0, nil, 0, nil, 0, 0
+	}
+}
+
 //export EtcdClientRemoveObject
 func EtcdClientRemoveObject(oid uint64) {
 	RemoveManagedObject(oid)